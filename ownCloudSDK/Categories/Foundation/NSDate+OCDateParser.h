@@ -20,12 +20,19 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/*
+	Date parsing first tries locale-free parsers that decode the fixed formats used by servers directly from ASCII/UTF-8
+	bytes, without allocating memory or touching shared state. Only strings these parsers reject are passed on to the
+	(shared) date formatters.
+*/
+
 @interface NSDate (OCDateParser)
 
-+ (instancetype)dateParsedFromString:(NSString *)dateString error:(NSError * _Nullable *)error;
++ (instancetype)dateParsedFromString:(NSString *)dateString error:(NSError * _Nullable *)error; //!< Parses RFC 1123 dates as used by WebDAV, f.ex. "Fri, 23 Feb 2018 11:52:05 GMT"
 - (nullable NSString *)davDateString;
 
-+ (instancetype)dateParsedFromCompactUTCString:(NSString *)dateString error:(NSError * _Nullable *)error;
++ (instancetype)dateParsedFromCompactUTCString:(NSString *)dateString error:(NSError * _Nullable *)error; //!< Parses "yyyy-MM-dd HH:mm:ss" (UTC) and ISO 8601 dates
++ (nullable instancetype)dateParsedFromISO8601String:(NSString *)dateString; //!< Parses ISO 8601 internet date/times with or without fractional seconds, f.ex. "2018-02-23T11:52:05.123Z" as used by the Graph API
 - (nullable NSString *)compactUTCString;
 - (nullable NSString *)compactUTCStringDateOnly;
 - (nullable NSString *)compactISO8601String;
@@ -36,4 +43,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+#pragma mark - Byte parsers
+BOOL OCDateParseRFC1123(const char *bytes, size_t length, NSTimeInterval *outTimeIntervalSinceReferenceDate); //!< Parses a RFC 1123 date ("Fri, 23 Feb 2018 11:52:05 GMT", weekday optional, GMT/UTC/Z or numeric zone). Returns NO for anything else. Thread-safe and allocation-free.
+BOOL OCDateParseISO8601(const char *bytes, size_t length, NSTimeInterval *outTimeIntervalSinceReferenceDate); //!< Parses an ISO 8601 date/time ("2018-02-23T11:52:05[.123](Z|+01:00)") or its compact UTC variant ("2018-02-23 11:52:05"). Returns NO for anything else. Thread-safe and allocation-free.
+
 NS_ASSUME_NONNULL_END
@@ -18,6 +18,266 @@
 
 #import "NSDate+OCDateParser.h"
 
+#pragma mark - Byte parsers
+static const int64_t OCDateSecondsFrom1970To2001 = 978307200; // NSTimeIntervalSince1970 as integer
+
+static int64_t OCDateDaysSince1970(int64_t year, int month, int day)
+{
+	// Days from civil date in the proleptic Gregorian calendar (see http://howardhinnant.github.io/date_algorithms.html)
+	int64_t era, yearOfEra, dayOfYear, dayOfEra;
+
+	year -= (month <= 2) ? 1 : 0;
+	era = ((year >= 0) ? year : (year - 399)) / 400;
+	yearOfEra = year - (era * 400);
+	dayOfYear = ((153 * (month + ((month > 2) ? -3 : 9))) + 2) / 5 + day - 1;
+	dayOfEra = (yearOfEra * 365) + (yearOfEra / 4) - (yearOfEra / 100) + dayOfYear;
+
+	return ((era * 146097) + dayOfEra - 719468);
+}
+
+static BOOL OCDateIsValid(int year, int month, int day, int hour, int minute, int second)
+{
+	static const int daysInMonth[12] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+	if ((month < 1) || (month > 12) || (day < 1) || (day > daysInMonth[month-1])) { return (NO); }
+	if ((month == 2) && (day == 29) && !(((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0)))) { return (NO); }
+
+	// Leap seconds (second == 60) are left to the date formatters
+	return ((hour <= 23) && (minute <= 59) && (second <= 59));
+}
+
+static NSTimeInterval OCDateTimeIntervalSinceReferenceDate(int year, int month, int day, int hour, int minute, int second, int offsetSeconds)
+{
+	int64_t secondsSince1970 = (OCDateDaysSince1970(year, month, day) * 86400) + (hour * 3600) + (minute * 60) + second - offsetSeconds;
+
+	return ((NSTimeInterval)(secondsSince1970 - OCDateSecondsFrom1970To2001));
+}
+
+static BOOL OCDateScanDigits(const char **cursor, const char *end, int minDigits, int maxDigits, int *outValue)
+{
+	const char *p = *cursor;
+	int value = 0, digits = 0;
+
+	while ((p < end) && (digits < maxDigits) && (*p >= '0') && (*p <= '9'))
+	{
+		value = (value * 10) + (*p - '0');
+		digits++;
+		p++;
+	}
+
+	if (digits < minDigits) { return (NO); }
+
+	*cursor = p;
+	*outValue = value;
+
+	return (YES);
+}
+
+static BOOL OCDateScanCharacter(const char **cursor, const char *end, char character)
+{
+	if ((*cursor < end) && (**cursor == character))
+	{
+		(*cursor)++;
+		return (YES);
+	}
+
+	return (NO);
+}
+
+static void OCDateSkipWhitespace(const char **cursor, const char *end)
+{
+	while ((*cursor < end) && ((**cursor == ' ') || (**cursor == '\t') || (**cursor == '\r') || (**cursor == '\n')))
+	{
+		(*cursor)++;
+	}
+}
+
+static BOOL OCDateScanNumericTimeZone(const char **cursor, const char *end, BOOL colonSeparated, int *outOffsetSeconds)
+{
+	int sign, hours, minutes;
+
+	if (*cursor >= end) { return (NO); }
+
+	switch (**cursor)
+	{
+		case '+': sign = 1; break;
+		case '-': sign = -1; break;
+		default: return (NO);
+	}
+	(*cursor)++;
+
+	if (!OCDateScanDigits(cursor, end, 2, 2, &hours)) { return (NO); }
+	if (colonSeparated) { OCDateScanCharacter(cursor, end, ':'); }
+	if (!OCDateScanDigits(cursor, end, 2, 2, &minutes)) { return (NO); }
+
+	if ((hours > 23) || (minutes > 59)) { return (NO); }
+
+	*outOffsetSeconds = sign * ((hours * 3600) + (minutes * 60));
+
+	return (YES);
+}
+
+BOOL OCDateParseRFC1123(const char *bytes, size_t length, NSTimeInterval *outTimeIntervalSinceReferenceDate)
+{
+	static const char *monthNames = "janfebmaraprmayjunjulaugsepoctnovdec";
+	const char *cursor = bytes, *end = bytes + length;
+	int year, month = 0, day, hour, minute, second, offsetSeconds = 0;
+
+	if ((bytes == NULL) || (outTimeIntervalSinceReferenceDate == NULL)) { return (NO); }
+
+	OCDateSkipWhitespace(&cursor, end);
+
+	// Weekday (optional, ignored)
+	if ((cursor < end) && (((*cursor | 0x20) >= 'a') && ((*cursor | 0x20) <= 'z')))
+	{
+		while ((cursor < end) && ((*cursor | 0x20) >= 'a') && ((*cursor | 0x20) <= 'z')) { cursor++; }
+		if (!OCDateScanCharacter(&cursor, end, ',')) { return (NO); }
+		OCDateSkipWhitespace(&cursor, end);
+	}
+
+	// Day
+	if (!OCDateScanDigits(&cursor, end, 1, 2, &day)) { return (NO); }
+	if (!OCDateScanCharacter(&cursor, end, ' ')) { return (NO); }
+
+	// Month
+	if ((end - cursor) < 3) { return (NO); }
+
+	for (int monthIdx=0; monthIdx < 12; monthIdx++)
+	{
+		const char *monthName = monthNames + (monthIdx * 3);
+
+		if (((cursor[0] | 0x20) == monthName[0]) && ((cursor[1] | 0x20) == monthName[1]) && ((cursor[2] | 0x20) == monthName[2]))
+		{
+			month = monthIdx + 1;
+			break;
+		}
+	}
+
+	if (month == 0) { return (NO); }
+	cursor += 3;
+
+	// Year, Time
+	if (!OCDateScanCharacter(&cursor, end, ' ')) { return (NO); }
+	if (!OCDateScanDigits(&cursor, end, 4, 4, &year)) { return (NO); }
+	if (!OCDateScanCharacter(&cursor, end, ' ')) { return (NO); }
+	if (!OCDateScanDigits(&cursor, end, 2, 2, &hour)) { return (NO); }
+	if (!OCDateScanCharacter(&cursor, end, ':')) { return (NO); }
+	if (!OCDateScanDigits(&cursor, end, 2, 2, &minute)) { return (NO); }
+	if (!OCDateScanCharacter(&cursor, end, ':')) { return (NO); }
+	if (!OCDateScanDigits(&cursor, end, 2, 2, &second)) { return (NO); }
+
+	// Time zone
+	if (!OCDateScanCharacter(&cursor, end, ' ')) { return (NO); }
+
+	if (((end - cursor) >= 3) && (strncmp(cursor, "GMT", 3) == 0 || strncmp(cursor, "UTC", 3) == 0))
+	{
+		cursor += 3;
+	}
+	else if (((end - cursor) >= 2) && (strncmp(cursor, "UT", 2) == 0))
+	{
+		cursor += 2;
+	}
+	else if (!OCDateScanCharacter(&cursor, end, 'Z') && !OCDateScanNumericTimeZone(&cursor, end, NO, &offsetSeconds))
+	{
+		return (NO);
+	}
+
+	OCDateSkipWhitespace(&cursor, end);
+
+	if ((cursor != end) || !OCDateIsValid(year, month, day, hour, minute, second)) { return (NO); }
+
+	*outTimeIntervalSinceReferenceDate = OCDateTimeIntervalSinceReferenceDate(year, month, day, hour, minute, second, offsetSeconds);
+
+	return (YES);
+}
+
+BOOL OCDateParseISO8601(const char *bytes, size_t length, NSTimeInterval *outTimeIntervalSinceReferenceDate)
+{
+	const char *cursor = bytes, *end = bytes + length;
+	int year, month, day, hour, minute, second, offsetSeconds = 0;
+	double fraction = 0;
+	BOOL spaceSeparated = NO;
+
+	if ((bytes == NULL) || (outTimeIntervalSinceReferenceDate == NULL)) { return (NO); }
+
+	OCDateSkipWhitespace(&cursor, end);
+
+	// Date
+	if (!OCDateScanDigits(&cursor, end, 4, 4, &year)) { return (NO); }
+	if (!OCDateScanCharacter(&cursor, end, '-')) { return (NO); }
+	if (!OCDateScanDigits(&cursor, end, 2, 2, &month)) { return (NO); }
+	if (!OCDateScanCharacter(&cursor, end, '-')) { return (NO); }
+	if (!OCDateScanDigits(&cursor, end, 2, 2, &day)) { return (NO); }
+
+	// Separator
+	if (!OCDateScanCharacter(&cursor, end, 'T') && !OCDateScanCharacter(&cursor, end, 't'))
+	{
+		if (!(spaceSeparated = OCDateScanCharacter(&cursor, end, ' '))) { return (NO); }
+	}
+
+	// Time
+	if (!OCDateScanDigits(&cursor, end, 2, 2, &hour)) { return (NO); }
+	if (!OCDateScanCharacter(&cursor, end, ':')) { return (NO); }
+	if (!OCDateScanDigits(&cursor, end, 2, 2, &minute)) { return (NO); }
+	if (!OCDateScanCharacter(&cursor, end, ':')) { return (NO); }
+	if (!OCDateScanDigits(&cursor, end, 2, 2, &second)) { return (NO); }
+
+	// Fractional seconds
+	if (OCDateScanCharacter(&cursor, end, '.'))
+	{
+		double scale = 0.1;
+		const char *fractionStart = cursor;
+
+		while ((cursor < end) && (*cursor >= '0') && (*cursor <= '9'))
+		{
+			fraction += (*cursor - '0') * scale;
+			scale *= 0.1;
+			cursor++;
+		}
+
+		if (cursor == fractionStart) { return (NO); }
+	}
+
+	// Time zone (only the compact UTC variant may omit it)
+	if (!OCDateScanCharacter(&cursor, end, 'Z') && !OCDateScanCharacter(&cursor, end, 'z'))
+	{
+		if (!OCDateScanNumericTimeZone(&cursor, end, YES, &offsetSeconds) && !spaceSeparated)
+		{
+			return (NO);
+		}
+	}
+
+	OCDateSkipWhitespace(&cursor, end);
+
+	if ((cursor != end) || !OCDateIsValid(year, month, day, hour, minute, second)) { return (NO); }
+
+	*outTimeIntervalSinceReferenceDate = OCDateTimeIntervalSinceReferenceDate(year, month, day, hour, minute, second, offsetSeconds) + fraction;
+
+	return (YES);
+}
+
+static BOOL OCDateParseString(NSString *dateString, BOOL(*parser)(const char *bytes, size_t length, NSTimeInterval *outTimeIntervalSinceReferenceDate), NSTimeInterval *outTimeIntervalSinceReferenceDate)
+{
+	char buffer[64];
+	const char *bytes;
+
+	if (dateString == nil) { return (NO); }
+
+	// Use the string's internal buffer where possible, copy to the stack otherwise. Strings that are too long or not ASCII
+	// can't be dates in one of the supported formats.
+	if ((bytes = CFStringGetCStringPtr((__bridge CFStringRef)dateString, kCFStringEncodingASCII)) == NULL)
+	{
+		if (![dateString getCString:buffer maxLength:sizeof(buffer) encoding:NSASCIIStringEncoding])
+		{
+			return (NO);
+		}
+
+		bytes = buffer;
+	}
+
+	return (parser(bytes, strlen(bytes), outTimeIntervalSinceReferenceDate));
+}
+
 @implementation NSDate (OCDateParser)
 
 + (NSDateFormatter *)_ocDateFormatter
@@ -110,6 +370,13 @@
 
 + (instancetype)dateParsedFromString:(NSString *)dateString error:(NSError **)error
 {
+	NSTimeInterval timeInterval;
+
+	if (OCDateParseString(dateString, OCDateParseRFC1123, &timeInterval))
+	{
+		return ([self dateWithTimeIntervalSinceReferenceDate:timeInterval]);
+	}
+
 	return ([[self _ocDateFormatter] dateFromString:dateString]);
 }
 
@@ -121,6 +388,12 @@
 + (instancetype)dateParsedFromCompactUTCString:(NSString *)dateString error:(NSError **)error
 {
 	NSDate *date;
+	NSTimeInterval timeInterval;
+
+	if (OCDateParseString(dateString, OCDateParseISO8601, &timeInterval))
+	{
+		return ([self dateWithTimeIntervalSinceReferenceDate:timeInterval]);
+	}
 
 	date = [[self _ocDateFormatterCompactUTC] dateFromString:dateString];
 
@@ -135,6 +408,24 @@
 	return (date);
 }
 
++ (instancetype)dateParsedFromISO8601String:(NSString *)dateString
+{
+	NSDate *date;
+	NSTimeInterval timeInterval;
+
+	if (OCDateParseString(dateString, OCDateParseISO8601, &timeInterval))
+	{
+		return ([self dateWithTimeIntervalSinceReferenceDate:timeInterval]);
+	}
+
+	if ((date = [[self _ocDateFormatterISO8601WithFractionalSeconds] dateFromString:dateString]) == nil)
+	{
+		date = [[self _ocDateFormatterISO8601] dateFromString:dateString];
+	}
+
+	return (date);
+}
+
 - (NSString *)compactUTCString
 {
 	return ([[[self class] _ocDateFormatterCompactUTC] stringFromDate:self]);
@@ -28,6 +28,8 @@
 #import "NSProgress+OCExtensions.h"
 #import "OCCore+SyncEngine.h"
 #import "OCPlatform.h"
+#import "OCProcessManager.h"
+#import "OCBackgroundManager.h"
 
 typedef NSString* OCUploadInfoKey;
 typedef NSString* OCUploadInfoTask;
@@ -272,6 +274,7 @@ static OCUploadInfoTask OCUploadInfoTaskUpload = @"upload";
 	BOOL useCreationWithUpload = OCTUSIsSupported(tusJob.header.supportFlags, OCTUSSupportExtensionCreationWithUpload);
 	NSUInteger maxCreationWithUploadSize = NSUIntegerMax;
 	OCHTTPRequest *request = nil;
+	OCHTTPPipeline *pipeline = nil;
 
 	// Check if upload should continue
 	if (performCheck &&
@@ -428,17 +431,12 @@ static OCUploadInfoTask OCUploadInfoTaskUpload = @"upload";
 				NSError *error = nil;
 
 				// Create and send segment
-				OCTUSJobSegment *segment;
-
-				if ((segment = [tusJob requestSegmentFromOffset:0 withSize:initialChunkSize error:&error]) != nil)
+				if ((pipeline = [self _applyTusJob:tusJob segmentFromOffset:0 withSize:initialChunkSize toRequest:request error:&error]) != nil)
 				{
-					if ((request.bodyURL = segment.url) != nil)
-					{
-						// Prepare header for inclusion of creation-with-upload data
-						reqTusHeader.uploadOffset = @(0);
+					// Prepare header for inclusion of creation-with-upload data
+					reqTusHeader.uploadOffset = @(0);
 
-						[request setValue:@"application/offset+octet-stream" forHeaderField:OCHTTPHeaderFieldNameContentType];
-					}
+					[request setValue:@"application/offset+octet-stream" forHeaderField:OCHTTPHeaderFieldNameContentType];
 				}
 
 				if (error != nil)
@@ -500,13 +498,19 @@ static OCUploadInfoTask OCUploadInfoTaskUpload = @"upload";
 				request.actionTrackingID = tusJob.trackingID;
 
 				// Compose body
-				NSError *error;
-				OCTUSJobSegment *segment = [tusJob requestSegmentFromOffset:tusJob.uploadOffset.unsignedIntegerValue
-								   withSize:((tusJob.maxSegmentSize == 0) ?
-										(tusJob.fileSize.unsignedIntegerValue - tusJob.uploadOffset.unsignedIntegerValue) :
-										tusJob.maxSegmentSize
-									)
-								   error:&error];
+				NSError *error = nil;
+				NSUInteger segmentSize = ((tusJob.maxSegmentSize == 0) ?
+								(tusJob.fileSize.unsignedIntegerValue - tusJob.uploadOffset.unsignedIntegerValue) :
+								tusJob.maxSegmentSize
+							 );
+
+				if (segmentSize > (tusJob.fileSize.unsignedIntegerValue - tusJob.uploadOffset.unsignedIntegerValue))
+				{
+					// Last segment
+					segmentSize = tusJob.fileSize.unsignedIntegerValue - tusJob.uploadOffset.unsignedIntegerValue;
+				}
+
+				pipeline = [self _applyTusJob:tusJob segmentFromOffset:tusJob.uploadOffset.unsignedIntegerValue withSize:segmentSize toRequest:request error:&error];
 
 				if (error != nil)
 				{
@@ -519,11 +523,6 @@ static OCUploadInfoTask OCUploadInfoTaskUpload = @"upload";
 					return (nil);
 				}
 
-				if (segment != nil)
-				{
-					request.bodyURL = segment.url;
-				}
-
 				// Compose header
 				reqTusHeader.uploadOffset = tusJob.uploadOffset;
 				// reqTusHeader.uploadLength = @(segment.size);
@@ -534,14 +533,14 @@ static OCUploadInfoTask OCUploadInfoTaskUpload = @"upload";
 				request.userInfo = @{
 					OCUploadInfoKeyTask : OCUploadInfoTaskUpload,
 					OCUploadInfoKeyJob  : tusJob,
-					OCUploadInfoKeySegmentSize : @(segment.size)
+					OCUploadInfoKeySegmentSize : @(segmentSize)
 				};
 
 				NSProgress *progress = request.progress.progress;
 
 				if (progress != nil)
 				{
-					[actionProgress addChild:progress withPendingUnitCount:segment.size];
+					[actionProgress addChild:progress withPendingUnitCount:segmentSize];
 				}
 
 				if ((tusJob.trackingID != nil) && (self.delegate != nil) && ([self.delegate respondsToSelector:@selector(connection:hasUpdate:forTrackingID:)]) && (progress != nil))
@@ -579,12 +578,58 @@ static OCUploadInfoTask OCUploadInfoTaskUpload = @"upload";
 //			request.requestObserver = options[OCConnectionOptionRequestObserverKey];
 //		}
 
-		[[self transferPipelineForRequest:request withExpectedResponseLength:1000] enqueueRequest:request forPartitionID:self.partitionID];
+		if (pipeline == nil)
+		{
+			pipeline = [self transferPipelineForRequest:request withExpectedResponseLength:1000];
+		}
+
+		[pipeline enqueueRequest:request forPartitionID:self.partitionID];
 	}
 
 	return (tusProgress);
 }
 
+- (nullable OCHTTPPipeline *)_applyTusJob:(OCTUSJob *)tusJob segmentFromOffset:(NSUInteger)offset withSize:(NSUInteger)size toRequest:(OCHTTPRequest *)request error:(NSError **)outError
+{
+	OCHTTPPipeline *pipeline;
+
+	// Stream the segment straight from the (cloned) source file
+	request.bodyURL = tusJob.fileURL;
+	request.bodyURLRange = NSMakeRange(offset, size);
+
+	if (!OCProcessManager.isProcessExtension && !OCBackgroundManager.sharedBackgroundManager.isBackgrounded && (self.foregroundTransferPipeline != nil))
+	{
+		// While the app is in the foreground, upload segments through the foreground transfer pipeline, which can stream them without
+		// competing with commands for connections. Its tasks are covered by background tasks, so that a segment in flight can complete
+		// after the app was moved to the background. Should it still be interrupted, the TUS upload resumes from the offset last confirmed
+		// by the server. Extensions and apps in the background keep using background sessions, so that uploads continue after the process
+		// is suspended.
+		pipeline = self.foregroundTransferPipeline;
+	}
+	else
+	{
+		pipeline = [self transferPipelineForRequest:request withExpectedResponseLength:1000];
+	}
+
+	if (pipeline.backgroundSessionBacked)
+	{
+		// Background sessions only support uploads from files, so fall back to a segment file
+		OCTUSJobSegment *segment;
+
+		request.bodyURLRange = NSMakeRange(0, 0);
+
+		if ((segment = [tusJob requestSegmentFromOffset:offset withSize:size error:outError]) == nil)
+		{
+			request.bodyURL = nil;
+			return (nil);
+		}
+
+		request.bodyURL = segment.url;
+	}
+
+	return (pipeline);
+}
+
 - (void)_handleUploadTusJobResult:(OCHTTPRequest *)request error:(NSError *)error
 {
 	NSString *task = request.userInfo[OCUploadInfoKeyTask];
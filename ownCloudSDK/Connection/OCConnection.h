@@ -48,6 +48,7 @@
 @class OCServerInstance;
 @class OCTUSJobSegment;
 @class OCTUSJob;
+@class OCRangedDownloadJob;
 @class OCShareRole;
 
 typedef NSString* OCConnectionEndpointID NS_TYPED_ENUM;
@@ -59,6 +60,8 @@ typedef NSDictionary<OCItemPropertyName,OCHTTPStatus*>* OCConnectionPropertyUpda
 
 typedef NSDictionary<OCConnectionOptionKey,id>* OCConnectionOptions;
 
+typedef void(^OCConnectionItemBatchHandler)(NSArray<OCItem *> *items); //!< Receives batches of items decoded from a streamed PROPFIND response
+
 typedef NSString* OCConnectionActionUpdateKey NS_TYPED_ENUM;
 typedef NSDictionary<OCConnectionActionUpdateKey,id>* OCConnectionActionUpdate;
 
@@ -163,6 +166,8 @@ NS_ASSUME_NONNULL_BEGIN
 	NSMutableArray <OCConnectionAuthenticationAvailabilityHandler> *_pendingAuthenticationAvailabilityHandlers;
 
 	NSMutableDictionary<OCActionTrackingID, NSProgress *> *_progressByActionTrackingID;
+
+	NSMutableDictionary<NSString *, OCRangedDownloadJob *> *_rangedDownloadJobsByID;
 }
 
 @property(class,readonly,nonatomic) BOOL backgroundURLSessionsAllowed; //!< Indicates whether background URL sessions should be used.
@@ -182,6 +187,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property(nullable,strong) OCHTTPPipeline *ephermalPipeline; //!< Pipeline for requests whose response is only interesting for the instance making them (f.ex. login, status, PROPFINDs)
 @property(nullable,strong) OCHTTPPipeline *commandPipeline;  //!< Pipeline for requests whose response is important across instances (f.ex. commands like move, delete)
 @property(nullable,strong) OCHTTPPipeline *longLivedPipeline; //!< Pipeline for requests whose response may take a while (like uploads, downloads) or that may not be dropped - not even temporarily.
+@property(nullable,strong) OCHTTPPipeline *foregroundTransferPipeline; //!< Pipeline for transfers streamed while the app is in the foreground (like TUS upload segments), so they don't compete with commands for connections.
 
 @property(strong,nullable) OCHTTPCookieStorage *cookieStorage; //!< Cookie storage. Must be set externally if it should be used.
 
@@ -232,6 +238,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable OCProgress *)deleteItem:(OCItem *)item requireMatch:(BOOL)requireMatch resultTarget:(OCEventTarget *)eventTarget;
 
 - (nullable OCProgress *)downloadItem:(OCItem *)item to:(nullable NSURL *)targetURL options:(nullable OCConnectionOptions)options resultTarget:(OCEventTarget *)eventTarget;
+- (nullable OCRangedDownloadJob *)rangedDownloadJobForItem:(OCItem *)item fileURL:(NSURL *)fileURL; //!< Returns a new job to download the item in concurrent byte ranges into fileURL - or nil if the item is too small or lacks an ETag. Pass the job to -downloadItem:to:options:resultTarget: via OCConnectionOptionRangedDownloadJob.
 
 - (nullable OCProgress *)updateItem:(OCItem *)item properties:(nullable NSArray <OCItemPropertyName> *)properties options:(nullable OCConnectionOptions)options resultTarget:(OCEventTarget *)eventTarget;
 
@@ -522,6 +529,9 @@ extern OCClassSettingsKey OCConnectionPlainHTTPPolicy; //!< Either "warn" (for O
 extern OCClassSettingsKey OCConnectionAlwaysRequestPrivateLink; //!< Controls whether private links are requested with regular PROPFINDs.
 extern OCClassSettingsKey OCConnectionTransparentTemporaryRedirect; //!< Allows (TRUE) transparent handling of 307 redirects at the HTTP pipeline level.
 extern OCClassSettingsKey OCConnectionValidatorFlags; //!< Allows fine-tuning the behavior of the connection validator.
+extern OCClassSettingsKey OCConnectionRangedDownloadMinimumSize; //!< Minimum size (in bytes) of files to download in concurrent byte ranges. A value of 0 disables ranged downloads. Defaults to 16 MB.
+extern OCClassSettingsKey OCConnectionRangedDownloadChunkSize; //!< Size (in bytes) of the byte ranges to request in ranged downloads. Defaults to 4 MB.
+extern OCClassSettingsKey OCConnectionRangedDownloadConcurrency; //!< Maximum number of byte ranges to request concurrently per ranged download. Defaults to 4.
 extern OCClassSettingsKey OCConnectionBlockPasswordRemovalDefault; //!< Controls the value of the `block_password_removal`-based capabilities if the server provides no value for it. This controls whether passwords can be removed from an existing link even though passwords need to be enforced on creation as per capabilities.
 
 extern OCConnectionOptionKey OCConnectionOptionRequestObserverKey;
@@ -536,11 +546,15 @@ extern OCConnectionOptionKey OCConnectionOptionTemporarySegmentFolderURLKey; //!
 extern OCConnectionOptionKey OCConnectionOptionForceReplaceKey; //!< If YES, force replace existing items.
 extern OCConnectionOptionKey OCConnectionOptionResponseDestinationURL; //!< NSURL of where to store a (raw) response
 extern OCConnectionOptionKey OCConnectionOptionResponseStreamHandler; //!< Response stream handler (OCHTTPRequestEphermalStreamHandler) to receive the response body stream
+extern OCConnectionOptionKey OCConnectionOptionResponseItemBatchHandler; //!< Item batch handler (OCConnectionItemBatchHandler) to receive items while the PROPFIND response is being received. The response body is then decoded while streaming, not buffered, and the result of the OCEventTypeRetrieveItemList event will be nil.
+extern OCConnectionOptionKey OCConnectionOptionResponseItemBatchRestartHandler; //!< Block (dispatch_block_t) called if the request is rescheduled after items were delivered via OCConnectionOptionResponseItemBatchHandler. Items delivered until then should be discarded, as all items will be delivered again.
+extern OCConnectionOptionKey OCConnectionOptionResponseItemBatchSize; //!< Maximum number of items (NSNumber) to deliver per call to the OCConnectionOptionResponseItemBatchHandler. Defaults to 200.
 extern OCConnectionOptionKey OCConnectionOptionDriveID; //!< Drive ID (OCDriveID) to target.
 extern OCConnectionOptionKey OCConnectionOptionParentItem; //!< Parent item (OCItem)
 extern OCConnectionOptionKey OCConnectionOptionSyncRecordID; //!< Sync Record ID (OCSyncRecordID), typically of the sync record performing the operation.
 extern OCConnectionOptionKey OCConnectionOptionAlternativeEventType; //!< Type (OCEventType) of the event a PROPFIND response belongs to and should undergo specific handling (internal)
 extern OCConnectionOptionKey OCConnectionOptionActionTrackingID; //!< Tracking ID (OCActionTrackingID) that should be used when communicating with the delegate about an action.
+extern OCConnectionOptionKey OCConnectionOptionRangedDownloadJob; //!< OCRangedDownloadJob to perform a download with. The file is then assembled at the job's .fileURL and the targetURL is ignored.
 
 extern OCConnectionSetupOptionKey OCConnectionSetupOptionUserName; //!< User name to feed to OCConnectionServerLocator to determine server.
 
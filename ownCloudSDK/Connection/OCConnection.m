@@ -60,6 +60,7 @@
 #import "OCAuthenticationMethodBasicAuth.h"
 
 #import "OCChecksumAlgorithmSHA1.h"
+#import "OCRangedDownloadJob.h"
 
 static OCConnectionSetupHTTPPolicy sSetupHTTPPolicy = OCConnectionSetupHTTPPolicyAuto;
 
@@ -111,7 +112,10 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 		OCConnectionAlwaysRequestPrivateLink,
 		OCConnectionTransparentTemporaryRedirect,
 		OCConnectionValidatorFlags,
-		OCConnectionBlockPasswordRemovalDefault
+		OCConnectionBlockPasswordRemovalDefault,
+		OCConnectionRangedDownloadMinimumSize,
+		OCConnectionRangedDownloadChunkSize,
+		OCConnectionRangedDownloadConcurrency
 	]);
 }
 
@@ -164,7 +168,10 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 		OCConnectionPlainHTTPPolicy			: @"warn",
 		OCConnectionAlwaysRequestPrivateLink		: @(NO),
 		OCConnectionTransparentTemporaryRedirect	: @(NO),
-		OCConnectionBlockPasswordRemovalDefault		: @(YES)
+		OCConnectionBlockPasswordRemovalDefault		: @(YES),
+		OCConnectionRangedDownloadMinimumSize		: @(16 * 1024 * 1024),
+		OCConnectionRangedDownloadChunkSize		: @(4 * 1024 * 1024),
+		OCConnectionRangedDownloadConcurrency		: @(4)
 	});
 }
 
@@ -234,6 +241,30 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 			OCClassSettingsMetadataKeyFlags		: @(OCClassSettingsFlagDenyUserPreferences)
 		},
 
+		OCConnectionRangedDownloadMinimumSize : @{
+			OCClassSettingsMetadataKeyType 		: OCClassSettingsMetadataTypeInteger,
+			OCClassSettingsMetadataKeyDescription 	: @"Minimum size (in bytes) of files to download in concurrent byte ranges. A value of 0 disables ranged downloads.",
+			OCClassSettingsMetadataKeyStatus	: OCClassSettingsKeyStatusAdvanced,
+			OCClassSettingsMetadataKeyCategory	: @"Connection",
+			OCClassSettingsMetadataKeyFlags		: @(OCClassSettingsFlagDenyUserPreferences)
+		},
+
+		OCConnectionRangedDownloadChunkSize : @{
+			OCClassSettingsMetadataKeyType 		: OCClassSettingsMetadataTypeInteger,
+			OCClassSettingsMetadataKeyDescription 	: @"Size (in bytes) of the byte ranges requested in ranged downloads.",
+			OCClassSettingsMetadataKeyStatus	: OCClassSettingsKeyStatusAdvanced,
+			OCClassSettingsMetadataKeyCategory	: @"Connection",
+			OCClassSettingsMetadataKeyFlags		: @(OCClassSettingsFlagDenyUserPreferences)
+		},
+
+		OCConnectionRangedDownloadConcurrency : @{
+			OCClassSettingsMetadataKeyType 		: OCClassSettingsMetadataTypeInteger,
+			OCClassSettingsMetadataKeyDescription 	: @"Maximum number of byte ranges requested concurrently per ranged download.",
+			OCClassSettingsMetadataKeyStatus	: OCClassSettingsKeyStatusAdvanced,
+			OCClassSettingsMetadataKeyCategory	: @"Connection",
+			OCClassSettingsMetadataKeyFlags		: @(OCClassSettingsFlagDenyUserPreferences)
+		},
+
 		// Endpoints
 		OCConnectionEndpointIDWellKnown : @{
 			OCClassSettingsMetadataKeyType 		: OCClassSettingsMetadataTypeString,
@@ -501,6 +532,8 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 
 		_progressByActionTrackingID = [NSMutableDictionary new];
 
+		_rangedDownloadJobsByID = [NSMutableDictionary new];
+
 		[NSNotificationCenter.defaultCenter addObserver:self selector:@selector(_connectionCertificateUserApproved) name:self.bookmark.certificateUserApprovalUpdateNotificationName object:nil];
 
 		// Get pipelines
@@ -535,22 +568,28 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 
 				OCLogDebug(@"Retrieved local pipeline %@ with error=%@", pipeline, error);
 
-				if (OCConnection.backgroundURLSessionsAllowed)
-				{
-					[OCHTTPPipelineManager.sharedPipelineManager requestPipelineWithIdentifier:OCHTTPPipelineIDBackground completionHandler:^(OCHTTPPipeline * _Nullable pipeline, NSError * _Nullable error) {
-						self->_longLivedPipeline = pipeline;
+				[OCHTTPPipelineManager.sharedPipelineManager requestPipelineWithIdentifier:OCHTTPPipelineIDForegroundTransfer completionHandler:^(OCHTTPPipeline * _Nullable pipeline, NSError * _Nullable error) {
+					self->_foregroundTransferPipeline = pipeline;
 
-						OCLogDebug(@"Retrieved longlived pipeline %@ with error=%@", pipeline, error);
+					OCLogDebug(@"Retrieved foreground transfer pipeline %@ with error=%@", pipeline, error);
 
-						OCSyncExecDone(waitForPipelines);
-					}];
-				}
-				else
-				{
-					self->_longLivedPipeline = pipeline;
+					if (OCConnection.backgroundURLSessionsAllowed)
+					{
+						[OCHTTPPipelineManager.sharedPipelineManager requestPipelineWithIdentifier:OCHTTPPipelineIDBackground completionHandler:^(OCHTTPPipeline * _Nullable pipeline, NSError * _Nullable error) {
+							self->_longLivedPipeline = pipeline;
 
-					OCSyncExecDone(waitForPipelines);
-				}
+							OCLogDebug(@"Retrieved longlived pipeline %@ with error=%@", pipeline, error);
+
+							OCSyncExecDone(waitForPipelines);
+						}];
+					}
+					else
+					{
+						self->_longLivedPipeline = self->_commandPipeline;
+
+						OCSyncExecDone(waitForPipelines);
+					}
+				}];
 			}];
 		}];
 	});
@@ -673,6 +712,10 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 	{
 		[connectionPipelines addObject:self->_commandPipeline];
 	}
+	if (self->_foregroundTransferPipeline != nil)
+	{
+		[connectionPipelines addObject:self->_foregroundTransferPipeline];
+	}
 
 	return (connectionPipelines);
 }
@@ -1913,6 +1956,7 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 		if ((davRequest = [self _propfindDAVRequestForPath:path endpointURL:endpointURL depth:depth]) != nil)
 		{
 			OCHTTPRequestEphermalStreamHandler ephermalStreamHandler = nil;
+			OCConnectionItemBatchHandler itemBatchHandler = nil;
 
 			if ((ephermalStreamHandler = options[OCConnectionOptionResponseStreamHandler]) != nil)
 			{
@@ -1921,6 +1965,49 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 				[(NSMutableDictionary *)options removeObjectForKey:OCConnectionOptionResponseStreamHandler];
 			}
 
+			if ((itemBatchHandler = options[OCConnectionOptionResponseItemBatchHandler]) != nil)
+			{
+				OCHTTPDAVItemStreamDecoder *itemStreamDecoder;
+				NSNumber *batchSize = options[OCConnectionOptionResponseItemBatchSize];
+				dispatch_block_t restartHandler = options[OCConnectionOptionResponseItemBatchRestartHandler];
+
+				// Remove blocks from options as they can't be serialized otherwise
+				options = [options mutableCopy];
+				[(NSMutableDictionary *)options removeObjectForKey:OCConnectionOptionResponseItemBatchHandler];
+				[(NSMutableDictionary *)options removeObjectForKey:OCConnectionOptionResponseItemBatchRestartHandler];
+
+				// Decode items as the response is received, rather than buffering and parsing the entire response
+				itemStreamDecoder = [[OCHTTPDAVItemStreamDecoder alloc] initWithBasePath:endpointURL.path batchHandler:^(OCHTTPDAVItemStreamDecoder *decoder, NSArray<OCItem *> *items) {
+					OCTUSHeader *tusHeader;
+
+					if ((decoder.response != nil) && ((tusHeader = [[OCTUSHeader alloc] initWithHTTPHeaderFields:decoder.response.headerFields]) != nil) && (tusHeader.supportFlags != OCTUSSupportNone))
+					{
+						for (OCItem *item in items)
+						{
+							if ([item.path isEqual:path])
+							{
+								item.tusInfo = tusHeader.info;
+								break;
+							}
+						}
+					}
+
+					itemBatchHandler(items);
+				}];
+
+				itemStreamDecoder.driveID = driveID;
+				itemStreamDecoder.bookmarkUUIDString = self.bookmark.uuidString;
+				itemStreamDecoder.restartHandler = restartHandler;
+
+				if (batchSize != nil)
+				{
+					itemStreamDecoder.batchSize = batchSize.unsignedIntegerValue;
+				}
+
+				davRequest.itemStreamDecoder = itemStreamDecoder;
+				ephermalStreamHandler = itemStreamDecoder.streamHandler;
+			}
+
 			// davRequest.requiredSignals = self.actionSignals;
 			davRequest.resultHandlerAction = @selector(_handleRetrieveItemListAtPathResult:error:);
 			davRequest.userInfo = @{
@@ -2025,6 +2112,18 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 		eventType = (OCEventType)[options[OCConnectionOptionAlternativeEventType] integerValue];
 	}
 
+	OCHTTPDAVItemStreamDecoder *itemStreamDecoder = OCTypedCast(request, OCHTTPDAVRequest).itemStreamDecoder;
+
+	if ((itemStreamDecoder != nil) && !itemStreamDecoder.finished)
+	{
+		// Deliver the result only after the last batch of items has been delivered
+		[itemStreamDecoder notifyWhenFinished:^{
+			[self _handleRetrieveItemListAtPathResult:request error:error];
+		}];
+
+		return;
+	}
+
 	if ((event = [OCEvent eventForEventTarget:request.eventTarget type:eventType uuid:request.identifier attributes:nil]) != nil)
 	{
 		NSURL *endpointURL = request.userInfo[@"endpointURL"];
@@ -2070,9 +2169,17 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 
 			// OCLogDebug(@"Error: %@ - Response: %@", OCLogPrivate(error), ((request.downloadRequest && (request.downloadedFileURL != nil)) ? OCLogPrivate([NSString stringWithContentsOfURL:request.downloadedFileURL encoding:NSUTF8StringEncoding error:NULL]) : nil));
 
-			items = [((OCHTTPDAVRequest *)request) responseItemsForBasePath:endpointURL.path drives:nil reuseUsersByID:_usersByUserID driveID:driveID withErrors:&errors];
+			if (itemStreamDecoder != nil)
+			{
+				// Items have already been delivered via OCConnectionOptionResponseItemBatchHandler
+				errors = itemStreamDecoder.errors;
+			}
+			else
+			{
+				items = [((OCHTTPDAVRequest *)request) responseItemsForBasePath:endpointURL.path drives:nil reuseUsersByID:_usersByUserID driveID:driveID withErrors:&errors];
+			}
 
-			if ((items.count == 0) && (errors.count > 0) && (event.error == nil))
+			if ((items.count == 0) && (itemStreamDecoder.itemCount == 0) && (errors.count > 0) && (event.error == nil))
 			{
 				event.error = errors.firstObject;
 			}
@@ -2251,6 +2358,7 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 {
 	OCProgress *requestProgress = nil;
 	OCActionTrackingID actionTrackingID = OCConnectionInferActionTrackingID(options, eventTarget);
+	OCRangedDownloadJob *rangedDownloadJob;
 	NSURL *downloadURL;
 
 	if (item == nil)
@@ -2266,6 +2374,12 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 		return (nil);
 	}
 
+	if ((rangedDownloadJob = OCTypedCast(options[OCConnectionOptionRangedDownloadJob], OCRangedDownloadJob)) != nil)
+	{
+		// Download in concurrent byte ranges
+		return ([self _startRangedDownloadJob:rangedDownloadJob forItem:item options:options resultTarget:eventTarget]);
+	}
+
 	if ((downloadURL = [[self URLForEndpoint:OCConnectionEndpointIDWebDAVRoot options:@{ OCConnectionEndpointURLOptionDriveID : OCNullProtect(item.driveID) }] URLByAppendingPathComponent:item.path]) != nil)
 	{
 		OCHTTPRequest *request = [OCHTTPRequest requestWithURL:downloadURL];
@@ -2366,65 +2480,397 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCConnection)
 				}
 				else
 				{
-					switch (request.httpResponse.status.code)
-					{
-						case OCHTTPStatusCodePRECONDITION_FAILED: {
-							NSError *davError;
+					event.error = [self _errorForFailedDownloadRequest:request];
+				}
+			}
+		}
 
-							if (((davError = request.httpResponse.bodyParsedAsDAVError) != nil) && (davError.code == OCDAVErrorItemDoesNotExist))
-							{
-								event.error = OCErrorFromError(OCErrorItemNotFound, davError);
-							}
-							else
-							{
-								event.error = OCErrorFromError(OCErrorItemChanged, request.httpResponse.status.error);
-							}
-						}
-						break;
+		OCErrorAddDateFromResponse(event.error, request.httpResponse);
 
-						case OCHTTPStatusCodeTOO_EARLY: {
-							NSString *itemName = OCTypedCast(request.userInfo[@"item"], OCItem).name;
+		[request.eventTarget handleEvent:event sender:self];
+	}
+}
 
-							if (itemName == nil)
-							{
-								itemName = OCLocalizedString(@"File",nil);
-							}
+- (NSError *)_errorForFailedDownloadRequest:(OCHTTPRequest *)request
+{
+	switch (request.httpResponse.status.code)
+	{
+		case OCHTTPStatusCodePRECONDITION_FAILED: {
+			NSError *davError;
 
-							event.error = OCErrorWithDescriptionFromError(OCErrorItemProcessing, OCLocalizedFormat(@"{{itemName}} is currently processed on the server and can't be downloaded until it finishes processing.", @{
-								@"itemName" : itemName
-							}), request.httpResponse.status.error);
-						}
-						break;
+			if (((davError = request.httpResponse.bodyParsedAsDAVError) != nil) && (davError.code == OCDAVErrorItemDoesNotExist))
+			{
+				return (OCErrorFromError(OCErrorItemNotFound, davError));
+			}
+
+			return (OCErrorFromError(OCErrorItemChanged, request.httpResponse.status.error));
+		}
+		break;
 
-						case OCHTTPStatusCodeFORBIDDEN: {
-							NSError *davError;
+		case OCHTTPStatusCodeTOO_EARLY: {
+			NSString *itemName = OCTypedCast(request.userInfo[@"item"], OCItem).name;
 
-							if ((davError = request.httpResponse.bodyParsedAsDAVError) != nil)
-							{
-								event.error = OCErrorWithDescriptionFromError(OCErrorItemInsufficientPermissions, davError.davExceptionMessage, davError);
-							}
-							else
-							{
-								event.error = OCErrorFromError(OCErrorItemInsufficientPermissions, request.httpResponse.status.error);
-							}
-						}
-						break;
+			if (itemName == nil)
+			{
+				itemName = OCLocalizedString(@"File",nil);
+			}
 
-						case OCHTTPStatusCodeNOT_FOUND:
-							event.error = OCErrorFromError(OCErrorItemNotFound, request.httpResponse.status.error);
-						break;
+			return (OCErrorWithDescriptionFromError(OCErrorItemProcessing, OCLocalizedFormat(@"{{itemName}} is currently processed on the server and can't be downloaded until it finishes processing.", @{
+				@"itemName" : itemName
+			}), request.httpResponse.status.error));
+		}
+		break;
 
-						default:
-							event.error = request.httpResponse.status.error;
-						break;
-					}
-				}
+		case OCHTTPStatusCodeFORBIDDEN: {
+			NSError *davError;
+
+			if ((davError = request.httpResponse.bodyParsedAsDAVError) != nil)
+			{
+				return (OCErrorWithDescriptionFromError(OCErrorItemInsufficientPermissions, davError.davExceptionMessage, davError));
 			}
+
+			return (OCErrorFromError(OCErrorItemInsufficientPermissions, request.httpResponse.status.error));
 		}
+		break;
 
-		OCErrorAddDateFromResponse(event.error, request.httpResponse);
+		case OCHTTPStatusCodeNOT_FOUND:
+			return (OCErrorFromError(OCErrorItemNotFound, request.httpResponse.status.error));
+		break;
 
-		[request.eventTarget handleEvent:event sender:self];
+		default:
+		break;
+	}
+
+	return (request.httpResponse.status.error);
+}
+
+#pragma mark - File transfer: ranged download
+- (OCRangedDownloadJob *)rangedDownloadJobForItem:(OCItem *)item fileURL:(NSURL *)fileURL
+{
+	NSUInteger minimumSize = [[self classSettingForOCClassSettingsKey:OCConnectionRangedDownloadMinimumSize] unsignedIntegerValue];
+	NSUInteger chunkSize = [[self classSettingForOCClassSettingsKey:OCConnectionRangedDownloadChunkSize] unsignedIntegerValue];
+	NSUInteger concurrency = [[self classSettingForOCClassSettingsKey:OCConnectionRangedDownloadConcurrency] unsignedIntegerValue];
+	OCRangedDownloadJob *job;
+
+	if ((minimumSize == 0) || (chunkSize == 0) || // Ranged downloads disabled
+	    (item.size < 0) || ((NSUInteger)item.size < minimumSize) || ((NSUInteger)item.size <= chunkSize) || // File too small to benefit
+	    (item.eTag == nil) || [item.eTag isEqual:OCFileETagPlaceholder]) // No ETag to validate ranges against
+	{
+		return (nil);
+	}
+
+	job = [[OCRangedDownloadJob alloc] initWithFileURL:fileURL fileSize:(unsigned long long)item.size eTag:item.eTag chunkSize:chunkSize];
+	job.maximumConcurrentChunks = MAX(concurrency, 1);
+
+	return (job);
+}
+
+- (OCProgress *)_startRangedDownloadJob:(OCRangedDownloadJob *)job forItem:(OCItem *)item options:(OCConnectionOptions)options resultTarget:(OCEventTarget *)eventTarget
+{
+	OCActionTrackingID actionTrackingID = OCConnectionInferActionTrackingID(options, eventTarget);
+	OCActionTrackingID progressTrackingID = (actionTrackingID != nil) ? actionTrackingID : job.identifier;
+	NSProgress *actionProgress;
+	NSError *error = nil;
+
+	if (![job prepareFileWithError:&error])
+	{
+		[eventTarget handleError:error type:OCEventTypeDownload uuid:nil sender:self];
+		return (nil);
+	}
+
+	[job resume];
+
+	// Register job, so that results of chunk requests decoded from the pipeline backend resolve to this instance
+	@synchronized(_rangedDownloadJobsByID)
+	{
+		_rangedDownloadJobsByID[job.identifier] = job;
+	}
+
+	// Set up progress
+	actionProgress = [self progressForActionTrackingID:progressTrackingID provider:^NSProgress * _Nonnull(NSProgress * _Nonnull progress) {
+		progress.totalUnitCount = job.fileSize;
+		progress.completedUnitCount = job.completedByteCount;
+
+		return (progress);
+	}];
+
+	if (actionProgress.totalUnitCount <= 0)
+	{
+		actionProgress.totalUnitCount = job.fileSize;
+		actionProgress.completedUnitCount = job.completedByteCount;
+	}
+
+	actionProgress.eventType = OCEventTypeDownload;
+	actionProgress.localizedDescription = [NSString stringWithFormat:OCLocalizedString(@"Downloading %@…",nil), item.name];
+
+	job.progress = actionProgress;
+
+	OCLogDebug(@"Starting ranged download of %@ (%lu chunks, %llu of %llu bytes already downloaded)", item, (unsigned long)job.chunkCount, job.completedByteCount, job.fileSize);
+
+	// Attach to pipelines
+	[self attachToPipelines];
+
+	if (job.isComplete)
+	{
+		// All chunks were already downloaded before
+		[self _concludeRangedDownloadJob:job item:item error:nil eventTarget:eventTarget actionTrackingID:actionTrackingID];
+	}
+	else
+	{
+		[self _requestChunksOfRangedDownloadJob:job item:item eventTarget:eventTarget actionTrackingID:actionTrackingID cellularSwitch:options[OCConnectionOptionRequiredCellularSwitchKey] requestObserver:options[OCConnectionOptionRequestObserverKey]];
+	}
+
+	return ([[OCProgress alloc] initWithPath:((self.bookmark.uuid != nil) ?
+							@[ OCProgressPathElementIdentifierCoreRoot, self.bookmark.uuidString, OCProgressPathElementIdentifierCoreConnectionPath, progressTrackingID ] :
+							@[])
+					progress:actionProgress]);
+}
+
+- (void)_requestChunksOfRangedDownloadJob:(OCRangedDownloadJob *)job item:(OCItem *)item eventTarget:(OCEventTarget *)eventTarget actionTrackingID:(OCActionTrackingID)actionTrackingID cellularSwitch:(OCCellularSwitchIdentifier)cellularSwitch requestObserver:(OCHTTPRequestObserver)requestObserver
+{
+	NSIndexSet *chunkIndexes = [job requestChunks];
+	NSURL *downloadURL;
+
+	if (chunkIndexes.count == 0)
+	{
+		return;
+	}
+
+	if ((downloadURL = [[self URLForEndpoint:OCConnectionEndpointIDWebDAVRoot options:@{ OCConnectionEndpointURLOptionDriveID : OCNullProtect(item.driveID) }] URLByAppendingPathComponent:item.path]) == nil)
+	{
+		// WebDAV root could not be generated (likely due to lack of username)
+		[chunkIndexes enumerateIndexesUsingBlock:^(NSUInteger chunkIndex, BOOL * _Nonnull stop) {
+			[job abandonChunk:chunkIndex];
+		}];
+
+		[self _concludeRangedDownloadJob:job item:item error:OCError(OCErrorInternal) eventTarget:eventTarget actionTrackingID:actionTrackingID];
+		return;
+	}
+
+	[chunkIndexes enumerateIndexesUsingBlock:^(NSUInteger chunkIndex, BOOL * _Nonnull stop) {
+		NSRange byteRange = [job byteRangeOfChunk:chunkIndex];
+		OCHTTPRequest *request = [OCHTTPRequest requestWithURL:downloadURL];
+
+		request.method = OCHTTPMethodGET;
+		request.requiredSignals = self.actionSignals;
+
+		request.resultHandlerAction = @selector(_handleRangedDownloadChunkResult:error:);
+		request.userInfo = @{
+			@"item" : item,
+			@"job" : job,
+			@"chunk" : @(chunkIndex)
+		};
+		request.eventTarget = eventTarget;
+		request.downloadRequest = YES;
+		request.forceCertificateDecisionDelegation = YES;
+		request.autoResume = YES;
+		request.actionTrackingID = actionTrackingID;
+
+		// If the file changed on the server, If-Range makes it respond with the entire (new) file instead of the range
+		[request setValue:[NSString stringWithFormat:@"bytes=%lu-%lu", (unsigned long)byteRange.location, (unsigned long)NSMaxRange(byteRange)-1] forHeaderField:OCHTTPHeaderFieldNameRange];
+		[request setValue:job.eTag forHeaderField:OCHTTPHeaderFieldNameIfRange];
+
+		// Apply cellular options
+		if (cellularSwitch != nil)
+		{
+			request.requiredCellularSwitch = cellularSwitch;
+		}
+
+		if (requestObserver != nil)
+		{
+			request.requestObserver = requestObserver;
+		}
+
+		// Enqueue request
+		[[self transferPipelineForRequest:request withExpectedResponseLength:byteRange.length] enqueueRequest:request forPartitionID:self.partitionID];
+
+		NSProgress *progress = request.progress.progress;
+
+		if (progress != nil)
+		{
+			[job.progress addChild:progress withPendingUnitCount:byteRange.length];
+		}
+	}];
+}
+
+- (void)_handleRangedDownloadChunkResult:(OCHTTPRequest *)request error:(NSError *)error
+{
+	OCRangedDownloadJob *job = OCTypedCast(request.userInfo[@"job"], OCRangedDownloadJob);
+	OCItem *item = OCTypedCast(request.userInfo[@"item"], OCItem);
+	NSNumber *chunkIndexNumber = OCTypedCast(request.userInfo[@"chunk"], NSNumber);
+	NSUInteger chunkIndex = chunkIndexNumber.unsignedIntegerValue;
+	OCChecksumHeaderString checksumString;
+
+	if ((job == nil) || (item == nil) || (chunkIndexNumber == nil))
+	{
+		OCLogError(@"Ranged download chunk request %@ lacks job, item or chunk information", request);
+		return;
+	}
+
+	// Resolve to the registered instance of the job (requests may have been decoded from the pipeline backend)
+	@synchronized(_rangedDownloadJobsByID)
+	{
+		OCRangedDownloadJob *registeredJob;
+
+		if ((registeredJob = _rangedDownloadJobsByID[job.identifier]) != nil)
+		{
+			job = registeredJob;
+		}
+		else
+		{
+			// Continue a job that was started before the app was relaunched
+			_rangedDownloadJobsByID[job.identifier] = job;
+		}
+	}
+
+	if ((error == nil) && (request.error == nil) && !request.cancelled)
+	{
+		// Record checksum of the entire file
+		if ((job.checksum == nil) && ((checksumString = request.httpResponse.headerFields[@"oc-checksum"]) != nil))
+		{
+			job.checksum = [OCChecksum checksumFromHeaderString:checksumString];
+		}
+
+		if (request.httpResponse.status.code == OCHTTPStatusCodePARTIAL_CONTENT)
+		{
+			// Range of the requested version => write it to the file (even if the job concluded in the meantime, to save the work for a retry)
+			NSString *contentRange = request.httpResponse.headerFields[OCHTTPHeaderFieldNameContentRange];
+			NSRange byteRange = [job byteRangeOfChunk:chunkIndex];
+			unsigned long long firstByte = 0, lastByte = 0, totalBytes = 0;
+
+			if ((request.httpResponse.bodyURL == nil) || (contentRange == nil) || (sscanf(contentRange.UTF8String, "bytes %llu-%llu/%llu", &firstByte, &lastByte, &totalBytes) != 3) ||
+			    (firstByte != byteRange.location) || ((lastByte + 1) != NSMaxRange(byteRange)) || (totalBytes != job.fileSize))
+			{
+				OCLogError(@"Ranged download chunk %lu: unexpected Content-Range %@ (expected %lu-%lu/%llu)", (unsigned long)chunkIndex, contentRange, (unsigned long)byteRange.location, (unsigned long)NSMaxRange(byteRange)-1, job.fileSize);
+				[job abandonChunk:chunkIndex];
+				error = OCError(OCErrorResponseUnknownFormat);
+			}
+			else if (![job storeChunk:chunkIndex fromFileURL:request.httpResponse.bodyURL error:&error])
+			{
+				OCLogError(@"Ranged download chunk %lu: error storing chunk: %@", (unsigned long)chunkIndex, error);
+			}
+		}
+		else if (request.httpResponse.status.code == OCHTTPStatusCodeOK)
+		{
+			// Server responded with the entire file - either because it doesn't support ranges or because the file changed (If-Range)
+			OCFileETag eTag = request.httpResponse.headerFields[@"oc-etag"];
+
+			if (eTag == nil)
+			{
+				eTag = request.httpResponse.headerFields[@"Etag"];
+			}
+
+			[job abandonChunk:chunkIndex];
+
+			// Only accept the file as the requested version if its ETag matches - without ETag, there's no telling which version was returned
+			if ((eTag == nil) || ![eTag isEqual:job.eTag])
+			{
+				OCLogWarning(@"Ranged download of %@: ETag changed from %@ to %@", item, job.eTag, eTag);
+				[job reset];
+
+				error = OCErrorFromError(OCErrorItemChanged, request.httpResponse.status.error);
+			}
+			else if (request.httpResponse.bodyURL == nil)
+			{
+				error = OCError(OCErrorResponseUnknownFormat);
+			}
+			else if (!job.concluded && ![job storeFileFromURL:request.httpResponse.bodyURL error:&error])
+			{
+				OCLogError(@"Ranged download of %@: error storing file: %@", item, error);
+			}
+		}
+		else
+		{
+			[job abandonChunk:chunkIndex];
+			error = [self _errorForFailedDownloadRequest:request];
+		}
+	}
+	else
+	{
+		[job abandonChunk:chunkIndex];
+
+		if (request.cancelled)
+		{
+			error = OCError(OCErrorCancelled);
+		}
+		else if (error == nil)
+		{
+			error = request.error;
+		}
+	}
+
+	if (job.concluded)
+	{
+		// Job already concluded (f.ex. because of an error in another chunk)
+		[self _unregisterConcludedRangedDownloadJob:job];
+		return;
+	}
+
+	if (error != nil)
+	{
+		OCErrorAddDateFromResponse(error, request.httpResponse);
+		[self _concludeRangedDownloadJob:job item:item error:error eventTarget:request.eventTarget actionTrackingID:request.actionTrackingID];
+	}
+	else if (job.isComplete)
+	{
+		[self _concludeRangedDownloadJob:job item:item error:nil eventTarget:request.eventTarget actionTrackingID:request.actionTrackingID];
+	}
+	else
+	{
+		[self _requestChunksOfRangedDownloadJob:job item:item eventTarget:request.eventTarget actionTrackingID:request.actionTrackingID cellularSwitch:request.requiredCellularSwitch requestObserver:request.requestObserver];
+	}
+}
+
+- (void)_concludeRangedDownloadJob:(OCRangedDownloadJob *)job item:(OCItem *)item error:(NSError *)error eventTarget:(OCEventTarget *)eventTarget actionTrackingID:(OCActionTrackingID)actionTrackingID
+{
+	OCEvent *event;
+
+	if (![job conclude])
+	{
+		return;
+	}
+
+	OCLogDebug(@"Ranged download of %@ concluded with error=%@ (%llu of %llu bytes downloaded)", item, error, job.completedByteCount, job.fileSize);
+
+	[self _unregisterConcludedRangedDownloadJob:job];
+
+	job.progress = nil;
+	[self finishActionWithTrackingID:((actionTrackingID != nil) ? actionTrackingID : job.identifier)];
+
+	if ((event = [OCEvent eventForEventTarget:eventTarget type:OCEventTypeDownload uuid:nil attributes:nil]) != nil)
+	{
+		if (error != nil)
+		{
+			event.error = error;
+		}
+		else
+		{
+			OCFile *file = [OCFile new];
+
+			file.item = item;
+			file.url = job.fileURL;
+			file.checksum = job.checksum;
+			file.eTag = job.eTag;
+			file.fileID = item.fileID;
+
+			event.file = file;
+		}
+
+		event.result = job; // Allows the receiver to pick up the latest chunk map
+
+		[eventTarget handleEvent:event sender:self];
+	}
+}
+
+- (void)_unregisterConcludedRangedDownloadJob:(OCRangedDownloadJob *)job
+{
+	@synchronized(_rangedDownloadJobsByID)
+	{
+		// Concluded jobs stay registered until all their chunk requests have returned, so that late results are recognized as belonging to a concluded job
+		if (job.concluded && !job.hasChunksInFlight && (_rangedDownloadJobsByID[job.identifier] == job))
+		{
+			[_rangedDownloadJobsByID removeObjectForKey:job.identifier];
+		}
 	}
 }
 
@@ -3454,6 +3900,9 @@ OCClassSettingsKey OCConnectionAlwaysRequestPrivateLink = @"always-request-priva
 OCClassSettingsKey OCConnectionTransparentTemporaryRedirect = @"transparent-temporary-redirect";
 OCClassSettingsKey OCConnectionValidatorFlags = @"validator-flags";
 OCClassSettingsKey OCConnectionBlockPasswordRemovalDefault = @"block-password-removal-default";
+OCClassSettingsKey OCConnectionRangedDownloadMinimumSize = @"ranged-download-minimum-size";
+OCClassSettingsKey OCConnectionRangedDownloadChunkSize = @"ranged-download-chunk-size";
+OCClassSettingsKey OCConnectionRangedDownloadConcurrency = @"ranged-download-concurrency";
 
 OCConnectionOptionKey OCConnectionOptionRequestObserverKey = @"request-observer";
 OCConnectionOptionKey OCConnectionOptionLastModificationDateKey = @"last-modification-date";
@@ -3467,11 +3916,15 @@ OCConnectionOptionKey OCConnectionOptionTemporarySegmentFolderURLKey = @"tempora
 OCConnectionOptionKey OCConnectionOptionForceReplaceKey = @"force-replace";
 OCConnectionOptionKey OCConnectionOptionResponseDestinationURL = @"response-destination-url";
 OCConnectionOptionKey OCConnectionOptionResponseStreamHandler = @"response-stream-handler";
+OCConnectionOptionKey OCConnectionOptionResponseItemBatchHandler = @"response-item-batch-handler";
+OCConnectionOptionKey OCConnectionOptionResponseItemBatchRestartHandler = @"response-item-batch-restart-handler";
+OCConnectionOptionKey OCConnectionOptionResponseItemBatchSize = @"response-item-batch-size";
 OCConnectionOptionKey OCConnectionOptionDriveID = @"drive-id";
 OCConnectionOptionKey OCConnectionOptionParentItem = @"parent-item";
 OCConnectionOptionKey OCConnectionOptionSyncRecordID = @"sync-record-id";
 OCConnectionOptionKey OCConnectionOptionAlternativeEventType = @"alternativeEventType";
 OCConnectionOptionKey OCConnectionOptionActionTrackingID = @"action-tracking-id";
+OCConnectionOptionKey OCConnectionOptionRangedDownloadJob = @"ranged-download-job";
 
 OCConnectionSetupOptionKey OCConnectionSetupOptionUserName = @"user-name";
 
@@ -0,0 +1,88 @@
+//
+//  OCRangedDownloadJob.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCTypes.h"
+#import "OCChecksum.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class OCItem;
+
+/*
+	Download of a file in byte ranges ("chunks") that are requested concurrently and written into .fileURL at their
+	offsets as they arrive.
+
+	The chunk map (one bit per chunk) is part of the job's encoded state. Sync actions keep the job in their sync record,
+	so that an interrupted download only requests the chunks that are still missing when it is resumed. Chunks are
+	requested with If-Range set to .eTag, so a server holding a different version of the file returns the entire file
+	instead of a range of it.
+
+	The job is thread-safe.
+*/
+
+@interface OCRangedDownloadJob : NSObject <NSSecureCoding>
+
+@property(strong,readonly) NSString *identifier;
+
+@property(strong,readonly) NSURL *fileURL; //!< URL of the file the chunks are assembled in
+@property(readonly) unsigned long long fileSize;
+@property(strong,readonly) OCFileETag eTag; //!< ETag of the item version to download
+
+@property(readonly) NSUInteger chunkSize;
+@property(assign) NSUInteger maximumConcurrentChunks; //!< Maximum number of chunks to request concurrently
+
+@property(strong,nullable) OCChecksum *checksum; //!< Checksum of the entire file, as provided by the server
+
+@property(strong,nullable) NSProgress *progress; //!< Progress of the job (not encoded)
+
+@property(copy,nullable) void(^chunkStoredHandler)(OCRangedDownloadJob *job); //!< Called after a chunk was stored, f.ex. to persist the chunk map (not encoded)
+
+@property(readonly,nonatomic) NSUInteger chunkCount;
+@property(readonly,nonatomic) unsigned long long completedByteCount;
+@property(readonly,nonatomic) BOOL isComplete;
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL fileSize:(unsigned long long)fileSize eTag:(OCFileETag)eTag chunkSize:(NSUInteger)chunkSize;
+
+- (BOOL)isValidForItem:(OCItem *)item; //!< Returns YES if the job downloads the current version of the item and its file still exists
+
+#pragma mark - File
+- (BOOL)prepareFileWithError:(NSError * _Nullable * _Nullable)outError; //!< Creates the file at .fileURL if it doesn't exist yet
+- (void)destroy; //!< Removes the file at .fileURL
+
+#pragma mark - Chunks
+- (NSRange)byteRangeOfChunk:(NSUInteger)chunkIndex;
+- (BOOL)isChunkComplete:(NSUInteger)chunkIndex;
+
+- (NSIndexSet *)requestChunks; //!< Returns the incomplete chunks that can be requested without exceeding .maximumConcurrentChunks and marks them as in flight
+- (void)abandonChunk:(NSUInteger)chunkIndex; //!< Marks a chunk returned by -requestChunks as no longer in flight
+@property(readonly,nonatomic) BOOL hasChunksInFlight; //!< YES while chunks returned by -requestChunks have neither been stored nor abandoned
+
+- (BOOL)storeChunk:(NSUInteger)chunkIndex fromFileURL:(NSURL *)chunkFileURL error:(NSError * _Nullable * _Nullable)outError; //!< Writes the contents of chunkFileURL into the file at the offset of the chunk and marks the chunk as complete
+- (BOOL)storeFileFromURL:(NSURL *)sourceFileURL error:(NSError * _Nullable * _Nullable)outError; //!< Replaces the file with the (complete) file at sourceFileURL and marks all chunks as complete
+
+- (void)reset; //!< Marks all chunks as incomplete. Chunks in flight remain in flight until stored or abandoned.
+
+#pragma mark - Conclusion
+- (BOOL)conclude; //!< Returns YES if the job wasn't concluded before and marks it as concluded (not encoded). Chunks in flight remain in flight, so they aren't requested again if the job is resumed before their requests return.
+- (void)resume; //!< Marks the job as no longer concluded
+@property(readonly,nonatomic) BOOL concluded;
+
+@end
+
+NS_ASSUME_NONNULL_END
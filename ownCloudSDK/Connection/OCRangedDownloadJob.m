@@ -0,0 +1,446 @@
+//
+//  OCRangedDownloadJob.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCRangedDownloadJob.h"
+#import "OCItem.h"
+#import "OCLogger.h"
+#import "NSError+OCError.h"
+
+static const NSUInteger OCRangedDownloadJobCopyBlockSize = 1024 * 1024; //!< Size of the blocks in which chunks are copied into the file
+
+@implementation OCRangedDownloadJob
+{
+	NSMutableData *_chunkMap; //!< One bit per chunk, set if the chunk is complete
+	NSMutableIndexSet *_chunksInFlight;
+	BOOL _concluded;
+}
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL fileSize:(unsigned long long)fileSize eTag:(OCFileETag)eTag chunkSize:(NSUInteger)chunkSize
+{
+	if ((self = [super init]) != nil)
+	{
+		_identifier = NSUUID.UUID.UUIDString;
+
+		_fileURL = fileURL;
+		_fileSize = fileSize;
+		_eTag = eTag;
+
+		_chunkSize = MAX(chunkSize, 1);
+		_maximumConcurrentChunks = 4;
+
+		_chunksInFlight = [NSMutableIndexSet new];
+		_chunkMap = [[NSMutableData alloc] initWithLength:(self.chunkCount + 7) / 8];
+	}
+
+	return (self);
+}
+
+- (BOOL)isValidForItem:(OCItem *)item
+{
+	return ([item.eTag isEqual:_eTag] && ((unsigned long long)item.size == _fileSize) && (_fileURL != nil) && [NSFileManager.defaultManager fileExistsAtPath:_fileURL.path]);
+}
+
+#pragma mark - File
+- (BOOL)prepareFileWithError:(NSError * _Nullable * _Nullable)outError
+{
+	NSError *error = nil;
+	NSFileHandle *fileHandle;
+
+	if (![NSFileManager.defaultManager fileExistsAtPath:_fileURL.path])
+	{
+		if (![NSFileManager.defaultManager createFileAtPath:_fileURL.path contents:nil attributes:nil])
+		{
+			OCLogError(@"Error creating ranged download file %@", _fileURL);
+
+			if (outError != NULL)
+			{
+				*outError = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteUnknownError userInfo:@{ NSURLErrorKey : _fileURL }];
+			}
+
+			return (NO);
+		}
+
+		@synchronized(self)
+		{
+			// Contents of a file that had to be recreated are lost
+			[_chunkMap resetBytesInRange:NSMakeRange(0, _chunkMap.length)];
+		}
+	}
+
+	// Allocate the full file size, so that chunks can be written at their offsets in any order
+	if ((fileHandle = [NSFileHandle fileHandleForWritingToURL:_fileURL error:&error]) != nil)
+	{
+		if (![fileHandle truncateAtOffset:_fileSize error:&error])
+		{
+			OCLogError(@"Error resizing ranged download file %@ to %llu bytes: %@", _fileURL, _fileSize, error);
+		}
+
+		[fileHandle closeAndReturnError:NULL];
+	}
+	else
+	{
+		OCLogError(@"Error opening ranged download file %@ for writing: %@", _fileURL, error);
+	}
+
+	if ((error != nil) && (outError != NULL))
+	{
+		*outError = error;
+	}
+
+	return (error == nil);
+}
+
+- (void)destroy
+{
+	if (_fileURL != nil)
+	{
+		NSError *error = nil;
+
+		if ([NSFileManager.defaultManager fileExistsAtPath:_fileURL.path])
+		{
+			[NSFileManager.defaultManager removeItemAtURL:_fileURL error:&error];
+
+			OCFileOpLog(@"rm", error, @"Removed ranged download file at %@", _fileURL.path);
+		}
+	}
+
+	[self reset];
+}
+
+#pragma mark - Chunks
+- (NSUInteger)chunkCount
+{
+	return ((NSUInteger)((_fileSize + _chunkSize - 1) / _chunkSize));
+}
+
+- (NSRange)byteRangeOfChunk:(NSUInteger)chunkIndex
+{
+	unsigned long long offset = (unsigned long long)chunkIndex * _chunkSize;
+
+	if (offset >= _fileSize)
+	{
+		return (NSMakeRange(NSNotFound, 0));
+	}
+
+	return (NSMakeRange((NSUInteger)offset, (NSUInteger)MIN((unsigned long long)_chunkSize, _fileSize - offset)));
+}
+
+- (BOOL)_isChunkComplete:(NSUInteger)chunkIndex
+{
+	if ((chunkIndex / 8) >= _chunkMap.length) { return (NO); }
+
+	return ((((const uint8_t *)_chunkMap.bytes)[chunkIndex / 8] & (1 << (chunkIndex % 8))) != 0);
+}
+
+- (BOOL)isChunkComplete:(NSUInteger)chunkIndex
+{
+	@synchronized(self)
+	{
+		return ([self _isChunkComplete:chunkIndex]);
+	}
+}
+
+- (unsigned long long)completedByteCount
+{
+	unsigned long long completedByteCount = 0;
+	NSUInteger chunkCount = self.chunkCount;
+
+	@synchronized(self)
+	{
+		for (NSUInteger chunkIndex=0; chunkIndex < chunkCount; chunkIndex++)
+		{
+			if ([self _isChunkComplete:chunkIndex])
+			{
+				completedByteCount += [self byteRangeOfChunk:chunkIndex].length;
+			}
+		}
+	}
+
+	return (completedByteCount);
+}
+
+- (BOOL)isComplete
+{
+	NSUInteger chunkCount = self.chunkCount;
+
+	@synchronized(self)
+	{
+		for (NSUInteger chunkIndex=0; chunkIndex < chunkCount; chunkIndex++)
+		{
+			if (![self _isChunkComplete:chunkIndex])
+			{
+				return (NO);
+			}
+		}
+	}
+
+	return (YES);
+}
+
+- (NSIndexSet *)requestChunks
+{
+	NSMutableIndexSet *requestChunks = [NSMutableIndexSet new];
+	NSUInteger chunkCount = self.chunkCount;
+
+	@synchronized(self)
+	{
+		for (NSUInteger chunkIndex=0; (chunkIndex < chunkCount) && (_chunksInFlight.count < MAX(_maximumConcurrentChunks, 1)); chunkIndex++)
+		{
+			if (![self _isChunkComplete:chunkIndex] && ![_chunksInFlight containsIndex:chunkIndex])
+			{
+				[_chunksInFlight addIndex:chunkIndex];
+				[requestChunks addIndex:chunkIndex];
+			}
+		}
+	}
+
+	return (requestChunks);
+}
+
+- (void)abandonChunk:(NSUInteger)chunkIndex
+{
+	@synchronized(self)
+	{
+		[_chunksInFlight removeIndex:chunkIndex];
+	}
+}
+
+- (BOOL)hasChunksInFlight
+{
+	@synchronized(self)
+	{
+		return (_chunksInFlight.count > 0);
+	}
+}
+
+- (BOOL)storeChunk:(NSUInteger)chunkIndex fromFileURL:(NSURL *)chunkFileURL error:(NSError * _Nullable * _Nullable)outError
+{
+	NSRange byteRange = [self byteRangeOfChunk:chunkIndex];
+	NSFileHandle *srcFile = nil, *dstFile = nil;
+	NSUInteger bytesCopied = 0;
+	NSError *error = nil;
+
+	do
+	{
+		if (byteRange.location == NSNotFound)
+		{
+			error = OCError(OCErrorInsufficientParameters);
+			break;
+		}
+
+		if ((srcFile = [NSFileHandle fileHandleForReadingFromURL:chunkFileURL error:&error]) == nil)
+		{
+			OCLogError(@"Error opening chunk file %@ for reading: %@", chunkFileURL, error);
+			break;
+		}
+
+		if ((dstFile = [NSFileHandle fileHandleForWritingToURL:_fileURL error:&error]) == nil)
+		{
+			OCLogError(@"Error opening ranged download file %@ for writing: %@", _fileURL, error);
+			break;
+		}
+
+		if (![dstFile seekToOffset:byteRange.location error:&error])
+		{
+			OCLogError(@"Error seeking to position %lu in file %@: %@", (unsigned long)byteRange.location, _fileURL, error);
+			break;
+		}
+
+		while (bytesCopied < byteRange.length)
+		{
+			@autoreleasepool {
+				NSData *data;
+
+				if ((data = [srcFile readDataUpToLength:MIN(OCRangedDownloadJobCopyBlockSize, byteRange.length - bytesCopied) error:&error]) == nil)
+				{
+					OCLogError(@"Error reading from chunk file %@: %@", chunkFileURL, error);
+					break;
+				}
+
+				if (data.length == 0)
+				{
+					break;
+				}
+
+				if (![dstFile writeData:data error:&error])
+				{
+					OCLogError(@"Error writing %lu bytes to file %@: %@", (unsigned long)data.length, _fileURL, error);
+					break;
+				}
+
+				bytesCopied += data.length;
+			}
+		}
+
+		if ((error == nil) && (bytesCopied != byteRange.length))
+		{
+			OCLogError(@"Chunk %lu of %@ has %lu bytes, expected %lu", (unsigned long)chunkIndex, _fileURL, (unsigned long)bytesCopied, (unsigned long)byteRange.length);
+			error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError userInfo:@{ NSURLErrorKey : chunkFileURL }];
+		}
+	}while(false);
+
+	[srcFile closeAndReturnError:NULL];
+	[dstFile closeAndReturnError:NULL];
+
+	@synchronized(self)
+	{
+		[_chunksInFlight removeIndex:chunkIndex];
+
+		if (error == nil)
+		{
+			((uint8_t *)_chunkMap.mutableBytes)[chunkIndex / 8] |= (1 << (chunkIndex % 8));
+		}
+	}
+
+	if (error == nil)
+	{
+		void (^chunkStoredHandler)(OCRangedDownloadJob *job);
+
+		if ((chunkStoredHandler = self.chunkStoredHandler) != nil)
+		{
+			chunkStoredHandler(self);
+		}
+	}
+	else if (outError != NULL)
+	{
+		*outError = error;
+	}
+
+	return (error == nil);
+}
+
+- (BOOL)storeFileFromURL:(NSURL *)sourceFileURL error:(NSError * _Nullable * _Nullable)outError
+{
+	NSError *error = nil;
+
+	@synchronized(self)
+	{
+		[NSFileManager.defaultManager removeItemAtURL:_fileURL error:NULL];
+
+		if ([NSFileManager.defaultManager moveItemAtURL:sourceFileURL toURL:_fileURL error:&error])
+		{
+			memset(_chunkMap.mutableBytes, 0xFF, _chunkMap.length);
+		}
+		else
+		{
+			[_chunkMap resetBytesInRange:NSMakeRange(0, _chunkMap.length)];
+		}
+
+		OCFileOpLog(@"mv", error, @"Moved complete download %@ to %@", sourceFileURL.path, _fileURL.path);
+	}
+
+	if ((error != nil) && (outError != NULL))
+	{
+		*outError = error;
+	}
+
+	return (error == nil);
+}
+
+- (void)reset
+{
+	@synchronized(self)
+	{
+		[_chunkMap resetBytesInRange:NSMakeRange(0, _chunkMap.length)];
+	}
+}
+
+#pragma mark - Conclusion
+- (BOOL)conclude
+{
+	@synchronized(self)
+	{
+		if (_concluded) { return (NO); }
+
+		_concluded = YES;
+
+		return (YES);
+	}
+}
+
+- (void)resume
+{
+	@synchronized(self)
+	{
+		_concluded = NO;
+	}
+}
+
+- (BOOL)concluded
+{
+	@synchronized(self)
+	{
+		return (_concluded);
+	}
+}
+
+#pragma mark - NSSecureCoding
++ (BOOL)supportsSecureCoding
+{
+	return (YES);
+}
+
+- (instancetype)initWithCoder:(NSCoder *)coder
+{
+	if ((self = [super init]) != nil)
+	{
+		_identifier = [coder decodeObjectOfClass:NSString.class forKey:@"identifier"];
+
+		_fileURL = [coder decodeObjectOfClass:NSURL.class forKey:@"fileURL"];
+		_fileSize = (unsigned long long)[coder decodeInt64ForKey:@"fileSize"];
+		_eTag = [coder decodeObjectOfClass:NSString.class forKey:@"eTag"];
+
+		_chunkSize = MAX((NSUInteger)[coder decodeInt64ForKey:@"chunkSize"], 1);
+		_maximumConcurrentChunks = (NSUInteger)[coder decodeInt64ForKey:@"maximumConcurrentChunks"];
+
+		_checksum = [coder decodeObjectOfClass:OCChecksum.class forKey:@"checksum"];
+
+		_chunksInFlight = [NSMutableIndexSet new];
+		_chunkMap = [[NSMutableData alloc] initWithLength:(self.chunkCount + 7) / 8];
+
+		NSData *chunkMap;
+
+		if (((chunkMap = [coder decodeObjectOfClass:NSData.class forKey:@"chunkMap"]) != nil) && (chunkMap.length == _chunkMap.length))
+		{
+			[_chunkMap setData:chunkMap];
+		}
+	}
+
+	return (self);
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder
+{
+	[coder encodeObject:_identifier forKey:@"identifier"];
+
+	[coder encodeObject:_fileURL forKey:@"fileURL"];
+	[coder encodeInt64:(int64_t)_fileSize forKey:@"fileSize"];
+	[coder encodeObject:_eTag forKey:@"eTag"];
+
+	[coder encodeInt64:(int64_t)_chunkSize forKey:@"chunkSize"];
+	[coder encodeInt64:(int64_t)_maximumConcurrentChunks forKey:@"maximumConcurrentChunks"];
+
+	[coder encodeObject:_checksum forKey:@"checksum"];
+
+	@synchronized(self)
+	{
+		[coder encodeObject:[_chunkMap copy] forKey:@"chunkMap"];
+	}
+}
+
+@end
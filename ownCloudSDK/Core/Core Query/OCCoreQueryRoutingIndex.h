@@ -0,0 +1,50 @@
+//
+//  OCCoreQueryRoutingIndex.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCQuery.h"
+#import "OCCoreItemList.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+	Index of running queries, used to dispatch item changes only to the queries that can possibly be affected by them:
+
+	- queries targeting a location are indexed by drive ID and path. They receive changes to items located directly in
+	  that path, changes to the item at that path (root item), removals of ancestor folders and moves of the folder itself.
+	- queries targeting an item are indexed by drive ID and path as well as by local ID of the item.
+	- queries targeting sync anchors and custom (condition-based) queries need to evaluate every change and are kept in a
+	  separate bucket that receives all changes.
+
+	The index is not thread-safe. OCCore accesses it only while holding @synchronized(_queries).
+*/
+
+@interface OCCoreQueryRoutingIndex : NSObject
+
+@property(readonly,nonatomic) NSUInteger count; //!< Number of indexed queries
+@property(readonly,strong,nonatomic) NSArray<OCQuery *> *queries; //!< All indexed queries, in the order they were added
+
+- (void)addQuery:(OCQuery *)query;
+- (void)removeQuery:(OCQuery *)query;
+- (void)reindexQuery:(OCQuery *)query; //!< Updates the index entries of a query after its .queryLocation or .queryItem changed
+
+- (NSArray<OCQuery *> *)queriesForAddedItems:(nullable OCCoreItemList *)addedItemList removedItems:(nullable OCCoreItemList *)removedItemList updatedItems:(nullable OCCoreItemList *)updatedItemList movedFolderItems:(nullable NSArray<OCItem *> *)movedFolderItems; //!< Returns the queries that can possibly be affected by the changes, in the order they were added
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,387 @@
+//
+//  OCCoreQueryRoutingIndex.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCCoreQueryRoutingIndex.h"
+#import "OCDrive.h"
+#import "NSString+OCPath.h"
+
+@interface OCCoreQueryRoutingRecord : NSObject
+{
+	@public
+	NSUInteger sequence; //!< Order in which the query was added
+
+	OCDriveID locationDriveID;
+	OCPath locationPath;
+
+	OCDriveID itemDriveID;
+	OCPath itemPath;
+	OCLocalID itemLocalID;
+
+	BOOL unconditional;
+}
+@end
+
+@implementation OCCoreQueryRoutingRecord
+@end
+
+typedef NSMutableDictionary<OCDriveID, NSMutableDictionary<OCPath, NSMutableArray<OCQuery *> *> *> OCCoreQueryRoutingPathIndex;
+
+@interface OCCoreQueryRoutingIndex ()
+{
+	NSMapTable<OCQuery *, OCCoreQueryRoutingRecord *> *_recordsByQuery;
+	NSMutableArray<OCQuery *> *_queries;
+	NSUInteger _nextSequence;
+
+	OCCoreQueryRoutingPathIndex *_locationQueriesByDriveIDAndPath;
+	OCCoreQueryRoutingPathIndex *_itemQueriesByDriveIDAndPath;
+	NSMutableDictionary<OCLocalID, NSMutableArray<OCQuery *> *> *_itemQueriesByLocalID;
+	NSMutableArray<OCQuery *> *_unconditionalQueries;
+}
+@end
+
+@implementation OCCoreQueryRoutingIndex
+
+- (instancetype)init
+{
+	if ((self = [super init]) != nil)
+	{
+		_recordsByQuery = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory];
+		_queries = [NSMutableArray new];
+
+		_locationQueriesByDriveIDAndPath = [NSMutableDictionary new];
+		_itemQueriesByDriveIDAndPath = [NSMutableDictionary new];
+		_itemQueriesByLocalID = [NSMutableDictionary new];
+		_unconditionalQueries = [NSMutableArray new];
+	}
+
+	return (self);
+}
+
+- (NSUInteger)count
+{
+	return (_queries.count);
+}
+
+- (NSArray<OCQuery *> *)queries
+{
+	return ([_queries copy]);
+}
+
+#pragma mark - Index management
+static void OCCoreQueryRoutingPathIndexAdd(OCCoreQueryRoutingPathIndex *index, OCDriveID driveID, OCPath path, OCQuery *query)
+{
+	NSMutableDictionary<OCPath, NSMutableArray<OCQuery *> *> *queriesByPath;
+	NSMutableArray<OCQuery *> *queries;
+
+	if ((queriesByPath = index[driveID]) == nil)
+	{
+		queriesByPath = [NSMutableDictionary new];
+		index[driveID] = queriesByPath;
+	}
+
+	if ((queries = queriesByPath[path]) == nil)
+	{
+		queries = [NSMutableArray new];
+		queriesByPath[path] = queries;
+	}
+
+	[queries addObject:query];
+}
+
+static void OCCoreQueryRoutingPathIndexRemove(OCCoreQueryRoutingPathIndex *index, OCDriveID driveID, OCPath path, OCQuery *query)
+{
+	NSMutableDictionary<OCPath, NSMutableArray<OCQuery *> *> *queriesByPath;
+	NSMutableArray<OCQuery *> *queries;
+
+	if (((queriesByPath = index[driveID]) != nil) && ((queries = queriesByPath[path]) != nil))
+	{
+		[queries removeObjectIdenticalTo:query];
+
+		if (queries.count == 0)
+		{
+			[queriesByPath removeObjectForKey:path];
+
+			if (queriesByPath.count == 0)
+			{
+				[index removeObjectForKey:driveID];
+			}
+		}
+	}
+}
+
+- (void)_indexQuery:(OCQuery *)query withRecord:(OCCoreQueryRoutingRecord *)record
+{
+	OCPath path;
+	OCItem *queryItem;
+
+	if ((path = query.queryLocation.path) != nil)
+	{
+		record->locationDriveID = OCDriveIDWrap(query.queryLocation.driveID);
+		record->locationPath = path;
+
+		OCCoreQueryRoutingPathIndexAdd(_locationQueriesByDriveIDAndPath, record->locationDriveID, record->locationPath, query);
+	}
+
+	if ((queryItem = query.queryItem) != nil)
+	{
+		record->itemDriveID = OCDriveIDWrap(queryItem.driveID);
+
+		if ((record->itemPath = queryItem.path) != nil)
+		{
+			OCCoreQueryRoutingPathIndexAdd(_itemQueriesByDriveIDAndPath, record->itemDriveID, record->itemPath, query);
+		}
+
+		if ((record->itemLocalID = queryItem.localID) != nil)
+		{
+			NSMutableArray<OCQuery *> *queries;
+
+			if ((queries = _itemQueriesByLocalID[record->itemLocalID]) == nil)
+			{
+				queries = [NSMutableArray new];
+				_itemQueriesByLocalID[record->itemLocalID] = queries;
+			}
+
+			[queries addObject:query];
+		}
+	}
+
+	// Queries that need to see every change
+	if ((query.querySinceSyncAnchor != nil) || query.isCustom)
+	{
+		record->unconditional = YES;
+		[_unconditionalQueries addObject:query];
+	}
+}
+
+- (void)_unindexQuery:(OCQuery *)query withRecord:(OCCoreQueryRoutingRecord *)record
+{
+	if (record->locationPath != nil)
+	{
+		OCCoreQueryRoutingPathIndexRemove(_locationQueriesByDriveIDAndPath, record->locationDriveID, record->locationPath, query);
+
+		record->locationDriveID = nil;
+		record->locationPath = nil;
+	}
+
+	if (record->itemPath != nil)
+	{
+		OCCoreQueryRoutingPathIndexRemove(_itemQueriesByDriveIDAndPath, record->itemDriveID, record->itemPath, query);
+		record->itemPath = nil;
+	}
+
+	if (record->itemLocalID != nil)
+	{
+		NSMutableArray<OCQuery *> *queries;
+
+		if ((queries = _itemQueriesByLocalID[record->itemLocalID]) != nil)
+		{
+			[queries removeObjectIdenticalTo:query];
+
+			if (queries.count == 0)
+			{
+				[_itemQueriesByLocalID removeObjectForKey:record->itemLocalID];
+			}
+		}
+
+		record->itemLocalID = nil;
+	}
+
+	record->itemDriveID = nil;
+
+	if (record->unconditional)
+	{
+		[_unconditionalQueries removeObjectIdenticalTo:query];
+		record->unconditional = NO;
+	}
+}
+
+- (void)addQuery:(OCQuery *)query
+{
+	OCCoreQueryRoutingRecord *record;
+
+	if ([_recordsByQuery objectForKey:query] != nil)
+	{
+		return;
+	}
+
+	record = [OCCoreQueryRoutingRecord new];
+	record->sequence = _nextSequence++;
+
+	[_recordsByQuery setObject:record forKey:query];
+	[_queries addObject:query];
+
+	[self _indexQuery:query withRecord:record];
+}
+
+- (void)removeQuery:(OCQuery *)query
+{
+	OCCoreQueryRoutingRecord *record;
+
+	if ((record = [_recordsByQuery objectForKey:query]) != nil)
+	{
+		[self _unindexQuery:query withRecord:record];
+
+		[_recordsByQuery removeObjectForKey:query];
+		[_queries removeObjectIdenticalTo:query];
+	}
+}
+
+- (void)reindexQuery:(OCQuery *)query
+{
+	OCCoreQueryRoutingRecord *record;
+
+	if ((record = [_recordsByQuery objectForKey:query]) != nil)
+	{
+		[self _unindexQuery:query withRecord:record];
+		[self _indexQuery:query withRecord:record];
+	}
+}
+
+#pragma mark - Routing
+- (NSArray<OCQuery *> *)queriesForAddedItems:(OCCoreItemList *)addedItemList removedItems:(OCCoreItemList *)removedItemList updatedItems:(OCCoreItemList *)updatedItemList movedFolderItems:(NSArray<OCItem *> *)movedFolderItems
+{
+	NSHashTable<OCQuery *> *candidates = [NSHashTable hashTableWithOptions:(NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality)];
+	NSMutableArray<OCQuery *> *routedQueries;
+
+	if (_queries.count == 0)
+	{
+		return (@[]);
+	}
+
+	#define AddCandidates(queryArray) for (OCQuery *candidate in queryArray) { [candidates addObject:candidate]; }
+
+	// Queries that see every change
+	if ((addedItemList != nil) || (removedItemList != nil) || (updatedItemList != nil))
+	{
+		AddCandidates(_unconditionalQueries);
+	}
+
+	for (OCCoreItemList *itemList in @[ (addedItemList != nil) ? addedItemList : NSNull.null, (removedItemList != nil) ? removedItemList : NSNull.null, (updatedItemList != nil) ? updatedItemList : NSNull.null ])
+	{
+		if (![itemList isKindOfClass:OCCoreItemList.class]) { continue; }
+
+		[itemList.itemListsByDriveID enumerateKeysAndObjectsUsingBlock:^(OCDriveID driveID, OCCoreItemList *driveItemList, BOOL *stop) {
+			NSMutableDictionary<OCPath, NSMutableArray<OCQuery *> *> *locationQueriesByPath = self->_locationQueriesByDriveIDAndPath[driveID];
+			NSMutableDictionary<OCPath, NSMutableArray<OCQuery *> *> *itemQueriesByPath = self->_itemQueriesByDriveIDAndPath[driveID];
+
+			if (locationQueriesByPath != nil)
+			{
+				// Items located directly inside a query's location
+				for (OCPath parentPath in driveItemList.itemsByParentPaths)
+				{
+					AddCandidates(locationQueriesByPath[parentPath]);
+				}
+
+				// Items at a query's location (root items)
+				for (OCPath path in driveItemList.itemsByPath)
+				{
+					AddCandidates(locationQueriesByPath[path]);
+				}
+			}
+
+			if (itemQueriesByPath != nil)
+			{
+				// Items targeted by item queries, by path
+				for (OCPath path in driveItemList.itemsByPath)
+				{
+					AddCandidates(itemQueriesByPath[path]);
+				}
+			}
+		}];
+
+		// Items targeted by item queries, by local ID
+		if (_itemQueriesByLocalID.count > 0)
+		{
+			for (OCLocalID localID in itemList.itemsByLocalID)
+			{
+				AddCandidates(_itemQueriesByLocalID[localID]);
+			}
+		}
+	}
+
+	// Removed ancestor folders of query locations
+	[removedItemList.itemListsByDriveID enumerateKeysAndObjectsUsingBlock:^(OCDriveID driveID, OCCoreItemList *driveItemList, BOOL *stop) {
+		NSMutableDictionary<OCPath, NSMutableArray<OCQuery *> *> *locationQueriesByPath;
+		NSMutableArray<OCPath> *removedFolderPaths = nil;
+
+		if ((locationQueriesByPath = self->_locationQueriesByDriveIDAndPath[driveID]) == nil)
+		{
+			return;
+		}
+
+		for (OCItem *removedItem in driveItemList.items)
+		{
+			OCPath removedItemPath = removedItem.path;
+
+			if (removedItemPath.isNormalizedDirectoryPath)
+			{
+				if (removedFolderPaths == nil) { removedFolderPaths = [NSMutableArray new]; }
+				[removedFolderPaths addObject:removedItemPath];
+			}
+		}
+
+		if (removedFolderPaths != nil)
+		{
+			[locationQueriesByPath enumerateKeysAndObjectsUsingBlock:^(OCPath queryPath, NSMutableArray<OCQuery *> *queries, BOOL *stop) {
+				for (OCPath removedFolderPath in removedFolderPaths)
+				{
+					if ([queryPath hasPrefix:removedFolderPath])
+					{
+						AddCandidates(queries);
+						break;
+					}
+				}
+			}];
+		}
+	}];
+
+	// Moved folders targeted by queries
+	for (OCItem *movedFolderItem in movedFolderItems)
+	{
+		OCPath previousPath;
+
+		if ((previousPath = movedFolderItem.previousPath) != nil)
+		{
+			AddCandidates(_locationQueriesByDriveIDAndPath[OCDriveIDWrap(movedFolderItem.driveID)][previousPath]);
+		}
+	}
+
+	#undef AddCandidates
+
+	// Return candidates in the order they were added
+	routedQueries = [[NSMutableArray alloc] initWithCapacity:candidates.count];
+
+	for (OCQuery *query in candidates)
+	{
+		[routedQueries addObject:query];
+	}
+
+	if (routedQueries.count > 1)
+	{
+		[routedQueries sortUsingComparator:^NSComparisonResult(OCQuery *query1, OCQuery *query2) {
+			NSUInteger sequence1 = ((OCCoreQueryRoutingRecord *)[self->_recordsByQuery objectForKey:query1])->sequence;
+			NSUInteger sequence2 = ((OCCoreQueryRoutingRecord *)[self->_recordsByQuery objectForKey:query2])->sequence;
+
+			return ((sequence1 < sequence2) ? NSOrderedAscending : ((sequence1 > sequence2) ? NSOrderedDescending : NSOrderedSame));
+		}];
+	}
+
+	return (routedQueries);
+}
+
+@end
@@ -40,6 +40,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark - Update Scans
 - (void)scheduleUpdateScanForLocation:(OCLocation *)location waitForNextQueueCycle:(BOOL)waitForNextQueueCycle;
+- (void)scheduleUpdateScanForFolderItem:(OCItem *)folderItem waitForNextQueueCycle:(BOOL)waitForNextQueueCycle; //!< Schedules a scan of the folder, which is skipped if its contents have already been retrieved at the folder item's eTag by the time it is due
 - (void)recoverPendingUpdateJobs;
 
 - (void)coordinatedScanForChanges;
@@ -35,6 +35,7 @@
 #import "OCScanJobActivity.h"
 #import "OCMeasurement.h"
 #import "OCCoreUpdateScheduleRecord.h"
+#import "OCCoreScanPlanner.h"
 #import "OCLockManager.h"
 #import "OCLockRequest.h"
 #import "OCConnection+GraphAPI.h"
@@ -140,8 +141,6 @@ static OCHTTPRequestGroupID OCCoreItemListTaskGroupBackgroundTasks = @"backgroun
 
 - (void)scheduleNextItemListTask
 {
-	OCCoreDirectoryUpdateJob *nextUpdateJob = nil;
-
 	@synchronized(_queuedItemListTaskUpdateJobs)
 	{
 		if ((self.state != OCCoreStateStopping) && (self.state != OCCoreStateStopped))
@@ -155,57 +154,56 @@ static OCHTTPRequestGroupID OCCoreItemListTaskGroupBackgroundTasks = @"backgroun
 				}
 			}
 
-			// Check for free capacities and try to fill them
-			if (_scheduledItemListTasks.count < self.parallelItemListTaskCount)
+			// Check for free capacities and fill them (so that f.ex. sibling folders are requested in parallel)
+			while (_scheduledItemListTasks.count < self.parallelItemListTaskCount)
 			{
-				// Check for high-priority query item list update jobs
-				for (OCCoreDirectoryUpdateJob *updateJob in _queuedItemListTaskUpdateJobs)
-				{
-					if (updateJob.isForQuery)
-					{
-						nextUpdateJob = updateJob;
-						break;
-					}
-				}
+				OCCoreDirectoryUpdateJob *nextUpdateJob;
+				OCCoreItemListTask *task;
 
-				if (nextUpdateJob == nil)
+				// Pick high-priority query item list update jobs first, then the background job most likely to contain changes
+				if ((nextUpdateJob = [_scanPlanner nextUpdateJobFrom:_queuedItemListTaskUpdateJobs]) == nil)
 				{
-					// If no high-priority query item list update job has been found => proceed with top of the list
-					nextUpdateJob = _queuedItemListTaskUpdateJobs.firstObject;
+					break;
 				}
 
-				if (nextUpdateJob != nil)
-				{
-					// Remove the update job and any targeting the same path (effectively coalescating the tasks)
-					NSMutableIndexSet *removeIndexes = [NSMutableIndexSet new];
+				// Remove the update job and any targeting the same path (effectively coalescating the tasks)
+				NSMutableIndexSet *removeIndexes = [NSMutableIndexSet new];
 
-					[_queuedItemListTaskUpdateJobs enumerateObjectsUsingBlock:^(OCCoreDirectoryUpdateJob * _Nonnull updateJob, NSUInteger idx, BOOL * _Nonnull stop) {
-						if (nextUpdateJob == updateJob)
+				[_queuedItemListTaskUpdateJobs enumerateObjectsUsingBlock:^(OCCoreDirectoryUpdateJob * _Nonnull updateJob, NSUInteger idx, BOOL * _Nonnull stop) {
+					if (nextUpdateJob == updateJob)
+					{
+						[removeIndexes addIndex:idx];
+					}
+					else
+					{
+						if ([updateJob.location isEqual:nextUpdateJob.location])
 						{
+							// Add to represented array, so the database can be cleaned up properly
+							[nextUpdateJob addRepresentedJobID:updateJob.identifier];
 							[removeIndexes addIndex:idx];
-						}
-						else
-						{
-							if ([updateJob.location isEqual:nextUpdateJob.location])
+
+							// Only skip the coalesced job if all represented jobs could be skipped
+							if ((updateJob.expectedETag == nil) || ![updateJob.expectedETag isEqual:nextUpdateJob.expectedETag])
 							{
-								// Add to represented array, so the database can be cleaned up properly
-								[nextUpdateJob addRepresentedJobID:updateJob.identifier];
-								[removeIndexes addIndex:idx];
+								nextUpdateJob.expectedETag = nil;
 							}
 						}
-					}];
+					}
+				}];
 
-					[_queuedItemListTaskUpdateJobs removeObjectsAtIndexes:removeIndexes];
-				}
+				[_queuedItemListTaskUpdateJobs removeObjectsAtIndexes:removeIndexes];
 
-				if (nextUpdateJob != nil)
+				// Skip jobs for folders whose contents have been retrieved in the meantime
+				if ([_scanPlanner canSkipUpdateJob:nextUpdateJob])
 				{
-					OCCoreItemListTask *task;
+					OCLogDebug(@"Skipping update job for unchanged folder: %@", nextUpdateJob);
+					[self _completeDirectoryUpdateJob:nextUpdateJob removeFromDatabase:YES];
+					continue;
+				}
 
-					if ((task = [self _scheduleItemListTaskForDirectoryUpdateJob:nextUpdateJob]) != nil)
-					{
-						[_scheduledItemListTasks addObject:task];
-					}
+				if ((task = [self _scheduleItemListTaskForDirectoryUpdateJob:nextUpdateJob]) != nil)
+				{
+					[_scheduledItemListTasks addObject:task];
 				}
 			}
 		}
@@ -322,19 +320,7 @@ static OCHTTPRequestGroupID OCCoreItemListTaskGroupBackgroundTasks = @"backgroun
 				}
 			}
 
-			for (OCCoreDirectoryUpdateJobID doneJobID in finishedTask.updateJob.representedJobIDs)
-			{
-				if (removeJobFromDatabase)
-				{
-					[self.vault.database removeDirectoryUpdateJobWithID:doneJobID completionHandler:^(OCDatabase *db, NSError *error) {
-						[self _handleCompletionOfUpdateJobWithID:doneJobID];
-					}];
-				}
-				else
-				{
-					[self _handleCompletionOfUpdateJobWithID:doneJobID];
-				}
-			}
+			[self _completeDirectoryUpdateJob:finishedTask.updateJob removeFromDatabase:removeJobFromDatabase];
 		}
 
 		if (finishedTask.updateJob.isForQuery)
@@ -344,6 +330,23 @@ static OCHTTPRequestGroupID OCCoreItemListTaskGroupBackgroundTasks = @"backgroun
 	}
 }
 
+- (void)_completeDirectoryUpdateJob:(OCCoreDirectoryUpdateJob *)updateJob removeFromDatabase:(BOOL)removeJobFromDatabase
+{
+	for (OCCoreDirectoryUpdateJobID doneJobID in updateJob.representedJobIDs)
+	{
+		if (removeJobFromDatabase)
+		{
+			[self.vault.database removeDirectoryUpdateJobWithID:doneJobID completionHandler:^(OCDatabase *db, NSError *error) {
+				[self _handleCompletionOfUpdateJobWithID:doneJobID];
+			}];
+		}
+		else
+		{
+			[self _handleCompletionOfUpdateJobWithID:doneJobID];
+		}
+	}
+}
+
 - (void)handleUpdatedTask:(OCCoreItemListTask *)task
 {
 	OCQueryState queryState = OCQueryStateStarted;
@@ -661,7 +664,7 @@ static OCHTTPRequestGroupID OCCoreItemListTaskGroupBackgroundTasks = @"backgroun
 				{
 					if (deletedItem.type == OCItemTypeCollection)
 					{
-						[self.database retrieveCacheItemsRecursivelyBelowLocation:deletedItem.location includingPathItself:NO includingRemoved:NO completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *items) {
+						[self.database retrieveCacheItemsRecursivelyBelowItem:deletedItem includingItemItself:NO includingRemoved:YES completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *items) {
 							if (items.count > 0)
 							{
 								if (recursivelyDeletedItems == nil)
@@ -803,6 +806,7 @@ static OCHTTPRequestGroupID OCCoreItemListTaskGroupBackgroundTasks = @"backgroun
 			{
 				// Fully merged => use for updating existing queries that have already gone through their complete, initial update
 				NSMutableArray<OCLocation *> *refreshLocations = [NSMutableArray new];
+				NSMutableArray<OCItem *> *refreshFolderItems = [NSMutableArray new];
 				NSMutableArray<OCItem *> *movedItems = [NSMutableArray new];
 				BOOL fetchUpdatesRunning = NO;
 
@@ -831,7 +835,7 @@ static OCHTTPRequestGroupID OCCoreItemListTaskGroupBackgroundTasks = @"backgroun
 						// discovered collections will.
 						if (allowRefreshPathAddition)
 						{
-							[refreshLocations addObject:item.location];
+							[refreshFolderItems addObject:item];
 						}
 					}
 				}
@@ -849,12 +853,21 @@ static OCHTTPRequestGroupID OCCoreItemListTaskGroupBackgroundTasks = @"backgroun
 							}];
 						}
 
-						// Do not trigger refreshes if only the name changed
-						if ((cacheItem==nil) || ((cacheItem != nil) && ![cacheItem.itemVersionIdentifier isEqual:item.itemVersionIdentifier]))
+						// Do not trigger refreshes if only the name changed - or if the folder's contents have already been retrieved at its current eTag
+						if (allowRefreshPathAddition)
 						{
-							if (allowRefreshPathAddition)
+							__block OCFileETag scannedContentsETag = nil;
+
+							if (cacheItem != nil)
 							{
-								[refreshLocations addObject:item.location];
+								[self.database retrieveScannedContentsETagForFolderWithFileID:item.fileID completionHandler:^(NSError *error, OCFileETag eTag) {
+									scannedContentsETag = eTag;
+								}];
+							}
+
+							if ([OCCoreScanPlanner needsScanOfFolder:item previousFolderItem:cacheItem scannedContentsETag:scannedContentsETag])
+							{
+								[refreshFolderItems addObject:item];
 							}
 						}
 
@@ -911,6 +924,33 @@ static OCHTTPRequestGroupID OCCoreItemListTaskGroupBackgroundTasks = @"backgroun
 					refreshLocations = nil;
 				}
 
+				// Record the eTag at which the contents of the task's folder have now been retrieved
+				OCItem *taskRootItem = retrievedItemsByPath[taskLocationPath];
+
+				if ((taskRootItem.type == OCItemTypeCollection) && (taskRootItem.fileID != nil) && (taskRootItem.eTag != nil))
+				{
+					[self.database setScannedContentsETag:taskRootItem.eTag forFolderWithFileID:taskRootItem.fileID completionHandler:nil];
+					[self->_scanPlanner recordScannedContentsETag:taskRootItem.eTag forFolderWithFileID:taskRootItem.fileID];
+				}
+
+				// Forget about removed folders
+				NSMutableArray<OCFileID> *deletedFolderFileIDs = nil;
+
+				for (OCItem *item in deletedCacheItems)
+				{
+					if ((item.type == OCItemTypeCollection) && (item.fileID != nil))
+					{
+						if (deletedFolderFileIDs == nil) { deletedFolderFileIDs = [NSMutableArray new]; }
+						[deletedFolderFileIDs addObject:item.fileID];
+					}
+				}
+
+				if (deletedFolderFileIDs != nil)
+				{
+					[self.database removeScannedContentsETagsForFolderFileIDs:deletedFolderFileIDs completionHandler:nil];
+					[self->_scanPlanner removeScannedContentsETagsForFolderFileIDs:deletedFolderFileIDs];
+				}
+
 				if (movedItems.count > 0)
 				{
 					// OCLogDebug(@"Moved items: %@", OCLogPrivate(movedItems));
@@ -946,6 +986,12 @@ static OCHTTPRequestGroupID OCCoreItemListTaskGroupBackgroundTasks = @"backgroun
 					       queryPostProcessor:nil
     					             skipDatabase:NO
 				];
+
+				// Schedule scans of new and changed folders (following the updates above, like the refreshLocations)
+				for (OCItem *folderItem in refreshFolderItems)
+				{
+					[self scheduleUpdateScanForFolderItem:folderItem waitForNextQueueCycle:YES];
+				}
 			}
 			else
 			{
@@ -1669,11 +1715,23 @@ static OCHTTPRequestGroupID OCCoreItemListTaskGroupBackgroundTasks = @"backgroun
 #pragma mark - Update Scans
 - (void)scheduleUpdateScanForLocation:(OCLocation *)location waitForNextQueueCycle:(BOOL)waitForNextQueueCycle
 {
-	OCCoreDirectoryUpdateJob *updateJob;
-
 	OCLogDebug(@"Scheduling scan for location=%@, waitForNextCycle: %d", location, waitForNextQueueCycle);
 
-	if ((updateJob = [OCCoreDirectoryUpdateJob withLocation:location]) != nil)
+	[self _scheduleUpdateScanWithJob:[OCCoreDirectoryUpdateJob withLocation:location] waitForNextQueueCycle:waitForNextQueueCycle];
+}
+
+- (void)scheduleUpdateScanForFolderItem:(OCItem *)folderItem waitForNextQueueCycle:(BOOL)waitForNextQueueCycle
+{
+	OCLogDebug(@"Scheduling scan for folder=%@ (eTag: %@), waitForNextCycle: %d", folderItem.location, folderItem.eTag, waitForNextQueueCycle);
+
+	[self _scheduleUpdateScanWithJob:[OCCoreDirectoryUpdateJob withFolderItem:folderItem] waitForNextQueueCycle:waitForNextQueueCycle];
+}
+
+- (void)_scheduleUpdateScanWithJob:(OCCoreDirectoryUpdateJob *)updateJob waitForNextQueueCycle:(BOOL)waitForNextQueueCycle
+{
+	OCLocation *location = updateJob.location;
+
+	if (location != nil)
 	{
 		[self beginActivity:@"Scheduling update scan"];
 
@@ -24,6 +24,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 typedef NSNumber* OCCoreDirectoryUpdateJobID;
 
+@class OCItem;
+
 @interface OCCoreDirectoryUpdateJob : NSObject
 
 @property(nullable,strong) OCCoreDirectoryUpdateJobID identifier;
@@ -33,7 +35,14 @@ typedef NSNumber* OCCoreDirectoryUpdateJobID;
 
 @property(nonatomic,readonly) BOOL isForQuery;
 
+// Scan planning (set for jobs scheduled for folders discovered in the listing of their parent folder - not persisted)
+@property(nullable,strong) OCFileID fileID; //!< File ID of the folder
+@property(nullable,strong) OCFileETag expectedETag; //!< eTag of the folder in the listing of its parent folder. If the contents of the folder have already been retrieved at this eTag when the job is due, the job can be skipped.
+@property(assign) NSInteger subtreeSize; //!< Size of the folder (= size of all contained items) in the listing of its parent folder
+@property(nullable,strong) NSDate *lastModified; //!< Last modification date of the folder in the listing of its parent folder
+
 + (instancetype)withLocation:(OCLocation *)location;
++ (instancetype)withFolderItem:(OCItem *)folderItem; //!< Returns a job for the location of the folder item, with scan planning properties taken from the folder item
 
 - (void)addRepresentedJobID:(nullable OCCoreDirectoryUpdateJobID)jobID;
 
@@ -17,6 +17,7 @@
  */
 
 #import "OCCoreDirectoryUpdateJob.h"
+#import "OCItem.h"
 
 @implementation OCCoreDirectoryUpdateJob
 
@@ -29,6 +30,18 @@
 	return (updateScanPath);
 }
 
++ (instancetype)withFolderItem:(OCItem *)folderItem
+{
+	OCCoreDirectoryUpdateJob *updateJob = [self withLocation:folderItem.location];
+
+	updateJob.fileID = folderItem.fileID;
+	updateJob.expectedETag = folderItem.eTag;
+	updateJob.subtreeSize = folderItem.size;
+	updateJob.lastModified = folderItem.lastModified;
+
+	return (updateJob);
+}
+
 - (NSSet<OCCoreDirectoryUpdateJobID> *)representedJobIDs
 {
 	@synchronized(self)
@@ -69,7 +82,7 @@
 #pragma mark - Description
 - (NSString *)description
 {
-	return ([NSString stringWithFormat:@"<%@: %p, jobID: %@, location: %@, isForQuery: %d, representedJobIDs: %@>", NSStringFromClass(self.class), self, _identifier, _location, self.isForQuery, self.representedJobIDs]);
+	return ([NSString stringWithFormat:@"<%@: %p, jobID: %@, location: %@, isForQuery: %d, representedJobIDs: %@%@>", NSStringFromClass(self.class), self, _identifier, _location, self.isForQuery, self.representedJobIDs, ((_expectedETag != nil) ? [NSString stringWithFormat:@", expectedETag: %@, subtreeSize: %ld", _expectedETag, (long)_subtreeSize] : @"")]);
 }
 
 @end
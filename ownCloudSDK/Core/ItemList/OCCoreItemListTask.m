@@ -164,6 +164,7 @@
 			[self->_core queueConnectivityBlock:^{
 				[self->_core queueRequestJob:^(dispatch_block_t completionHandler) {
 					NSProgress *retrievalProgress;
+					NSMutableArray<OCItem *> *streamedItems = [NSMutableArray new];
 
 					OCMeasureEventEnd(self, @"core.queue", propFindEvenRef, @"Beginning PROPFIND");
 
@@ -173,11 +174,36 @@
 						// For background scan jobs, wait with scheduling until there is connectivity
 						((self.updateJob.isForQuery) ? self.core.connection.propFindSignals : self.core.connection.actionSignals), 	OCConnectionOptionRequiredSignalsKey,
 
+						// Decode items while the response is still being received
+						[^(NSArray<OCItem *> *items) {
+							@synchronized(streamedItems)
+							{
+								[streamedItems addObjectsFromArray:items];
+							}
+						} copy],													OCConnectionOptionResponseItemBatchHandler,
+						[^{
+							@synchronized(streamedItems)
+							{
+								[streamedItems removeAllObjects];
+							}
+						} copy],													OCConnectionOptionResponseItemBatchRestartHandler,
+
 						// Schedule in a particular group
 						((self.groupID != nil) ? self.groupID : nil), 									OCConnectionOptionGroupIDKey,
-					nil] completionHandler:^(NSError *error, NSArray<OCItem *> *items) {
+					nil] completionHandler:^(NSError *error, NSArray<OCItem *> *retrievedItems) {
+						NSArray<OCItem *> *items = retrievedItems;
+
 						OCMeasureEventEnd(self, @"network.propfind", propFindEvenRef, ([NSString stringWithFormat:@"Completed PROPFIND for %@", self.location]));
 
+						if ((error == nil) && (items == nil))
+						{
+							// Items were delivered in batches via OCConnectionOptionResponseItemBatchHandler
+							@synchronized(streamedItems)
+							{
+								items = [streamedItems copy];
+							}
+						}
+
 						if (self.core.state != OCCoreStateRunning)
 						{
 							// Skip processing the response if the core is not starting or running
@@ -0,0 +1,59 @@
+//
+//  OCCoreScanPlanner.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCTypes.h"
+#import "OCCoreDirectoryUpdateJob.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class OCItem;
+
+/*
+	Plans the folders visited by update scans:
+
+	- descent: after the contents of a folder have been retrieved and merged, its eTag is recorded as "scanned contents eTag"
+	  (persisted in the folderScans table of OCDatabase). A sub folder found in a listing is only scanned if its eTag differs
+	  from the eTag its contents were last scanned at. Where no scan has been recorded yet (f.ex. for caches created before
+	  scans were recorded), the eTag of the folder's cache item is used instead.
+	- skipping: jobs for folders discovered in the listing of their parent carry the eTag from that listing. If the folder's
+	  contents have been retrieved at that eTag by the time the job is due (f.ex. by a query), the job is skipped.
+	- ordering: query jobs go first. Background jobs are ordered by last modification date (most recent first), then by
+	  subtree size (largest first), so that the folders most likely to contain the changes are scanned first.
+
+	The planner keeps the scanned contents eTags recorded by this process in memory, so that checking whether a job can be
+	skipped does not require a database lookup. OCCore accesses the job ordering only while holding @synchronized(_queuedItemListTaskUpdateJobs).
+*/
+
+@interface OCCoreScanPlanner : NSObject
+
++ (BOOL)needsScanOfFolder:(OCItem *)folderItem previousFolderItem:(nullable OCItem *)previousFolderItem scannedContentsETag:(nullable OCFileETag)scannedContentsETag; //!< Returns YES if the contents of folderItem (as found in the listing of its parent) need to be retrieved
+
+#pragma mark - Scanned contents eTags
+- (void)recordScannedContentsETag:(OCFileETag)eTag forFolderWithFileID:(OCFileID)fileID;
+- (void)removeScannedContentsETagsForFolderFileIDs:(NSArray<OCFileID> *)fileIDs;
+
+#pragma mark - Jobs
+- (BOOL)canSkipUpdateJob:(OCCoreDirectoryUpdateJob *)updateJob; //!< Returns YES if the contents of the job's folder have already been retrieved at the job's expected eTag
+- (nullable OCCoreDirectoryUpdateJob *)nextUpdateJobFrom:(NSArray<OCCoreDirectoryUpdateJob *> *)updateJobs; //!< Returns the job to run next
+
+@property(readonly,nonatomic) NSUInteger skippedUpdateJobCount; //!< Number of jobs skipped because -canSkipUpdateJob: returned YES for them
+
+@end
+
+NS_ASSUME_NONNULL_END
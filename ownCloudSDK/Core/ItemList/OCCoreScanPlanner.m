@@ -0,0 +1,135 @@
+//
+//  OCCoreScanPlanner.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCCoreScanPlanner.h"
+#import "OCItem.h"
+#import "OCItemVersionIdentifier.h"
+
+@interface OCCoreScanPlanner ()
+{
+	NSCache<OCFileID, OCFileETag> *_scannedContentsETagsByFileID;
+}
+@end
+
+@implementation OCCoreScanPlanner
+
+- (instancetype)init
+{
+	if ((self = [super init]) != nil)
+	{
+		_scannedContentsETagsByFileID = [NSCache new];
+		_scannedContentsETagsByFileID.countLimit = 5000; // Losing entries only means that fewer jobs can be skipped
+	}
+
+	return (self);
+}
+
+#pragma mark - Descent
++ (BOOL)needsScanOfFolder:(OCItem *)folderItem previousFolderItem:(OCItem *)previousFolderItem scannedContentsETag:(OCFileETag)scannedContentsETag
+{
+	if (previousFolderItem == nil)
+	{
+		// Newly discovered folder
+		return (YES);
+	}
+
+	if (scannedContentsETag != nil)
+	{
+		// Contents have been scanned before: scan only if the folder changed since
+		return (![scannedContentsETag isEqual:folderItem.eTag]);
+	}
+
+	// No scan recorded: compare with the cached version of the folder
+	return (![previousFolderItem.itemVersionIdentifier isEqual:folderItem.itemVersionIdentifier]);
+}
+
+#pragma mark - Scanned contents eTags
+- (void)recordScannedContentsETag:(OCFileETag)eTag forFolderWithFileID:(OCFileID)fileID
+{
+	if ((eTag != nil) && (fileID != nil))
+	{
+		[_scannedContentsETagsByFileID setObject:eTag forKey:fileID];
+	}
+}
+
+- (void)removeScannedContentsETagsForFolderFileIDs:(NSArray<OCFileID> *)fileIDs
+{
+	for (OCFileID fileID in fileIDs)
+	{
+		[_scannedContentsETagsByFileID removeObjectForKey:fileID];
+	}
+}
+
+#pragma mark - Jobs
+- (BOOL)canSkipUpdateJob:(OCCoreDirectoryUpdateJob *)updateJob
+{
+	OCFileETag scannedContentsETag;
+
+	if (updateJob.isForQuery || (updateJob.expectedETag == nil) || (updateJob.fileID == nil))
+	{
+		return (NO);
+	}
+
+	if (((scannedContentsETag = [_scannedContentsETagsByFileID objectForKey:updateJob.fileID]) != nil) && [scannedContentsETag isEqual:updateJob.expectedETag])
+	{
+		_skippedUpdateJobCount++;
+		return (YES);
+	}
+
+	return (NO);
+}
+
+- (OCCoreDirectoryUpdateJob *)nextUpdateJobFrom:(NSArray<OCCoreDirectoryUpdateJob *> *)updateJobs
+{
+	OCCoreDirectoryUpdateJob *nextUpdateJob = nil;
+
+	for (OCCoreDirectoryUpdateJob *updateJob in updateJobs)
+	{
+		// High-priority query item list update jobs go first
+		if (updateJob.isForQuery)
+		{
+			return (updateJob);
+		}
+
+		if ((nextUpdateJob == nil) || ([self _compareUpdateJob:updateJob withUpdateJob:nextUpdateJob] == NSOrderedAscending))
+		{
+			nextUpdateJob = updateJob;
+		}
+	}
+
+	return (nextUpdateJob);
+}
+
+- (NSComparisonResult)_compareUpdateJob:(OCCoreDirectoryUpdateJob *)updateJob1 withUpdateJob:(OCCoreDirectoryUpdateJob *)updateJob2
+{
+	NSTimeInterval lastModified1 = (updateJob1.lastModified != nil) ? updateJob1.lastModified.timeIntervalSinceReferenceDate : -DBL_MAX;
+	NSTimeInterval lastModified2 = (updateJob2.lastModified != nil) ? updateJob2.lastModified.timeIntervalSinceReferenceDate : -DBL_MAX;
+
+	// Most recently modified first
+	if (lastModified1 > lastModified2) { return (NSOrderedAscending); }
+	if (lastModified1 < lastModified2) { return (NSOrderedDescending); }
+
+	// Largest subtree first
+	if (updateJob1.subtreeSize > updateJob2.subtreeSize) { return (NSOrderedAscending); }
+	if (updateJob1.subtreeSize < updateJob2.subtreeSize) { return (NSOrderedDescending); }
+
+	// Otherwise keep the order in which jobs were queued
+	return (NSOrderedSame);
+}
+
+@end
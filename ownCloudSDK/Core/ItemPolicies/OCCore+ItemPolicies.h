@@ -44,6 +44,9 @@ typedef NS_OPTIONS(NSUInteger, OCCoreItemPolicyOption)
 #pragma mark - Policy application
 - (void)runProtectedPolicyProcessorsForTrigger:(OCItemPolicyProcessorTrigger)triggerMask;
 - (void)runPolicyProcessorsForTrigger:(OCItemPolicyProcessorTrigger)triggerMask;
+- (void)runPolicyProcessorsForTrigger:(OCItemPolicyProcessorTrigger)triggerMask fullEvaluation:(BOOL)fullEvaluation; //!< If fullEvaluation is YES, processors that evaluate incrementally scan all items in the database (repair mode)
+
+- (void)resetPolicyProcessorWatermarks; //!< Removes the watermarks of incrementally evaluating processors, so that their next runs scan all items in the database
 
 - (void)runPolicyProcessorsOnNewUpdatedAndDeletedItems:(NSArray <OCItem *> *)items forTrigger:(OCItemPolicyProcessorTrigger)triggerMask;
 
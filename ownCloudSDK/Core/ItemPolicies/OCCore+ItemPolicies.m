@@ -27,6 +27,13 @@
 #import "OCItemPolicyProcessorVersionUpdates.h"
 #import "OCCore+SyncEngine.h"
 #import "OCItemPolicy.h"
+#import "OCMacros.h"
+
+typedef NSString* OCItemPolicyProcessorWatermarkID;
+
+static OCKeyValueStoreKey OCKeyValueStoreKeyItemPolicyProcessorWatermarks = @"itemPolicyProcessorWatermarks"; //!< Dictionary of watermarks (dictionaries with sync anchor and date of last full scan) by OCItemPolicyProcessorWatermarkID
+static NSString *OCItemPolicyProcessorWatermarkSyncAnchorKey = @"syncAnchor";
+static NSString *OCItemPolicyProcessorWatermarkFullEvaluationDateKey = @"fullEvaluationDate";
 
 @implementation OCCore (ItemPolicies)
 
@@ -245,12 +252,17 @@
 }
 
 - (void)runPolicyProcessorsForTrigger:(OCItemPolicyProcessorTrigger)triggerMask
+{
+	[self runPolicyProcessorsForTrigger:triggerMask fullEvaluation:NO];
+}
+
+- (void)runPolicyProcessorsForTrigger:(OCItemPolicyProcessorTrigger)triggerMask fullEvaluation:(BOOL)fullEvaluation
 {
 	@synchronized(_itemPolicies)
 	{
 		for (OCItemPolicyProcessor *policyProcessor in _itemPolicyProcessors)
 		{
-			[self runPolicyProcessor:policyProcessor forTrigger:triggerMask];
+			[self runPolicyProcessor:policyProcessor forTrigger:triggerMask fullEvaluation:fullEvaluation];
 		}
 	}
 }
@@ -284,6 +296,11 @@
 }
 
 - (void)runPolicyProcessor:(OCItemPolicyProcessor *)policyProcessor forTrigger:(OCItemPolicyProcessorTrigger)triggerMask
+{
+	[self runPolicyProcessor:policyProcessor forTrigger:triggerMask fullEvaluation:NO];
+}
+
+- (void)runPolicyProcessor:(OCItemPolicyProcessor *)policyProcessor forTrigger:(OCItemPolicyProcessorTrigger)triggerMask fullEvaluation:(BOOL)fullEvaluation
 {
 	OCItemPolicyProcessorTrigger policyProcessorTriggerMask = policyProcessor.triggerMask;
 
@@ -291,20 +308,32 @@
 	{
 		OCQueryCondition *matchCondition;
 		OCQueryCondition *cleanupCondition;
+		OCSyncAnchor scanSyncAnchor = nil;
 
 		[policyProcessor performPreflightOnPoliciesWithTrigger:triggerMask withItems:nil];
 
 		[policyProcessor willEnterTrigger:triggerMask];
 
+		if (policyProcessor.evaluatesIncrementally)
+		{
+			// Items changed after this sync anchor (or while it is still current) are picked up by the next scan
+			scanSyncAnchor = [self retrieveLatestSyncAnchorWithError:NULL];
+		}
+
 		if ((matchCondition = policyProcessor.matchCondition) != nil)
 		{
 			__block BOOL foundMatch = NO;
 			__block BOOL foundItems = NO;
+			__block BOOL stoppedEarly = NO;
+			__block NSUInteger foundItemCount = 0;
 			NSNumber *storedMaxResultCount = matchCondition.maxResultCount;
 			BOOL limitQueriedItemResultCount = (
 				(policyProcessor.maximumQueriedItems.integerValue > 0) &&
 			    	(policyProcessor.syncReason != nil) && (policyProcessor.maximumActiveSyncActions != nil)
 			);
+			OCItemPolicyProcessorWatermarkID watermarkID = [self _watermarkIDForPolicyProcessor:policyProcessor trigger:triggerMask conditionName:@"match"];
+			OCQueryCondition *scanCondition;
+			BOOL isFullScan = YES;
 
 			if (limitQueriedItemResultCount)
 			{
@@ -312,11 +341,26 @@
 				matchCondition.maxResultCount = policyProcessor.maximumQueriedItems;
 			}
 
-			[self.database iterateCacheItemsForQueryCondition:matchCondition excludeRemoved:NO withIterator:^(NSError *error, OCSyncAnchor syncAnchor, OCItem *item, BOOL *stop) {
+			scanCondition = [self _scanConditionForCondition:matchCondition policyProcessor:policyProcessor watermarkID:watermarkID trigger:triggerMask scanSyncAnchor:scanSyncAnchor fullEvaluation:fullEvaluation isFullScan:&isFullScan];
+
+			[self.database iterateCacheItemsForQueryCondition:scanCondition excludeRemoved:NO withIterator:^(NSError *error, OCSyncAnchor syncAnchor, OCItem *item, BOOL *stop) {
 				if (item != nil)
 				{
 					foundItems = YES;
+					foundItemCount++;
+
 					[self _performActionOfPolicyProcessor:policyProcessor onItem:item forTrigger:triggerMask foundMatch:&foundMatch stop:stop];
+
+					if (*stop)
+					{
+						stoppedEarly = YES;
+					}
+				}
+				else if ((error == nil) && (scanSyncAnchor != nil) && !stoppedEarly &&
+					 ((scanCondition.maxResultCount == nil) || (foundItemCount < scanCondition.maxResultCount.unsignedIntegerValue)))
+				{
+					// All items matching the condition have been processed => move watermark forward
+					[self _storeWatermarkWithID:watermarkID syncAnchor:scanSyncAnchor isFullScan:isFullScan];
 				}
 			}];
 
@@ -336,8 +380,14 @@
 		if ((cleanupCondition = policyProcessor.cleanupCondition) != nil)
 		{
 			__block BOOL foundMatch = NO;
+			__block NSUInteger foundItemCount = 0;
+			OCItemPolicyProcessorWatermarkID watermarkID = [self _watermarkIDForPolicyProcessor:policyProcessor trigger:triggerMask conditionName:@"cleanup"];
+			OCQueryCondition *scanCondition;
+			BOOL isFullScan = YES;
 
-			[self.database iterateCacheItemsForQueryCondition:cleanupCondition excludeRemoved:NO withIterator:^(NSError *error, OCSyncAnchor syncAnchor, OCItem *item, BOOL *stop) {
+			scanCondition = [self _scanConditionForCondition:cleanupCondition policyProcessor:policyProcessor watermarkID:watermarkID trigger:triggerMask scanSyncAnchor:scanSyncAnchor fullEvaluation:fullEvaluation isFullScan:&isFullScan];
+
+			[self.database iterateCacheItemsForQueryCondition:scanCondition excludeRemoved:NO withIterator:^(NSError *error, OCSyncAnchor syncAnchor, OCItem *item, BOOL *stop) {
 				if (item != nil)
 				{
 					if (!foundMatch)
@@ -346,8 +396,16 @@
 						[policyProcessor beginCleanupWithTrigger:triggerMask];
 					}
 
+					foundItemCount++;
+
 					[policyProcessor performCleanupOn:item withTrigger:triggerMask];
 				}
+				else if ((error == nil) && (scanSyncAnchor != nil) &&
+					 ((scanCondition.maxResultCount == nil) || (foundItemCount < scanCondition.maxResultCount.unsignedIntegerValue)))
+				{
+					// All items matching the condition have been processed => move watermark forward
+					[self _storeWatermarkWithID:watermarkID syncAnchor:scanSyncAnchor isFullScan:isFullScan];
+				}
 			}];
 
 			if (foundMatch)
@@ -360,6 +418,100 @@
 	}
 }
 
+#pragma mark - Incremental evaluation
+- (OCItemPolicyProcessorWatermarkID)_watermarkIDForPolicyProcessor:(OCItemPolicyProcessor *)policyProcessor trigger:(OCItemPolicyProcessorTrigger)triggerMask conditionName:(NSString *)conditionName
+{
+	// Watermarks are kept per trigger, since processors can act differently on the same items depending on the trigger
+	return ([NSString stringWithFormat:@"%@.%lu.%@", policyProcessor.kind, (unsigned long)triggerMask, conditionName]);
+}
+
+- (OCQueryCondition *)_scanConditionForCondition:(OCQueryCondition *)condition policyProcessor:(OCItemPolicyProcessor *)policyProcessor watermarkID:(OCItemPolicyProcessorWatermarkID)watermarkID trigger:(OCItemPolicyProcessorTrigger)triggerMask scanSyncAnchor:(OCSyncAnchor)scanSyncAnchor fullEvaluation:(BOOL)fullEvaluation isFullScan:(BOOL *)outIsFullScan
+{
+	NSDictionary<NSString *, id> *watermark;
+	NSNumber *watermarkSyncAnchor;
+	NSDate *lastFullEvaluationDate;
+
+	*outIsFullScan = YES;
+
+	if ((scanSyncAnchor == nil) || fullEvaluation || ((triggerMask & OCItemPolicyProcessorTriggerPoliciesChanged) != 0))
+	{
+		// Full scan: not evaluating incrementally, explicitly requested or policies (and therefore conditions) changed
+		return (condition);
+	}
+
+	if (((watermark = OCTypedCast(OCTypedCast([self.vault.keyValueStore readObjectForKey:OCKeyValueStoreKeyItemPolicyProcessorWatermarks], NSDictionary)[watermarkID], NSDictionary)) == nil) ||
+	    ((watermarkSyncAnchor = OCTypedCast(watermark[OCItemPolicyProcessorWatermarkSyncAnchorKey], NSNumber)) == nil) ||
+	    (watermarkSyncAnchor.unsignedIntegerValue > scanSyncAnchor.unsignedIntegerValue))
+	{
+		// Full scan: no (valid) watermark
+		return (condition);
+	}
+
+	if ((policyProcessor.fullEvaluationInterval > 0) &&
+	    (((lastFullEvaluationDate = OCTypedCast(watermark[OCItemPolicyProcessorWatermarkFullEvaluationDateKey], NSDate)) == nil) || (-lastFullEvaluationDate.timeIntervalSinceNow > policyProcessor.fullEvaluationInterval)))
+	{
+		// Full scan: periodic full scan is due
+		return (condition);
+	}
+
+	*outIsFullScan = NO;
+
+	// Incremental scan: only items changed with or after the watermark sync anchor (sort order and result limit apply to the combined condition)
+	OCQueryCondition *unsortedCondition = [OCQueryCondition new];
+	unsortedCondition.operator = condition.operator;
+	unsortedCondition.property = condition.property;
+	unsortedCondition.value = condition.value;
+
+	OCQueryCondition *incrementalCondition = [OCQueryCondition require:@[
+		unsortedCondition,
+		[OCQueryCondition where:OCItemPropertyNameDatabaseSyncAnchor isGreaterThan:@(watermarkSyncAnchor.integerValue - 1)]
+	]];
+
+	incrementalCondition.sortBy = condition.sortBy;
+	incrementalCondition.sortAscending = condition.sortAscending;
+	incrementalCondition.maxResultCount = condition.maxResultCount;
+
+	return (incrementalCondition);
+}
+
+- (void)_storeWatermarkWithID:(OCItemPolicyProcessorWatermarkID)watermarkID syncAnchor:(OCSyncAnchor)syncAnchor isFullScan:(BOOL)isFullScan
+{
+	[self.vault.keyValueStore updateObjectForKey:OCKeyValueStoreKeyItemPolicyProcessorWatermarks usingModifier:^id _Nullable(NSDictionary<OCItemPolicyProcessorWatermarkID, NSDictionary<NSString *, id> *> * _Nullable watermarks, BOOL * _Nonnull outDidModify) {
+		NSMutableDictionary<OCItemPolicyProcessorWatermarkID, NSDictionary<NSString *, id> *> *updatedWatermarks;
+		NSDate *fullEvaluationDate;
+
+		if ((updatedWatermarks = [OCTypedCast(watermarks, NSDictionary) mutableCopy]) == nil)
+		{
+			updatedWatermarks = [NSMutableDictionary new];
+		}
+
+		fullEvaluationDate = isFullScan ? [NSDate new] : OCTypedCast(OCTypedCast(updatedWatermarks[watermarkID], NSDictionary)[OCItemPolicyProcessorWatermarkFullEvaluationDateKey], NSDate);
+
+		if (fullEvaluationDate != nil)
+		{
+			updatedWatermarks[watermarkID] = @{
+				OCItemPolicyProcessorWatermarkSyncAnchorKey : syncAnchor,
+				OCItemPolicyProcessorWatermarkFullEvaluationDateKey : fullEvaluationDate
+			};
+		}
+		else
+		{
+			updatedWatermarks[watermarkID] = @{
+				OCItemPolicyProcessorWatermarkSyncAnchorKey : syncAnchor
+			};
+		}
+
+		*outDidModify = YES;
+
+		return (updatedWatermarks);
+	}];
+}
+
+- (void)resetPolicyProcessorWatermarks
+{
+	[self.vault.keyValueStore storeObject:nil forKey:OCKeyValueStoreKeyItemPolicyProcessorWatermarks];
+}
+
 - (void)runPolicyProcessorsOnNewUpdatedAndDeletedItems:(NSArray <OCItem *> *)items forTrigger:(OCItemPolicyProcessorTrigger)triggerMask
 {
 	@synchronized(_itemPolicies)
@@ -378,10 +530,11 @@
 				if ((matchCondition = policyProcessor.matchCondition) != nil)
 				{
 					__block BOOL foundMatch = NO;
+					OCQueryConditionProgram *matchProgram = [matchCondition compiledProgram];
 
 					for (OCItem *item in items)
 					{
-						if ([matchCondition fulfilledByItem:item])
+						if ([matchProgram evaluateWithItem:item])
 						{
 							BOOL stop = NO;
 
@@ -400,10 +553,11 @@
 				if ((cleanupCondition = policyProcessor.cleanupCondition) != nil)
 				{
 					__block BOOL foundMatch = NO;
+					OCQueryConditionProgram *cleanupProgram = [cleanupCondition compiledProgram];
 
 					for (OCItem *item in items)
 					{
-						if ([cleanupCondition fulfilledByItem:item])
+						if ([cleanupProgram evaluateWithItem:item])
 						{
 							if (!foundMatch)
 							{
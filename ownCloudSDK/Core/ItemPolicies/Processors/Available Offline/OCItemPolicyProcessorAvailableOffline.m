@@ -47,6 +47,11 @@
 
 		self.syncReason = OCSyncReasonAvailableOffline;
 		self.maximumActiveSyncActions = @(2);
+
+		// Items that need downloading or cleanup change in the database (f.ex. when policies are applied, downloads finish or fail),
+		// so only changed items need to be evaluated. Full scans daily to also catch items that remained unhandled for other reasons.
+		self.evaluatesIncrementally = YES;
+		self.fullEvaluationInterval = 24 * 60 * 60;
 	}
 
 	return (self);
@@ -54,6 +54,10 @@
 {
 	if ((self = [super initWithKind:OCItemPolicyKindDownloadExpiration core:core]) != nil)
 	{
+		// Local copies expire without changing in the database, so full scans are needed to find them. Limit these to one per hour.
+		self.evaluatesIncrementally = YES;
+		self.fullEvaluationInterval = 60 * 60;
+
 		[self _refreshCleanupCondition];
 	}
 
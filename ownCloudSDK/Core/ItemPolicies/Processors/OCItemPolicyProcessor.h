@@ -61,6 +61,9 @@ typedef NS_OPTIONS(NSUInteger, OCItemPolicyProcessorTrigger)
 @property(assign) BOOL hasPendingActionItems; //!< Internal, tracks if there are (possibly) pending items if .syncReason != nil, maximumActiveSyncActions != nil AND the number of active sync actions with this Sync Reason is less than .maximumActiveSyncActions
 @property(nullable,strong) NSNumber *activeSyncActionCount; //!< Internal, if .syncReason != nil, tracks the number of active sync actions with that Sync Reason
 
+@property(assign) BOOL evaluatesIncrementally; //!< If YES, database scans for .matchCondition and .cleanupCondition only consider items changed since the last complete scan for the same trigger (tracked via a persisted sync anchor watermark). Full scans are still performed on OCItemPolicyProcessorTriggerPoliciesChanged, on the first run and when explicitly requested.
+@property(assign) NSTimeInterval fullEvaluationInterval; //!< If .evaluatesIncrementally is YES, the maximum time between two full scans. Should be used by processors whose conditions can start to match items without the items changing (f.ex. conditions on dates). 0 for no periodic full scans.
+
 - (instancetype)initWithKind:(OCItemPolicyKind)kind core:(OCCore *)core;
 
 #pragma mark - Policy updates
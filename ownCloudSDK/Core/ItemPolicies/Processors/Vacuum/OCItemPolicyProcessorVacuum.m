@@ -44,6 +44,10 @@
 {
 	if ((self = [super initWithKind:OCItemPolicyKindVacuum core:core]) != nil)
 	{
+		// Removed items become due for vacuuming without changing in the database, so full scans are needed to find them. Limit these to one per hour.
+		self.evaluatesIncrementally = YES;
+		self.fullEvaluationInterval = 60 * 60;
+
 		[self _refreshCleanupCondition];
 	}
 
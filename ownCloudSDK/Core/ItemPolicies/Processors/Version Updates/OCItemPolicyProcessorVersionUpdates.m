@@ -25,6 +25,7 @@
 	if ((self = [super initWithKind:OCItemPolicyKindVersionUpdates core:core]) != nil)
 	{
 		self.matchCondition = [OCQueryCondition where:OCItemPropertyNameType isEqualTo:@(OCItemTypeFile)]; // Match all files
+		self.evaluatesIncrementally = YES; // Only outdated local copies of changed items are of interest
 	}
 
 	return (self);
@@ -24,6 +24,7 @@
 #import "OCCore+Internal.h"
 #import "OCCore+ItemList.h"
 #import "OCQuery+Internal.h"
+#import "OCCoreQueryRoutingIndex.h"
 #import "OCCore+FileProvider.h"
 #import "OCCore+ItemPolicies.h"
 #import "NSString+OCPath.h"
@@ -166,7 +167,7 @@
 						OCItem *reMovedItem;
 
 						// Make a decoupled copy of the item, replace its path and add it to relocatedItems
-						if ((reMovedItem = [OCItem itemFromSerializedData:updatedItem.serializedData]) != nil)
+						if ((reMovedItem = [updatedItem copy]) != nil)
 						{
 							reMovedItem.path = updatedItem.previousPath;
 							reMovedItem.removed = YES;
@@ -226,7 +227,16 @@
 			NSArray *queries;
 			@synchronized(self->_queries)
 			{
-				queries = [self->_queries copy];
+				if (queryPostProcessor != nil)
+				{
+					// The post processor needs to see all queries
+					queries = [self->_queries copy];
+				}
+				else
+				{
+					// Only consider queries that can be affected by the changes
+					queries = [self->_queryRoutingIndex queriesForAddedItems:addedItemList removedItems:removedItemList updatedItems:updatedItemList movedFolderItems:movedFolderItems];
+				}
 			}
 
 			for (OCQuery *query in queries)
@@ -251,6 +261,11 @@
 							{
 								query.queryLocation = movedFolderItem.location;
 								queryLocation = query.queryLocation;
+
+								@synchronized(self->_queries)
+								{
+									[self->_queryRoutingIndex reindexQuery:query];
+								}
 							}
 						}
 					}
@@ -502,6 +517,11 @@
 								query.state = OCQueryStateIdle;
 								query.queryItem = setNewItem;
 								query.fullQueryResults = [NSMutableArray arrayWithObject:setNewItem];
+
+								@synchronized(self->_queries)
+								{
+									[self->_queryRoutingIndex reindexQuery:query];
+								}
 							}
 							else
 							{
@@ -54,6 +54,8 @@
 @class OCCoreQuery;
 @class OCItemPolicyProcessor;
 @class OCSignalManager;
+@class OCCoreQueryRoutingIndex;
+@class OCCoreScanPlanner;
 
 @class OCCoreConnectionStatusSignalProvider;
 @class OCCoreServerStatusSignalProvider;
@@ -157,6 +159,7 @@ typedef id<NSObject> OCCoreItemTracking;
 	OCPlatformMemoryConfiguration _memoryConfiguration;
 
 	NSMutableArray <OCQuery *> *_queries;
+	OCCoreQueryRoutingIndex *_queryRoutingIndex;
 
 	NSMutableArray <OCShareQuery *> *_shareQueries;
 	OCShareQuery *_pollingQuery;
@@ -202,6 +205,7 @@ typedef id<NSObject> OCCoreItemTracking;
 
 	NSMutableDictionary <OCLocationString, OCCoreItemListTask *> *_itemListTasksByLocationString;
 	NSMutableArray <OCCoreDirectoryUpdateJob *> *_queuedItemListTaskUpdateJobs;
+	OCCoreScanPlanner *_scanPlanner;
 	NSMutableArray <OCCoreItemListTask *> *_scheduledItemListTasks;
 	NSMutableSet <OCCoreDirectoryUpdateJobID> *_scheduledDirectoryUpdateJobIDs;
 	OCScanJobActivity *_scheduledDirectoryUpdateJobActivity;
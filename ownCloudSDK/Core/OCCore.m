@@ -20,6 +20,8 @@
 
 #import "OCCore.h"
 #import "OCQuery+Internal.h"
+#import "OCCoreQueryRoutingIndex.h"
+#import "OCCoreScanPlanner.h"
 #import "OCShareQuery.h"
 #import "OCLogger.h"
 #import "NSProgress+OCExtensions.h"
@@ -271,10 +273,12 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCCore)
 		_vault = [[OCVault alloc] initWithBookmark:bookmark];
 
 		_queries = [NSMutableArray new];
+		_queryRoutingIndex = [OCCoreQueryRoutingIndex new];
 		_shareQueries = [NSMutableArray new];
 
 		_itemListTasksByLocationString = [NSMutableDictionary new];
 		_queuedItemListTaskUpdateJobs = [NSMutableArray new];
+		_scanPlanner = [OCCoreScanPlanner new];
 		_scheduledItemListTasks = [NSMutableArray new];
 		_scheduledDirectoryUpdateJobIDs = [NSMutableSet new];
 		_itemListTasksRequestQueue = [OCAsyncSequentialQueue new];
@@ -941,6 +945,7 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCCore)
 			@synchronized(self->_queries)
 			{
 				[self->_queries addObject:query];
+				[self->_queryRoutingIndex addQuery:query];
 			}
 		}];
 
@@ -1013,6 +1018,7 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCCore)
 			@synchronized(self->_queries)
 			{
 				[self->_queries removeObject:query];
+				[self->_queryRoutingIndex removeQuery:query];
 			}
 		}];
 	}
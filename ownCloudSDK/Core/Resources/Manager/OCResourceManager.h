@@ -33,6 +33,9 @@ typedef void(^OCResourceRetrieveCompletionHandler)(NSError * _Nullable error, OC
 - (void)retrieveResourceForRequest:(OCResourceRequest *)request completionHandler:(OCResourceRetrieveCompletionHandler)completionHandler;
 - (void)storeResource:(OCResource *)resource completionHandler:(OCResourceStoreCompletionHandler)completionHandler;
 - (void)removeResourceOfType:(OCResourceType)type identifier:(OCResourceIdentifier)identifier completionHandler:(OCResourceStoreCompletionHandler)completionHandler;
+
+@optional
+- (void)setStorageSizeBudget:(NSUInteger)sizeBudget; //!< Maximum size (in bytes) the storage should use for resource data, evicting least recently used data as needed. 0 for no limit.
 @end
 
 @interface OCResourceManager : NSObject <OCResourceStorage>
@@ -23,6 +23,10 @@
 #import "OCLogger.h"
 #import "NSError+OCError.h"
 #import "NSError+OCHTTPStatus.h"
+#import "OCPlatform.h"
+
+#define OCResourceManagerStorageSizeBudgetDefault	(200 * 1024 * 1024)	//!< Storage size budget for OCPlatformMemoryConfigurationDefault
+#define OCResourceManagerStorageSizeBudgetMinimum	(50 * 1024 * 1024)	//!< Storage size budget for OCPlatformMemoryConfigurationMinimum
 
 @interface OCResourceManager ()
 {
@@ -46,11 +50,13 @@
 		_sourcesByType = [NSMutableDictionary new];
 		_jobs = [NSMutableArray new];
 
-		_cache = [[OCCache alloc] init];
+		_cache = [[OCCache alloc] initWithShardCount:8]; // accessed for every visible cell, from many threads
 
 		_queue = dispatch_queue_create("OCResourceManager", DISPATCH_QUEUE_SERIAL);
 
 		[self addSource:[OCResourceSourceStorage new]];
+
+		self.memoryConfiguration = OCPlatform.current.memoryConfiguration;
 	}
 
 	return (self);
@@ -64,7 +70,7 @@
 	{
 		case OCPlatformMemoryConfigurationDefault:
 			if (_cache == nil) {
-				_cache = [OCCache new];
+				_cache = [[OCCache alloc] initWithShardCount:8];
 			}
 			_cache.countLimit = OCCacheLimitNone;
 		break;
@@ -73,6 +79,18 @@
 			_cache = nil; // Do not perform any caching
 		break;
 	}
+
+	[self _applyStorageSizeBudget];
+}
+
+- (void)_applyStorageSizeBudget
+{
+	id<OCResourceStorage> storage = _storage;
+
+	if ([storage respondsToSelector:@selector(setStorageSizeBudget:)])
+	{
+		[storage setStorageSizeBudget:((_memoryConfiguration == OCPlatformMemoryConfigurationMinimum) ? OCResourceManagerStorageSizeBudgetMinimum : OCResourceManagerStorageSizeBudgetDefault)];
+	}
 }
 
 #pragma mark - Sources
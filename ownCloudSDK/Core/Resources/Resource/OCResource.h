@@ -42,6 +42,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property(strong,nullable) NSURL *url; //!< URL at which the resource is stored (optional)
 @property(strong,nullable,nonatomic) NSData *data; //!< Data of the resource. If data == nil and url != nil, loads contents of url.
+@property(strong,nullable) NSString *blobID; //!< ID of the blob in which the data is stored externally (optional, NOT serialized). If set, data is not serialized either.
 
 @property(strong,nullable) NSDate *timestamp;
 
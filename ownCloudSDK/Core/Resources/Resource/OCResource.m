@@ -72,7 +72,7 @@
 	[coder encodeObject:_mimeType forKey:@"mimeType"];
 
 	[coder encodeObject:_url forKey:@"url"];
-	if (_url == nil)
+	if ((_url == nil) && (_blobID == nil))
 	{
 		[coder encodeObject:_data forKey:@"data"];
 	}
@@ -23,6 +23,7 @@
 #import "OCMacros.h"
 #import "OCSQLiteTransaction.h"
 #import "NSError+OCError.h"
+#import "OCResourceBlobStore.h"
 
 @implementation OCDatabase (ResourceStorage)
 
@@ -35,7 +36,30 @@
 	}
 
 	NSError *error = nil;
-	NSData *resourceData = [NSKeyedArchiver archivedDataWithRootObject:resource requiringSecureCoding:YES error:&error];
+	OCResourceBlobID blobID = nil;
+	NSData *resourceData = nil;
+
+	// Store large payloads in the blob store, so only the remainder of the resource needs to be archived into the database
+	if ((resource.url == nil) && (resource.data.length >= OCResourceBlobStore.minimumBlobSize))
+	{
+		if ((blobID = [self.resourceBlobStore storeData:resource.data error:&error]) == nil)
+		{
+			OCTLogWarning(@[@"ResMan"], @"Storing data of resource %@ inline because it couldn't be stored in the blob store (error=%@).", OCLogPrivate(resource), error);
+		}
+	}
+
+	if (blobID != nil)
+	{
+		NSString *previousBlobID = resource.blobID;
+
+		resource.blobID = blobID;
+		resourceData = [NSKeyedArchiver archivedDataWithRootObject:resource requiringSecureCoding:YES error:&error];
+		resource.blobID = previousBlobID;
+	}
+	else
+	{
+		resourceData = [NSKeyedArchiver archivedDataWithRootObject:resource requiringSecureCoding:YES error:&error];
+	}
 
 	if (resourceData == nil)
 	{
@@ -44,20 +68,28 @@
 	}
 
 	OCResourceImage *imageResource = OCTypedCast(resource, OCResourceImage);
+	NSDictionary<NSString *, id> *outdatedParameters = @{
+		@"type" : resource.type,
+
+		@"identifier" : resource.identifier,
+		@"version" : OCSQLiteNullProtect(resource.version),
+		@"structDesc" : OCSQLiteNullProtect(resource.structureDescription),
+
+		@"maxWidth" : @((imageResource != nil) ? imageResource.maxPixelSize.width : 0),
+		@"maxHeight" : @((imageResource != nil) ? imageResource.maxPixelSize.height : 0),
+	};
+	NSMutableSet<OCResourceBlobID> *removedBlobIDs = [NSMutableSet new];
 
 	[self.sqlDB executeTransaction:[OCSQLiteTransaction transactionWithQueries:@[
+		// Collect blobs of outdated versions and smaller resource sizes
+		[OCSQLiteQuery  query:@"SELECT blobID FROM thumb.resources WHERE identifier = :identifier AND type = :type AND ((version != :version) OR (maxWidth <= :maxWidth AND maxHeight <= :maxHeight) OR (structDesc != :structDesc)) AND blobID IS NOT NULL" // relatedTo:OCDatabaseTableNameResources
+			        withNamedParameters:outdatedParameters resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
+					[self _collectBlobIDsFromResultSet:resultSet into:removedBlobIDs];
+				}],
+
 		// Remove outdated versions and smaller resource sizes
 		[OCSQLiteQuery  query:@"DELETE FROM thumb.resources WHERE identifier = :identifier AND type = :type AND ((version != :version) OR (maxWidth <= :maxWidth AND maxHeight <= :maxHeight) OR (structDesc != :structDesc))" // relatedTo:OCDatabaseTableNameResources
-			        withNamedParameters:@{
-					@"type" : resource.type,
-
-					@"identifier" : resource.identifier,
-					@"version" : OCSQLiteNullProtect(resource.version),
-					@"structDesc" : OCSQLiteNullProtect(resource.structureDescription),
-
-					@"maxWidth" : @((imageResource != nil) ? imageResource.maxPixelSize.width : 0),
-					@"maxHeight" : @((imageResource != nil) ? imageResource.maxPixelSize.height : 0),
-			        } resultHandler:nil],
+			        withNamedParameters:outdatedParameters resultHandler:nil],
 
 		// Insert new resource
 		[OCSQLiteQuery  queryInsertingIntoTable:OCDatabaseTableNameResources
@@ -72,9 +104,15 @@
 					@"maxHeight" : ((imageResource != nil) ? @(imageResource.maxPixelSize.height) : NSNull.null),
 
 					@"metaData" : ((resource.metaData != nil) ? resource.metaData : NSNull.null),
+					@"blobID" : OCSQLiteNullProtect(blobID),
 					@"data" : resourceData
 				} resultHandler:nil]
 	] type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+		if (error == nil)
+		{
+			[self _removeBlobsNoLongerReferenced:removedBlobIDs];
+		}
+
 		if (completionHandler != nil)
 		{
 			completionHandler(error);
@@ -132,9 +170,12 @@
 		return;
 	}
 
+	OCResourceBlobStore *blobStore = self.resourceBlobStore;
+
 	OCSQLiteDBResultHandler resultHandler = ^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
 		NSError *returnError = error;
 		__block BOOL calledCompletionHandler = NO;
+		__block NSNumber *orphanedRowID = nil;
 
 		if (returnError == nil)
 		{
@@ -148,15 +189,46 @@
 
 					if ((resource = [NSKeyedUnarchiver unarchivedObjectOfClass:OCResource.class fromData:data error:&error]) != nil)
 					{
-						completionHandler(nil, resource);
+						NSString *blobID;
+
+						if ((blobID = OCTypedCast(rowDictionary[@"blobID"], NSString)) != nil)
+						{
+							NSData *blobData;
+
+							// Attach memory-mapped data from the blob store
+							if ((blobData = [blobStore dataForBlobID:blobID]) != nil)
+							{
+								resource.blobID = blobID;
+								resource.data = blobData;
+							}
+							else
+							{
+								// Blob has been evicted
+								orphanedRowID = rowDictionary[@"rowID"];
+								resource = nil;
+							}
+						}
+
+						if (resource != nil)
+						{
+							completionHandler(nil, resource);
+							calledCompletionHandler = YES;
+						}
 
-						calledCompletionHandler = YES;
 						*stop = YES;
 					}
 				}
 			} error:&returnError];
 		}
 
+		if (orphanedRowID != nil)
+		{
+			// Remove entries whose blob has been evicted, so they can be replaced with a fresh copy
+			[db executeQuery:[OCSQLiteQuery query:@"DELETE FROM thumb.resources WHERE rowID = :rowID" withNamedParameters:@{ // relatedTo:OCDatabaseTableNameResources
+				@"rowID" : orphanedRowID
+			} resultHandler:nil]];
+		}
+
 		if (!calledCompletionHandler)
 		{
 			completionHandler(returnError, nil);
@@ -165,7 +237,7 @@
 
 	if ((request.maxPixelSize.width == 0) || (request.maxPixelSize.height == 0))
 	{
-		[self.sqlDB executeQuery:[OCSQLiteQuery query:[NSString stringWithFormat:@"SELECT data FROM thumb.resources WHERE identifier = :identifier AND type = :type %@ %@ LIMIT 0,1",
+		[self.sqlDB executeQuery:[OCSQLiteQuery query:[NSString stringWithFormat:@"SELECT rowID, blobID, data FROM thumb.resources WHERE identifier = :identifier AND type = :type %@ %@ LIMIT 0,1",
 			((request.version != nil) ? @"AND version = :version" : @""),
 			((request.structureDescription != nil) ? @"AND structDesc = :structDesc" : @"")]
 		withNamedParameters:@{
@@ -177,7 +249,7 @@
 	}
 	else
 	{
-		[self.sqlDB executeQuery:[OCSQLiteQuery query:[NSString stringWithFormat:@"SELECT maxWidth, maxHeight, data FROM thumb.resources WHERE identifier = :identifier AND type = :type %@ %@ ORDER BY (maxWidth = :maxWidth AND maxHeight = :maxHeight) DESC, (maxWidth >= :maxWidth AND maxHeight >= :maxHeight) DESC, (((maxWidth < :maxWidth AND maxHeight < :maxHeight) * -1000 + 1) * ((maxWidth * maxHeight) - (:maxWidth * :maxHeight))) ASC LIMIT 0,1",
+		[self.sqlDB executeQuery:[OCSQLiteQuery query:[NSString stringWithFormat:@"SELECT rowID, maxWidth, maxHeight, blobID, data FROM thumb.resources WHERE identifier = :identifier AND type = :type %@ %@ ORDER BY (maxWidth = :maxWidth AND maxHeight = :maxHeight) DESC, (maxWidth >= :maxWidth AND maxHeight >= :maxHeight) DESC, (((maxWidth < :maxWidth AND maxHeight < :maxHeight) * -1000 + 1) * ((maxWidth * maxHeight) - (:maxWidth * :maxHeight))) ASC LIMIT 0,1",
 			((request.version != nil) ? @"AND version = :version" : @""),
 			((request.structureDescription != nil) ? @"AND structDesc = :structDesc" : @"")]
 		withNamedParameters:@{
@@ -193,10 +265,26 @@
 
 - (void)removeResourceOfType:(OCResourceType)type identifier:(OCResourceIdentifier)identifier completionHandler:(OCResourceStoreCompletionHandler)completionHandler
 {
-	[self.sqlDB executeQuery:[OCSQLiteQuery  query:@"DELETE FROM thumb.resources WHERE identifier = :identifier AND type = :type" withNamedParameters:@{ // relatedTo:OCDatabaseTableNameResources
+	NSDictionary<NSString *, id> *parameters = @{
 		@"type" : type,
 		@"identifier" : identifier,
-	} resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
+	};
+	NSMutableSet<OCResourceBlobID> *removedBlobIDs = [NSMutableSet new];
+
+	[self.sqlDB executeTransaction:[OCSQLiteTransaction transactionWithQueries:@[
+		// Collect blobs of the resource
+		[OCSQLiteQuery  query:@"SELECT blobID FROM thumb.resources WHERE identifier = :identifier AND type = :type AND blobID IS NOT NULL" withNamedParameters:parameters resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) { // relatedTo:OCDatabaseTableNameResources
+			[self _collectBlobIDsFromResultSet:resultSet into:removedBlobIDs];
+		}],
+
+		// Remove resource
+		[OCSQLiteQuery  query:@"DELETE FROM thumb.resources WHERE identifier = :identifier AND type = :type" withNamedParameters:parameters resultHandler:nil] // relatedTo:OCDatabaseTableNameResources
+	] type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+		if (error == nil)
+		{
+			[self _removeBlobsNoLongerReferenced:removedBlobIDs];
+		}
+
 		if (completionHandler != nil)
 		{
 			completionHandler(error);
@@ -204,4 +292,56 @@
 	}]];
 }
 
+#pragma mark - Blobs
+- (void)_collectBlobIDsFromResultSet:(OCSQLiteResultSet *)resultSet into:(NSMutableSet<OCResourceBlobID> *)blobIDs
+{
+	[resultSet iterateUsing:^(OCSQLiteResultSet *resultSet, NSUInteger line, NSDictionary<NSString *,id> *rowDictionary, BOOL *stop) {
+		OCResourceBlobID blobID;
+
+		if ((blobID = OCTypedCast(rowDictionary[@"blobID"], NSString)) != nil)
+		{
+			[blobIDs addObject:blobID];
+		}
+	} error:NULL];
+}
+
+- (void)_removeBlobsNoLongerReferenced:(NSSet<OCResourceBlobID> *)blobIDs
+{
+	// Several rows can share a blob (identical payloads are only stored once), so blobs are only removed once no row references them anymore
+	if (blobIDs.count == 0)
+	{
+		return;
+	}
+
+	OCResourceBlobStore *blobStore = self.resourceBlobStore;
+	NSArray<OCResourceBlobID> *checkBlobIDs = blobIDs.allObjects;
+	NSString *placeholders = [@"" stringByPaddingToLength:((checkBlobIDs.count * 2) - 1) withString:@"?," startingAtIndex:0];
+
+	[self.sqlDB executeQuery:[OCSQLiteQuery query:[NSString stringWithFormat:@"SELECT DISTINCT blobID FROM thumb.resources WHERE blobID IN (%@)", placeholders] withParameters:checkBlobIDs resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) { // relatedTo:OCDatabaseTableNameResources
+		NSMutableSet<OCResourceBlobID> *referencedBlobIDs = [NSMutableSet new];
+
+		if (error == nil)
+		{
+			[self _collectBlobIDsFromResultSet:resultSet into:referencedBlobIDs];
+
+			for (OCResourceBlobID blobID in checkBlobIDs)
+			{
+				if (![referencedBlobIDs containsObject:blobID])
+				{
+					[blobStore removeBlobWithID:blobID];
+				}
+			}
+		}
+		else
+		{
+			OCTLogError(@[@"ResMan"], @"Error checking references to blobs %@: %@", checkBlobIDs, error);
+		}
+	}]];
+}
+
+- (void)setStorageSizeBudget:(NSUInteger)sizeBudget
+{
+	self.resourceBlobStore.sizeBudget = sizeBudget;
+}
+
 @end
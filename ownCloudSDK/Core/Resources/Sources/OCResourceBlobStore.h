@@ -0,0 +1,56 @@
+//
+//  OCResourceBlobStore.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NSString* OCResourceBlobID; //!< Lowercase hex SHA-256 hash of the blob's contents
+
+/*
+	Content-addressed store for large resource payloads (f.ex. thumbnail and avatar image data).
+
+	Blobs are stored as files in a two-level sharded folder structure below the root URL ([ab]/[cd]/[abcd…]), named after the
+	SHA-256 hash of their contents. Identical payloads are therefore only stored once. Since blobs are never modified after
+	they have been written, they can safely be read via memory mapping.
+
+	If a size budget is set, the least recently used blobs are evicted whenever the total size of all blobs exceeds the budget.
+	The last access date of blobs is persisted via the file's modification date (in at most daily granularity), so that eviction
+	order is preserved across launches and processes.
+*/
+
+@interface OCResourceBlobStore : NSObject
+
+@property(readonly,strong) NSURL *rootURL;
+
+@property(assign,nonatomic) NSUInteger sizeBudget; //!< Maximum total size of all blobs in bytes. 0 for no limit (the default).
+@property(readonly,nonatomic) NSUInteger totalSize; //!< Total size of all blobs in bytes
+
+@property(class,readonly,nonatomic) NSUInteger minimumBlobSize; //!< Payloads smaller than this are not worth a separate file and should be stored inline
+
+- (instancetype)initWithRootURL:(NSURL *)rootURL;
+
+- (nullable OCResourceBlobID)storeData:(NSData *)data error:(NSError * _Nullable * _Nullable)outError; //!< Stores data (if a blob with identical contents doesn't exist yet) and returns the ID of the blob
+- (nullable NSData *)dataForBlobID:(OCResourceBlobID)blobID; //!< Returns the memory-mapped contents of the blob - or nil if it doesn't exist (anymore)
+
+- (void)removeBlobWithID:(OCResourceBlobID)blobID;
+- (void)removeAllBlobs;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,354 @@
+//
+//  OCResourceBlobStore.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCResourceBlobStore.h"
+#import "NSData+OCHash.h"
+#import "NSError+OCError.h"
+#import "OCLogger.h"
+#import "OCMacros.h"
+
+#define OCResourceBlobStoreAccessDatePersistInterval (24.0 * 60.0 * 60.0) // Persist the last access date at most once a day
+#define OCResourceBlobStoreEvictionTargetRatio 0.9 // When over budget, evict down to 90% of the budget, so not every new blob triggers another eviction
+
+@interface OCResourceBlobStoreEntry : NSObject
+{
+	@public
+	NSUInteger size;
+	NSTimeInterval lastAccess; //!< In-memory last access date
+	NSTimeInterval persistedLastAccess; //!< Last access date as persisted via the file's modification date
+}
+@end
+
+@implementation OCResourceBlobStoreEntry
+@end
+
+@interface OCResourceBlobStore ()
+{
+	NSMutableDictionary<OCResourceBlobID, OCResourceBlobStoreEntry *> *_entriesByBlobID;
+	NSUInteger _totalSize;
+}
+@end
+
+@implementation OCResourceBlobStore
+
++ (NSUInteger)minimumBlobSize
+{
+	return (16 * 1024);
+}
+
+- (instancetype)initWithRootURL:(NSURL *)rootURL
+{
+	if ((self = [super init]) != nil)
+	{
+		_rootURL = rootURL;
+	}
+
+	return (self);
+}
+
+#pragma mark - Paths
+- (BOOL)_isValidBlobID:(OCResourceBlobID)blobID
+{
+	// Guard against anything that isn't a hex string (and could f.ex. contain path components)
+	return ((blobID.length == 64) && ([blobID rangeOfCharacterFromSet:[NSCharacterSet characterSetWithCharactersInString:@"0123456789abcdef"].invertedSet].location == NSNotFound));
+}
+
+- (NSURL *)_urlForBlobID:(OCResourceBlobID)blobID
+{
+	return ([[[_rootURL URLByAppendingPathComponent:[blobID substringWithRange:NSMakeRange(0, 2)] isDirectory:YES]
+			    URLByAppendingPathComponent:[blobID substringWithRange:NSMakeRange(2, 2)] isDirectory:YES]
+			    URLByAppendingPathComponent:blobID isDirectory:NO]);
+}
+
+#pragma mark - Index
+- (void)_loadIndex
+{
+	// Must be called from within @synchronized(self)
+	NSDirectoryEnumerator<NSURL *> *enumerator;
+	NSMutableDictionary<OCResourceBlobID, OCResourceBlobStoreEntry *> *entriesByBlobID = [NSMutableDictionary new];
+	NSUInteger totalSize = 0;
+
+	if ((enumerator = [NSFileManager.defaultManager enumeratorAtURL:_rootURL includingPropertiesForKeys:@[ NSURLIsRegularFileKey, NSURLFileSizeKey, NSURLContentModificationDateKey ] options:NSDirectoryEnumerationSkipsHiddenFiles errorHandler:nil]) != nil)
+	{
+		for (NSURL *fileURL in enumerator)
+		{
+			NSDictionary<NSURLResourceKey, id> *resourceValues;
+			OCResourceBlobID blobID = fileURL.lastPathComponent;
+
+			if ([self _isValidBlobID:blobID] && ((resourceValues = [fileURL resourceValuesForKeys:@[ NSURLIsRegularFileKey, NSURLFileSizeKey, NSURLContentModificationDateKey ] error:NULL]) != nil))
+			{
+				if ([resourceValues[NSURLIsRegularFileKey] boolValue])
+				{
+					OCResourceBlobStoreEntry *entry = [OCResourceBlobStoreEntry new];
+
+					entry->size = [resourceValues[NSURLFileSizeKey] unsignedIntegerValue];
+					entry->persistedLastAccess = entry->lastAccess = [resourceValues[NSURLContentModificationDateKey] timeIntervalSinceReferenceDate];
+
+					totalSize += entry->size;
+					entriesByBlobID[blobID] = entry;
+				}
+			}
+		}
+	}
+
+	_entriesByBlobID = entriesByBlobID;
+	_totalSize = totalSize;
+}
+
+- (void)_loadIndexIfNeeded
+{
+	if (_entriesByBlobID == nil)
+	{
+		[self _loadIndex];
+	}
+}
+
+- (NSUInteger)totalSize
+{
+	@synchronized(self)
+	{
+		[self _loadIndexIfNeeded];
+		return (_totalSize);
+	}
+}
+
+- (void)_removeEntryForBlobID:(OCResourceBlobID)blobID
+{
+	OCResourceBlobStoreEntry *entry;
+
+	if ((entry = _entriesByBlobID[blobID]) != nil)
+	{
+		_totalSize -= MIN(entry->size, _totalSize);
+		[_entriesByBlobID removeObjectForKey:blobID];
+	}
+}
+
+#pragma mark - Storing
+- (nullable OCResourceBlobID)storeData:(NSData *)data error:(NSError * _Nullable * _Nullable)outError
+{
+	OCResourceBlobID blobID = [data.sha256Hash asHexStringWithSeparator:nil lowercase:YES];
+	NSURL *blobURL = [self _urlForBlobID:blobID];
+	NSError *error = nil;
+
+	@synchronized(self)
+	{
+		OCResourceBlobStoreEntry *entry;
+
+		[self _loadIndexIfNeeded];
+
+		if (((entry = _entriesByBlobID[blobID]) == nil) && [NSFileManager.defaultManager fileExistsAtPath:blobURL.path])
+		{
+			// Blob was stored by another process since the index was loaded
+			entry = [OCResourceBlobStoreEntry new];
+			entry->size = data.length;
+			entry->persistedLastAccess = NSDate.timeIntervalSinceReferenceDate;
+
+			_entriesByBlobID[blobID] = entry;
+			_totalSize += entry->size;
+		}
+
+		if (entry != nil)
+		{
+			// Identical blob already stored
+			entry->lastAccess = NSDate.timeIntervalSinceReferenceDate;
+		}
+		else
+		{
+			// Write new blob (atomically, so that readers never see partial contents)
+			if ([NSFileManager.defaultManager createDirectoryAtURL:blobURL.URLByDeletingLastPathComponent withIntermediateDirectories:YES attributes:@{ NSFileProtectionKey : NSFileProtectionCompleteUntilFirstUserAuthentication } error:&error] &&
+			    [data writeToURL:blobURL options:NSDataWritingAtomic error:&error])
+			{
+				entry = [OCResourceBlobStoreEntry new];
+				entry->size = data.length;
+				entry->persistedLastAccess = entry->lastAccess = NSDate.timeIntervalSinceReferenceDate;
+
+				_entriesByBlobID[blobID] = entry;
+				_totalSize += entry->size;
+
+				[self _evictIfNeeded];
+			}
+			else
+			{
+				OCTLogError(@[@"ResMan"], @"Error storing blob %@: %@", blobID, error);
+				blobID = nil;
+			}
+		}
+	}
+
+	if (outError != NULL)
+	{
+		*outError = error;
+	}
+
+	return (blobID);
+}
+
+#pragma mark - Retrieval
+- (nullable NSData *)dataForBlobID:(OCResourceBlobID)blobID
+{
+	NSURL *blobURL;
+	NSData *data = nil;
+	NSError *error = nil;
+
+	if (![self _isValidBlobID:blobID])
+	{
+		return (nil);
+	}
+
+	blobURL = [self _urlForBlobID:blobID];
+
+	// Blobs are immutable, so mapping them is safe. If a blob is evicted while mapped, the mapping remains valid until the data is deallocated.
+	if ((data = [NSData dataWithContentsOfURL:blobURL options:NSDataReadingMappedAlways error:&error]) != nil)
+	{
+		@synchronized(self)
+		{
+			OCResourceBlobStoreEntry *entry;
+			NSTimeInterval now = NSDate.timeIntervalSinceReferenceDate;
+
+			// Reads count as accesses for the LRU order, so the index needs to be loaded before a blob is first read
+			[self _loadIndexIfNeeded];
+
+			if ((entry = _entriesByBlobID[blobID]) == nil)
+			{
+				// Blob was stored by another process since the index was loaded
+				entry = [OCResourceBlobStoreEntry new];
+				entry->size = data.length;
+				entry->persistedLastAccess = now;
+
+				_entriesByBlobID[blobID] = entry;
+				_totalSize += entry->size;
+			}
+
+			entry->lastAccess = now;
+
+			if ((now - entry->persistedLastAccess) > OCResourceBlobStoreAccessDatePersistInterval)
+			{
+				entry->persistedLastAccess = now;
+				[blobURL setResourceValue:[NSDate dateWithTimeIntervalSinceReferenceDate:now] forKey:NSURLContentModificationDateKey error:NULL];
+			}
+		}
+	}
+	else
+	{
+		// Blob no longer exists (f.ex. evicted by another process)
+		@synchronized(self)
+		{
+			[self _removeEntryForBlobID:blobID];
+		}
+	}
+
+	return (data);
+}
+
+#pragma mark - Removal
+- (void)removeBlobWithID:(OCResourceBlobID)blobID
+{
+	if (![self _isValidBlobID:blobID])
+	{
+		return;
+	}
+
+	@synchronized(self)
+	{
+		[NSFileManager.defaultManager removeItemAtURL:[self _urlForBlobID:blobID] error:NULL];
+		[self _removeEntryForBlobID:blobID];
+	}
+}
+
+- (void)removeAllBlobs
+{
+	@synchronized(self)
+	{
+		[NSFileManager.defaultManager removeItemAtURL:_rootURL error:NULL];
+
+		_entriesByBlobID = [NSMutableDictionary new];
+		_totalSize = 0;
+	}
+}
+
+#pragma mark - Eviction
+- (void)setSizeBudget:(NSUInteger)sizeBudget
+{
+	@synchronized(self)
+	{
+		_sizeBudget = sizeBudget;
+
+		if (_entriesByBlobID != nil)
+		{
+			[self _evictIfNeeded];
+		}
+	}
+}
+
+- (void)_evictIfNeeded
+{
+	// Must be called from within @synchronized(self)
+	NSUInteger targetSize;
+	NSArray<OCResourceBlobID> *blobIDsByLastAccess;
+
+	if ((_sizeBudget == 0) || (_totalSize <= _sizeBudget))
+	{
+		return;
+	}
+
+	// Re-scan to pick up blobs stored and removed by other processes before deciding what to evict
+	NSMutableDictionary<OCResourceBlobID, OCResourceBlobStoreEntry *> *previousEntriesByBlobID = _entriesByBlobID;
+
+	[self _loadIndex];
+
+	[previousEntriesByBlobID enumerateKeysAndObjectsUsingBlock:^(OCResourceBlobID blobID, OCResourceBlobStoreEntry *previousEntry, BOOL *stop) {
+		OCResourceBlobStoreEntry *entry;
+
+		if ((entry = self->_entriesByBlobID[blobID]) != nil)
+		{
+			entry->lastAccess = MAX(entry->lastAccess, previousEntry->lastAccess);
+		}
+	}];
+
+	if (_totalSize <= _sizeBudget)
+	{
+		return;
+	}
+
+	targetSize = (NSUInteger)(((double)_sizeBudget) * OCResourceBlobStoreEvictionTargetRatio);
+
+	blobIDsByLastAccess = [_entriesByBlobID keysSortedByValueUsingComparator:^NSComparisonResult(OCResourceBlobStoreEntry *entry1, OCResourceBlobStoreEntry *entry2) {
+		if (entry1->lastAccess < entry2->lastAccess) { return (NSOrderedAscending); }
+		if (entry1->lastAccess > entry2->lastAccess) { return (NSOrderedDescending); }
+		return (NSOrderedSame);
+	}];
+
+	NSUInteger evictedCount = 0, previousTotalSize = _totalSize;
+
+	for (OCResourceBlobID blobID in blobIDsByLastAccess)
+	{
+		if (_totalSize <= targetSize)
+		{
+			break;
+		}
+
+		[NSFileManager.defaultManager removeItemAtURL:[self _urlForBlobID:blobID] error:NULL];
+		[self _removeEntryForBlobID:blobID];
+
+		evictedCount++;
+	}
+
+	OCTLogDebug(@[@"ResMan"], @"Evicted %lu blobs, reducing size from %lu to %lu bytes (budget: %lu bytes)", (unsigned long)evictedCount, (unsigned long)previousTotalSize, (unsigned long)_totalSize, (unsigned long)_sizeBudget);
+}
+
+@end
@@ -23,7 +23,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface OCCore (Search)
 
-- (nullable OCSearchResult *)searchFilesWithPattern:(NSString *)pattern limit:(nullable NSNumber *)limit options:(nullable NSDictionary<OCConnectionOptionKey,id> *)options;
+- (nullable OCSearchResult *)searchFilesWithPattern:(NSString *)pattern limit:(nullable NSNumber *)limit options:(nullable NSDictionary<OCConnectionOptionKey,id> *)options; //!< Searches the server for files matching the KQL pattern. If the pattern only consists of name terms, matching items from the local item name index are provided immediately - and also while offline.
+
++ (nullable NSArray<NSString *> *)localSearchTermsForKQLQuery:(OCKQLQuery)kqlQuery; //!< Returns the name terms of a KQL query that can be answered from the local item name index (in the format of -[OCDatabase retrieveCacheItemsMatchingSearchTerms:…], keeping wildcards of anchored values), or nil if the query contains other conditions
 
 @end
 
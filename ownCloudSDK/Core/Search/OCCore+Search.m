@@ -17,7 +17,11 @@
  */
 
 #import "OCCore+Search.h"
+#import "OCCore+Internal.h"
 #import "OCConnection.h"
+#import "OCDatabase.h"
+#import "OCMacros.h"
+#import "OCLogger.h"
 #import "NSError+OCError.h"
 
 @implementation OCCore (Search)
@@ -25,10 +29,28 @@
 - (nullable OCSearchResult *)searchFilesWithPattern:(NSString *)pattern limit:(nullable NSNumber *)limit options:(nullable NSDictionary<OCConnectionOptionKey,id> *)options
 {
 	OCSearchResult *searchResult = [[OCSearchResult alloc] initWithKQLQuery:pattern core:self];
+	NSArray<NSString *> *localSearchTerms = [OCCore localSearchTermsForKQLQuery:pattern];
+	BOOL online = (self.connectionStatus == OCCoreConnectionStatusOnline);
 
-	if (self.connectionStatus != OCCoreConnectionStatusOnline)
+	if (localSearchTerms != nil)
 	{
-		searchResult.error = OCError(OCErrorNotAvailableOffline);
+		// Provide results from the local item name index while the server search is in flight (or unavailable)
+		[self.database retrieveCacheItemsMatchingSearchTerms:localSearchTerms limit:limit.unsignedIntegerValue cancelAction:nil completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *items) {
+			if (error != nil)
+			{
+				OCLogError(@"Local search for %@ failed with error: %@", OCLogPrivate(localSearchTerms), error);
+			}
+
+			[searchResult _handleLocalResultItems:((items != nil) ? items : @[]) concluded:!online];
+		}];
+	}
+
+	if (!online)
+	{
+		if (localSearchTerms == nil)
+		{
+			searchResult.error = OCError(OCErrorNotAvailableOffline);
+		}
 	}
 	else
 	{
@@ -42,4 +64,114 @@
 	return (searchResult);
 }
 
++ (nullable NSArray<NSString *> *)localSearchTermsForKQLQuery:(OCKQLQuery)kqlQuery
+{
+	static dispatch_once_t onceToken;
+	static NSRegularExpression *tokenRegex;
+	NSMutableArray<NSString *> *nameTerms = [NSMutableArray new];
+	NSMutableArray<NSString *> *contentTerms = [NSMutableArray new];
+	NSUInteger location = 0;
+
+	dispatch_once(&onceToken, ^{
+		// Groups: 1: property, 2: property value, 3: quoted phrase, 4: word
+		tokenRegex = [NSRegularExpression regularExpressionWithPattern:@"\\s*(?:[()]|([A-Za-z]+):(\"(?:[^\"\\\\]|\\\\.)*\"|[^\\s()\"]+)|(\"(?:[^\"\\\\]|\\\\.)*\")|([^\\s()\"<>:=]+))\\s*" options:0 error:NULL];
+	});
+
+	if (kqlQuery.length == 0)
+	{
+		return (nil);
+	}
+
+	while (location < kqlQuery.length)
+	{
+		NSTextCheckingResult *match;
+		NSString *property = nil, *value = nil, *word = nil;
+
+		if (((match = [tokenRegex firstMatchInString:kqlQuery options:NSMatchingAnchored range:NSMakeRange(location, kqlQuery.length - location)]) == nil) || (match.range.length == 0))
+		{
+			// Unsupported syntax
+			return (nil);
+		}
+
+		location = NSMaxRange(match.range);
+
+		if ([match rangeAtIndex:1].location != NSNotFound)
+		{
+			property = [kqlQuery substringWithRange:[match rangeAtIndex:1]].lowercaseString;
+			value = [kqlQuery substringWithRange:[match rangeAtIndex:2]];
+		}
+		else if ([match rangeAtIndex:3].location != NSNotFound)
+		{
+			value = [kqlQuery substringWithRange:[match rangeAtIndex:3]];
+		}
+		else if ([match rangeAtIndex:4].location != NSNotFound)
+		{
+			word = [kqlQuery substringWithRange:[match rangeAtIndex:4]];
+
+			if ([word isEqual:@"AND"] || [word isEqual:@"OR"])
+			{
+				// Local results require all terms to match, which also satisfies OR
+				continue;
+			}
+
+			if ([word isEqual:@"NOT"] || [word hasPrefix:@"-"])
+			{
+				// Negations can't be answered from the name index
+				return (nil);
+			}
+
+			value = word;
+		}
+
+		if (value == nil)
+		{
+			// Parenthesis
+			continue;
+		}
+
+		if ([value hasPrefix:@"\""] && [value hasSuffix:@"\""] && (value.length >= 2))
+		{
+			value = [[value substringWithRange:NSMakeRange(1, value.length-2)] stringByReplacingOccurrencesOfString:@"\\\"" withString:@"\""];
+		}
+
+		if ((property == nil) || [property isEqual:@"name"])
+		{
+			NSString *innerValue = ((value.length > 2) && [value hasPrefix:@"*"] && [value hasSuffix:@"*"]) ? [value substringWithRange:NSMakeRange(1, value.length-2)] : nil;
+
+			if ((innerValue != nil) && ![innerValue containsString:@"*"])
+			{
+				// "*term*" => term may occur anywhere in the name
+				[nameTerms addObject:innerValue];
+			}
+			else if ([value stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"*"]].length > 0)
+			{
+				// Values without wildcards are matched anywhere in the name, others (f.ex. "term*" for a prefix) are kept as patterns, so their anchoring is preserved
+				[nameTerms addObject:value];
+			}
+		}
+		else if ([property isEqual:@"content"])
+		{
+			[contentTerms addObject:value];
+		}
+		else
+		{
+			// Other properties (f.ex. mediatype, mtime) can't be answered from the name index
+			return (nil);
+		}
+	}
+
+	// Content terms are only acceptable as alternative to a name term with the same value, as produced by -[OCQueryCondition kqlStringWithTypeAliasToKQLTypeMap:targetContent:]
+	for (NSString *contentTerm in contentTerms)
+	{
+		NSString *trimmedContentTerm = [contentTerm stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"*"]];
+
+		if ((trimmedContentTerm.length > 0) && ![nameTerms containsObject:trimmedContentTerm])
+		{
+			return (nil);
+		}
+	}
+
+	return ((nameTerms.count > 0) ? nameTerms : nil);
+}
+
 @end
@@ -41,6 +41,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 // MARK: - Internals
 - (void)_handleResultEvent:(OCEvent *)event;
+- (void)_handleLocalResultItems:(NSArray<OCItem *> *)localResultItems concluded:(BOOL)concluded; //!< Local results (f.ex. from the itemNameIndex) are shown until and alongside server results. Pass concluded=YES if no server results will follow.
 
 @end
 
@@ -26,6 +26,7 @@
 {
 	NSMapTable<OCLocation *, OCCoreItemTracking> *_itemTrackingByLocation;
 	NSMutableArray<OCItem *> *_resultItems;
+	NSArray<OCItem *> *_localResultItems;
 }
 
 - (instancetype)initWithKQLQuery:(OCKQLQuery)kqlQuery core:(OCCore *)core
@@ -45,6 +46,35 @@
 	return (self);
 }
 
+- (void)_updateResults
+{
+	// Server results first, followed by local results not (yet) part of them
+	NSMutableArray<OCItem *> *items = [[NSMutableArray alloc] initWithArray:_resultItems];
+
+	if (_localResultItems.count > 0)
+	{
+		NSMutableSet<OCLocalID> *localIDs = [NSMutableSet new];
+
+		for (OCItem *item in _resultItems)
+		{
+			if (item.localID != nil)
+			{
+				[localIDs addObject:item.localID];
+			}
+		}
+
+		for (OCItem *item in _localResultItems)
+		{
+			if ((item.localID == nil) || ![localIDs containsObject:item.localID])
+			{
+				[items addObject:item];
+			}
+		}
+	}
+
+	[(OCDataSourceArray *)self.results setVersionedItems:items];
+}
+
 - (void)dealloc
 {
 	if (!self.progress.cancelled)
@@ -58,10 +88,22 @@
 	[self.progress cancel];
 }
 
+- (void)_handleLocalResultItems:(NSArray<OCItem *> *)localResultItems concluded:(BOOL)concluded
+{
+	@synchronized(self) {
+		_localResultItems = localResultItems;
+		[self _updateResults];
+	}
+
+	if (concluded)
+	{
+		self.results.state = OCDataSourceStateIdle;
+	}
+}
+
 - (void)_handleResultEvent:(OCEvent *)event
 {
 	NSArray<OCItem *> *searchResults = OCTypedCast(event.result, NSArray);
-	OCDataSourceArray *searchResultDatasource = (OCDataSourceArray *)self.results;
 
 	self.results.state = OCDataSourceStateIdle;
 
@@ -86,7 +128,7 @@
 					{
 						@synchronized(self) {
 							[self->_resultItems addObject:item];
-							[searchResultDatasource setVersionedItems:self->_resultItems];
+							[self _updateResults];
 
 							OCLogDebug(@"Result Items: %@", self->_resultItems);
 						}
@@ -82,7 +82,7 @@ OCSYNCACTION_REGISTER_ISSUETEMPLATES
 			NSMutableArray <OCItem *> *removedItems = [syncContext.removedItems mutableCopy];
 			NSMutableArray <OCLocalID> *removedLocalIDs = [NSMutableArray new];
 
-			[self.core.vault.database retrieveCacheItemsRecursivelyBelowLocation:itemToDelete.location includingPathItself:NO includingRemoved:NO completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *items) {
+			[self.core.vault.database retrieveCacheItemsRecursivelyBelowItem:itemToDelete includingItemItself:NO includingRemoved:YES completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *items) {
 				for (OCItem *item in items)
 				{
 					[item addSyncRecordID:syncContext.syncRecord.recordID activity:OCItemSyncActivityDeleting];
@@ -232,7 +232,7 @@ OCSYNCACTION_REGISTER_ISSUETEMPLATES
 			// Items that are still contained in the deleted item itself
 			if (self.localItem.type == OCItemTypeCollection)
 			{
-				[self.core.vault.database retrieveCacheItemsRecursivelyBelowLocation:self.localItem.location includingPathItself:NO includingRemoved:NO completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *items) {
+				[self.core.vault.database retrieveCacheItemsRecursivelyBelowItem:self.localItem includingItemItself:NO includingRemoved:YES completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *items) {
 					for (OCItem *item in items)
 					{
 						OCLogDebug(@"Success: remove delete contained %@", OCLogPrivate(item.path));
@@ -17,10 +17,12 @@
  */
 
 #import "OCSyncAction.h"
+#import "OCRangedDownloadJob.h"
 
 @interface OCSyncActionDownload : OCSyncAction <OCSyncActionOptions>
 
 @property(assign) NSUInteger resolutionRetries;
+@property(strong,nullable) OCRangedDownloadJob *rangedDownloadJob; //!< Job of a download performed in byte ranges. Persisted with the sync record, so that interrupted downloads resume with the missing ranges.
 
 - (instancetype)initWithItem:(OCItem *)item options:(NSDictionary<OCCoreOption,id> *)options;
 
@@ -21,6 +21,7 @@
 #import "OCCore+FileProvider.h"
 #import "OCCore+ItemUpdates.h"
 #import "OCCore+Claims.h"
+#import "OCCore+Internal.h"
 #import "OCWaitConditionMetaDataRefresh.h"
 #import "OCCellularManager.h"
 
@@ -28,6 +29,8 @@ static OCMessageTemplateIdentifier OCMessageTemplateIdentifierDownloadOverwrite
 static OCMessageTemplateIdentifier OCMessageTemplateIdentifierDownloadRetry = @"download.retry";
 static OCMessageTemplateIdentifier OCMessageTemplateIdentifierDownloadCancel = @"download.cancel";
 
+static const NSTimeInterval OCSyncActionDownloadChunkMapPersistInterval = 10.0; //!< Minimum interval (in seconds) between updates of the sync record as chunks of a ranged download complete
+
 @implementation OCSyncActionDownload
 
 @synthesize options;
@@ -198,6 +201,9 @@ OCSYNCACTION_REGISTER_ISSUETEMPLATES
 {
 	OCItem *item;
 
+	[self.rangedDownloadJob destroy];
+	self.rangedDownloadJob = nil;
+
 	if ((item = self.latestVersionOfLocalItem) != nil)
 	{
 		[item removeSyncRecordID:syncContext.syncRecord.recordID activity:OCItemSyncActivityDownloading];
@@ -317,6 +323,7 @@ OCSYNCACTION_REGISTER_ISSUETEMPLATES
 
 		NSURL *temporaryDirectoryURL = self.core.vault.temporaryDownloadURL;
 		NSURL *temporaryFileURL = [temporaryDirectoryURL URLByAppendingPathComponent:[NSUUID UUID].UUIDString];
+		OCRangedDownloadJob *rangedDownloadJob = self.rangedDownloadJob;
 
 		OCLogDebug(@"record %@ download: setting up directory", syncContext.syncRecord);
 
@@ -344,6 +351,68 @@ OCSYNCACTION_REGISTER_ISSUETEMPLATES
 			options = mutableOptions;
 		}
 
+		// Resume ranged download of the same version - or start a new one for large files
+		if ((rangedDownloadJob != nil) && ![rangedDownloadJob isValidForItem:item])
+		{
+			OCLogDebug(@"record %@ download: discarding ranged download job %@ for outdated version", syncContext.syncRecord, rangedDownloadJob.identifier);
+
+			[rangedDownloadJob destroy];
+			rangedDownloadJob = nil;
+		}
+
+		if (rangedDownloadJob == nil)
+		{
+			rangedDownloadJob = [self.core.connection rangedDownloadJobForItem:item fileURL:temporaryFileURL];
+		}
+
+		if (rangedDownloadJob != nil)
+		{
+			NSMutableDictionary *mutableOptions = (options != nil) ? [options mutableCopy] : [NSMutableDictionary new];
+
+			mutableOptions[OCConnectionOptionRangedDownloadJob] = rangedDownloadJob;
+			options = mutableOptions;
+
+			temporaryFileURL = rangedDownloadJob.fileURL;
+
+			// Periodically persist the chunk map while chunks complete, so that a download interrupted before its result is handled only repeats recent chunks
+			__weak OCCore *weakCore = self.core;
+			__weak OCSyncRecord *weakSyncRecord = syncContext.syncRecord;
+			__block NSTimeInterval lastPersistTime = NSDate.timeIntervalSinceReferenceDate;
+
+			rangedDownloadJob.chunkStoredHandler = ^(OCRangedDownloadJob *job) {
+				NSTimeInterval now = NSDate.timeIntervalSinceReferenceDate;
+				BOOL persist = NO;
+
+				@synchronized(job)
+				{
+					if ((now - lastPersistTime) >= OCSyncActionDownloadChunkMapPersistInterval)
+					{
+						lastPersistTime = now;
+						persist = YES;
+					}
+				}
+
+				if (persist)
+				{
+					OCCore *core = weakCore;
+					OCSyncRecord *syncRecord = weakSyncRecord;
+
+					if ((core != nil) && (syncRecord != nil))
+					{
+						[core queueBlock:^{
+							[core updateSyncRecords:@[ syncRecord ] completionHandler:nil];
+						}];
+					}
+				}
+			};
+		}
+
+		if (rangedDownloadJob != self.rangedDownloadJob)
+		{
+			self.rangedDownloadJob = rangedDownloadJob;
+			syncContext.updateStoredSyncRecordAfterItemUpdates = YES; // Update sync record in db, so the job (and its chunk map) is persisted
+		}
+
 		OCLogDebug(@"record %@ download: initiating download (requiredCellularSwitch=%@) of %@", syncContext.syncRecord, options[OCConnectionOptionRequiredCellularSwitchKey], item);
 
 		if ((progress = [self.core.connection downloadItem:item to:temporaryFileURL options:options resultTarget:[self.core _eventTargetWithSyncRecord:syncContext.syncRecord]]) != nil)
@@ -378,6 +447,15 @@ OCSYNCACTION_REGISTER_ISSUETEMPLATES
 	OCItem *item = self.archivedServerItem;
 	NSError *downloadError = event.error;
 	BOOL isTriggeredDownload = (self.options[OCCoreOptionDownloadTriggerID] != nil);
+	OCRangedDownloadJob *rangedDownloadJob;
+
+	if (((rangedDownloadJob = OCTypedCast(event.result, OCRangedDownloadJob)) != nil) && [rangedDownloadJob.identifier isEqual:self.rangedDownloadJob.identifier])
+	{
+		// Pick up latest chunk map and persist it with the sync record
+		rangedDownloadJob.chunkStoredHandler = nil;
+		self.rangedDownloadJob = rangedDownloadJob;
+		syncContext.updateStoredSyncRecordAfterItemUpdates = YES;
+	}
 
 	if ((event.error == nil) && (event.file != nil) && (item != nil))
 	{
@@ -387,6 +465,9 @@ OCSYNCACTION_REGISTER_ISSUETEMPLATES
 		BOOL useDownloadedFile = YES;
 		OCItem *latestVersionOfItem = nil;
 
+		// Downloaded file is moved into the vault below, no need to resume the job
+		self.rangedDownloadJob = nil;
+
 		// Using archivedServerItem for item, which can sometimes differ from localItem, so make sure to carry info over
 		[item prepareToReplace:self.localItem];
 
@@ -575,6 +656,9 @@ OCSYNCACTION_REGISTER_ISSUETEMPLATES
 		if ([downloadError isOCErrorWithCode:OCErrorCancelled])
 		{
 			// Download has been cancelled by the user => create no issue, remove sync record reference and the record itself instead
+			[self.rangedDownloadJob destroy];
+			self.rangedDownloadJob = nil;
+
 			if (item != nil)
 			{
 				[item removeSyncRecordID:syncContext.syncRecord.recordID activity:OCItemSyncActivityDownloading];
@@ -790,12 +874,14 @@ OCSYNCACTION_REGISTER_ISSUETEMPLATES
 {
 	self.options = [decoder decodeObjectOfClasses:OCEvent.safeClasses forKey:@"options"];
 	_resolutionRetries = (NSUInteger)[decoder decodeIntForKey:@"resolutionRetries"];
+	_rangedDownloadJob = [decoder decodeObjectOfClass:OCRangedDownloadJob.class forKey:@"rangedDownloadJob"];
 }
 
 - (void)encodeActionData:(NSCoder *)coder
 {
 	[coder encodeObject:self.options forKey:@"options"];
 	[coder encodeInteger:_resolutionRetries forKey:@"resolutionRetries"];
+	[coder encodeObject:_rangedDownloadJob forKey:@"rangedDownloadJob"];
 }
 
 @end
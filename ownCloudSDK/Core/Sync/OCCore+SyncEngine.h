@@ -94,6 +94,7 @@ extern OCProgressPathElementIdentifier OCProgressPathElementIdentifierCoreRoot;
 extern OCProgressPathElementIdentifier OCProgressPathElementIdentifierCoreSyncRecordPath;
 extern OCProgressPathElementIdentifier OCProgressPathElementIdentifierCoreConnectionPath;
 
-extern OCKeyValueStoreKey OCKeyValueStoreKeyOCCoreSyncEventsQueue;
+extern OCKeyValueStoreKey OCKeyValueStoreKeyOCCoreSyncEventsQueue; //!< Queue of sync events stored by earlier versions (OCEventQueue)
+extern OCKeyValueStoreKey OCKeyValueStoreKeyOCCoreSyncEvents; //!< Collection of queued sync events (OCEventRecord), keyed by event UUID
 
 NS_ASSUME_NONNULL_END
@@ -47,6 +47,7 @@ OCIPCNotificationName OCIPCNotificationNameProcessSyncRecordsBase = @"org.ownclo
 OCIPCNotificationName OCIPCNotificationNameUpdateSyncRecordsBase = @"org.owncloud.update-sync-records";
 
 OCKeyValueStoreKey OCKeyValueStoreKeyOCCoreSyncEventsQueue = @"syncEventsQueue";
+OCKeyValueStoreKey OCKeyValueStoreKeyOCCoreSyncEvents = @"syncEvents";
 static OCKeyValueStoreKey OCKeyValueStoreKeyActiveProcessCores = @"activeProcessCores";
 
 @implementation OCCore (SyncEngine)
@@ -747,9 +748,7 @@ static OCKeyValueStoreKey OCKeyValueStoreKeyActiveProcessCores = @"activeProcess
 		// occurs only inside Sync Engine global lock protection, we're not in danger of re-adding an event that's just been removed.
 		// On the other end, even if an event is added right after reading it, the addition of the event will trigger a new run of
 		// processSyncRecords, at which time the event will be transfered over to the database
-		OCEventQueue *eventQueue = [self.vault.keyValueStore readObjectForKey:OCKeyValueStoreKeyOCCoreSyncEventsQueue];
-
-		for (OCEventRecord *eventRecord in eventQueue.records)
+		for (OCEventRecord *eventRecord in [self _queuedSyncEventRecords])
 		{
 			// Avoid double-transfer
 			if (![self.database queueContainsEvent:eventRecord.event])
@@ -1293,17 +1292,7 @@ static OCKeyValueStoreKey OCKeyValueStoreKeyActiveProcessCores = @"activeProcess
 		while ((event = [self.database nextEventForSyncRecordID:syncRecordID afterEventID:nil]) != nil)
 		{
 			// Remove from KVS (if exists), now that we can be sure the OCEvent is in the database
-			[self.vault.keyValueStore updateObjectForKey:OCKeyValueStoreKeyOCCoreSyncEventsQueue usingModifier:^id _Nullable(OCEventQueue * _Nullable eventQueue, BOOL * _Nonnull outDidModify) {
- 				BOOL didRemove;
-
- 				didRemove = [eventQueue removeEventRecordForEventUUID:event.uuid];
-
-				OCTLogDebug(@[@"EventRecord"], @"Removing from KVS (didRemove=%d): %@", didRemove, event);
-
-				*outDidModify = didRemove;
-
-				return (eventQueue);
-			}];
+			[self _removeQueuedSyncEvent:event];
 
 			// Process event
 			OCSyncContext *syncContext;
@@ -1723,31 +1712,7 @@ static OCKeyValueStoreKey OCKeyValueStoreKeyActiveProcessCores = @"activeProcess
 
 		// Store in KVS
 		OCTLogDebug(@[@"EventRecord"], @"Queuing in KVS: %@", event);
-		[self.vault.keyValueStore updateObjectForKey:OCKeyValueStoreKeyOCCoreSyncEventsQueue usingModifier:^id _Nullable(OCEventQueue * _Nullable eventQueue, BOOL * _Nonnull outDidModify) {
-			OCEventRecord *eventRecord;
-
-			if (eventQueue == nil) { eventQueue = [OCEventQueue new]; }
-
-			if ((eventRecord = [[OCEventRecord alloc] initWithEvent:event syncRecordID:recordID]) != nil)
-			{
-				// Checks for duplicate entries (in case process was terminated after the OCEvent was saved in KVS, but before the HTTP request was removed from the pipeline db)
-				if ([eventQueue addEventRecord:eventRecord])
-				{
-					*outDidModify = YES;
-					OCTLogDebug(@[@"EventRecord"], @"Added to KVS: %@", event);
-				}
-				else
-				{
-					OCTLogDebug(@[@"EventRecord"], @"Not adding to KVS (duplicate event): %@", event);
-				}
-			}
-			else
-			{
-				OCTLogError(@[@"EventRecord"], @"Allocation of OCEventRecord failed");
-			}
-
-			return (eventQueue);
-		}];
+		[self _queueSyncEvent:event forSyncRecordID:recordID];
 
 		[self setNeedsToProcessSyncRecords];
 
@@ -1759,6 +1724,73 @@ static OCKeyValueStoreKey OCKeyValueStoreKeyActiveProcessCores = @"activeProcess
 	}
 }
 
+/*
+	Sync events are stored in a KVS collection (OCKeyValueStoreKeyOCCoreSyncEvents), keyed by event UUID, so that adding
+	and removing an event doesn't require reading and writing all other queued events. The collection rejects UUIDs of
+	events that are part of it or have recently been removed from it, which prevents duplicates.
+
+	Events queued by earlier versions in the OCEventQueue stored under OCKeyValueStoreKeyOCCoreSyncEventsQueue are still
+	transferred and removed from there.
+*/
+- (void)_queueSyncEvent:(OCEvent *)event forSyncRecordID:(OCSyncRecordID)recordID
+{
+	OCEventRecord *eventRecord;
+
+	if ((eventRecord = [[OCEventRecord alloc] initWithEvent:event syncRecordID:recordID]) != nil)
+	{
+		OCKeyValueStoreCollectionEntryID entryID = (event.uuid != nil) ? event.uuid : NSUUID.UUID.UUIDString;
+
+		// Checks for duplicate entries (in case process was terminated after the OCEvent was saved in KVS, but before the HTTP request was removed from the pipeline db)
+		if ([self.vault.keyValueStore addObject:eventRecord toCollectionForKey:OCKeyValueStoreKeyOCCoreSyncEvents withEntryID:entryID])
+		{
+			OCTLogDebug(@[@"EventRecord"], @"Added to KVS: %@", event);
+		}
+		else
+		{
+			OCTLogDebug(@[@"EventRecord"], @"Not adding to KVS (duplicate event): %@", event);
+		}
+	}
+	else
+	{
+		OCTLogError(@[@"EventRecord"], @"Allocation of OCEventRecord failed");
+	}
+}
+
+- (void)_removeQueuedSyncEvent:(OCEvent *)event
+{
+	BOOL didRemove = NO;
+
+	if (event.uuid != nil)
+	{
+		didRemove = [self.vault.keyValueStore removeObjectWithEntryID:event.uuid fromCollectionForKey:OCKeyValueStoreKeyOCCoreSyncEvents];
+
+		if (!didRemove && (((OCEventQueue *)[self.vault.keyValueStore readObjectForKey:OCKeyValueStoreKeyOCCoreSyncEventsQueue]).records.count > 0))
+		{
+			// Event queued by an earlier version
+			[self.vault.keyValueStore updateObjectForKey:OCKeyValueStoreKeyOCCoreSyncEventsQueue usingModifier:^id _Nullable(OCEventQueue * _Nullable eventQueue, BOOL * _Nonnull outDidModify) {
+				*outDidModify = [eventQueue removeEventRecordForEventUUID:event.uuid];
+
+				return (eventQueue);
+			}];
+		}
+	}
+
+	OCTLogDebug(@[@"EventRecord"], @"Removing from KVS (didRemove=%d): %@", didRemove, event);
+}
+
+- (NSArray<OCEventRecord *> *)_queuedSyncEventRecords
+{
+	NSArray<OCEventRecord *> *eventRecords = OCTypedCast([self.vault.keyValueStore readObjectForKey:OCKeyValueStoreKeyOCCoreSyncEvents], NSArray);
+	OCEventQueue *legacyEventQueue = [self.vault.keyValueStore readObjectForKey:OCKeyValueStoreKeyOCCoreSyncEventsQueue];
+
+	if (legacyEventQueue.records.count > 0)
+	{
+		eventRecords = (eventRecords != nil) ? [legacyEventQueue.records arrayByAddingObjectsFromArray:eventRecords] : [legacyEventQueue.records copy];
+	}
+
+	return ((eventRecords != nil) ? eventRecords : @[]);
+}
+
 #pragma mark - Sync issue handling
 - (void)resolveSyncIssue:(OCSyncIssue *)issue withChoice:(OCSyncIssueChoice *)choice userInfo:(NSDictionary<OCEventUserInfoKey, id> *)userInfo completionHandler:(nullable OCCoreSyncIssueResolutionResultHandler)completionHandler
 {
@@ -2150,9 +2182,7 @@ static OCKeyValueStoreKey OCKeyValueStoreKeyActiveProcessCores = @"activeProcess
 
 			// Retrieve sync record IDs with pending events
 			// - include (possibly as-of-yet in-delivery) events
-			OCEventQueue *eventQueue = [self.vault.keyValueStore readObjectForKey:OCKeyValueStoreKeyOCCoreSyncEventsQueue];
-
-			for (OCEventRecord *eventRecord in eventQueue.records)
+			for (OCEventRecord *eventRecord in [self _queuedSyncEventRecords])
 			{
 				if (eventRecord.syncRecordID != nil)
 				{
@@ -19,6 +19,7 @@
 #import "OCDataSourceComposition.h"
 #import "NSArray+OCFiltering.h"
 #import "OCMacros.h"
+#import "OCDataSourceDiff.h"
 
 #pragma mark - Record definition
 @interface OCDataSourceCompositionRecord : NSObject
@@ -38,8 +39,15 @@
 
 @property(assign) BOOL hasUpdates;
 
+// Composition state (only accessed on the composition queue)
+@property(strong,nullable) NSArray<OCDataItemReference> *composedItems; //!< Items of the active snapshot after filtering and sorting
+@property(strong,nullable) NSMutableSet<OCDataItemReference> *excludedItemRefs; //!< Items of the active snapshot that did not pass the filters (nil if no filters are applied)
+@property(assign) NSUInteger composedConfigurationGeneration; //!< Configuration generation of the composition at the time .composedItems was last determined
+
 - (instancetype)initWithSource:(OCDataSource *)source composition:(OCDataSourceComposition *)composition;
 
+- (NSArray<OCDataItemReference> *)composeItemsWithFilter:(nullable OCDataSourceItemFilter)compositionFilter snapshotDiff:(nullable OCDataSourceDiff *)snapshotDiff updatedItems:(nullable NSSet<OCDataItemReference> *)updatedItems; //!< Applies filters and sorting to the items of the active snapshot. If snapshotDiff is provided, filters are only evaluated for inserted and updated items.
+
 @end
 
 #pragma mark - Composition
@@ -54,6 +62,10 @@
 	BOOL _compositionNeedsUpdate;
 
 	BOOL _supressNeedsCompositionUpdates;
+
+	NSUInteger _configurationGeneration; //!< Incremented whenever sources, filters, sorting or inclusion change, invalidating previous compositions
+	NSUInteger _composedConfigurationGeneration;
+	NSArray<OCDataItemReference> *_composedItemReferences; //!< Result of the last composition
 }
 @end
 
@@ -162,13 +174,13 @@
 - (void)setFilter:(OCDataSourceItemFilter)filter
 {
 	_filter = [filter copy];
-	[self setNeedsCompositionUpdate];
+	[self setNeedsCompositionUpdateWithConfigurationChange];
 }
 
 - (void)setSortComparator:(OCDataSourceItemComparator)sortComparator
 {
 	_sortComparator = [sortComparator copy];
-	[self setNeedsCompositionUpdate];
+	[self setNeedsCompositionUpdateWithConfigurationChange];
 }
 
 - (void)setSortComparator:(OCDataSourceItemComparator)sortComparator forSource:(OCDataSource *)source
@@ -178,7 +190,7 @@
 		[self recordForSource:source].sortComparator = sortComparator;
 	}
 
-	[self setNeedsCompositionUpdate];
+	[self setNeedsCompositionUpdateWithConfigurationChange];
 }
 
 - (void)setFilter:(OCDataSourceItemFilter)filter forSource:(OCDataSource *)source
@@ -188,7 +200,7 @@
 		[self recordForSource:source].filter = filter;
 	}
 
-	[self setNeedsCompositionUpdate];
+	[self setNeedsCompositionUpdateWithConfigurationChange];
 }
 
 - (void)setInclude:(BOOL)include forSource:(OCDataSource *)source
@@ -206,7 +218,7 @@
 
 	if (didChange)
 	{
-		[self setNeedsCompositionUpdate];
+		[self setNeedsCompositionUpdateWithConfigurationChange];
 	}
 }
 
@@ -243,7 +255,7 @@
 		[_sourceRecords setArray:newSourceRecords];
 	}
 
-	[self setNeedsCompositionUpdate];
+	[self setNeedsCompositionUpdateWithConfigurationChange];
 }
 
 - (void)addSources:(NSArray<OCDataSource *> *)sources
@@ -257,7 +269,7 @@
 			[_sourceRecords addObjectsFromArray:newSourceRecords];
 		}
 
-		[self setNeedsCompositionUpdate];
+		[self setNeedsCompositionUpdateWithConfigurationChange];
 	}
 }
 
@@ -283,7 +295,7 @@
 
 		NSLog(@"BEF: After: %@", _sourceRecords);
 
-		[self setNeedsCompositionUpdate];
+		[self setNeedsCompositionUpdateWithConfigurationChange];
 	}
 }
 
@@ -300,7 +312,7 @@
 		[_sourceRecords setArray:filteredRecords];
 	}
 
-	[self setNeedsCompositionUpdate];
+	[self setNeedsCompositionUpdateWithConfigurationChange];
 }
 
 #pragma mark - Composition
@@ -319,6 +331,16 @@
 	}
 }
 
+- (void)setNeedsCompositionUpdateWithConfigurationChange
+{
+	@synchronized(self)
+	{
+		_configurationGeneration++;
+	}
+
+	[self setNeedsCompositionUpdate];
+}
+
 - (void)setNeedsCompositionUpdate
 {
 	if (_supressNeedsCompositionUpdates)
@@ -374,21 +396,32 @@
 	NSMutableArray<OCDataItemReference> *composedItemReferences = [NSMutableArray new];
 	NSMutableSet<OCDataItemReference> *updatedItemReferences = [NSMutableSet new];
 	NSArray<OCDataSourceCompositionRecord *> *sourceRecords;
-	NSMapTable<OCDataItemReference, OCDataSourceCompositionRecord *> *compositionRecordByItemReference = nil;
+	NSUInteger configurationGeneration;
+	BOOL fullComposition, compositionChanged = NO;
+
+	// Items that need to be removed from / (re)inserted into the sorted composition
+	NSMutableSet<OCDataItemReference> *unsortedItemReferences = [NSMutableSet new];
+	NSMutableArray<OCDataItemReference> *itemReferencesToSort = [NSMutableArray new];
+	NSMapTable<OCDataItemReference, OCDataSourceCompositionRecord *> *recordByItemReferenceToSort = [NSMapTable strongToWeakObjectsMapTable];
 
 	@synchronized(_sourceRecords)
 	{
 		sourceRecords = [_sourceRecords copy];
 	}
 
-	if (_sortComparator != nil)
+	@synchronized(self)
 	{
-		compositionRecordByItemReference = [NSMapTable strongToWeakObjectsMapTable];
+		configurationGeneration = _configurationGeneration;
 	}
 
+	// Changes to sources, filters, sorting or inclusion require a full composition, otherwise only records with updates are recomposed
+	fullComposition = (_composedItemReferences == nil) || (_composedConfigurationGeneration != configurationGeneration);
+
 	for (OCDataSourceCompositionRecord *record in sourceRecords)
 	{
 		NSRange itemRange = NSMakeRange(composedItemReferences.count, 0);
+		OCDataSourceSnapshot *previousSnapshot = record.activeSnapshot, *snapshot = nil;
+		NSArray<OCDataItemReference> *previousComposedItems = record.composedItems, *composedItems = previousComposedItems;
 
 		// Skip records that shouldn't be included
 		if (!record.include) {
@@ -403,97 +436,157 @@
 			{
 				if (record.hasUpdates)
 				{
-					OCDataSourceSnapshot *snapshot = [record.subscription snapshotResettingChangeTracking:YES];
+					snapshot = [record.subscription snapshotResettingChangeTracking:YES];
 
 					record.activeSnapshot = snapshot;
 					record.hasUpdates = NO;
-
-					[updatedItemReferences unionSet:snapshot.updatedItems];
 				}
 			}
 		}
 
-		// Add to composed array
-		NSArray<OCDataItemReference> *snapshotItems;
-
-		if ((snapshotItems = record.activeSnapshot.items) != nil)
+		if ((snapshot != nil) || (record.composedConfigurationGeneration != configurationGeneration) || (composedItems == nil))
 		{
-			if (record.filter != nil)
-			{
-				// Apply source-specific filter
-				snapshotItems = [snapshotItems filteredArrayUsingBlock:^BOOL(OCDataItemReference  _Nonnull itemRef, BOOL * _Nonnull stop) {
-					if (record.filter(record.source, itemRef))
-					{
-						return (YES);
-					}
+			OCDataSourceDiff *snapshotDiff = nil;
 
-					[updatedItemReferences removeObject:itemRef];
-
-					return (NO);
-				}];
+			// Use the snapshot's differences if it directly follows the previously composed snapshot
+			if ((snapshot != nil) && (previousSnapshot != nil) && (previousComposedItems != nil) && (snapshot.previousItems == previousSnapshot.items) &&
+			    (record.composedConfigurationGeneration == configurationGeneration))
+			{
+				snapshotDiff = snapshot.diff;
 			}
 
-			if (record.sortComparator != nil)
+			composedItems = [record composeItemsWithFilter:_filter snapshotDiff:snapshotDiff updatedItems:snapshot.updatedItems];
+			record.composedItems = composedItems;
+			record.composedConfigurationGeneration = configurationGeneration;
+
+			// Propagate updates for items that are part of the composition
+			for (OCDataItemReference itemRef in snapshot.updatedItems)
 			{
-				// Apply source-specific sorting
-				snapshotItems = [snapshotItems sortedArrayUsingComparator:^NSComparisonResult(OCDataItemReference itemRef1, OCDataItemReference itemRef2) {
-					return (record.sortComparator(record.source, itemRef1, record.source, itemRef2));
-				}];
+				if (![record.excludedItemRefs containsObject:itemRef])
+				{
+					[updatedItemReferences addObject:itemRef];
+				}
 			}
 
-			if ((_sortComparator != nil) || (_filter != nil))
+			if ((composedItems != previousComposedItems) || (updatedItemReferences.count > 0))
 			{
-				for (OCDataItemReference itemRef in snapshotItems)
+				compositionChanged = YES;
+
+				if (!fullComposition && (_sortComparator != nil))
 				{
-					BOOL includeItem = YES;
+					// Determine which items need to be (re)sorted into the composition
+					OCDataSourceDiff *composedDiff = [OCDataSourceDiff diffFromItems:previousComposedItems toItems:composedItems detectMoves:NO];
 
-					if (_filter != nil)
-					{
-						includeItem = _filter(record.source, itemRef);
+					[unsortedItemReferences addObjectsFromArray:composedDiff.removedItems];
 
-						if (includeItem)
-						{
-							// Only add items passing the filter
-							[composedItemReferences addObject:itemRef];
-						}
-						else
-						{
-							// Remove updates for items that are not in the composed set of items
-							[updatedItemReferences removeObject:itemRef];
-						}
+					for (OCDataItemReference itemRef in composedDiff.insertedItems)
+					{
+						// Also track inserted items as unsorted, so they're not queued again if they were also updated
+						[unsortedItemReferences addObject:itemRef];
+						[itemReferencesToSort addObject:itemRef];
+						[recordByItemReferenceToSort setObject:record forKey:itemRef];
 					}
 
-					if ((_sortComparator != nil) && includeItem)
+					// Updated items may have changed their sort position
+					for (OCDataItemReference itemRef in snapshot.updatedItems)
 					{
-						[compositionRecordByItemReference setObject:record forKey:itemRef];
+						if (![record.excludedItemRefs containsObject:itemRef] && ![unsortedItemReferences containsObject:itemRef])
+						{
+							[unsortedItemReferences addObject:itemRef];
+							[itemReferencesToSort addObject:itemRef];
+							[recordByItemReferenceToSort setObject:record forKey:itemRef];
+						}
 					}
 				}
 			}
+		}
 
-			if (_filter == nil)
-			{
-				[composedItemReferences addObjectsFromArray:snapshotItems];
-			}
-
-			itemRange.length = composedItemReferences.count - itemRange.location;
+		// Add to composed array
+		if (composedItems != nil)
+		{
+			[composedItemReferences addObjectsFromArray:composedItems];
+			itemRange.length = composedItems.count;
 		}
 
 		record.itemRange = itemRange;
 	}
 
+	if (!fullComposition && !compositionChanged)
+	{
+		// Nothing changed
+		return;
+	}
+
 	// Propagate updates
 	@synchronized(_subscriptions)
 	{
-		// Make items available for sorting by reference
-		_compositionRecordByItemReference = compositionRecordByItemReference;
-
 		// Sort items
 		if (_sortComparator != nil)
 		{
-			[composedItemReferences sortUsingComparator:^NSComparisonResult(OCDataItemReference reference1, OCDataItemReference reference2) {
-				return (_sortComparator(self, reference1, self, reference2));
-			}];
+			if (!fullComposition && (((unsortedItemReferences.count + itemReferencesToSort.count) * 4) < composedItemReferences.count))
+			{
+				// Incremental: remove changed items from the previous composition, then insert them at their sorted positions
+				NSMutableArray<OCDataItemReference> *sortedItemReferences = [[NSMutableArray alloc] initWithCapacity:composedItemReferences.count];
+				NSComparator comparator = ^NSComparisonResult(OCDataItemReference reference1, OCDataItemReference reference2) {
+					return (self->_sortComparator(self, reference1, self, reference2));
+				};
+
+				for (OCDataItemReference itemRef in _composedItemReferences)
+				{
+					if (![unsortedItemReferences containsObject:itemRef])
+					{
+						[sortedItemReferences addObject:itemRef];
+					}
+					else
+					{
+						[_compositionRecordByItemReference removeObjectForKey:itemRef];
+					}
+				}
+
+				for (OCDataItemReference itemRef in itemReferencesToSort)
+				{
+					[_compositionRecordByItemReference setObject:[recordByItemReferenceToSort objectForKey:itemRef] forKey:itemRef];
+				}
+
+				for (OCDataItemReference itemRef in itemReferencesToSort)
+				{
+					NSUInteger insertIndex = [sortedItemReferences indexOfObject:itemRef inSortedRange:NSMakeRange(0, sortedItemReferences.count) options:NSBinarySearchingInsertionIndex usingComparator:comparator];
+
+					[sortedItemReferences insertObject:itemRef atIndex:insertIndex];
+				}
+
+				composedItemReferences = sortedItemReferences;
+			}
+			else
+			{
+				// Full: make items available for sorting by reference, then sort all items
+				NSMapTable<OCDataItemReference, OCDataSourceCompositionRecord *> *compositionRecordByItemReference = [NSMapTable strongToWeakObjectsMapTable];
+
+				for (OCDataSourceCompositionRecord *record in sourceRecords)
+				{
+					if (record.include)
+					{
+						for (OCDataItemReference itemRef in record.composedItems)
+						{
+							[compositionRecordByItemReference setObject:record forKey:itemRef];
+						}
+					}
+				}
+
+				_compositionRecordByItemReference = compositionRecordByItemReference;
+
+				[composedItemReferences sortUsingComparator:^NSComparisonResult(OCDataItemReference reference1, OCDataItemReference reference2) {
+					return (self->_sortComparator(self, reference1, self, reference2));
+				}];
+			}
 		}
+		else
+		{
+			_compositionRecordByItemReference = nil;
+		}
+
+		_composedItemReferences = [composedItemReferences copy];
+		_composedConfigurationGeneration = configurationGeneration;
 
 		// Update data source
 		[self setItemReferences:composedItemReferences updated:updatedItemReferences];
@@ -593,6 +686,113 @@
 	[_subscription terminate];
 }
 
+- (BOOL)_includeItemRef:(OCDataItemReference)itemRef compositionFilter:(nullable OCDataSourceItemFilter)compositionFilter
+{
+	if ((_filter != nil) && !_filter(_source, itemRef))
+	{
+		return (NO);
+	}
+
+	if ((compositionFilter != nil) && !compositionFilter(_source, itemRef))
+	{
+		return (NO);
+	}
+
+	return (YES);
+}
+
+- (NSArray<OCDataItemReference> *)composeItemsWithFilter:(nullable OCDataSourceItemFilter)compositionFilter snapshotDiff:(nullable OCDataSourceDiff *)snapshotDiff updatedItems:(nullable NSSet<OCDataItemReference> *)updatedItems
+{
+	NSArray<OCDataItemReference> *items, *composedItems;
+
+	if ((items = _activeSnapshot.items) == nil)
+	{
+		_excludedItemRefs = nil;
+		return (nil);
+	}
+
+	if ((_filter == nil) && (compositionFilter == nil))
+	{
+		// No filters
+		_excludedItemRefs = nil;
+		composedItems = items;
+	}
+	else
+	{
+		if ((snapshotDiff != nil) && (_excludedItemRefs != nil))
+		{
+			// Reuse previous filter results and only evaluate filters for inserted and updated items
+			for (OCDataItemReference itemRef in snapshotDiff.removedItems)
+			{
+				[_excludedItemRefs removeObject:itemRef];
+			}
+
+			for (OCDataItemReference itemRef in snapshotDiff.insertedItems)
+			{
+				if ([self _includeItemRef:itemRef compositionFilter:compositionFilter])
+				{
+					[_excludedItemRefs removeObject:itemRef];
+				}
+				else
+				{
+					[_excludedItemRefs addObject:itemRef];
+				}
+			}
+
+			for (OCDataItemReference itemRef in updatedItems)
+			{
+				if ([self _includeItemRef:itemRef compositionFilter:compositionFilter])
+				{
+					[_excludedItemRefs removeObject:itemRef];
+				}
+				else
+				{
+					[_excludedItemRefs addObject:itemRef];
+				}
+			}
+		}
+		else
+		{
+			// Evaluate filters for all items
+			_excludedItemRefs = [NSMutableSet new];
+
+			for (OCDataItemReference itemRef in items)
+			{
+				if (![self _includeItemRef:itemRef compositionFilter:compositionFilter])
+				{
+					[_excludedItemRefs addObject:itemRef];
+				}
+			}
+		}
+
+		if (_excludedItemRefs.count == 0)
+		{
+			composedItems = items;
+		}
+		else
+		{
+			NSMutableSet<OCDataItemReference> *excludedItemRefs = _excludedItemRefs;
+
+			composedItems = [items filteredArrayUsingBlock:^BOOL(OCDataItemReference  _Nonnull itemRef, BOOL * _Nonnull stop) {
+				return (![excludedItemRefs containsObject:itemRef]);
+			}];
+		}
+	}
+
+	if (_sortComparator != nil)
+	{
+		// Apply source-specific sorting
+		OCDataSourceItemComparator sortComparator = _sortComparator;
+		OCDataSource *source = _source;
+
+		composedItems = [composedItems sortedArrayUsingComparator:^NSComparisonResult(OCDataItemReference itemRef1, OCDataItemReference itemRef2) {
+			return (sortComparator(source, itemRef1, source, itemRef2));
+		}];
+	}
+
+	return (composedItems);
+}
+
 - (void)updateWithSubscription:(OCDataSourceSubscription *)subscription
 {
 	@synchronized(self)
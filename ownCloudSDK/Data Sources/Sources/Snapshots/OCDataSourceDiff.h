@@ -0,0 +1,63 @@
+//
+//  OCDataSourceDiff.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCDataTypes.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface OCDataSourceDiffMove : NSObject
+
+@property(readonly,strong) OCDataItemReference itemRef;
+
+@property(readonly) NSUInteger fromIndex; //!< Index of the item in the previous items
+@property(readonly) NSUInteger toIndex; //!< Index of the item in the new items
+
+@end
+
+/*
+	Differences between two arrays of item references, as index-based inserts, removals and moves.
+
+	Since item references are unique within a data source, items are matched by identity (Heckel-style):
+	- the common prefix and suffix of both arrays are skipped
+	- the remaining previous items are indexed by reference, then the remaining new items are matched against that index
+	- unmatched previous items are removed, unmatched new items are inserted
+	- matched items that are not part of the longest increasing subsequence of their previous indexes have changed their position
+	  relative to the other items and are reported as moves. Items that only shifted because of inserts or removals are not moves.
+
+	This yields a minimal set of moves in O(n + m log m) time, where m is the number of matched items outside prefix and suffix.
+	If a reference occurs more than once in one of the arrays, its occurrences are reported as removals and insertions.
+*/
+
+@interface OCDataSourceDiff : NSObject
+
+@property(readonly,strong) NSIndexSet *removedIndexes; //!< Indexes of removed items in the previous items
+@property(readonly,strong) NSIndexSet *insertedIndexes; //!< Indexes of inserted items in the new items
+@property(readonly,strong) NSArray<OCDataSourceDiffMove *> *moves; //!< Items that changed their position relative to the other items
+
+@property(readonly,strong) NSArray<OCDataItemReference> *removedItems; //!< Removed items, in the order of removedIndexes
+@property(readonly,strong) NSArray<OCDataItemReference> *insertedItems; //!< Inserted items, in the order of insertedIndexes
+
+@property(readonly,nonatomic) BOOL hasChanges; //!< YES if items were removed, inserted or moved
+
++ (instancetype)diffFromItems:(nullable NSArray<OCDataItemReference> *)previousItems toItems:(nullable NSArray<OCDataItemReference> *)items; //!< Computes the differences, including moves
++ (instancetype)diffFromItems:(nullable NSArray<OCDataItemReference> *)previousItems toItems:(nullable NSArray<OCDataItemReference> *)items detectMoves:(BOOL)detectMoves; //!< Computes the differences. Pass NO for detectMoves if only inserts and removals are needed.
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,231 @@
+//
+//  OCDataSourceDiff.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCDataSourceDiff.h"
+
+@implementation OCDataSourceDiffMove
+
+- (instancetype)initWithItemRef:(OCDataItemReference)itemRef fromIndex:(NSUInteger)fromIndex toIndex:(NSUInteger)toIndex
+{
+	if ((self = [super init]) != nil)
+	{
+		_itemRef = itemRef;
+		_fromIndex = fromIndex;
+		_toIndex = toIndex;
+	}
+
+	return (self);
+}
+
+- (NSString *)description
+{
+	return ([NSString stringWithFormat:@"<%@: %p, itemRef: %@, %lu -> %lu>", NSStringFromClass(self.class), self, _itemRef, (unsigned long)_fromIndex, (unsigned long)_toIndex]);
+}
+
+@end
+
+@implementation OCDataSourceDiff
+
+static inline BOOL OCDataSourceDiffItemRefsEqual(OCDataItemReference itemRef1, OCDataItemReference itemRef2)
+{
+	return ((itemRef1 == itemRef2) || [itemRef1 isEqual:itemRef2]);
+}
+
++ (instancetype)diffFromItems:(NSArray<OCDataItemReference> *)previousItems toItems:(NSArray<OCDataItemReference> *)items
+{
+	return ([self diffFromItems:previousItems toItems:items detectMoves:YES]);
+}
+
++ (instancetype)diffFromItems:(NSArray<OCDataItemReference> *)previousItems toItems:(NSArray<OCDataItemReference> *)items detectMoves:(BOOL)detectMoves
+{
+	OCDataSourceDiff *diff = [self new];
+	NSUInteger previousCount = previousItems.count, count = items.count;
+	NSUInteger prefixLength = 0, suffixLength = 0, maxCommonLength = MIN(previousCount, count);
+
+	NSMutableIndexSet *removedIndexes = [NSMutableIndexSet new];
+	NSMutableIndexSet *insertedIndexes = [NSMutableIndexSet new];
+	NSMutableArray<OCDataItemReference> *removedItems = [NSMutableArray new];
+	NSMutableArray<OCDataItemReference> *insertedItems = [NSMutableArray new];
+	NSMutableArray<OCDataSourceDiffMove *> *moves = [NSMutableArray new];
+
+	// Skip common prefix and suffix - typically the largest part of the items
+	while ((prefixLength < maxCommonLength) && OCDataSourceDiffItemRefsEqual(previousItems[prefixLength], items[prefixLength]))
+	{
+		prefixLength++;
+	}
+
+	while ((suffixLength < (maxCommonLength - prefixLength)) && OCDataSourceDiffItemRefsEqual(previousItems[previousCount - suffixLength - 1], items[count - suffixLength - 1]))
+	{
+		suffixLength++;
+	}
+
+	NSRange previousRange = NSMakeRange(prefixLength, previousCount - prefixLength - suffixLength);
+	NSRange range = NSMakeRange(prefixLength, count - prefixLength - suffixLength);
+
+	if ((previousRange.length == 0) || (range.length == 0))
+	{
+		// Only removals or only insertions
+		if (previousRange.length > 0)
+		{
+			[removedIndexes addIndexesInRange:previousRange];
+			[removedItems addObjectsFromArray:[previousItems subarrayWithRange:previousRange]];
+		}
+
+		if (range.length > 0)
+		{
+			[insertedIndexes addIndexesInRange:range];
+			[insertedItems addObjectsFromArray:[items subarrayWithRange:range]];
+		}
+	}
+	else
+	{
+		NSMutableDictionary<OCDataItemReference, NSNumber *> *previousIndexByItemRef = [[NSMutableDictionary alloc] initWithCapacity:previousRange.length];
+		NSMutableSet<OCDataItemReference> *duplicateItemRefs = nil;
+		NSUInteger maxMatchCount = MIN(previousRange.length, range.length), matchCount = 0;
+		NSUInteger *matchedPreviousIndexes = malloc(sizeof(NSUInteger) * maxMatchCount);
+		NSUInteger *matchedIndexes = malloc(sizeof(NSUInteger) * maxMatchCount);
+		BOOL *previousMatched = calloc(previousRange.length, sizeof(BOOL));
+
+		// Index previous items by reference
+		for (NSUInteger previousIdx = previousRange.location; previousIdx < NSMaxRange(previousRange); previousIdx++)
+		{
+			OCDataItemReference itemRef = previousItems[previousIdx];
+
+			if (previousIndexByItemRef[itemRef] != nil)
+			{
+				if (duplicateItemRefs == nil) { duplicateItemRefs = [NSMutableSet new]; }
+				[duplicateItemRefs addObject:itemRef];
+			}
+
+			previousIndexByItemRef[itemRef] = @(previousIdx);
+		}
+
+		// Match new items against previous items
+		for (NSUInteger idx = range.location; idx < NSMaxRange(range); idx++)
+		{
+			OCDataItemReference itemRef = items[idx];
+			NSNumber *previousIdx;
+
+			if (((previousIdx = previousIndexByItemRef[itemRef]) != nil) && ![duplicateItemRefs containsObject:itemRef] && (matchCount < maxMatchCount))
+			{
+				matchedPreviousIndexes[matchCount] = previousIdx.unsignedIntegerValue;
+				matchedIndexes[matchCount] = idx;
+				matchCount++;
+
+				previousMatched[previousIdx.unsignedIntegerValue - previousRange.location] = YES;
+
+				// Any further occurence of itemRef in items is an insertion
+				[previousIndexByItemRef removeObjectForKey:itemRef];
+			}
+			else
+			{
+				[insertedIndexes addIndex:idx];
+				[insertedItems addObject:itemRef];
+			}
+		}
+
+		// Unmatched previous items have been removed
+		for (NSUInteger previousIdx = previousRange.location; previousIdx < NSMaxRange(previousRange); previousIdx++)
+		{
+			if (!previousMatched[previousIdx - previousRange.location])
+			{
+				[removedIndexes addIndex:previousIdx];
+				[removedItems addObject:previousItems[previousIdx]];
+			}
+		}
+
+		// Matched items whose previous indexes are not part of the longest increasing subsequence have moved
+		if (detectMoves && (matchCount > 1))
+		{
+			NSUInteger *tailMatchIndexes = malloc(sizeof(NSUInteger) * matchCount); // tailMatchIndexes[l] = match with the smallest previous index ending an increasing subsequence of length l+1
+			NSUInteger *predecessorMatchIndexes = malloc(sizeof(NSUInteger) * matchCount);
+			BOOL *inSubsequence = calloc(matchCount, sizeof(BOOL));
+			NSUInteger subsequenceLength = 0;
+
+			for (NSUInteger matchIdx = 0; matchIdx < matchCount; matchIdx++)
+			{
+				NSUInteger previousIdx = matchedPreviousIndexes[matchIdx];
+				NSUInteger low = 0, high = subsequenceLength;
+
+				// Binary search for the first tail with a previous index larger than previousIdx
+				while (low < high)
+				{
+					NSUInteger mid = (low + high) / 2;
+
+					if (matchedPreviousIndexes[tailMatchIndexes[mid]] < previousIdx)
+					{
+						low = mid + 1;
+					}
+					else
+					{
+						high = mid;
+					}
+				}
+
+				predecessorMatchIndexes[matchIdx] = (low > 0) ? tailMatchIndexes[low - 1] : NSNotFound;
+				tailMatchIndexes[low] = matchIdx;
+
+				if (low == subsequenceLength)
+				{
+					subsequenceLength++;
+				}
+			}
+
+			for (NSUInteger matchIdx = tailMatchIndexes[subsequenceLength - 1]; matchIdx != NSNotFound; matchIdx = predecessorMatchIndexes[matchIdx])
+			{
+				inSubsequence[matchIdx] = YES;
+			}
+
+			for (NSUInteger matchIdx = 0; matchIdx < matchCount; matchIdx++)
+			{
+				if (!inSubsequence[matchIdx])
+				{
+					[moves addObject:[[OCDataSourceDiffMove alloc] initWithItemRef:items[matchedIndexes[matchIdx]] fromIndex:matchedPreviousIndexes[matchIdx] toIndex:matchedIndexes[matchIdx]]];
+				}
+			}
+
+			free(tailMatchIndexes);
+			free(predecessorMatchIndexes);
+			free(inSubsequence);
+		}
+
+		free(matchedPreviousIndexes);
+		free(matchedIndexes);
+		free(previousMatched);
+	}
+
+	diff->_removedIndexes = removedIndexes;
+	diff->_insertedIndexes = insertedIndexes;
+	diff->_removedItems = removedItems;
+	diff->_insertedItems = insertedItems;
+	diff->_moves = moves;
+
+	return (diff);
+}
+
+- (BOOL)hasChanges
+{
+	return ((_removedIndexes.count > 0) || (_insertedIndexes.count > 0) || (_moves.count > 0));
+}
+
+- (NSString *)description
+{
+	return ([NSString stringWithFormat:@"<%@: %p, removed: %@, inserted: %@, moves: %@>", NSStringFromClass(self.class), self, _removedIndexes, _insertedIndexes, _moves]);
+}
+
+@end
@@ -18,6 +18,7 @@
 
 #import <Foundation/Foundation.h>
 #import "OCDataTypes.h"
+#import "OCDataSourceDiff.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -31,6 +32,9 @@ NS_ASSUME_NONNULL_BEGIN
 @property(strong,nullable) NSSet<OCDataItemReference> *updatedItems; //!< Updated items since last snapshot
 @property(strong,nullable) NSSet<OCDataItemReference> *removedItems; //!< Removed items since last snapshot
 
+@property(strong,nullable) NSArray<OCDataItemReference> *previousItems; //!< The item references at the time of the last snapshot that reset change tracking (only available if the subscription tracks differences)
+@property(strong,nullable,nonatomic) OCDataSourceDiff *diff; //!< Index-based inserts, removals and moves from previousItems to items. Computed on first access. Only available if the subscription tracks differences.
+
 @property(strong,nullable) NSDictionary<OCDataSourceSpecialItem, id<OCDataItem>> *specialItems; //!< The current special items at the time of snapshot
 
 @end
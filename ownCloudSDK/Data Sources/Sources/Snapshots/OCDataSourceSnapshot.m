@@ -20,4 +20,27 @@
 
 @implementation OCDataSourceSnapshot
 
+@synthesize diff = _diff;
+
+- (OCDataSourceDiff *)diff
+{
+	@synchronized(self)
+	{
+		if ((_diff == nil) && (_previousItems != nil))
+		{
+			_diff = [OCDataSourceDiff diffFromItems:_previousItems toItems:_items];
+		}
+
+		return (_diff);
+	}
+}
+
+- (void)setDiff:(OCDataSourceDiff *)diff
+{
+	@synchronized(self)
+	{
+		_diff = diff;
+	}
+}
+
 @end
@@ -19,6 +19,7 @@
 #import "OCDataSourceSubscription+Internal.h"
 #import "OCDataSource.h"
 #import "OCLogger.h"
+#import "OCDataSourceDiff.h"
 
 @implementation OCDataSourceSubscription (Internal)
 
@@ -116,23 +117,8 @@
 			NSMutableSet<OCDataItemReference> *previouslyRemovedAndNowReaddedItemRefs = nil;
 			NSMutableSet<OCDataItemReference> *previouslyAddedAndNowRemovedItemRefs = nil;
 			NSMutableSet<OCDataItemReference> *danglingUpdatedItemRefs = nil;
-			NSSet<OCDataItemReference> *existingItemRefs = nil;
 			BOOL itemRefsChanged = NO;
 
-			if (_itemRefs != nil)
-			{
-				existingItemRefs = [[NSSet alloc] initWithArray:_itemRefs];
-				newlyRemovedItemRefs = [existingItemRefs mutableCopy];
-			}
-
-			if ((_itemRefs.count == newItemRefs.count) && (_itemRefs != nil) && (newItemRefs != nil))
-			{
-				if (![_itemRefs isEqualToArray:newItemRefs])
-				{
-					itemRefsChanged = YES;
-				}
-			}
-
 			if (updatedItemRefs != nil)
 			{
 				newlyUpdatedItemRefs = [updatedItemRefs mutableCopy];
@@ -144,23 +130,37 @@
 
 			if (newItemRefs != nil)
 			{
-				newlyAddedItemRefs = [[NSMutableSet alloc] initWithArray:newItemRefs];
+				// Determine added and removed items by diffing old and new references. Only the part between the common prefix and
+				// suffix needs to be indexed, so that small changes to large arrays no longer require building sets over all items.
+				OCDataSourceDiff *diff = [OCDataSourceDiff diffFromItems:_itemRefs toItems:newItemRefs detectMoves:NO];
 
-				// Find items that are supposed to be updated, but not contained in newItemRefs
-				if (updatedItemRefs != nil)
+				itemRefsChanged = diff.hasChanges;
+
+				// Removed Items = (Old Items - New Items)
+				newlyRemovedItemRefs = [[NSMutableSet alloc] initWithArray:diff.removedItems];
+
+				// Added Items = (New Items - Old Items)
+				newlyAddedItemRefs = [[NSMutableSet alloc] initWithArray:diff.insertedItems];
+
+				// References that were both removed and inserted have only changed their position
+				if ((newlyRemovedItemRefs.count > 0) && (newlyAddedItemRefs.count > 0))
 				{
-					danglingUpdatedItemRefs = [newlyUpdatedItemRefs mutableCopy];
-					[danglingUpdatedItemRefs minusSet:newlyAddedItemRefs];
+					NSMutableSet<OCDataItemReference> *movedItemRefs = [newlyRemovedItemRefs mutableCopy];
+					[movedItemRefs intersectSet:newlyAddedItemRefs];
+
+					[newlyRemovedItemRefs minusSet:movedItemRefs];
+					[newlyAddedItemRefs minusSet:movedItemRefs];
 				}
 
-				// Find added and removed items
-				if (existingItemRefs != nil)
-				{
-					// Removed Items = (Old Items - New Items)
-					[newlyRemovedItemRefs minusSet:newlyAddedItemRefs];
+				// Keep set of current references up-to-date
+				[_itemRefSet minusSet:newlyRemovedItemRefs];
+				[_itemRefSet unionSet:newlyAddedItemRefs];
 
-					// Added Items = (New Items - Old Items)
-					[newlyAddedItemRefs minusSet:existingItemRefs];
+				// Find items that are supposed to be updated, but not contained in newItemRefs
+				if (updatedItemRefs != nil)
+				{
+					danglingUpdatedItemRefs = [newlyUpdatedItemRefs mutableCopy];
+					[danglingUpdatedItemRefs minusSet:_itemRefSet];
 				}
 
 				// Find items that were added and then removed
@@ -33,6 +33,9 @@ typedef void(^OCDataSourceSubscriptionUpdateHandler)(OCDataSourceSubscription *s
 	NSMutableSet<OCDataItemReference> *_updatedItemRefs;
 	NSMutableSet<OCDataItemReference> *_removedItemRefs;
 
+	NSMutableSet<OCDataItemReference> *_itemRefSet; //!< Set of the references in _itemRefs, maintained incrementally if differences are tracked
+	NSArray<OCDataItemReference> *_snapshotItemRefs; //!< References at the time of the last snapshot that reset change tracking
+
 	BOOL _needsUpdateHandling;
 
 	BOOL _isInterDataSourceSubscription;
@@ -40,6 +40,12 @@
 		_updatedItemRefs = [NSMutableSet new];
 		_removedItemRefs = [NSMutableSet new];
 
+		if (trackDifferences)
+		{
+			_itemRefSet = [[NSMutableSet alloc] initWithArray:_itemRefs];
+			_snapshotItemRefs = [_itemRefs copy];
+		}
+
 		_updateQueue = updateQueue;
 	}
 
@@ -58,6 +64,9 @@
 		[_updatedItemRefs removeAllObjects];
 		[_removedItemRefs removeAllObjects];
 
+		[_itemRefSet removeAllObjects];
+		_snapshotItemRefs = nil;
+
 		self.updateHandler = nil;
 	}
 }
@@ -81,11 +90,23 @@
 
 	@synchronized (_itemRefs)
 	{
-		snapshot.items = [_itemRefs copy];
-		snapshot.numberOfItems = _itemRefs.count;
+		NSArray<OCDataItemReference> *items = [_itemRefs copy];
+
+		snapshot.items = items;
+		snapshot.numberOfItems = items.count;
+
+		if (_trackDifferences)
+		{
+			snapshot.previousItems = (_snapshotItemRefs != nil) ? _snapshotItemRefs : @[];
+		}
 
 		if (resetChangeTracking)
 		{
+			if (_trackDifferences)
+			{
+				_snapshotItemRefs = items;
+			}
+
 			snapshot.addedItems = _addedItemRefs;
 			snapshot.updatedItems = _updatedItemRefs;
 			snapshot.removedItems = _removedItemRefs;
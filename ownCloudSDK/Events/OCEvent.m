@@ -48,6 +48,7 @@
 #import "OCUser.h"
 #import "OCWaitCondition.h"
 #import "OCTUSJob.h"
+#import "OCRangedDownloadJob.h"
 #import "OCTUSHeader.h"
 #import "OCMessageChoice.h"
 #import "OCDAVRawResponse.h"
@@ -120,6 +121,7 @@
 				OCTUSHeader.class,
 				OCTUSJob.class,
 				OCTUSJobSegment.class,
+				OCRangedDownloadJob.class,
 				OCMessage.class,
 				OCMessageChoice.class,
 				OCCoreUpdateScheduleRecord.class,
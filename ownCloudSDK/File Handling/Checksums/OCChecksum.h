@@ -26,6 +26,7 @@ typedef NSString* OCChecksumString;
 
 typedef void(^OCChecksumComputationCompletionHandler)(NSError *error, OCChecksum *computedChecksum);
 typedef void(^OCChecksumVerificationCompletionHandler)(NSError *error, BOOL isValid, OCChecksum *actualChecksum);
+typedef void(^OCChecksumMultiComputationCompletionHandler)(NSError *error, NSDictionary<OCChecksumAlgorithmIdentifier, OCChecksum *> *computedChecksums);
 
 @interface OCChecksum : NSObject <NSSecureCoding>
 {
@@ -46,6 +47,7 @@ typedef void(^OCChecksumVerificationCompletionHandler)(NSError *error, BOOL isVa
 
 #pragma mark - Computations
 + (void)computeForFile:(NSURL *)fileURL checksumAlgorithm:(OCChecksumAlgorithmIdentifier)algorithmIdentifier completionHandler:(OCChecksumComputationCompletionHandler)completionHandler;
++ (void)computeForFile:(NSURL *)fileURL checksumAlgorithms:(NSArray<OCChecksumAlgorithmIdentifier> *)algorithmIdentifiers completionHandler:(OCChecksumMultiComputationCompletionHandler)completionHandler; //!< Computes the checksums for several algorithms in a single pass over the file
 - (void)verifyForFile:(NSURL *)fileURL completionHandler:(OCChecksumVerificationCompletionHandler)completionHandler;
 
 @end
@@ -18,6 +18,7 @@
 
 #import "OCChecksum.h"
 #import "OCChecksumAlgorithm.h"
+#import "OCChecksumEngine.h"
 #import "NSError+OCError.h"
 
 @implementation OCChecksum
@@ -92,6 +93,28 @@
 	}
 }
 
++ (void)computeForFile:(NSURL *)fileURL checksumAlgorithms:(NSArray<OCChecksumAlgorithmIdentifier> *)algorithmIdentifiers completionHandler:(OCChecksumMultiComputationCompletionHandler)completionHandler
+{
+	NSMutableArray<OCChecksumAlgorithm *> *algorithms = [NSMutableArray new];
+
+	if (completionHandler==nil) { return; }
+
+	for (OCChecksumAlgorithmIdentifier algorithmIdentifier in algorithmIdentifiers)
+	{
+		OCChecksumAlgorithm *algorithm;
+
+		if ((algorithm = [OCChecksumAlgorithm algorithmForIdentifier:algorithmIdentifier]) == nil)
+		{
+			completionHandler(OCError(OCErrorFeatureNotImplemented), nil);
+			return;
+		}
+
+		[algorithms addObject:algorithm];
+	}
+
+	[OCChecksumEngine.sharedEngine computeChecksumsWithAlgorithms:algorithms forFileAtURL:fileURL completionHandler:completionHandler];
+}
+
 - (void)verifyForFile:(NSURL *)fileURL completionHandler:(OCChecksumVerificationCompletionHandler)completionHandler
 {
 	OCChecksumAlgorithm *algorithm;
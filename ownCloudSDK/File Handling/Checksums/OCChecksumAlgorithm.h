@@ -21,6 +21,17 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/*
+	Incremental computation of a checksum. Algorithms providing digests via -createDigest can be fed by
+	OCChecksumEngine together with other algorithms, from a single read of a file.
+*/
+@interface OCChecksumDigest : NSObject
+
+- (void)updateWithBytes:(const void *)bytes length:(size_t)length; //!< Adds the bytes to the digest
+- (nullable OCChecksum *)finalizeChecksum; //!< Finalizes the digest and returns the resulting checksum. The digest can't be updated after this.
+
+@end
+
 @interface OCChecksumAlgorithm : NSObject
 
 #pragma mark - Registration and lookup
@@ -38,7 +49,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable OCChecksum *)computeChecksumForData:(NSData *)data error:(NSError * _Nullable * _Nullable)error; //!< Utility method invoking -computeChecksumForInputStream:error:
 
 #pragma mark - Algorithm implementation
-- (nullable OCChecksum *)computeChecksumForInputStream:(NSInputStream *)inputStream error:(NSError * _Nullable * _Nullable )error;
+- (nullable OCChecksumDigest *)createDigest; //!< Returns a new digest for incremental computation. Returns nil by default. Subclasses should implement this or -computeChecksumForInputStream:error:.
+- (nullable OCChecksum *)computeChecksumForInputStream:(NSInputStream *)inputStream error:(NSError * _Nullable * _Nullable )error; //!< Default implementation feeds the stream into a digest created by -createDigest
 
 @end
 
@@ -19,6 +19,20 @@
 #import "OCChecksumAlgorithm.h"
 #import "NSError+OCError.h"
 #import "OCLogger.h"
+#import "OCChecksumEngine.h"
+
+@implementation OCChecksumDigest
+
+- (void)updateWithBytes:(const void *)bytes length:(size_t)length
+{
+}
+
+- (OCChecksum *)finalizeChecksum
+{
+	return (nil);
+}
+
+@end
 
 @implementation OCChecksumAlgorithm
 
@@ -90,38 +104,9 @@
 		return;
 	}
 
-	dispatch_async(OCChecksumAlgorithm.computationQueue, ^{
-		NSInputStream *inputStream;
-		NSError *error = nil;
-		OCChecksum *checksum = nil;
-
-		if ((inputStream = [NSInputStream inputStreamWithURL:fileURL]) != nil)
-		{
-			do {
-				if (inputStream.streamError != nil) { break; }
-
-				[inputStream open];
-
-				if (inputStream.streamError != nil) { break; }
-
-				checksum = [self computeChecksumForInputStream:inputStream error:&error];
-			} while(NO);
-
-			if (inputStream.streamStatus != NSStreamStatusClosed)
-			{
-				[inputStream close];
-			}
-
-			if ((error==nil) && (inputStream.streamError != nil))
-			{
-				error = inputStream.streamError;
-
-				OCLogError(@"Checksum computation on %@ failed due to error=%@", fileURL, error);
-			}
-		}
-
-		completionHandler(error, checksum);
-	});
+	[OCChecksumEngine.sharedEngine computeChecksumsWithAlgorithms:@[ self ] forFileAtURL:fileURL completionHandler:^(NSError * _Nullable error, NSDictionary<OCChecksumAlgorithmIdentifier,OCChecksum *> * _Nullable checksums) {
+		completionHandler(error, checksums[self.class.identifier]);
+	}];
 }
 
 - (void)verifyChecksum:(OCChecksum *)checksum forFileAtURL:(NSURL *)fileURL completionHandler:(OCChecksumVerificationCompletionHandler)completionHandler
@@ -161,14 +146,56 @@
 }
 
 #pragma mark - Algorithm implementation
+- (OCChecksumDigest *)createDigest
+{
+	return (nil);
+}
+
 - (OCChecksum *)computeChecksumForInputStream:(NSInputStream *)inputStream error:(NSError **)error
 {
-	if (error != NULL)
+	OCChecksumDigest *digest;
+	OCChecksum *checksum = nil;
+
+	if ((digest = [self createDigest]) == nil)
 	{
-		*error = OCError(OCErrorFeatureNotImplemented);
+		if (error != NULL)
+		{
+			*error = OCError(OCErrorFeatureNotImplemented);
+		}
+
+		return (nil);
 	}
 
-	return (nil);
+	NSInteger readLength = 0;
+	size_t maxLength = 128 * 1024; // 128 KB
+	void *readBuffer = NULL;
+
+	if ((readBuffer = malloc(maxLength)) != NULL)
+	{
+		do
+		{
+			if ((readLength = [inputStream read:(uint8_t *)readBuffer maxLength:maxLength]) > 0)
+			{
+				[digest updateWithBytes:readBuffer length:(size_t)readLength];
+			}
+		} while(readLength > 0);
+
+		if (readLength == -1)
+		{
+			if (error != NULL)
+			{
+				*error = inputStream.streamError;
+			}
+		}
+		else
+		{
+			checksum = [digest finalizeChecksum];
+		}
+
+		free(readBuffer);
+	}
+
+	return (checksum);
 }
 
 @end
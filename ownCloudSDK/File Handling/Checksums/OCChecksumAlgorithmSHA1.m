@@ -21,6 +21,49 @@
 #import "OCChecksumAlgorithmSHA1.h"
 #import "NSData+OCHash.h"
 
+@interface OCChecksumDigestSHA1 : OCChecksumDigest
+{
+	CC_SHA1_CTX _digestContext;
+}
+@end
+
+@implementation OCChecksumDigestSHA1
+
+- (instancetype)init
+{
+	if ((self = [super init]) != nil)
+	{
+		CC_SHA1_Init(&_digestContext);
+	}
+
+	return (self);
+}
+
+- (void)updateWithBytes:(const void *)bytes length:(size_t)length
+{
+	// CC_SHA1_Update takes a 32 bit length
+	while (length > 0)
+	{
+		CC_LONG updateLength = (CC_LONG)MIN(length, (size_t)UINT32_MAX);
+
+		CC_SHA1_Update(&_digestContext, bytes, updateLength);
+
+		bytes = ((const uint8_t *)bytes) + updateLength;
+		length -= updateLength;
+	}
+}
+
+- (OCChecksum *)finalizeChecksum
+{
+	UInt8 digest[CC_SHA1_DIGEST_LENGTH];
+
+	CC_SHA1_Final((unsigned char *)&digest, &_digestContext);
+
+	return ([[OCChecksum alloc] initWithAlgorithmIdentifier:OCChecksumAlgorithmIdentifierSHA1 checksum:[[NSData dataWithBytes:digest length:sizeof(digest)] asHexStringWithSeparator:nil lowercase:YES]]);
+}
+
+@end
+
 @implementation OCChecksumAlgorithmSHA1
 
 OCChecksumAlgorithmAutoRegister
@@ -30,46 +73,9 @@ OCChecksumAlgorithmAutoRegister
 	return (OCChecksumAlgorithmIdentifierSHA1);
 }
 
-- (OCChecksum *)computeChecksumForInputStream:(NSInputStream *)inputStream error:(NSError *__autoreleasing *)error
+- (OCChecksumDigest *)createDigest
 {
-	OCChecksum *checksum = nil;
-	NSInteger readLength = 0;
-	size_t maxLength = 128 * 1024; // 128 KB
-	void *readBuffer = NULL;
-
-	if ((maxLength > 0) && ((readBuffer = calloc(1, maxLength)) != NULL))
-	{
-		UInt8 digest[CC_SHA1_DIGEST_LENGTH];
-		CC_SHA1_CTX digestContext;
-
-		CC_SHA1_Init(&digestContext);
-
-		do
-		{
-			if ((readLength = [inputStream read:(uint8_t *)readBuffer maxLength:maxLength]) > 0)
-			{
-				CC_SHA1_Update(&digestContext, readBuffer, (CC_LONG)readLength);
-			}
-		} while(readLength > 0);
-
-		CC_SHA1_Final((unsigned char *)&digest, &digestContext);
-
-		if (readLength == -1)
-		{
-			if (error != NULL)
-			{
-				*error = inputStream.streamError;
-			}
-		}
-		else
-		{
-			checksum = [[OCChecksum alloc] initWithAlgorithmIdentifier:OCChecksumAlgorithmIdentifierSHA1 checksum:[[NSData dataWithBytes:digest length:sizeof(digest)] asHexStringWithSeparator:nil lowercase:YES]];
-		}
-
-		free(readBuffer);
-	}
-
-	return (checksum);
+	return ([OCChecksumDigestSHA1 new]);
 }
 
 @end
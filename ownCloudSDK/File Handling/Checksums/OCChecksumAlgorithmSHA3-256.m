@@ -24,6 +24,39 @@
 #import "OCExtensionManager.h"
 #import "OCExtension+License.h"
 
+@interface OCChecksumDigestSHA3_256 : OCChecksumDigest
+{
+    sha3_context _ctx;
+}
+@end
+
+@implementation OCChecksumDigestSHA3_256
+
+- (instancetype)init
+{
+    if ((self = [super init]) != nil) {
+        sha3_Init(&_ctx, 256);
+        sha3_SetFlags(&_ctx, 0);
+    }
+
+    return self;
+}
+
+- (void)updateWithBytes:(const void *)bytes length:(size_t)length
+{
+    sha3_Update(&_ctx, bytes, length);
+}
+
+- (OCChecksum *)finalizeChecksum
+{
+    const void *digest = sha3_Finalize(&_ctx);
+    NSData *digestData = [NSData dataWithBytes:digest length:32];
+
+    return [[OCChecksum alloc] initWithAlgorithmIdentifier:OCChecksumAlgorithmIdentifierSHA3_256 checksum:[digestData asHexStringWithSeparator:nil lowercase:YES]];
+}
+
+@end
+
 @implementation OCChecksumAlgorithmSHA3
 
 + (void)load
@@ -41,41 +74,9 @@
     return (OCChecksumAlgorithmIdentifierSHA3_256);
 }
 
-- (OCChecksum *)computeChecksumForInputStream:(NSInputStream *)inputStream error:(NSError *__autoreleasing *)error
+- (OCChecksumDigest *)createDigest
 {
-    OCChecksum *checksum = nil;
-    NSInteger readLength = 0;
-    size_t maxLength = 128 * 1024; // 128 KB
-    void *readBuffer = NULL;
-    sha3_context ctx;
-    unsigned char hash[32];
-
-    if ((maxLength > 0) && ((readBuffer = calloc(1, maxLength)) != NULL)) {
-        sha3_Init(&ctx, 256);
-        sha3_SetFlags(&ctx, 0);
-
-        do {
-            readLength = [inputStream read:(uint8_t *)readBuffer maxLength:maxLength];
-            if (readLength > 0) {
-                sha3_Update(&ctx, readBuffer, (size_t)readLength);
-            }
-        } while (readLength > 0);
-
-        if (readLength == -1) {
-            if (error != NULL) {
-                *error = inputStream.streamError;
-            }
-        } else {
-            const void *digest = sha3_Finalize(&ctx);
-            memcpy(hash, digest, 32);
-            NSData *digestData = [NSData dataWithBytes:hash length:32];
-            checksum = [[OCChecksum alloc] initWithAlgorithmIdentifier:OCChecksumAlgorithmIdentifierSHA3_256 checksum:[digestData asHexStringWithSeparator:nil lowercase:YES]];
-        }
-
-        free(readBuffer);
-    }
-    
-    return checksum;
+    return ([OCChecksumDigestSHA3_256 new]);
 }
 
 @end
@@ -0,0 +1,52 @@
+//
+//  OCChecksumEngine.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCChecksum.h"
+
+@class OCChecksumAlgorithm;
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void(^OCChecksumEngineCompletionHandler)(NSError * _Nullable error, NSDictionary<OCChecksumAlgorithmIdentifier, OCChecksum *> * _Nullable checksums);
+
+/*
+	Computes checksums of files:
+	- files are read only once, in large, page-aligned chunks, regardless of the number of algorithms
+	- the digests of all algorithms are fed in parallel, while the next chunk is read from the file
+	- up to .maximumConcurrentComputations files are processed concurrently, further requests are queued
+
+	Algorithms that don't provide a digest via -[OCChecksumAlgorithm createDigest] are computed separately, using
+	-[OCChecksumAlgorithm computeChecksumForInputStream:error:].
+*/
+
+@interface OCChecksumEngine : NSObject
+
+@property(class,readonly,strong,nonatomic) OCChecksumEngine *sharedEngine;
+
+@property(readonly) NSUInteger maximumConcurrentComputations; //!< Maximum number of files processed concurrently
+
+- (instancetype)initWithMaximumConcurrentComputations:(NSUInteger)maximumConcurrentComputations; //!< Use 0 to process as many files concurrently as there are active processors
+
+- (void)computeChecksumsWithAlgorithms:(NSArray<OCChecksumAlgorithm *> *)algorithms forFileAtURL:(NSURL *)fileURL completionHandler:(OCChecksumEngineCompletionHandler)completionHandler; //!< Computes the checksums of the file at fileURL for all algorithms in a single pass. The completionHandler is called on a computation thread.
+
+- (nullable NSDictionary<OCChecksumAlgorithmIdentifier, OCChecksum *> *)computeChecksumsWithAlgorithms:(NSArray<OCChecksumAlgorithm *> *)algorithms forFileAtURL:(NSURL *)fileURL error:(NSError * _Nullable * _Nullable)outError; //!< Synchronously computes the checksums of the file at fileURL for all algorithms in a single pass, on the calling thread and without queuing.
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,324 @@
+//
+//  OCChecksumEngine.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <fcntl.h>
+#import <unistd.h>
+
+#import "OCChecksumEngine.h"
+#import "OCChecksumAlgorithm.h"
+#import "NSError+OCError.h"
+#import "OCPlatform.h"
+#import "OCLogger.h"
+
+@interface OCChecksumEngine ()
+{
+	dispatch_queue_t _queue; //!< Serial queue managing the pending and running computations
+	dispatch_queue_t _digestQueue; //!< Concurrent queue feeding chunks to digests. Separate from the queue computations run on, which wait for the digests.
+
+	NSMutableArray<dispatch_block_t> *_pendingComputations;
+	NSUInteger _runningComputations;
+}
+@end
+
+@implementation OCChecksumEngine
+
++ (OCChecksumEngine *)sharedEngine
+{
+	static dispatch_once_t onceToken;
+	static OCChecksumEngine *sharedEngine;
+
+	dispatch_once(&onceToken, ^{
+		sharedEngine = [[OCChecksumEngine alloc] initWithMaximumConcurrentComputations:((OCPlatform.current.memoryConfiguration == OCPlatformMemoryConfigurationMinimum) ? 1 : 0)];
+	});
+
+	return (sharedEngine);
+}
+
+- (instancetype)init
+{
+	return ([self initWithMaximumConcurrentComputations:0]);
+}
+
+- (instancetype)initWithMaximumConcurrentComputations:(NSUInteger)maximumConcurrentComputations
+{
+	if ((self = [super init]) != nil)
+	{
+		if (maximumConcurrentComputations == 0)
+		{
+			maximumConcurrentComputations = MAX(NSProcessInfo.processInfo.activeProcessorCount, 1);
+		}
+
+		_maximumConcurrentComputations = maximumConcurrentComputations;
+
+		_queue = dispatch_queue_create("OCChecksumEngine", DISPATCH_QUEUE_SERIAL);
+		_digestQueue = dispatch_queue_create("OCChecksumEngine.digest", DISPATCH_QUEUE_CONCURRENT);
+		_pendingComputations = [NSMutableArray new];
+	}
+
+	return (self);
+}
+
+#pragma mark - Worker pool
+- (void)_enqueueComputation:(dispatch_block_t)computation
+{
+	dispatch_async(_queue, ^{
+		[self->_pendingComputations addObject:computation];
+		[self _startPendingComputations];
+	});
+}
+
+- (void)_startPendingComputations
+{
+	// Must be called on _queue
+	while ((_runningComputations < _maximumConcurrentComputations) && (_pendingComputations.count > 0))
+	{
+		dispatch_block_t computation = _pendingComputations.firstObject;
+
+		[_pendingComputations removeObjectAtIndex:0];
+		_runningComputations++;
+
+		dispatch_async(OCChecksumAlgorithm.computationQueue, ^{
+			computation();
+
+			dispatch_async(self->_queue, ^{
+				self->_runningComputations--;
+				[self _startPendingComputations];
+			});
+		});
+	}
+}
+
+#pragma mark - Computation
+- (void)computeChecksumsWithAlgorithms:(NSArray<OCChecksumAlgorithm *> *)algorithms forFileAtURL:(NSURL *)fileURL completionHandler:(OCChecksumEngineCompletionHandler)completionHandler
+{
+	if (completionHandler == nil) { return; }
+
+	if ((fileURL == nil) || (algorithms.count == 0))
+	{
+		completionHandler(OCError(OCErrorInsufficientParameters), nil);
+		return;
+	}
+
+	[self _enqueueComputation:^{
+		NSError *error = nil;
+		NSDictionary<OCChecksumAlgorithmIdentifier, OCChecksum *> *checksums;
+
+		checksums = [self computeChecksumsWithAlgorithms:algorithms forFileAtURL:fileURL error:&error];
+
+		completionHandler(error, checksums);
+	}];
+}
+
+- (NSDictionary<OCChecksumAlgorithmIdentifier, OCChecksum *> *)computeChecksumsWithAlgorithms:(NSArray<OCChecksumAlgorithm *> *)algorithms forFileAtURL:(NSURL *)fileURL error:(NSError **)outError
+{
+	NSMutableDictionary<OCChecksumAlgorithmIdentifier, OCChecksum *> *checksums = [NSMutableDictionary new];
+	NSMutableArray<OCChecksumDigest *> *digests = [NSMutableArray new];
+	NSMutableArray<OCChecksumAlgorithm *> *streamAlgorithms = [NSMutableArray new];
+	NSError *error = nil;
+
+	// Split algorithms into those providing digests - and those that need to be fed from a stream
+	for (OCChecksumAlgorithm *algorithm in algorithms)
+	{
+		OCChecksumDigest *digest;
+
+		if ((digest = [algorithm createDigest]) != nil)
+		{
+			[digests addObject:digest];
+		}
+		else
+		{
+			[streamAlgorithms addObject:algorithm];
+		}
+	}
+
+	// Feed digests from a single read of the file
+	if (digests.count > 0)
+	{
+		NSArray<OCChecksum *> *digestChecksums;
+
+		if ((digestChecksums = [self _computeDigests:digests forFileAtURL:fileURL error:&error]) != nil)
+		{
+			for (OCChecksum *checksum in digestChecksums)
+			{
+				checksums[checksum.algorithmIdentifier] = checksum;
+			}
+		}
+	}
+
+	// Compute remaining algorithms via streams
+	for (OCChecksumAlgorithm *algorithm in streamAlgorithms)
+	{
+		NSInputStream *inputStream;
+		OCChecksum *checksum = nil;
+
+		if (error != nil) { break; }
+
+		if ((inputStream = [NSInputStream inputStreamWithURL:fileURL]) != nil)
+		{
+			[inputStream open];
+
+			if (inputStream.streamError == nil)
+			{
+				checksum = [algorithm computeChecksumForInputStream:inputStream error:&error];
+			}
+
+			if ((error == nil) && (inputStream.streamError != nil))
+			{
+				error = inputStream.streamError;
+			}
+
+			[inputStream close];
+		}
+
+		if (checksum != nil)
+		{
+			checksums[checksum.algorithmIdentifier] = checksum;
+		}
+	}
+
+	if (error != nil)
+	{
+		OCLogError(@"Checksum computation on %@ failed due to error=%@", fileURL, error);
+
+		if (outError != NULL)
+		{
+			*outError = error;
+		}
+
+		return (nil);
+	}
+
+	return (checksums);
+}
+
+- (nullable NSArray<OCChecksum *> *)_computeDigests:(NSArray<OCChecksumDigest *> *)digests forFileAtURL:(NSURL *)fileURL error:(NSError **)outError
+{
+	size_t pageSize = (size_t)getpagesize();
+	size_t chunkSize = (OCPlatform.current.memoryConfiguration == OCPlatformMemoryConfigurationMinimum) ? (256 * 1024) : (1024 * 1024);
+	uint8_t *buffers[2] = { NULL, NULL };
+	NSMutableArray<OCChecksum *> *checksums = nil;
+	dispatch_group_t digestGroup = dispatch_group_create();
+	dispatch_queue_t digestQueue = _digestQueue;
+	ssize_t readLength = 0;
+	int readErrno = 0;
+	NSUInteger bufferIndex = 0;
+	int fd;
+
+	if ((fd = open(fileURL.fileSystemRepresentation, O_RDONLY)) < 0)
+	{
+		if (outError != NULL)
+		{
+			*outError = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSURLErrorKey : fileURL }];
+		}
+
+		return (nil);
+	}
+
+	#ifdef F_RDAHEAD
+	// The file is read sequentially
+	fcntl(fd, F_RDAHEAD, 1);
+	#endif /* F_RDAHEAD */
+
+	// Two page-aligned buffers: while the digests consume one, the next chunk is read into the other
+	if ((posix_memalign((void **)&buffers[0], pageSize, chunkSize) == 0) &&
+	    (posix_memalign((void **)&buffers[1], pageSize, chunkSize) == 0))
+	{
+		do
+		{
+			uint8_t *buffer = buffers[bufferIndex];
+
+			// Read next chunk (filling the buffer, unless the end of file is reached)
+			size_t bufferLength = 0;
+
+			while (bufferLength < chunkSize)
+			{
+				if ((readLength = read(fd, &buffer[bufferLength], chunkSize - bufferLength)) < 0)
+				{
+					if (errno == EINTR) { continue; }
+					readErrno = errno;
+					break;
+				}
+
+				if (readLength == 0)
+				{
+					break;
+				}
+
+				bufferLength += (size_t)readLength;
+			}
+
+			// Wait for digests to finish with the previous chunk
+			dispatch_group_wait(digestGroup, DISPATCH_TIME_FOREVER);
+
+			if ((readLength < 0) || (bufferLength == 0))
+			{
+				break;
+			}
+
+			// Feed chunk to all digests in parallel
+			for (OCChecksumDigest *digest in digests)
+			{
+				dispatch_group_async(digestGroup, digestQueue, ^{
+					[digest updateWithBytes:buffer length:bufferLength];
+				});
+			}
+
+			bufferIndex = 1 - bufferIndex;
+		} while (readLength > 0);
+
+		dispatch_group_wait(digestGroup, DISPATCH_TIME_FOREVER);
+
+		if (readLength < 0)
+		{
+			if (outError != NULL)
+			{
+				*outError = [NSError errorWithDomain:NSPOSIXErrorDomain code:readErrno userInfo:@{ NSURLErrorKey : fileURL }];
+			}
+		}
+		else
+		{
+			checksums = [NSMutableArray new];
+
+			for (OCChecksumDigest *digest in digests)
+			{
+				OCChecksum *checksum;
+
+				if ((checksum = [digest finalizeChecksum]) != nil)
+				{
+					[checksums addObject:checksum];
+				}
+			}
+		}
+	}
+	else
+	{
+		if (outError != NULL)
+		{
+			*outError = OCError(OCErrorInternal);
+		}
+	}
+
+	if (buffers[0] != NULL) { free(buffers[0]); }
+	if (buffers[1] != NULL) { free(buffers[1]); }
+
+	close(fd);
+
+	return (checksums);
+}
+
+@end
@@ -0,0 +1,67 @@
+//
+//  OCHTTPConcurrencyController.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCHTTPTypes.h"
+#import "OCHTTPStatus.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void(^OCHTTPConcurrencyLimitChangeHandler)(OCHTTPPipelinePartitionID partitionID, NSString *hostname, double limit);
+
+/*
+	Adaptive concurrency limits, tracked per partition (bookmark) and hostname:
+
+	- additive increase: every successful response received while the limit is in use adds 1/limit to it, so that the
+	  limit grows by about one per round of requests
+	- multiplicative decrease: 429 (Too Many Requests) and 503 (Service Unavailable) responses halve the limit. Decreases
+	  happen at most once per cool-down period, so that a burst of rejections of requests started under the previous
+	  limit only counts once.
+	- latency: if the smoothed server latency (time to first byte) exceeds twice the lowest latency observed recently,
+	  requests are queueing up at the server and the limit is decreased by one
+	- throughput: the limit grows at most a few requests beyond the limit at which the highest throughput has been
+	  observed. Higher limits that don't yield more throughput only add queueing.
+
+	Whenever the integer value of a limit changes, the limitChangeHandler is called, so that limits can be persisted and
+	later restored via -restoreLimit:forPartitionID:hostname:.
+
+	The controller is thread-safe.
+*/
+
+@interface OCHTTPConcurrencyController : NSObject
+
+@property(readonly) NSUInteger initialLimit; //!< Limit used for hosts without samples or restored limit
+@property(readonly) NSUInteger minimumLimit; //!< Lowest limit the controller decreases to
+@property(readonly) NSUInteger maximumLimit; //!< Highest limit the controller increases to
+
+@property(nullable,copy) OCHTTPConcurrencyLimitChangeHandler limitChangeHandler; //!< Called (outside of any locks) when the integer value of a limit changed
+
+- (instancetype)initWithInitialLimit:(NSUInteger)initialLimit minimumLimit:(NSUInteger)minimumLimit maximumLimit:(NSUInteger)maximumLimit;
+
+#pragma mark - Limits
+- (NSUInteger)limitForPartitionID:(OCHTTPPipelinePartitionID)partitionID hostname:(NSString *)hostname; //!< Returns the number of requests that may be running concurrently for the partition and host
+
+- (void)restoreLimit:(double)limit forPartitionID:(OCHTTPPipelinePartitionID)partitionID hostname:(NSString *)hostname; //!< Restores a previously persisted limit
+- (void)removeLimitsForPartitionID:(OCHTTPPipelinePartitionID)partitionID; //!< Drops all limits of a partition
+
+#pragma mark - Feedback
+- (void)recordResponseWithStatusCode:(OCHTTPStatusCode)statusCode latency:(nullable NSNumber *)latency receiveBytesPerSecond:(nullable NSNumber *)receiveBytesPerSecond runningRequests:(NSUInteger)runningRequests forPartitionID:(OCHTTPPipelinePartitionID)partitionID hostname:(NSString *)hostname; //!< Adjusts the limit for the partition and host based on a finished request. runningRequests is the number of requests running for the partition and host at the time the request finished (including the request itself). Pass 0 as statusCode for requests that failed without response.
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,249 @@
+//
+//  OCHTTPConcurrencyController.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCHTTPConcurrencyController.h"
+#import "OCLogger.h"
+
+static const double OCHTTPConcurrencyDecreaseFactor = 0.5; //!< Factor applied to the limit on 429/503 responses
+static const double OCHTTPConcurrencyLatencyTolerance = 2.0; //!< Smoothed latency above this multiple of the baseline latency is considered queueing
+static const NSTimeInterval OCHTTPConcurrencyMinimumQueueingDelay = 0.1; //!< Latency increases below this number of seconds are not considered queueing (avoids reacting to jitter on fast links)
+static const double OCHTTPConcurrencyLatencySmoothing = 0.2; //!< Weight of a new sample in the smoothed latency
+static const double OCHTTPConcurrencyBaselineDrift = 0.01; //!< Share by which the baseline latency drifts towards the smoothed latency with every sample, so that it can adapt to slower links
+static const double OCHTTPConcurrencyThroughputDecay = 0.99; //!< Decay of the highest throughput with every sample, so that it can adapt to slower links
+static const double OCHTTPConcurrencyThroughputHeadroom = 2.0; //!< Number of requests the limit may grow beyond the limit at which the highest throughput was observed
+static const NSTimeInterval OCHTTPConcurrencyMinimumCoolDown = 1.0; //!< Minimum time between two decreases
+
+@interface OCHTTPConcurrencyLimit : NSObject
+
+@property(assign) double limit;
+
+@property(assign) double smoothedLatency; //!< Exponentially smoothed latency (0 if no samples)
+@property(assign) double baselineLatency; //!< Lowest recent latency (0 if no samples)
+
+@property(assign) double highestThroughput; //!< Highest (decaying) aggregate throughput observed
+@property(assign) double limitAtHighestThroughput; //!< Limit at which .highestThroughput was observed
+
+@property(assign) NSUInteger successesInRound; //!< Successful responses received while the limit was in use since the last change of the limit
+
+@property(assign) NSTimeInterval lastDecreaseTime;
+
+@end
+
+@implementation OCHTTPConcurrencyLimit
+@end
+
+@implementation OCHTTPConcurrencyController
+{
+	NSMutableDictionary<OCHTTPPipelinePartitionID, NSMutableDictionary<NSString *, OCHTTPConcurrencyLimit *> *> *_limitsByPartitionID;
+}
+
+- (instancetype)initWithInitialLimit:(NSUInteger)initialLimit minimumLimit:(NSUInteger)minimumLimit maximumLimit:(NSUInteger)maximumLimit
+{
+	if ((self = [super init]) != nil)
+	{
+		_minimumLimit = MAX(minimumLimit, 1);
+		_maximumLimit = MAX(maximumLimit, _minimumLimit);
+		_initialLimit = MIN(MAX(initialLimit, _minimumLimit), _maximumLimit);
+
+		_limitsByPartitionID = [NSMutableDictionary new];
+	}
+
+	return (self);
+}
+
+#pragma mark - Limits
+- (OCHTTPConcurrencyLimit *)_limitForPartitionID:(OCHTTPPipelinePartitionID)partitionID hostname:(NSString *)hostname create:(BOOL)create
+{
+	NSMutableDictionary<NSString *, OCHTTPConcurrencyLimit *> *limitsByHostname;
+	OCHTTPConcurrencyLimit *limit = nil;
+
+	hostname = hostname.lowercaseString;
+
+	if ((limitsByHostname = _limitsByPartitionID[partitionID]) == nil)
+	{
+		if (!create) { return (nil); }
+
+		limitsByHostname = [NSMutableDictionary new];
+		_limitsByPartitionID[partitionID] = limitsByHostname;
+	}
+
+	if (((limit = limitsByHostname[hostname]) == nil) && create)
+	{
+		limit = [OCHTTPConcurrencyLimit new];
+		limit.limit = _initialLimit;
+		limit.limitAtHighestThroughput = _initialLimit;
+
+		limitsByHostname[hostname] = limit;
+	}
+
+	return (limit);
+}
+
+- (NSUInteger)limitForPartitionID:(OCHTTPPipelinePartitionID)partitionID hostname:(NSString *)hostname
+{
+	OCHTTPConcurrencyLimit *limit;
+
+	if ((partitionID == nil) || (hostname == nil))
+	{
+		return (_initialLimit);
+	}
+
+	@synchronized(self)
+	{
+		if ((limit = [self _limitForPartitionID:partitionID hostname:hostname create:NO]) != nil)
+		{
+			return ((NSUInteger)limit.limit);
+		}
+	}
+
+	return (_initialLimit);
+}
+
+- (void)restoreLimit:(double)limitValue forPartitionID:(OCHTTPPipelinePartitionID)partitionID hostname:(NSString *)hostname
+{
+	if ((partitionID == nil) || (hostname == nil))
+	{
+		return;
+	}
+
+	@synchronized(self)
+	{
+		OCHTTPConcurrencyLimit *limit = [self _limitForPartitionID:partitionID hostname:hostname create:YES];
+
+		limit.limit = MIN(MAX(limitValue, (double)_minimumLimit), (double)_maximumLimit);
+		limit.limitAtHighestThroughput = limit.limit;
+		limit.successesInRound = 0;
+	}
+}
+
+- (void)removeLimitsForPartitionID:(OCHTTPPipelinePartitionID)partitionID
+{
+	if (partitionID == nil)
+	{
+		return;
+	}
+
+	@synchronized(self)
+	{
+		[_limitsByPartitionID removeObjectForKey:partitionID];
+	}
+}
+
+#pragma mark - Feedback
+- (void)recordResponseWithStatusCode:(OCHTTPStatusCode)statusCode latency:(NSNumber *)latency receiveBytesPerSecond:(NSNumber *)receiveBytesPerSecond runningRequests:(NSUInteger)runningRequests forPartitionID:(OCHTTPPipelinePartitionID)partitionID hostname:(NSString *)hostname
+{
+	OCHTTPConcurrencyLimitChangeHandler limitChangeHandler = nil;
+	double previousLimit, newLimit;
+
+	if ((partitionID == nil) || (hostname == nil))
+	{
+		return;
+	}
+
+	@synchronized(self)
+	{
+		OCHTTPConcurrencyLimit *limit = [self _limitForPartitionID:partitionID hostname:hostname create:YES];
+		NSTimeInterval now = NSDate.timeIntervalSinceReferenceDate;
+		BOOL canDecrease = ((now - limit.lastDecreaseTime) >= MAX(OCHTTPConcurrencyMinimumCoolDown, limit.smoothedLatency * 2.0));
+
+		previousLimit = limit.limit;
+
+		if ((statusCode == OCHTTPStatusCodeTOO_MANY_REQUESTS) || (statusCode == OCHTTPStatusCodeSERVICE_UNAVAILABLE))
+		{
+			// Rate limited / overloaded => multiplicative decrease
+			if (canDecrease)
+			{
+				limit.limit = MAX(limit.limit * OCHTTPConcurrencyDecreaseFactor, (double)_minimumLimit);
+				limit.limitAtHighestThroughput = MIN(limit.limitAtHighestThroughput, limit.limit);
+				limit.lastDecreaseTime = now;
+				limit.successesInRound = 0;
+			}
+		}
+		else if ((statusCode != 0) && (statusCode < 500))
+		{
+			// Latency
+			if (latency != nil)
+			{
+				double latencySample = latency.doubleValue;
+
+				if (limit.smoothedLatency == 0)
+				{
+					limit.smoothedLatency = latencySample;
+					limit.baselineLatency = latencySample;
+				}
+				else
+				{
+					limit.smoothedLatency += (latencySample - limit.smoothedLatency) * OCHTTPConcurrencyLatencySmoothing;
+					limit.baselineLatency = MIN(latencySample, limit.baselineLatency + ((limit.smoothedLatency - limit.baselineLatency) * OCHTTPConcurrencyBaselineDrift));
+				}
+			}
+
+			// Throughput (aggregate throughput of all running requests, estimated from the throughput of this one)
+			if ((receiveBytesPerSecond != nil) && (runningRequests > 0))
+			{
+				double throughput = receiveBytesPerSecond.doubleValue * (double)runningRequests;
+
+				limit.highestThroughput *= OCHTTPConcurrencyThroughputDecay;
+
+				if (throughput > limit.highestThroughput)
+				{
+					limit.highestThroughput = throughput;
+					limit.limitAtHighestThroughput = limit.limit;
+				}
+			}
+
+			if ((limit.baselineLatency > 0) && (limit.smoothedLatency > (limit.baselineLatency * OCHTTPConcurrencyLatencyTolerance)) && ((limit.smoothedLatency - limit.baselineLatency) > OCHTTPConcurrencyMinimumQueueingDelay))
+			{
+				// Requests are queueing up => decrease
+				if (canDecrease)
+				{
+					limit.limit = MAX(limit.limit - 1.0, (double)_minimumLimit);
+					limit.lastDecreaseTime = now;
+					limit.successesInRound = 0;
+				}
+			}
+			else if ((runningRequests >= (NSUInteger)limit.limit) && ((limit.highestThroughput == 0) || (limit.limit < (limit.limitAtHighestThroughput + OCHTTPConcurrencyThroughputHeadroom))))
+			{
+				// Limit in use, no signs of congestion => additive increase by one per full round of requests
+				limit.successesInRound++;
+
+				if (limit.successesInRound >= (NSUInteger)limit.limit)
+				{
+					limit.limit = MIN(floor(limit.limit) + 1.0, (double)_maximumLimit);
+					limit.successesInRound = 0;
+				}
+			}
+		}
+
+		newLimit = limit.limit;
+
+		if (floor(previousLimit) != floor(newLimit))
+		{
+			limitChangeHandler = _limitChangeHandler;
+		}
+	}
+
+	if (limitChangeHandler != nil)
+	{
+		OCLogDebug(@"Concurrency limit for %@ (partition %@) changed from %lu to %lu (statusCode=%ld, latency=%@, receiveBytesPerSecond=%@, runningRequests=%lu)", OCLogPrivate(hostname), partitionID, (unsigned long)previousLimit, (unsigned long)newLimit, (long)statusCode, latency, receiveBytesPerSecond, (unsigned long)runningRequests);
+
+		limitChangeHandler(partitionID, hostname.lowercaseString, newLimit);
+	}
+}
+
+@end
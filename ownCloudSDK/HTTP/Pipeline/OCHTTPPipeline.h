@@ -24,6 +24,7 @@
 #import "OCCertificate.h"
 #import "OCClassSettings.h"
 #import "OCLogTag.h"
+#import "OCHTTPConcurrencyController.h"
 
 @class OCHTTPPipeline;
 
@@ -113,6 +114,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property(assign) NSUInteger maximumConcurrentRequests; //!< The maximum number of concurrently running requests. A value of 0 means no limit.
 
+@property(assign) BOOL adaptiveConcurrency; //!< If YES, the number of concurrently running requests per partition and host is limited by .concurrencyController. Defaults to the value of the OCHTTPPipelineSettingAdaptiveConcurrency class setting.
+@property(strong,readonly) OCHTTPConcurrencyController *concurrencyController; //!< Controller adapting the per-partition, per-host concurrency limits. Limits are persisted in the backend.
+
 @property(strong,nullable,readonly) NSString *urlSessionIdentifier;
 
 #pragma mark - User Agent
@@ -168,6 +172,7 @@ NS_ASSUME_NONNULL_BEGIN
 extern OCClassSettingsIdentifier OCClassSettingsIdentifierHTTP;
 extern OCClassSettingsKey OCHTTPPipelineSettingUserAgent;
 extern OCClassSettingsKey OCHTTPPipelineSettingTrafficLogFormat;
+extern OCClassSettingsKey OCHTTPPipelineSettingAdaptiveConcurrency;
 
 extern OCHTTPPipelineLogFormat OCHTTPPipelineLogFormatPlainText;
 extern OCHTTPPipelineLogFormat OCHTTPPipelineLogFormatJSON;
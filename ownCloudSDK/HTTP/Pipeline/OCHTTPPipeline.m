@@ -20,6 +20,7 @@
 #import "OCHTTPPipelineTask.h"
 #import "OCHTTPResponse.h"
 #import "OCHTTPPipelineBackend.h"
+#import "OCHTTPPipelineTaskIndex.h"
 #import "OCHTTPPipelineManager.h"
 #import "OCProcessManager.h"
 #import "OCLogger.h"
@@ -35,6 +36,7 @@
 #import "OCNetworkMonitor.h"
 #import "OCHTTPPolicyManager.h"
 #import "OCHTTPRequest+Stream.h"
+#import "OCHTTPRangedFileStream.h"
 #import "NSURLSessionTask+Debug.h"
 #import "NSURLSessionTaskMetrics+OCCompactSummary.h"
 
@@ -50,6 +52,8 @@
 	NSMutableSet<OCHTTPPipelinePartitionID> *_partitionsInDestruction;
 	NSMutableDictionary<OCHTTPPipelinePartitionID, NSMutableArray<dispatch_block_t> *> *_partitionEmptyHandlers;
 
+	NSMapTable<NSURLSessionTask *, OCHTTPRangedFileStream *> *_bodyStreamsByURLSessionTask; //!< Streams supplying request bodies from file ranges, closed when their task completes
+
 	NSMutableArray<OCHTTPPipelineTaskMetrics *> *_metricsHistory;
 	NSTimeInterval _metricsHistoryMaxAge;
 	NSTimeInterval _metricsMinimumTotalTransferDurationRelevancyThreshold;
@@ -133,12 +137,28 @@
 		_sessionCompletionHandlersByIdentifiers = [NSMutableDictionary new];
 		_partitionsInDestruction = [NSMutableSet new];
 
+		_bodyStreamsByURLSessionTask = [NSMapTable strongToStrongObjectsMapTable];
+
 		_metricsHistory = [NSMutableArray new];
 		_metricsHistoryMaxAge = 10 * 60; //!< Metrics records are used for computation for a maximum of 10 minutes
 		_metricsMinimumTotalTransferDurationRelevancyThreshold = 0.01; // Only metrics with a minimum total transfer duration of X secs should be considered relevant
 
 		_busyGroup = dispatch_group_create();
 
+		// Adaptive concurrency
+		__weak OCHTTPPipeline *weakSelf = self;
+
+		_adaptiveConcurrency = [[self classSettingForOCClassSettingsKey:OCHTTPPipelineSettingAdaptiveConcurrency] boolValue];
+		_concurrencyController = [[OCHTTPConcurrencyController alloc] initWithInitialLimit:8 minimumLimit:1 maximumLimit:32];
+		_concurrencyController.limitChangeHandler = ^(OCHTTPPipelinePartitionID partitionID, NSString *hostname, double limit) {
+			OCHTTPPipeline *strongSelf;
+
+			if ((strongSelf = weakSelf) != nil)
+			{
+				[strongSelf.backend setConcurrencyLimit:limit forPipeline:strongSelf.identifier partition:partitionID hostname:hostname];
+			}
+		};
+
 		// Set backend
 		if (backend == nil)
 		{
@@ -187,6 +207,16 @@
 							self->_state = OCHTTPPipelineStateStarted;
 						}
 
+						// Restore concurrency limits persisted during previous launches (dropping those unused for 30 days)
+						NSError *limitsError;
+
+						if ((limitsError = [self.backend enumerateConcurrencyLimitsForPipeline:self.identifier updatedSince:[NSDate dateWithTimeIntervalSinceNow:-30 * 24 * 60 * 60] enumerator:^(OCHTTPPipelinePartitionID partitionID, NSString *hostname, double limit) {
+							[self->_concurrencyController restoreLimit:limit forPartitionID:partitionID hostname:hostname];
+						}]) != nil)
+						{
+							OCLogError(@"Error restoring concurrency limits: %@", limitsError);
+						}
+
 						// Start URLSession
 						self->_urlSession = [NSURLSession sessionWithConfiguration:self->_sessionConfiguration delegate:self delegateQueue:nil];
 
@@ -604,20 +634,34 @@
 	}
 }
 
+static NSString *OCHTTPPipelineConcurrencyKey(OCHTTPPipelinePartitionID partitionID, NSString *hostname)
+{
+	if ((partitionID == nil) || (hostname == nil))
+	{
+		return (nil);
+	}
+
+	return ([NSString stringWithFormat:@"%@:%@", partitionID, hostname.lowercaseString]);
+}
+
 - (void)_schedule
 {
-	__block NSUInteger remainingSlots = NSUIntegerMax;
+	NSUInteger remainingSlots = NSUIntegerMax;
 
 	/*
 		Scheduling goals:
 		- the number of running requests doesn't exceed the limit imposed by .maximumConcurrentRequests at any time
 		- requests are scheduled fairly: the scheduler guarantees that for N groups, every group will get one request scheduled after N slots have become available (doesn't need to be in the same scheduling run)
 		- only one request can be running per group
+		- if .adaptiveConcurrency is enabled, the number of running requests per partition and host doesn't exceed the limit provided by .concurrencyController
 		- request not belonging to a group are assigned to the default group:
 			- any number of requests can be running for the default group at the same time
 			- any spots remaining after fair scheduling are filled with requests from the default group
 			- requests with a higher priority are scheduled sooner
 		- requests are only considered for scheduling if a partitionHandler is attached for them - or they have the .requestFinal flag set
+
+		Instead of enumerating all tasks in the backend, the scheduler uses the backend's task index and only
+		evaluates as many pending tasks as needed to fill the remaining slots.
 	*/
 
 	@synchronized(self)
@@ -633,38 +677,57 @@
 		_needsScheduling = NO;
 	}
 
+	// Retrieve up-to-date task index
+	OCHTTPPipelineTaskIndex *taskIndex;
+	NSError *indexError = nil;
+
+	if ((taskIndex = [_backend taskIndexForPipeline:self error:&indexError]) == nil)
+	{
+		OCLogError(@"Error retrieving task index during scheduling: indexError=%@", indexError);
+		return;
+	}
+
+	NSArray<OCHTTPPipelineTask *> *runningTasks = [taskIndex runningTasksForPipeline:self.identifier];
+
 	// Enforce .maximumConcurrentRequests
 	if (self.maximumConcurrentRequests != 0)
 	{
-		NSNumber *runningRequestsCount;
-		NSError *error = nil;
+		if (runningTasks.count >= self.maximumConcurrentRequests)
+		{
+			// Maximum number of concurrent requests reached => exit early
+			return;
+		}
+		else
+		{
+			// Adjust number of remaining slots
+			remainingSlots = self.maximumConcurrentRequests - runningTasks.count;
+		}
+	}
+
+	// Count running tasks per partition and host to enforce adaptive concurrency limits
+	OCHTTPConcurrencyController *concurrencyController = _adaptiveConcurrency ? _concurrencyController : nil;
+	NSMutableDictionary<NSString *, NSNumber *> *runningTaskCountByConcurrencyKey = nil;
+
+	if (concurrencyController != nil)
+	{
+		runningTaskCountByConcurrencyKey = [NSMutableDictionary new];
 
-		if ((runningRequestsCount = [_backend numberOfRequestsWithState:OCHTTPPipelineTaskStateRunning inPipeline:self partition:nil error:&error]) != nil)
+		for (OCHTTPPipelineTask *task in runningTasks)
 		{
-			if (runningRequestsCount.unsignedIntegerValue >= self.maximumConcurrentRequests)
-			{
-				// Maximum number of concurrent requests reached => exit early
-				return;
-			}
-			else
+			NSString *concurrencyKey;
+
+			if ((concurrencyKey = OCHTTPPipelineConcurrencyKey(task.partitionID, task.request.url.host)) != nil)
 			{
-				// Adjust number of remaining slots
-				remainingSlots = self.maximumConcurrentRequests - runningRequestsCount.unsignedIntegerValue;
+				runningTaskCountByConcurrencyKey[concurrencyKey] = @(runningTaskCountByConcurrencyKey[concurrencyKey].unsignedIntegerValue + 1);
 			}
 		}
-		else if (error != nil)
-		{
-			OCLogError(@"Error retrieving number of requests in running state: %@", error);
-		}
 	}
 
-	// Enumerate tasks in pipeline and pick ones for scheduling
-	__block NSMutableDictionary <OCHTTPRequestGroupID, NSMutableArray<OCHTTPPipelineTask *> *> *schedulableTasksByGroupID = [NSMutableDictionary new];
-	__block NSMutableSet <OCHTTPRequestGroupID> *blockedGroupIDs = [NSMutableSet new];
+	NSMutableSet <OCHTTPRequestGroupID> *blockedGroupIDs = [NSMutableSet new];
 	const OCHTTPRequestGroupID defaultGroupID = @"_default_";
-	NSError *enumerationError;
 
-	enumerationError = [_backend enumerateTasksForPipeline:self enumerator:^(OCHTTPPipelineTask *task, BOOL *stop) {
+	// Determine if a task is relevant for scheduling
+	BOOL (^TaskIsRelevant)(OCHTTPPipelineTask *task, id<OCHTTPPipelinePartitionHandler> *outPartitionHandler, BOOL *outIsTiedToOtherProcess, BOOL *outTaskExecutingOtherProcessIsAlive) = ^(OCHTTPPipelineTask *task, id<OCHTTPPipelinePartitionHandler> *outPartitionHandler, BOOL *outIsTiedToOtherProcess, BOOL *outTaskExecutingOtherProcessIsAlive) {
 		BOOL isRelevant = YES;
 		BOOL isTiedToOtherProcess = NO;
 		BOOL taskExecutingOtherProcessIsAlive = NO; // only relevant if isTiedToOtherProcess is YES
@@ -675,7 +738,7 @@
 		if ((partitionID = task.partitionID) == nil)
 		{
 			// No partitionID?! => skip
-			return;
+			return (NO);
 		}
 
 		@synchronized(self)
@@ -683,7 +746,7 @@
 			// Check if partition is being destroyed => skip
 			if ([self->_partitionsInDestruction containsObject:partitionID])
 			{
-				return;
+				return (NO);
 			}
 
 			// Retrieve partition handler
@@ -696,270 +759,278 @@
 			if (partitionHandler==nil)
 			{
 				// No partitionHandler for this task => skip
-				return;
+				return (NO);
 			}
 		}
 
 		// Check if this task originates from our process
-		if (isRelevant)
+		if (![task.bundleID isEqual:self->_bundleIdentifier] &&    // not originating from this process ..
+		    ![task.bundleID isEqual:OCHTTPPipelineTaskAnyBundleID]) // .. and tied to a specific process
 		{
-			if (![task.bundleID isEqual:self->_bundleIdentifier] &&    // not originating from this process ..
-			    ![task.bundleID isEqual:OCHTTPPipelineTaskAnyBundleID]) // .. and tied to a specific process
+			isTiedToOtherProcess = YES;
+			taskExecutingOtherProcessIsAlive = NO;
+
+			// Task originates from a different process. Only process it, if that other process is no longer around
+			OCProcessSession *processSession;
+
+			if ((processSession = [[OCProcessManager sharedProcessManager] findLatestSessionForProcessWithBundleIdentifier:task.bundleID]) != nil)
 			{
-				isTiedToOtherProcess = YES;
-				taskExecutingOtherProcessIsAlive = NO;
+				taskExecutingOtherProcessIsAlive = [[OCProcessManager sharedProcessManager] isAnyInstanceOfSessionProcessRunning:processSession];
+				isRelevant = !taskExecutingOtherProcessIsAlive;
+			}
+		}
+
+		*outPartitionHandler = partitionHandler;
+		*outIsTiedToOtherProcess = isTiedToOtherProcess;
+		*outTaskExecutingOtherProcessIsAlive = taskExecutingOtherProcessIsAlive;
+
+		return (isRelevant);
+	};
+
+	// Running tasks: block their groups and restart tasks dropped by the termination of other processes
+	for (OCHTTPPipelineTask *task in runningTasks)
+	{
+		id<OCHTTPPipelinePartitionHandler> partitionHandler = nil;
+		BOOL isTiedToOtherProcess = NO, taskExecutingOtherProcessIsAlive = NO;
+
+		if (!TaskIsRelevant(task, &partitionHandler, &isTiedToOtherProcess, &taskExecutingOtherProcessIsAlive))
+		{
+			continue;
+		}
 
-				// Task originates from a different process. Only process it, if that other process is no longer around
-				OCProcessSession *processSession;
+		if (task.groupID != nil)
+		{
+			// Add groupID to list of blocked group IDs
+			[blockedGroupIDs addObject:task.groupID];
+		}
 
-				if ((processSession = [[OCProcessManager sharedProcessManager] findLatestSessionForProcessWithBundleIdentifier:task.bundleID]) != nil)
+		// Check if the task should be restarted
+		if (isTiedToOtherProcess && !taskExecutingOtherProcessIsAlive)
+		{
+			// Tied to another process which is no longer alive
+			if ([self.identifier isEqual:OCHTTPPipelineIDLocal] || [self.identifier isEqual:OCHTTPPipelineIDForegroundTransfer])
+			{
+				// Task runs on "local" or "foregroundTransfer" pipeline (for "ephermal" is memory-only and background can run even if the process is not)
+				if ([OCLogger logsForLevel:OCLogLevelWarning] && (task.request != nil))
 				{
-					taskExecutingOtherProcessIsAlive = [[OCProcessManager sharedProcessManager] isAnyInstanceOfSessionProcessRunning:processSession];
-					isRelevant = !taskExecutingOtherProcessIsAlive;
+					OCLogWarning(@"Determined that task has been dropped by process termination of %@ - restarting %@", task.bundleID, task);
 				}
+
+				// All conditions met to restart request
+				[self finishedTask:task withResponse:[OCHTTPResponse responseWithRequest:task.request HTTPError:OCError(OCErrorRequestDroppedByOriginalProcessTermination)]];
 			}
 		}
+	}
 
-		// Task is relevant
-		if (isRelevant)
+	// Determine if a pending task can be scheduled now. Returns NO if it can't - or has been made to fail.
+	BOOL (^TaskIsSchedulable)(OCHTTPPipelineTask *task, id<OCHTTPPipelinePartitionHandler> partitionHandler, BOOL *outFailed) = ^(OCHTTPPipelineTask *task, id<OCHTTPPipelinePartitionHandler> partitionHandler, BOOL *outFailed) {
+		BOOL schedule = YES;
+
+		// Check signal availability
 		{
-			OCHTTPRequestGroupID taskGroupID = task.groupID;
+			NSError *failWithError = nil;
 
-			// Check group association
-			if (taskGroupID == nil)
+			// Only check for signals on final requests if more than one signal has been set (several unit tests with "final" requests depend on this) or the partitionHandler currently is available
+			// !! For non-final requests, the Connection Validator depends on -meetsSignalRequirements:forTask:failWithError: being called !!
+			if (!task.requestFinal || (task.requestFinal && (task.request.requiredSignals.count > 0)) || (partitionHandler != nil))
 			{
-				// Task doesn't belong to a group. Assign default ID.
-				taskGroupID = defaultGroupID;
+				// This call is also made if partitionHandler is nil, resulting in schedule = NO
+				schedule = [partitionHandler pipeline:self meetsSignalRequirements:task.request.requiredSignals forTask:task failWithError:&failWithError];
 			}
-			else
+
+			if (!schedule && (failWithError!=nil))
+			{
+				// Required signal check returned a failWithError => make request fail with that error
+				[self _finishedTask:task withResponse:[OCHTTPResponse responseWithRequest:task.request HTTPError:failWithError]];
+				*outFailed = YES;
+				return (NO);
+			}
+		}
+
+		// Check cellular switch availability
+		if (schedule && (task.request.requiredCellularSwitch != nil))
+		{
+			NSUInteger transferSize = 0;
+			BOOL wifiOnly = NO;
+
+			if (task.request.bodyData != nil)
 			{
-				// Task belongs to group
-				if ([blockedGroupIDs containsObject:taskGroupID])
+				transferSize = task.request.bodyData.length;
+			}
+			else if ((task.request.bodyURL != nil) && (task.request.bodyURLRange.length > 0))
+			{
+				transferSize = task.request.bodyURLRange.length;
+			}
+			else if (task.request.bodyURL != nil)
+			{
+				NSNumber *fileSize = nil;
 				{
-					// Another task for the same task.groupID is already active
-					return;
+					NSError *error = nil;
+					if (![task.request.bodyURL getResourceValue:&fileSize forKey:NSURLFileSizeKey error:&error])
+					{
+						OCLogError(@"Error determining size of %@: %@", task.request.bodyURL, error);
+					}
+					else
+					{
+						transferSize = fileSize.unsignedIntegerValue;
+					}
 				}
 			}
 
-			// Check task state
-			switch (task.state)
+			if ([OCCellularManager.sharedManager networkAccessAvailableFor:task.request.requiredCellularSwitch transferSize:transferSize onWifiOnly:&wifiOnly])
 			{
-				case OCHTTPPipelineTaskStatePending:
-					// Task is pending
-					if (taskGroupID != nil)
-					{
-						NSMutableArray <OCHTTPPipelineTask *> *schedulableTasks = nil;
-						BOOL schedule = YES;
+				// Network access currently allowed for this request
+				task.request.avoidCellular = wifiOnly; // Pass on enforcement of cellular setting on to the HTTP/NSURLSession layer
+			}
+			else
+			{
+				// Network access not currently allowed for this request based on the cellular switch settings
+				schedule = NO;
+			}
+		}
 
-						// Check signal availability
-						{
-							NSError *failWithError = nil;
+		return (schedule);
+	};
 
-							// Only check for signals on final requests if more than one signal has been set (several unit tests with "final" requests depend on this) or the partitionHandler currently is available
-							// !! For non-final requests, the Connection Validator depends on -meetsSignalRequirements:forTask:failWithError: being called !!
-							if (!task.requestFinal || (task.requestFinal && (task.request.requiredSignals.count > 0)) || (partitionHandler != nil))
-							{
-								// This call is also made if partitionHandler is nil, resulting in schedule = NO
-								schedule = [partitionHandler pipeline:self meetsSignalRequirements:task.request.requiredSignals forTask:task failWithError:&failWithError];
-							}
+	// Returns the next task to schedule for a group (or the default group), walking its pending tasks in scheduling order
+	NSUInteger batchSize = MIN(MAX(remainingSlots, 16), 256);
+	__block OCHTTPPipelineTask *lastDefaultGroupTask = nil;
 
-							if (!schedule && (failWithError!=nil))
-							{
-								// Required signal check returned a failWithError => make request fail with that error
-								[self _finishedTask:task withResponse:[OCHTTPResponse responseWithRequest:task.request HTTPError:failWithError]];
-								return;
-							}
-						}
+	OCHTTPPipelineTask *(^NextSchedulableTaskForGroup)(OCHTTPRequestGroupID groupID) = ^OCHTTPPipelineTask *(OCHTTPRequestGroupID groupID) {
+		BOOL isDefaultGroup = [groupID isEqual:defaultGroupID];
+		OCHTTPPipelineTask *afterTask = isDefaultGroup ? lastDefaultGroupTask : nil;
+		NSArray<OCHTTPPipelineTask *> *tasks;
 
-						// Check cellular switch availability
-						if (schedule && (task.request.requiredCellularSwitch != nil))
-						{
-							NSUInteger transferSize = 0;
-							BOOL wifiOnly = NO;
+		while ((tasks = [taskIndex pendingTasksForPipeline:self.identifier groupID:(isDefaultGroup ? nil : groupID) after:afterTask limit:batchSize]).count > 0)
+		{
+			for (OCHTTPPipelineTask *task in tasks)
+			{
+				id<OCHTTPPipelinePartitionHandler> partitionHandler = nil;
+				BOOL isTiedToOtherProcess = NO, taskExecutingOtherProcessIsAlive = NO, failed = NO;
 
-							if (task.request.bodyData != nil)
-							{
-								transferSize = task.request.bodyData.length;
-							}
-							else if (task.request.bodyURL != nil)
-							{
-								NSNumber *fileSize = nil;
-								{
-									NSError *error = nil;
-									if (![task.request.bodyURL getResourceValue:&fileSize forKey:NSURLFileSizeKey error:&error])
-									{
-										OCLogError(@"Error determining size of %@: %@", task.request.bodyURL, error);
-									}
-									else
-									{
-										transferSize = fileSize.unsignedIntegerValue;
-									}
-								}
-							}
+				afterTask = task;
 
-							if ([OCCellularManager.sharedManager networkAccessAvailableFor:task.request.requiredCellularSwitch transferSize:transferSize onWifiOnly:&wifiOnly])
-							{
-								// Network access currently allowed for this request
-								task.request.avoidCellular = wifiOnly; // Pass on enforcement of cellular setting on to the HTTP/NSURLSession layer
-							}
-							else
-							{
-								// Network access not currently allowed for this request based on the cellular switch settings
-								schedule = NO;
-							}
-						}
+				if (isDefaultGroup)
+				{
+					lastDefaultGroupTask = task;
+				}
 
-						if (schedule)
-						{
-							if ((schedulableTasks = schedulableTasksByGroupID[taskGroupID]) == nil)
-							{
-								// First pending task with this taskGroupID
-								schedulableTasks = [[NSMutableArray alloc] initWithObjects:task, nil];
-								schedulableTasksByGroupID[taskGroupID] = schedulableTasks;
-							}
-							else if (task.groupID == nil)
-							{
-								// Pending task without groupID (ignore tasks with groupID here, as it'd be the second with the groupID or later)
-								[schedulableTasks addObject:task];
-							}
-						}
-						else
-						{
-							if (task.groupID != nil)
-							{
-								// Add groupID to list of blocked group IDs (to prevent out-of-order scheduling/execution of requests)
-								[blockedGroupIDs addObject:task.groupID];
-							}
-						}
-					}
-				break;
+				// Check adaptive concurrency limit for the task's partition and host first, as it is the cheapest check
+				NSString *concurrencyKey = nil;
 
-				case OCHTTPPipelineTaskStateRunning:
-					// Task is running
-					if (task.groupID != nil)
+				if ((concurrencyController != nil) && ((concurrencyKey = OCHTTPPipelineConcurrencyKey(task.partitionID, task.request.url.host)) != nil))
+				{
+					if (runningTaskCountByConcurrencyKey[concurrencyKey].unsignedIntegerValue >= [concurrencyController limitForPartitionID:task.partitionID hostname:task.request.url.host])
 					{
-						// Add groupID to list of blocked group IDs
-						[blockedGroupIDs addObject:task.groupID];
+						if (!isDefaultGroup)
+						{
+							// Keep requests of the group in order
+							[blockedGroupIDs addObject:groupID];
+							return (nil);
+						}
 
-						[schedulableTasksByGroupID removeObjectForKey:task.groupID];
+						continue;
 					}
+				}
 
-					// Check if the task should be restarted
-					if (isTiedToOtherProcess && !taskExecutingOtherProcessIsAlive)
-					{
-						// Tied to another process which is no longer alive
-						if ([self.identifier isEqual:OCHTTPPipelineIDLocal])
-						{
-							// Task runs on "local" pipeline (for "ephermal" is memory-only and background can run even if the process is not)
-							if ([OCLogger logsForLevel:OCLogLevelWarning] && (task.request != nil))
-							{
-								OCLogWarning(@"Determined that task has been dropped by process termination of %@ - restarting %@", task.bundleID, task);
-							}
+				if (!TaskIsRelevant(task, &partitionHandler, &isTiedToOtherProcess, &taskExecutingOtherProcessIsAlive))
+				{
+					continue;
+				}
 
-							// All conditions met to restart request
-							[self finishedTask:task withResponse:[OCHTTPResponse responseWithRequest:task.request HTTPError:OCError(OCErrorRequestDroppedByOriginalProcessTermination)]];
-						}
+				if (TaskIsSchedulable(task, partitionHandler, &failed))
+				{
+					if (concurrencyKey != nil)
+					{
+						runningTaskCountByConcurrencyKey[concurrencyKey] = @(runningTaskCountByConcurrencyKey[concurrencyKey].unsignedIntegerValue + 1);
 					}
 
-					return;
-				break;
+					return (task);
+				}
 
-				case OCHTTPPipelineTaskStateCompleted:
-					// Task is completed
-					return;
-				break;
+				if (!failed && !isDefaultGroup)
+				{
+					// Add groupID to list of blocked group IDs (to prevent out-of-order scheduling/execution of requests)
+					[blockedGroupIDs addObject:groupID];
+					return (nil);
+				}
 			}
 		}
-	}];
 
-	if (enumerationError != nil)
-	{
-		OCLogError(@"Error enumerating tasks during scheduling: enumerationError=%@", enumerationError);
-	}
+		return (nil);
+	};
 
-	// OCLogVerbose(@"Scheduler state: schedulableTasksByGroupID=%@, blockedGroupIDs=%@, remainingSlots=%d, recentlyScheduledGroupIDs=%@", schedulableTasksByGroupID, blockedGroupIDs, remainingSlots, _recentlyScheduledGroupIDs);
+	// Pick tasks for scheduling
+	NSMutableArray <OCHTTPPipelineTask *> *scheduleTasks = [NSMutableArray new];
+	NSMutableArray <OCHTTPRequestGroupID> *schedulableGroupIDs = [[taskIndex groupIDsWithPendingTasksForPipeline:self.identifier] mutableCopy];
+	NSSet <OCHTTPRequestGroupID> *recentlyScheduledGroupIDs = [NSSet setWithArray:_recentlyScheduledGroupIDs];
 
-	// Filter and sort tasks
-	if (schedulableTasksByGroupID.count > 0)
+	if ([taskIndex hasPendingTasksWithoutGroupForPipeline:self.identifier])
 	{
-		NSMutableArray <OCHTTPPipelineTask *> *scheduleTasks = [NSMutableArray new];
-		NSMutableArray <OCHTTPRequestGroupID> *schedulableGroupIDs = [schedulableTasksByGroupID.allKeys mutableCopy];
-
-		NSComparator sortTasksByRequestPriorityComparator = ^NSComparisonResult(OCHTTPPipelineTask *task1, OCHTTPPipelineTask *task2) {
-			OCHTTPRequestPriority task1Priority, task2Priority;
+		[schedulableGroupIDs addObject:defaultGroupID];
+	}
 
-			task1Priority = task1.request.priority;
-			task2Priority = task2.request.priority;
+	[schedulableGroupIDs removeObjectsInArray:blockedGroupIDs.allObjects];
 
-			if (task1Priority == task2Priority)
-			{
-				return (NSOrderedSame);
-			}
+	// OCLogVerbose(@"Scheduler state: schedulableGroupIDs=%@, blockedGroupIDs=%@, remainingSlots=%d, recentlyScheduledGroupIDs=%@", schedulableGroupIDs, blockedGroupIDs, remainingSlots, _recentlyScheduledGroupIDs);
 
-			return ((task1Priority > task2Priority) ? NSOrderedAscending : NSOrderedDescending); // In reverse order, so highest value comes first
-		};
-
-		// Sort defaultGroup requests by request.priority
-		[schedulableTasksByGroupID[defaultGroupID] sortUsingComparator:sortTasksByRequestPriorityComparator];
+	// Prioritize requests from groups whose requests have never been scheduled
+	for (OCHTTPRequestGroupID groupID in schedulableGroupIDs)
+	{
+		OCHTTPPipelineTask *task;
 
-		// Prioritize requests from groups whose requests haven't been scheduled the longest
-		for (OCHTTPRequestGroupID groupID in _recentlyScheduledGroupIDs)
+		if (scheduleTasks.count >= remainingSlots)
 		{
-			NSMutableArray <OCHTTPPipelineTask *> *tasks;
+			break;
+		}
 
-			if ((tasks = schedulableTasksByGroupID[groupID]) != nil)
+		if (![recentlyScheduledGroupIDs containsObject:groupID])
+		{
+			// Add the oldest task from this group
+			if ((task = NextSchedulableTaskForGroup(groupID)) != nil)
 			{
-				OCHTTPPipelineTask *task;
-
-				// Add the oldest task from this group
-				if ((task = tasks.firstObject) != nil)
-				{
-					[scheduleTasks addObject:task];
-					[tasks removeObjectAtIndex:0];
-				}
-
-				[schedulableGroupIDs removeObject:groupID]; // Done with this group
+				[scheduleTasks addObject:task];
 			}
 		}
+	}
 
-		// OCLogVerbose(@"schedulableGroupIDs=%@", schedulableGroupIDs);
-
-		// Prioritize requests from groups whose requests have never been scheduled even higher (by inserting them at the top)
-		for (OCHTTPRequestGroupID groupID in schedulableGroupIDs)
-		{
-			NSMutableArray <OCHTTPPipelineTask *> *tasks;
+	// Followed by requests from groups whose requests haven't been scheduled the longest
+	NSSet <OCHTTPRequestGroupID> *schedulableGroupIDsSet = [NSSet setWithArray:schedulableGroupIDs];
 
-			if ((tasks = schedulableTasksByGroupID[groupID]) != nil)
-			{
-				OCHTTPPipelineTask *task;
+	for (OCHTTPRequestGroupID groupID in _recentlyScheduledGroupIDs)
+	{
+		OCHTTPPipelineTask *task;
 
-				// Add the oldest task from this group
-				if ((task = tasks.firstObject) != nil)
-				{
-					[scheduleTasks insertObject:task atIndex:0];
-					[tasks removeObjectAtIndex:0];
-				}
-			}
+		if (scheduleTasks.count >= remainingSlots)
+		{
+			break;
 		}
 
-		// Fill remaining spots (if any) with defaultGroup tasks
-		NSMutableArray <OCHTTPPipelineTask *> *tasks;
-
-		if ((tasks = schedulableTasksByGroupID[defaultGroupID]) != nil)
+		if ([schedulableGroupIDsSet containsObject:groupID])
 		{
-			[scheduleTasks addObjectsFromArray:tasks];
+			// Add the oldest task from this group
+			if ((task = NextSchedulableTaskForGroup(groupID)) != nil)
+			{
+				[scheduleTasks addObject:task];
+			}
 		}
+	}
 
-		// OCLogVerbose(@"scheduleTasks=%@", scheduleTasks);
+	// Fill remaining spots (if any) with defaultGroup tasks
+	if ([schedulableGroupIDsSet containsObject:defaultGroupID])
+	{
+		OCHTTPPipelineTask *task;
 
-		// Reduce to maximum of remainingSlots
-		if (scheduleTasks.count > remainingSlots)
+		while ((scheduleTasks.count < remainingSlots) && ((task = NextSchedulableTaskForGroup(defaultGroupID)) != nil))
 		{
-			[scheduleTasks removeObjectsInRange:NSMakeRange(remainingSlots, scheduleTasks.count-remainingSlots)];
+			[scheduleTasks addObject:task];
 		}
+	}
 
-		// OCLogVerbose(@"scheduleTasksShortened=%@", scheduleTasks);
+	// OCLogVerbose(@"scheduleTasks=%@", scheduleTasks);
 
+	if (scheduleTasks.count > 0)
+	{
 		// Update recentlyScheduledGroupIDs
 		for (OCHTTPPipelineTask *task in scheduleTasks)
 		{
@@ -1087,6 +1158,19 @@
 								urlSessionTask = [_urlSession downloadTaskWithRequest:urlRequest];
 							}
 						}
+						else if ((request.bodyURL != nil) && (request.bodyURLRange.length > 0))
+						{
+							// Body comes from a range of a file. Make it a streamed upload task, whose body stream is provided via -URLSession:task:needNewBodyStream:
+							if (self.backgroundSessionBacked)
+							{
+								// Background sessions only support uploads from files. Leave urlSessionTask nil, so the request fails.
+								OCLogError(@"Request %@ with body range can't be scheduled on background session backed pipeline %@", request.identifier, _identifier);
+							}
+							else
+							{
+								urlSessionTask = [_urlSession uploadTaskWithStreamedRequest:urlRequest];
+							}
+						}
 						else if (request.bodyURL != nil)
 						{
 							// Body comes from a file. Make it an upload task.
@@ -1926,6 +2010,10 @@
 				// Remove all records for this partition from the database
 				[self.backend removeAllTasksForPipeline:self.identifier partition:partitionID];
 
+				// Remove concurrency limits for this partition
+				[self.backend removeConcurrencyLimitsForPipeline:self.identifier partition:partitionID];
+				[self->_concurrencyController removeLimitsForPartitionID:partitionID];
+
 				// Remove partition root dir for temporary files
 				if ((temporaryPartitionRootURL = [self _URLForPartitionID:partitionID requestID:nil]) != nil)
 				{
@@ -2207,6 +2295,9 @@
 
 	OCLogVerbose(@"Task [%@] didCompleteWithError=%@", urlSessionTask.requestIdentityDescription, error);
 
+	// Stop streaming the request body (f.ex. if the task was cancelled before the body was sent completely)
+	[self _setBodyStream:nil forURLSessionTask:urlSessionTask];
+
 	if ((task = [self.backend retrieveTaskForPipeline:self URLSession:session task:urlSessionTask error:&backendError]) != nil)
 	{
 		OCLogVerbose(@"Known task [%@] didCompleteWithError=%@", urlSessionTask.requestIdentityDescription,  error);
@@ -2220,11 +2311,17 @@
 			response.requestID = task.request.identifier;
 			response.httpError = error;
 
+			[self _recordConcurrencyFeedbackForTask:task response:response];
+
 			[self finishedTask:task withResponse:response];
 		}
 		else
 		{
-			[self finishedTask:task withResponse:[task responseFromURLSessionTask:urlSessionTask]];
+			OCHTTPResponse *response = [task responseFromURLSessionTask:urlSessionTask];
+
+			[self _recordConcurrencyFeedbackForTask:task response:response];
+
+			[self finishedTask:task withResponse:response];
 		}
 	}
 	else
@@ -2234,6 +2331,55 @@
 	}
 }
 
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)urlSessionTask needNewBodyStream:(void (^)(NSInputStream * _Nullable))completionHandler
+{
+	NSError *backendError = nil;
+	OCHTTPRangedFileStream *bodyStream = nil;
+	OCHTTPPipelineTask *task;
+
+	OCLogVerbose(@"Task [%@] needNewBodyStream", urlSessionTask.requestIdentityDescription);
+
+	if ((task = [self.backend retrieveTaskForPipeline:self URLSession:session task:urlSessionTask error:&backendError]) != nil)
+	{
+		NSError *streamError = nil;
+
+		if ((bodyStream = [task.request bodyURLRangeStreamWithError:&streamError]) == nil)
+		{
+			OCLogError(@"Task [%@] needNewBodyStream: no body stream available, streamError=%@", urlSessionTask.requestIdentityDescription, streamError);
+		}
+	}
+	else
+	{
+		OCLogError(@"UNKNOWN TASK [%@] needNewBodyStream, backendError=%@", urlSessionTask.requestIdentityDescription, backendError);
+	}
+
+	// Replaces (and closes) a stream provided earlier, f.ex. if the body needs to be resent after a redirect or authentication challenge
+	[self _setBodyStream:bodyStream forURLSessionTask:urlSessionTask];
+
+	completionHandler(bodyStream.inputStream);
+}
+
+- (void)_setBodyStream:(nullable OCHTTPRangedFileStream *)bodyStream forURLSessionTask:(NSURLSessionTask *)urlSessionTask
+{
+	OCHTTPRangedFileStream *previousBodyStream;
+
+	@synchronized(_bodyStreamsByURLSessionTask)
+	{
+		previousBodyStream = [_bodyStreamsByURLSessionTask objectForKey:urlSessionTask];
+
+		if (bodyStream != nil)
+		{
+			[_bodyStreamsByURLSessionTask setObject:bodyStream forKey:urlSessionTask];
+		}
+		else
+		{
+			[_bodyStreamsByURLSessionTask removeObjectForKey:urlSessionTask];
+		}
+	}
+
+	[previousBodyStream close];
+}
+
 - (void)URLSession:(NSURLSession *)session taskIsWaitingForConnectivity:(NSURLSessionTask *)urlSessionTask
 {
 	OCLogVerbose(@"Task [%@] taskIsWaitingForConnectivity", urlSessionTask.requestIdentityDescription);
@@ -2703,7 +2849,11 @@
 
 		requestSize += [OCHTTPPipelineTaskMetrics lengthOfHeaderDictionary:request.headerFields method:request.method url:request.effectiveURL];
 
-		if (request.bodyURL != nil)
+		if ((request.bodyURL != nil) && (request.bodyURLRange.length > 0))
+		{
+			requestSize += request.bodyURLRange.length;
+		}
+		else if (request.bodyURL != nil)
 		{
 			NSNumber *fileSize = nil;
 
@@ -2734,6 +2884,35 @@
 	return (nil);
 }
 
+#pragma mark - Adaptive concurrency
+- (void)_recordConcurrencyFeedbackForTask:(OCHTTPPipelineTask *)task response:(OCHTTPResponse *)response
+{
+	OCHTTPConcurrencyController *concurrencyController;
+	OCHTTPPipelineTaskIndex *taskIndex;
+	NSString *concurrencyKey, *hostname = task.request.url.host;
+	NSUInteger runningRequests = 0;
+
+	if (!_adaptiveConcurrency || ((concurrencyController = _concurrencyController) == nil) ||
+	    ((concurrencyKey = OCHTTPPipelineConcurrencyKey(task.partitionID, hostname)) == nil))
+	{
+		return;
+	}
+
+	// Number of requests running for the same partition and host (incl. the finished one, which is still running from the index' perspective)
+	if ((taskIndex = [_backend taskIndexForPipeline:self error:NULL]) != nil)
+	{
+		for (OCHTTPPipelineTask *runningTask in [taskIndex runningTasksForPipeline:_identifier])
+		{
+			if ([OCHTTPPipelineConcurrencyKey(runningTask.partitionID, runningTask.request.url.host) isEqual:concurrencyKey])
+			{
+				runningRequests++;
+			}
+		}
+	}
+
+	[concurrencyController recordResponseWithStatusCode:response.status.code latency:task.metrics.serverProcessingTimeInterval receiveBytesPerSecond:task.metrics.receivedBytesPerSecond runningRequests:MAX(runningRequests, 1) forPartitionID:task.partitionID hostname:hostname];
+}
+
 #pragma mark - Progress
 - (nullable NSProgress *)progressForRequestID:(OCHTTPRequestID)requestID
 {
@@ -2759,7 +2938,8 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCHTTPPipeline)
 {
 	return (@{
 		OCHTTPPipelineSettingUserAgent : @"ownCloudApp/{{app.version}} ({{app.part}}/{{app.build}}; {{os.name}}/{{os.version}}; {{device.model}})",
-		OCHTTPPipelineSettingTrafficLogFormat : OCHTTPPipelineLogFormatJSON
+		OCHTTPPipelineSettingTrafficLogFormat : OCHTTPPipelineLogFormatJSON,
+		OCHTTPPipelineSettingAdaptiveConcurrency : @(YES)
 	});
 }
 
@@ -2783,6 +2963,13 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCHTTPPipeline)
 				OCHTTPPipelineLogFormatPlainText : @"Plain text",
 				OCHTTPPipelineLogFormatJSON	 : @"JSON"
 			}
+		},
+
+		OCHTTPPipelineSettingAdaptiveConcurrency : @{
+			OCClassSettingsMetadataKeyType 		: OCClassSettingsMetadataTypeBoolean,
+			OCClassSettingsMetadataKeyDescription 	: @"Adapt the number of concurrent requests per account and host to observed throughput, latency and rate limiting (429/503) responses. Limits are kept across launches.",
+			OCClassSettingsMetadataKeyStatus	: OCClassSettingsKeyStatusAdvanced,
+			OCClassSettingsMetadataKeyCategory	: @"Connection",
 		}
 	});
 }
@@ -2859,6 +3046,7 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCHTTPPipeline)
 OCClassSettingsIdentifier OCClassSettingsIdentifierHTTP = @"http";
 OCClassSettingsKey OCHTTPPipelineSettingUserAgent = @"user-agent";
 OCClassSettingsKey OCHTTPPipelineSettingTrafficLogFormat = @"traffic-log-format";
+OCClassSettingsKey OCHTTPPipelineSettingAdaptiveConcurrency = @"adaptive-concurrency";
 
 OCHTTPPipelineLogFormat OCHTTPPipelineLogFormatPlainText = @"plain";
 OCHTTPPipelineLogFormat OCHTTPPipelineLogFormatJSON = @"json";
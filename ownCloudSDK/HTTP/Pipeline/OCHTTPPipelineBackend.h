@@ -24,6 +24,7 @@
 @class OCHTTPPipeline;
 @class OCHTTPPipelineTask;
 @class OCHTTPPipelineTaskCache;
+@class OCHTTPPipelineTaskIndex;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -35,6 +36,9 @@ NS_ASSUME_NONNULL_BEGIN
 	OCCompletionHandler _openCompletionHandler;
 
 	OCHTTPPipelineTaskCache *_taskCache;
+
+	OCHTTPPipelineTaskIndex *_taskIndex;
+	NSNumber *_taskIndexDataVersion;
 }
 
 @property(strong,readonly) NSString *bundleIdentifier;
@@ -67,8 +71,15 @@ NS_ASSUME_NONNULL_BEGIN
 - (NSNumber *)numberOfRequestsWithState:(OCHTTPPipelineTaskState)state inPipeline:(OCHTTPPipeline *)pipeline partition:(nullable OCHTTPPipelinePartitionID)partitionID error:(NSError * _Nullable *)outDBError;
 - (NSNumber *)numberOfRequestsInPipeline:(OCHTTPPipeline *)pipeline partition:(OCHTTPPipelinePartitionID)partitionID error:(NSError * _Nullable *)outDBError;
 
+- (nullable OCHTTPPipelineTaskIndex *)taskIndexForPipeline:(OCHTTPPipeline *)pipeline error:(NSError * _Nullable *)outDBError; //!< Returns an up-to-date index of the pending and running tasks of the pipeline, (re)building it from the database if needed (f.ex. after changes by other processes)
+
 - (void)retrieveActionTrackingIDsForPartition:(OCHTTPPipelinePartitionID)partitionID resultHandler:(void(^)(NSError * _Nullable error, NSSet<OCActionTrackingID> * _Nullable trackingIDs, NSNumber * _Nullable totalNumberOfRequestsInBackend))resultHandler;
 
+#pragma mark - Concurrency limits
+- (NSError *)enumerateConcurrencyLimitsForPipeline:(OCHTTPPipelineID)pipelineID updatedSince:(NSDate *)date enumerator:(void(^)(OCHTTPPipelinePartitionID partitionID, NSString *hostname, double limit))limitEnumerator; //!< Enumerates the persisted concurrency limits of a pipeline, removing those not updated since date
+- (void)setConcurrencyLimit:(double)limit forPipeline:(OCHTTPPipelineID)pipelineID partition:(OCHTTPPipelinePartitionID)partitionID hostname:(NSString *)hostname; //!< Persists a concurrency limit of a pipeline
+- (void)removeConcurrencyLimitsForPipeline:(OCHTTPPipelineID)pipelineID partition:(OCHTTPPipelinePartitionID)partitionID; //!< Removes all persisted concurrency limits of a pipeline's partition
+
 #pragma mark - Debugging
 - (void)dumpDBTable;
 
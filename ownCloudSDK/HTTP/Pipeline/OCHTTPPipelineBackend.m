@@ -24,6 +24,7 @@
 #import "OCHTTPPipelineTask.h"
 #import "OCMacros.h"
 #import "OCHTTPPipelineTaskCache.h"
+#import "OCHTTPPipelineTaskIndex.h"
 #import "OCLogger.h"
 #import "NSError+OCError.h"
 
@@ -37,6 +38,7 @@
 // #define TaskDescription(task) task.taskID
 
 static NSString *OCHTTPPipelineTasksTableName = @"httpPipelineTasks";
+static NSString *OCHTTPPipelineConcurrencyLimitsTableName = @"httpConcurrencyLimits";
 
 @implementation OCHTTPPipelineBackend
 
@@ -57,6 +59,7 @@ static NSString *OCHTTPPipelineTasksTableName = @"httpPipelineTasks";
 		}
 
 		_taskCache = [[OCHTTPPipelineTaskCache alloc] initWithBackend:self];
+		_taskIndex = [OCHTTPPipelineTaskIndex new];
 
 		if (sqlDB != nil)
 		{
@@ -283,6 +286,59 @@ static NSString *OCHTTPPipelineTasksTableName = @"httpPipelineTasks";
 		}]
 
 	];
+
+	// Concurrency limits - version 1
+	[_sqlDB addTableSchema:[OCSQLiteTableSchema
+		schemaWithTableName:OCHTTPPipelineConcurrencyLimitsTableName
+		version:1
+		creationQueries:@[
+			/*
+				partitionID : TEXT		- ID of the partition the limit applies to
+				hostname : TEXT			- (lowercase) name of the host the limit applies to
+				concurrencyLimit : REAL		- adaptive concurrency limit (see OCHTTPConcurrencyController)
+				lastUpdated : REAL		- NSDate.timeIntervalSinceReferenceDate of the last update of the limit
+			*/
+			@"CREATE TABLE httpConcurrencyLimits (partitionID TEXT NOT NULL, hostname TEXT NOT NULL, concurrencyLimit REAL NOT NULL, lastUpdated REAL NOT NULL, PRIMARY KEY (partitionID, hostname))",
+		]
+		openStatements:nil
+		upgradeMigrator:nil]
+	];
+
+	// Concurrency limits - version 2
+	[_sqlDB addTableSchema:[OCSQLiteTableSchema
+		schemaWithTableName:OCHTTPPipelineConcurrencyLimitsTableName
+		version:2
+		creationQueries:@[
+			/*
+				pipelineID : TEXT		- ID of the pipeline the limit applies to
+				partitionID : TEXT		- ID of the partition the limit applies to
+				hostname : TEXT			- (lowercase) name of the host the limit applies to
+				concurrencyLimit : REAL		- adaptive concurrency limit (see OCHTTPConcurrencyController)
+				lastUpdated : REAL		- NSDate.timeIntervalSinceReferenceDate of the last update of the limit
+			*/
+			@"CREATE TABLE httpConcurrencyLimits (pipelineID TEXT NOT NULL, partitionID TEXT NOT NULL, hostname TEXT NOT NULL, concurrencyLimit REAL NOT NULL, lastUpdated REAL NOT NULL, PRIMARY KEY (pipelineID, partitionID, hostname))",
+		]
+		openStatements:nil
+		upgradeMigrator:^(OCSQLiteDB *db, OCSQLiteTableSchema *schema, void (^completionHandler)(NSError *error)) {
+			// Migrate to version 2
+			[db executeTransaction:[OCSQLiteTransaction transactionWithBlock:^NSError *(OCSQLiteDB *db, OCSQLiteTransaction *transaction) {
+				INSTALL_TRANSACTION_ERROR_COLLECTION_RESULT_HANDLER
+
+				// Drop old table (its limits can't be attributed to a pipeline and are re-learned quickly)
+				[db executeQuery:[OCSQLiteQuery query:@"DROP TABLE httpConcurrencyLimits" resultHandler:resultHandler]];
+				if (transactionError != nil) { return(transactionError); }
+
+				// Create new table
+				[db executeQuery:[OCSQLiteQuery query:@"CREATE TABLE httpConcurrencyLimits (pipelineID TEXT NOT NULL, partitionID TEXT NOT NULL, hostname TEXT NOT NULL, concurrencyLimit REAL NOT NULL, lastUpdated REAL NOT NULL, PRIMARY KEY (pipelineID, partitionID, hostname))" resultHandler:resultHandler]];
+				if (transactionError != nil) { return(transactionError); }
+
+				return (transactionError);
+
+			} type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+				completionHandler(error);
+			}]];
+		}]
+	];
 }
 
 #pragma mark - Task access
@@ -321,8 +377,9 @@ static NSString *OCHTTPPipelineTasksTableName = @"httpPipelineTasks";
 			insertionError = error;
 		}]];
 
-		// Update cache
+		// Update cache and index
 		[self->_taskCache updateWithTask:task remove:NO];
+		[self->_taskIndex updateWithTask:task remove:NO];
 
 		OCTLogVerbose(@[@"leave"], @"addPipelineTask: task.taskID=%@, error=%@, task=%@", task.taskID, insertionError, TaskDescription(task));
 
@@ -367,8 +424,9 @@ static NSString *OCHTTPPipelineTasksTableName = @"httpPipelineTasks";
 			updateError = error;
 		}]];
 
-		// Update cache
+		// Update cache and index
 		[self->_taskCache updateWithTask:task remove:NO];
+		[self->_taskIndex updateWithTask:task remove:NO];
 
 		if (updateError != nil)
 		{
@@ -398,8 +456,9 @@ static NSString *OCHTTPPipelineTasksTableName = @"httpPipelineTasks";
 			removeError = error;
 		}]];
 
-		// Remove from cache
+		// Remove from cache and index
 		[self->_taskCache updateWithTask:task remove:YES];
+		[self->_taskIndex updateWithTask:task remove:YES];
 
 		if (removeError != nil)
 		{
@@ -432,8 +491,9 @@ static NSString *OCHTTPPipelineTasksTableName = @"httpPipelineTasks";
 			removeError = error;
 		}]];
 
-		// Update cache
+		// Update cache and index
 		[self->_taskCache removeAllTasksForPipeline:pipelineID partition:partitionID];
+		[self->_taskIndex removeAllTasksForPipeline:pipelineID partition:partitionID];
 
 		OCTLogVerbose(@[@"leave"], @"removeAllTasksForPipeline: pipelineID=%@, partitionID=%@, removeError=%@", pipelineID, partitionID, removeError);
 
@@ -678,6 +738,69 @@ static NSString *OCHTTPPipelineTasksTableName = @"httpPipelineTasks";
 	return (numberOfRequests);
 }
 
+- (OCHTTPPipelineTaskIndex *)taskIndexForPipeline:(OCHTTPPipeline *)pipeline error:(NSError * _Nullable *)outDBError
+{
+	NSError *dbError = nil;
+	__block OCHTTPPipelineTaskIndex *taskIndex = nil;
+
+	dbError = [_sqlDB executeOperationSync:^NSError * _Nullable(OCSQLiteDB * _Nonnull db) {
+		__block NSError *retrieveError = nil;
+		__block NSNumber *dataVersion = nil;
+
+		// PRAGMA data_version changes whenever another connection (f.ex. in another process) commits changes to the database
+		[db executeQuery:[OCSQLiteQuery query:@"PRAGMA data_version" resultHandler:^(OCSQLiteDB * _Nonnull db, NSError * _Nullable error, OCSQLiteTransaction * _Nullable transaction, OCSQLiteResultSet * _Nullable resultSet) {
+			retrieveError = error;
+			dataVersion = (NSNumber *)[resultSet nextRowDictionaryWithError:&retrieveError][@"data_version"];
+		}]];
+
+		if (retrieveError != nil)
+		{
+			return (retrieveError);
+		}
+
+		if (OCNANotEqual(dataVersion, self->_taskIndexDataVersion))
+		{
+			// Database was changed from outside => drop index
+			if (self->_taskIndexDataVersion != nil)
+			{
+				OCLogDebug(@"Pipeline backend database changed externally (data_version %@ -> %@) - rebuilding task index", self->_taskIndexDataVersion, dataVersion);
+			}
+
+			[self->_taskIndex invalidate];
+			self->_taskIndexDataVersion = dataVersion;
+		}
+
+		if (![self->_taskIndex isIndexingPipeline:pipeline.identifier])
+		{
+			// (Re)build index for pipeline from pending and running tasks
+			NSMutableArray<OCHTTPPipelineTask *> *tasks = [NSMutableArray new];
+
+			if ((retrieveError = [self enumerateTasksWhere:@{
+				@"pipelineID" : pipeline.identifier,
+				@"state"      : [OCSQLiteQueryCondition queryConditionWithOperator:@"!=" value:@(OCHTTPPipelineTaskStateCompleted) apply:YES]
+			} orderBy:@"taskID" limit:nil enumerator:^(OCHTTPPipelineTask * _Nonnull task, BOOL * _Nonnull stop) {
+				[tasks addObject:task];
+			}]) != nil)
+			{
+				return (retrieveError);
+			}
+
+			[self->_taskIndex indexPipeline:pipeline.identifier withTasks:tasks];
+		}
+
+		taskIndex = self->_taskIndex;
+
+		return (nil);
+	}];
+
+	if (outDBError != NULL)
+	{
+		*outDBError = dbError;
+	}
+
+	return (taskIndex);
+}
+
 - (void)retrieveActionTrackingIDsForPartition:(OCHTTPPipelinePartitionID)partitionID resultHandler:(void (^)(NSError * _Nullable error, NSSet<OCActionTrackingID> * _Nullable trackingsIDs, NSNumber * _Nullable totalNumberOfRequestsInBackend))resultHandler
 {
 	__block NSMutableSet<OCActionTrackingID> *actionTrackingIDs = nil;
@@ -722,6 +845,53 @@ static NSString *OCHTTPPipelineTasksTableName = @"httpPipelineTasks";
 	];
 }
 
+#pragma mark - Concurrency limits
+- (NSError *)enumerateConcurrencyLimitsForPipeline:(OCHTTPPipelineID)pipelineID updatedSince:(NSDate *)date enumerator:(void(^)(OCHTTPPipelinePartitionID partitionID, NSString *hostname, double limit))limitEnumerator
+{
+	return([_sqlDB executeOperationSync:^NSError * _Nullable(OCSQLiteDB * _Nonnull db) {
+		__block NSError *retrieveError = nil;
+
+		// Drop outdated limits
+		[db executeQuery:[OCSQLiteQuery query:@"DELETE FROM httpConcurrencyLimits WHERE pipelineID=? AND lastUpdated < ?" withParameters:@[ pipelineID, @(date.timeIntervalSinceReferenceDate) ] resultHandler:nil]];
+
+		[db executeQuery:[OCSQLiteQuery query:@"SELECT partitionID, hostname, concurrencyLimit FROM httpConcurrencyLimits WHERE pipelineID=?" withParameters:@[ pipelineID ] resultHandler:^(OCSQLiteDB * _Nonnull db, NSError * _Nullable error, OCSQLiteTransaction * _Nullable transaction, OCSQLiteResultSet * _Nullable resultSet) {
+			if (error != nil)
+			{
+				retrieveError = error;
+				return;
+			}
+
+			[resultSet iterateUsing:^(OCSQLiteResultSet * _Nonnull resultSet, NSUInteger line, OCSQLiteRowDictionary  _Nonnull rowDictionary, BOOL * _Nonnull stop) {
+				OCHTTPPipelinePartitionID partitionID = OCTypedCast(rowDictionary[@"partitionID"], NSString);
+				NSString *hostname = OCTypedCast(rowDictionary[@"hostname"], NSString);
+				NSNumber *limit = OCTypedCast(rowDictionary[@"concurrencyLimit"], NSNumber);
+
+				if ((partitionID != nil) && (hostname != nil) && (limit != nil))
+				{
+					limitEnumerator(partitionID, hostname, limit.doubleValue);
+				}
+			} error:&retrieveError];
+		}]];
+
+		return (retrieveError);
+	}]);
+}
+
+- (void)setConcurrencyLimit:(double)limit forPipeline:(OCHTTPPipelineID)pipelineID partition:(OCHTTPPipelinePartitionID)partitionID hostname:(NSString *)hostname
+{
+	[_sqlDB executeQuery:[OCSQLiteQuery query:@"INSERT OR REPLACE INTO httpConcurrencyLimits (pipelineID, partitionID, hostname, concurrencyLimit, lastUpdated) VALUES (?, ?, ?, ?, ?)" withParameters:@[ pipelineID, partitionID, hostname, @(limit), @(NSDate.timeIntervalSinceReferenceDate) ] resultHandler:^(OCSQLiteDB * _Nonnull db, NSError * _Nullable error, OCSQLiteTransaction * _Nullable transaction, OCSQLiteResultSet * _Nullable resultSet) {
+		if (error != nil)
+		{
+			OCLogError(@"Error storing concurrency limit for pipeline %@, partition %@: %@", pipelineID, partitionID, error);
+		}
+	}]];
+}
+
+- (void)removeConcurrencyLimitsForPipeline:(OCHTTPPipelineID)pipelineID partition:(OCHTTPPipelinePartitionID)partitionID
+{
+	[_sqlDB executeQuery:[OCSQLiteQuery query:@"DELETE FROM httpConcurrencyLimits WHERE pipelineID=? AND partitionID=?" withParameters:@[ pipelineID, partitionID ] resultHandler:nil]];
+}
+
 - (BOOL)isOnQueueThread
 {
 	return _sqlDB.isOnSQLiteThread;
@@ -35,7 +35,7 @@ typedef void(^OCHTTPPipelineManagerRequestCompletionHandler)(OCHTTPPipeline * _N
 @property(strong,readonly,nonatomic) OCHTTPPipelineBackend *ephermalBackend; //!< Backend storing tasks in an in-memory SQLite db.
 
 #pragma mark - Set up persistent pipelines
-+ (void)setupPersistentPipelines; //!< Makes sure that the pipelines OCHTTPPipelineIDLocal and OCHTTPPipelineIDBackground stay around for the lifetime of the process.
++ (void)setupPersistentPipelines; //!< Makes sure that the pipelines OCHTTPPipelineIDLocal, OCHTTPPipelineIDForegroundTransfer and OCHTTPPipelineIDBackground stay around for the lifetime of the process.
 
 #pragma mark - Requesting and returning pipelines
 - (void)requestPipelineWithIdentifier:(OCHTTPPipelineID)pipelineID completionHandler:(OCHTTPPipelineManagerRequestCompletionHandler)completionHandler; //!< Request the pipeline with the provided identifier to start using it
@@ -56,5 +56,6 @@ typedef void(^OCHTTPPipelineManagerRequestCompletionHandler)(OCHTTPPipeline * _N
 extern OCHTTPPipelineID OCHTTPPipelineIDEphermal;   //!< The ID of the ephermal pipeline.   Uses an ephermal NSURLSession and an in-memory backend.
 extern OCHTTPPipelineID OCHTTPPipelineIDLocal;	    //!< The ID of the local pipeline. 	    Uses an ephermal NSURLSession and a persistent SQL backend.
 extern OCHTTPPipelineID OCHTTPPipelineIDBackground; //!< The ID of the background pipeline. Uses a background NSURLSession and a persistent SQL backend.
+extern OCHTTPPipelineID OCHTTPPipelineIDForegroundTransfer; //!< The ID of the foreground transfer pipeline. Uses an ephermal NSURLSession and a persistent SQL backend. Transfers that are streamed while the app is in the foreground use it, so they don't compete with commands for connections.
 
 NS_ASSUME_NONNULL_END
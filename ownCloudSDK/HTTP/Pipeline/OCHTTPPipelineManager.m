@@ -60,7 +60,7 @@
 	static dispatch_once_t onceToken;
 
 	dispatch_once(&onceToken, ^{
-		NSArray <OCHTTPPipelineID> *persistentPipelineIDs = @[ OCHTTPPipelineIDLocal, OCHTTPPipelineIDBackground ];
+		NSArray <OCHTTPPipelineID> *persistentPipelineIDs = @[ OCHTTPPipelineIDLocal, OCHTTPPipelineIDForegroundTransfer, OCHTTPPipelineIDBackground ];
 
 		for (OCHTTPPipelineID pipelineID in persistentPipelineIDs)
 		{
@@ -232,6 +232,7 @@
 	NSURLSessionConfiguration *sessionConfiguration = nil;
 
 	if ([pipelineID isEqual:OCHTTPPipelineIDLocal] ||
+	    [pipelineID isEqual:OCHTTPPipelineIDForegroundTransfer] ||
 	    [pipelineID isEqual:OCHTTPPipelineIDEphermal])
 	{
 		sessionConfiguration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
@@ -243,7 +244,8 @@
 		sessionConfiguration.shouldUseExtendedBackgroundIdleMode = YES;
 	}
 
-	if ([pipelineID isEqual:OCHTTPPipelineIDLocal])
+	if ([pipelineID isEqual:OCHTTPPipelineIDLocal] ||
+	    [pipelineID isEqual:OCHTTPPipelineIDForegroundTransfer])
 	{
 		backend = self.backend;
 	}
@@ -529,7 +531,7 @@
 			pipelineIDs = [[NSMutableSet alloc] initWithArray:self->_pipelineByIdentifier.allKeys];
 		}
 
-		[pipelineIDs addObjectsFromArray:@[OCHTTPPipelineIDLocal, OCHTTPPipelineIDEphermal, OCHTTPPipelineIDBackground]];
+		[pipelineIDs addObjectsFromArray:@[OCHTTPPipelineIDLocal, OCHTTPPipelineIDEphermal, OCHTTPPipelineIDForegroundTransfer, OCHTTPPipelineIDBackground]];
 
 		for (OCHTTPPipelineID pipelineID in pipelineIDs)
 		{
@@ -607,3 +609,4 @@
 OCHTTPPipelineID OCHTTPPipelineIDLocal = @"default";
 OCHTTPPipelineID OCHTTPPipelineIDEphermal = @"ephermal";
 OCHTTPPipelineID OCHTTPPipelineIDBackground = @"background";
+OCHTTPPipelineID OCHTTPPipelineIDForegroundTransfer = @"foregroundTransfer";
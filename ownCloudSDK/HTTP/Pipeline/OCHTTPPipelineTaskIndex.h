@@ -0,0 +1,65 @@
+//
+//  OCHTTPPipelineTaskIndex.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCHTTPTypes.h"
+
+@class OCHTTPPipelineTask;
+@class OCHTTPPipelineTaskIndexPipeline;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+	In-memory index of the pending and running tasks of pipelines, kept in sync by OCHTTPPipelineBackend, so that
+	the scheduler doesn't need to enumerate all tasks in the backend on every scheduling pass.
+
+	- running tasks are kept in order of their taskID
+	- pending tasks with a groupID are kept per group, in order of their taskID
+	- pending tasks without a groupID are kept in order of their request priority (highest first), then taskID
+	- counts of pending and running tasks are kept per partition
+
+	Completed tasks are not indexed.
+*/
+
+@interface OCHTTPPipelineTaskIndex : NSObject
+{
+	NSMutableDictionary<OCHTTPPipelineID, OCHTTPPipelineTaskIndexPipeline *> *_pipelinesByID;
+}
+
+#pragma mark - Index management
+- (BOOL)isIndexingPipeline:(OCHTTPPipelineID)pipelineID; //!< Returns YES if tasks of the pipeline are being indexed
+- (void)indexPipeline:(OCHTTPPipelineID)pipelineID withTasks:(NSArray<OCHTTPPipelineTask *> *)tasks; //!< Starts indexing the tasks of the pipeline, with tasks as initial content
+- (void)invalidate; //!< Drops the indexes of all pipelines (f.ex. after changes by other processes), so they need to be rebuilt before next use
+
+#pragma mark - Updates
+- (void)updateWithTask:(OCHTTPPipelineTask *)task remove:(BOOL)remove;
+- (void)removeAllTasksForPipeline:(OCHTTPPipelineID)pipelineID partition:(OCHTTPPipelinePartitionID)partitionID;
+
+#pragma mark - Queries
+- (NSUInteger)numberOfTasksWithState:(OCHTTPPipelineTaskState)state inPipeline:(OCHTTPPipelineID)pipelineID partition:(nullable OCHTTPPipelinePartitionID)partitionID; //!< Returns the number of pending or running tasks in the pipeline (and partition, if provided)
+
+- (NSArray<OCHTTPPipelineTask *> *)runningTasksForPipeline:(OCHTTPPipelineID)pipelineID;
+
+- (NSArray<OCHTTPRequestGroupID> *)groupIDsWithPendingTasksForPipeline:(OCHTTPPipelineID)pipelineID; //!< Returns the IDs of all groups with pending tasks. Pending tasks without a groupID are not included.
+- (BOOL)hasPendingTasksWithoutGroupForPipeline:(OCHTTPPipelineID)pipelineID;
+
+- (NSArray<OCHTTPPipelineTask *> *)pendingTasksForPipeline:(OCHTTPPipelineID)pipelineID groupID:(nullable OCHTTPRequestGroupID)groupID after:(nullable OCHTTPPipelineTask *)afterTask limit:(NSUInteger)limit; //!< Returns up to limit pending tasks of the group (or without group, if groupID is nil) in scheduling order, starting after afterTask (or at the beginning if afterTask is nil)
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,415 @@
+//
+//  OCHTTPPipelineTaskIndex.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCHTTPPipelineTaskIndex.h"
+#import "OCHTTPPipelineTask.h"
+#import "OCHTTPRequest.h"
+#import "OCMacros.h"
+
+#pragma mark - Entry
+@interface OCHTTPPipelineTaskIndexEntry : NSObject
+
+@property(strong) OCHTTPPipelineTask *task;
+
+@property(strong) OCHTTPPipelineTaskID taskID;
+@property(strong) OCHTTPPipelinePartitionID partitionID;
+@property(strong) OCHTTPRequestGroupID groupID;
+@property(assign) OCHTTPPipelineTaskState state;
+@property(assign) OCHTTPRequestPriority priority;
+
+@end
+
+@implementation OCHTTPPipelineTaskIndexEntry
+
+- (instancetype)initWithTask:(OCHTTPPipelineTask *)task
+{
+	if ((self = [super init]) != nil)
+	{
+		// Keep a copy of the values the entry is sorted by, so it can be located even after the task has been changed
+		_task = task;
+		_taskID = task.taskID;
+		_partitionID = task.partitionID;
+		_groupID = task.groupID;
+		_state = task.state;
+		_priority = (_groupID == nil) ? task.request.priority : 0; // Priority is only relevant for tasks without group
+	}
+
+	return (self);
+}
+
+@end
+
+static NSComparator OCHTTPPipelineTaskIndexTaskIDComparator = ^NSComparisonResult(OCHTTPPipelineTaskIndexEntry *entry1, OCHTTPPipelineTaskIndexEntry *entry2) {
+	return ([entry1.taskID compare:entry2.taskID]);
+};
+
+static NSComparator OCHTTPPipelineTaskIndexPriorityComparator = ^NSComparisonResult(OCHTTPPipelineTaskIndexEntry *entry1, OCHTTPPipelineTaskIndexEntry *entry2) {
+	if (entry1.priority != entry2.priority)
+	{
+		return ((entry1.priority > entry2.priority) ? NSOrderedAscending : NSOrderedDescending); // In reverse order, so highest value comes first
+	}
+
+	return ([entry1.taskID compare:entry2.taskID]);
+};
+
+#pragma mark - Pipeline index
+@interface OCHTTPPipelineTaskIndexPipeline : NSObject
+{
+	@public
+	NSMutableDictionary<OCHTTPPipelineTaskID, OCHTTPPipelineTaskIndexEntry *> *_entriesByTaskID;
+
+	NSMutableArray<OCHTTPPipelineTaskIndexEntry *> *_runningEntries;
+
+	NSMutableDictionary<OCHTTPRequestGroupID, NSMutableArray<OCHTTPPipelineTaskIndexEntry *> *> *_pendingEntriesByGroupID;
+	NSMutableArray<OCHTTPPipelineTaskIndexEntry *> *_pendingUngroupedEntries;
+
+	NSCountedSet<OCHTTPPipelinePartitionID> *_pendingPartitionIDs;
+	NSCountedSet<OCHTTPPipelinePartitionID> *_runningPartitionIDs;
+}
+@end
+
+@implementation OCHTTPPipelineTaskIndexPipeline
+
+- (instancetype)init
+{
+	if ((self = [super init]) != nil)
+	{
+		_entriesByTaskID = [NSMutableDictionary new];
+		_runningEntries = [NSMutableArray new];
+		_pendingEntriesByGroupID = [NSMutableDictionary new];
+		_pendingUngroupedEntries = [NSMutableArray new];
+		_pendingPartitionIDs = [NSCountedSet new];
+		_runningPartitionIDs = [NSCountedSet new];
+	}
+
+	return (self);
+}
+
+- (NSMutableArray<OCHTTPPipelineTaskIndexEntry *> *)_entriesForEntry:(OCHTTPPipelineTaskIndexEntry *)entry create:(BOOL)create comparator:(NSComparator *)outComparator
+{
+	NSMutableArray<OCHTTPPipelineTaskIndexEntry *> *entries = nil;
+
+	*outComparator = OCHTTPPipelineTaskIndexTaskIDComparator;
+
+	switch (entry.state)
+	{
+		case OCHTTPPipelineTaskStatePending:
+			if (entry.groupID != nil)
+			{
+				if (((entries = _pendingEntriesByGroupID[entry.groupID]) == nil) && create)
+				{
+					entries = [NSMutableArray new];
+					_pendingEntriesByGroupID[entry.groupID] = entries;
+				}
+			}
+			else
+			{
+				entries = _pendingUngroupedEntries;
+				*outComparator = OCHTTPPipelineTaskIndexPriorityComparator;
+			}
+		break;
+
+		case OCHTTPPipelineTaskStateRunning:
+			entries = _runningEntries;
+		break;
+
+		case OCHTTPPipelineTaskStateCompleted:
+		break;
+	}
+
+	return (entries);
+}
+
+- (void)addEntry:(OCHTTPPipelineTaskIndexEntry *)entry
+{
+	NSMutableArray<OCHTTPPipelineTaskIndexEntry *> *entries;
+	NSComparator comparator;
+
+	if ((entries = [self _entriesForEntry:entry create:YES comparator:&comparator]) != nil)
+	{
+		NSUInteger insertIndex = [entries indexOfObject:entry inSortedRange:NSMakeRange(0, entries.count) options:NSBinarySearchingInsertionIndex|NSBinarySearchingLastEqual usingComparator:comparator];
+
+		[entries insertObject:entry atIndex:insertIndex];
+
+		_entriesByTaskID[entry.taskID] = entry;
+
+		if (entry.state == OCHTTPPipelineTaskStatePending)
+		{
+			[_pendingPartitionIDs addObject:entry.partitionID];
+		}
+		else
+		{
+			[_runningPartitionIDs addObject:entry.partitionID];
+		}
+	}
+}
+
+- (void)removeEntry:(OCHTTPPipelineTaskIndexEntry *)entry
+{
+	NSMutableArray<OCHTTPPipelineTaskIndexEntry *> *entries;
+	NSComparator comparator;
+
+	if ((entries = [self _entriesForEntry:entry create:NO comparator:&comparator]) != nil)
+	{
+		NSUInteger entryIndex = [entries indexOfObject:entry inSortedRange:NSMakeRange(0, entries.count) options:NSBinarySearchingFirstEqual usingComparator:comparator];
+
+		if (entryIndex != NSNotFound)
+		{
+			[entries removeObjectAtIndex:entryIndex];
+		}
+
+		if ((entries.count == 0) && (entry.state == OCHTTPPipelineTaskStatePending) && (entry.groupID != nil))
+		{
+			[_pendingEntriesByGroupID removeObjectForKey:entry.groupID];
+		}
+
+		if (entry.state == OCHTTPPipelineTaskStatePending)
+		{
+			[_pendingPartitionIDs removeObject:entry.partitionID];
+		}
+		else
+		{
+			[_runningPartitionIDs removeObject:entry.partitionID];
+		}
+	}
+
+	[_entriesByTaskID removeObjectForKey:entry.taskID];
+}
+
+@end
+
+#pragma mark - Index
+@implementation OCHTTPPipelineTaskIndex
+
+- (instancetype)init
+{
+	if ((self = [super init]) != nil)
+	{
+		_pipelinesByID = [NSMutableDictionary new];
+	}
+
+	return (self);
+}
+
+#pragma mark - Index management
+- (BOOL)isIndexingPipeline:(OCHTTPPipelineID)pipelineID
+{
+	@synchronized(self)
+	{
+		return (_pipelinesByID[pipelineID] != nil);
+	}
+}
+
+- (void)indexPipeline:(OCHTTPPipelineID)pipelineID withTasks:(NSArray<OCHTTPPipelineTask *> *)tasks
+{
+	@synchronized(self)
+	{
+		_pipelinesByID[pipelineID] = [OCHTTPPipelineTaskIndexPipeline new];
+
+		for (OCHTTPPipelineTask *task in tasks)
+		{
+			[self updateWithTask:task remove:NO];
+		}
+	}
+}
+
+- (void)invalidate
+{
+	@synchronized(self)
+	{
+		[_pipelinesByID removeAllObjects];
+	}
+}
+
+#pragma mark - Updates
+- (void)updateWithTask:(OCHTTPPipelineTask *)task remove:(BOOL)remove
+{
+	OCHTTPPipelineTaskID taskID;
+
+	if (((taskID = task.taskID) == nil) || (task.pipelineID == nil) || (task.partitionID == nil))
+	{
+		return;
+	}
+
+	@synchronized(self)
+	{
+		OCHTTPPipelineTaskIndexPipeline *pipelineIndex;
+		OCHTTPPipelineTaskIndexEntry *existingEntry;
+
+		if ((pipelineIndex = _pipelinesByID[task.pipelineID]) == nil)
+		{
+			// Pipeline not indexed
+			return;
+		}
+
+		if ((existingEntry = pipelineIndex->_entriesByTaskID[taskID]) != nil)
+		{
+			if (!remove &&
+			    (existingEntry.task == task) &&
+			    (existingEntry.state == task.state) &&
+			    OCNAIsEqual(existingEntry.groupID, task.groupID))
+			{
+				// No change relevant to the index
+				return;
+			}
+
+			[pipelineIndex removeEntry:existingEntry];
+		}
+
+		if (!remove && (task.state != OCHTTPPipelineTaskStateCompleted))
+		{
+			[pipelineIndex addEntry:[[OCHTTPPipelineTaskIndexEntry alloc] initWithTask:task]];
+		}
+	}
+}
+
+- (void)removeAllTasksForPipeline:(OCHTTPPipelineID)pipelineID partition:(OCHTTPPipelinePartitionID)partitionID
+{
+	@synchronized(self)
+	{
+		OCHTTPPipelineTaskIndexPipeline *pipelineIndex;
+
+		if ((pipelineIndex = _pipelinesByID[pipelineID]) != nil)
+		{
+			for (OCHTTPPipelineTaskIndexEntry *entry in pipelineIndex->_entriesByTaskID.allValues)
+			{
+				if ([entry.partitionID isEqual:partitionID])
+				{
+					[pipelineIndex removeEntry:entry];
+				}
+			}
+		}
+	}
+}
+
+#pragma mark - Queries
+- (NSUInteger)numberOfTasksWithState:(OCHTTPPipelineTaskState)state inPipeline:(OCHTTPPipelineID)pipelineID partition:(nullable OCHTTPPipelinePartitionID)partitionID
+{
+	@synchronized(self)
+	{
+		OCHTTPPipelineTaskIndexPipeline *pipelineIndex;
+
+		if ((pipelineIndex = _pipelinesByID[pipelineID]) != nil)
+		{
+			switch (state)
+			{
+				case OCHTTPPipelineTaskStatePending:
+					if (partitionID != nil)
+					{
+						return ([pipelineIndex->_pendingPartitionIDs countForObject:partitionID]);
+					}
+
+					return (pipelineIndex->_entriesByTaskID.count - pipelineIndex->_runningEntries.count);
+				break;
+
+				case OCHTTPPipelineTaskStateRunning:
+					if (partitionID != nil)
+					{
+						return ([pipelineIndex->_runningPartitionIDs countForObject:partitionID]);
+					}
+
+					return (pipelineIndex->_runningEntries.count);
+				break;
+
+				case OCHTTPPipelineTaskStateCompleted:
+				break;
+			}
+		}
+	}
+
+	return (0);
+}
+
+- (NSArray<OCHTTPPipelineTask *> *)runningTasksForPipeline:(OCHTTPPipelineID)pipelineID
+{
+	@synchronized(self)
+	{
+		OCHTTPPipelineTaskIndexPipeline *pipelineIndex;
+
+		if ((pipelineIndex = _pipelinesByID[pipelineID]) != nil)
+		{
+			return ([pipelineIndex->_runningEntries valueForKey:@"task"]);
+		}
+	}
+
+	return (@[]);
+}
+
+- (NSArray<OCHTTPRequestGroupID> *)groupIDsWithPendingTasksForPipeline:(OCHTTPPipelineID)pipelineID
+{
+	@synchronized(self)
+	{
+		OCHTTPPipelineTaskIndexPipeline *pipelineIndex;
+
+		if ((pipelineIndex = _pipelinesByID[pipelineID]) != nil)
+		{
+			return (pipelineIndex->_pendingEntriesByGroupID.allKeys);
+		}
+	}
+
+	return (@[]);
+}
+
+- (BOOL)hasPendingTasksWithoutGroupForPipeline:(OCHTTPPipelineID)pipelineID
+{
+	@synchronized(self)
+	{
+		OCHTTPPipelineTaskIndexPipeline *pipelineIndex;
+
+		if ((pipelineIndex = _pipelinesByID[pipelineID]) != nil)
+		{
+			return (pipelineIndex->_pendingUngroupedEntries.count > 0);
+		}
+	}
+
+	return (NO);
+}
+
+- (NSArray<OCHTTPPipelineTask *> *)pendingTasksForPipeline:(OCHTTPPipelineID)pipelineID groupID:(nullable OCHTTPRequestGroupID)groupID after:(nullable OCHTTPPipelineTask *)afterTask limit:(NSUInteger)limit
+{
+	@synchronized(self)
+	{
+		OCHTTPPipelineTaskIndexPipeline *pipelineIndex;
+		NSArray<OCHTTPPipelineTaskIndexEntry *> *entries;
+		NSComparator comparator = (groupID != nil) ? OCHTTPPipelineTaskIndexTaskIDComparator : OCHTTPPipelineTaskIndexPriorityComparator;
+		NSUInteger startIndex = 0;
+
+		if (((pipelineIndex = _pipelinesByID[pipelineID]) == nil) ||
+		    ((entries = ((groupID != nil) ? pipelineIndex->_pendingEntriesByGroupID[groupID] : pipelineIndex->_pendingUngroupedEntries)) == nil))
+		{
+			return (@[]);
+		}
+
+		if (afterTask != nil)
+		{
+			// Continue after the position afterTask has (or would have) in the sorted entries - even if it has been removed in the meantime
+			OCHTTPPipelineTaskIndexEntry *afterEntry = [[OCHTTPPipelineTaskIndexEntry alloc] initWithTask:afterTask];
+
+			startIndex = [entries indexOfObject:afterEntry inSortedRange:NSMakeRange(0, entries.count) options:NSBinarySearchingInsertionIndex|NSBinarySearchingLastEqual usingComparator:comparator];
+		}
+
+		if (startIndex >= entries.count)
+		{
+			return (@[]);
+		}
+
+		return ([[entries subarrayWithRange:NSMakeRange(startIndex, MIN(limit, entries.count - startIndex))] valueForKey:@"task"]);
+	}
+}
+
+@end
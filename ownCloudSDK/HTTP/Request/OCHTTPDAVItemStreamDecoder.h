@@ -0,0 +1,73 @@
+//
+//  OCHTTPDAVItemStreamDecoder.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCHTTPTypes.h"
+#import "OCItem.h"
+#import "OCUser.h"
+#import "OCBookmark.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class OCHTTPDAVItemStreamDecoder;
+
+typedef void(^OCHTTPDAVItemStreamBatchHandler)(OCHTTPDAVItemStreamDecoder *decoder, NSArray<OCItem *> *items);
+
+/*
+	OCHTTPDAVItemStreamDecoder decodes a PROPFIND multistatus response into OCItems while the response is still being received,
+	delivering them in batches of .batchSize via the batchHandler. The response body is never buffered in full: only the
+	items of the current batch and the OCXMLParserNodes of the <d:response> currently being parsed are held in memory.
+
+	Parsing takes place on a private serial queue of the decoder, so that the stream thread feeding the response body into
+	the stream can continue to do so while the parser is waiting for data. Batches are delivered on that queue, too.
+*/
+
+@interface OCHTTPDAVItemStreamDecoder : NSObject
+
+@property(strong,nullable) NSString *basePath; //!< Base path of the WebDAV endpoint, used to derive item paths from <d:href>
+@property(strong,nullable) OCDriveID driveID; //!< Drive ID to set on all decoded items
+@property(strong,nullable) OCBookmarkUUIDString bookmarkUUIDString; //!< Bookmark UUID to set on all decoded items
+@property(strong,nullable) NSMutableDictionary<NSString *,OCUser *> *usersByUserID; //!< Dictionary to reuse OCUser instances from. Must not be shared with parsers running concurrently.
+
+@property(assign) NSUInteger batchSize; //!< Maximum number of items per batch. Defaults to 200.
+
+@property(copy,nullable) dispatch_block_t restartHandler; //!< Called by -decoderForRestartedResponse, after which all items will be delivered again from the start
+
+@property(strong,nullable,readonly) OCHTTPResponse *response; //!< The response the stream belongs to, if decoding via -streamHandler
+
+@property(readonly) NSUInteger itemCount; //!< Number of items decoded so far
+@property(strong,readonly,nullable) NSArray<NSError *> *errors; //!< Errors encountered while decoding (includes DAV errors contained in the response)
+@property(readonly) BOOL finished; //!< YES once decoding has finished and all batches have been delivered
+@property(readonly,getter=isCancelled) BOOL cancelled; //!< YES once -cancel has been called
+
+- (instancetype)initWithBasePath:(nullable NSString *)basePath batchHandler:(OCHTTPDAVItemStreamBatchHandler)batchHandler;
+
+- (OCHTTPRequestEphermalStreamHandler)streamHandler; //!< Returns a stream handler suitable for use as OCHTTPRequest.ephermalStreamHandler
+
+- (void)decodeStream:(NSInputStream *)inputStream; //!< Starts asynchronous decoding of inputStream. Can only be called once.
+- (void)finishWithoutStream; //!< Marks the decoder as finished if no stream was received (f.ex. due to an empty response body)
+
+- (void)cancel; //!< Aborts decoding at the next parsed element. No further batches will be delivered once this method returns.
+
+- (instancetype)decoderForRestartedResponse; //!< Cancels the receiver and returns a new decoder with the same configuration and handlers, for use with a rescheduled request. Calls .restartHandler, so items delivered so far can be discarded.
+
+- (void)notifyWhenFinished:(dispatch_block_t)finishedHandler; //!< Calls finishedHandler once the decoder has finished (immediately, if it is already finished)
+
+@end
+
+NS_ASSUME_NONNULL_END
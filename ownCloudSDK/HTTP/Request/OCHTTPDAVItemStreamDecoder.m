@@ -0,0 +1,310 @@
+//
+//  OCHTTPDAVItemStreamDecoder.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCHTTPDAVItemStreamDecoder.h"
+#import "OCXMLParser.h"
+#import "OCLogger.h"
+#import "NSError+OCError.h"
+
+@interface OCHTTPDAVItemStreamDecoder ()
+{
+	OCHTTPDAVItemStreamBatchHandler _batchHandler;
+
+	dispatch_queue_t _parseQueue;
+
+	NSMutableArray<OCItem *> *_batchItems;
+	NSMutableArray<NSError *> *_errors;
+
+	NSMutableArray<dispatch_block_t> *_finishedHandlers;
+
+	BOOL _started;
+}
+@end
+
+@implementation OCHTTPDAVItemStreamDecoder
+
+- (instancetype)initWithBasePath:(NSString *)basePath batchHandler:(OCHTTPDAVItemStreamBatchHandler)batchHandler
+{
+	if ((self = [super init]) != nil)
+	{
+		_basePath = basePath;
+		_batchHandler = [batchHandler copy];
+		_batchSize = 200;
+
+		_usersByUserID = [NSMutableDictionary new];
+
+		_batchItems = [NSMutableArray new];
+		_finishedHandlers = [NSMutableArray new];
+
+		_parseQueue = dispatch_queue_create("OCHTTPDAVItemStreamDecoder", DISPATCH_QUEUE_SERIAL_WITH_AUTORELEASE_POOL);
+	}
+
+	return (self);
+}
+
+#pragma mark - Stream handler
+- (OCHTTPRequestEphermalStreamHandler)streamHandler
+{
+	__weak OCHTTPDAVItemStreamDecoder *weakSelf = self;
+
+	return (^(OCHTTPRequest *request, OCHTTPResponse * _Nullable response, NSInputStream * _Nullable inputStream, NSError * _Nullable error) {
+		OCHTTPDAVItemStreamDecoder *strongSelf;
+
+		if ((strongSelf = weakSelf) != nil)
+		{
+			if (inputStream != nil)
+			{
+				// First call: response body stream is available
+				strongSelf->_response = response;
+				[strongSelf decodeStream:inputStream];
+			}
+			else
+			{
+				// Last call: stream has been closed. If no stream was ever received (f.ex. because the body was empty), finish right away.
+				[strongSelf finishWithoutStream];
+			}
+		}
+	});
+}
+
+#pragma mark - Decoding
+- (void)decodeStream:(NSInputStream *)inputStream
+{
+	@synchronized(self)
+	{
+		if (_started)
+		{
+			OCLogError(@"Attempt to decode more than one stream with the same decoder");
+			return;
+		}
+
+		_started = YES;
+	}
+
+	dispatch_async(_parseQueue, ^{
+		OCXMLParser *parser;
+
+		if ((parser = [[OCXMLParser alloc] initWithParser:[[NSXMLParser alloc] initWithStream:inputStream]]) != nil)
+		{
+			NSMutableDictionary<NSString *,id> *options = [NSMutableDictionary new];
+
+			options[@"basePath"] = self.basePath;
+			options[@"usersByUserID"] = self.usersByUserID;
+
+			parser.options = options;
+
+			parser.parsedObjectStreamConsumer = ^(OCXMLParser *parser, NSError *error, id parsedObject) {
+				if (self.isCancelled)
+				{
+					[parser abort];
+					return;
+				}
+
+				if (error != nil)
+				{
+					[self _addError:error];
+				}
+
+				if (parsedObject != nil)
+				{
+					[self _addItem:(OCItem *)parsedObject];
+				}
+			};
+
+			[parser addObjectCreationClasses:@[ [OCItem class], [NSError class] ]];
+
+			if (![parser parse] && !self.isCancelled)
+			{
+				OCLogDebug(@"Streamed PROPFIND parsing ended with error(s): %@", self.errors);
+			}
+
+			parser.parsedObjectStreamConsumer = nil;
+		}
+
+		// Deliver remaining items
+		[self _flushBatch];
+
+		[self _finish];
+	});
+}
+
+- (void)finishWithoutStream
+{
+	@synchronized(self)
+	{
+		if (_started)
+		{
+			// Decoding in progress - will finish on its own
+			return;
+		}
+
+		_started = YES;
+	}
+
+	dispatch_async(_parseQueue, ^{
+		[self _finish];
+	});
+}
+
+- (void)cancel
+{
+	@synchronized(self)
+	{
+		_cancelled = YES;
+	}
+}
+
+- (instancetype)decoderForRestartedResponse
+{
+	OCHTTPDAVItemStreamDecoder *decoder = [[OCHTTPDAVItemStreamDecoder alloc] initWithBasePath:_basePath batchHandler:_batchHandler];
+
+	decoder.driveID = _driveID;
+	decoder.bookmarkUUIDString = _bookmarkUUIDString;
+	decoder.batchSize = _batchSize;
+	decoder.restartHandler = _restartHandler;
+
+	// Make sure no further batches are delivered by the receiver before notifying the restart
+	[self cancel];
+
+	if (_restartHandler != nil)
+	{
+		_restartHandler();
+	}
+
+	return (decoder);
+}
+
+- (BOOL)isCancelled
+{
+	@synchronized(self)
+	{
+		return (_cancelled);
+	}
+}
+
+- (NSUInteger)itemCount
+{
+	@synchronized(self)
+	{
+		return (_itemCount);
+	}
+}
+
+- (NSArray<NSError *> *)errors
+{
+	@synchronized(self)
+	{
+		return ([_errors copy]);
+	}
+}
+
+- (void)_addError:(NSError *)error
+{
+	@synchronized(self)
+	{
+		if (_errors == nil)
+		{
+			_errors = [NSMutableArray new];
+		}
+
+		[_errors addObject:error];
+	}
+}
+
+- (void)_addItem:(OCItem *)item
+{
+	if (_driveID != nil)
+	{
+		item.driveID = _driveID;
+	}
+
+	if (_bookmarkUUIDString != nil)
+	{
+		item.bookmarkUUID = _bookmarkUUIDString;
+	}
+
+	[_batchItems addObject:item];
+
+	@synchronized(self)
+	{
+		_itemCount++;
+	}
+
+	if (_batchItems.count >= _batchSize)
+	{
+		[self _flushBatch];
+	}
+}
+
+- (void)_flushBatch
+{
+	if (_batchItems.count > 0)
+	{
+		NSArray<OCItem *> *batchItems = _batchItems;
+
+		_batchItems = [NSMutableArray new];
+
+		// Deliver while holding the lock, so that -cancel only returns once no batch is being delivered anymore
+		@synchronized(self)
+		{
+			if (!_cancelled && (_batchHandler != nil))
+			{
+				_batchHandler(self, batchItems);
+			}
+		}
+	}
+}
+
+#pragma mark - Finish
+- (void)_finish
+{
+	NSArray<dispatch_block_t> *finishedHandlers = nil;
+
+	@synchronized(self)
+	{
+		_finished = YES;
+
+		finishedHandlers = _finishedHandlers;
+		_finishedHandlers = nil;
+	}
+
+	for (dispatch_block_t finishedHandler in finishedHandlers)
+	{
+		finishedHandler();
+	}
+}
+
+- (void)notifyWhenFinished:(dispatch_block_t)finishedHandler
+{
+	BOOL finished = NO;
+
+	@synchronized(self)
+	{
+		if (!(finished = _finished))
+		{
+			[_finishedHandlers addObject:[finishedHandler copy]];
+		}
+	}
+
+	if (finished)
+	{
+		finishedHandler();
+	}
+}
+
+@end
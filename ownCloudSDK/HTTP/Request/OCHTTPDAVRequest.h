@@ -23,6 +23,7 @@
 #import "OCItem.h"
 #import "OCUser.h"
 #import "OCDrive.h"
+#import "OCHTTPDAVItemStreamDecoder.h"
 
 typedef NS_ENUM(NSInteger, OCPropfindDepth) {
 	OCPropfindDepthInfinity = -1,
@@ -45,6 +46,8 @@ typedef NS_ENUM(NSInteger, OCPropfindDepth) {
 
 @property(strong) OCXMLNode *xmlRequest;
 
+@property(strong) OCHTTPDAVItemStreamDecoder *itemStreamDecoder; //!< Decoder decoding the response body into items as it is received. Ephermal [not serialized].
+
 + (instancetype)propfindRequestWithURL:(NSURL *)url depth:(OCPropfindDepth)depth;
 + (instancetype)proppatchRequestWithURL:(NSURL *)url content:(NSArray <OCXMLNode *> *)contentNodes;
 + (instancetype)reportRequestWithURL:(NSURL *)url rootElementName:(NSString *)rootElementName content:(NSArray <OCXMLNode *> *)contentNodes;
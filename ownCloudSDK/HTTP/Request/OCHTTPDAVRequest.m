@@ -91,6 +91,18 @@
 	return (_bodyData);
 }
 
+- (void)scrubForRescheduling
+{
+	[super scrubForRescheduling];
+
+	if (_itemStreamDecoder != nil)
+	{
+		// Decode the response of the rescheduled request from the start
+		_itemStreamDecoder = [_itemStreamDecoder decoderForRestartedResponse];
+		self.ephermalStreamHandler = _itemStreamDecoder.streamHandler;
+	}
+}
+
 - (NSArray <OCItem *> *)responseItemsForBasePath:(NSString *)basePath drives:(NSArray<OCDrive *> *)drives reuseUsersByID:(NSMutableDictionary<NSString *,OCUser *> *)usersByUserID driveID:(nullable OCDriveID)driveID withErrors:(NSArray <NSError *> **)errors
 {
 	NSArray <OCItem *> *responseItems = nil;
@@ -0,0 +1,46 @@
+//
+//  OCHTTPRangedFileStream.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+	Streams a byte range of a file, without copying it to an intermediate file first.
+
+	The range is read in chunks on OCHTTPRequest.sharedStreamThread and written into a bound stream pair, whose
+	buffer (readAheadSize) determines how much data is read ahead of the consumer. If readAheadSize is larger than
+	zero, the file system is also advised to prefetch the next chunk while the current one is being consumed.
+
+	The instance keeps itself alive until the range has been written completely, an error occurred or -close is called.
+	Consumers that stop reading early (f.ex. because a request was cancelled) must therefore call -close.
+*/
+
+@interface OCHTTPRangedFileStream : NSObject <NSStreamDelegate>
+
+@property(class,readonly,nonatomic) NSUInteger defaultReadAheadSize; //!< Default read-ahead size (256 KB)
+
++ (nullable instancetype)streamForFileURL:(NSURL *)fileURL range:(NSRange)range readAheadSize:(NSUInteger)readAheadSize error:(NSError * _Nullable * _Nullable)outError; //!< Returns a new stream providing the bytes [range.location, range.location+range.length) of the file at fileURL via .inputStream. Returns nil if the file can't be opened or the range exceeds the file's size.
+
+@property(strong,readonly) NSInputStream *inputStream; //!< The (unopened) input stream to hand to the consumer
+
+- (void)close; //!< Stops feeding .inputStream and closes the file
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,261 @@
+//
+//  OCHTTPRangedFileStream.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <fcntl.h>
+#import <unistd.h>
+#import <sys/stat.h>
+
+#import "OCHTTPRangedFileStream.h"
+#import "OCHTTPRequest+Stream.h"
+#import "NSError+OCError.h"
+#import "OCLogger.h"
+
+#define OCHTTPRangedFileStreamChunkSize (64 * 1024)
+
+@interface OCHTTPRangedFileStream ()
+{
+	int _fd;
+
+	off_t _readPosition;	//!< Position in the file to read the next chunk from
+	off_t _endPosition;	//!< Position in the file after the last byte of the range
+
+	NSUInteger _readAheadSize;
+
+	NSOutputStream *_outputStream;
+
+	uint8_t *_chunkBuffer;
+	NSUInteger _chunkLength;
+	NSUInteger _chunkOffset;
+
+	OCHTTPRangedFileStream *_retainedSelf; //!< Keeps the instance alive for as long as it feeds the output stream
+}
+@end
+
+@implementation OCHTTPRangedFileStream
+
++ (NSUInteger)defaultReadAheadSize
+{
+	return (256 * 1024);
+}
+
++ (nullable instancetype)streamForFileURL:(NSURL *)fileURL range:(NSRange)range readAheadSize:(NSUInteger)readAheadSize error:(NSError * _Nullable * _Nullable)outError
+{
+	OCHTTPRangedFileStream *rangedStream;
+	NSInputStream *inputStream = nil;
+	NSOutputStream *outputStream = nil;
+	NSError *error = nil;
+
+	if ((rangedStream = [[self alloc] initWithFileURL:fileURL range:range readAheadSize:readAheadSize error:&error]) == nil)
+	{
+		if (outError != NULL)
+		{
+			*outError = error;
+		}
+
+		return (nil);
+	}
+
+	// The bound stream pair's buffer holds the data read ahead of the consumer
+	[NSStream getBoundStreamsWithBufferSize:MAX(readAheadSize, OCHTTPRangedFileStreamChunkSize) inputStream:&inputStream outputStream:&outputStream];
+
+	rangedStream->_inputStream = inputStream;
+
+	[rangedStream _startWritingTo:outputStream];
+
+	return (rangedStream);
+}
+
+- (nullable instancetype)initWithFileURL:(NSURL *)fileURL range:(NSRange)range readAheadSize:(NSUInteger)readAheadSize error:(NSError **)outError
+{
+	if ((self = [super init]) != nil)
+	{
+		struct stat fileInfo;
+
+		if ((_fd = open(fileURL.fileSystemRepresentation, O_RDONLY)) < 0)
+		{
+			*outError = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+			OCLogError(@"Error opening %@ for ranged reading: %@", fileURL, *outError);
+			return (nil);
+		}
+
+		if ((fstat(_fd, &fileInfo) != 0) || (fileInfo.st_size < (off_t)(range.location + range.length)))
+		{
+			*outError = OCError(OCErrorInvalidParameter);
+			OCLogError(@"Range %@ exceeds size of %@ (%lld bytes)", NSStringFromRange(range), fileURL, (long long)fileInfo.st_size);
+
+			close(_fd);
+			_fd = -1;
+
+			return (nil);
+		}
+
+		_readPosition = (off_t)range.location;
+		_endPosition = (off_t)(range.location + range.length);
+		_readAheadSize = readAheadSize;
+
+		_chunkBuffer = malloc(OCHTTPRangedFileStreamChunkSize);
+
+		#ifdef F_RDAHEAD
+		// Enable read-ahead by the file system if requested - or disable it, as the file is read only once
+		fcntl(_fd, F_RDAHEAD, (readAheadSize > 0) ? 1 : 0);
+		#endif /* F_RDAHEAD */
+	}
+
+	return (self);
+}
+
+- (void)dealloc
+{
+	[self _closeFile];
+
+	if (_chunkBuffer != NULL)
+	{
+		free(_chunkBuffer);
+		_chunkBuffer = NULL;
+	}
+}
+
+#pragma mark - Writing
+- (void)_startWritingTo:(NSOutputStream *)outputStream
+{
+	_outputStream = outputStream;
+	_retainedSelf = self;
+
+	[OCHTTPRequest.sharedStreamThread dispatchBlockToRunLoopAsync:^{
+		outputStream.delegate = self;
+		[outputStream scheduleInRunLoop:NSRunLoop.currentRunLoop forMode:NSDefaultRunLoopMode];
+		[outputStream open];
+	}];
+}
+
+- (void)close
+{
+	// Performed after writing was started, as blocks are run on the stream thread in the order they were dispatched
+	[OCHTTPRequest.sharedStreamThread dispatchBlockToRunLoopAsync:^{
+		[self _finish];
+	}];
+}
+
+- (void)stream:(NSStream *)stream handleEvent:(NSStreamEvent)eventCode
+{
+	switch (eventCode)
+	{
+		case NSStreamEventHasSpaceAvailable:
+			[self _writeAvailable];
+		break;
+
+		case NSStreamEventErrorOccurred:
+		case NSStreamEventEndEncountered:
+			// Consumer closed the stream (f.ex. because the request was cancelled)
+			[self _finish];
+		break;
+
+		default:
+		break;
+	}
+}
+
+- (BOOL)_readNextChunk
+{
+	NSUInteger readLength = (NSUInteger)MIN((off_t)OCHTTPRangedFileStreamChunkSize, _endPosition - _readPosition);
+	ssize_t bytesRead;
+
+	if (readLength == 0)
+	{
+		return (NO);
+	}
+
+	if ((bytesRead = pread(_fd, _chunkBuffer, readLength, _readPosition)) <= 0)
+	{
+		OCLogError(@"Error reading %lu bytes at %lld: %d (%s)", (unsigned long)readLength, (long long)_readPosition, errno, strerror(errno));
+		return (NO);
+	}
+
+	_readPosition += bytesRead;
+	_chunkLength = (NSUInteger)bytesRead;
+	_chunkOffset = 0;
+
+	#ifdef F_RDADVISE
+	if ((_readAheadSize > 0) && (_readPosition < _endPosition))
+	{
+		// Advise the file system to prefetch the next chunk while this one is consumed
+		struct radvisory advisory = {
+			.ra_offset = _readPosition,
+			.ra_count = (int)MIN((off_t)OCHTTPRangedFileStreamChunkSize, _endPosition - _readPosition)
+		};
+
+		fcntl(_fd, F_RDADVISE, &advisory);
+	}
+	#endif /* F_RDADVISE */
+
+	return (YES);
+}
+
+- (void)_writeAvailable
+{
+	while (_outputStream.hasSpaceAvailable)
+	{
+		NSInteger bytesWritten;
+
+		if (_chunkOffset >= _chunkLength)
+		{
+			if (![self _readNextChunk])
+			{
+				// Range completely written - or reading failed, in which case the consumer will receive fewer bytes than announced
+				[self _finish];
+				return;
+			}
+		}
+
+		if ((bytesWritten = [_outputStream write:&_chunkBuffer[_chunkOffset] maxLength:(_chunkLength - _chunkOffset)]) <= 0)
+		{
+			break;
+		}
+
+		_chunkOffset += bytesWritten;
+	}
+}
+
+- (void)_finish
+{
+	if (_outputStream != nil)
+	{
+		NSOutputStream *outputStream = _outputStream;
+
+		_outputStream = nil;
+
+		outputStream.delegate = nil;
+		[outputStream close];
+		[outputStream removeFromRunLoop:NSRunLoop.currentRunLoop forMode:NSDefaultRunLoopMode];
+	}
+
+	[self _closeFile];
+
+	_retainedSelf = nil;
+}
+
+- (void)_closeFile
+{
+	if (_fd >= 0)
+	{
+		close(_fd);
+		_fd = -1;
+	}
+}
+
+@end
@@ -21,6 +21,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class OCHTTPRangedFileStream;
+
 @interface OCHTTPRequest (Stream)
 
 @property(readonly,class,nonatomic) OCRunLoopThread *sharedStreamThread; //!< RunLoop Thread for scheduling of read and write streams for streaming responses
@@ -30,6 +32,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)handleResponseStreamData:(nullable NSData *)data forPipelineTask:(OCHTTPPipelineTask *)pipelineTask;
 - (void)closeResponseStreamWithError:(nullable NSError *)error forPipelineTask:(OCHTTPPipelineTask *)pipelineTask;
 
+- (nullable OCHTTPRangedFileStream *)bodyURLRangeStreamWithError:(NSError * _Nullable * _Nullable)outError; //!< Returns a new stream for the .bodyURLRange of .bodyURL, or nil if .bodyURLRange is empty or the stream could not be created. The stream must be closed once the request has finished.
+
 @end
 
 NS_ASSUME_NONNULL_END
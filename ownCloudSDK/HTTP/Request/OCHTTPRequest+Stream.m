@@ -18,6 +18,7 @@
 
 #import "OCHTTPRequest+Stream.h"
 #import "OCHTTPPipelineTask.h"
+#import "OCHTTPRangedFileStream.h"
 
 @implementation OCHTTPRequest (Stream)
 
@@ -118,4 +119,15 @@
 	}
 }
 
+#pragma mark - Request body
+- (OCHTTPRangedFileStream *)bodyURLRangeStreamWithError:(NSError **)outError
+{
+	if ((self.bodyURL == nil) || (self.bodyURLRange.length == 0))
+	{
+		return (nil);
+	}
+
+	return ([OCHTTPRangedFileStream streamForFileURL:self.bodyURL range:self.bodyURLRange readAheadSize:self.bodyURLReadAheadSize error:outError]);
+}
+
 @end
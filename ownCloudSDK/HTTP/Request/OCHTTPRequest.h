@@ -82,6 +82,8 @@ typedef NSDictionary<OCHTTPRequestResumeInfoKey,id>* OCHTTPRequestResumeInfo;
 @property(strong) OCHTTPHeaderFields headerFields;//!< The HTTP headerfields to send alongside the request
 @property(strong,nonatomic) NSData *bodyData;		//!< The HTTP body to send (as body data). Ignored / overwritten if .method is POST and .parameters has key-value pairs.
 @property(strong) NSURL *bodyURL;			//!< The HTTP body to send (from a file). Ignored if .method is POST and .parameters has key-value pairs.
+@property(assign) NSRange bodyURLRange;			//!< If .length > 0, only this byte range of .bodyURL is sent as HTTP body - streamed straight from the file, without intermediate copies. Not supported by pipelines backed by background sessions.
+@property(assign) NSUInteger bodyURLReadAheadSize;	//!< Number of bytes to read ahead of the consumer when streaming .bodyURLRange. Defaults to OCHTTPRangedFileStream.defaultReadAheadSize. Use 0 to disable read-ahead.
 
 @property(strong) OCAuthenticationDataID authenticationDataID; //!< The ID of the authentication data that was used for the authentication parts of the request.
 
@@ -198,6 +200,9 @@ extern OCHTTPHeaderFieldName OCHTTPHeaderFieldNameOverwrite;
 extern OCHTTPHeaderFieldName OCHTTPHeaderFieldNamePrefer;
 extern OCHTTPHeaderFieldName OCHTTPHeaderFieldNameIfMatch;
 extern OCHTTPHeaderFieldName OCHTTPHeaderFieldNameIfNoneMatch;
+extern OCHTTPHeaderFieldName OCHTTPHeaderFieldNameIfRange;
+extern OCHTTPHeaderFieldName OCHTTPHeaderFieldNameRange;
+extern OCHTTPHeaderFieldName OCHTTPHeaderFieldNameContentRange;
 extern OCHTTPHeaderFieldName OCHTTPHeaderFieldNameUserAgent;
 extern OCHTTPHeaderFieldName OCHTTPHeaderFieldNameCookie;
 extern OCHTTPHeaderFieldName OCHTTPHeaderFieldNameSetCookie;
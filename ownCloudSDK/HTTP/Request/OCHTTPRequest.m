@@ -23,6 +23,7 @@
 #import "OCMacros.h"
 #import "OCConnection.h"
 #import "NSDictionary+OCFormEncoding.h"
+#import "OCHTTPRangedFileStream.h"
 
 @implementation OCHTTPRequest
 
@@ -39,6 +40,8 @@
 
 		_maximumRedirectionDepth = 5;
 
+		_bodyURLReadAheadSize = OCHTTPRangedFileStream.defaultReadAheadSize;
+
 		self.method = OCHTTPMethodGET;
 	
 		self.headerFields = [[NSMutableDictionary alloc] initWithObjectsAndKeys:
@@ -299,6 +302,12 @@
 		// Apply body
 		if (_bodyURL != nil)
 		{
+			if (_bodyURLRange.length > 0)
+			{
+				// The body stream for the range is supplied through -[OCHTTPRequest bodyURLRangeStreamWithError:] from the URLSession:task:needNewBodyStream: delegate method
+				[urlRequest setValue:[NSString stringWithFormat:@"%lu", (unsigned long)_bodyURLRange.length] forHTTPHeaderField:OCHTTPHeaderFieldNameContentLength];
+			}
+
 			// Mitigate error "The request of a upload task should not contain a body or a body stream, use `uploadTask(with:fromFile:)` or supply the body stream through the `urlSession(_:needNewBodyStreamForTask:)` delegate method."
 			/*
 			if ((_bodyURLInputStream = [[NSInputStream alloc] initWithURL:_bodyURL]) != nil)
@@ -324,6 +333,13 @@
 	_httpResponse = nil;
 	_effectiveURL = nil;
 
+	@synchronized(self)
+	{
+		// Streamed responses of rescheduled requests need a new stream pair
+		_streamingResponseBodyInputStream = nil;
+		_streamingResponseBodyOutputStream = nil;
+	}
+
 	if (_downloadRequest)
 	{
 		if (_downloadedFileURL != nil)
@@ -603,7 +619,12 @@
 	{
 		[requestDescription appendFormat:@"%@Content-Length: %lu\n", headPrefix, (unsigned long)_bodyData.length];
 	}
-	if (_bodyURL != nil)
+	if ((_bodyURL != nil) && (_bodyURLRange.length > 0))
+	{
+		[requestDescription appendFormat:@"%@Content-Length: %lu\n", headPrefix, (unsigned long)_bodyURLRange.length];
+		[requestDescription appendFormat:@"%@[Body Range: %lu-%lu]\n", infoPrefix, (unsigned long)_bodyURLRange.location, (unsigned long)NSMaxRange(_bodyURLRange)-1];
+	}
+	else if (_bodyURL != nil)
 	{
 		NSNumber *fileSize = nil;
 		if ([_bodyURL getResourceValue:&fileSize forKey:NSURLFileSizeKey error:NULL])
@@ -652,6 +673,8 @@
 		self.parameters 	= [decoder decodeObjectOfClasses:[[NSSet alloc] initWithObjects:NSMutableDictionary.class, NSString.class, nil] forKey:@"parameters"];
 		self.bodyData 		= [decoder decodeObjectOfClass:[NSData class] forKey:@"bodyData"];
 		self.bodyURL 		= [decoder decodeObjectOfClass:[NSURL class] forKey:@"bodyURL"];
+		self.bodyURLRange	= NSMakeRange((NSUInteger)[decoder decodeInt64ForKey:@"bodyURLRangeLocation"], (NSUInteger)[decoder decodeInt64ForKey:@"bodyURLRangeLength"]);
+		self.bodyURLReadAheadSize = [decoder containsValueForKey:@"bodyURLReadAheadSize"] ? (NSUInteger)[decoder decodeInt64ForKey:@"bodyURLReadAheadSize"] : OCHTTPRangedFileStream.defaultReadAheadSize;
 
 		self.authenticationDataID = [decoder decodeObjectOfClass:NSString.class forKey:@"authenticationDataID"];
 
@@ -711,6 +734,9 @@
 	[coder encodeObject:_headerFields 	forKey:@"headerFields"];
 	[coder encodeObject:_bodyData 		forKey:@"bodyData"];
 	[coder encodeObject:_bodyURL 		forKey:@"bodyURL"];
+	[coder encodeInt64:(int64_t)_bodyURLRange.location	forKey:@"bodyURLRangeLocation"];
+	[coder encodeInt64:(int64_t)_bodyURLRange.length	forKey:@"bodyURLRangeLength"];
+	[coder encodeInt64:(int64_t)_bodyURLReadAheadSize	forKey:@"bodyURLReadAheadSize"];
 
 	[coder encodeObject:_authenticationDataID forKey:@"authenticationDataID"];
 
@@ -781,6 +807,9 @@ OCHTTPHeaderFieldName OCHTTPHeaderFieldNameOverwrite = @"Overwrite";
 OCHTTPHeaderFieldName OCHTTPHeaderFieldNamePrefer = @"Prefer";
 OCHTTPHeaderFieldName OCHTTPHeaderFieldNameIfMatch = @"If-Match";
 OCHTTPHeaderFieldName OCHTTPHeaderFieldNameIfNoneMatch = @"If-None-Match";
+OCHTTPHeaderFieldName OCHTTPHeaderFieldNameIfRange = @"If-Range";
+OCHTTPHeaderFieldName OCHTTPHeaderFieldNameRange = @"Range";
+OCHTTPHeaderFieldName OCHTTPHeaderFieldNameContentRange = @"Content-Range";
 OCHTTPHeaderFieldName OCHTTPHeaderFieldNameUserAgent = @"User-Agent";
 OCHTTPHeaderFieldName OCHTTPHeaderFieldNameCookie = @"Cookie";
 OCHTTPHeaderFieldName OCHTTPHeaderFieldNameSetCookie = @"Set-Cookie";
@@ -48,6 +48,7 @@ typedef NS_ENUM(NSUInteger, OCHTTPStatusCode)
 	OCHTTPStatusCodePAYLOAD_TOO_LARGE = 413,
 	OCHTTPStatusCodeLOCKED = 423,
 	OCHTTPStatusCodeTOO_EARLY = 425,
+	OCHTTPStatusCodeTOO_MANY_REQUESTS = 429,
 
 	// Server Error (5xx)
 	OCHTTPStatusCodeINTERNAL_SERVER_ERROR = 500,
@@ -159,6 +159,10 @@
 		case OCHTTPStatusCodeTOO_EARLY:
 			return (@"TOO EARLY");
 		break;
+
+		case OCHTTPStatusCodeTOO_MANY_REQUESTS:
+			return (@"TOO MANY REQUESTS");
+		break;
 	}
 
 	return (@(_code).stringValue);
@@ -53,6 +53,7 @@ typedef NS_ENUM(NSInteger, OCUserType) {
 @property(nullable,strong) NSString *emailAddress; //!< Email address of the user (f.ex. "jappleseed@owncloud.org")
 
 @property(nonatomic,readonly) BOOL isRemote; //!< Returns YES if the userName contains an @ sign
+@property(nullable,readonly,strong) NSNumber *forceIsRemote; //!< Explicitly provided remote status (see +userWithUserName:displayName:isRemote:), nil if derived from the userName
 @property(nullable,readonly) NSString *remoteUserName; //!< Returns the part before the @ sign for usernames containing an @ sign (nil otherwise)
 @property(nullable,readonly) NSString *remoteHost; //!< Returns the part after the @ sign for usernames containing an @ sign (nil otherwise)
 
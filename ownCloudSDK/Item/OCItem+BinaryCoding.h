@@ -0,0 +1,47 @@
+//
+//  OCItem+BinaryCoding.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCItem.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+	Compact binary encoding of OCItem, used for storing items in the database.
+
+	Format: "OCIB" magic, a version byte, followed by a sequence of tagged fields. Each field starts with a varint tag
+	((fieldID << 3) | wireType), followed by its value:
+	- varint: unsigned LEB128 integer (signed values are zigzag-encoded)
+	- double: 8 bytes, little endian
+	- bytes: varint length, followed by the bytes (UTF-8 for strings, nested fields for sub-structures)
+	- table string: varint index into a fixed, append-only table of common strings (MIME types, checksum algorithms, ..)
+
+	Fields not known to a decoder are skipped, so fields can be added without bumping the version. Rarely accessed
+	fields (checksums, fileClaim, remoteItem, localAttributes) are stored in a trailing section that is only decoded
+	on first access to any of them.
+*/
+
+@interface OCItem (BinaryCoding)
+
++ (BOOL)isBinaryEncodedData:(NSData *)data; //!< Returns YES if data starts with the magic of the binary encoding
++ (nullable instancetype)itemFromBinaryEncodedData:(NSData *)data; //!< Decodes an item from binary encoded data. Returns nil if the data is not valid.
+
+- (NSData *)binaryEncodedData; //!< Returns the binary encoding of the item
+
+@end
+
+NS_ASSUME_NONNULL_END
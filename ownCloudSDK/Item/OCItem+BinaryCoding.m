@@ -0,0 +1,1128 @@
+//
+//  OCItem+BinaryCoding.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCItem+BinaryCoding.h"
+#import "OCItem+Internal.h"
+#import "OCChecksum.h"
+#import "OCUser.h"
+#import "OCClaim.h"
+#import "OCMacros.h"
+#import "OCLogger.h"
+
+#define OCItemBinaryCodingMagicLength	4
+#define OCItemBinaryCodingHeaderLength	(OCItemBinaryCodingMagicLength + 1)
+#define OCItemBinaryCodingVersion	1
+
+static const uint8_t OCItemBinaryCodingMagic[OCItemBinaryCodingMagicLength] = { 'O', 'C', 'I', 'B' };
+
+typedef NS_ENUM(uint8_t, OCItemBinaryWireType)
+{
+	OCItemBinaryWireTypeVarint = 0,
+	OCItemBinaryWireTypeDouble = 1,
+	OCItemBinaryWireTypeBytes = 2,
+	OCItemBinaryWireTypeTableString = 3
+};
+
+// Field IDs - must never be changed or reused, only appended
+typedef NS_ENUM(uint32_t, OCItemBinaryField)
+{
+	OCItemBinaryFieldType = 1,
+	OCItemBinaryFieldMIMEType = 2,
+	OCItemBinaryFieldPermissions = 3,
+	OCItemBinaryFieldLocalRelativePath = 4,
+	OCItemBinaryFieldLocallyModified = 5,
+	OCItemBinaryFieldLocalCopyVersionIdentifier = 6,
+	OCItemBinaryFieldDownloadTriggerIdentifier = 8,
+
+	OCItemBinaryFieldPath = 11,
+	OCItemBinaryFieldParentLocalID = 12,
+	OCItemBinaryFieldLocalID = 13,
+	OCItemBinaryFieldDriveID = 14,
+	OCItemBinaryFieldParentFileID = 16,
+	OCItemBinaryFieldFileID = 17,
+	OCItemBinaryFieldETag = 18,
+
+	OCItemBinaryFieldActiveSyncRecordIDs = 19,
+	OCItemBinaryFieldSyncActivity = 20,
+	OCItemBinaryFieldSyncActivityCounts = 21,
+
+	OCItemBinaryFieldSize = 22,
+	OCItemBinaryFieldCreationDate = 23,
+	OCItemBinaryFieldLastModified = 24,
+	OCItemBinaryFieldLastUsed = 25,
+	OCItemBinaryFieldIsFavorite = 26,
+	OCItemBinaryFieldState = 27,
+
+	OCItemBinaryFieldLocalAttributesLastModified = 29,
+	OCItemBinaryFieldShareTypesMask = 30,
+	OCItemBinaryFieldOwner = 31,
+	OCItemBinaryFieldPrivateLink = 32,
+	OCItemBinaryFieldTUSInfo = 33,
+	OCItemBinaryFieldDatabaseID = 34,
+	OCItemBinaryFieldQuotaBytesRemaining = 35,
+	OCItemBinaryFieldQuotaBytesUsed = 36,
+	OCItemBinaryFieldVersionSeed = 37,
+
+	OCItemBinaryFieldLazySection = 40
+};
+
+// Sub-fields of OCItemBinaryFieldLocalCopyVersionIdentifier
+typedef NS_ENUM(uint32_t, OCItemBinaryVersionIdentifierField)
+{
+	OCItemBinaryVersionIdentifierFieldFileID = 1,
+	OCItemBinaryVersionIdentifierFieldETag = 2
+};
+
+// Sub-fields of OCItemBinaryFieldOwner
+typedef NS_ENUM(uint32_t, OCItemBinaryOwnerField)
+{
+	OCItemBinaryOwnerFieldUserName = 1,
+	OCItemBinaryOwnerFieldDisplayName = 2,
+	OCItemBinaryOwnerFieldEmailAddress = 3,
+	OCItemBinaryOwnerFieldType = 4,
+	OCItemBinaryOwnerFieldIdentifier = 5,
+	OCItemBinaryOwnerFieldForceIsRemote = 6
+};
+
+// Sub-fields of OCItemBinaryFieldLazySection
+typedef NS_ENUM(uint32_t, OCItemBinaryLazyField)
+{
+	OCItemBinaryLazyFieldChecksum = 1,	// repeated, nested OCItemBinaryChecksumField
+	OCItemBinaryLazyFieldFileClaim = 2,	// keyed archive
+	OCItemBinaryLazyFieldRemoteItem = 3,	// nested binary encoded item
+	OCItemBinaryLazyFieldLocalAttributes = 4 // keyed archive
+};
+
+typedef NS_ENUM(uint32_t, OCItemBinaryChecksumField)
+{
+	OCItemBinaryChecksumFieldAlgorithm = 1,
+	OCItemBinaryChecksumFieldChecksum = 2
+};
+
+#pragma mark - String table
+// Table of common strings that are encoded by index. Append-only: indexes are part of the format.
+static NSArray<NSString *> *OCItemBinaryStringTable(void)
+{
+	static dispatch_once_t onceToken;
+	static NSArray<NSString *> *stringTable;
+
+	dispatch_once(&onceToken, ^{
+		stringTable = @[
+			@"", // Index 0 - unused
+
+			// Download triggers
+			@"user",
+			@"availableOffline",
+
+			// Checksum algorithms
+			@"SHA1",
+			@"MD5",
+			@"ADLER32",
+
+			// MIME types
+			@"httpd/unix-directory",
+			@"application/octet-stream",
+			@"text/plain",
+			@"text/html",
+			@"text/markdown",
+			@"text/csv",
+			@"text/calendar",
+			@"text/vcard",
+			@"image/jpeg",
+			@"image/png",
+			@"image/gif",
+			@"image/heic",
+			@"image/heif",
+			@"image/webp",
+			@"image/tiff",
+			@"image/bmp",
+			@"image/svg+xml",
+			@"video/mp4",
+			@"video/quicktime",
+			@"video/x-msvideo",
+			@"video/webm",
+			@"audio/mpeg",
+			@"audio/mp4",
+			@"audio/x-wav",
+			@"audio/ogg",
+			@"application/pdf",
+			@"application/zip",
+			@"application/x-tar",
+			@"application/gzip",
+			@"application/x-7z-compressed",
+			@"application/json",
+			@"application/xml",
+			@"application/javascript",
+			@"application/rtf",
+			@"application/msword",
+			@"application/vnd.ms-excel",
+			@"application/vnd.ms-powerpoint",
+			@"application/vnd.openxmlformats-officedocument.wordprocessingml.document",
+			@"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet",
+			@"application/vnd.openxmlformats-officedocument.presentationml.presentation",
+			@"application/vnd.oasis.opendocument.text",
+			@"application/vnd.oasis.opendocument.spreadsheet",
+			@"application/vnd.oasis.opendocument.presentation",
+			@"application/vnd.apple.pages",
+			@"application/vnd.apple.numbers",
+			@"application/vnd.apple.keynote",
+			@"application/epub+zip",
+
+			// Checksum algorithms (appended)
+			@"SHA3-256"
+		];
+	});
+
+	return (stringTable);
+}
+
+static NSDictionary<NSString *, NSNumber *> *OCItemBinaryStringTableIndexes(void)
+{
+	static dispatch_once_t onceToken;
+	static NSDictionary<NSString *, NSNumber *> *stringTableIndexes;
+
+	dispatch_once(&onceToken, ^{
+		NSArray<NSString *> *stringTable = OCItemBinaryStringTable();
+		NSMutableDictionary<NSString *, NSNumber *> *indexes = [NSMutableDictionary new];
+
+		for (NSUInteger idx=1; idx < stringTable.count; idx++)
+		{
+			indexes[stringTable[idx]] = @(idx);
+		}
+
+		stringTableIndexes = indexes;
+	});
+
+	return (stringTableIndexes);
+}
+
+#pragma mark - String interning
+// Strings with low cardinality (MIME types, drive IDs, owners) are interned, so that decoding many items doesn't create as many identical string instances
+#define OCItemBinaryInternedStringsMaximumCount 4096
+
+static NSString *OCItemBinaryInternedString(const uint8_t *bytes, size_t length)
+{
+	static dispatch_once_t onceToken;
+	static NSMutableDictionary<NSString *, NSString *> *internedStrings;
+	NSString *lookupString, *internedString = nil;
+
+	dispatch_once(&onceToken, ^{
+		internedStrings = [NSMutableDictionary new];
+	});
+
+	if ((lookupString = [[NSString alloc] initWithBytesNoCopy:(void *)bytes length:length encoding:NSUTF8StringEncoding freeWhenDone:NO]) == nil)
+	{
+		return (nil);
+	}
+
+	@synchronized(internedStrings)
+	{
+		if ((internedString = internedStrings[lookupString]) == nil)
+		{
+			// lookupString references the decoded data without copying it, so a real copy has to be made
+			internedString = [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+
+			if (internedStrings.count < OCItemBinaryInternedStringsMaximumCount)
+			{
+				internedStrings[internedString] = internedString;
+			}
+		}
+	}
+
+	return (internedString);
+}
+
+#pragma mark - Writer
+typedef struct
+{
+	uint8_t *bytes;
+	size_t length;
+	size_t capacity;
+} OCItemBinaryWriter;
+
+static void OCItemBinaryWriterReserve(OCItemBinaryWriter *writer, size_t additionalLength)
+{
+	if ((writer->length + additionalLength) > writer->capacity)
+	{
+		size_t newCapacity = (writer->capacity < 256) ? 256 : (writer->capacity * 2);
+
+		while (newCapacity < (writer->length + additionalLength))
+		{
+			newCapacity *= 2;
+		}
+
+		writer->bytes = reallocf(writer->bytes, newCapacity);
+		writer->capacity = newCapacity;
+	}
+}
+
+static NSData *OCItemBinaryWriterFinish(OCItemBinaryWriter *writer)
+{
+	NSData *data = [[NSData alloc] initWithBytesNoCopy:writer->bytes length:writer->length freeWhenDone:YES];
+
+	writer->bytes = NULL;
+	writer->length = 0;
+	writer->capacity = 0;
+
+	return (data);
+}
+
+static void OCItemBinaryWriteVarint(OCItemBinaryWriter *writer, uint64_t value)
+{
+	OCItemBinaryWriterReserve(writer, 10);
+
+	while (value >= 0x80)
+	{
+		writer->bytes[writer->length++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+
+	writer->bytes[writer->length++] = (uint8_t)value;
+}
+
+static void OCItemBinaryWriteRaw(OCItemBinaryWriter *writer, const void *bytes, size_t length)
+{
+	if (length == 0)
+	{
+		// Nothing to copy - bytes may be NULL, f.ex. for an empty nested writer
+		return;
+	}
+
+	OCItemBinaryWriterReserve(writer, length);
+	memcpy(&writer->bytes[writer->length], bytes, length);
+	writer->length += length;
+}
+
+static void OCItemBinaryWriteTag(OCItemBinaryWriter *writer, uint32_t field, OCItemBinaryWireType wireType)
+{
+	OCItemBinaryWriteVarint(writer, (((uint64_t)field) << 3) | wireType);
+}
+
+static void OCItemBinaryWriteUInt(OCItemBinaryWriter *writer, uint32_t field, uint64_t value)
+{
+	OCItemBinaryWriteTag(writer, field, OCItemBinaryWireTypeVarint);
+	OCItemBinaryWriteVarint(writer, value);
+}
+
+static void OCItemBinaryWriteInt(OCItemBinaryWriter *writer, uint32_t field, int64_t value)
+{
+	OCItemBinaryWriteUInt(writer, field, (((uint64_t)value) << 1) ^ (uint64_t)(value >> 63)); // zigzag
+}
+
+static void OCItemBinaryWriteDouble(OCItemBinaryWriter *writer, uint32_t field, double value)
+{
+	uint64_t bits;
+
+	memcpy(&bits, &value, sizeof(bits));
+	bits = OSSwapHostToLittleInt64(bits);
+
+	OCItemBinaryWriteTag(writer, field, OCItemBinaryWireTypeDouble);
+	OCItemBinaryWriteRaw(writer, &bits, sizeof(bits));
+}
+
+static void OCItemBinaryWriteBytes(OCItemBinaryWriter *writer, uint32_t field, const void *bytes, size_t length)
+{
+	OCItemBinaryWriteTag(writer, field, OCItemBinaryWireTypeBytes);
+	OCItemBinaryWriteVarint(writer, length);
+	OCItemBinaryWriteRaw(writer, bytes, length);
+}
+
+static void OCItemBinaryWriteData(OCItemBinaryWriter *writer, uint32_t field, NSData *data)
+{
+	if (data != nil)
+	{
+		OCItemBinaryWriteBytes(writer, field, data.bytes, data.length);
+	}
+}
+
+static void OCItemBinaryWriteString(OCItemBinaryWriter *writer, uint32_t field, NSString *string)
+{
+	NSNumber *tableIndex;
+
+	if (string == nil)
+	{
+		return;
+	}
+
+	if ((tableIndex = OCItemBinaryStringTableIndexes()[string]) != nil)
+	{
+		OCItemBinaryWriteTag(writer, field, OCItemBinaryWireTypeTableString);
+		OCItemBinaryWriteVarint(writer, tableIndex.unsignedIntegerValue);
+	}
+	else
+	{
+		NSUInteger length = [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+
+		OCItemBinaryWriteTag(writer, field, OCItemBinaryWireTypeBytes);
+		OCItemBinaryWriteVarint(writer, length);
+		OCItemBinaryWriterReserve(writer, length);
+
+		[string getBytes:&writer->bytes[writer->length] maxLength:length usedLength:&length encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, string.length) remainingRange:NULL];
+
+		writer->length += length;
+	}
+}
+
+static void OCItemBinaryWriteNested(OCItemBinaryWriter *writer, uint32_t field, OCItemBinaryWriter *nestedWriter)
+{
+	OCItemBinaryWriteBytes(writer, field, nestedWriter->bytes, nestedWriter->length);
+
+	free(nestedWriter->bytes);
+	nestedWriter->bytes = NULL;
+	nestedWriter->length = 0;
+	nestedWriter->capacity = 0;
+}
+
+#pragma mark - Reader
+typedef struct
+{
+	const uint8_t *position;
+	const uint8_t *end;
+	BOOL failed;
+} OCItemBinaryReader;
+
+typedef struct
+{
+	uint32_t field;
+	OCItemBinaryWireType wireType;
+
+	uint64_t varint;
+	double doubleValue;
+	const uint8_t *bytes;
+	size_t length;
+} OCItemBinaryValue;
+
+static uint64_t OCItemBinaryReadVarint(OCItemBinaryReader *reader)
+{
+	uint64_t value = 0;
+	uint8_t shift = 0;
+
+	while (reader->position < reader->end)
+	{
+		uint8_t byte = *(reader->position++);
+
+		value |= ((uint64_t)(byte & 0x7F)) << shift;
+
+		if ((byte & 0x80) == 0)
+		{
+			return (value);
+		}
+
+		if ((shift += 7) > 63)
+		{
+			break;
+		}
+	}
+
+	reader->failed = YES;
+
+	return (0);
+}
+
+static BOOL OCItemBinaryReadValue(OCItemBinaryReader *reader, OCItemBinaryValue *value)
+{
+	uint64_t tag;
+
+	if (reader->failed || (reader->position >= reader->end))
+	{
+		return (NO);
+	}
+
+	tag = OCItemBinaryReadVarint(reader);
+
+	value->varint = 0;
+	value->doubleValue = 0;
+	value->bytes = NULL;
+	value->length = 0;
+
+	value->field = (uint32_t)(tag >> 3);
+	value->wireType = (OCItemBinaryWireType)(tag & 0x07);
+
+	switch (value->wireType)
+	{
+		case OCItemBinaryWireTypeVarint:
+		case OCItemBinaryWireTypeTableString:
+			value->varint = OCItemBinaryReadVarint(reader);
+		break;
+
+		case OCItemBinaryWireTypeDouble: {
+			uint64_t bits;
+
+			if ((reader->end - reader->position) < (ptrdiff_t)sizeof(bits))
+			{
+				reader->failed = YES;
+				break;
+			}
+
+			memcpy(&bits, reader->position, sizeof(bits));
+			bits = OSSwapLittleToHostInt64(bits);
+			memcpy(&value->doubleValue, &bits, sizeof(bits));
+
+			reader->position += sizeof(bits);
+		}
+		break;
+
+		case OCItemBinaryWireTypeBytes:
+			value->length = (size_t)OCItemBinaryReadVarint(reader);
+
+			if (reader->failed || (value->length > (size_t)(reader->end - reader->position)))
+			{
+				reader->failed = YES;
+				break;
+			}
+
+			value->bytes = reader->position;
+			reader->position += value->length;
+		break;
+
+		default:
+			// Unknown wire types can't be skipped
+			reader->failed = YES;
+		break;
+	}
+
+	return (!reader->failed);
+}
+
+static OCItemBinaryReader OCItemBinaryNestedReader(OCItemBinaryValue *value)
+{
+	return ((OCItemBinaryReader){ .position = value->bytes, .end = value->bytes + value->length, .failed = NO });
+}
+
+static NSString *OCItemBinaryValueString(OCItemBinaryValue *value, BOOL intern)
+{
+	switch (value->wireType)
+	{
+		case OCItemBinaryWireTypeBytes:
+			if (intern)
+			{
+				return (OCItemBinaryInternedString(value->bytes, value->length));
+			}
+
+			return ([[NSString alloc] initWithBytes:value->bytes length:value->length encoding:NSUTF8StringEncoding]);
+		break;
+
+		case OCItemBinaryWireTypeTableString: {
+			NSArray<NSString *> *stringTable = OCItemBinaryStringTable();
+
+			if ((value->varint > 0) && (value->varint < stringTable.count))
+			{
+				return (stringTable[(NSUInteger)value->varint]);
+			}
+		}
+		break;
+
+		default:
+		break;
+	}
+
+	return (nil);
+}
+
+static int64_t OCItemBinaryValueInt(OCItemBinaryValue *value)
+{
+	return ((int64_t)(value->varint >> 1) ^ -(int64_t)(value->varint & 1)); // zigzag
+}
+
+static NSDate *OCItemBinaryValueDate(OCItemBinaryValue *value)
+{
+	return ((value->wireType == OCItemBinaryWireTypeDouble) ? [[NSDate alloc] initWithTimeIntervalSinceReferenceDate:value->doubleValue] : nil);
+}
+
+static id OCItemBinaryValueUnarchivedObject(OCItemBinaryValue *value)
+{
+	if (value->wireType == OCItemBinaryWireTypeBytes)
+	{
+		return ([NSKeyedUnarchiver unarchiveObjectWithData:[[NSData alloc] initWithBytesNoCopy:(void *)value->bytes length:value->length freeWhenDone:NO]]);
+	}
+
+	return (nil);
+}
+
+@implementation OCItem (BinaryCoding)
+
+#pragma mark - Detection
++ (BOOL)isBinaryEncodedData:(NSData *)data
+{
+	return ((data.length >= OCItemBinaryCodingHeaderLength) && (memcmp(data.bytes, OCItemBinaryCodingMagic, OCItemBinaryCodingMagicLength) == 0));
+}
+
+#pragma mark - Encoding
+- (NSData *)binaryEncodedData
+{
+	OCItemBinaryWriter writer = { NULL, 0, 0 };
+	NSData *pendingLazyBinaryFields;
+	OCItemVersionIdentifier *localCopyVersionIdentifier;
+	NSArray<OCSyncRecordID> *activeSyncRecordIDs;
+	NSCountedSet<NSNumber *> *syncActivityCounts;
+	OCUser *owner;
+	NSNumber *databaseID;
+
+	OCItemBinaryWriterReserve(&writer, 512);
+
+	OCItemBinaryWriteRaw(&writer, OCItemBinaryCodingMagic, OCItemBinaryCodingMagicLength);
+	OCItemBinaryWriteVarint(&writer, OCItemBinaryCodingVersion);
+
+	// Eagerly decoded fields
+	OCItemBinaryWriteUInt(&writer, OCItemBinaryFieldType, (uint64_t)self.type);
+	OCItemBinaryWriteString(&writer, OCItemBinaryFieldMIMEType, self.mimeType);
+	OCItemBinaryWriteUInt(&writer, OCItemBinaryFieldPermissions, (uint64_t)self.permissions);
+
+	OCItemBinaryWriteString(&writer, OCItemBinaryFieldLocalRelativePath, self.localRelativePath);
+
+	if (self.locallyModified)
+	{
+		OCItemBinaryWriteUInt(&writer, OCItemBinaryFieldLocallyModified, 1);
+	}
+
+	if ((localCopyVersionIdentifier = self.localCopyVersionIdentifier) != nil)
+	{
+		OCItemBinaryWriter nestedWriter = { NULL, 0, 0 };
+
+		OCItemBinaryWriteString(&nestedWriter, OCItemBinaryVersionIdentifierFieldFileID, localCopyVersionIdentifier.fileID);
+		OCItemBinaryWriteString(&nestedWriter, OCItemBinaryVersionIdentifierFieldETag, localCopyVersionIdentifier.eTag);
+
+		OCItemBinaryWriteNested(&writer, OCItemBinaryFieldLocalCopyVersionIdentifier, &nestedWriter);
+	}
+
+	OCItemBinaryWriteString(&writer, OCItemBinaryFieldDownloadTriggerIdentifier, self.downloadTriggerIdentifier);
+
+	OCItemBinaryWriteString(&writer, OCItemBinaryFieldPath, self.path);
+	OCItemBinaryWriteString(&writer, OCItemBinaryFieldParentLocalID, self.parentLocalID);
+	OCItemBinaryWriteString(&writer, OCItemBinaryFieldLocalID, self.localID);
+	OCItemBinaryWriteString(&writer, OCItemBinaryFieldDriveID, self.driveID);
+	OCItemBinaryWriteString(&writer, OCItemBinaryFieldParentFileID, self.parentFileID);
+	OCItemBinaryWriteString(&writer, OCItemBinaryFieldFileID, self.fileID);
+	OCItemBinaryWriteString(&writer, OCItemBinaryFieldETag, self.eTag);
+
+	if ((activeSyncRecordIDs = self.activeSyncRecordIDs) != nil)
+	{
+		// Packed zigzag varints (an empty field represents an empty array)
+		OCItemBinaryWriter nestedWriter = { NULL, 0, 0 };
+
+		for (OCSyncRecordID syncRecordID in activeSyncRecordIDs)
+		{
+			int64_t value = syncRecordID.longLongValue;
+
+			OCItemBinaryWriteVarint(&nestedWriter, (((uint64_t)value) << 1) ^ (uint64_t)(value >> 63));
+		}
+
+		OCItemBinaryWriteNested(&writer, OCItemBinaryFieldActiveSyncRecordIDs, &nestedWriter);
+	}
+
+	OCItemBinaryWriteUInt(&writer, OCItemBinaryFieldSyncActivity, (uint64_t)self.syncActivity);
+
+	if ((syncActivityCounts = self.syncActivityCounts) != nil)
+	{
+		// Packed (activity, count) varint pairs
+		OCItemBinaryWriter nestedWriter = { NULL, 0, 0 };
+
+		for (NSNumber *activity in syncActivityCounts)
+		{
+			OCItemBinaryWriteVarint(&nestedWriter, activity.unsignedLongLongValue);
+			OCItemBinaryWriteVarint(&nestedWriter, [syncActivityCounts countForObject:activity]);
+		}
+
+		OCItemBinaryWriteNested(&writer, OCItemBinaryFieldSyncActivityCounts, &nestedWriter);
+	}
+
+	OCItemBinaryWriteInt(&writer, OCItemBinaryFieldSize, self.size);
+
+	if (self.creationDate != nil)
+	{
+		OCItemBinaryWriteDouble(&writer, OCItemBinaryFieldCreationDate, self.creationDate.timeIntervalSinceReferenceDate);
+	}
+
+	if (self.lastModified != nil)
+	{
+		OCItemBinaryWriteDouble(&writer, OCItemBinaryFieldLastModified, self.lastModified.timeIntervalSinceReferenceDate);
+	}
+
+	if (self.lastUsed != nil)
+	{
+		OCItemBinaryWriteDouble(&writer, OCItemBinaryFieldLastUsed, self.lastUsed.timeIntervalSinceReferenceDate);
+	}
+
+	if (self.isFavorite != nil)
+	{
+		OCItemBinaryWriteUInt(&writer, OCItemBinaryFieldIsFavorite, self.isFavorite.boolValue ? 1 : 0);
+	}
+
+	OCItemBinaryWriteUInt(&writer, OCItemBinaryFieldState, (uint64_t)self.state);
+
+	if (self.localAttributesLastModified != 0)
+	{
+		OCItemBinaryWriteDouble(&writer, OCItemBinaryFieldLocalAttributesLastModified, self.localAttributesLastModified);
+	}
+
+	OCItemBinaryWriteUInt(&writer, OCItemBinaryFieldShareTypesMask, (uint64_t)self.shareTypesMask);
+
+	if ((owner = self.owner) != nil)
+	{
+		OCItemBinaryWriter nestedWriter = { NULL, 0, 0 };
+
+		OCItemBinaryWriteString(&nestedWriter, OCItemBinaryOwnerFieldUserName, owner.userName);
+		OCItemBinaryWriteString(&nestedWriter, OCItemBinaryOwnerFieldDisplayName, owner.displayName);
+		OCItemBinaryWriteString(&nestedWriter, OCItemBinaryOwnerFieldEmailAddress, owner.emailAddress);
+		OCItemBinaryWriteUInt(&nestedWriter, OCItemBinaryOwnerFieldType, (uint64_t)owner.type);
+		OCItemBinaryWriteString(&nestedWriter, OCItemBinaryOwnerFieldIdentifier, owner.identifier);
+
+		if (owner.forceIsRemote != nil)
+		{
+			OCItemBinaryWriteUInt(&nestedWriter, OCItemBinaryOwnerFieldForceIsRemote, owner.forceIsRemote.boolValue ? 1 : 0);
+		}
+
+		OCItemBinaryWriteNested(&writer, OCItemBinaryFieldOwner, &nestedWriter);
+	}
+
+	OCItemBinaryWriteString(&writer, OCItemBinaryFieldPrivateLink, self.privateLink.absoluteString);
+
+	OCItemBinaryWriteUInt(&writer, OCItemBinaryFieldTUSInfo, self.tusInfo);
+
+	if ((databaseID = OCTypedCast(self.databaseID, NSNumber)) != nil)
+	{
+		OCItemBinaryWriteInt(&writer, OCItemBinaryFieldDatabaseID, databaseID.longLongValue);
+	}
+	else if (self.databaseID != nil)
+	{
+		OCLogWarning(@"Binary coding does not support databaseID %@ - it will not be encoded", self.databaseID);
+	}
+
+	if (self.quotaBytesRemaining != nil)
+	{
+		OCItemBinaryWriteInt(&writer, OCItemBinaryFieldQuotaBytesRemaining, self.quotaBytesRemaining.longLongValue);
+	}
+
+	if (self.quotaBytesUsed != nil)
+	{
+		OCItemBinaryWriteInt(&writer, OCItemBinaryFieldQuotaBytesUsed, self.quotaBytesUsed.longLongValue);
+	}
+
+	OCItemBinaryWriteInt(&writer, OCItemBinaryFieldVersionSeed, self.versionSeed);
+
+	// Lazily decoded fields
+	if ((pendingLazyBinaryFields = self.pendingLazyBinaryFields) != nil)
+	{
+		// Lazy fields have not been decoded yet and therefore are unchanged - pass them through as-is
+		OCItemBinaryWriteData(&writer, OCItemBinaryFieldLazySection, pendingLazyBinaryFields);
+	}
+	else
+	{
+		OCItemBinaryWriter lazyWriter = { NULL, 0, 0 };
+		NSDictionary<OCLocalAttribute, id> *localAttributes;
+		OCClaim *fileClaim;
+		OCItem *remoteItem;
+
+		for (OCChecksum *checksum in self.checksums)
+		{
+			OCItemBinaryWriter checksumWriter = { NULL, 0, 0 };
+
+			OCItemBinaryWriteString(&checksumWriter, OCItemBinaryChecksumFieldAlgorithm, checksum.algorithmIdentifier);
+			OCItemBinaryWriteString(&checksumWriter, OCItemBinaryChecksumFieldChecksum, checksum.checksum);
+
+			OCItemBinaryWriteNested(&lazyWriter, OCItemBinaryLazyFieldChecksum, &checksumWriter);
+		}
+
+		if ((fileClaim = self.fileClaim) != nil)
+		{
+			OCItemBinaryWriteData(&lazyWriter, OCItemBinaryLazyFieldFileClaim, [NSKeyedArchiver archivedDataWithRootObject:fileClaim]);
+		}
+
+		if ((remoteItem = self.remoteItem) != nil)
+		{
+			OCItemBinaryWriteData(&lazyWriter, OCItemBinaryLazyFieldRemoteItem, remoteItem.binaryEncodedData);
+		}
+
+		if (((localAttributes = self.localAttributes) != nil) && (localAttributes.count > 0))
+		{
+			OCItemBinaryWriteData(&lazyWriter, OCItemBinaryLazyFieldLocalAttributes, [NSKeyedArchiver archivedDataWithRootObject:localAttributes]);
+		}
+
+		if (lazyWriter.length > 0)
+		{
+			OCItemBinaryWriteNested(&writer, OCItemBinaryFieldLazySection, &lazyWriter);
+		}
+		else
+		{
+			free(lazyWriter.bytes);
+		}
+	}
+
+	return (OCItemBinaryWriterFinish(&writer));
+}
+
+#pragma mark - Decoding
++ (instancetype)itemFromBinaryEncodedData:(NSData *)data
+{
+	OCItemBinaryReader reader;
+	OCItemBinaryValue value;
+	OCItem *item;
+
+	if (![self isBinaryEncodedData:data])
+	{
+		return (nil);
+	}
+
+	reader = (OCItemBinaryReader){ .position = ((const uint8_t *)data.bytes) + OCItemBinaryCodingMagicLength, .end = ((const uint8_t *)data.bytes) + data.length, .failed = NO };
+
+	if (OCItemBinaryReadVarint(&reader) != OCItemBinaryCodingVersion)
+	{
+		OCLogError(@"Unsupported binary item encoding version");
+		return (nil);
+	}
+
+	item = [[self alloc] initForDecoding];
+
+	while (OCItemBinaryReadValue(&reader, &value))
+	{
+		switch (value.field)
+		{
+			case OCItemBinaryFieldType:
+				item.type = (OCItemType)value.varint;
+			break;
+
+			case OCItemBinaryFieldMIMEType:
+				item.mimeType = OCItemBinaryValueString(&value, YES);
+			break;
+
+			case OCItemBinaryFieldPermissions:
+				item.permissions = (OCItemPermissions)value.varint;
+			break;
+
+			case OCItemBinaryFieldLocalRelativePath:
+				item.localRelativePath = OCItemBinaryValueString(&value, NO);
+			break;
+
+			case OCItemBinaryFieldLocallyModified:
+				item.locallyModified = (value.varint != 0);
+			break;
+
+			case OCItemBinaryFieldLocalCopyVersionIdentifier: {
+				OCItemBinaryReader nestedReader = OCItemBinaryNestedReader(&value);
+				OCItemBinaryValue nestedValue;
+				OCFileID fileID = nil;
+				OCFileETag eTag = nil;
+
+				while (OCItemBinaryReadValue(&nestedReader, &nestedValue))
+				{
+					switch (nestedValue.field)
+					{
+						case OCItemBinaryVersionIdentifierFieldFileID:
+							fileID = OCItemBinaryValueString(&nestedValue, NO);
+						break;
+
+						case OCItemBinaryVersionIdentifierFieldETag:
+							eTag = OCItemBinaryValueString(&nestedValue, NO);
+						break;
+					}
+				}
+
+				item.localCopyVersionIdentifier = [[OCItemVersionIdentifier alloc] initWithFileID:fileID eTag:eTag];
+			}
+			break;
+
+			case OCItemBinaryFieldDownloadTriggerIdentifier:
+				item.downloadTriggerIdentifier = OCItemBinaryValueString(&value, YES);
+			break;
+
+			case OCItemBinaryFieldPath:
+				item.path = OCItemBinaryValueString(&value, NO);
+			break;
+
+			case OCItemBinaryFieldParentLocalID:
+				item.parentLocalID = OCItemBinaryValueString(&value, NO);
+			break;
+
+			case OCItemBinaryFieldLocalID:
+				item.localID = OCItemBinaryValueString(&value, NO);
+			break;
+
+			case OCItemBinaryFieldDriveID:
+				item.driveID = OCItemBinaryValueString(&value, YES);
+			break;
+
+			case OCItemBinaryFieldParentFileID:
+				item.parentFileID = OCItemBinaryValueString(&value, NO);
+			break;
+
+			case OCItemBinaryFieldFileID:
+				item.fileID = OCItemBinaryValueString(&value, NO);
+			break;
+
+			case OCItemBinaryFieldETag:
+				item.eTag = OCItemBinaryValueString(&value, NO);
+			break;
+
+			case OCItemBinaryFieldActiveSyncRecordIDs: {
+				OCItemBinaryReader nestedReader = OCItemBinaryNestedReader(&value);
+				NSMutableArray<OCSyncRecordID> *activeSyncRecordIDs = [NSMutableArray new];
+
+				while (!nestedReader.failed && (nestedReader.position < nestedReader.end))
+				{
+					OCItemBinaryValue idValue = { .varint = OCItemBinaryReadVarint(&nestedReader) };
+
+					if (!nestedReader.failed)
+					{
+						[activeSyncRecordIDs addObject:@(OCItemBinaryValueInt(&idValue))];
+					}
+				}
+
+				item.activeSyncRecordIDs = activeSyncRecordIDs;
+			}
+			break;
+
+			case OCItemBinaryFieldSyncActivity:
+				item.syncActivity = (OCItemSyncActivity)value.varint;
+			break;
+
+			case OCItemBinaryFieldSyncActivityCounts: {
+				OCItemBinaryReader nestedReader = OCItemBinaryNestedReader(&value);
+				NSCountedSet<NSNumber *> *syncActivityCounts = [NSCountedSet new];
+
+				while (!nestedReader.failed && (nestedReader.position < nestedReader.end))
+				{
+					NSNumber *activity = @(OCItemBinaryReadVarint(&nestedReader));
+					uint64_t count = OCItemBinaryReadVarint(&nestedReader);
+
+					if (!nestedReader.failed)
+					{
+						for (uint64_t i=0; i<count; i++)
+						{
+							[syncActivityCounts addObject:activity];
+						}
+					}
+				}
+
+				item.syncActivityCounts = syncActivityCounts;
+			}
+			break;
+
+			case OCItemBinaryFieldSize:
+				item.size = (NSInteger)OCItemBinaryValueInt(&value);
+			break;
+
+			case OCItemBinaryFieldCreationDate:
+				item.creationDate = OCItemBinaryValueDate(&value);
+			break;
+
+			case OCItemBinaryFieldLastModified:
+				item.lastModified = OCItemBinaryValueDate(&value);
+			break;
+
+			case OCItemBinaryFieldLastUsed:
+				item.lastUsed = OCItemBinaryValueDate(&value);
+			break;
+
+			case OCItemBinaryFieldIsFavorite:
+				item.isFavorite = (value.varint != 0) ? @(YES) : @(NO);
+			break;
+
+			case OCItemBinaryFieldState:
+				item.state = (OCItemState)value.varint;
+			break;
+
+			case OCItemBinaryFieldLocalAttributesLastModified:
+				item.localAttributesLastModified = value.doubleValue;
+			break;
+
+			case OCItemBinaryFieldShareTypesMask:
+				item.shareTypesMask = (OCShareTypesMask)value.varint;
+			break;
+
+			case OCItemBinaryFieldOwner: {
+				OCItemBinaryReader nestedReader = OCItemBinaryNestedReader(&value);
+				OCItemBinaryValue nestedValue;
+				NSString *userName = nil, *displayName = nil, *emailAddress = nil;
+				OCUserID identifier = nil;
+				OCUserType type = OCUserTypeUnknown;
+				NSNumber *forceIsRemote = nil;
+				OCUser *owner;
+
+				while (OCItemBinaryReadValue(&nestedReader, &nestedValue))
+				{
+					switch (nestedValue.field)
+					{
+						case OCItemBinaryOwnerFieldUserName:
+							userName = OCItemBinaryValueString(&nestedValue, YES);
+						break;
+
+						case OCItemBinaryOwnerFieldDisplayName:
+							displayName = OCItemBinaryValueString(&nestedValue, YES);
+						break;
+
+						case OCItemBinaryOwnerFieldEmailAddress:
+							emailAddress = OCItemBinaryValueString(&nestedValue, YES);
+						break;
+
+						case OCItemBinaryOwnerFieldType:
+							type = (OCUserType)nestedValue.varint;
+						break;
+
+						case OCItemBinaryOwnerFieldIdentifier:
+							identifier = OCItemBinaryValueString(&nestedValue, YES);
+						break;
+
+						case OCItemBinaryOwnerFieldForceIsRemote:
+							forceIsRemote = @(nestedValue.varint != 0);
+						break;
+					}
+				}
+
+				if (forceIsRemote != nil)
+				{
+					owner = [OCUser userWithUserName:userName displayName:displayName isRemote:forceIsRemote.boolValue];
+				}
+				else
+				{
+					owner = [OCUser userWithUserName:userName displayName:displayName];
+				}
+
+				owner.emailAddress = emailAddress;
+				owner.identifier = identifier;
+				owner.type = type;
+
+				item.owner = owner;
+			}
+			break;
+
+			case OCItemBinaryFieldPrivateLink: {
+				NSString *privateLinkString;
+
+				if ((privateLinkString = OCItemBinaryValueString(&value, NO)) != nil)
+				{
+					item.privateLink = [[NSURL alloc] initWithString:privateLinkString];
+				}
+			}
+			break;
+
+			case OCItemBinaryFieldTUSInfo:
+				item.tusInfo = (OCTUSInfo)value.varint;
+			break;
+
+			case OCItemBinaryFieldDatabaseID:
+				item.databaseID = @(OCItemBinaryValueInt(&value));
+			break;
+
+			case OCItemBinaryFieldQuotaBytesRemaining:
+				item.quotaBytesRemaining = @(OCItemBinaryValueInt(&value));
+			break;
+
+			case OCItemBinaryFieldQuotaBytesUsed:
+				item.quotaBytesUsed = @(OCItemBinaryValueInt(&value));
+			break;
+
+			case OCItemBinaryFieldVersionSeed:
+				item.versionSeed = (OCItemVersionSeed)OCItemBinaryValueInt(&value);
+			break;
+
+			case OCItemBinaryFieldLazySection:
+				if (value.length > 0)
+				{
+					item.pendingLazyBinaryFields = [[NSData alloc] initWithBytes:value.bytes length:value.length];
+				}
+			break;
+
+			default:
+				// Unknown field (f.ex. added by a newer version) - skip
+			break;
+		}
+	}
+
+	if (reader.failed)
+	{
+		OCLogError(@"Error decoding binary encoded item");
+		return (nil);
+	}
+
+	return (item);
+}
+
+- (void)applyLazyBinaryFields:(NSData *)lazyBinaryFields
+{
+	OCItemBinaryReader reader = { .position = lazyBinaryFields.bytes, .end = ((const uint8_t *)lazyBinaryFields.bytes) + lazyBinaryFields.length, .failed = NO };
+	OCItemBinaryValue value;
+	NSMutableArray<OCChecksum *> *checksums = nil;
+
+	while (OCItemBinaryReadValue(&reader, &value))
+	{
+		switch (value.field)
+		{
+			case OCItemBinaryLazyFieldChecksum: {
+				OCItemBinaryReader nestedReader = OCItemBinaryNestedReader(&value);
+				OCItemBinaryValue nestedValue;
+				OCChecksumAlgorithmIdentifier algorithmIdentifier = nil;
+				OCChecksumString checksumString = nil;
+
+				while (OCItemBinaryReadValue(&nestedReader, &nestedValue))
+				{
+					switch (nestedValue.field)
+					{
+						case OCItemBinaryChecksumFieldAlgorithm:
+							algorithmIdentifier = OCItemBinaryValueString(&nestedValue, YES);
+						break;
+
+						case OCItemBinaryChecksumFieldChecksum:
+							checksumString = OCItemBinaryValueString(&nestedValue, NO);
+						break;
+					}
+				}
+
+				if ((algorithmIdentifier != nil) && (checksumString != nil))
+				{
+					if (checksums == nil)
+					{
+						checksums = [NSMutableArray new];
+					}
+
+					[checksums addObject:[[OCChecksum alloc] initWithAlgorithmIdentifier:algorithmIdentifier checksum:checksumString]];
+				}
+			}
+			break;
+
+			case OCItemBinaryLazyFieldFileClaim:
+				self.fileClaim = OCTypedCast(OCItemBinaryValueUnarchivedObject(&value), OCClaim);
+			break;
+
+			case OCItemBinaryLazyFieldRemoteItem:
+				if (value.wireType == OCItemBinaryWireTypeBytes)
+				{
+					self.remoteItem = [OCItem itemFromBinaryEncodedData:[[NSData alloc] initWithBytesNoCopy:(void *)value.bytes length:value.length freeWhenDone:NO]];
+				}
+			break;
+
+			case OCItemBinaryLazyFieldLocalAttributes:
+				self.localAttributes = OCTypedCast(OCItemBinaryValueUnarchivedObject(&value), NSDictionary);
+			break;
+
+			default:
+			break;
+		}
+	}
+
+	if (checksums != nil)
+	{
+		self.checksums = checksums;
+	}
+
+	if (reader.failed)
+	{
+		OCLogError(@"Error decoding lazy fields of binary encoded item %@", self.localID);
+	}
+}
+
+@end
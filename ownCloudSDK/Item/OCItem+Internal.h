@@ -0,0 +1,35 @@
+//
+//  OCItem+Internal.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCItem.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface OCItem (Internal)
+
+#pragma mark - Decoding
+- (instancetype)initForDecoding; //!< Initializer for decoders: neither generates a localID nor a version seed
+
+#pragma mark - Lazy binary fields
+- (nullable NSData *)pendingLazyBinaryFields; //!< Encoded lazy fields that have not been decoded yet (nil if there are none)
+- (void)setPendingLazyBinaryFields:(nullable NSData *)pendingLazyBinaryFields; //!< Sets encoded lazy fields, which will be decoded on first access to any of them
+- (void)applyLazyBinaryFields:(NSData *)lazyBinaryFields; //!< Decodes lazy fields and applies them to the item (implemented in OCItem+BinaryCoding)
+
+@end
+
+NS_ASSUME_NONNULL_END
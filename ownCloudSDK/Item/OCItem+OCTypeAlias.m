@@ -135,10 +135,13 @@
 
 	OCTypeAlias typeAlias;
 
-	if ((typeAlias = typeAliasByMIMEType[mimeType]) == nil)
+	@synchronized(typeAliasByMIMEType)
 	{
-		typeAlias = [OCTypeAliasMIMEPrefix stringByAppendingString:mimeType];
-		typeAliasByMIMEType[mimeType] = typeAlias;
+		if ((typeAlias = typeAliasByMIMEType[mimeType]) == nil)
+		{
+			typeAlias = [OCTypeAliasMIMEPrefix stringByAppendingString:mimeType];
+			typeAliasByMIMEType[mimeType] = typeAlias;
+		}
 	}
 
 	return (typeAlias);
@@ -269,5 +269,6 @@ extern OCItemPropertyName OCItemPropertyNameDownloadTrigger; //!< Supported by O
 
 extern OCItemPropertyName OCItemPropertyNameRemoved; //!< Supported by OCQueryCondition SQLBuilder (for internal use by policies)
 extern OCItemPropertyName OCItemPropertyNameDatabaseTimestamp; //!< Supported by OCQueryCondition SQLBuilder (for internal use by policies)
+extern OCItemPropertyName OCItemPropertyNameDatabaseSyncAnchor; //!< Supported by OCQueryCondition SQLBuilder only (for internal use by policies): sync anchor of the last change to the item in the database
 
 NS_ASSUME_NONNULL_END
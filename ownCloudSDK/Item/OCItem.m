@@ -21,14 +21,24 @@
 #import "OCCore+FileProvider.h"
 #import "OCFile.h"
 #import "OCItem+OCItemCreationDebugging.h"
+#import "OCItem+BinaryCoding.h"
+#import "OCItem+Internal.h"
 #import "OCMacros.h"
 #import "NSString+OCPath.h"
 
 @implementation OCItem
 {
 	OCLocation *_location;
+
+	NSData *_lazyBinaryFields;
+
+	BOOL _sharesMutableContainers; //!< YES if _localAttributes, _syncActivityCounts and _activeSyncRecordIDs may be shared with a copy of the item and need to be copied before they are mutated
 }
 
+@synthesize checksums = _checksums;
+@synthesize fileClaim = _fileClaim;
+@synthesize remoteItem = _remoteItem;
+
 @dynamic cloudStatus;
 @dynamic hasLocalAttributes;
 @dynamic parentPath;
@@ -59,6 +69,18 @@
 	return (self);
 }
 
+- (instancetype)initForDecoding
+{
+	if ((self = [super init]) != nil)
+	{
+		[self _captureCallstack];
+
+		_thumbnailAvailability = OCItemThumbnailAvailabilityInternal;
+	}
+
+	return (self);
+}
+
 #pragma mark - Placeholder
 + (instancetype)placeholderItemOfType:(OCItemType)type
 {
@@ -86,6 +108,8 @@
 
 - (void)encodeWithCoder:(NSCoder *)coder
 {
+	[self _resolveLazyBinaryFields];
+
 	[coder encodeInteger:_type    		forKey:@"type"];
 
 	[coder encodeObject:_mimeType 		forKey:@"mimeType"];
@@ -193,7 +217,7 @@
 
 		_state = [decoder decodeIntegerForKey:@"state"];
 
-		_localAttributes = [decoder decodeObjectOfClasses:OCEvent.safeClasses forKey:@"localAttributes"];
+		_localAttributes = [[decoder decodeObjectOfClasses:OCEvent.safeClasses forKey:@"localAttributes"] mutableCopy];
 		_localAttributesLastModified = [decoder decodeDoubleForKey:@"localAttributesLastModified"];
 
 		_shareTypesMask = [decoder decodeIntegerForKey:@"shareTypesMask"];
@@ -219,6 +243,12 @@
 {
 	if (serializedData != nil)
 	{
+		if ([OCItem isBinaryEncodedData:serializedData])
+		{
+			return ([self itemFromBinaryEncodedData:serializedData]);
+		}
+
+		// Legacy keyed archive
 		return ([NSKeyedUnarchiver unarchiveObjectWithData:serializedData]);
 	}
 
@@ -227,7 +257,93 @@
 
 - (NSData *)serializedData
 {
-	return ([NSKeyedArchiver archivedDataWithRootObject:self]);
+	return ([self binaryEncodedData]);
+}
+
+#pragma mark - Lazy binary fields
+- (NSData *)pendingLazyBinaryFields
+{
+	@synchronized(self)
+	{
+		return (_lazyBinaryFields);
+	}
+}
+
+- (void)setPendingLazyBinaryFields:(NSData *)pendingLazyBinaryFields
+{
+	@synchronized(self)
+	{
+		_lazyBinaryFields = pendingLazyBinaryFields;
+	}
+}
+
+- (void)_resolveLazyBinaryFields
+{
+	@synchronized(self)
+	{
+		NSData *lazyBinaryFields;
+
+		if ((lazyBinaryFields = _lazyBinaryFields) != nil)
+		{
+			_lazyBinaryFields = nil;
+
+			[self applyLazyBinaryFields:lazyBinaryFields];
+		}
+	}
+}
+
+- (NSArray<OCChecksum *> *)checksums
+{
+	@synchronized(self)
+	{
+		[self _resolveLazyBinaryFields];
+		return (_checksums);
+	}
+}
+
+- (void)setChecksums:(NSArray<OCChecksum *> *)checksums
+{
+	@synchronized(self)
+	{
+		[self _resolveLazyBinaryFields];
+		_checksums = checksums;
+	}
+}
+
+- (OCClaim *)fileClaim
+{
+	@synchronized(self)
+	{
+		[self _resolveLazyBinaryFields];
+		return (_fileClaim);
+	}
+}
+
+- (void)setFileClaim:(OCClaim *)fileClaim
+{
+	@synchronized(self)
+	{
+		[self _resolveLazyBinaryFields];
+		_fileClaim = fileClaim;
+	}
+}
+
+- (OCItem *)remoteItem
+{
+	@synchronized(self)
+	{
+		[self _resolveLazyBinaryFields];
+		return (_remoteItem);
+	}
+}
+
+- (void)setRemoteItem:(OCItem *)remoteItem
+{
+	@synchronized(self)
+	{
+		[self _resolveLazyBinaryFields];
+		_remoteItem = remoteItem;
+	}
 }
 
 #pragma mark - Metadata
@@ -359,6 +475,7 @@
 
 	@synchronized(self)
 	{
+		[self _resolveLazyBinaryFields];
 		hasLocalAttributes = (_localAttributes.count > 0);
 	}
 
@@ -371,16 +488,27 @@
 
 	@synchronized(self)
 	{
+		[self _resolveLazyBinaryFields];
 		localAttributesCopy = [NSDictionary dictionaryWithDictionary:_localAttributes];
 	}
 
 	return (localAttributesCopy);
 }
 
+- (void)setLocalAttributes:(NSDictionary<OCLocalAttribute,id> *)localAttributes
+{
+	@synchronized(self)
+	{
+		[self _resolveLazyBinaryFields];
+		_localAttributes = [localAttributes mutableCopy];
+	}
+}
+
 - (id)valueForLocalAttribute:(OCLocalAttribute)localAttribute
 {
 	@synchronized(self)
 	{
+		[self _resolveLazyBinaryFields];
 		return (_localAttributes[localAttribute]);
 	}
 }
@@ -389,6 +517,9 @@
 {
 	@synchronized(self)
 	{
+		[self _resolveLazyBinaryFields];
+		[self _unshareMutableContainers];
+
 		if (value != nil)
 		{
 			if (_localAttributes==nil)
@@ -456,13 +587,15 @@
 	return (!_locallyModified && 						   	// This is not a locally modified copy
 		(_syncActivity == OCItemSyncActivityNone) && 			   	// No sync activity is going on
 		((_activeSyncRecordIDs==nil) || (_activeSyncRecordIDs.count == 0)) && 	// No sync record references this item
-		![_fileClaim isValid]							// Nobody holds onto this item
+		![self.fileClaim isValid]						// Nobody holds onto this item
 	       );
 }
 
 #pragma mark - Sync record tools
 - (void)addSyncRecordID:(OCSyncRecordID)syncRecordID activity:(OCItemSyncActivity)activity
 {
+	[self _unshareMutableContainers];
+
 	if (activity != OCItemSyncActivityNone)
 	{
 		if ((self.syncActivity & activity) == 0)
@@ -503,6 +636,8 @@
 
 - (void)removeSyncRecordID:(OCSyncRecordID)syncRecordID activity:(OCItemSyncActivity)activity
 {
+	[self _unshareMutableContainers];
+
 	if (activity != OCItemSyncActivityNone)
 	{
 		if ((_syncActivityCounts != nil) && ([_syncActivityCounts countForObject:@(activity)] > 0))
@@ -850,19 +985,117 @@
 {
 	NSString *shareTypesDescription = [self _shareTypesDescription];
 
-	return ([NSString stringWithFormat:@"<%@: %p, type: %lu, name: %@, path: %@, size: %lu bytes, MIME-Type: %@, Last modified: %@, Last used: %@, driveID: %@, fileID: %@, eTag: %@, parentID: %@, localID: %@, parentLocalID: %@%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@>", NSStringFromClass(self.class), self, (unsigned long)self.type, self.name, self.path, self.size, self.mimeType, self.lastModified, self.lastUsed, self.driveID, self.fileID, self.eTag, self.parentFileID, self.localID, self.parentLocalID, ((shareTypesDescription!=nil) ? [NSString stringWithFormat:@", shareTypes: [%@]",shareTypesDescription] : @""), (self.isSharedWithUser ? @", sharedWithUser" : @""), (self.isShareable ? @", shareable" : @""), ((_owner!=nil) ? [NSString stringWithFormat:@", owner: %@", _owner] : @""), (_removed ? @", removed" : @""), (_isFavorite.boolValue ? @", favorite" : @""), (_privateLink ? [NSString stringWithFormat:@", privateLink: %@", _privateLink] : @""), (_checksums ? [NSString stringWithFormat:@", checksums: %@", _checksums] : @""), [self _tusSupportDescription], (_downloadTriggerIdentifier ? [NSString stringWithFormat:@", downloadTrigger: %@", _downloadTriggerIdentifier] : @""), ((_fileClaim!=nil) ? @", fileClaim: yes" : @""), ((_localRelativePath!=nil) ? [NSString stringWithFormat:@", localRelativePath: %@", _localRelativePath] : @""), ((_state!=OCItemStateNormal) ? [NSString stringWithFormat:@", state: %ld", (long)_state] : @""), ((_bookmarkUUID!=nil) ? [NSString stringWithFormat:@", bookmarkUUID: %@", _bookmarkUUID] : @""), [self syncActivityDescription]]);
+	return ([NSString stringWithFormat:@"<%@: %p, type: %lu, name: %@, path: %@, size: %lu bytes, MIME-Type: %@, Last modified: %@, Last used: %@, driveID: %@, fileID: %@, eTag: %@, parentID: %@, localID: %@, parentLocalID: %@%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@>", NSStringFromClass(self.class), self, (unsigned long)self.type, self.name, self.path, self.size, self.mimeType, self.lastModified, self.lastUsed, self.driveID, self.fileID, self.eTag, self.parentFileID, self.localID, self.parentLocalID, ((shareTypesDescription!=nil) ? [NSString stringWithFormat:@", shareTypes: [%@]",shareTypesDescription] : @""), (self.isSharedWithUser ? @", sharedWithUser" : @""), (self.isShareable ? @", shareable" : @""), ((_owner!=nil) ? [NSString stringWithFormat:@", owner: %@", _owner] : @""), (_removed ? @", removed" : @""), (_isFavorite.boolValue ? @", favorite" : @""), (_privateLink ? [NSString stringWithFormat:@", privateLink: %@", _privateLink] : @""), ((self.checksums!=nil) ? [NSString stringWithFormat:@", checksums: %@", self.checksums] : @""), [self _tusSupportDescription], (_downloadTriggerIdentifier ? [NSString stringWithFormat:@", downloadTrigger: %@", _downloadTriggerIdentifier] : @""), ((self.fileClaim!=nil) ? @", fileClaim: yes" : @""), ((_localRelativePath!=nil) ? [NSString stringWithFormat:@", localRelativePath: %@", _localRelativePath] : @""), ((_state!=OCItemStateNormal) ? [NSString stringWithFormat:@", state: %ld", (long)_state] : @""), ((_bookmarkUUID!=nil) ? [NSString stringWithFormat:@", bookmarkUUID: %@", _bookmarkUUID] : @""), [self syncActivityDescription]]);
 }
 
 #pragma mark - Copying
 - (id)copyWithZone:(nullable NSZone *)zone
 {
-	OCItem *copy = [[self class] itemFromSerializedData:self.serializedData];
+	// Memberwise copy of the properties preserved by -serializedData (+ bookmarkUUID). Immutable values are shared, mutable
+	// containers are shared until either item mutates them (copy-on-write), encoded lazy fields are passed on undecoded.
+	OCItem *copy = [[[self class] alloc] initForDecoding];
+
+	@synchronized(self)
+	{
+		copy->_type = _type;
+		copy->_mimeType = _mimeType;
+		copy->_permissions = _permissions;
+
+		copy->_localRelativePath = _localRelativePath;
+		copy->_locallyModified = _locallyModified;
+		copy->_localCopyVersionIdentifier = _localCopyVersionIdentifier;
+		copy->_downloadTriggerIdentifier = _downloadTriggerIdentifier;
+
+		copy->_path = _path;
+		copy->_parentLocalID = _parentLocalID;
+		copy->_localID = _localID;
+		copy->_driveID = _driveID;
+		copy->_parentFileID = _parentFileID;
+		copy->_fileID = _fileID;
+		copy->_eTag = _eTag;
+
+		copy->_activeSyncRecordIDs = _activeSyncRecordIDs;
+		copy->_syncActivity = _syncActivity;
+		copy->_syncActivityCounts = _syncActivityCounts;
+
+		copy->_size = _size;
+		copy->_creationDate = _creationDate;
+		copy->_lastModified = _lastModified;
+		copy->_lastUsed = _lastUsed;
+		copy->_isFavorite = _isFavorite;
+
+		copy->_state = _state;
+
+		copy->_localAttributesLastModified = _localAttributesLastModified;
+
+		copy->_shareTypesMask = _shareTypesMask;
+		copy->_owner = _owner;
+		copy->_privateLink = _privateLink;
+
+		copy->_tusInfo = _tusInfo;
+
+		copy->_databaseID = _databaseID;
+
+		copy->_quotaBytesRemaining = _quotaBytesRemaining;
+		copy->_quotaBytesUsed = _quotaBytesUsed;
+
+		copy->_versionSeed = _versionSeed;
+
+		if (_lazyBinaryFields != nil)
+		{
+			// Lazy fields have not been decoded yet - let the copy decode them when needed
+			copy->_lazyBinaryFields = _lazyBinaryFields;
+		}
+		else
+		{
+			copy->_checksums = _checksums;
+			copy->_fileClaim = _fileClaim;
+			copy->_remoteItem = [_remoteItem copy];
+			copy->_localAttributes = (_localAttributes.count > 0) ? _localAttributes : nil;
+		}
+
+		_sharesMutableContainers = YES;
+		copy->_sharesMutableContainers = YES;
+	}
 
 	copy.bookmarkUUID = _bookmarkUUID;
 
 	return (copy);
 }
 
+- (void)_unshareMutableContainers
+{
+	@synchronized(self)
+	{
+		if (_sharesMutableContainers)
+		{
+			_sharesMutableContainers = NO;
+
+			_localAttributes = [_localAttributes mutableCopy];
+
+			if ([_activeSyncRecordIDs isKindOfClass:NSMutableArray.class])
+			{
+				_activeSyncRecordIDs = [_activeSyncRecordIDs mutableCopy];
+			}
+
+			if (_syncActivityCounts != nil)
+			{
+				NSCountedSet<NSNumber *> *syncActivityCounts = [NSCountedSet new];
+
+				for (NSNumber *activity in _syncActivityCounts)
+				{
+					for (NSUInteger i=0; i < [_syncActivityCounts countForObject:activity]; i++)
+					{
+						[syncActivityCounts addObject:activity];
+					}
+				}
+
+				_syncActivityCounts = syncActivityCounts;
+			}
+		}
+	}
+}
+
 @end
 
 OCFileID   OCFileIDPlaceholderPrefix = @"_placeholder_";
@@ -903,4 +1136,5 @@ OCItemPropertyName OCItemPropertyNameFileID = @"fileID";
 
 OCItemPropertyName OCItemPropertyNameRemoved = @"removed";
 OCItemPropertyName OCItemPropertyNameDatabaseTimestamp = @"databaseTimestamp";
+OCItemPropertyName OCItemPropertyNameDatabaseSyncAnchor = @"databaseSyncAnchor";
 
@@ -0,0 +1,37 @@
+//
+//  OCKeyValueCollection.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCKeyValueStore.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface OCKeyValueCollection : NSObject <NSSecureCoding>
+
+@property(readonly,nonatomic) NSUInteger count;
+@property(readonly,strong,nonatomic) NSArray<OCKeyValueStoreCollectionEntryID> *entryIDs; //!< IDs of the entries, in the order they were added
+
+- (nullable NSData *)dataForEntryID:(OCKeyValueStoreCollectionEntryID)entryID;
+
+- (BOOL)canAddEntryWithID:(OCKeyValueStoreCollectionEntryID)entryID; //!< Returns NO if an entry with that ID is already part of the collection or has been removed recently
+- (BOOL)addData:(NSData *)data withEntryID:(OCKeyValueStoreCollectionEntryID)entryID; //!< Adds data for entryID, returns NO if .canAddEntryWithID: returns NO for entryID
+- (BOOL)removeEntryWithID:(OCKeyValueStoreCollectionEntryID)entryID; //!< Removes the entry with the ID, returns NO if no entry with that ID exists
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,164 @@
+//
+//  OCKeyValueCollection.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCKeyValueCollection.h"
+
+#define OCKeyValueCollectionMaxRemovedEntryIDs 100 // Number of removed entry IDs to remember, to reject late duplicates of already processed entries
+
+@interface OCKeyValueCollection ()
+{
+	NSMutableOrderedSet<OCKeyValueStoreCollectionEntryID> *_entryIDs;
+	NSMutableDictionary<OCKeyValueStoreCollectionEntryID, NSData *> *_dataByEntryID;
+	NSMutableOrderedSet<OCKeyValueStoreCollectionEntryID> *_removedEntryIDs;
+}
+@end
+
+@implementation OCKeyValueCollection
+
+- (instancetype)init
+{
+	if ((self = [super init]) != nil)
+	{
+		_entryIDs = [NSMutableOrderedSet new];
+		_dataByEntryID = [NSMutableDictionary new];
+		_removedEntryIDs = [NSMutableOrderedSet new];
+	}
+
+	return (self);
+}
+
+- (NSUInteger)count
+{
+	@synchronized(self)
+	{
+		return (_entryIDs.count);
+	}
+}
+
+- (NSArray<OCKeyValueStoreCollectionEntryID> *)entryIDs
+{
+	@synchronized(self)
+	{
+		return (_entryIDs.array);
+	}
+}
+
+- (NSData *)dataForEntryID:(OCKeyValueStoreCollectionEntryID)entryID
+{
+	@synchronized(self)
+	{
+		return (_dataByEntryID[entryID]);
+	}
+}
+
+- (BOOL)canAddEntryWithID:(OCKeyValueStoreCollectionEntryID)entryID
+{
+	@synchronized(self)
+	{
+		return ((_dataByEntryID[entryID] == nil) && ![_removedEntryIDs containsObject:entryID]);
+	}
+}
+
+- (BOOL)addData:(NSData *)data withEntryID:(OCKeyValueStoreCollectionEntryID)entryID
+{
+	@synchronized(self)
+	{
+		if (![self canAddEntryWithID:entryID])
+		{
+			return (NO);
+		}
+
+		[_entryIDs addObject:entryID];
+		_dataByEntryID[entryID] = data;
+
+		return (YES);
+	}
+}
+
+- (BOOL)removeEntryWithID:(OCKeyValueStoreCollectionEntryID)entryID
+{
+	@synchronized(self)
+	{
+		if (_dataByEntryID[entryID] == nil)
+		{
+			return (NO);
+		}
+
+		[_entryIDs removeObject:entryID];
+		[_dataByEntryID removeObjectForKey:entryID];
+
+		[_removedEntryIDs addObject:entryID];
+
+		if (_removedEntryIDs.count > OCKeyValueCollectionMaxRemovedEntryIDs)
+		{
+			[_removedEntryIDs removeObjectAtIndex:0];
+		}
+
+		return (YES);
+	}
+}
+
+#pragma mark - Secure coding
++ (BOOL)supportsSecureCoding
+{
+	return (YES);
+}
+
+- (instancetype)initWithCoder:(NSCoder *)decoder
+{
+	if ((self = [self init]) != nil)
+	{
+		NSArray<OCKeyValueStoreCollectionEntryID> *entryIDs = [decoder decodeObjectOfClasses:[[NSSet alloc] initWithObjects:[NSArray class], [NSString class], nil] forKey:@"entryIDs"];
+		NSArray<NSData *> *entryData = [decoder decodeObjectOfClasses:[[NSSet alloc] initWithObjects:[NSArray class], [NSData class], nil] forKey:@"entryData"];
+		NSArray<OCKeyValueStoreCollectionEntryID> *removedEntryIDs = [decoder decodeObjectOfClasses:[[NSSet alloc] initWithObjects:[NSArray class], [NSString class], nil] forKey:@"removedEntryIDs"];
+
+		if ((entryIDs != nil) && (entryData != nil) && (entryIDs.count == entryData.count))
+		{
+			[entryIDs enumerateObjectsUsingBlock:^(OCKeyValueStoreCollectionEntryID entryID, NSUInteger idx, BOOL * _Nonnull stop) {
+				[self->_entryIDs addObject:entryID];
+				self->_dataByEntryID[entryID] = entryData[idx];
+			}];
+		}
+
+		if (removedEntryIDs != nil)
+		{
+			[_removedEntryIDs addObjectsFromArray:removedEntryIDs];
+		}
+	}
+
+	return (self);
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder
+{
+	@synchronized(self)
+	{
+		NSMutableArray<NSData *> *entryData = [[NSMutableArray alloc] initWithCapacity:_entryIDs.count];
+
+		for (OCKeyValueStoreCollectionEntryID entryID in _entryIDs)
+		{
+			[entryData addObject:_dataByEntryID[entryID]];
+		}
+
+		[coder encodeObject:_entryIDs.array forKey:@"entryIDs"];
+		[coder encodeObject:entryData forKey:@"entryData"];
+		[coder encodeObject:_removedEntryIDs.array forKey:@"removedEntryIDs"];
+	}
+}
+
+@end
@@ -0,0 +1,97 @@
+//
+//  OCKeyValueLog.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCKeyValueStore.h"
+#import "OCKeyValueRecord.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSUInteger, OCKeyValueLogOperation)
+{
+	OCKeyValueLogOperationSetRecord,	//!< Replaces the record for .key with .record
+	OCKeyValueLogOperationRemoveRecord,	//!< Removes the record for .key
+
+	OCKeyValueLogOperationStackPush,	//!< Pushes .data with .claim onto the stack for .key
+	OCKeyValueLogOperationStackPop,		//!< Pops the entry with .claimIdentifier from the stack for .key
+
+	OCKeyValueLogOperationCollectionAdd,	//!< Adds .data with .entryID to the collection for .key
+	OCKeyValueLogOperationCollectionRemove	//!< Removes the entry with .entryID from the collection for .key
+};
+
+@interface OCKeyValueLogEntry : NSObject <NSSecureCoding>
+
+@property(readonly) OCKeyValueLogOperation operation;
+@property(strong,readonly) OCKeyValueStoreKey key;
+@property(readonly) OCKeyValueRecordSeed seed; //!< Seed of the record for .key after applying the entry
+
+@property(strong,nullable,readonly) OCKeyValueRecord *record;
+
+@property(strong,nullable,readonly) OCClaim *claim;
+@property(strong,nullable,readonly) OCClaimIdentifier claimIdentifier;
+
+@property(strong,nullable,readonly) OCKeyValueStoreCollectionEntryID entryID;
+@property(strong,nullable,readonly) NSData *data;
+
++ (instancetype)entryWithOperation:(OCKeyValueLogOperation)operation key:(OCKeyValueStoreKey)key seed:(OCKeyValueRecordSeed)seed;
++ (instancetype)setEntryForKey:(OCKeyValueStoreKey)key record:(OCKeyValueRecord *)record;
+
+- (instancetype)initWithOperation:(OCKeyValueLogOperation)operation key:(OCKeyValueStoreKey)key seed:(OCKeyValueRecordSeed)seed record:(nullable OCKeyValueRecord *)record claim:(nullable OCClaim *)claim claimIdentifier:(nullable OCClaimIdentifier)claimIdentifier entryID:(nullable OCKeyValueStoreCollectionEntryID)entryID data:(nullable NSData *)data;
+
+@end
+
+/*
+	Append-only record log backing OCKeyValueStore instances using OCKeyValueStoreBackendLog.
+
+	File format:
+	- header: magic (8 bytes) + generation (UInt64, little endian)
+	- entries: length (UInt32, little endian) + checksum of the payload (UInt32, little endian) + payload (archived OCKeyValueLogEntry)
+
+	- readers keep track of the offset up to which they have read the log and only read entries appended after it
+	- writers first read all new entries, then append their own entries at the end of the file. An incomplete entry
+	  at the end of the log (f.ex. from a writer that crashed mid-write) is ignored by readers and truncated by the next writer.
+	- compaction rewrites the log as one SetRecord entry per key and increments the generation, so that readers can detect
+	  that the log was replaced and need to read it from the start
+
+	OCKeyValueLog performs no coordination on its own. All methods must be called within a coordinated read (read methods)
+	or coordinated write (write methods) on the file.
+*/
+
+@interface OCKeyValueLog : NSObject <OCLogTagging>
+
+@property(strong,readonly) NSURL *url;
+
+@property(readonly) UInt64 generation; //!< Generation of the log at the time of the last read or write
+@property(readonly) unsigned long long offset; //!< Offset of the end of the last complete entry read or written
+
+@property(readonly,nonatomic) BOOL needsCompaction; //!< YES if the log has grown significantly since its last compaction
+
++ (BOOL)isLogAtURL:(NSURL *)url; //!< Returns YES if the file at url starts with a valid log header
+
+- (instancetype)initWithURL:(NSURL *)url;
+
+#pragma mark - Reading
+- (nullable NSArray<OCKeyValueLogEntry *> *)readNewEntries:(BOOL *)outReset error:(NSError * _Nullable * _Nullable)outError; //!< Returns the entries appended since the last read or write. If the log was replaced since, returns all entries and sets *outReset to YES.
+
+#pragma mark - Writing
+- (BOOL)appendEntries:(NSArray<OCKeyValueLogEntry *> *)entries error:(NSError * _Nullable * _Nullable)outError; //!< Appends entries to the log. Must be preceded by a call to -readNewEntries:error: within the same coordinated write.
+- (BOOL)writeLogWithRecords:(NSDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> *)records error:(NSError * _Nullable * _Nullable)outError; //!< Atomically replaces the log with a compacted log containing the records, using the next generation
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,458 @@
+//
+//  OCKeyValueLog.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <fcntl.h>
+#import <unistd.h>
+#import <sys/stat.h>
+
+#import "OCKeyValueLog.h"
+#import "NSError+OCError.h"
+#import "OCLogger.h"
+
+#define OCKeyValueLogHeaderSize			16
+#define OCKeyValueLogEntryHeaderSize		8
+#define OCKeyValueLogMaxEntrySize		(64 * 1024 * 1024) // Sanity limit, guards against reading garbage as entry length
+
+#define OCKeyValueLogCompactionMinimumSize	(256 * 1024) // Minimum log size before compaction is considered
+#define OCKeyValueLogCompactionGrowthFactor	4 // Compact once the log has grown to this multiple of its size after the last compaction
+
+static const char OCKeyValueLogMagic[8] = { 'O', 'C', 'K', 'V', 'L', 'O', 'G', '1' };
+
+static UInt32 OCKeyValueLogChecksum(const uint8_t *bytes, size_t length)
+{
+	// FNV-1a
+	UInt32 hash = 2166136261u;
+
+	for (size_t idx=0; idx < length; idx++)
+	{
+		hash ^= bytes[idx];
+		hash *= 16777619u;
+	}
+
+	return (hash);
+}
+
+static BOOL OCKeyValueLogReadBytes(int fd, void *buffer, size_t length, off_t offset)
+{
+	size_t readBytes = 0;
+
+	while (readBytes < length)
+	{
+		ssize_t result = pread(fd, ((uint8_t *)buffer) + readBytes, length - readBytes, offset + readBytes);
+
+		if (result < 0)
+		{
+			if (errno == EINTR) { continue; }
+			return (NO);
+		}
+
+		if (result == 0)
+		{
+			break;
+		}
+
+		readBytes += result;
+	}
+
+	return (readBytes == length);
+}
+
+static BOOL OCKeyValueLogWriteBytes(int fd, const void *buffer, size_t length, off_t offset)
+{
+	size_t writtenBytes = 0;
+
+	while (writtenBytes < length)
+	{
+		ssize_t result = pwrite(fd, ((const uint8_t *)buffer) + writtenBytes, length - writtenBytes, offset + writtenBytes);
+
+		if (result < 0)
+		{
+			if (errno == EINTR) { continue; }
+			return (NO);
+		}
+
+		writtenBytes += result;
+	}
+
+	return (YES);
+}
+
+@implementation OCKeyValueLogEntry
+
++ (instancetype)entryWithOperation:(OCKeyValueLogOperation)operation key:(OCKeyValueStoreKey)key seed:(OCKeyValueRecordSeed)seed
+{
+	return ([[self alloc] initWithOperation:operation key:key seed:seed record:nil claim:nil claimIdentifier:nil entryID:nil data:nil]);
+}
+
++ (instancetype)setEntryForKey:(OCKeyValueStoreKey)key record:(OCKeyValueRecord *)record
+{
+	return ([[self alloc] initWithOperation:OCKeyValueLogOperationSetRecord key:key seed:record.seed record:record claim:nil claimIdentifier:nil entryID:nil data:nil]);
+}
+
+- (instancetype)initWithOperation:(OCKeyValueLogOperation)operation key:(OCKeyValueStoreKey)key seed:(OCKeyValueRecordSeed)seed record:(OCKeyValueRecord *)record claim:(OCClaim *)claim claimIdentifier:(OCClaimIdentifier)claimIdentifier entryID:(OCKeyValueStoreCollectionEntryID)entryID data:(NSData *)data
+{
+	if ((self = [super init]) != nil)
+	{
+		_operation = operation;
+		_key = key;
+		_seed = seed;
+
+		_record = record;
+
+		_claim = claim;
+		_claimIdentifier = claimIdentifier;
+
+		_entryID = entryID;
+		_data = data;
+	}
+
+	return (self);
+}
+
+#pragma mark - Secure coding
++ (BOOL)supportsSecureCoding
+{
+	return (YES);
+}
+
+- (instancetype)initWithCoder:(NSCoder *)decoder
+{
+	if ((self = [super init]) != nil)
+	{
+		_operation = [decoder decodeIntegerForKey:@"operation"];
+		_key = [decoder decodeObjectOfClass:[NSString class] forKey:@"key"];
+		_seed = [decoder decodeIntegerForKey:@"seed"];
+
+		_record = [decoder decodeObjectOfClass:[OCKeyValueRecord class] forKey:@"record"];
+
+		_claim = [decoder decodeObjectOfClass:[OCClaim class] forKey:@"claim"];
+		_claimIdentifier = [decoder decodeObjectOfClass:[NSUUID class] forKey:@"claimIdentifier"];
+
+		_entryID = [decoder decodeObjectOfClass:[NSString class] forKey:@"entryID"];
+		_data = [decoder decodeObjectOfClass:[NSData class] forKey:@"data"];
+	}
+
+	return (self);
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder
+{
+	[coder encodeInteger:_operation forKey:@"operation"];
+	[coder encodeObject:_key forKey:@"key"];
+	[coder encodeInteger:_seed forKey:@"seed"];
+
+	[coder encodeObject:_record forKey:@"record"];
+
+	[coder encodeObject:_claim forKey:@"claim"];
+	[coder encodeObject:_claimIdentifier forKey:@"claimIdentifier"];
+
+	[coder encodeObject:_entryID forKey:@"entryID"];
+	[coder encodeObject:_data forKey:@"data"];
+}
+
+@end
+
+@interface OCKeyValueLog ()
+{
+	unsigned long long _compactedSize;
+}
+@end
+
+@implementation OCKeyValueLog
+
++ (NSData *)_headerWithGeneration:(UInt64)generation
+{
+	NSMutableData *header = [[NSMutableData alloc] initWithBytes:OCKeyValueLogMagic length:sizeof(OCKeyValueLogMagic)];
+	UInt64 generationLE = CFSwapInt64HostToLittle(generation);
+
+	[header appendBytes:&generationLE length:sizeof(generationLE)];
+
+	return (header);
+}
+
++ (BOOL)isLogAtURL:(NSURL *)url
+{
+	BOOL isLog = NO;
+	int fd;
+
+	if ((fd = open(url.fileSystemRepresentation, O_RDONLY)) >= 0)
+	{
+		char magic[sizeof(OCKeyValueLogMagic)];
+
+		isLog = OCKeyValueLogReadBytes(fd, magic, sizeof(magic), 0) && (memcmp(magic, OCKeyValueLogMagic, sizeof(magic)) == 0);
+
+		close(fd);
+	}
+
+	return (isLog);
+}
+
+- (instancetype)initWithURL:(NSURL *)url
+{
+	if ((self = [super init]) != nil)
+	{
+		_url = url;
+	}
+
+	return (self);
+}
+
+- (BOOL)needsCompaction
+{
+	return ((_offset > OCKeyValueLogCompactionMinimumSize) && (_offset > (_compactedSize * OCKeyValueLogCompactionGrowthFactor)));
+}
+
+#pragma mark - Entry serialization
+- (void)_appendEntry:(OCKeyValueLogEntry *)entry toData:(NSMutableData *)data
+{
+	NSData *payload;
+
+	if ((payload = [NSKeyedArchiver archivedDataWithRootObject:entry requiringSecureCoding:YES error:NULL]) != nil)
+	{
+		UInt32 lengthLE = CFSwapInt32HostToLittle((UInt32)payload.length);
+		UInt32 checksumLE = CFSwapInt32HostToLittle(OCKeyValueLogChecksum(payload.bytes, payload.length));
+
+		[data appendBytes:&lengthLE length:sizeof(lengthLE)];
+		[data appendBytes:&checksumLE length:sizeof(checksumLE)];
+		[data appendData:payload];
+	}
+	else
+	{
+		OCLogError(@"Error serializing log entry for key=%@", entry.key);
+	}
+}
+
+#pragma mark - Reading
+- (NSArray<OCKeyValueLogEntry *> *)readNewEntries:(BOOL *)outReset error:(NSError * _Nullable __autoreleasing *)outError
+{
+	NSMutableArray<OCKeyValueLogEntry *> *entries = nil;
+	NSError *error = nil;
+	BOOL reset = NO;
+	int fd;
+
+	if ((fd = open(_url.fileSystemRepresentation, O_RDONLY)) >= 0)
+	{
+		struct stat fileStat;
+		uint8_t header[OCKeyValueLogHeaderSize];
+
+		if ((fstat(fd, &fileStat) == 0) && OCKeyValueLogReadBytes(fd, header, sizeof(header), 0))
+		{
+			if (memcmp(header, OCKeyValueLogMagic, sizeof(OCKeyValueLogMagic)) == 0)
+			{
+				UInt64 generation = CFSwapInt64LittleToHost(*((UInt64 *)(header + sizeof(OCKeyValueLogMagic))));
+				unsigned long long fileSize = (unsigned long long)fileStat.st_size;
+				unsigned long long startOffset;
+
+				// Read the log from the start if it was compacted or replaced since the last read
+				reset = (generation != _generation) || (fileSize < _offset) || (_offset < OCKeyValueLogHeaderSize);
+				startOffset = reset ? OCKeyValueLogHeaderSize : _offset;
+
+				entries = [NSMutableArray new];
+
+				if (fileSize > startOffset)
+				{
+					NSMutableData *buffer = [[NSMutableData alloc] initWithLength:(NSUInteger)(fileSize - startOffset)];
+
+					if (OCKeyValueLogReadBytes(fd, buffer.mutableBytes, buffer.length, startOffset))
+					{
+						const uint8_t *bytes = buffer.bytes;
+						NSUInteger length = buffer.length, position = 0;
+						NSSet<Class> *entryClasses = [NSSet setWithObject:[OCKeyValueLogEntry class]];
+
+						while ((position + OCKeyValueLogEntryHeaderSize) <= length)
+						{
+							UInt32 entryLength = CFSwapInt32LittleToHost(*((UInt32 *)(bytes + position)));
+							UInt32 entryChecksum = CFSwapInt32LittleToHost(*((UInt32 *)(bytes + position + 4)));
+							const uint8_t *payloadBytes = bytes + position + OCKeyValueLogEntryHeaderSize;
+							OCKeyValueLogEntry *entry;
+
+							if ((entryLength > OCKeyValueLogMaxEntrySize) || ((position + OCKeyValueLogEntryHeaderSize + entryLength) > length) ||
+							    (OCKeyValueLogChecksum(payloadBytes, entryLength) != entryChecksum))
+							{
+								// Incomplete or damaged entry at the end of the log
+								break;
+							}
+
+							if ((entry = [NSKeyedUnarchiver unarchivedObjectOfClasses:entryClasses fromData:[NSData dataWithBytesNoCopy:(void *)payloadBytes length:entryLength freeWhenDone:NO] error:&error]) != nil)
+							{
+								[entries addObject:entry];
+							}
+							else
+							{
+								OCLogError(@"Error decoding log entry at offset %llu: %@", startOffset + position, error);
+								error = nil;
+							}
+
+							position += OCKeyValueLogEntryHeaderSize + entryLength;
+						}
+
+						_offset = startOffset + position;
+						_generation = generation;
+
+						if (reset)
+						{
+							_compactedSize = _offset;
+						}
+					}
+					else
+					{
+						error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSURLErrorKey : _url }];
+						entries = nil;
+					}
+				}
+				else
+				{
+					_offset = startOffset;
+					_generation = generation;
+
+					if (reset)
+					{
+						_compactedSize = _offset;
+					}
+				}
+			}
+			else
+			{
+				error = OCErrorWithDescription(OCErrorInternal, @"Not a key value log");
+			}
+		}
+		else
+		{
+			error = [NSError errorWithDomain:NSPOSIXErrorDomain code:((errno != 0) ? errno : EIO) userInfo:@{ NSURLErrorKey : _url }];
+		}
+
+		close(fd);
+	}
+	else
+	{
+		error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSURLErrorKey : _url }];
+	}
+
+	if (outReset != NULL)
+	{
+		*outReset = reset;
+	}
+
+	if (outError != NULL)
+	{
+		*outError = error;
+	}
+
+	return (entries);
+}
+
+#pragma mark - Writing
+- (BOOL)appendEntries:(NSArray<OCKeyValueLogEntry *> *)entries error:(NSError * _Nullable __autoreleasing *)outError
+{
+	NSMutableData *data = [NSMutableData new];
+	NSError *error = nil;
+	int fd;
+
+	for (OCKeyValueLogEntry *entry in entries)
+	{
+		[self _appendEntry:entry toData:data];
+	}
+
+	if (data.length == 0)
+	{
+		return (YES);
+	}
+
+	if ((fd = open(_url.fileSystemRepresentation, O_WRONLY)) >= 0)
+	{
+		struct stat fileStat;
+
+		// Drop incomplete entries left behind by interrupted writers, so the new entries directly follow the last complete one
+		if ((fstat(fd, &fileStat) == 0) && ((unsigned long long)fileStat.st_size > _offset))
+		{
+			OCLogWarning(@"Truncating %llu bytes of incomplete entries from log", (unsigned long long)fileStat.st_size - _offset);
+
+			if (ftruncate(fd, (off_t)_offset) != 0)
+			{
+				error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSURLErrorKey : _url }];
+			}
+		}
+
+		if (error == nil)
+		{
+			if (OCKeyValueLogWriteBytes(fd, data.bytes, data.length, (off_t)_offset))
+			{
+				_offset += data.length;
+			}
+			else
+			{
+				error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSURLErrorKey : _url }];
+
+				// Remove partially written entries
+				ftruncate(fd, (off_t)_offset);
+			}
+		}
+
+		close(fd);
+	}
+	else
+	{
+		error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSURLErrorKey : _url }];
+	}
+
+	if (outError != NULL)
+	{
+		*outError = error;
+	}
+
+	return (error == nil);
+}
+
+- (BOOL)writeLogWithRecords:(NSDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> *)records error:(NSError * _Nullable __autoreleasing *)outError
+{
+	UInt64 generation = _generation + 1;
+	NSMutableData *data = [[NSMutableData alloc] initWithData:[OCKeyValueLog _headerWithGeneration:generation]];
+	NSError *error = nil;
+
+	for (OCKeyValueStoreKey key in records)
+	{
+		[self _appendEntry:[OCKeyValueLogEntry setEntryForKey:key record:records[key]] toData:data];
+	}
+
+	if ([data writeToURL:_url options:NSDataWritingAtomic error:&error])
+	{
+		_generation = generation;
+		_offset = data.length;
+		_compactedSize = data.length;
+	}
+
+	if (outError != NULL)
+	{
+		*outError = error;
+	}
+
+	return (error == nil);
+}
+
+#pragma mark - Log tags
++ (NSArray<OCLogTagName> *)logTags
+{
+	return (@[@"KeyValueStore"]);
+}
+
+- (NSArray<OCLogTagName> *)logTags
+{
+	return (@[@"KeyValueStore"]);
+}
+
+@end
@@ -25,7 +25,8 @@ typedef NSUInteger OCKeyValueRecordSeed;
 typedef NS_ENUM(NSUInteger, OCKeyValueRecordType)
 {
 	OCKeyValueRecordTypeValue,
-	OCKeyValueRecordTypeStack
+	OCKeyValueRecordTypeStack,
+	OCKeyValueRecordTypeCollection
 };
 
 @interface OCKeyValueRecord : NSObject <NSSecureCoding>
@@ -33,15 +34,19 @@ typedef NS_ENUM(NSUInteger, OCKeyValueRecordType)
 @property(assign, readonly) OCKeyValueRecordSeed seed; //!< Seed value of the record. Changes whenever the record is updated.
 @property(assign, readonly) OCKeyValueRecordType type; //!< The type of record.
 
-@property(strong, nullable, readonly) NSData *data; //!< Data from serializing .object
+@property(strong, nullable, readonly, nonatomic) NSData *data; //!< Data from serializing .object
 @property(strong, nullable, readonly) id<NSSecureCoding> object; //!< Object from deserializing .data
 
 - (instancetype)initWithValue:(id<NSSecureCoding>)value; //!< Creates a record of type value with the given object
 - (instancetype)initWithKeyValueStack; //!< Creates a record of type stack with a new OCKeyValueStack as object
+- (instancetype)initWithKeyValueCollection; //!< Creates a record of type collection with a new OCKeyValueCollection as object
 
 - (void)updateWithObject:(id<NSSecureCoding>)object; //!< Updates .object and .data with the provided object
+- (void)invalidateDataWithSeed:(OCKeyValueRecordSeed)seed; //!< To be called after .object was modified in place: sets the seed and discards .data, which is then re-generated from .object on demand
 - (BOOL)updateFromRecord:(OCKeyValueRecord *)otherRecord; //!< Checks otherRecord for updates and applies them. Returns YES if the record was updated from otherRecord's data, NO otherwise.
 
+- (instancetype)detachedCopy; //!< Returns a copy of the record that decodes its own instance of .object from .data, so that changes to it don't affect the receiver. Records with pending in-place modifications are not copied, but returned as-is.
+
 - (nullable id<NSSecureCoding>)decodeObjectWithClasses:(NSSet<Class> *)decodeClasses; //!< Decodes .data using .decodeClasses and caches the decoded object.
 
 @end
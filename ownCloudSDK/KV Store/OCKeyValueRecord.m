@@ -19,6 +19,7 @@
 #import "OCKeyValueRecord.h"
 #import "OCLogger.h"
 #import "OCKeyValueStack.h"
+#import "OCKeyValueCollection.h"
 
 @implementation OCKeyValueRecord
 
@@ -44,6 +45,17 @@
 	return (self);
 }
 
+- (instancetype)initWithKeyValueCollection
+{
+	if ((self = [self init]) != nil)
+	{
+		_type = OCKeyValueRecordTypeCollection;
+		[self updateWithObject:[OCKeyValueCollection new]];
+	}
+
+	return (self);
+}
+
 - (void)updateWithObject:(id<NSSecureCoding>)object
 {
 	@synchronized(self)
@@ -55,6 +67,51 @@
 	}
 }
 
+- (void)invalidateDataWithSeed:(OCKeyValueRecordSeed)seed
+{
+	@synchronized(self)
+	{
+		_seed = seed;
+		_data = nil;
+	}
+}
+
+- (NSData *)data
+{
+	@synchronized(self)
+	{
+		if ((_data == nil) && (_object != nil))
+		{
+			_data = [NSKeyedArchiver archivedDataWithRootObject:_object];
+		}
+
+		return (_data);
+	}
+}
+
+- (instancetype)detachedCopy
+{
+	@synchronized(self)
+	{
+		OCKeyValueRecord *record;
+
+		if ((_data == nil) && (_object != nil))
+		{
+			// Avoid re-serializing an object that was modified in place
+			return (self);
+		}
+
+		if ((record = [OCKeyValueRecord new]) != nil)
+		{
+			record->_seed = _seed;
+			record->_type = _type;
+			record->_data = _data;
+		}
+
+		return (record);
+	}
+}
+
 - (BOOL)updateFromRecord:(OCKeyValueRecord *)otherRecord
 {
 	if (otherRecord != nil)
@@ -124,7 +181,7 @@
 	[encoder encodeInteger:_seed forKey:@"seed"];
 	[encoder encodeInteger:_type forKey:@"type"];
 
-	[encoder encodeObject:_data  forKey:@"data"];
+	[encoder encodeObject:self.data forKey:@"data"];
 }
 
 @end
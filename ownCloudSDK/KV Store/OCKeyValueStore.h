@@ -27,10 +27,13 @@
 			- validity / life-time limited by OCClaim (value is ignored, if OCClaim is no longer valid)
 			- only the most recent, valid value is returned
 			- allows usage for f.ex. recording process lifetime-bound locks on shared resources
+		- "collections": values identified by an entry ID, kept in the order they were added:
+			- adding and removing an entry doesn't require reading or writing the other entries (with the log backend)
+			- IDs of recently removed entries are remembered, so that late duplicates of already processed entries are rejected
 	- keeps values in-sync cross-process
 	- allows registering for changes
 
-	Internals:
+	Internals (archive backend):
 	- stored as a single file, structured as
 		{
 			key : {
@@ -49,6 +52,14 @@
 	- lastUpdated or seed values are used to indicate and detect changes
 	- file observed for changes via NSNotificationCenter/OCIPNotificationCenter (rate-limited), re-read and parsed when a change occurs
 	- uses NSFileCoordinator to protect against corruption, to coordinate concurrent changes and allow efficient bulk updates
+
+	Internals (log backend):
+	- stored as an append-only log of changes (see OCKeyValueLog), where each entry describes either a complete record
+	  (key, seed, record) or a single stack or collection operation (key, seed, claim or entry ID, data)
+	- changes only append the entries describing them to the log, instead of rewriting the entire store
+	- on change notifications, only the entries appended since the last read are read and applied
+	- the log is compacted to one entry per key once it has grown significantly, readers detect this via the log's generation
+	- existing stores using the archive backend are converted when opened with the log backend
 */
 
 #import <Foundation/Foundation.h>
@@ -61,6 +72,12 @@ typedef NSString* OCKeyValueStoreIdentifier;
 typedef NSString* OCKeyValueStoreKey NS_TYPED_ENUM;
 typedef NSString* OCKeyValueStoreCollectionEntryID;
 
+typedef NS_ENUM(NSUInteger, OCKeyValueStoreBackend)
+{
+	OCKeyValueStoreBackendArchive,	//!< Store contents are kept as a single archived dictionary that is re-written on every change
+	OCKeyValueStoreBackendLog	//!< Store contents are kept as an append-only log of changes that is compacted periodically
+};
+
 @class OCKeyValueStore;
 
 typedef void(^OCKeyValueStoreObserver)(OCKeyValueStore *store, id _Nullable owner, OCKeyValueStoreKey key, id _Nullable newValue);
@@ -69,6 +86,7 @@ typedef void(^OCKeyValueStoreObserver)(OCKeyValueStore *store, id _Nullable owne
 
 @property(strong,readonly,nullable) OCKeyValueStoreIdentifier identifier;
 @property(strong,readonly) NSURL *url;
+@property(assign,readonly) OCKeyValueStoreBackend backend;
 
 #pragma mark - Fallback
 + (NSSet<Class> *)fallbackClasses; //!< Classes to use for decoding if no class has been registered for a key. Safe "Property List" classes + NSSet by default.
@@ -80,8 +98,10 @@ typedef void(^OCKeyValueStoreObserver)(OCKeyValueStore *store, id _Nullable owne
 
 #pragma mark - Init
 - (instancetype)initWithURL:(NSURL *)url identifier:(nullable OCKeyValueStoreIdentifier)identifier; //!< Creates a new, independent KVS instance.
+- (instancetype)initWithURL:(NSURL *)url identifier:(nullable OCKeyValueStoreIdentifier)identifier backend:(OCKeyValueStoreBackend)backend; //!< Creates a new, independent KVS instance using the backend. Stores that already use the log backend keep using it, stores using the archive backend are converted if OCKeyValueStoreBackendLog is requested.
 
 + (instancetype)sharedWithURL:(NSURL *)url identifier:(nullable OCKeyValueStoreIdentifier)identifier owner:(nullable id)owner; //!< Returns a shared instance for the URL + identifier combination and keeps it alive as long as at least one "owner" has not yet been deallocated.
++ (instancetype)sharedWithURL:(NSURL *)url identifier:(nullable OCKeyValueStoreIdentifier)identifier owner:(nullable id)owner backend:(OCKeyValueStoreBackend)backend; //!< Like +sharedWithURL:identifier:owner:, using the backend if a new instance needs to be created.
 - (void)dropSharedFrom:(id)owner; //!< Drops the reference to the messaged KVS shared instance from owner
 
 #pragma mark - Class registration
@@ -100,8 +120,12 @@ typedef void(^OCKeyValueStoreObserver)(OCKeyValueStore *store, id _Nullable owne
 - (void)popObjectWithClaimID:(OCClaimIdentifier)claimIdentifier fromStackForKey:(OCKeyValueStoreKey)key;
 - (void)flushStackForKey:(OCKeyValueStoreKey)key;
 
+#pragma mark - Storing values in collections
+- (BOOL)addObject:(id<NSSecureCoding>)object toCollectionForKey:(OCKeyValueStoreKey)key withEntryID:(OCKeyValueStoreCollectionEntryID)entryID; //!< Adds object to the collection for key, unless an entry with entryID is part of the collection or has been removed from it recently. Returns YES if the object was added.
+- (BOOL)removeObjectWithEntryID:(OCKeyValueStoreCollectionEntryID)entryID fromCollectionForKey:(OCKeyValueStoreKey)key; //!< Removes the entry with entryID from the collection for key. Returns YES if an entry was removed.
+
 #pragma mark - Reading values
-- (nullable id)readObjectForKey:(OCKeyValueStoreKey)key;
+- (nullable id)readObjectForKey:(OCKeyValueStoreKey)key; //!< Returns the value for key. For stacks, that's the most recent valid value. For collections, that's an array of the values in the order they were added.
 
 #pragma mark - Observation
 - (void)addObserver:(OCKeyValueStoreObserver)observer forKey:(OCKeyValueStoreKey)key withOwner:(id)owner initial:(BOOL)initial;
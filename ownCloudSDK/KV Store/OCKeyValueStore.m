@@ -26,6 +26,8 @@
 #import "OCIPNotificationCenter.h"
 #import "OCRateLimiter.h"
 #import "OCKeyValueStack.h"
+#import "OCKeyValueCollection.h"
+#import "OCKeyValueLog.h"
 #import "OCBackgroundTask.h"
 
 typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValueStoreDictionary;
@@ -40,6 +42,8 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 	NSFileCoordinator *_coordinator;
 	NSOperationQueue *_coordinationQueue;
 
+	OCKeyValueLog *_log; //!< Only used with the log backend, and only accessed from _coordinationQueue
+
 	OCRateLimiter *_rateLimiter;
 
 	NSString *_cachedKeyUpdateNotificationName;
@@ -113,6 +117,11 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 
 #pragma mark - Init
 + (instancetype)sharedWithURL:(NSURL *)url identifier:(nullable OCKeyValueStoreIdentifier)identifier owner:(nullable id)owner
+{
+	return ([self sharedWithURL:url identifier:identifier owner:owner backend:OCKeyValueStoreBackendArchive]);
+}
+
++ (instancetype)sharedWithURL:(NSURL *)url identifier:(nullable OCKeyValueStoreIdentifier)identifier owner:(nullable id)owner backend:(OCKeyValueStoreBackend)backend
 {
 	static NSMapTable<NSString *, OCKeyValueStore *> *kvsByIdentifier;
 	static dispatch_once_t onceToken;
@@ -132,7 +141,7 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 			if ((keyValueStore = [kvsByIdentifier objectForKey:URLplusIdentifier]) == nil)
 			{
 				// Create KVS if none exists yet
-				keyValueStore = [[self alloc] initWithURL:url identifier:identifier];
+				keyValueStore = [[self alloc] initWithURL:url identifier:identifier backend:backend];
 
 				// Store weak reference to KVS for URLplusIdentifier
 				[kvsByIdentifier setObject:keyValueStore forKey:URLplusIdentifier];
@@ -160,16 +169,33 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 }
 
 - (instancetype)initWithURL:(NSURL *)url identifier:(nullable OCKeyValueStoreIdentifier)identifier
+{
+	return ([self initWithURL:url identifier:identifier backend:OCKeyValueStoreBackendArchive]);
+}
+
+- (instancetype)initWithURL:(NSURL *)url identifier:(nullable OCKeyValueStoreIdentifier)identifier backend:(OCKeyValueStoreBackend)backend
 {
 	if ((self = [self init]) != nil)
 	{
-		if ((url!=nil) && (![[NSFileManager defaultManager] fileExistsAtPath:url.path]))
+		// Stores already using the log backend always continue to use it
+		if ((url != nil) && [OCKeyValueLog isLogAtURL:url])
+		{
+			backend = OCKeyValueStoreBackendLog;
+		}
+
+		if ((url!=nil) && (backend == OCKeyValueStoreBackendArchive) && (![[NSFileManager defaultManager] fileExistsAtPath:url.path]))
 		{
 			[[NSKeyedArchiver archivedDataWithRootObject:[NSMutableDictionary new]] writeToURL:url atomically:YES];
 		}
 
 		_url = url;
 		_identifier = identifier;
+		_backend = backend;
+
+		if (_backend == OCKeyValueStoreBackendLog)
+		{
+			_log = [[OCKeyValueLog alloc] initWithURL:url];
+		}
 
 		_classesForKey = [NSMutableDictionary new];
 		_observersByOwnerByKey = [NSMutableDictionary new];
@@ -190,6 +216,18 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 			[_coordinationQueue addOperationWithBlock:^{
 				self->_coordinator = [[NSFileCoordinator alloc] initWithFilePresenter:nil];
 
+				if (self->_backend == OCKeyValueStoreBackendLog)
+				{
+					// Writing access, as the log may need to be created or converted from an archive
+					[self->_coordinator coordinateWritingItemAtURL:self->_url options:NSFileCoordinatorWritingForMerging error:NULL byAccessor:^(NSURL * _Nonnull newURL) {
+						// Initial load
+						[self _openLog];
+
+						OCSyncExecDone(waitForCoordinator);
+					}];
+					return;
+				}
+
 				[self->_coordinator coordinateReadingItemAtURL:self->_url options:0 error:NULL byAccessor:^(NSURL * _Nonnull newURL) {
 					// Initial load
 					OCKeyValueStoreDictionary recordsByKey;
@@ -311,6 +349,26 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 
 	OCWaitInitAndStartTask(waitForUpdateToFinish);
 
+	if (_backend == OCKeyValueStoreBackendLog)
+	{
+		[self _updateLogWithEntries:^NSArray<OCKeyValueLogEntry *> *(OCKeyValueStoreDictionary records) {
+			OCKeyValueRecord *record = records[key];
+
+			if ((record != nil) && (record.type != OCKeyValueRecordTypeStack))
+			{
+				OCLogError(@"Failed to push object on stack for key=%@", key);
+				return (nil);
+			}
+
+			return (@[ [[OCKeyValueLogEntry alloc] initWithOperation:OCKeyValueLogOperationStackPush key:key seed:record.seed+1 record:nil claim:claim claimIdentifier:nil entryID:nil data:objectData] ]);
+		} completionHandler:^(BOOL committed) {
+			OCWaitDidFinishTask(waitForUpdateToFinish);
+		}];
+
+		OCWaitForCompletion(waitForUpdateToFinish);
+		return;
+	}
+
 	[self updateStoreContentsWithModifications:^BOOL(OCKeyValueStoreDictionary storeContents) {
 		OCKeyValueRecord *record = nil;
 		OCKeyValueStack *stack;
@@ -345,6 +403,25 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 {
 	OCWaitInitAndStartTask(waitForUpdateToFinish);
 
+	if (_backend == OCKeyValueStoreBackendLog)
+	{
+		[self _updateLogWithEntries:^NSArray<OCKeyValueLogEntry *> *(OCKeyValueStoreDictionary records) {
+			OCKeyValueRecord *record = records[key];
+
+			if ((record != nil) && (record.type == OCKeyValueRecordTypeStack))
+			{
+				return (@[ [[OCKeyValueLogEntry alloc] initWithOperation:OCKeyValueLogOperationStackPop key:key seed:record.seed+1 record:nil claim:nil claimIdentifier:claimIdentifier entryID:nil data:nil] ]);
+			}
+
+			return (nil);
+		} completionHandler:^(BOOL committed) {
+			OCWaitDidFinishTask(waitForUpdateToFinish);
+		}];
+
+		OCWaitForCompletion(waitForUpdateToFinish);
+		return;
+	}
+
 	[self updateStoreContentsWithModifications:^BOOL(OCKeyValueStoreDictionary storeContents) {
 		OCKeyValueRecord *record = storeContents[key];
 		OCKeyValueStack *stack;
@@ -369,6 +446,134 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 	[self storeObject:nil forKey:key];
 }
 
+#pragma mark - Storing values in collections
+- (BOOL)addObject:(id<NSSecureCoding>)object toCollectionForKey:(OCKeyValueStoreKey)key withEntryID:(OCKeyValueStoreCollectionEntryID)entryID
+{
+	NSData *objectData = [NSKeyedArchiver archivedDataWithRootObject:object];
+	__block BOOL didAdd = NO;
+
+	OCWaitInitAndStartTask(waitForUpdateToFinish);
+
+	if (_backend == OCKeyValueStoreBackendLog)
+	{
+		[self _updateLogWithEntries:^NSArray<OCKeyValueLogEntry *> *(OCKeyValueStoreDictionary records) {
+			OCKeyValueRecord *record = records[key];
+
+			if (record != nil)
+			{
+				OCKeyValueCollection *collection;
+
+				if ((record.type != OCKeyValueRecordTypeCollection) || ((collection = OCTypedCast([record decodeObjectWithClasses:[NSSet setWithObject:[OCKeyValueCollection class]]], OCKeyValueCollection)) == nil))
+				{
+					OCLogError(@"Failed to add object to collection for key=%@", key);
+					return (nil);
+				}
+
+				if (![collection canAddEntryWithID:entryID])
+				{
+					return (nil);
+				}
+			}
+
+			return (@[ [[OCKeyValueLogEntry alloc] initWithOperation:OCKeyValueLogOperationCollectionAdd key:key seed:record.seed+1 record:nil claim:nil claimIdentifier:nil entryID:entryID data:objectData] ]);
+		} completionHandler:^(BOOL committed) {
+			didAdd = committed;
+			OCWaitDidFinishTask(waitForUpdateToFinish);
+		}];
+	}
+	else
+	{
+		[self updateStoreContentsWithModifications:^BOOL(OCKeyValueStoreDictionary storeContents) {
+			OCKeyValueRecord *record = storeContents[key];
+			OCKeyValueCollection *collection;
+
+			if (record == nil)
+			{
+				record = [[OCKeyValueRecord alloc] initWithKeyValueCollection];
+			}
+
+			if ((record.type == OCKeyValueRecordTypeCollection) &&
+			    ((collection = OCTypedCast([record decodeObjectWithClasses:[NSSet setWithObject:[OCKeyValueCollection class]]], OCKeyValueCollection)) != nil))
+			{
+				if ([collection addData:objectData withEntryID:entryID])
+				{
+					[record updateWithObject:collection];
+					storeContents[key] = record;
+
+					didAdd = YES;
+					return (YES);
+				}
+			}
+			else
+			{
+				OCLogError(@"Failed to add object to collection for key=%@", key);
+			}
+
+			return (NO);
+		} completionHandler:^{
+			OCWaitDidFinishTask(waitForUpdateToFinish);
+		}];
+	}
+
+	OCWaitForCompletion(waitForUpdateToFinish);
+
+	return (didAdd);
+}
+
+- (BOOL)removeObjectWithEntryID:(OCKeyValueStoreCollectionEntryID)entryID fromCollectionForKey:(OCKeyValueStoreKey)key
+{
+	__block BOOL didRemove = NO;
+
+	OCWaitInitAndStartTask(waitForUpdateToFinish);
+
+	if (_backend == OCKeyValueStoreBackendLog)
+	{
+		[self _updateLogWithEntries:^NSArray<OCKeyValueLogEntry *> *(OCKeyValueStoreDictionary records) {
+			OCKeyValueRecord *record = records[key];
+			OCKeyValueCollection *collection;
+
+			if ((record.type == OCKeyValueRecordTypeCollection) &&
+			    ((collection = OCTypedCast([record decodeObjectWithClasses:[NSSet setWithObject:[OCKeyValueCollection class]]], OCKeyValueCollection)) != nil) &&
+			    ([collection dataForEntryID:entryID] != nil))
+			{
+				return (@[ [[OCKeyValueLogEntry alloc] initWithOperation:OCKeyValueLogOperationCollectionRemove key:key seed:record.seed+1 record:nil claim:nil claimIdentifier:nil entryID:entryID data:nil] ]);
+			}
+
+			return (nil);
+		} completionHandler:^(BOOL committed) {
+			didRemove = committed;
+			OCWaitDidFinishTask(waitForUpdateToFinish);
+		}];
+	}
+	else
+	{
+		[self updateStoreContentsWithModifications:^BOOL(OCKeyValueStoreDictionary storeContents) {
+			OCKeyValueRecord *record = storeContents[key];
+			OCKeyValueCollection *collection;
+
+			if ((record != nil) && (record.type == OCKeyValueRecordTypeCollection) &&
+			    ((collection = OCTypedCast([record decodeObjectWithClasses:[NSSet setWithObject:[OCKeyValueCollection class]]], OCKeyValueCollection)) != nil))
+			{
+				if ([collection removeEntryWithID:entryID])
+				{
+					[record updateWithObject:collection];
+
+					didRemove = YES;
+					return (YES);
+				}
+			}
+
+			return (NO);
+		} completionHandler:^{
+			OCWaitDidFinishTask(waitForUpdateToFinish);
+		}];
+	}
+
+	OCWaitForCompletion(waitForUpdateToFinish);
+
+	return (didRemove);
+}
+
 #pragma mark - Reading values
 - (NSSet<Class> *)_classesForKey:(OCKeyValueStoreKey)key
 {
@@ -455,6 +660,31 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 				}
 			}
 			break;
+
+			case OCKeyValueRecordTypeCollection: {
+				OCKeyValueCollection *collection;
+
+				if ((collection = OCTypedCast([record decodeObjectWithClasses:[NSSet setWithObject:[OCKeyValueCollection class]]], OCKeyValueCollection)) != nil)
+				{
+					NSSet<Class> *classes = [self _classesForKey:key];
+					NSMutableArray *objects = [NSMutableArray new];
+
+					for (OCKeyValueStoreCollectionEntryID entryID in collection.entryIDs)
+					{
+						NSData *objectData;
+						id object;
+
+						if (((objectData = [collection dataForEntryID:entryID]) != nil) &&
+						    ((object = [NSKeyedUnarchiver unarchivedObjectOfClasses:classes fromData:objectData error:NULL]) != nil))
+						{
+							[objects addObject:object];
+						}
+					}
+
+					return (objects);
+				}
+			}
+			break;
 		}
 	}
 
@@ -713,7 +943,12 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 
 			if (strongSelf == nil) { return; }
 
-			if ([[NSFileManager defaultManager] fileExistsAtPath:newURL.path])
+			if (strongSelf->_backend == OCKeyValueStoreBackendLog)
+			{
+				// Only read and apply entries appended since the last read
+				[strongSelf _readLogUpdates];
+			}
+			else if ([[NSFileManager defaultManager] fileExistsAtPath:newURL.path])
 			{
 				// File exists, read and apply updates
 				OCKeyValueStoreDictionary latestStoreContents;
@@ -738,6 +973,61 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 
 - (void)updateStoreContentsWithModifications:(BOOL(^)(OCKeyValueStoreDictionary storeContents))modifier completionHandler:(dispatch_block_t)inCompletionHandler
 {
+	if (_backend == OCKeyValueStoreBackendLog)
+	{
+		[self _updateLogWithEntries:^NSArray<OCKeyValueLogEntry *> *(OCKeyValueStoreDictionary records) {
+			OCKeyValueStoreDictionary storeContents = [[NSMutableDictionary alloc] initWithCapacity:records.count];
+			NSMutableDictionary<OCKeyValueStoreKey, NSNumber *> *seedsByKey = [[NSMutableDictionary alloc] initWithCapacity:records.count];
+			NSDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> *recordsBefore;
+			NSMutableArray<OCKeyValueLogEntry *> *entries = nil;
+
+			// Let the modifier work on detached copies of the records, so uncommitted modifications don't affect the current contents
+			for (OCKeyValueStoreKey key in records)
+			{
+				OCKeyValueRecord *record = [records[key] detachedCopy];
+
+				storeContents[key] = record;
+				seedsByKey[key] = @(record.seed);
+			}
+
+			recordsBefore = [storeContents copy];
+
+			if (modifier(storeContents))
+			{
+				entries = [NSMutableArray new];
+
+				// Log new and updated records
+				for (OCKeyValueStoreKey key in storeContents)
+				{
+					OCKeyValueRecord *record = storeContents[key];
+
+					if ((record != recordsBefore[key]) || (record.seed != seedsByKey[key].unsignedIntegerValue))
+					{
+						[entries addObject:[OCKeyValueLogEntry setEntryForKey:key record:record]];
+					}
+				}
+
+				// Log removed records
+				for (OCKeyValueStoreKey key in recordsBefore)
+				{
+					if (storeContents[key] == nil)
+					{
+						[entries addObject:[OCKeyValueLogEntry entryWithOperation:OCKeyValueLogOperationRemoveRecord key:key seed:0]];
+					}
+				}
+			}
+
+			return (entries);
+		} completionHandler:^(BOOL committed) {
+			if (inCompletionHandler != nil)
+			{
+				inCompletionHandler();
+			}
+		}];
+
+		return;
+	}
+
 	[_coordinationQueue addOperationWithBlock:^{
 		NSError *error = nil;
 
@@ -815,6 +1105,297 @@ typedef NSMutableDictionary<OCKeyValueStoreKey, OCKeyValueRecord *> * OCKeyValue
 	}];
 }
 
+#pragma mark - Log backend
+- (void)_openLog
+{
+	// Must be called from _coordinationQueue, within a coordinated write
+	OCKeyValueStoreDictionary recordsByKey = [NSMutableDictionary new];
+	NSError *error = nil;
+
+	if ([OCKeyValueLog isLogAtURL:_url])
+	{
+		NSArray<OCKeyValueLogEntry *> *entries;
+
+		if ((entries = [_log readNewEntries:NULL error:&error]) != nil)
+		{
+			[self _applyLogEntries:entries toRecords:recordsByKey changedKeys:nil];
+		}
+		else
+		{
+			OCLogError(@"Error reading log: %@", error);
+		}
+	}
+	else
+	{
+		OCKeyValueStoreDictionary archivedRecordsByKey;
+
+		// Convert existing archive (if any) to a new log
+		if ([[NSFileManager defaultManager] fileExistsAtPath:_url.path] && ((archivedRecordsByKey = [self _readStoreContentsAtURL:_url]) != nil))
+		{
+			OCLogDebug(@"Converting %lu records from archive to log", (unsigned long)archivedRecordsByKey.count);
+			recordsByKey = archivedRecordsByKey;
+		}
+
+		if (![_log writeLogWithRecords:recordsByKey error:&error])
+		{
+			OCLogError(@"Error creating log: %@", error);
+		}
+	}
+
+	@synchronized(self)
+	{
+		_recordsByKey = recordsByKey;
+	}
+}
+
+- (void)_applyLogEntries:(NSArray<OCKeyValueLogEntry *> *)entries toRecords:(OCKeyValueStoreDictionary)records changedKeys:(nullable NSMutableSet<OCKeyValueStoreKey> *)changedKeys
+{
+	for (OCKeyValueLogEntry *entry in entries)
+	{
+		OCKeyValueStoreKey key = entry.key;
+		OCKeyValueRecord *record = records[key];
+
+		if (key == nil) { continue; }
+
+		switch (entry.operation)
+		{
+			case OCKeyValueLogOperationSetRecord:
+				records[key] = entry.record;
+			break;
+
+			case OCKeyValueLogOperationRemoveRecord:
+				records[key] = nil;
+			break;
+
+			case OCKeyValueLogOperationStackPush:
+			case OCKeyValueLogOperationStackPop: {
+				OCKeyValueStack *stack;
+
+				if (record == nil)
+				{
+					if (entry.operation == OCKeyValueLogOperationStackPop) { continue; }
+
+					record = [[OCKeyValueRecord alloc] initWithKeyValueStack];
+					records[key] = record;
+				}
+
+				if ((record.type == OCKeyValueRecordTypeStack) && ((stack = OCTypedCast([record decodeObjectWithClasses:[NSSet setWithObject:[OCKeyValueStack class]]], OCKeyValueStack)) != nil))
+				{
+					if (entry.operation == OCKeyValueLogOperationStackPush)
+					{
+						[stack pushObject:entry.data withClaim:entry.claim];
+					}
+					else
+					{
+						[stack popObjectWithClaimID:entry.claimIdentifier];
+					}
+
+					[record invalidateDataWithSeed:entry.seed];
+				}
+			}
+			break;
+
+			case OCKeyValueLogOperationCollectionAdd:
+			case OCKeyValueLogOperationCollectionRemove: {
+				OCKeyValueCollection *collection;
+
+				if (record == nil)
+				{
+					if (entry.operation == OCKeyValueLogOperationCollectionRemove) { continue; }
+
+					record = [[OCKeyValueRecord alloc] initWithKeyValueCollection];
+					records[key] = record;
+				}
+
+				if ((record.type == OCKeyValueRecordTypeCollection) && ((collection = OCTypedCast([record decodeObjectWithClasses:[NSSet setWithObject:[OCKeyValueCollection class]]], OCKeyValueCollection)) != nil))
+				{
+					if (entry.operation == OCKeyValueLogOperationCollectionAdd)
+					{
+						if (entry.data != nil)
+						{
+							[collection addData:entry.data withEntryID:entry.entryID];
+						}
+					}
+					else
+					{
+						[collection removeEntryWithID:entry.entryID];
+					}
+
+					[record invalidateDataWithSeed:entry.seed];
+				}
+			}
+			break;
+		}
+
+		[changedKeys addObject:key];
+	}
+}
+
+- (BOOL)_readLogUpdates
+{
+	// Must be called from _coordinationQueue, within a coordinated read or write
+	NSArray<OCKeyValueLogEntry *> *entries;
+	NSError *error = nil;
+	BOOL reset = NO;
+
+	if ((entries = [_log readNewEntries:&reset error:&error]) == nil)
+	{
+		OCLogError(@"Error reading log updates: %@", error);
+		return (NO);
+	}
+
+	if (reset)
+	{
+		// Log was compacted or replaced: rebuild from scratch and compare with current contents
+		OCKeyValueStoreDictionary latestStoreContents = [NSMutableDictionary new];
+
+		[self _applyLogEntries:entries toRecords:latestStoreContents changedKeys:nil];
+
+		@synchronized(self)
+		{
+			[self _updateFromStoreContents:latestStoreContents];
+		}
+	}
+	else if (entries.count > 0)
+	{
+		NSMutableSet<OCKeyValueStoreKey> *changedKeys = [NSMutableSet new];
+
+		@synchronized(self)
+		{
+			[self _applyLogEntries:entries toRecords:_recordsByKey changedKeys:changedKeys];
+		}
+
+		for (OCKeyValueStoreKey key in changedKeys)
+		{
+			[self notifyObserversOfNewValueForKey:key];
+		}
+	}
+
+	return (YES);
+}
+
+- (void)_updateLogWithEntries:(NSArray<OCKeyValueLogEntry *> * _Nullable(^)(OCKeyValueStoreDictionary records))entryProvider completionHandler:(void(^)(BOOL committed))inCompletionHandler
+{
+	[_coordinationQueue addOperationWithBlock:^{
+		NSError *error = nil;
+
+		OCBackgroundTask *backgroundTask = [[OCBackgroundTask backgroundTaskWithName:@"OCKeyValueStore updateLogWithEntries" expirationHandler:^(OCBackgroundTask * _Nonnull task) {
+			OCWTLogWarning(nil, @"%@ background task expired", task.name);
+			[task end];
+		}] start];
+
+		[self->_coordinator coordinateWritingItemAtURL:self.url options:NSFileCoordinatorWritingForMerging error:&error byAccessor:^(NSURL * _Nonnull newURL) {
+			void(^completionHandler)(BOOL committed) = inCompletionHandler;
+			NSArray<OCKeyValueLogEntry *> *entries = nil;
+			OCKeyValueStoreDictionary records;
+			NSError *error = nil;
+			BOOL caughtUp;
+
+			// Catch up with entries appended by other instances and processes
+			if (!(caughtUp = [self _readLogUpdates]))
+			{
+				if (![[NSFileManager defaultManager] fileExistsAtPath:self.url.path])
+				{
+					// Log was removed - re-create it from the current contents
+					@synchronized(self)
+					{
+						caughtUp = [self->_log writeLogWithRecords:self->_recordsByKey error:NULL];
+					}
+				}
+				else
+				{
+					// Log exists, but couldn't be read (f.ex. caught mid-replacement) - retry once
+					caughtUp = [self _readLogUpdates];
+				}
+			}
+
+			if (!caughtUp)
+			{
+				// Appending with an outdated offset would truncate entries appended by other processes, so abort instead
+				OCLogError(@"Aborting log update because log couldn't be caught up");
+
+				if (completionHandler != nil)
+				{
+					completionHandler(NO);
+				}
+				return;
+			}
+
+			// Determine entries to append, from a snapshot (modifiers are not called with the lock held)
+			@synchronized(self)
+			{
+				records = [self->_recordsByKey mutableCopy];
+			}
+
+			entries = entryProvider(records);
+
+			if (entries.count > 0)
+			{
+				if ([self->_log appendEntries:entries error:&error])
+				{
+					NSMutableSet<OCKeyValueStoreKey> *changedKeys = [NSMutableSet new];
+
+					// Apply entries to local copy
+					@synchronized(self)
+					{
+						[self _applyLogEntries:entries toRecords:self->_recordsByKey changedKeys:changedKeys];
+					}
+
+					for (OCKeyValueStoreKey key in changedKeys)
+					{
+						[self notifyObserversOfNewValueForKey:key];
+					}
+
+					// Compact log if it has grown significantly
+					if (self->_log.needsCompaction)
+					{
+						@synchronized(self)
+						{
+							if (![self->_log writeLogWithRecords:self->_recordsByKey error:&error])
+							{
+								OCLogError(@"Error compacting log: %@", error);
+							}
+						}
+					}
+
+					void(^postCompletionHandler)(BOOL committed) = completionHandler;
+					completionHandler = nil;
+
+					[self->_coordinationQueue addOperationWithBlock: ^{
+						[self _postUpdateNotifications];
+
+						if (postCompletionHandler != nil)
+						{
+							postCompletionHandler(YES);
+						}
+					}];
+				}
+				else
+				{
+					OCLogError(@"Error appending to log: %@", error);
+				}
+			}
+
+			if (completionHandler != nil)
+			{
+				completionHandler(NO);
+			}
+		}];
+
+		if (error != nil)
+		{
+			OCLogError(@"Error coordinating write: %@", error);
+
+			if (inCompletionHandler != nil)
+			{
+				inCompletionHandler(NO);
+			}
+		}
+
+		[backgroundTask end];
+	}];
+}
+
 #pragma mark - Log tags
 + (NSArray<OCLogTagName> *)logTags
 {
@@ -19,6 +19,7 @@
 #import <Foundation/Foundation.h>
 #import "OCLock.h"
 #import "OCKeyValueStore.h"
+#import "OCLockTable.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -30,6 +31,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark - Individual instances
 - (instancetype)initWithKeyValueStore:(OCKeyValueStore *)keyValueStore;
+- (instancetype)initWithLockTable:(nullable OCLockTable *)lockTable keyValueStore:(nullable OCKeyValueStore *)keyValueStore; //!< Manages locks in lockTable. Locks for resources the lock table can't provide (or all locks, if lockTable is nil or another process keeps a record of the lock table being unavailable in keyValueStore) are managed in keyValueStore.
 
 #pragma mark - Locking
 - (void)requestLock:(OCLockRequest *)lockRequest; //!< Requests a lock, allowing to coordinate changes across processes.
@@ -38,5 +40,6 @@ NS_ASSUME_NONNULL_BEGIN
 @end
 
 extern OCKeyValueStoreKey OCKeyValueStoreKeyManagedLocks;
+extern OCKeyValueStoreKey OCKeyValueStoreKeyLockTableUnavailable; //!< Date at which a process that can't open the lock table last recorded it as unavailable. While the record is recent, all processes manage their locks in the KVS. The process refreshes the record while it uses locks, so it expires once the process terminates or no longer uses locks.
 
 NS_ASSUME_NONNULL_END
@@ -20,6 +20,10 @@
 #import "OCLockRequest.h"
 #import "OCAppIdentity.h"
 #import "NSError+OCError.h"
+#import "OCIPNotificationCenter.h"
+#import "OCMacros.h"
+
+#define OCLockTableUnavailableValidity (OCLockExpirationInterval * 8.0) // Records of the lock table being unavailable expire unless refreshed within this interval
 
 #pragma mark - Database helper
 
@@ -66,12 +70,23 @@
 @interface OCLockManager ()
 {
 	OCKeyValueStore *_keyValueStore;
+	OCLockTable *_lockTable;
 
 	NSMutableArray<OCLockRequest *> *_requests;
 
 	NSMutableArray<OCLock *> *_locks;
 	NSMutableArray<OCLockIdentifier> *_lockIdentifiers;
 	NSMutableArray<OCLockIdentifier> *_releasedLockIdentifiers;
+	NSMutableDictionary<OCLockIdentifier, NSNumber *> *_lockTableTokensByLockIdentifier;
+
+	NSDate *_lockTableUnavailableDate; //!< Start of the period in which at least one process records the lock table as unavailable, nil if there's no such period
+	NSDate *_lockTableUnavailableUntil; //!< Date at which the most recent record of the lock table being unavailable expires
+	BOOL _recordsLockTableUnavailable; //!< YES if this process can't use the lock table and keeps its record of the lock table being unavailable alive
+	BOOL _lockTableSuspended; //!< YES while the lock table is not used because another process records it as unavailable
+	BOOL _lockTableResumed; //!< YES after the lock table is used again, while locks acquired in the KVS in the meantime may still be held
+	NSMutableSet<OCLockIdentifier> *_migratingLockIdentifiers; //!< Locks acquired in the lock table that still need to be added to the KVS
+
+	NSMutableSet<OCLockResourceIdentifier> *_observedResourceIdentifiers;
 
 	dispatch_queue_t _lockQueue;
 	BOOL _needsUpdate;
@@ -88,21 +103,40 @@
 	static OCLockManager *sharedLockManager = nil;
 
 	dispatch_once(&onceToken, ^{
-		NSURL *lockStoreURL;
+		NSURL *lockStoreURL, *lockTableURL;
 		OCKeyValueStore *keyValueStore = nil;
+		OCLockTable *lockTable = nil;
 
 		if ((lockStoreURL = [OCAppIdentity.sharedAppIdentity.appGroupContainerURL URLByAppendingPathComponent:@"lockManager.db"]) != nil)
 		{
 			keyValueStore = [[OCKeyValueStore alloc] initWithURL:lockStoreURL identifier:@"OCLockManager"];
 		}
 
-		sharedLockManager = [[OCLockManager alloc] initWithKeyValueStore:keyValueStore];
+		if ((lockTableURL = [OCAppIdentity.sharedAppIdentity.appGroupContainerURL URLByAppendingPathComponent:@"lockManager.table"]) != nil)
+		{
+			NSString *appIdentifierPrefix = OCAppIdentity.sharedAppIdentity.appIdentifierPrefix;
+
+			lockTable = [[OCLockTable alloc] initWithURL:lockTableURL identifier:((appIdentifierPrefix != nil) ? [appIdentifierPrefix stringByAppendingString:@"OCLockManager"] : @"OCLockManager")];
+		}
+
+		sharedLockManager = [[OCLockManager alloc] initWithLockTable:lockTable keyValueStore:keyValueStore];
+
+		if ((lockTableURL != nil) && (lockTable == nil))
+		{
+			// Lock table could not be opened in this process => make all processes manage their locks in the KVS, so they keep coordinating with this one
+			[sharedLockManager _recordLockTableUnavailable];
+		}
 	});
 
 	return (sharedLockManager);
 }
 
 - (instancetype)initWithKeyValueStore:(OCKeyValueStore *)keyValueStore
+{
+	return ([self initWithLockTable:nil keyValueStore:keyValueStore]);
+}
+
+- (instancetype)initWithLockTable:(OCLockTable *)lockTable keyValueStore:(OCKeyValueStore *)keyValueStore
 {
 	if ((self = [super init]) != nil)
 	{
@@ -111,9 +145,16 @@
 		_locks = [NSMutableArray new];
 		_lockIdentifiers = [NSMutableArray new];
 		_releasedLockIdentifiers = [NSMutableArray new];
+		_lockTableTokensByLockIdentifier = [NSMutableDictionary new];
+		_migratingLockIdentifiers = [NSMutableSet new];
+
+		_observedResourceIdentifiers = [NSMutableSet new];
 
 		_lockQueue = dispatch_queue_create("OCLockManager serial queue", DISPATCH_QUEUE_SERIAL_WITH_AUTORELEASE_POOL);
 
+		// Set up lock table
+		_lockTable = lockTable;
+
 		// Set up KVS
 		_keyValueStore = keyValueStore;
 
@@ -124,6 +165,13 @@
 		[_keyValueStore addObserver:^(OCKeyValueStore * _Nonnull store, id  _Nullable owner, OCKeyValueStoreKey  _Nonnull key, id  _Nullable newValue) {
 			[(OCLockManager *)owner setNeedsLockUpdate];
 		} forKey:OCKeyValueStoreKeyManagedLocks withOwner:self initial:NO];
+
+		// Register class for and observe OCKeyValueStoreKeyLockTableUnavailable
+		[_keyValueStore registerClass:NSDate.class forKey:OCKeyValueStoreKeyLockTableUnavailable];
+
+		[_keyValueStore addObserver:^(OCKeyValueStore * _Nonnull store, id  _Nullable owner, OCKeyValueStoreKey  _Nonnull key, id  _Nullable newValue) {
+			[(OCLockManager *)owner _lockTableBecameUnavailableAt:OCTypedCast(newValue, NSDate)];
+		} forKey:OCKeyValueStoreKeyLockTableUnavailable withOwner:self initial:YES];
 	}
 
 	return (self);
@@ -132,6 +180,11 @@
 - (void)dealloc
 {
 	OCLogDebug(@"Dealloc %@", self);
+
+	for (OCLockResourceIdentifier resourceIdentifier in _observedResourceIdentifiers)
+	{
+		[_lockTable removeWaiterForResource:resourceIdentifier];
+	}
 }
 
 - (void)requestLock:(OCLockRequest *)lockRequest
@@ -152,7 +205,19 @@
 	{
 		if ([_locks indexOfObjectIdenticalTo:lock] != NSNotFound)
 		{
-			[_releasedLockIdentifiers addObject:lock.identifier];
+			NSNumber *lockTableToken;
+
+			if ((lockTableToken = _lockTableTokensByLockIdentifier[lock.identifier]) != nil)
+			{
+				// Release in lock table right away (which also wakes up waiting lock managers)
+				[_lockTable releaseLockForResource:lock.resourceIdentifier token:lockTableToken.unsignedIntValue];
+				[_lockTableTokensByLockIdentifier removeObjectForKey:lock.identifier];
+			}
+			else
+			{
+				[_releasedLockIdentifiers addObject:lock.identifier];
+			}
+
 			[_lockIdentifiers removeObject:lock.identifier];
 			[_locks removeObject:lock];
 
@@ -192,15 +257,405 @@
 	}
 }
 
-- (void)_updateLocks
+- (BOOL)_lockTableProvidesLockForResource:(OCLockResourceIdentifier)resourceIdentifier
 {
-	__block NSMutableArray<OCLockRequest *> *processedRequests = nil;
-	__block NSDate *nextRelevantExpirationDate = nil;
+	return ((_lockTable != nil) && !_lockTableSuspended && [_lockTable providesLockForResource:resourceIdentifier]);
+}
+
+#pragma mark - Lock table
+- (void)_updateLocksInLockTableWithProcessedRequests:(NSMutableArray<OCLockRequest *> *)processedRequests invalidatedLockIdentifiers:(NSMutableArray<OCLockIdentifier> *)invalidatedLockIdentifiers nextRelevantExpirationDate:(NSDate **)ioNextRelevantExpirationDate
+{
+	NSMutableSet<OCLockResourceIdentifier> *waitingResourceIdentifiers = [NSMutableSet new];
+	NSDate *nextRelevantExpirationDate = *ioNextRelevantExpirationDate;
+	NSDictionary<OCLockResourceIdentifier, NSDate *> *keyValueStoreLockExpirationDates = nil;
+
+	if (_lockTableResumed)
+	{
+		// Locks acquired in the KVS while the lock table was unavailable are not part of the lock table => honor them until they have been released
+		if ((keyValueStoreLockExpirationDates = [self _expirationDatesOfLocksInKeyValueStore]).count == 0)
+		{
+			_lockTableResumed = NO;
+			keyValueStoreLockExpirationDates = nil;
+		}
+	}
+
+	// Keep own locks alive - or find out that they expired and were taken over
+	@synchronized(_locks)
+	{
+		for (OCLock *lock in _locks)
+		{
+			NSNumber *lockTableToken;
+
+			if ((lockTableToken = _lockTableTokensByLockIdentifier[lock.identifier]) != nil)
+			{
+				NSDate *previousExpirationDate = lock.expirationDate;
+
+				[lock keepAlive:YES];
+
+				if (![_lockTable renewLockForResource:lock.resourceIdentifier token:lockTableToken.unsignedIntValue expirationDate:lock.expirationDate])
+				{
+					lock.expirationDate = previousExpirationDate;
+					[invalidatedLockIdentifiers addObject:lock.identifier];
+				}
+			}
+		}
+	}
+
+	// Fulfill requests
+	@synchronized(_requests)
+	{
+		for (OCLockRequest *request in _requests)
+		{
+			OCLockTableToken lockTableToken;
+			NSDate *holderExpirationDate = nil;
+			OCLock *lock;
+
+			if (![_lockTable providesLockForResource:request.resourceIdentifier])
+			{
+				// Managed in KVS
+				continue;
+			}
+
+			if ((holderExpirationDate = keyValueStoreLockExpirationDates[request.resourceIdentifier]) != nil)
+			{
+				// Lock is still held in the KVS (release of the lock updates the KVS, which triggers another update)
+				if (request.returnAfterFirstAttempt)
+				{
+					[request invalidate];
+					[processedRequests addObject:request];
+				}
+
+				if ((nextRelevantExpirationDate == nil) || (holderExpirationDate.timeIntervalSinceReferenceDate < nextRelevantExpirationDate.timeIntervalSinceReferenceDate))
+				{
+					nextRelevantExpirationDate = holderExpirationDate;
+				}
+
+				continue;
+			}
+
+			lock = [[OCLock alloc] initWithIdentifier:request.resourceIdentifier];
+
+			if ((lockTableToken = [_lockTable acquireLockForResource:request.resourceIdentifier expirationDate:lock.expirationDate holderExpirationDate:&holderExpirationDate]) != 0)
+			{
+				if (request.invalidated || ((request.lockNeededHandler != nil) && !request.lockNeededHandler(request)))
+				{
+					// Lock no longer needed
+					[_lockTable releaseLockForResource:request.resourceIdentifier token:lockTableToken];
+				}
+				else
+				{
+					lock.manager = self;
+
+					@synchronized(_locks)
+					{
+						_lockTableTokensByLockIdentifier[lock.identifier] = @(lockTableToken);
+					}
+
+					// Store in request
+					request.lock = lock;
+				}
+
+				// Schedule request for notification and removal
+				[processedRequests addObject:request];
+			}
+			else
+			{
+				// Lock can't be acquired at this time
+				if (request.returnAfterFirstAttempt)
+				{
+					// Invalidate request and schedule it for removal
+					[request invalidate];
+					[processedRequests addObject:request];
+				}
+				else
+				{
+					[waitingResourceIdentifiers addObject:request.resourceIdentifier];
+				}
+
+				if ((holderExpirationDate != nil) && ((nextRelevantExpirationDate == nil) || (holderExpirationDate.timeIntervalSinceReferenceDate < nextRelevantExpirationDate.timeIntervalSinceReferenceDate)))
+				{
+					nextRelevantExpirationDate = holderExpirationDate;
+				}
+			}
+		}
+	}
+
+	*ioNextRelevantExpirationDate = nextRelevantExpirationDate;
+
+	// Observe releases of locks requests are waiting for
+	if (![waitingResourceIdentifiers isEqualToSet:_observedResourceIdentifiers])
+	{
+		BOOL addedObservers = NO;
+
+		for (OCLockResourceIdentifier resourceIdentifier in _observedResourceIdentifiers)
+		{
+			if (![waitingResourceIdentifiers containsObject:resourceIdentifier])
+			{
+				[OCIPNotificationCenter.sharedNotificationCenter removeObserver:self forName:[_lockTable releaseNotificationNameForResource:resourceIdentifier]];
+				[_lockTable removeWaiterForResource:resourceIdentifier];
+			}
+		}
+
+		for (OCLockResourceIdentifier resourceIdentifier in waitingResourceIdentifiers)
+		{
+			if (![_observedResourceIdentifiers containsObject:resourceIdentifier])
+			{
+				[OCIPNotificationCenter.sharedNotificationCenter addObserver:self forName:[_lockTable releaseNotificationNameForResource:resourceIdentifier] withHandler:^(OCIPNotificationCenter * _Nonnull notificationCenter, OCLockManager *lockManager, OCIPCNotificationName  _Nonnull notificationName) {
+					[lockManager setNeedsLockUpdate];
+				}];
+				[_lockTable addWaiterForResource:resourceIdentifier];
+
+				addedObservers = YES;
+			}
+		}
+
+		_observedResourceIdentifiers = waitingResourceIdentifiers;
+
+		if (addedObservers)
+		{
+			// Try again in case the lock was released before the observer was added
+			[self setNeedsLockUpdate];
+		}
+	}
+}
+
+#pragma mark - Lock table availability
+- (void)_recordLockTableUnavailable
+{
+	// Records - or refreshes the record - that this process can't use the lock table. Records expire after OCLockTableUnavailableValidity, so that the
+	// other processes return to the lock table once this process has terminated, is suspended or no longer uses locks.
+	NSDate *recordDate = [NSDate new];
+
+	@synchronized(self)
+	{
+		_recordsLockTableUnavailable = YES;
+	}
+
+	[_keyValueStore storeObject:recordDate forKey:OCKeyValueStoreKeyLockTableUnavailable];
+
+	[self _lockTableBecameUnavailableAt:recordDate];
+}
+
+- (void)_lockTableBecameUnavailableAt:(NSDate *)recordDate
+{
+	NSDate *unavailableUntil;
+
+	if (recordDate == nil)
+	{
+		return;
+	}
+
+	if ((unavailableUntil = [recordDate dateByAddingTimeInterval:OCLockTableUnavailableValidity]).timeIntervalSinceNow <= 0)
+	{
+		// Record has expired (f.ex. left behind by a process that has since terminated)
+		return;
+	}
+
+	@synchronized(self)
+	{
+		if ((_lockTableUnavailableDate != nil) && (_lockTableUnavailableUntil.timeIntervalSinceNow > 0))
+		{
+			// Refresh of the record for the current period
+			if (unavailableUntil.timeIntervalSinceReferenceDate > _lockTableUnavailableUntil.timeIntervalSinceReferenceDate)
+			{
+				_lockTableUnavailableUntil = unavailableUntil;
+			}
+
+			return;
+		}
+
+		_lockTableUnavailableDate = recordDate;
+		_lockTableUnavailableUntil = unavailableUntil;
+	}
+
+	OCLogWarning(@"Lock table unavailable in at least one process since %@ - managing locks in KVS", recordDate);
+
+	[self setNeedsLockUpdate];
+}
+
+- (void)_updateLockTableAvailabilityWithNextRelevantExpirationDate:(NSDate **)ioNextRelevantExpirationDate
+{
+	// Must be called from _lockQueue
+	NSDate *unavailableDate = nil, *unavailableUntil = nil, *nextCheckDate = nil;
+	BOOL refreshesRecord = NO;
+
+	if (_recordsLockTableUnavailable)
+	{
+		// Keep the record alive while this process needs to coordinate locks with the other processes
+		@synchronized(_locks)
+		{
+			refreshesRecord = (_locks.count > 0);
+		}
+
+		@synchronized(_requests)
+		{
+			refreshesRecord = refreshesRecord || (_requests.count > 0);
+		}
+
+		@synchronized(self)
+		{
+			unavailableUntil = _lockTableUnavailableUntil;
+		}
+
+		if (refreshesRecord && ((unavailableUntil == nil) || (unavailableUntil.timeIntervalSinceNow < (OCLockTableUnavailableValidity / 2.0))))
+		{
+			[self _recordLockTableUnavailable];
+		}
+	}
+
+	@synchronized(self)
+	{
+		if ((_lockTableUnavailableUntil != nil) && (_lockTableUnavailableUntil.timeIntervalSinceNow <= 0))
+		{
+			// Record expired
+			_lockTableUnavailableDate = nil;
+			_lockTableUnavailableUntil = nil;
+		}
+
+		unavailableDate = _lockTableUnavailableDate;
+		unavailableUntil = _lockTableUnavailableUntil;
+	}
+
+	if (unavailableDate != nil)
+	{
+		if ((_lockTable != nil) && !_lockTableSuspended)
+		{
+			// The lock table is unavailable in at least one process => manage all locks in the KVS
+			[self _stopUsingLockTable];
+		}
+
+		// Check again when the record is due for a refresh - or expires
+		nextCheckDate = refreshesRecord ? [unavailableUntil dateByAddingTimeInterval:-(OCLockTableUnavailableValidity / 2.0)] : unavailableUntil;
+
+		if ((*ioNextRelevantExpirationDate == nil) || (nextCheckDate.timeIntervalSinceReferenceDate < (*ioNextRelevantExpirationDate).timeIntervalSinceReferenceDate))
+		{
+			*ioNextRelevantExpirationDate = nextCheckDate;
+		}
+	}
+	else if (_lockTableSuspended)
+	{
+		// Record expired => return to the lock table
+		OCLogWarning(@"Lock table available again - resuming use of the lock table");
+
+		_lockTableSuspended = NO;
+		_lockTableResumed = YES;
+	}
+}
+
+- (NSDate *)_lockTableUnavailableDate
+{
+	@synchronized(self)
+	{
+		return (_lockTableUnavailableDate);
+	}
+}
+
+- (NSDate *)_lockTableUnavailableUntil
+{
+	@synchronized(self)
+	{
+		return (_lockTableUnavailableUntil);
+	}
+}
+
+- (void)_stopUsingLockTable
+{
+	// Stop waiting for releases in the lock table
+	for (OCLockResourceIdentifier resourceIdentifier in _observedResourceIdentifiers)
+	{
+		[OCIPNotificationCenter.sharedNotificationCenter removeObserver:self forName:[_lockTable releaseNotificationNameForResource:resourceIdentifier]];
+		[_lockTable removeWaiterForResource:resourceIdentifier];
+	}
+
+	_observedResourceIdentifiers = [NSMutableSet new];
+
+	// Move locks held in the lock table to the KVS. They are not released in the lock table, so that processes still using it can't acquire them until they expire there.
+	@synchronized(_locks)
+	{
+		[_migratingLockIdentifiers addObjectsFromArray:_lockTableTokensByLockIdentifier.allKeys];
+		[_lockTableTokensByLockIdentifier removeAllObjects];
+
+		_lockTableSuspended = YES;
+		_lockTableResumed = NO;
+	}
+}
+
+- (NSDictionary<OCLockResourceIdentifier, NSDate *> *)_expirationDatesOfLocksInKeyValueStore
+{
+	OCLockDatabase *database = OCTypedCast([_keyValueStore readObjectForKey:OCKeyValueStoreKeyManagedLocks], OCLockDatabase);
+	NSMutableDictionary<OCLockResourceIdentifier, NSDate *> *expirationDates = [NSMutableDictionary new];
+
+	[database.lockByResourceIdentifier enumerateKeysAndObjectsUsingBlock:^(OCLockResourceIdentifier resourceIdentifier, OCLock *lock, BOOL *stop) {
+		if (lock.isValid)
+		{
+			expirationDates[resourceIdentifier] = lock.expirationDate;
+		}
+	}];
+
+	return (expirationDates);
+}
+
+#pragma mark - KVS
+- (BOOL)_needsKeyValueStoreUpdate
+{
+	if ((_lockTable == nil) || _lockTableSuspended)
+	{
+		return (YES);
+	}
+
+	@synchronized(_locks)
+	{
+		if (_releasedLockIdentifiers.count > 0)
+		{
+			return (YES);
+		}
+
+		for (OCLock *lock in _locks)
+		{
+			if (_lockTableTokensByLockIdentifier[lock.identifier] == nil)
+			{
+				return (YES);
+			}
+		}
+	}
+
+	@synchronized(_requests)
+	{
+		for (OCLockRequest *request in _requests)
+		{
+			if (![_lockTable providesLockForResource:request.resourceIdentifier])
+			{
+				return (YES);
+			}
+		}
+	}
+
+	return (NO);
+}
+
+- (void)_updateLocksInKeyValueStoreWithProcessedRequests:(NSMutableArray<OCLockRequest *> *)processedRequests invalidatedLockIdentifiers:(NSMutableArray<OCLockIdentifier> *)outInvalidatedLockIdentifiers nextRelevantExpirationDate:(NSDate **)ioNextRelevantExpirationDate
+{
+	__block NSDate *nextRelevantExpirationDate = *ioNextRelevantExpirationDate;
 	NSMutableArray<OCLockIdentifier> *invalidatedLockIdentifiers = nil;
+	NSDate *lockTableUnavailableDate = [self _lockTableUnavailableDate];
+	NSDate *lockTableMigrationEndDate = nil, *lockTableReturnDate = nil;
+
+	if ((lockTableUnavailableDate != nil) && ((lockTableMigrationEndDate = [lockTableUnavailableDate dateByAddingTimeInterval:OCLockExpirationInterval]).timeIntervalSinceNow <= 0))
+	{
+		// Locks held in the lock table have since been moved to the KVS or expired
+		lockTableMigrationEndDate = nil;
+	}
+
+	if ((lockTableUnavailableDate != nil) && (_lockTable != nil) && ((lockTableReturnDate = [self _lockTableUnavailableUntil]).timeIntervalSinceNow >= OCLockExpirationInterval))
+	{
+		// Return to the lock table is not imminent
+		lockTableReturnDate = nil;
+	}
 
 	@synchronized (_locks)
 	{
 		invalidatedLockIdentifiers = [_lockIdentifiers mutableCopy];
+		[invalidatedLockIdentifiers removeObjectsInArray:_lockTableTokensByLockIdentifier.allKeys]; // Locks managed in the lock table are not part of the KVS
 	}
 
 	[_keyValueStore updateObjectForKey:OCKeyValueStoreKeyManagedLocks usingModifier:^id _Nullable(id  _Nullable existingObject, BOOL * _Nonnull outDidModify) {
@@ -272,12 +727,70 @@
 			*outDidModify = YES;
 		}
 
+		// Add locks acquired in the lock table before it became unavailable
+		@synchronized(self->_locks)
+		{
+			if (self->_migratingLockIdentifiers.count > 0)
+			{
+				for (OCLock *lock in self->_locks)
+				{
+					if ([self->_migratingLockIdentifiers containsObject:lock.identifier] && [invalidatedLockIdentifiers containsObject:lock.identifier])
+					{
+						OCLock *existingLock = database.lockByResourceIdentifier[lock.resourceIdentifier];
+
+						if ((existingLock == nil) || !existingLock.isValid)
+						{
+							[lock keepAlive:YES];
+							database.lockByResourceIdentifier[lock.resourceIdentifier] = lock;
+							[invalidatedLockIdentifiers removeObject:lock.identifier];
+
+							*outDidModify = YES;
+						}
+					}
+				}
+			}
+		}
+
 		// Fulfill requests
 		@synchronized(self->_requests)
 		{
 			for (OCLockRequest *request in self->_requests)
 			{
+				if ([self _lockTableProvidesLockForResource:request.resourceIdentifier])
+				{
+					// Managed in lock table
+					continue;
+				}
+
 				OCLock *lock = database.lockByResourceIdentifier[request.resourceIdentifier];
+				NSDate *waitUntilDate = nil;
+
+				if ((lock == nil) && (lockTableMigrationEndDate != nil))
+				{
+					// Other processes may not have moved their locks from the lock table to the KVS yet => wait until those would have expired
+					waitUntilDate = lockTableMigrationEndDate;
+				}
+				else if ((lock == nil) && (lockTableReturnDate != nil) && [self->_lockTable providesLockForResource:request.resourceIdentifier])
+				{
+					// Processes are about to return to the lock table and may not see a lock acquired in the KVS now => wait and acquire it in the lock table
+					waitUntilDate = lockTableReturnDate;
+				}
+
+				if (waitUntilDate != nil)
+				{
+					if (request.returnAfterFirstAttempt)
+					{
+						[request invalidate];
+						[processedRequests addObject:request];
+					}
+
+					if ((nextRelevantExpirationDate == nil) || (waitUntilDate.timeIntervalSinceReferenceDate < nextRelevantExpirationDate.timeIntervalSinceReferenceDate))
+					{
+						nextRelevantExpirationDate = waitUntilDate;
+					}
+
+					continue;
+				}
 
 				if (lock == nil)
 				{
@@ -285,7 +798,6 @@
 					if (request.invalidated || ((request.lockNeededHandler != nil) && !request.lockNeededHandler(request)))
 					{
 						// Request processed, schedule for removal
-						if (processedRequests == nil) { processedRequests = [NSMutableArray new]; }
 						[processedRequests addObject:request];
 					}
 					else
@@ -301,7 +813,6 @@
 						request.lock = lock;
 
 						// Schedule requests for notification and removal
-						if (processedRequests == nil) { processedRequests = [NSMutableArray new]; }
 						[processedRequests addObject:request];
 
 						*outDidModify = YES;
@@ -318,7 +829,6 @@
 						[request invalidate];
 
 						// Schedule request for removal
-						if (processedRequests == nil) { processedRequests = [NSMutableArray new]; }
 						[processedRequests addObject:request];
 					}
 
@@ -335,6 +845,37 @@
 		return (database);
 	}];
 
+	@synchronized(_locks)
+	{
+		[_migratingLockIdentifiers removeAllObjects];
+	}
+
+	[outInvalidatedLockIdentifiers addObjectsFromArray:invalidatedLockIdentifiers];
+	*ioNextRelevantExpirationDate = nextRelevantExpirationDate;
+}
+
+#pragma mark - Update
+- (void)_updateLocks
+{
+	NSMutableArray<OCLockRequest *> *processedRequests = [NSMutableArray new];
+	NSMutableArray<OCLockIdentifier> *invalidatedLockIdentifiers = [NSMutableArray new];
+	NSDate *nextRelevantExpirationDate = nil;
+
+	if (_keyValueStore != nil)
+	{
+		[self _updateLockTableAvailabilityWithNextRelevantExpirationDate:&nextRelevantExpirationDate];
+	}
+
+	if ((_lockTable != nil) && !_lockTableSuspended)
+	{
+		[self _updateLocksInLockTableWithProcessedRequests:processedRequests invalidatedLockIdentifiers:invalidatedLockIdentifiers nextRelevantExpirationDate:&nextRelevantExpirationDate];
+	}
+
+	if ([self _needsKeyValueStoreUpdate])
+	{
+		[self _updateLocksInKeyValueStoreWithProcessedRequests:processedRequests invalidatedLockIdentifiers:invalidatedLockIdentifiers nextRelevantExpirationDate:&nextRelevantExpirationDate];
+	}
+
 	// Process request results
 	if (processedRequests.count > 0)
 	{
@@ -407,6 +948,7 @@
 
 				[_locks removeObject:lock];
 				[_lockIdentifiers removeObject:lock.identifier];
+				[_lockTableTokensByLockIdentifier removeObjectForKey:lock.identifier];
 			}
 		}
 
@@ -471,3 +1013,4 @@
 @end
 
 OCKeyValueStoreKey OCKeyValueStoreKeyManagedLocks = @"managedLocks";
+OCKeyValueStoreKey OCKeyValueStoreKeyLockTableUnavailable = @"lockTableUnavailable";
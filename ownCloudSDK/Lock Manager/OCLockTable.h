@@ -0,0 +1,63 @@
+//
+//  OCLockTable.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCLock.h"
+#import "OCIPNotificationCenter.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef uint32_t OCLockTableToken; //!< Identifies a lock acquisition. 0 indicates that no lock was acquired.
+
+/*
+	Table of locks in a small memory-mapped file, shared by all processes that open the same file.
+
+	Each resource is assigned a slot (by hash of its identifier). A slot's state - the token of the current holder and
+	the expiration date of its lock - is stored in a single 64-bit word, so that acquiring, renewing and releasing a lock
+	is a single compare-and-swap on shared memory. flock() is only used to initialize the file. Releasing a lock that others
+	wait for posts a notification specific to the resource, so only the waiting processes are woken up.
+
+	Slots are never freed. If the table is full, -providesLockForResource: returns NO for resources without slot. Since the
+	table only ever fills up, all processes then agree on which resources need to be coordinated by other means.
+*/
+
+@interface OCLockTable : NSObject
+
+@property(strong,readonly) NSURL *url; //!< URL of the table file, including the path extension for the table's version and slot count
+@property(strong,readonly) NSString *identifier;
+
+@property(readonly) NSUInteger slotCount;
+
+- (nullable instancetype)initWithURL:(NSURL *)url identifier:(NSString *)identifier; //!< Opens (or creates) the table at url, with a path extension for the table's version and slot count appended. Returns nil if the file can't be created or mapped.
+
+#pragma mark - Locks
+- (BOOL)providesLockForResource:(OCLockResourceIdentifier)resourceIdentifier; //!< Returns YES if the resource has a slot in the table, allocating one if needed and possible.
+
+- (OCLockTableToken)acquireLockForResource:(OCLockResourceIdentifier)resourceIdentifier expirationDate:(NSDate *)expirationDate holderExpirationDate:(NSDate * _Nullable * _Nullable)outHolderExpirationDate; //!< Acquires the lock for the resource if it is not held or has expired. Returns the token of the new lock - or 0 and the expiration date of the lock held by someone else.
+- (BOOL)renewLockForResource:(OCLockResourceIdentifier)resourceIdentifier token:(OCLockTableToken)token expirationDate:(NSDate *)expirationDate; //!< Extends the lock held with token. Returns NO if the lock is no longer held with token.
+- (BOOL)releaseLockForResource:(OCLockResourceIdentifier)resourceIdentifier token:(OCLockTableToken)token; //!< Releases the lock held with token and - if there are waiters - posts -releaseNotificationNameForResource:. Returns NO if the lock is no longer held with token.
+
+#pragma mark - Waiters
+- (void)addWaiterForResource:(OCLockResourceIdentifier)resourceIdentifier; //!< Registers interest in release notifications for the resource. Try to acquire the lock again after registering, as it may have been released in the meantime.
+- (void)removeWaiterForResource:(OCLockResourceIdentifier)resourceIdentifier;
+
+- (OCIPCNotificationName)releaseNotificationNameForResource:(OCLockResourceIdentifier)resourceIdentifier; //!< Name of the inter-process notification posted when the lock for the resource is released while there are waiters
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,359 @@
+//
+//  OCLockTable.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <sys/mman.h>
+#import <sys/file.h>
+#import <sys/stat.h>
+#import <stdatomic.h>
+
+#import "OCLockTable.h"
+#import "OCLogger.h"
+
+#define OCLockTableMagic		0x4F434C54	// "OCLT"
+#define OCLockTableVersion		1
+#define OCLockTableDefaultSlotCount	1024
+
+#define OCLockTableExpirationBits	40		// Expiration in milliseconds since the table's epoch (good for ~34 years)
+#define OCLockTableExpirationMask	((1ULL << OCLockTableExpirationBits) - 1)
+#define OCLockTableTokenMask		0xFFFFFFU	// Tokens occupy the remaining 24 bits of a slot's state
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t slotCount;
+	_Atomic(uint32_t) nextToken;
+	int64_t epoch;			//!< Milliseconds since 1970 that expiration dates are relative to
+	uint8_t reserved[40];
+} OCLockTableHeader;
+
+typedef struct
+{
+	_Atomic(uint64_t) resourceHash;	//!< Hash of the resource identifier, 0 if the slot is unused
+	_Atomic(uint64_t) state;	//!< (token << OCLockTableExpirationBits) | expiration, 0 if the lock is not held
+	_Atomic(uint32_t) waiterCount;	//!< Number of waiters registered via -addWaiterForResource:
+	uint32_t reserved;
+} OCLockTableSlot;
+
+_Static_assert(sizeof(OCLockTableHeader) == 64, "Unexpected OCLockTableHeader size");
+_Static_assert(sizeof(OCLockTableSlot) == 24, "Unexpected OCLockTableSlot size");
+
+@implementation OCLockTable
+{
+	OCLockTableHeader *_header;
+	OCLockTableSlot *_slots;
+	size_t _mappedSize;
+}
+
+- (instancetype)initWithURL:(NSURL *)url identifier:(NSString *)identifier
+{
+	if ((self = [super init]) != nil)
+	{
+		struct stat fileStat;
+		size_t fileSize = sizeof(OCLockTableHeader) + (OCLockTableDefaultSlotCount * sizeof(OCLockTableSlot));
+		void *mappedTable;
+		int fd;
+
+		// Tables with a different layout use a different file, so an existing file is never resized while other processes have it mapped (which would crash them)
+		_url = url = [url URLByAppendingPathExtension:[NSString stringWithFormat:@"v%d-%d", OCLockTableVersion, OCLockTableDefaultSlotCount]];
+		_identifier = identifier;
+
+		if ((fd = open(url.fileSystemRepresentation, O_RDWR | O_CREAT | O_CLOEXEC, 0600)) < 0)
+		{
+			OCLogError(@"Error %d opening lock table at %@", errno, url);
+			return (nil);
+		}
+
+		// Serialize initialization across processes
+		flock(fd, LOCK_EX);
+
+		if (fstat(fd, &fileStat) != 0)
+		{
+			OCLogError(@"Error %d determining size of lock table at %@", errno, url);
+
+			flock(fd, LOCK_UN);
+			close(fd);
+			return (nil);
+		}
+
+		if (fileStat.st_size == 0)
+		{
+			// New file (only mapped once sized, since sizing happens while holding the flock)
+			if (ftruncate(fd, (off_t)fileSize) != 0)
+			{
+				OCLogError(@"Error %d sizing lock table at %@", errno, url);
+
+				flock(fd, LOCK_UN);
+				close(fd);
+				return (nil);
+			}
+		}
+		else if (fileStat.st_size != (off_t)fileSize)
+		{
+			OCLogError(@"Lock table at %@ has unexpected size %lld", url, (long long)fileStat.st_size);
+
+			flock(fd, LOCK_UN);
+			close(fd);
+			return (nil);
+		}
+
+		if ((mappedTable = mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+		{
+			OCLogError(@"Error %d mapping lock table at %@", errno, url);
+
+			flock(fd, LOCK_UN);
+			close(fd);
+			return (nil);
+		}
+
+		_mappedSize = fileSize;
+		_header = (OCLockTableHeader *)mappedTable;
+		_slots = (OCLockTableSlot *)(((uint8_t *)mappedTable) + sizeof(OCLockTableHeader));
+
+		if ((_header->magic == OCLockTableMagic) && ((_header->version != OCLockTableVersion) || (_header->slotCount != OCLockTableDefaultSlotCount)))
+		{
+			// Initialized table with a different layout - other processes may be using it, so leave it alone
+			OCLogError(@"Lock table at %@ has unexpected version %u or slot count %u", url, _header->version, _header->slotCount);
+
+			munmap(mappedTable, fileSize);
+			_header = NULL;
+
+			flock(fd, LOCK_UN);
+			close(fd);
+			return (nil);
+		}
+
+		if (_header->magic != OCLockTableMagic)
+		{
+			// New table (or one whose initialization didn't complete, so no process is using it)
+			memset(mappedTable, 0, fileSize);
+
+			_header->version = OCLockTableVersion;
+			_header->slotCount = OCLockTableDefaultSlotCount;
+			_header->epoch = (int64_t)(NSDate.date.timeIntervalSince1970 * 1000.0);
+			atomic_store(&_header->nextToken, 1);
+
+			// Mark as initialized last
+			atomic_thread_fence(memory_order_release);
+			_header->magic = OCLockTableMagic;
+		}
+
+		// The mapping remains valid after closing the file descriptor (which also releases the flock)
+		flock(fd, LOCK_UN);
+		close(fd);
+
+		_slotCount = _header->slotCount;
+	}
+
+	return (self);
+}
+
+- (void)dealloc
+{
+	if (_header != NULL)
+	{
+		munmap(_header, _mappedSize);
+		_header = NULL;
+	}
+}
+
+#pragma mark - Slots
+- (uint64_t)_hashForResource:(OCLockResourceIdentifier)resourceIdentifier
+{
+	// FNV-1a. Resources sharing a hash also share a slot, which serializes them, but never allows two holders of the same lock.
+	const char *utf8String = resourceIdentifier.UTF8String;
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	while ((utf8String != NULL) && (*utf8String != 0))
+	{
+		hash ^= (uint8_t)*utf8String;
+		hash *= 0x100000001b3ULL;
+		utf8String++;
+	}
+
+	return ((hash != 0) ? hash : 1);
+}
+
+- (OCLockTableSlot *)_slotForResource:(OCLockResourceIdentifier)resourceIdentifier create:(BOOL)create
+{
+	uint64_t hash = [self _hashForResource:resourceIdentifier];
+
+	// Linear probing. Slots are only ever added, so the first unused slot ends the search.
+	for (NSUInteger probe=0; probe < _slotCount; probe++)
+	{
+		OCLockTableSlot *slot = &_slots[(hash + probe) % _slotCount];
+		uint64_t slotHash = atomic_load(&slot->resourceHash);
+
+		if (slotHash == 0)
+		{
+			if (!create)
+			{
+				return (NULL);
+			}
+
+			if (atomic_compare_exchange_strong(&slot->resourceHash, &slotHash, hash))
+			{
+				return (slot);
+			}
+
+			// Slot was claimed by another process in the meantime, slotHash now contains its hash
+		}
+
+		if (slotHash == hash)
+		{
+			return (slot);
+		}
+	}
+
+	return (NULL);
+}
+
+- (uint64_t)_expirationFromDate:(NSDate *)date
+{
+	int64_t expiration = (int64_t)(date.timeIntervalSince1970 * 1000.0) - _header->epoch;
+
+	return ((uint64_t)MIN(MAX(expiration, 1), (int64_t)OCLockTableExpirationMask));
+}
+
+- (NSDate *)_dateFromExpiration:(uint64_t)expiration
+{
+	return ([NSDate dateWithTimeIntervalSince1970:((double)(_header->epoch + (int64_t)expiration)) / 1000.0]);
+}
+
+#pragma mark - Locks
+- (BOOL)providesLockForResource:(OCLockResourceIdentifier)resourceIdentifier
+{
+	return ([self _slotForResource:resourceIdentifier create:YES] != NULL);
+}
+
+- (OCLockTableToken)acquireLockForResource:(OCLockResourceIdentifier)resourceIdentifier expirationDate:(NSDate *)expirationDate holderExpirationDate:(NSDate * _Nullable __autoreleasing * _Nullable)outHolderExpirationDate
+{
+	OCLockTableSlot *slot;
+	OCLockTableToken token;
+	uint64_t state, now, newState;
+
+	if ((slot = [self _slotForResource:resourceIdentifier create:YES]) == NULL)
+	{
+		return (0);
+	}
+
+	token = (atomic_fetch_add(&_header->nextToken, 1) % OCLockTableTokenMask) + 1;
+	newState = (((uint64_t)token) << OCLockTableExpirationBits) | [self _expirationFromDate:expirationDate];
+	now = [self _expirationFromDate:NSDate.date];
+	state = atomic_load(&slot->state);
+
+	do
+	{
+		if ((state != 0) && ((state & OCLockTableExpirationMask) > now))
+		{
+			// Held by someone else and not yet expired
+			if (outHolderExpirationDate != NULL)
+			{
+				*outHolderExpirationDate = [self _dateFromExpiration:(state & OCLockTableExpirationMask)];
+			}
+
+			return (0);
+		}
+	} while (!atomic_compare_exchange_weak(&slot->state, &state, newState));
+
+	return (token);
+}
+
+- (BOOL)renewLockForResource:(OCLockResourceIdentifier)resourceIdentifier token:(OCLockTableToken)token expirationDate:(NSDate *)expirationDate
+{
+	OCLockTableSlot *slot;
+	uint64_t state, newState;
+
+	if ((slot = [self _slotForResource:resourceIdentifier create:NO]) == NULL)
+	{
+		return (NO);
+	}
+
+	newState = (((uint64_t)token) << OCLockTableExpirationBits) | [self _expirationFromDate:expirationDate];
+	state = atomic_load(&slot->state);
+
+	do
+	{
+		if ((state >> OCLockTableExpirationBits) != token)
+		{
+			// Released or taken over after expiration
+			return (NO);
+		}
+	} while (!atomic_compare_exchange_weak(&slot->state, &state, newState));
+
+	return (YES);
+}
+
+- (BOOL)releaseLockForResource:(OCLockResourceIdentifier)resourceIdentifier token:(OCLockTableToken)token
+{
+	OCLockTableSlot *slot;
+	uint64_t state;
+
+	if ((slot = [self _slotForResource:resourceIdentifier create:NO]) == NULL)
+	{
+		return (NO);
+	}
+
+	state = atomic_load(&slot->state);
+
+	do
+	{
+		if ((state >> OCLockTableExpirationBits) != token)
+		{
+			return (NO);
+		}
+	} while (!atomic_compare_exchange_weak(&slot->state, &state, 0));
+
+	if (atomic_load(&slot->waiterCount) > 0)
+	{
+		[OCIPNotificationCenter.sharedNotificationCenter postNotificationForName:[self releaseNotificationNameForResource:resourceIdentifier] ignoreSelf:NO];
+	}
+
+	return (YES);
+}
+
+#pragma mark - Waiters
+- (void)addWaiterForResource:(OCLockResourceIdentifier)resourceIdentifier
+{
+	OCLockTableSlot *slot;
+
+	if ((slot = [self _slotForResource:resourceIdentifier create:YES]) != NULL)
+	{
+		atomic_fetch_add(&slot->waiterCount, 1);
+	}
+}
+
+- (void)removeWaiterForResource:(OCLockResourceIdentifier)resourceIdentifier
+{
+	OCLockTableSlot *slot;
+
+	if ((slot = [self _slotForResource:resourceIdentifier create:NO]) != NULL)
+	{
+		uint32_t waiterCount = atomic_load(&slot->waiterCount);
+
+		while ((waiterCount > 0) && !atomic_compare_exchange_weak(&slot->waiterCount, &waiterCount, waiterCount - 1)) {}
+	}
+}
+
+#pragma mark - Notifications
+- (OCIPCNotificationName)releaseNotificationNameForResource:(OCLockResourceIdentifier)resourceIdentifier
+{
+	return ([NSString stringWithFormat:@"%@.released.%016llx", _identifier, [self _hashForResource:resourceIdentifier]]);
+}
+
+@end
@@ -82,6 +82,7 @@ typedef BOOL(^OCLogFilter)(OCLogger *logger, OCLogLevel logLevel, NSString * _Nu
 @property(readonly,class) OCLogFormat logFormat;
 @property(assign,class) BOOL maskPrivateData;
 @property(readonly,class) BOOL synchronousLoggingEnabled;
+@property(readonly,class) BOOL bufferedLoggingEnabled; //!< If YES, log messages are captured as compact records in per-thread ring buffers and only formatted when they are written in batches on the writeQueue
 @property(readonly,class) BOOL coloredLogging;
 
 @property(copy,readonly,nonatomic) NSArray<OCLogWriter *> *writers;
@@ -107,6 +108,8 @@ typedef BOOL(^OCLogFilter)(OCLogger *logger, OCLogLevel logLevel, NSString * _Nu
 
 - (void)rawAppendLogLevel:(OCLogLevel)logLevel functionName:(NSString * _Nullable)functionName file:(NSString * _Nullable)file line:(NSUInteger)line tags:(nullable NSArray<OCLogTagName> *)tags logMessage:(NSString *)logMessage threadID:(uint64_t)threadID timestamp:(NSDate *)timestamp forceSyncWrite:(BOOL)forceSyncWrite;
 
+- (void)flushBufferedRecords; //!< Formats and writes all buffered log records synchronously. Can be called from any thread, including the writeQueue.
+
 #pragma mark - Sources
 - (void)addSource:(OCLogSource *)logSource;
 - (void)removeSource:(OCLogSource *)logSource;
@@ -134,6 +137,7 @@ extern OCClassSettingsKey OCClassSettingsKeyLogLevel;
 extern OCClassSettingsKey OCClassSettingsKeyLogPrivacyMask;
 extern OCClassSettingsKey OCClassSettingsKeyLogEnabledComponents;
 extern OCClassSettingsKey OCClassSettingsKeyLogSynchronousLogging;
+extern OCClassSettingsKey OCClassSettingsKeyLogBufferedLogging;
 extern OCClassSettingsKey OCClassSettingsKeyLogColored;
 extern OCClassSettingsKey OCClassSettingsKeyLogOnlyTags;
 extern OCClassSettingsKey OCClassSettingsKeyLogOmitTags;
@@ -27,7 +27,9 @@
 #import "OCAppIdentity.h"
 #import "OCIPNotificationCenter.h"
 #import "OCMacros.h"
+#import "OCLogRecordBuffer.h"
 #import <pthread/pthread.h>
+#import <stdatomic.h>
 
 #import "OCConnection.h"
 #import "OCClassSetting.h"
@@ -47,12 +49,30 @@ static BOOL sOCLogReplaceNewLine;
 static NSUInteger sOCLogMessageMaximumSize;
 static OCLogger *sharedLogger;
 
+#define OCLogRecordBufferCapacity 256
+#define OCLogRecordBufferFlushDelay (100 * NSEC_PER_MSEC)
+
+static void *OCLoggerWriteQueueKey = &OCLoggerWriteQueueKey;
+
 @interface OCLogger ()
 {
 	uint64_t _mainThreadThreadID;
+
+	pthread_key_t _recordBufferKey;
+	dispatch_once_t _recordBufferKeyOnceToken;
+	NSMutableArray<OCLogRecordBuffer *> *_recordBuffers;
+	_Atomic(BOOL) _recordBufferFlushScheduled;
 }
 @end
 
+static void OCLoggerRecordBufferThreadDestructor(void *recordBufferPointer)
+{
+	// The thread exits: release the thread's reference, leaving only the one in _recordBuffers. The buffer is removed from there once it has been drained.
+	OCLogRecordBuffer *recordBuffer = (__bridge_transfer OCLogRecordBuffer *)recordBufferPointer;
+
+	recordBuffer.abandoned = YES;
+}
+
 static OCClassSettingsUserPreferencesMigrationIdentifier OCClassSettingsUserPreferencesMigrationIdentifierLogLevel = @"log-level";
 static OCClassSettingsUserPreferencesMigrationIdentifier OCClassSettingsUserPreferencesMigrationIdentifierMaskPrivateData = @"log-mask-private-data";
 
@@ -206,6 +226,7 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCLogger)
 			OCClassSettingsKeyLogPrivacyMask	   : @(NO),
 			OCClassSettingsKeyLogEnabledComponents	   : @[ OCLogComponentIdentifierWriterStandardError, OCLogComponentIdentifierWriterFile ],
 			OCClassSettingsKeyLogSynchronousLogging    : @(NO),
+			OCClassSettingsKeyLogBufferedLogging	   : @(NO),
 			OCClassSettingsKeyLogBlankFilteredMessages : @(NO),
 			OCClassSettingsKeyLogColored		   : @(NO),
 			OCClassSettingsKeyLogSingleLined	   : @(NO),
@@ -285,6 +306,14 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCLogger)
 			OCClassSettingsMetadataKeyFlags		 : @(OCClassSettingsFlagDenyUserPreferences)
 		},
 
+		OCClassSettingsKeyLogBufferedLogging : @{
+			OCClassSettingsMetadataKeyType 	      	 : OCClassSettingsMetadataTypeBoolean,
+			OCClassSettingsMetadataKeyDescription 	 : @"Controls whether log messages should be captured as compact records in per-thread buffers and only be formatted when they are written in batches. Reduces the overhead of logging for the logging threads. Ignored if synchronous logging is enabled.",
+			OCClassSettingsMetadataKeyCategory    	 : @"Logging",
+			OCClassSettingsMetadataKeyStatus	 : OCClassSettingsKeyStatusAdvanced,
+			OCClassSettingsMetadataKeyFlags		 : @(OCClassSettingsFlagDenyUserPreferences)
+		},
+
 		OCClassSettingsKeyLogOnlyTags : @{
 			OCClassSettingsMetadataKeyType 	      	 : OCClassSettingsMetadataTypeStringArray,
 			OCClassSettingsMetadataKeyDescription 	 : @"If set, omits all log messages not tagged with tags in this array.",
@@ -548,6 +577,23 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCLogger)
 	return (synchronousLoggingEnabled);
 }
 
++ (BOOL)bufferedLoggingEnabled
+{
+	static dispatch_once_t onceToken;
+	static BOOL bufferedLoggingEnabled = NO;
+
+	dispatch_once(&onceToken, ^{
+		bufferedLoggingEnabled = ((NSNumber *)[self classSettingForOCClassSettingsKey:OCClassSettingsKeyLogBufferedLogging]).boolValue && !self.synchronousLoggingEnabled;
+
+		if (bufferedLoggingEnabled)
+		{
+			NSLog(@"[LOG] Buffered logging enabled");
+		}
+	});
+
+	return (bufferedLoggingEnabled);
+}
+
 #pragma mark - Init
 - (instancetype)init
 {
@@ -555,6 +601,10 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCLogger)
 	{
 		_writers = [NSMutableArray new];
 		_writeQueue = dispatch_queue_create("OCLogger writer queue", DISPATCH_QUEUE_SERIAL_WITH_AUTORELEASE_POOL);
+		dispatch_queue_set_specific(_writeQueue, OCLoggerWriteQueueKey, (__bridge void *)self, NULL);
+
+		_recordBuffers = [NSMutableArray new];
+		atomic_init(&_recordBufferFlushScheduled, NO);
 
 		_sources = [NSMutableArray new];
 
@@ -579,6 +629,8 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCLogger)
 
 - (void)dealloc
 {
+	[self _writeBufferedRecords];
+
 	[self _closeAllWriters];
 
 	for (OCLogSource *source in _sources)
@@ -631,6 +683,14 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCLogger)
 		NSDate *timestamp;
 		uint64_t threadID = 0;
 
+		if (!forceSyncWrite && OCLogger.bufferedLoggingEnabled)
+		{
+			if ([self _bufferLogLevel:logLevel functionName:functionName file:file line:line tags:tags message:formatString arguments:args])
+			{
+				return;
+			}
+		}
+
 		pthread_threadid_np(pthread_self(), &threadID);
 
 		if (_mainThreadThreadID == 0)
@@ -772,6 +832,149 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCLogger)
 	}
 }
 
+#pragma mark - Buffered logging
+- (OCLogRecordBuffer *)_recordBufferForCurrentThread
+{
+	OCLogRecordBuffer *recordBuffer;
+
+	dispatch_once(&_recordBufferKeyOnceToken, ^{
+		pthread_key_create(&self->_recordBufferKey, OCLoggerRecordBufferThreadDestructor);
+	});
+
+	if ((recordBuffer = (__bridge OCLogRecordBuffer *)pthread_getspecific(_recordBufferKey)) == nil)
+	{
+		uint64_t threadID = 0;
+
+		pthread_threadid_np(pthread_self(), &threadID);
+
+		if ((_mainThreadThreadID == 0) && (pthread_main_np() != 0))
+		{
+			_mainThreadThreadID = threadID;
+		}
+
+		recordBuffer = [[OCLogRecordBuffer alloc] initWithCapacity:OCLogRecordBufferCapacity threadID:threadID];
+
+		@synchronized(_recordBuffers)
+		{
+			[_recordBuffers addObject:recordBuffer];
+		}
+
+		pthread_setspecific(_recordBufferKey, (__bridge_retained void *)recordBuffer);
+	}
+
+	return (recordBuffer);
+}
+
+- (BOOL)_bufferLogLevel:(OCLogLevel)logLevel functionName:(NSString *)functionName file:(NSString *)file line:(NSUInteger)line tags:(nullable NSArray<OCLogTagName> *)tags message:(NSString *)formatString arguments:(va_list)args
+{
+	OCLogRecordBuffer *recordBuffer = [self _recordBufferForCurrentThread];
+	uint64_t timestamp = OCLogRecordBuffer.currentTimestamp;
+	BOOL appended;
+	va_list recordArgs;
+
+	va_copy(recordArgs, args);
+	appended = [recordBuffer appendRecordWithLogLevel:logLevel timestamp:timestamp functionName:functionName file:file line:line tags:tags format:formatString arguments:recordArgs];
+	va_end(recordArgs);
+
+	if (!appended)
+	{
+		// Buffer is full: write out buffered records (blocking this thread until done) and try again
+		[self flushBufferedRecords];
+
+		va_copy(recordArgs, args);
+		appended = [recordBuffer appendRecordWithLogLevel:logLevel timestamp:timestamp functionName:functionName file:file line:line tags:tags format:formatString arguments:recordArgs];
+		va_end(recordArgs);
+	}
+
+	if (appended)
+	{
+		// Schedule a single, batched flush for all records logged until then
+		if (!atomic_exchange(&_recordBufferFlushScheduled, YES))
+		{
+			dispatch_after(dispatch_time(DISPATCH_TIME_NOW, OCLogRecordBufferFlushDelay), _writeQueue, ^{
+				[self _writeBufferedRecords];
+			});
+		}
+	}
+
+	return (appended);
+}
+
+- (void)flushBufferedRecords
+{
+	if (dispatch_get_specific(OCLoggerWriteQueueKey) == (__bridge void *)self)
+	{
+		[self _writeBufferedRecords];
+	}
+	else
+	{
+		dispatch_sync(_writeQueue, ^{
+			[self _writeBufferedRecords];
+		});
+	}
+}
+
+- (void)_writeBufferedRecords
+{
+	NSMutableArray<OCLogBufferedRecord *> *records = [NSMutableArray new];
+	NSArray<OCLogRecordBuffer *> *recordBuffers;
+
+	atomic_store(&_recordBufferFlushScheduled, NO);
+
+	@synchronized(_recordBuffers)
+	{
+		recordBuffers = [_recordBuffers copy];
+	}
+
+	for (OCLogRecordBuffer *recordBuffer in recordBuffers)
+	{
+		// Check .abandoned before dequeuing, so no records can be added after the check
+		BOOL abandoned = recordBuffer.abandoned;
+
+		[recordBuffer dequeueRecordsInto:records];
+
+		if (abandoned)
+		{
+			@synchronized(_recordBuffers)
+			{
+				[_recordBuffers removeObjectIdenticalTo:recordBuffer];
+			}
+		}
+	}
+
+	if (records.count == 0)
+	{
+		return;
+	}
+
+	// Restore chronological order across threads
+	[records sortWithOptions:NSSortStable usingComparator:^NSComparisonResult(OCLogBufferedRecord *record1, OCLogBufferedRecord *record2) {
+		if (record1.timestamp < record2.timestamp) { return (NSOrderedAscending); }
+		if (record1.timestamp > record2.timestamp) { return (NSOrderedDescending); }
+		return (NSOrderedSame);
+	}];
+
+	@synchronized(self) // Serialize with synchronous writes
+	{
+		for (OCLogWriter *writer in _writers)
+		{
+			[writer beginBatch];
+		}
+
+		for (OCLogBufferedRecord *record in records)
+		{
+			@autoreleasepool {
+				[self _rawAppendLogLevel:record.logLevel functionName:record.functionName file:record.file line:record.line tags:record.tags logMessage:record.message threadID:record.threadID timestamp:[OCLogRecordBuffer dateForTimestamp:record.timestamp]];
+			}
+		}
+
+		for (OCLogWriter *writer in _writers)
+		{
+			[writer endBatch];
+		}
+	}
+}
+
 + (id)applyPrivacyMask:(id)object
 {
 	if (self.maskPrivateData && (object!=nil))
@@ -854,6 +1057,8 @@ INCLUDE_IN_CLASS_SETTINGS_SNAPSHOTS(OCLogger)
 - (void)pauseWritersWithIntermittentBlock:(dispatch_block_t)intermittentBlock
 {
 	dispatch_async(_writeQueue, ^{
+		[self _writeBufferedRecords];
+
 		[self _closeAllWriters];
 
 		intermittentBlock();
@@ -1050,6 +1255,7 @@ OCClassSettingsKey OCClassSettingsKeyLogLevel = @"level";
 OCClassSettingsKey OCClassSettingsKeyLogPrivacyMask = @"privacy-mask";
 OCClassSettingsKey OCClassSettingsKeyLogEnabledComponents = @"enabled-components";
 OCClassSettingsKey OCClassSettingsKeyLogSynchronousLogging = @"synchronous";
+OCClassSettingsKey OCClassSettingsKeyLogBufferedLogging = @"buffered";
 OCClassSettingsKey OCClassSettingsKeyLogColored = @"colored";
 OCClassSettingsKey OCClassSettingsKeyLogOnlyTags = @"only-tags";
 OCClassSettingsKey OCClassSettingsKeyLogOmitTags = @"omit-tags";
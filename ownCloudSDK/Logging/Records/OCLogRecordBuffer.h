@@ -0,0 +1,75 @@
+//
+//  OCLogRecordBuffer.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCLogger.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class OCLogBufferedRecord;
+
+/*
+	Single-producer/single-consumer ring buffer of compact log records, used by OCLogger for buffered logging.
+
+	Each thread that logs gets its own buffer (producer), which is drained on the logger's write queue (consumer).
+	Records are appended without locks and contain the log level, a monotonic timestamp, the parsed format string
+	and the raw arguments. Formatting of the message is deferred until the record is written.
+
+	Arguments for %@ are captured as-is for immutable value types (NSString copies, NSNumber, NSDate, NSURL, NSUUID, NSNull),
+	all other objects are captured via their -description at the time of logging, so that later changes to the object
+	are not reflected in the message. Format strings with specifiers that can't be captured (f.ex. "*" width/precision)
+	are formatted immediately.
+*/
+
+@interface OCLogRecordBuffer : NSObject
+
+@property(readonly) uint64_t threadID; //!< ID of the thread this buffer was created for
+@property(readonly,nonatomic) NSUInteger capacity;
+@property(readonly,nonatomic) NSUInteger count; //!< Number of records currently in the buffer
+@property(assign) BOOL abandoned; //!< YES if the thread this buffer was created for has exited. Empty, abandoned buffers can be removed.
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity threadID:(uint64_t)threadID;
+
+#pragma mark - Producer
+- (BOOL)appendRecordWithLogLevel:(OCLogLevel)logLevel timestamp:(uint64_t)timestamp functionName:(nullable NSString *)functionName file:(nullable NSString *)file line:(NSUInteger)line tags:(nullable NSArray<OCLogTagName> *)tags format:(NSString *)format arguments:(va_list)args; //!< Appends a record. Returns NO - without consuming args - if the buffer is full. Must only be called from the thread the buffer was created for.
+
+#pragma mark - Consumer
+- (NSUInteger)dequeueRecordsInto:(NSMutableArray<OCLogBufferedRecord *> *)records; //!< Removes all records from the buffer, appends them to records and returns their number. Must not be called concurrently.
+
+#pragma mark - Timestamps
++ (uint64_t)currentTimestamp; //!< Monotonic timestamp for use with -appendRecordWithLogLevel:…
++ (NSDate *)dateForTimestamp:(uint64_t)timestamp; //!< Converts a monotonic timestamp to a date
+
+@end
+
+@interface OCLogBufferedRecord : NSObject
+
+@property(readonly) OCLogLevel logLevel;
+@property(readonly) uint64_t timestamp;
+@property(readonly) uint64_t threadID;
+
+@property(readonly,nullable,nonatomic) NSString *functionName;
+@property(readonly,nullable,nonatomic) NSString *file;
+@property(readonly) NSUInteger line;
+@property(readonly,nullable,nonatomic) NSArray<OCLogTagName> *tags;
+
+@property(readonly,strong,nonatomic) NSString *message; //!< Message, formatted on first access
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,631 @@
+//
+//  OCLogRecordBuffer.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <stdatomic.h>
+#import <mach/mach_time.h>
+
+#import "OCLogRecordBuffer.h"
+
+#define OCLogRecordMaximumArgumentCount 12
+#define OCLogRecordFormatCacheLimit 256
+
+typedef NS_ENUM(uint8_t, OCLogRecordArgumentType)
+{
+	OCLogRecordArgumentTypeInt32,	//!< int (and smaller types promoted to int)
+	OCLogRecordArgumentTypeInt64,	//!< 64 bit integer types (long, long long, size_t, …)
+	OCLogRecordArgumentTypeDouble,	//!< double (and float promoted to double)
+	OCLogRecordArgumentTypePointer,	//!< void * (%p)
+	OCLogRecordArgumentTypeObject	//!< retained object (%@ and %s, which is captured as NSString)
+};
+
+typedef union
+{
+	int32_t int32;
+	int64_t int64;
+	double doubleValue;
+	void *pointer;
+} OCLogRecordArgumentValue;
+
+#pragma mark - Format
+@interface OCLogRecordFormat : NSObject
+{
+	@public
+	NSArray<NSString *> *_literals; //!< Literal text before each argument, plus the text after the last argument
+	NSArray<NSString *> *_argumentFormats; //!< Format specifier for each argument
+	OCLogRecordArgumentType _argumentTypes[OCLogRecordMaximumArgumentCount];
+	BOOL _argumentIsCString[OCLogRecordMaximumArgumentCount];
+	NSUInteger _argumentCount;
+}
+@end
+
+@implementation OCLogRecordFormat
+
++ (nullable instancetype)formatWithString:(NSString *)formatString
+{
+	OCLogRecordFormat *format = [OCLogRecordFormat new];
+	NSMutableArray<NSString *> *literals = [NSMutableArray new];
+	NSMutableArray<NSString *> *argumentFormats = [NSMutableArray new];
+	NSMutableString *literal = [NSMutableString new];
+	NSUInteger length = formatString.length, idx = 0;
+	unichar *chars;
+
+	if ((chars = malloc((length + 1) * sizeof(unichar))) == NULL)
+	{
+		return (nil);
+	}
+
+	[formatString getCharacters:chars range:NSMakeRange(0, length)];
+	chars[length] = 0; // Terminate, so that parsing can look ahead by one character without range checks
+
+	#define OCLogRecordFormatFail() { free(chars); return (nil); }
+
+	while (idx < length)
+	{
+		NSUInteger specifierStart, literalStart = idx;
+		NSUInteger argumentSize = sizeof(int);
+		BOOL hasPrecision = NO, hasLengthModifier = NO, isCString = NO;
+		OCLogRecordArgumentType argumentType;
+		NSString *argumentFormat;
+
+		// Literal text
+		while ((idx < length) && (chars[idx] != '%')) { idx++; }
+
+		if (idx > literalStart)
+		{
+			[literal appendString:[formatString substringWithRange:NSMakeRange(literalStart, idx - literalStart)]];
+		}
+
+		if (idx >= length) { break; }
+
+		specifierStart = idx++;
+
+		if (chars[idx] == '%')
+		{
+			[literal appendString:@"%"];
+			idx++;
+			continue;
+		}
+
+		// Flags
+		while ((chars[idx] == '-') || (chars[idx] == '+') || (chars[idx] == ' ') || (chars[idx] == '#') || (chars[idx] == '0') || (chars[idx] == '\'')) { idx++; }
+
+		// Width
+		if (chars[idx] == '*') OCLogRecordFormatFail();
+		while ((chars[idx] >= '0') && (chars[idx] <= '9')) { idx++; }
+
+		// Precision
+		if (chars[idx] == '.')
+		{
+			idx++;
+			hasPrecision = YES;
+
+			if (chars[idx] == '*') OCLogRecordFormatFail();
+			while ((chars[idx] >= '0') && (chars[idx] <= '9')) { idx++; }
+		}
+
+		// Length modifier
+		switch (chars[idx])
+		{
+			case 'h':
+				idx++;
+				if (chars[idx] == 'h') { idx++; }
+				hasLengthModifier = YES;
+			break;
+
+			case 'l':
+				idx++;
+				if (chars[idx] == 'l') { idx++; argumentSize = sizeof(long long); }
+				else { argumentSize = sizeof(long); }
+				hasLengthModifier = YES;
+			break;
+
+			case 'q':
+				idx++;
+				argumentSize = sizeof(long long);
+				hasLengthModifier = YES;
+			break;
+
+			case 'z':
+				idx++;
+				argumentSize = sizeof(size_t);
+				hasLengthModifier = YES;
+			break;
+
+			case 't':
+				idx++;
+				argumentSize = sizeof(ptrdiff_t);
+				hasLengthModifier = YES;
+			break;
+
+			case 'j':
+				idx++;
+				argumentSize = sizeof(intmax_t);
+				hasLengthModifier = YES;
+			break;
+
+			case 'L':
+				// long double
+				OCLogRecordFormatFail();
+			break;
+		}
+
+		// Conversion
+		switch (chars[idx])
+		{
+			case 'D': case 'U': case 'O':
+				// Obsolete synonyms for ld, lu, lo
+				argumentType = (sizeof(long) > sizeof(int32_t)) ? OCLogRecordArgumentTypeInt64 : OCLogRecordArgumentTypeInt32;
+			break;
+
+			case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+				argumentType = (argumentSize > sizeof(int32_t)) ? OCLogRecordArgumentTypeInt64 : OCLogRecordArgumentTypeInt32;
+			break;
+
+			case 'c': case 'C':
+				// Characters are promoted to int
+				argumentType = OCLogRecordArgumentTypeInt32;
+			break;
+
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+				argumentType = OCLogRecordArgumentTypeDouble;
+			break;
+
+			case 'p':
+				argumentType = OCLogRecordArgumentTypePointer;
+			break;
+
+			case '@':
+				argumentType = OCLogRecordArgumentTypeObject;
+			break;
+
+			case 's':
+				// C strings are captured as NSString and formatted via %@, which doesn't support a precision
+				if (hasPrecision || hasLengthModifier) OCLogRecordFormatFail();
+
+				argumentType = OCLogRecordArgumentTypeObject;
+				isCString = YES;
+			break;
+
+			default:
+				OCLogRecordFormatFail();
+			break;
+		}
+
+		idx++;
+
+		if (format->_argumentCount >= OCLogRecordMaximumArgumentCount) OCLogRecordFormatFail();
+
+		argumentFormat = [formatString substringWithRange:NSMakeRange(specifierStart, idx - specifierStart)];
+
+		if (isCString)
+		{
+			argumentFormat = [[argumentFormat substringToIndex:argumentFormat.length-1] stringByAppendingString:@"@"];
+		}
+
+		[literals addObject:literal];
+		[argumentFormats addObject:argumentFormat];
+		literal = [NSMutableString new];
+
+		format->_argumentTypes[format->_argumentCount] = argumentType;
+		format->_argumentIsCString[format->_argumentCount] = isCString;
+		format->_argumentCount++;
+	}
+
+	#undef OCLogRecordFormatFail
+
+	free(chars);
+
+	[literals addObject:literal];
+
+	format->_literals = literals;
+	format->_argumentFormats = argumentFormats;
+
+	return (format);
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wformat-nonliteral"
+
+- (NSString *)messageWithArguments:(const OCLogRecordArgumentValue *)arguments
+{
+	NSMutableString *message = [NSMutableString new];
+
+	for (NSUInteger idx=0; idx < _argumentCount; idx++)
+	{
+		NSString *argumentFormat = _argumentFormats[idx];
+
+		[message appendString:_literals[idx]];
+
+		switch (_argumentTypes[idx])
+		{
+			case OCLogRecordArgumentTypeInt32:
+				[message appendFormat:argumentFormat, arguments[idx].int32];
+			break;
+
+			case OCLogRecordArgumentTypeInt64:
+				[message appendFormat:argumentFormat, arguments[idx].int64];
+			break;
+
+			case OCLogRecordArgumentTypeDouble:
+				[message appendFormat:argumentFormat, arguments[idx].doubleValue];
+			break;
+
+			case OCLogRecordArgumentTypePointer:
+				[message appendFormat:argumentFormat, arguments[idx].pointer];
+			break;
+
+			case OCLogRecordArgumentTypeObject:
+				[message appendFormat:argumentFormat, (__bridge id)arguments[idx].pointer];
+			break;
+		}
+	}
+
+	[message appendString:_literals.lastObject];
+
+	return (message);
+}
+
+#pragma clang diagnostic pop
+
+@end
+
+#pragma mark - Record
+typedef struct
+{
+	OCLogLevel logLevel;
+	uint64_t timestamp;
+	NSUInteger line;
+
+	void *functionName;	//!< retained NSString
+	void *file;		//!< retained NSString
+	void *tags;		//!< retained NSArray
+	void *format;		//!< retained OCLogRecordFormat, NULL if message is set
+	void *message;		//!< retained NSString with the formatted message, for format strings that can't be captured
+
+	OCLogRecordArgumentValue arguments[OCLogRecordMaximumArgumentCount];
+} OCLogRecord;
+
+@interface OCLogBufferedRecord ()
+{
+	OCLogRecord _record;
+	uint64_t _threadID;
+	NSString *_message;
+}
+
+- (instancetype)initWithRecord:(OCLogRecord *)record threadID:(uint64_t)threadID;
+
+@end
+
+static id OCLogRecordCaptureObject(id object)
+{
+	if (object == nil)
+	{
+		return (nil);
+	}
+
+	if ([object isKindOfClass:NSString.class])
+	{
+		// Immutable strings return self, mutable strings are copied
+		return ([object copy]);
+	}
+
+	if ([object isKindOfClass:NSNumber.class] ||
+	    [object isKindOfClass:NSDate.class] ||
+	    [object isKindOfClass:NSURL.class] ||
+	    [object isKindOfClass:NSUUID.class] ||
+	    [object isKindOfClass:NSNull.class])
+	{
+		// Immutable value types
+		return (object);
+	}
+
+	// Capture the state of all other objects at the time of logging
+	return ([object description]);
+}
+
+#pragma mark - Buffer
+@interface OCLogRecordBuffer ()
+{
+	OCLogRecord *_records;
+	NSUInteger _capacity;
+
+	_Atomic(NSUInteger) _head; //!< Total number of records appended (written by producer)
+	_Atomic(NSUInteger) _tail; //!< Total number of records dequeued (written by consumer)
+
+	NSMapTable<NSString *, id> *_formatCache; //!< Cache of parsed formats (or NSNull for formats that can't be captured), only accessed by the producer
+}
+@end
+
+@implementation OCLogRecordBuffer
+
+@synthesize capacity = _capacity;
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity threadID:(uint64_t)threadID
+{
+	if ((self = [super init]) != nil)
+	{
+		_capacity = capacity;
+		_threadID = threadID;
+
+		_records = calloc(capacity, sizeof(OCLogRecord));
+
+		atomic_init(&_head, 0);
+		atomic_init(&_tail, 0);
+
+		// Format strings are typically constant, so compare them by pointer (and retain them, so a pointer can't be reused by a different format string)
+		_formatCache = [[NSMapTable alloc] initWithKeyOptions:(NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory capacity:32];
+	}
+
+	return (self);
+}
+
+- (void)dealloc
+{
+	// Release objects of records that were never dequeued
+	NSMutableArray<OCLogBufferedRecord *> *records = [NSMutableArray new];
+
+	[self dequeueRecordsInto:records];
+
+	free(_records);
+}
+
+- (NSUInteger)count
+{
+	return (atomic_load_explicit(&_head, memory_order_acquire) - atomic_load_explicit(&_tail, memory_order_acquire));
+}
+
+#pragma mark - Producer
+- (BOOL)appendRecordWithLogLevel:(OCLogLevel)logLevel timestamp:(uint64_t)timestamp functionName:(NSString *)functionName file:(NSString *)file line:(NSUInteger)line tags:(NSArray<OCLogTagName> *)tags format:(NSString *)formatString arguments:(va_list)args
+{
+	NSUInteger head = atomic_load_explicit(&_head, memory_order_relaxed);
+	NSUInteger tail = atomic_load_explicit(&_tail, memory_order_acquire);
+	OCLogRecordFormat *format;
+	OCLogRecord *record;
+	id cachedFormat;
+
+	if ((head - tail) >= _capacity)
+	{
+		// Buffer full
+		return (NO);
+	}
+
+	// Parse format (or retrieve it from cache)
+	if ((cachedFormat = [_formatCache objectForKey:formatString]) == nil)
+	{
+		if (_formatCache.count >= OCLogRecordFormatCacheLimit)
+		{
+			[_formatCache removeAllObjects];
+		}
+
+		cachedFormat = [OCLogRecordFormat formatWithString:formatString];
+
+		[_formatCache setObject:((cachedFormat != nil) ? cachedFormat : NSNull.null) forKey:formatString];
+	}
+
+	format = [cachedFormat isKindOfClass:OCLogRecordFormat.class] ? cachedFormat : nil;
+
+	// Fill record
+	record = &_records[head % _capacity];
+
+	record->logLevel = logLevel;
+	record->timestamp = timestamp;
+	record->line = line;
+
+	record->functionName = (__bridge_retained void *)functionName;
+	record->file = (__bridge_retained void *)file;
+	record->tags = (__bridge_retained void *)tags;
+
+	if (format != nil)
+	{
+		record->format = (__bridge_retained void *)format;
+		record->message = NULL;
+
+		for (NSUInteger idx=0; idx < format->_argumentCount; idx++)
+		{
+			switch (format->_argumentTypes[idx])
+			{
+				case OCLogRecordArgumentTypeInt32:
+					record->arguments[idx].int32 = va_arg(args, int32_t);
+				break;
+
+				case OCLogRecordArgumentTypeInt64:
+					record->arguments[idx].int64 = va_arg(args, int64_t);
+				break;
+
+				case OCLogRecordArgumentTypeDouble:
+					record->arguments[idx].doubleValue = va_arg(args, double);
+				break;
+
+				case OCLogRecordArgumentTypePointer:
+					record->arguments[idx].pointer = va_arg(args, void *);
+				break;
+
+				case OCLogRecordArgumentTypeObject:
+					if (format->_argumentIsCString[idx])
+					{
+						const char *cString = va_arg(args, const char *);
+
+						record->arguments[idx].pointer = (cString != NULL) ? (__bridge_retained void *)[[NSString alloc] initWithUTF8String:cString] : NULL;
+					}
+					else
+					{
+						record->arguments[idx].pointer = (__bridge_retained void *)OCLogRecordCaptureObject(va_arg(args, id));
+					}
+				break;
+			}
+		}
+	}
+	else
+	{
+		// Format can't be captured, so format immediately
+		record->format = NULL;
+		record->message = (__bridge_retained void *)[[NSString alloc] initWithFormat:formatString arguments:args];
+	}
+
+	// Publish record
+	atomic_store_explicit(&_head, head + 1, memory_order_release);
+
+	return (YES);
+}
+
+#pragma mark - Consumer
+- (NSUInteger)dequeueRecordsInto:(NSMutableArray<OCLogBufferedRecord *> *)records
+{
+	NSUInteger head = atomic_load_explicit(&_head, memory_order_acquire);
+	NSUInteger tail = atomic_load_explicit(&_tail, memory_order_relaxed);
+	NSUInteger count = head - tail;
+
+	for (NSUInteger position = tail; position < head; position++)
+	{
+		OCLogBufferedRecord *bufferedRecord;
+
+		// Ownership of the retained objects in the record is transferred to the OCLogBufferedRecord
+		if ((bufferedRecord = [[OCLogBufferedRecord alloc] initWithRecord:&_records[position % _capacity] threadID:_threadID]) != nil)
+		{
+			[records addObject:bufferedRecord];
+		}
+	}
+
+	// Release slots for reuse by the producer
+	atomic_store_explicit(&_tail, head, memory_order_release);
+
+	return (count);
+}
+
+#pragma mark - Timestamps
+static mach_timebase_info_data_t sOCLogRecordTimebase;
+static uint64_t sOCLogRecordReferenceTimestamp;
+static NSTimeInterval sOCLogRecordReferenceTimeInterval;
+
++ (void)initialize
+{
+	static dispatch_once_t onceToken;
+
+	dispatch_once(&onceToken, ^{
+		mach_timebase_info(&sOCLogRecordTimebase);
+
+		sOCLogRecordReferenceTimestamp = mach_continuous_time();
+		sOCLogRecordReferenceTimeInterval = NSDate.timeIntervalSinceReferenceDate;
+	});
+}
+
++ (uint64_t)currentTimestamp
+{
+	return (mach_continuous_time());
+}
+
++ (NSDate *)dateForTimestamp:(uint64_t)timestamp
+{
+	double deltaNanoseconds = ((double)((int64_t)(timestamp - sOCLogRecordReferenceTimestamp))) * sOCLogRecordTimebase.numer / sOCLogRecordTimebase.denom;
+
+	return ([NSDate dateWithTimeIntervalSinceReferenceDate:sOCLogRecordReferenceTimeInterval + (deltaNanoseconds / (double)NSEC_PER_SEC)]);
+}
+
+@end
+
+#pragma mark - Buffered record
+@implementation OCLogBufferedRecord
+
+- (instancetype)initWithRecord:(OCLogRecord *)record threadID:(uint64_t)threadID
+{
+	if ((self = [super init]) != nil)
+	{
+		_record = *record;
+		_threadID = threadID;
+
+		memset(record, 0, sizeof(OCLogRecord));
+	}
+
+	return (self);
+}
+
+- (void)dealloc
+{
+	OCLogRecordFormat *format = (__bridge OCLogRecordFormat *)_record.format;
+
+	if (format != nil)
+	{
+		for (NSUInteger idx=0; idx < format->_argumentCount; idx++)
+		{
+			if ((format->_argumentTypes[idx] == OCLogRecordArgumentTypeObject) && (_record.arguments[idx].pointer != NULL))
+			{
+				CFRelease(_record.arguments[idx].pointer);
+			}
+		}
+
+		CFRelease(_record.format);
+	}
+
+	if (_record.message != NULL)	  { CFRelease(_record.message); }
+	if (_record.functionName != NULL) { CFRelease(_record.functionName); }
+	if (_record.file != NULL)	  { CFRelease(_record.file); }
+	if (_record.tags != NULL)	  { CFRelease(_record.tags); }
+}
+
+- (OCLogLevel)logLevel
+{
+	return (_record.logLevel);
+}
+
+- (uint64_t)timestamp
+{
+	return (_record.timestamp);
+}
+
+- (NSString *)functionName
+{
+	return ((__bridge NSString *)_record.functionName);
+}
+
+- (NSString *)file
+{
+	return ((__bridge NSString *)_record.file);
+}
+
+- (NSUInteger)line
+{
+	return (_record.line);
+}
+
+- (NSArray<OCLogTagName> *)tags
+{
+	return ((__bridge NSArray<OCLogTagName> *)_record.tags);
+}
+
+- (NSString *)message
+{
+	if (_message == nil)
+	{
+		if (_record.message != NULL)
+		{
+			_message = (__bridge NSString *)_record.message;
+		}
+		else if (_record.format != NULL)
+		{
+			_message = [(__bridge OCLogRecordFormat *)_record.format messageWithArguments:_record.arguments];
+		}
+		else
+		{
+			_message = @"";
+		}
+	}
+
+	return (_message);
+}
+
+@end
@@ -23,6 +23,7 @@
 NSUInteger const OCDefaultMaxLogFileCount = 10;
 NSTimeInterval const OCDefaultRotationTimeInterval = 60.0 * 60.0 * 24.0;
 int64_t const OCDefaultLogRotationFrequency = 60 * NSEC_PER_SEC;
+NSUInteger const OCDefaultMaxBatchDataSize = 64 * 1024;
 
 OCIPCNotificationName OCLogFileWriterLogRecordsChangedRemoteNotification = @"org.owncloud.log_records_remote_change";
 
@@ -34,6 +35,7 @@ OCIPCNotificationName OCLogFileWriterLogRecordsChangedRemoteNotification = @"org
 
 	NSUInteger _maximumLogFileCount;
 
+	NSMutableData *_batchData; //!< Messages collected between -beginBatch and -endBatch
 }
 @end
 
@@ -155,6 +157,8 @@ static NSURL *sDefaultLogFileURL;
 
 	if (_isOpen)
 	{
+		[self _writeBatchData];
+
 		if (OCLogger.logFormat == OCLogFormatText)
 		{
 			[self appendMessageData:[[NSString stringWithFormat:@"-- %@: closing log file --", [NSDate date]] dataUsingEncoding:NSUTF8StringEncoding]];
@@ -178,7 +182,47 @@ static NSURL *sDefaultLogFileURL;
 {
 	if (_isOpen && (data != nil))
 	{
-		write(_logFileFD, data.bytes, (size_t)data.length);
+		if (_batchData != nil)
+		{
+			[_batchData appendData:data];
+
+			if (_batchData.length >= OCDefaultMaxBatchDataSize)
+			{
+				[self _writeBatchData];
+			}
+		}
+		else
+		{
+			write(_logFileFD, data.bytes, (size_t)data.length);
+		}
+	}
+}
+
+#pragma mark - Batching
+- (void)beginBatch
+{
+	if (_batchData == nil)
+	{
+		_batchData = [[NSMutableData alloc] initWithCapacity:OCDefaultMaxBatchDataSize];
+	}
+}
+
+- (void)endBatch
+{
+	[self _writeBatchData];
+	_batchData = nil;
+}
+
+- (void)_writeBatchData
+{
+	if (_batchData.length > 0)
+	{
+		if (_isOpen)
+		{
+			write(_logFileFD, _batchData.bytes, (size_t)_batchData.length);
+		}
+
+		_batchData.length = 0;
 	}
 }
 
@@ -186,6 +230,9 @@ static NSURL *sDefaultLogFileURL;
 {
 	NSError *error = nil;
 
+	// Make sure buffered messages are part of the log files
+	[OCLogger.sharedLogger flushBufferedRecords];
+
 	// Get contents of log directory
 	NSArray *urls = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:OCAppIdentity.sharedAppIdentity.appGroupLogsContainerURL
 						      includingPropertiesForKeys:@[NSURLCreationDateKey, NSURLFileSizeKey]
@@ -59,6 +59,9 @@ typedef void(^OCLogWriteHandler)(NSData *messageData);
 - (void)appendMessageWithLogLevel:(OCLogLevel)logLevel date:(NSDate *)date threadID:(uint64_t)threadID isMainThread:(BOOL)isMainThread privacyMasked:(BOOL)privacyMasked functionName:(NSString *)functionName file:(NSString *)file line:(NSUInteger)line tags:(nullable NSArray<OCLogTagName> *)tags flags:(OCLogLineFlag)flags message:(NSString *)message; //!< By default composes the parameters and calls -appendMessage:
 - (void)appendMessageData:(NSData *)data; //!< Called by the default implementation of -appendMessageWithLogLevel:functionName:file:line:message:
 
+- (void)beginBatch; //!< Called before a batch of messages is appended. Writers can collect the messages until -endBatch is called and then write them at once. The default implementation does nothing.
+- (void)endBatch; //!< Called after a batch of messages has been appended. The default implementation does nothing.
+
 + (NSString*)timestampStringFrom:(NSDate*)date;
 
 @end
@@ -70,6 +70,14 @@ static NSDateFormatter *jsonDateFormatter;
 	return (nil);
 }
 
+- (void)beginBatch
+{
+}
+
+- (void)endBatch
+{
+}
+
 + (NSString*)timestampStringFrom:(NSDate*)date
 {
 	return [dateFormatter stringFromDate:date];
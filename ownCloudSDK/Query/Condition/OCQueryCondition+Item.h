@@ -17,6 +17,7 @@
  */
 
 #import "OCQueryCondition.h"
+#import "OCQueryConditionProgram.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -24,6 +25,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)fulfilledByItem:(OCItem *)item; //!< Returns YES if the provided item fulfills the condition, NO otherwise.
 
+- (OCQueryConditionProgram *)compiledProgram; //!< Returns a new program compiled from the condition, for fast repeated evaluation against many items via -[OCQueryConditionProgram evaluateWithItem:].
+
 - (nullable NSComparator)itemComparator; //!< Returns a comparator sorting items by the property specified by .sortBy and in .sortAscending order.
 
 @end
@@ -192,6 +192,11 @@
 	return (isFulfilled);
 }
 
+- (OCQueryConditionProgram *)compiledProgram
+{
+	return ([OCQueryConditionProgram programForCondition:self]);
+}
+
 - (NSComparator)itemComparator
 {
 	if (self.sortBy != nil)
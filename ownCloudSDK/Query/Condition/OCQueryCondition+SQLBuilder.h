@@ -23,6 +23,8 @@ NS_ASSUME_NONNULL_BEGIN
 @interface OCQueryCondition (SQLBuilder)
 
 - (nullable NSString *)buildSQLQueryWithPropertyColumnNameMap:(NSDictionary<OCItemPropertyName, NSString *> *)propertyColumnNameMap parameters:(NSArray * _Nonnull * _Nullable)outParameters error:(NSError * _Nullable *)error;
+- (nullable NSString *)buildSQLQueryWithPropertyColumnNameMap:(NSDictionary<OCItemPropertyName, NSString *> *)propertyColumnNameMap sortKeyColumnNameMap:(nullable NSDictionary<OCItemPropertyName, NSString *> *)sortKeyColumnNameMap parameters:(NSArray * _Nonnull * _Nullable)outParameters error:(NSError * _Nullable *)error; //!< sortKeyColumnNameMap maps properties with an OCLOCALIZED collated column to a column with their precomputed sort keys (+[OCSQLiteCollationLocalized sortKeyForString:]), which is then used for sorting and greater than/less than comparisons.
+- (nullable NSString *)buildSQLQueryWithPropertyColumnNameMap:(NSDictionary<OCItemPropertyName, NSString *> *)propertyColumnNameMap sortKeyColumnNameMap:(nullable NSDictionary<OCItemPropertyName, NSString *> *)sortKeyColumnNameMap substringIndexQueryMap:(nullable NSDictionary<OCItemPropertyName, NSString *> *)substringIndexQueryMap parameters:(NSArray * _Nonnull * _Nullable)outParameters error:(NSError * _Nullable *)error; //!< substringIndexQueryMap maps properties to an SQL expression with a single "LIKE ?" that is answered from a substring index. It is used instead of a LIKE on the column for prefix, suffix and contains conditions with values of at least three characters.
 
 @end
 
@@ -20,10 +20,34 @@
 #import "OCLogger.h"
 #import "OCMacros.h"
 #import "NSString+OCSQLTools.h"
+#import "OCSQLiteCollationLocalized.h"
 
 @implementation OCQueryCondition (SQLBuilder)
 
 - (NSString *)buildSQLQueryWithPropertyColumnNameMap:(NSDictionary<OCItemPropertyName, NSString *> *)propertyColumnNameMap parameters:(NSArray **)outParameters error:(NSError **)error
+{
+	return ([self buildSQLQueryWithPropertyColumnNameMap:propertyColumnNameMap sortKeyColumnNameMap:nil parameters:outParameters error:error]);
+}
+
+- (NSString *)buildSQLQueryWithPropertyColumnNameMap:(NSDictionary<OCItemPropertyName, NSString *> *)propertyColumnNameMap sortKeyColumnNameMap:(NSDictionary<OCItemPropertyName, NSString *> *)sortKeyColumnNameMap parameters:(NSArray **)outParameters error:(NSError **)error
+{
+	return ([self buildSQLQueryWithPropertyColumnNameMap:propertyColumnNameMap sortKeyColumnNameMap:sortKeyColumnNameMap substringIndexQueryMap:nil parameters:outParameters error:error]);
+}
+
+- (NSString *)_likeQueryForProperty:(OCItemPropertyName)property propertyColumnNameMap:(NSDictionary<OCItemPropertyName, NSString *> *)propertyColumnNameMap substringIndexQueryMap:(NSDictionary<OCItemPropertyName, NSString *> *)substringIndexQueryMap
+{
+	NSString *substringIndexQuery;
+
+	if (((substringIndexQuery = substringIndexQueryMap[property]) != nil) && ([self.value isKindOfClass:NSString.class]) && (((NSString *)self.value).length >= 3))
+	{
+		// Trigram indexes can only answer LIKE patterns containing at least three consecutive characters - and would otherwise fall back to a scan of the entire index
+		return ([[NSString alloc] initWithFormat:@"(%@)", substringIndexQuery]);
+	}
+
+	return ([[NSString alloc] initWithFormat:@"(%@ LIKE ?)", propertyColumnNameMap[property]]);
+}
+
+- (NSString *)buildSQLQueryWithPropertyColumnNameMap:(NSDictionary<OCItemPropertyName, NSString *> *)propertyColumnNameMap sortKeyColumnNameMap:(NSDictionary<OCItemPropertyName, NSString *> *)sortKeyColumnNameMap substringIndexQueryMap:(NSDictionary<OCItemPropertyName, NSString *> *)substringIndexQueryMap parameters:(NSArray **)outParameters error:(NSError **)error
 {
 	NSString *query = nil;
 	NSArray *parameters = nil;
@@ -31,13 +55,22 @@
 	switch (self.operator)
 	{
 		case OCQueryConditionOperatorPropertyGreaterThanValue:
-			query = [[NSString alloc] initWithFormat:@"(%@ > ?)", propertyColumnNameMap[self.property]];
-			parameters = @[ self.value ];
-		break;
+		case OCQueryConditionOperatorPropertyLessThanValue: {
+			NSString *operatorString = (self.operator == OCQueryConditionOperatorPropertyGreaterThanValue) ? @">" : @"<";
+			NSString *sortKeyColumnName;
 
-		case OCQueryConditionOperatorPropertyLessThanValue:
-			query = [[NSString alloc] initWithFormat:@"(%@ < ?)", propertyColumnNameMap[self.property]];
-			parameters = @[ self.value ];
+			if (((sortKeyColumnName = sortKeyColumnNameMap[self.property]) != nil) && [self.value isKindOfClass:NSString.class])
+			{
+				// Compare precomputed sort keys (memcmp) instead of invoking the collation for every row
+				query = [[NSString alloc] initWithFormat:@"(%@ %@ ?)", sortKeyColumnName, operatorString];
+				parameters = @[ [OCSQLiteCollationLocalized sortKeyForString:self.value] ];
+			}
+			else
+			{
+				query = [[NSString alloc] initWithFormat:@"(%@ %@ ?)", propertyColumnNameMap[self.property], operatorString];
+				parameters = @[ self.value ];
+			}
+		}
 		break;
 
 		case OCQueryConditionOperatorPropertyEqualToValue:
@@ -51,17 +84,17 @@
 		break;
 
 		case OCQueryConditionOperatorPropertyHasPrefix:
-			query = [[NSString alloc] initWithFormat:@"(%@ LIKE ?)", propertyColumnNameMap[self.property]];
+			query = [self _likeQueryForProperty:self.property propertyColumnNameMap:propertyColumnNameMap substringIndexQueryMap:substringIndexQueryMap];
 			parameters = @[ [NSString stringWithFormat:@"%@%%", [self.value stringBySQLLikeEscaping]] ];
 		break;
 
 		case OCQueryConditionOperatorPropertyHasSuffix:
-			query = [[NSString alloc] initWithFormat:@"(%@ LIKE ?)", propertyColumnNameMap[self.property]];
+			query = [self _likeQueryForProperty:self.property propertyColumnNameMap:propertyColumnNameMap substringIndexQueryMap:substringIndexQueryMap];
 			parameters = @[ [NSString stringWithFormat:@"%%%@", [self.value stringBySQLLikeEscaping]] ];
 		break;
 
 		case OCQueryConditionOperatorPropertyContains:
-			query = [[NSString alloc] initWithFormat:@"(%@ LIKE ?)", propertyColumnNameMap[self.property]];
+			query = [self _likeQueryForProperty:self.property propertyColumnNameMap:propertyColumnNameMap substringIndexQueryMap:substringIndexQueryMap];
 			parameters = @[ [NSString stringWithFormat:@"%%%@%%", [self.value stringBySQLLikeEscaping]] ];
 		break;
 
@@ -80,7 +113,7 @@
 					NSArray *conditionParameters = nil;
 					NSString *conditionQueryString = nil;
 
-					if ((conditionQueryString = [condition buildSQLQueryWithPropertyColumnNameMap:propertyColumnNameMap parameters:&conditionParameters error:NULL]) != nil)
+					if ((conditionQueryString = [condition buildSQLQueryWithPropertyColumnNameMap:propertyColumnNameMap sortKeyColumnNameMap:sortKeyColumnNameMap substringIndexQueryMap:substringIndexQueryMap parameters:&conditionParameters error:NULL]) != nil)
 					{
 						if (queryString.length > 0)
 						{
@@ -113,7 +146,7 @@
 
 			if ((condition = OCTypedCast(self.value, OCQueryCondition)) != nil)
 			{
-				query = [NSString stringWithFormat:@"(NOT %@)", [condition buildSQLQueryWithPropertyColumnNameMap:propertyColumnNameMap parameters:&parameters error:NULL]];
+				query = [NSString stringWithFormat:@"(NOT %@)", [condition buildSQLQueryWithPropertyColumnNameMap:propertyColumnNameMap sortKeyColumnNameMap:sortKeyColumnNameMap substringIndexQueryMap:substringIndexQueryMap parameters:&parameters error:NULL]];
 			}
 			else
 			{
@@ -127,7 +160,8 @@
 	{
 		NSString *sortByColumnName;
 
-		if ((sortByColumnName = propertyColumnNameMap[self.sortBy]) != nil)
+		if (((sortByColumnName = sortKeyColumnNameMap[self.sortBy]) != nil) || // Sort by precomputed sort keys where available
+		    ((sortByColumnName = propertyColumnNameMap[self.sortBy]) != nil))
 		{
 			query = [query stringByAppendingFormat:@" ORDER BY %@ %@", sortByColumnName, (self.sortAscending ? @"ASC" : @"DESC")];
 		}
@@ -0,0 +1,47 @@
+//
+//  OCQueryConditionProgram.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCQueryCondition.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+	Predicate program compiled from an OCQueryCondition tree, for evaluation against large numbers of items.
+	Produces the same results as -[OCQueryCondition fulfilledByItem:], but:
+
+	- reads properties through their typed getters instead of KVC, so scalar properties aren't boxed
+	- pre-converts scalar operands, so scalar comparisons don't go through NSNumber
+	- orders the conditions of AND/OR groups by evaluation cost, so cheap conditions short-circuit expensive ones
+
+	Conditions that can't be compiled (f.ex. on properties unknown to the runtime) are evaluated via
+	-[OCQueryCondition fulfilledByItem:]. The program doesn't reflect changes made to the condition after
+	compilation. Programs are immutable and can be evaluated from several threads concurrently.
+*/
+
+@interface OCQueryConditionProgram : NSObject
+
+@property(strong,readonly) OCQueryCondition *condition; //!< The condition the program was compiled from
+
++ (instancetype)programForCondition:(OCQueryCondition *)condition;
+
+- (BOOL)evaluateWithItem:(OCItem *)item; //!< Returns YES if the item fulfills the condition, NO otherwise
+
+@end
+
+NS_ASSUME_NONNULL_END
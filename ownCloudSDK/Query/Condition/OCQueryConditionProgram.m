@@ -0,0 +1,501 @@
+//
+//  OCQueryConditionProgram.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <objc/runtime.h>
+#import <objc/message.h>
+
+#import "OCQueryConditionProgram.h"
+#import "OCQueryCondition+Item.h"
+#import "OCMacros.h"
+
+typedef NS_ENUM(uint8_t, OCQueryConditionProgramNodeKind)
+{
+	OCQueryConditionProgramNodeKindAnd,
+	OCQueryConditionProgramNodeKindOr,
+	OCQueryConditionProgramNodeKindNegate,
+
+	OCQueryConditionProgramNodeKindFallback,	//!< Evaluated via -[OCQueryCondition fulfilledByItem:] (also used for malformed groups, to mirror its logging)
+
+	OCQueryConditionProgramNodeKindScalar,		//!< Comparison of a scalar property with a numeric operand
+	OCQueryConditionProgramNodeKindObject		//!< Operation on an object property
+};
+
+typedef struct
+{
+	OCQueryConditionProgramNodeKind kind;
+	OCQueryConditionOperator operator;
+
+	// Property
+	SEL getter;
+	char getterType; //!< Type encoding of the getter's return value
+
+	// Operand
+	BOOL compareAsDouble;
+	long long intOperand;
+	double doubleOperand;
+	__unsafe_unretained id objectOperand; //!< Retained by the program via _retainedObjects
+
+	__unsafe_unretained OCQueryCondition *condition; //!< Retained by the program via _retainedObjects
+
+	// Children (And, Or, Negate)
+	NSUInteger firstChild;
+	NSUInteger childCount;
+} OCQueryConditionProgramNode;
+
+#pragma mark - Compilation node
+@interface OCQueryConditionProgramCompilationNode : NSObject
+{
+	@public
+	OCQueryConditionProgramNode _node;
+	NSArray<OCQueryConditionProgramCompilationNode *> *_children;
+	NSUInteger _cost;
+	NSUInteger _totalNodeCount;
+}
+@end
+
+@implementation OCQueryConditionProgramCompilationNode
+@end
+
+#pragma mark - Program
+@interface OCQueryConditionProgram ()
+{
+	OCQueryConditionProgramNode *_nodes;
+	NSUInteger _nodeCount;
+
+	NSMutableArray *_retainedObjects;
+}
+@end
+
+@implementation OCQueryConditionProgram
+
++ (instancetype)programForCondition:(OCQueryCondition *)condition
+{
+	return ([[self alloc] initWithCondition:condition]);
+}
+
+- (instancetype)initWithCondition:(OCQueryCondition *)condition
+{
+	if ((self = [super init]) != nil)
+	{
+		OCQueryConditionProgramCompilationNode *rootNode;
+
+		_condition = condition;
+		_retainedObjects = [NSMutableArray new];
+
+		rootNode = [self _compileCondition:condition];
+
+		if ((_nodes = calloc(rootNode->_totalNodeCount, sizeof(OCQueryConditionProgramNode))) != NULL)
+		{
+			_nodeCount = 1;
+			[self _layoutNode:rootNode atIndex:0];
+		}
+	}
+
+	return (self);
+}
+
+- (void)dealloc
+{
+	if (_nodes != NULL)
+	{
+		free(_nodes);
+		_nodes = NULL;
+	}
+}
+
+#pragma mark - Compilation
++ (BOOL)_getter:(SEL *)outGetter type:(char *)outType forProperty:(OCItemPropertyName)propertyName
+{
+	objc_property_t property;
+	char *getterName, *typeEncoding;
+	SEL getter;
+	char type;
+
+	if ((propertyName == nil) || ((property = class_getProperty(OCItem.class, propertyName.UTF8String)) == NULL))
+	{
+		return (NO);
+	}
+
+	if ((getterName = property_copyAttributeValue(property, "G")) != NULL)
+	{
+		getter = sel_registerName(getterName);
+		free(getterName);
+	}
+	else
+	{
+		getter = sel_registerName(propertyName.UTF8String);
+	}
+
+	if ((typeEncoding = property_copyAttributeValue(property, "T")) == NULL)
+	{
+		return (NO);
+	}
+
+	type = typeEncoding[0];
+	free(typeEncoding);
+
+	if ((strchr("@cCBsSiIlLqQfd", type) == NULL) || ![OCItem instancesRespondToSelector:getter])
+	{
+		return (NO);
+	}
+
+	*outGetter = getter;
+	*outType = type;
+
+	return (YES);
+}
+
+- (OCQueryConditionProgramCompilationNode *)_compileCondition:(OCQueryCondition *)condition
+{
+	OCQueryConditionProgramCompilationNode *compiledNode = [OCQueryConditionProgramCompilationNode new];
+	OCQueryConditionProgramNode *node = &compiledNode->_node;
+	OCQueryConditionOperator operator = condition.operator;
+	id operand = condition.value;
+
+	[_retainedObjects addObject:condition];
+
+	node->operator = operator;
+	node->condition = condition;
+	node->kind = OCQueryConditionProgramNodeKindFallback;
+
+	compiledNode->_totalNodeCount = 1;
+
+	switch (operator)
+	{
+		case OCQueryConditionOperatorAnd:
+		case OCQueryConditionOperatorOr: {
+			NSArray<OCQueryCondition *> *conditions;
+
+			if ((conditions = OCTypedCast(operand, NSArray)) != nil)
+			{
+				NSMutableArray<OCQueryConditionProgramCompilationNode *> *children = [NSMutableArray new];
+
+				for (OCQueryCondition *childCondition in conditions)
+				{
+					OCQueryConditionProgramCompilationNode *childNode = [self _compileCondition:childCondition];
+
+					compiledNode->_cost += childNode->_cost;
+					compiledNode->_totalNodeCount += childNode->_totalNodeCount;
+
+					[children addObject:childNode];
+				}
+
+				// Evaluate cheapest conditions first
+				compiledNode->_children = [children sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(OCQueryConditionProgramCompilationNode *node1, OCQueryConditionProgramCompilationNode *node2) {
+					if (node1->_cost < node2->_cost) { return (NSOrderedAscending); }
+					if (node1->_cost > node2->_cost) { return (NSOrderedDescending); }
+					return (NSOrderedSame);
+				}];
+
+				node->kind = (operator == OCQueryConditionOperatorAnd) ? OCQueryConditionProgramNodeKindAnd : OCQueryConditionProgramNodeKindOr;
+			}
+			else
+			{
+				// Mirror -fulfilledByItem: (which logs an error and returns NO)
+				compiledNode->_cost = 32;
+			}
+		}
+		break;
+
+		case OCQueryConditionOperatorNegate: {
+			OCQueryCondition *childCondition;
+
+			if ((childCondition = OCTypedCast(operand, OCQueryCondition)) != nil)
+			{
+				OCQueryConditionProgramCompilationNode *childNode = [self _compileCondition:childCondition];
+
+				compiledNode->_children = @[ childNode ];
+				compiledNode->_cost = childNode->_cost;
+				compiledNode->_totalNodeCount += childNode->_totalNodeCount;
+
+				node->kind = OCQueryConditionProgramNodeKindNegate;
+			}
+			else
+			{
+				// Mirror -fulfilledByItem: (which logs an error and returns NO)
+				compiledNode->_cost = 32;
+			}
+		}
+		break;
+
+		default: {
+			SEL getter = NULL;
+			char getterType = 0;
+
+			// Conditions that can't be compiled remain with the fallback
+			compiledNode->_cost = 32;
+
+			if (![OCQueryConditionProgram _getter:&getter type:&getterType forProperty:condition.property])
+			{
+				break;
+			}
+
+			node->getter = getter;
+			node->getterType = getterType;
+
+			if (getterType == '@')
+			{
+				switch (operator)
+				{
+					case OCQueryConditionOperatorPropertyEqualToValue:
+					case OCQueryConditionOperatorPropertyNotEqualToValue:
+						compiledNode->_cost = 2;
+					break;
+
+					case OCQueryConditionOperatorPropertyGreaterThanValue:
+					case OCQueryConditionOperatorPropertyLessThanValue:
+						compiledNode->_cost = 3;
+					break;
+
+					case OCQueryConditionOperatorPropertyHasPrefix:
+					case OCQueryConditionOperatorPropertyHasSuffix:
+					case OCQueryConditionOperatorPropertyContains:
+						if (![operand isKindOfClass:NSString.class])
+						{
+							// Leave invalid operands to the fallback
+							node->getter = NULL;
+							break;
+						}
+
+						compiledNode->_cost = (operator == OCQueryConditionOperatorPropertyContains) ? 16 : 4;
+					break;
+
+					default:
+						node->getter = NULL;
+					break;
+				}
+
+				if (node->getter != NULL)
+				{
+					node->kind = OCQueryConditionProgramNodeKindObject;
+					node->objectOperand = operand;
+
+					if (operand != nil)
+					{
+						[_retainedObjects addObject:operand];
+					}
+				}
+			}
+			else
+			{
+				NSNumber *numericOperand;
+
+				// Only comparisons of scalars with numbers can be compiled (-fulfilledByItem: evaluates them using NSNumber)
+				if (((numericOperand = OCTypedCast(operand, NSNumber)) == nil) ||
+				    ((operator != OCQueryConditionOperatorPropertyEqualToValue) &&
+				     (operator != OCQueryConditionOperatorPropertyNotEqualToValue) &&
+				     (operator != OCQueryConditionOperatorPropertyGreaterThanValue) &&
+				     (operator != OCQueryConditionOperatorPropertyLessThanValue)))
+				{
+					break;
+				}
+
+				const char *operandType = numericOperand.objCType;
+
+				node->kind = OCQueryConditionProgramNodeKindScalar;
+				node->compareAsDouble = (getterType == 'f') || (getterType == 'd') || (operandType[0] == 'f') || (operandType[0] == 'd');
+				node->intOperand = numericOperand.longLongValue;
+				node->doubleOperand = numericOperand.doubleValue;
+
+				compiledNode->_cost = 1;
+			}
+		}
+		break;
+	}
+
+	return (compiledNode);
+}
+
+- (void)_layoutNode:(OCQueryConditionProgramCompilationNode *)compiledNode atIndex:(NSUInteger)index
+{
+	OCQueryConditionProgramNode *node = &_nodes[index];
+	NSUInteger childIndex;
+
+	*node = compiledNode->_node;
+
+	// Children are placed in a contiguous block, in evaluation order
+	node->firstChild = _nodeCount;
+	node->childCount = compiledNode->_children.count;
+
+	_nodeCount += node->childCount;
+
+	childIndex = node->firstChild;
+
+	for (OCQueryConditionProgramCompilationNode *childNode in compiledNode->_children)
+	{
+		[self _layoutNode:childNode atIndex:childIndex];
+		childIndex++;
+	}
+}
+
+#pragma mark - Evaluation
+static inline BOOL OCQueryConditionProgramReadScalar(OCItem *item, const OCQueryConditionProgramNode *node, long long *outInt, double *outDouble)
+{
+	SEL getter = node->getter;
+
+	#define OCQCPReadInt(type) 	*outInt = (long long)((type (*)(id, SEL))objc_msgSend)(item, getter); return (NO)
+	#define OCQCPReadDouble(type) 	*outDouble = (double)((type (*)(id, SEL))objc_msgSend)(item, getter); return (YES)
+
+	switch (node->getterType)
+	{
+		case 'c': OCQCPReadInt(char);
+		case 'C': OCQCPReadInt(unsigned char);
+		case 'B': OCQCPReadInt(bool);
+		case 's': OCQCPReadInt(short);
+		case 'S': OCQCPReadInt(unsigned short);
+		case 'i': OCQCPReadInt(int);
+		case 'I': OCQCPReadInt(unsigned int);
+		case 'l': OCQCPReadInt(long);
+		case 'L': OCQCPReadInt(unsigned long);
+		case 'q': OCQCPReadInt(long long);
+		case 'Q': OCQCPReadInt(unsigned long long);
+		case 'f': OCQCPReadDouble(float);
+		case 'd': OCQCPReadDouble(double);
+	}
+
+	#undef OCQCPReadInt
+	#undef OCQCPReadDouble
+
+	*outInt = 0;
+	return (NO);
+}
+
+static BOOL OCQueryConditionProgramEvaluate(const OCQueryConditionProgramNode *nodes, NSUInteger index, OCItem *item)
+{
+	const OCQueryConditionProgramNode *node = &nodes[index];
+
+	switch (node->kind)
+	{
+		case OCQueryConditionProgramNodeKindAnd:
+			for (NSUInteger childIndex = node->firstChild; childIndex < node->firstChild + node->childCount; childIndex++)
+			{
+				if (!OCQueryConditionProgramEvaluate(nodes, childIndex, item))
+				{
+					return (NO);
+				}
+			}
+		return (YES);
+
+		case OCQueryConditionProgramNodeKindOr:
+			for (NSUInteger childIndex = node->firstChild; childIndex < node->firstChild + node->childCount; childIndex++)
+			{
+				if (OCQueryConditionProgramEvaluate(nodes, childIndex, item))
+				{
+					return (YES);
+				}
+			}
+		return (NO);
+
+		case OCQueryConditionProgramNodeKindNegate:
+		return (!OCQueryConditionProgramEvaluate(nodes, node->firstChild, item));
+
+		case OCQueryConditionProgramNodeKindFallback:
+		return ([node->condition fulfilledByItem:item]);
+
+		case OCQueryConditionProgramNodeKindScalar: {
+			long long intValue = 0;
+			double doubleValue = 0;
+			BOOL isDouble = OCQueryConditionProgramReadScalar(item, node, &intValue, &doubleValue);
+
+			if (node->compareAsDouble)
+			{
+				double value = isDouble ? doubleValue : (double)intValue;
+
+				switch (node->operator)
+				{
+					case OCQueryConditionOperatorPropertyGreaterThanValue:	return (value > node->doubleOperand);
+					case OCQueryConditionOperatorPropertyLessThanValue:	return (value < node->doubleOperand);
+					case OCQueryConditionOperatorPropertyEqualToValue:	return (value == node->doubleOperand);
+					case OCQueryConditionOperatorPropertyNotEqualToValue:	return (value != node->doubleOperand);
+					default: break;
+				}
+			}
+			else
+			{
+				switch (node->operator)
+				{
+					case OCQueryConditionOperatorPropertyGreaterThanValue:	return (intValue > node->intOperand);
+					case OCQueryConditionOperatorPropertyLessThanValue:	return (intValue < node->intOperand);
+					case OCQueryConditionOperatorPropertyEqualToValue:	return (intValue == node->intOperand);
+					case OCQueryConditionOperatorPropertyNotEqualToValue:	return (intValue != node->intOperand);
+					default: break;
+				}
+			}
+		}
+		return (NO);
+
+		case OCQueryConditionProgramNodeKindObject: {
+			id value = ((id (*)(id, SEL))objc_msgSend)(item, node->getter);
+			id operand = node->objectOperand;
+
+			switch (node->operator)
+			{
+				case OCQueryConditionOperatorPropertyEqualToValue:
+				return ((value != nil) && [value isEqual:operand]);
+
+				case OCQueryConditionOperatorPropertyNotEqualToValue:
+				return ((value == nil) || ![value isEqual:operand]);
+
+				case OCQueryConditionOperatorPropertyGreaterThanValue:
+				case OCQueryConditionOperatorPropertyLessThanValue:
+					if (value == nil) { return (NO); }
+
+					if ([value respondsToSelector:@selector(compare:)])
+					{
+						return ([(NSNumber *)value compare:(NSNumber *)operand] == ((node->operator == OCQueryConditionOperatorPropertyGreaterThanValue) ? NSOrderedDescending : NSOrderedAscending));
+					}
+				break;
+
+				case OCQueryConditionOperatorPropertyHasPrefix:
+					if (value == nil) { return (NO); }
+					if ([value isKindOfClass:NSString.class]) { return ([(NSString *)value hasPrefix:operand]); }
+				break;
+
+				case OCQueryConditionOperatorPropertyHasSuffix:
+					if (value == nil) { return (NO); }
+					if ([value isKindOfClass:NSString.class]) { return ([(NSString *)value hasSuffix:operand]); }
+				break;
+
+				case OCQueryConditionOperatorPropertyContains:
+					if (value == nil) { return (NO); }
+					if ([value isKindOfClass:NSString.class]) { return ([(NSString *)value localizedStandardContainsString:operand]); }
+				break;
+
+				default:
+				break;
+			}
+
+			// Unexpected value type: leave handling (and logging) to -fulfilledByItem:
+			return ([node->condition fulfilledByItem:item]);
+		}
+	}
+
+	return (NO);
+}
+
+- (BOOL)evaluateWithItem:(OCItem *)item
+{
+	if (_nodes == NULL)
+	{
+		return ([_condition fulfilledByItem:item]);
+	}
+
+	return (OCQueryConditionProgramEvaluate(_nodes, 0, item));
+}
+
+@end
@@ -18,6 +18,7 @@
 
 #import "OCQuery+Internal.h"
 #import "OCCoreItemList.h"
+#import "OCQueryResultIndex.h"
 #import "OCStatistic.h"
 #import "OCLogger.h"
 
@@ -31,8 +32,9 @@
 		_fullQueryResults = fullQueryResults;
 		_fullQueryResultsSetOnce = YES;
 
-		// Release cached item list
+		// Release cached item list and index
 		_fullQueryResultsItemList = nil;
+		_fullQueryResultsIndex = nil;
 
 		[self setNeedsRecomputation];
 	}
@@ -53,8 +55,7 @@
 - (void)mergeItemsToFullQueryResults:(NSArray <OCItem *> *)mergeItems syncAnchor:(OCSyncAnchor)syncAnchor
 {
 	// Used only for queries targeting a sync anchor. Makes sure every changed item is only
-	// included once by replacing existing items for a path with new ones.
-
+	// included once by replacing existing items for a fileID or path with new ones.
 	if (!((mergeItems!=nil) && (mergeItems.count > 0)))
 	{
 		return;
@@ -62,38 +63,21 @@
 
 	@synchronized(self)
 	{
-		OCCoreItemList *itemList = [OCCoreItemList new];
-		NSDictionary <OCPath, OCItem *> *itemsByPath;
-
 		// Release cached item list
 		_fullQueryResultsItemList = nil;
 
-		// Merge
+		// (Re)build index if results were replaced
 		if (_fullQueryResults == nil) { _fullQueryResults = [NSMutableArray new]; }
 
-		itemList.items = _fullQueryResults;
-
-		_lastMergeSyncAnchor = syncAnchor;
-
-		if ((itemsByPath = itemList.itemsByPath) != nil)
+		if ((_fullQueryResultsIndex == nil) || (_fullQueryResultsIndex.items != _fullQueryResults))
 		{
-			for (OCItem *mergeItem in mergeItems)
-			{
-				if (mergeItem.path != nil)
-				{
-					OCItem *removeItem;
+			_fullQueryResultsIndex = [[OCQueryResultIndex alloc] initWithItems:_fullQueryResults];
+		}
 
-					if ((removeItem = itemsByPath[mergeItem.path]) != nil)
-					{
-						// Remove older items for the same path
-						[_fullQueryResults removeObjectIdenticalTo:removeItem];
-					}
+		_lastMergeSyncAnchor = syncAnchor;
 
-					// Add item to results
-					[_fullQueryResults addObject:mergeItem];
-				}
-			}
-		}
+		// Merge
+		[_fullQueryResultsIndex mergeItems:mergeItems];
 	}
 }
 
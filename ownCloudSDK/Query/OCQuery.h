@@ -27,6 +27,8 @@
 #import "OCCancelAction.h"
 #import "OCDataSourceArray.h"
 
+@class OCQueryResultIndex;
+
 #pragma mark - Types
 typedef NS_ENUM(NSUInteger, OCQueryState)
 {
@@ -76,6 +78,7 @@ typedef void(^OCQueryCustomSource)(OCCore *core, OCQuery *query, OCQueryCustomRe
 	OCDataSourceArray *_queryResultsDataSource;
 
 	OCCoreItemList *_fullQueryResultsItemList;			// Cached item list of _fullQueryResults used in the default
+	OCQueryResultIndex *_fullQueryResultsIndex;			// Index of _fullQueryResults by path and fileID, used by -mergeItemsToFullQueryResults:
 
 	NSArray <OCItem *> *_lastQueryResults;				// processedQueryResults at the time a changeset was last requested.
 
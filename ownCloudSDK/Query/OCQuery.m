@@ -132,8 +132,10 @@
 
 	if (inputFilter == nil)
 	{
+		OCQueryConditionProgram *conditionProgram = [condition compiledProgram];
+
 		inputFilter = [OCQueryFilter filterWithHandler:^BOOL(OCQuery *query, OCQueryFilter *filter, OCItem *item) {
-			return ([condition fulfilledByItem:item]);
+			return ([conditionProgram evaluateWithItem:item]);
 		}];
 	}
 
@@ -184,8 +186,9 @@
 		{
 			if (modificator(_fullQueryResults, ^{ return ([self fullQueryResultsItemList]); }))
 			{
-				// Release cached item list
+				// Release cached item list and index
 				_fullQueryResultsItemList = nil;
+				_fullQueryResultsIndex = nil;
 
 				// Signal recomputation is needed
 				[self setNeedsRecomputation];
@@ -497,6 +500,7 @@
 		if (self.querySinceSyncAnchor != nil)
 		{
 			_fullQueryResults = [NSMutableArray new];
+			_fullQueryResultsIndex = nil;
 			_processedQueryResults = [NSMutableArray new];
 			_lastQueryResults = [NSMutableArray new];
 
@@ -0,0 +1,48 @@
+//
+//  OCQueryResultIndex.h
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import <Foundation/Foundation.h>
+#import "OCItem.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+	Index of the positions of items in a results array by path and fileID, used to merge changed items
+	into the full results of sync anchor queries in O(k) for k changed items:
+
+	- a merged item replaces the existing item with the same fileID or path in place
+	- removed items are only matched by path: they neither replace nor get replaced by an item with the same fileID
+	  at a different path, so that both the removal at the previous path and the item at its new path are kept when
+	  an item is moved to another folder
+	- a merged item matching neither is appended
+	- if a merged item matches two different existing items (f.ex. by fileID an item that was moved, by path an
+	  item that was replaced), the one matched by path is removed. This is the only case requiring a compaction
+	  of the results array and a rebuild of the index.
+*/
+
+@interface OCQueryResultIndex : NSObject
+
+@property(strong,readonly) NSMutableArray<OCItem *> *items; //!< The indexed results array. Must not be modified by other means than -mergeItems:.
+
+- (instancetype)initWithItems:(NSMutableArray<OCItem *> *)items; //!< Indexes (and from then on modifies) the passed array
+
+- (void)mergeItems:(NSArray<OCItem *> *)mergeItems; //!< Merges the items into .items
+
+@end
+
+NS_ASSUME_NONNULL_END
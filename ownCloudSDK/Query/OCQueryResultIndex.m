@@ -0,0 +1,148 @@
+//
+//  OCQueryResultIndex.m
+//  ownCloudSDK
+//
+//  Created by Felix Schwarz on 18.10.26.
+//  Copyright © 2026 ownCloud GmbH. All rights reserved.
+//
+
+/*
+ * Copyright (C) 2026, ownCloud GmbH.
+ *
+ * This code is covered by the GNU Public License Version 3.
+ *
+ * For distribution utilizing Apple mechanisms please see https://owncloud.org/contribute/iOS-license-exception/
+ * You should have received a copy of this license along with this program. If not, see <http://www.gnu.org/licenses/gpl-3.0.en.html>.
+ *
+ */
+
+#import "OCQueryResultIndex.h"
+
+@interface OCQueryResultIndex ()
+{
+	NSMutableDictionary<OCPath, NSNumber *> *_indexByPath;
+	NSMutableDictionary<OCFileID, NSNumber *> *_indexByFileID;
+}
+@end
+
+@implementation OCQueryResultIndex
+
+- (instancetype)initWithItems:(NSMutableArray<OCItem *> *)items
+{
+	if ((self = [super init]) != nil)
+	{
+		_items = items;
+
+		[self _rebuildIndex];
+	}
+
+	return (self);
+}
+
+#pragma mark - Index maintenance
+- (void)_rebuildIndex
+{
+	_indexByPath = [[NSMutableDictionary alloc] initWithCapacity:_items.count];
+	_indexByFileID = [[NSMutableDictionary alloc] initWithCapacity:_items.count];
+
+	[_items enumerateObjectsUsingBlock:^(OCItem * _Nonnull item, NSUInteger idx, BOOL * _Nonnull stop) {
+		[self _indexItem:item atIndex:idx];
+	}];
+}
+
+- (void)_indexItem:(OCItem *)item atIndex:(NSUInteger)index
+{
+	NSNumber *indexNumber = @(index);
+	OCPath path;
+	OCFileID fileID;
+
+	if ((path = item.path) != nil)
+	{
+		_indexByPath[path] = indexNumber;
+	}
+
+	if (((fileID = item.fileID) != nil) && !item.removed)
+	{
+		// Removed items are only indexed by path, so that the removal of an item at its previous path (f.ex. after a move to another folder) is kept alongside the item at its new path
+		_indexByFileID[fileID] = indexNumber;
+	}
+}
+
+- (void)_unindexItem:(OCItem *)item atIndex:(NSUInteger)index
+{
+	OCPath path;
+	OCFileID fileID;
+
+	// Only remove keys still pointing to the item's index, as they may have been claimed by another item in the meantime
+	if (((path = item.path) != nil) && (_indexByPath[path].unsignedIntegerValue == index))
+	{
+		[_indexByPath removeObjectForKey:path];
+	}
+
+	if (((fileID = item.fileID) != nil) && (_indexByFileID[fileID].unsignedIntegerValue == index))
+	{
+		[_indexByFileID removeObjectForKey:fileID];
+	}
+}
+
+#pragma mark - Merge
+- (void)mergeItems:(NSArray<OCItem *> *)mergeItems
+{
+	NSMutableIndexSet *tombstoneIndexes = nil;
+
+	for (OCItem *mergeItem in mergeItems)
+	{
+		OCPath path;
+		OCFileID fileID = mergeItem.fileID;
+		NSNumber *pathIndex, *fileIDIndex, *targetIndex;
+
+		if ((path = mergeItem.path) == nil)
+		{
+			continue;
+		}
+
+		pathIndex = _indexByPath[path];
+		fileIDIndex = ((fileID != nil) && !mergeItem.removed) ? _indexByFileID[fileID] : nil; // Removed items only replace the item at their path
+
+		if ((pathIndex != nil) && (fileIDIndex != nil) && ![pathIndex isEqual:fileIDIndex])
+		{
+			// Item matches one existing item by fileID and another by path: remove the one matched by path
+			NSUInteger removeIndex = pathIndex.unsignedIntegerValue;
+
+			[self _unindexItem:_items[removeIndex] atIndex:removeIndex];
+
+			// Leave a tombstone, so indexes remain valid until compaction at the end of the merge
+			if (tombstoneIndexes == nil) { tombstoneIndexes = [NSMutableIndexSet new]; }
+			[tombstoneIndexes addIndex:removeIndex];
+			_items[removeIndex] = (OCItem *)NSNull.null;
+
+			pathIndex = nil;
+		}
+
+		if ((targetIndex = ((fileIDIndex != nil) ? fileIDIndex : pathIndex)) != nil)
+		{
+			// Replace existing item in place
+			NSUInteger replaceIndex = targetIndex.unsignedIntegerValue;
+
+			[self _unindexItem:_items[replaceIndex] atIndex:replaceIndex];
+
+			_items[replaceIndex] = mergeItem;
+			[self _indexItem:mergeItem atIndex:replaceIndex];
+		}
+		else
+		{
+			// Append new item
+			[self _indexItem:mergeItem atIndex:_items.count];
+			[_items addObject:mergeItem];
+		}
+	}
+
+	if (tombstoneIndexes != nil)
+	{
+		// Compact results and rebuild index, as positions have changed
+		[_items removeObjectsAtIndexes:tombstoneIndexes];
+		[self _rebuildIndex];
+	}
+}
+
+@end
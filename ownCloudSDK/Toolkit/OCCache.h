@@ -20,24 +20,31 @@
 
 #define OCCacheLimitNone 0
 
-NS_ASSUME_NONNULL_BEGIN
-
-@interface OCCache<K,V> : NSObject
+typedef NS_ENUM(NSInteger, OCCacheAdmissionPolicy)
 {
-	NSMutableDictionary<K, V> *_valuesByKey;
-	NSMutableArray<K> *_recentlyUsedKeys;
+	OCCacheAdmissionPolicyLRU,	//!< All key-value pairs are admitted, least recently used key-value pairs are removed first (default)
+	OCCacheAdmissionPolicyTinyLFU	//!< W-TinyLFU: new key-value pairs enter a small LRU window (1% of the count limit). When they leave the window while the cache is full, they are only admitted to the main cache if they have been used more frequently than the least recently used key-value pair in the main cache, which is removed instead. Protects frequently used key-value pairs from being flushed out by one-time accesses.
+};
 
-	NSMutableDictionary<K, NSNumber *> *_costByKey;
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+	Key-value pairs are kept in an intrusive doubly linked list ordered by recency, so that hits, insertions and removals
+	are O(1).
 
-	NSUInteger _currentCost;
-	NSUInteger _totalCostLimit;
+	Caches can be split into shards by key hash, each with its own lock and list. Limits are then split evenly across shards
+	and LRU order is only maintained within each shard. Caches created with -init use a single shard and exact LRU order.
+*/
 
-	NSUInteger _countLimit;
-}
+@interface OCCache<K,V> : NSObject
 
 @property(assign) NSUInteger countLimit;	//!< Impose limit on the maximum number of key-value pairs. If the limit is exceeded, least recently used key-value pairs are removed first. A value of OCCacheLimitNone (default) means no limit.
 @property(assign) NSUInteger totalCostLimit;	//!< Impose limit on the maximum cost of key-value pairs. If the limit is exceeded, least recently used key-value pairs are removed first. A value of OCCacheLimitNone (default) means no limit.
 
+@property(assign) OCCacheAdmissionPolicy admissionPolicy; //!< Policy used to decide which key-value pairs are kept when limits are exceeded. Defaults to OCCacheAdmissionPolicyLRU.
+
+- (instancetype)initWithShardCount:(NSUInteger)shardCount; //!< Creates a cache split into shardCount shards (rounded up to the next power of 2) to reduce lock contention when accessed from many threads.
+
 #pragma mark - Retrieval
 - (nullable V)objectForKey:(K)key;
 
@@ -52,6 +59,16 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark - Cache Cleaning
 - (void)clearCache; //!< Removes all contents from the cache
 
+#pragma mark - Statistics
+@property(readonly) NSUInteger count; //!< Number of key-value pairs in the cache
+@property(readonly) NSUInteger totalCost; //!< Total cost of key-value pairs in the cache
+
+@property(readonly) NSUInteger hitCount; //!< Number of -objectForKey: calls that returned an object
+@property(readonly) NSUInteger missCount; //!< Number of -objectForKey: calls that returned nil
+@property(readonly) NSUInteger evictionCount; //!< Number of key-value pairs removed (or not admitted) to stay within limits
+
+- (void)resetStatistics; //!< Resets hit, miss and eviction counts to 0
+
 @end
 
 NS_ASSUME_NONNULL_END
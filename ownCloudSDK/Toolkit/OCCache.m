@@ -19,148 +19,588 @@
 #import <UIKit/UIKit.h>
 #import "OCCache.h"
 
-@implementation OCCache
+#define OCCacheSketchDepth 4		// Number of rows in the frequency sketch
+#define OCCacheSketchMaximumFrequency 15	// Frequency counters saturate at this value
 
-@synthesize countLimit = _countLimit;
-@synthesize totalCostLimit = _totalCostLimit;
+#pragma mark - Entries
+@interface OCCacheEntry : NSObject
+{
+	@public
+	id _key;
+	id _value;
+	NSUInteger _cost;
+	uint64_t _keyHash;
+
+	BOOL _inWindow;
+
+	// Entries are retained by OCCacheShard._entriesByKey
+	__unsafe_unretained OCCacheEntry *_previous;
+	__unsafe_unretained OCCacheEntry *_next;
+}
+@end
+
+@implementation OCCacheEntry
+@end
+
+typedef struct
+{
+	__unsafe_unretained OCCacheEntry *head; // most recently used
+	__unsafe_unretained OCCacheEntry *tail; // least recently used
+	NSUInteger count;
+} OCCacheList;
+
+static void OCCacheListRemove(OCCacheList *list, OCCacheEntry *entry)
+{
+	if (entry->_previous != nil) { entry->_previous->_next = entry->_next; } else { list->head = entry->_next; }
+	if (entry->_next != nil) { entry->_next->_previous = entry->_previous; } else { list->tail = entry->_previous; }
+
+	entry->_previous = nil;
+	entry->_next = nil;
+
+	list->count--;
+}
+
+static void OCCacheListInsertAtHead(OCCacheList *list, OCCacheEntry *entry)
+{
+	entry->_previous = nil;
+	entry->_next = list->head;
+
+	if (list->head != nil) { list->head->_previous = entry; } else { list->tail = entry; }
+	list->head = entry;
+
+	list->count++;
+}
+
+static uint64_t OCCacheMixHash(uint64_t hash)
+{
+	// MurmurHash3 finalizer: -hash values are often pointers or small integers, spread them across all bits
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+
+	return (hash);
+}
+
+#pragma mark - Shards
+@interface OCCacheShard : NSObject
+{
+	@public
+	NSMutableDictionary<id, OCCacheEntry *> *_entriesByKey;
+
+	OCCacheList _mainList;
+	OCCacheList _windowList; // admission window (OCCacheAdmissionPolicyTinyLFU only)
+
+	NSUInteger _currentCost;
+
+	NSUInteger _countLimit;
+	NSUInteger _totalCostLimit;
+	OCCacheAdmissionPolicy _admissionPolicy;
+
+	uint8_t *_frequencySketch; // count-min sketch of OCCacheSketchDepth rows with _sketchWidth counters each (OCCacheAdmissionPolicyTinyLFU only)
+	NSUInteger _sketchWidth;
+	NSUInteger _sketchAdditions;
+
+	NSUInteger _hitCount;
+	NSUInteger _missCount;
+	NSUInteger _evictionCount;
+}
+@end
+
+@implementation OCCacheShard
 
-#pragma mark - Init & Dealloc
 - (instancetype)init
 {
 	if ((self = [super init]) != nil)
 	{
-		_valuesByKey = [NSMutableDictionary new];
-		_recentlyUsedKeys = [NSMutableArray new];
-		_costByKey = [NSMutableDictionary new];
-
-		[[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(_receivedMemoryWarning:) name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+		_entriesByKey = [NSMutableDictionary new];
 	}
 
-	return(self);
+	return (self);
 }
 
 - (void)dealloc
 {
-	[[NSNotificationCenter defaultCenter] removeObserver:self name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+	if (_frequencySketch != NULL)
+	{
+		free(_frequencySketch);
+		_frequencySketch = NULL;
+	}
 }
 
-#pragma mark - Retrieval
-- (id)objectForKey:(id)key
+#pragma mark - Configuration
+- (void)setCountLimit:(NSUInteger)countLimit totalCostLimit:(NSUInteger)totalCostLimit admissionPolicy:(OCCacheAdmissionPolicy)admissionPolicy
 {
-	if (key == nil) { return(nil); }
+	BOOL resetSketch = (admissionPolicy != _admissionPolicy) || (countLimit != _countLimit);
 
-	@synchronized(self)
+	if ((admissionPolicy != OCCacheAdmissionPolicyTinyLFU) && (_windowList.count > 0))
 	{
-		id object;
+		// Move window contents to the main list, keeping their order
+		OCCacheEntry *entry;
 
-		if ((object = [_valuesByKey objectForKey:key]) != nil)
+		while ((entry = _windowList.head) != nil)
 		{
-			[_recentlyUsedKeys removeObject:key];
-			[_recentlyUsedKeys addObject:key];
+			OCCacheListRemove(&_windowList, entry);
+			entry->_inWindow = NO;
+			OCCacheListInsertAtHead(&_mainList, entry);
 		}
+	}
+
+	_countLimit = countLimit;
+	_totalCostLimit = totalCostLimit;
+	_admissionPolicy = admissionPolicy;
 
-		return (object);
+	if (resetSketch)
+	{
+		[self _resetSketch];
 	}
+
+	[self _enforceLimits];
 }
 
-#pragma mark - Modification
-- (void)setObject:(id)obj forKey:(id)key
+#pragma mark - Frequency sketch
+- (void)_resetSketch
 {
-	if (key == nil) { return; }
+	if (_frequencySketch != NULL)
+	{
+		free(_frequencySketch);
+		_frequencySketch = NULL;
+	}
 
-	@synchronized(self)
+	_sketchWidth = 0;
+	_sketchAdditions = 0;
+
+	if (_admissionPolicy == OCCacheAdmissionPolicyTinyLFU)
 	{
-		[_recentlyUsedKeys removeObject:key];
-		[_recentlyUsedKeys addObject:key];
+		// One counter per row for every key-value pair the shard can hold (1024 without count limit)
+		NSUInteger width = 64, targetWidth = (_countLimit != OCCacheLimitNone) ? MIN(_countLimit, (1 << 20)) : 1024;
 
-		[_valuesByKey setObject:obj forKey:key];
+		while (width < targetWidth) { width <<= 1; }
 
-		[self _cleanCache];
+		if ((_frequencySketch = calloc(width * OCCacheSketchDepth, sizeof(uint8_t))) != NULL)
+		{
+			_sketchWidth = width;
+		}
 	}
 }
 
-- (void)setObject:(id)obj forKey:(id)key cost:(NSUInteger)cost
+static inline NSUInteger OCCacheSketchIndex(uint64_t keyHash, NSUInteger row, NSUInteger width)
 {
-	if (key == nil) { return; }
+	// Double hashing from the two halves of the key hash
+	uint32_t hash1 = (uint32_t)keyHash, hash2 = ((uint32_t)(keyHash >> 32)) | 1;
 
-	@synchronized(self)
+	return ((row * width) + ((hash1 + (row * hash2)) & (width - 1)));
+}
+
+- (NSUInteger)_frequencyForHash:(uint64_t)keyHash
+{
+	NSUInteger frequency = OCCacheSketchMaximumFrequency;
+
+	if (_frequencySketch == NULL) { return (0); }
+
+	for (NSUInteger row=0; row < OCCacheSketchDepth; row++)
 	{
-		NSNumber *previousCost;
+		frequency = MIN(frequency, _frequencySketch[OCCacheSketchIndex(keyHash, row, _sketchWidth)]);
+	}
 
-		[_recentlyUsedKeys removeObject:key];
-		[_recentlyUsedKeys addObject:key];
+	return (frequency);
+}
 
-		[_valuesByKey setObject:obj forKey:key];
+- (void)_recordAccessForHash:(uint64_t)keyHash
+{
+	if (_frequencySketch == NULL) { return; }
 
-		_currentCost += cost;
+	for (NSUInteger row=0; row < OCCacheSketchDepth; row++)
+	{
+		uint8_t *counter = &_frequencySketch[OCCacheSketchIndex(keyHash, row, _sketchWidth)];
 
-		if ((previousCost = [_costByKey objectForKey:key]) != nil)
+		if (*counter < OCCacheSketchMaximumFrequency)
 		{
-			_currentCost -= [previousCost unsignedIntegerValue];
+			(*counter)++;
 		}
+	}
 
-		[_costByKey setObject:@(cost) forKey:key];
+	if (++_sketchAdditions >= (_sketchWidth * 10))
+	{
+		// Aging: halve all counters, so that past popularity fades
+		for (NSUInteger idx=0; idx < (_sketchWidth * OCCacheSketchDepth); idx++)
+		{
+			_frequencySketch[idx] >>= 1;
+		}
 
-		[self _cleanCache];
+		_sketchAdditions /= 2;
 	}
 }
 
+#pragma mark - Access
+- (id)objectForKey:(id)key hash:(uint64_t)keyHash
+{
+	OCCacheEntry *entry;
+
+	[self _recordAccessForHash:keyHash];
+
+	if ((entry = _entriesByKey[key]) != nil)
+	{
+		OCCacheList *list = entry->_inWindow ? &_windowList : &_mainList;
+
+		OCCacheListRemove(list, entry);
+		OCCacheListInsertAtHead(list, entry);
+
+		_hitCount++;
+
+		return (entry->_value);
+	}
+
+	_missCount++;
+
+	return (nil);
+}
+
+- (void)setObject:(id)object forKey:(id)key hash:(uint64_t)keyHash cost:(NSUInteger)cost replaceCost:(BOOL)replaceCost
+{
+	OCCacheEntry *entry;
+
+	[self _recordAccessForHash:keyHash];
+
+	if ((entry = _entriesByKey[key]) != nil)
+	{
+		OCCacheList *list = entry->_inWindow ? &_windowList : &_mainList;
+
+		OCCacheListRemove(list, entry);
+		OCCacheListInsertAtHead(list, entry);
+
+		entry->_value = object;
+	}
+	else
+	{
+		entry = [OCCacheEntry new];
+		entry->_key = key;
+		entry->_value = object;
+		entry->_keyHash = keyHash;
+		entry->_inWindow = (_admissionPolicy == OCCacheAdmissionPolicyTinyLFU);
+
+		_entriesByKey[key] = entry;
+		OCCacheListInsertAtHead(entry->_inWindow ? &_windowList : &_mainList, entry);
+	}
+
+	if (replaceCost)
+	{
+		_currentCost = _currentCost - entry->_cost + cost;
+		entry->_cost = cost;
+	}
+
+	[self _enforceLimits];
+}
+
 - (void)setCost:(NSUInteger)cost forKey:(id)key
 {
-	if (key == nil) { return; }
+	OCCacheEntry *entry;
 
-	@synchronized(self)
+	if ((entry = _entriesByKey[key]) != nil)
+	{
+		_currentCost = _currentCost - entry->_cost + cost;
+		entry->_cost = cost;
+
+		[self _enforceLimits];
+	}
+}
+
+- (void)removeObjectForKey:(id)key
+{
+	OCCacheEntry *entry;
+
+	if ((entry = _entriesByKey[key]) != nil)
 	{
-		NSNumber *previousCost;
+		[self _removeEntry:entry];
+	}
+}
+
+- (void)removeAllObjects
+{
+	[_entriesByKey removeAllObjects];
+
+	_mainList = (OCCacheList){ nil, nil, 0 };
+	_windowList = (OCCacheList){ nil, nil, 0 };
+
+	_currentCost = 0;
+}
+
+- (void)_removeEntry:(OCCacheEntry *)entry
+{
+	id key = entry->_key;
+
+	OCCacheListRemove(entry->_inWindow ? &_windowList : &_mainList, entry);
+	_currentCost -= entry->_cost;
 
-		_currentCost += cost;
+	[_entriesByKey removeObjectForKey:key];
+}
+
+#pragma mark - Limits
+- (BOOL)_exceedsLimits
+{
+	return (((_countLimit != OCCacheLimitNone) && (_entriesByKey.count > _countLimit)) ||	// Count limit
+		((_totalCostLimit != OCCacheLimitNone) && (_currentCost > _totalCostLimit)));	// Cost limit
+}
+
+- (void)_enforceLimits
+{
+	if (_admissionPolicy == OCCacheAdmissionPolicyTinyLFU)
+	{
+		NSUInteger windowLimit = MAX(_countLimit / 100, 1);
 
-		if ((previousCost = [_costByKey objectForKey:key]) != nil)
+		// Key-value pairs leaving the window compete with the least recently used key-value pair of the main list for admission
+		while (_windowList.count > windowLimit)
 		{
-			_currentCost -= [previousCost unsignedIntegerValue];
+			OCCacheEntry *candidate = _windowList.tail, *victim = _mainList.tail;
+
+			if ((victim != nil) && [self _exceedsLimits])
+			{
+				_evictionCount++;
+
+				if ([self _frequencyForHash:candidate->_keyHash] <= [self _frequencyForHash:victim->_keyHash])
+				{
+					// Not admitted
+					[self _removeEntry:candidate];
+					continue;
+				}
+
+				[self _removeEntry:victim];
+			}
+
+			OCCacheListRemove(&_windowList, candidate);
+			candidate->_inWindow = NO;
+			OCCacheListInsertAtHead(&_mainList, candidate);
 		}
+	}
+
+	while ([self _exceedsLimits])
+	{
+		OCCacheEntry *leastRecentlyUsedEntry;
 
-		[_costByKey setObject:@(cost) forKey:key];
+		if ((leastRecentlyUsedEntry = ((_mainList.tail != nil) ? _mainList.tail : _windowList.tail)) == nil)
+		{
+			break;
+		}
 
-		[self _cleanCache];
+		[self _removeEntry:leastRecentlyUsedEntry];
+		_evictionCount++;
 	}
 }
 
-- (void)removeObjectForKey:(id)key
+@end
+
+#pragma mark - Cache
+@implementation OCCache
+{
+	NSArray<OCCacheShard *> *_shards;
+	NSUInteger _shardMask;
+
+	NSUInteger _countLimit;
+	NSUInteger _totalCostLimit;
+	OCCacheAdmissionPolicy _admissionPolicy;
+}
+
+#pragma mark - Init & Dealloc
+- (instancetype)init
+{
+	return ([self initWithShardCount:1]);
+}
+
+- (instancetype)initWithShardCount:(NSUInteger)shardCount
+{
+	if ((self = [super init]) != nil)
+	{
+		NSMutableArray<OCCacheShard *> *shards = [NSMutableArray new];
+		NSUInteger roundedShardCount = 1;
+
+		while ((roundedShardCount < shardCount) && (roundedShardCount < 64))
+		{
+			roundedShardCount <<= 1;
+		}
+
+		for (NSUInteger shardIdx=0; shardIdx < roundedShardCount; shardIdx++)
+		{
+			[shards addObject:[OCCacheShard new]];
+		}
+
+		_shards = shards;
+		_shardMask = roundedShardCount - 1;
+
+		[[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(_receivedMemoryWarning:) name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+	}
+
+	return(self);
+}
+
+- (void)dealloc
+{
+	[[NSNotificationCenter defaultCenter] removeObserver:self name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+}
+
+#pragma mark - Shards
+- (OCCacheShard *)_shardForHash:(uint64_t)keyHash
+{
+	// Use the top bits, the lower bits address the frequency sketch
+	return (_shards[((NSUInteger)(keyHash >> 58)) & _shardMask]);
+}
+
+#pragma mark - Limits
+- (NSUInteger)countLimit
 {
 	@synchronized(self)
 	{
-		[self _removeObjectForKey:key];
+		return (_countLimit);
 	}
 }
 
-- (void)_removeObjectForKey:(id)key
+- (void)setCountLimit:(NSUInteger)countLimit
 {
-	NSNumber *previousCost;
+	@synchronized(self)
+	{
+		_countLimit = countLimit;
+		[self _applyLimits];
+	}
+}
+
+- (NSUInteger)totalCostLimit
+{
+	@synchronized(self)
+	{
+		return (_totalCostLimit);
+	}
+}
+
+- (void)setTotalCostLimit:(NSUInteger)totalCostLimit
+{
+	@synchronized(self)
+	{
+		_totalCostLimit = totalCostLimit;
+		[self _applyLimits];
+	}
+}
+
+- (OCCacheAdmissionPolicy)admissionPolicy
+{
+	@synchronized(self)
+	{
+		return (_admissionPolicy);
+	}
+}
+
+- (void)setAdmissionPolicy:(OCCacheAdmissionPolicy)admissionPolicy
+{
+	@synchronized(self)
+	{
+		_admissionPolicy = admissionPolicy;
+		[self _applyLimits];
+	}
+}
+
+- (void)_applyLimits
+{
+	NSUInteger shardCount = _shards.count;
+
+	// Split limits evenly across shards
+	NSUInteger shardCountLimit = (_countLimit != OCCacheLimitNone) ? ((_countLimit + shardCount - 1) / shardCount) : OCCacheLimitNone;
+	NSUInteger shardTotalCostLimit = (_totalCostLimit != OCCacheLimitNone) ? ((_totalCostLimit + shardCount - 1) / shardCount) : OCCacheLimitNone;
+
+	for (OCCacheShard *shard in _shards)
+	{
+		@synchronized(shard)
+		{
+			[shard setCountLimit:shardCountLimit totalCostLimit:shardTotalCostLimit admissionPolicy:_admissionPolicy];
+		}
+	}
+}
+
+#pragma mark - Retrieval
+- (id)objectForKey:(id)key
+{
+	uint64_t keyHash;
+	OCCacheShard *shard;
+
+	if (key == nil) { return(nil); }
+
+	keyHash = OCCacheMixHash([key hash]);
+	shard = [self _shardForHash:keyHash];
+
+	@synchronized(shard)
+	{
+		return ([shard objectForKey:key hash:keyHash]);
+	}
+}
+
+#pragma mark - Modification
+- (void)setObject:(id)obj forKey:(id)key
+{
+	uint64_t keyHash;
+	OCCacheShard *shard;
+
+	if (key == nil) { return; }
+
+	keyHash = OCCacheMixHash([key hash]);
+	shard = [self _shardForHash:keyHash];
+
+	@synchronized(shard)
+	{
+		[shard setObject:obj forKey:key hash:keyHash cost:0 replaceCost:NO];
+	}
+}
+
+- (void)setObject:(id)obj forKey:(id)key cost:(NSUInteger)cost
+{
+	uint64_t keyHash;
+	OCCacheShard *shard;
 
 	if (key == nil) { return; }
 
-	if ((previousCost = [_costByKey objectForKey:key]) != nil)
+	keyHash = OCCacheMixHash([key hash]);
+	shard = [self _shardForHash:keyHash];
+
+	@synchronized(shard)
 	{
-		_currentCost -= [previousCost unsignedIntegerValue];
+		[shard setObject:obj forKey:key hash:keyHash cost:cost replaceCost:YES];
+	}
+}
+
+- (void)setCost:(NSUInteger)cost forKey:(id)key
+{
+	OCCacheShard *shard;
+
+	if (key == nil) { return; }
+
+	shard = [self _shardForHash:OCCacheMixHash([key hash])];
 
-		[_costByKey removeObjectForKey:key];
+	@synchronized(shard)
+	{
+		[shard setCost:cost forKey:key];
 	}
+}
+
+- (void)removeObjectForKey:(id)key
+{
+	OCCacheShard *shard;
+
+	if (key == nil) { return; }
 
-	[_valuesByKey removeObjectForKey:key];
-	[_recentlyUsedKeys removeObject:key];
+	shard = [self _shardForHash:OCCacheMixHash([key hash])];
+
+	@synchronized(shard)
+	{
+		[shard removeObjectForKey:key];
+	}
 }
 
 #pragma mark - Cache Cleaning
 - (void)clearCache
 {
-	@synchronized(self)
+	for (OCCacheShard *shard in _shards)
 	{
-		[_valuesByKey removeAllObjects];
-		[_costByKey removeAllObjects];
-		[_recentlyUsedKeys removeAllObjects];
-
-		_currentCost = 0;
+		@synchronized(shard)
+		{
+			[shard removeAllObjects];
+		}
 	}
 }
 
@@ -170,27 +610,57 @@
 	[self clearCache];
 }
 
-- (void)_cleanCache
+#pragma mark - Statistics
+- (NSUInteger)_sumOfShardValues:(NSUInteger(^)(OCCacheShard *shard))valueProvider
 {
-	if ((_countLimit != OCCacheLimitNone) || (_totalCostLimit != OCCacheLimitNone))
-	{
-		NSUInteger currentCount = _valuesByKey.count;
+	NSUInteger sum = 0;
 
-		while (((_countLimit != OCCacheLimitNone) && (currentCount > _countLimit)) || 	    // Count limit
-		       ((_totalCostLimit != OCCacheLimitNone) && (_currentCost > _totalCostLimit))) // Cost limit
+	for (OCCacheShard *shard in _shards)
+	{
+		@synchronized(shard)
 		{
-			id leastRecentlyUsedKey;
+			sum += valueProvider(shard);
+		}
+	}
 
-			if ((leastRecentlyUsedKey = _recentlyUsedKeys.firstObject) != nil)
-			{
-				[self _removeObjectForKey:leastRecentlyUsedKey];
-				currentCount--;
-			}
-			else
-			{
-				break;
-			}
-		};
+	return (sum);
+}
+
+- (NSUInteger)count
+{
+	return ([self _sumOfShardValues:^NSUInteger(OCCacheShard *shard) { return (shard->_entriesByKey.count); }]);
+}
+
+- (NSUInteger)totalCost
+{
+	return ([self _sumOfShardValues:^NSUInteger(OCCacheShard *shard) { return (shard->_currentCost); }]);
+}
+
+- (NSUInteger)hitCount
+{
+	return ([self _sumOfShardValues:^NSUInteger(OCCacheShard *shard) { return (shard->_hitCount); }]);
+}
+
+- (NSUInteger)missCount
+{
+	return ([self _sumOfShardValues:^NSUInteger(OCCacheShard *shard) { return (shard->_missCount); }]);
+}
+
+- (NSUInteger)evictionCount
+{
+	return ([self _sumOfShardValues:^NSUInteger(OCCacheShard *shard) { return (shard->_evictionCount); }]);
+}
+
+- (void)resetStatistics
+{
+	for (OCCacheShard *shard in _shards)
+	{
+		@synchronized(shard)
+		{
+			shard->_hitCount = 0;
+			shard->_missCount = 0;
+			shard->_evictionCount = 0;
+		}
 	}
 }
 
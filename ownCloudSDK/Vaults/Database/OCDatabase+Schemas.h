@@ -26,11 +26,15 @@
 @end
 
 extern OCDatabaseTableName OCDatabaseTableNameMetaData;
+extern OCDatabaseTableName OCDatabaseTableNameItemHierarchy;
+extern OCDatabaseTableName OCDatabaseTableNameItemNameIndex;
 extern OCDatabaseTableName OCDatabaseTableNameSyncJournal;
 extern OCDatabaseTableName OCDatabaseTableNameSyncLanes;
 extern OCDatabaseTableName OCDatabaseTableNameUpdateJobs;
+extern OCDatabaseTableName OCDatabaseTableNameFolderScans;
 extern OCDatabaseTableName OCDatabaseTableNameThumbnails;
 extern OCDatabaseTableName OCDatabaseTableNameResources;
 extern OCDatabaseTableName OCDatabaseTableNameCounters;
 extern OCDatabaseTableName OCDatabaseTableNameEvents;
 extern OCDatabaseTableName OCDatabaseTableNameItemPolicies;
+extern OCDatabaseTableName OCDatabaseTableNameProperties;
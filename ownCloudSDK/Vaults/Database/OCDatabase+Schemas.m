@@ -22,6 +22,7 @@
 #import "OCSyncLane.h"
 #import "OCMacros.h"
 #import "OCItem+OCTypeAlias.h"
+#import "OCItem+BinaryCoding.h"
 #import "OCDatabase+Scans.h"
 
 @implementation OCDatabase (Schemas)
@@ -30,8 +31,11 @@
 - (void)addSchemas
 {
 	[self addOrUpdateCountersSchema];
+	[self addOrUpdatePropertiesSchema];
 
 	[self addOrUpdateMetaDataSchema];
+	[self addOrUpdateItemHierarchySchema];
+	[self addOrUpdateItemNameIndexSchema];
 	[self addOrUpdateThumbnailsSchema];
 	[self addOrUpdateResourceSchema];
 
@@ -42,6 +46,7 @@
 	[self addOrUpdateItemPoliciesSchema];
 
 	[self addOrUpdateUpdateJobs];
+	[self addOrUpdateFolderScans];
 }
 
 - (void)addOrUpdateMetaDataSchema
@@ -1341,6 +1346,250 @@
 			}]];
 		}]
 	];
+
+	// Version 20
+	/*
+		Re-encode all items (itemData) with the compact binary encoding (OCItem+BinaryCoding), replacing the NSKeyedArchiver encoding.
+		The schema itself remains UNCHANGED.
+	*/
+	[self.sqlDB addTableSchema:[OCSQLiteTableSchema
+		schemaWithTableName:OCDatabaseTableNameMetaData
+		version:20
+		creationQueries:@[
+			/*
+				mdID : INTEGER	  		- unique ID used to uniquely identify and efficiently update a row
+				type : INTEGER    		- OCItemType value to indicate if this is a file or a collection/folder
+				syncAnchor: INTEGER		- sync anchor, a number that increases its value with every change to an entry. For files, higher sync anchor values indicate the file changed (incl. creation, content or meta data changes). For collections/folders, higher sync anchor values indicate the list of items in the collection/folder changed in a way not covered by file entries (i.e. rename, deletion, but not creation of files).
+				removed : INTEGER		- value indicating if this file or folder has been removed: 1 if it was, 0 if not (default). Removed entries are kept around until their delta to the latest syncAnchor value exceeds -[OCDatabase removedItemRetentionLength].
+				mdTimestamp: INTEGER		- NSDate.timeIntervalSinceReferenceDate value of creation or last update of this record
+				locallyModified: INTEGER	- value indicating if this is a file that's been created or modified locally
+				localRelativePath: TEXT		- path of the local copy of the item, relative to the rootURL of the vault that stores it
+				locationString : TEXT		- OCLocation.string, built from driveID + path, can be used to find all items inside a folder on a drive
+				path : TEXT	  		- full path of the item (e.g. "/example/file.txt")
+				parentPath : TEXT 		- parent path of the item. (e.g. "/example" for an item at "/example/file.txt")
+				name : TEXT 	  		- name of the item (e.g. "file.txt" for an item at "/example/file.txt")
+				mimeType : TEXT			- MIME type of the item (OCMIMEType)
+				typeAlias : TEXT		- Type alias of the item (OCTypeAlias)
+				size : INTEGER			- size of the item
+				favorite : INTEGER		- BOOL indicating if the item is favorite (OCItem.isFavorite)
+				cloudStatus : INTEGER 		- Cloud status of the item (OCItem.cloudStatus)
+				downloadTrigger : TEXT		- What triggered the download of the item (OCItemDownloadTriggerID)
+				hasLocalAttributes : INTEGER 	- BOOL indicating an item with local attributes (OCItem.hasLocalAttributes)
+				lastUsedDate : REAL 		- NSDate.timeIntervalSince1970 value of OCItem.lastUsed
+				lastModifiedDate : REAL		- NSDate.timeIntervalSince1970 value of OCItem.lastModified
+				syncActivity : INTEGER 		- OCSyncActivity mask indicating which sync activity the item has (0 for none) (OCItem.syncActivity)
+				ownerUserName : TEXT		- User name of the owner of this item (OCItem.user.userName)
+				driveID : TEXT			- OCDriveID identifying the drive the item is located on
+				fileID : TEXT			- OCFileID identifying the item
+				localID : TEXT			- OCLocalID identifying the item
+				itemData : BLOB	  		- data of the serialized OCItem
+			*/
+			@"CREATE TABLE metaData (mdID INTEGER PRIMARY KEY AUTOINCREMENT, type INTEGER NOT NULL, syncAnchor INTEGER NOT NULL, removed INTEGER NOT NULL, mdTimestamp INTEGER NOT NULL, locallyModified INTEGER NOT NULL, localRelativePath TEXT NULL, locationString TEXT NOT NULL, path TEXT NOT NULL, parentPath TEXT NOT NULL, name TEXT NOT NULL COLLATE OCLOCALIZED, mimeType TEXT NULL, typeAlias TEXT NULL, size INTEGER NOT NULL, favorite INTEGER NOT NULL, cloudStatus INTEGER NOT NULL, downloadTrigger TEXT NULL, hasLocalAttributes INTEGER NOT NULL, lastUsedDate REAL NULL, lastModifiedDate REAL NULL, syncActivity INTEGER NULL, ownerUserName TEXT, driveID TEXT, fileID TEXT, localID TEXT, itemData BLOB NOT NULL)",
+
+			// Create indexes over path and parentPath
+			@"CREATE INDEX idx_metaData_locationString ON metaData (locationString)",
+			@"CREATE INDEX idx_metaData_path ON metaData (path)",
+			@"CREATE INDEX idx_metaData_parentPath ON metaData (parentPath)",
+			@"CREATE INDEX idx_metaData_synchAnchor ON metaData (syncAnchor)",
+			@"CREATE INDEX idx_metaData_localID ON metaData (localID)",
+			@"CREATE INDEX idx_metaData_driveID ON metaData (driveID)",
+			@"CREATE INDEX idx_metaData_fileID ON metaData (fileID)",
+			@"CREATE INDEX idx_metaData_typeAlias ON metaData (typeAlias)",
+			@"CREATE INDEX idx_metaData_removed ON metaData (removed)",
+			@"CREATE INDEX idx_metaData_downloadTrigger ON metaData (downloadTrigger)",
+			@"CREATE INDEX idx_metaData_cloudStatus ON metaData (cloudStatus)",
+		]
+		openStatements:@[
+			// Create trigger to delete thumbnails alongside metadata entries
+			@"CREATE TEMPORARY TRIGGER temp_delete_associated_thumbnails AFTER DELETE ON metaData BEGIN DELETE FROM thumb.thumbnails WHERE fileID = OLD.fileID; END" // relatedTo:OCDatabaseTableNameThumbnails
+		]
+		upgradeMigrator:^(OCSQLiteDB *db, OCSQLiteTableSchema *schema, void (^completionHandler)(NSError *error)) {
+			// Migrate to version 20
+			[db executeTransaction:[OCSQLiteTransaction transactionWithBlock:^NSError *(OCSQLiteDB *db, OCSQLiteTransaction *transaction) {
+				INSTALL_TRANSACTION_ERROR_COLLECTION_RESULT_HANDLER
+
+				[db executeQuery:[OCSQLiteQuery querySelectingColumns:@[@"mdID", @"itemData"] fromTable:OCDatabaseTableNameMetaData where:nil resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
+					// Re-encode OCItems
+					[resultSet iterateUsing:^(OCSQLiteResultSet *resultSet, NSUInteger line, NSDictionary<NSString *, id> *rowDictionary, BOOL *stop) {
+						NSData *itemData = OCTypedCast(rowDictionary[@"itemData"], NSData);
+						OCItem *item;
+
+						if ((itemData != nil) && ![OCItem isBinaryEncodedData:itemData] && // Skip items that are already binary encoded
+						    ((item = [OCItem itemFromSerializedData:itemData]) != nil) &&
+						    (rowDictionary[@"mdID"] != nil))
+						{
+							[db executeQuery:[OCSQLiteQuery queryUpdatingRowWithID:rowDictionary[@"mdID"]
+											inTable:OCDatabaseTableNameMetaData
+											withRowValues:@{
+														@"itemData" : [item binaryEncodedData]
+												       }
+											completionHandler:^(OCSQLiteDB *db, NSError *error) {
+												if (error != nil)
+												{
+													transactionError = error;
+												}
+											}
+									]
+							];
+						}
+					} error:&transactionError];
+				}]];
+				if (transactionError != nil) { return(transactionError); }
+
+				return (transactionError);
+			} type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+				completionHandler(error);
+			}]];
+		}]
+	];
+
+	// Version 21
+	/*
+		Add column nameSortKey with precomputed sort keys for name, so sorting by name and range scans over name no longer need to call
+		the OCLOCALIZED collation (and bridge two strings) for every comparison, plus an index over it.
+	*/
+	[self.sqlDB addTableSchema:[OCSQLiteTableSchema
+		schemaWithTableName:OCDatabaseTableNameMetaData
+		version:21
+		creationQueries:@[
+			/*
+				mdID : INTEGER	  		- unique ID used to uniquely identify and efficiently update a row
+				type : INTEGER    		- OCItemType value to indicate if this is a file or a collection/folder
+				syncAnchor: INTEGER		- sync anchor, a number that increases its value with every change to an entry. For files, higher sync anchor values indicate the file changed (incl. creation, content or meta data changes). For collections/folders, higher sync anchor values indicate the list of items in the collection/folder changed in a way not covered by file entries (i.e. rename, deletion, but not creation of files).
+				removed : INTEGER		- value indicating if this file or folder has been removed: 1 if it was, 0 if not (default). Removed entries are kept around until their delta to the latest syncAnchor value exceeds -[OCDatabase removedItemRetentionLength].
+				mdTimestamp: INTEGER		- NSDate.timeIntervalSinceReferenceDate value of creation or last update of this record
+				locallyModified: INTEGER	- value indicating if this is a file that's been created or modified locally
+				localRelativePath: TEXT		- path of the local copy of the item, relative to the rootURL of the vault that stores it
+				locationString : TEXT		- OCLocation.string, built from driveID + path, can be used to find all items inside a folder on a drive
+				path : TEXT	  		- full path of the item (e.g. "/example/file.txt")
+				parentPath : TEXT 		- parent path of the item. (e.g. "/example" for an item at "/example/file.txt")
+				name : TEXT 	  		- name of the item (e.g. "file.txt" for an item at "/example/file.txt")
+				nameSortKey : BLOB		- sort key of the name of the item (+[OCSQLiteCollationLocalized sortKeyForString:]), to sort by name via plain memcmp() ordering rather than the OCLOCALIZED collation
+				mimeType : TEXT			- MIME type of the item (OCMIMEType)
+				typeAlias : TEXT		- Type alias of the item (OCTypeAlias)
+				size : INTEGER			- size of the item
+				favorite : INTEGER		- BOOL indicating if the item is favorite (OCItem.isFavorite)
+				cloudStatus : INTEGER 		- Cloud status of the item (OCItem.cloudStatus)
+				downloadTrigger : TEXT		- What triggered the download of the item (OCItemDownloadTriggerID)
+				hasLocalAttributes : INTEGER 	- BOOL indicating an item with local attributes (OCItem.hasLocalAttributes)
+				lastUsedDate : REAL 		- NSDate.timeIntervalSince1970 value of OCItem.lastUsed
+				lastModifiedDate : REAL		- NSDate.timeIntervalSince1970 value of OCItem.lastModified
+				syncActivity : INTEGER 		- OCSyncActivity mask indicating which sync activity the item has (0 for none) (OCItem.syncActivity)
+				ownerUserName : TEXT		- User name of the owner of this item (OCItem.user.userName)
+				driveID : TEXT			- OCDriveID identifying the drive the item is located on
+				fileID : TEXT			- OCFileID identifying the item
+				localID : TEXT			- OCLocalID identifying the item
+				itemData : BLOB	  		- data of the serialized OCItem
+			*/
+			@"CREATE TABLE metaData (mdID INTEGER PRIMARY KEY AUTOINCREMENT, type INTEGER NOT NULL, syncAnchor INTEGER NOT NULL, removed INTEGER NOT NULL, mdTimestamp INTEGER NOT NULL, locallyModified INTEGER NOT NULL, localRelativePath TEXT NULL, locationString TEXT NOT NULL, path TEXT NOT NULL, parentPath TEXT NOT NULL, name TEXT NOT NULL COLLATE OCLOCALIZED, nameSortKey BLOB, mimeType TEXT NULL, typeAlias TEXT NULL, size INTEGER NOT NULL, favorite INTEGER NOT NULL, cloudStatus INTEGER NOT NULL, downloadTrigger TEXT NULL, hasLocalAttributes INTEGER NOT NULL, lastUsedDate REAL NULL, lastModifiedDate REAL NULL, syncActivity INTEGER NULL, ownerUserName TEXT, driveID TEXT, fileID TEXT, localID TEXT, itemData BLOB NOT NULL)",
+
+			// Create indexes over path and parentPath
+			@"CREATE INDEX idx_metaData_locationString ON metaData (locationString)",
+			@"CREATE INDEX idx_metaData_path ON metaData (path)",
+			@"CREATE INDEX idx_metaData_parentPath ON metaData (parentPath)",
+			@"CREATE INDEX idx_metaData_synchAnchor ON metaData (syncAnchor)",
+			@"CREATE INDEX idx_metaData_localID ON metaData (localID)",
+			@"CREATE INDEX idx_metaData_driveID ON metaData (driveID)",
+			@"CREATE INDEX idx_metaData_fileID ON metaData (fileID)",
+			@"CREATE INDEX idx_metaData_typeAlias ON metaData (typeAlias)",
+			@"CREATE INDEX idx_metaData_removed ON metaData (removed)",
+			@"CREATE INDEX idx_metaData_downloadTrigger ON metaData (downloadTrigger)",
+			@"CREATE INDEX idx_metaData_cloudStatus ON metaData (cloudStatus)",
+			@"CREATE INDEX idx_metaData_nameSortKey ON metaData (nameSortKey)",
+		]
+		openStatements:@[
+			// Create trigger to delete thumbnails alongside metadata entries
+			@"CREATE TEMPORARY TRIGGER temp_delete_associated_thumbnails AFTER DELETE ON metaData BEGIN DELETE FROM thumb.thumbnails WHERE fileID = OLD.fileID; END" // relatedTo:OCDatabaseTableNameThumbnails
+		]
+		upgradeMigrator:^(OCSQLiteDB *db, OCSQLiteTableSchema *schema, void (^completionHandler)(NSError *error)) {
+			// Migrate to version 21
+			[db executeTransaction:[OCSQLiteTransaction transactionWithBlock:^NSError *(OCSQLiteDB *db, OCSQLiteTransaction *transaction) {
+				INSTALL_TRANSACTION_ERROR_COLLECTION_RESULT_HANDLER
+
+				// Add "nameSortKey" column
+				[db executeQuery:[OCSQLiteQuery query:@"ALTER TABLE metaData ADD COLUMN nameSortKey BLOB" resultHandler:resultHandler]];
+				if (transactionError != nil) { return(transactionError); }
+
+				// Sort keys for existing entries are computed by -[OCDatabase _updateNameSortKeysIfLocaleChanged] after opening, as no sort key locale is stored yet
+
+				// Create "nameSortKey" index
+				[db executeQuery:[OCSQLiteQuery query:@"CREATE INDEX idx_metaData_nameSortKey ON metaData (nameSortKey)" resultHandler:resultHandler]];
+				if (transactionError != nil) { return(transactionError); }
+
+				return (transactionError);
+			} type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+				completionHandler(error);
+			}]];
+		}]
+	];
+}
+
+- (void)addOrUpdateItemHierarchySchema
+{
+	/*** Item Hierarchy ***/
+
+	// Version 1
+	[self.sqlDB addTableSchema:[OCSQLiteTableSchema
+		schemaWithTableName:OCDatabaseTableNameItemHierarchy
+		version:1
+		creationQueries:@[
+			/*
+				localID : TEXT			- OCLocalID of the item
+				parentLocalID : TEXT		- OCLocalID of the item's parent folder (NULL for root folders)
+				idPath : TEXT			- materialized path of local IDs from the root folder to the item, in the format "/rootLocalID/…/parentLocalID/localID/".
+								  The idPaths of all items inside a folder share the folder's idPath as prefix, so that subtrees can be retrieved with
+								  range scans. Since local IDs don't change when items are renamed or moved, renames don't affect idPaths, and moving
+								  a folder only requires rewriting the prefix of the idPaths in its subtree. Items whose parent folder is not (yet) known
+								  are placed below "/parentLocalID/" and moved into place when the parent folder is added.
+			*/
+			@"CREATE TABLE itemHierarchy (localID TEXT PRIMARY KEY, parentLocalID TEXT, idPath TEXT NOT NULL)", // relatedTo:OCDatabaseTableNameItemHierarchy
+
+			// Create index over idPath
+			@"CREATE INDEX idx_itemHierarchy_idPath ON itemHierarchy (idPath)", // relatedTo:OCDatabaseTableNameItemHierarchy
+
+			// Populate from existing metaData entries, walking down from the root folders by path
+			@"WITH RECURSIVE hierarchy(localID, parentLocalID, driveID, path, idPath) AS ("
+				"SELECT localID, NULL, driveID, path, '/' || localID || '/' FROM metaData WHERE path='/' AND removed=0 AND localID IS NOT NULL "
+				"UNION ALL "
+				"SELECT metaData.localID, hierarchy.localID, metaData.driveID, metaData.path, hierarchy.idPath || metaData.localID || '/' FROM metaData INNER JOIN hierarchy ON (metaData.parentPath=hierarchy.path AND metaData.driveID IS hierarchy.driveID AND metaData.path!='/') WHERE metaData.removed=0 AND metaData.localID IS NOT NULL"
+			") INSERT OR IGNORE INTO itemHierarchy (localID, parentLocalID, idPath) SELECT localID, parentLocalID, idPath FROM hierarchy" // relatedTo:OCDatabaseTableNameItemHierarchy
+		]
+		openStatements:@[
+			// Create trigger to remove entries once no metaData entry references their localID anymore
+			@"CREATE TEMPORARY TRIGGER temp_delete_associated_hierarchy AFTER DELETE ON metaData WHEN OLD.localID IS NOT NULL BEGIN DELETE FROM itemHierarchy WHERE localID = OLD.localID AND NOT EXISTS (SELECT 1 FROM metaData WHERE localID = OLD.localID); END" // relatedTo:OCDatabaseTableNameItemHierarchy
+		]
+		upgradeMigrator:nil]
+	];
+}
+
+- (void)addOrUpdateItemNameIndexSchema
+{
+	/*** Item Name Index ***/
+
+	// Version 1
+	[self.sqlDB addTableSchema:[OCSQLiteTableSchema
+		schemaWithTableName:OCDatabaseTableNameItemNameIndex
+		version:1
+		creationQueries:@[
+			/*
+				External content FTS5 table over metaData.name, using the trigram tokenizer, so that substring searches and LIKE patterns
+				with at least three consecutive characters are answered from the index rather than by scanning all metaData rows.
+				rowid : INTEGER			- mdID of the metaData row
+				name : TEXT			- name of the item (indexed as case-insensitive trigrams)
+			*/
+			@"CREATE VIRTUAL TABLE itemNameIndex USING fts5(name, content='metaData', content_rowid='mdID', tokenize='trigram')", // relatedTo:OCDatabaseTableNameItemNameIndex
+
+			// Populate from existing metaData entries
+			@"INSERT INTO itemNameIndex(itemNameIndex) VALUES('rebuild')" // relatedTo:OCDatabaseTableNameItemNameIndex
+		]
+		openStatements:@[
+			// Create triggers to keep the index up-to-date as metaData entries are added, renamed and removed
+			@"CREATE TEMPORARY TRIGGER temp_itemNameIndex_insert AFTER INSERT ON metaData BEGIN INSERT INTO itemNameIndex(rowid, name) VALUES (NEW.mdID, NEW.name); END", // relatedTo:OCDatabaseTableNameItemNameIndex
+			@"CREATE TEMPORARY TRIGGER temp_itemNameIndex_update AFTER UPDATE OF name ON metaData WHEN OLD.name IS NOT NEW.name BEGIN INSERT INTO itemNameIndex(itemNameIndex, rowid, name) VALUES ('delete', OLD.mdID, OLD.name); INSERT INTO itemNameIndex(rowid, name) VALUES (NEW.mdID, NEW.name); END", // relatedTo:OCDatabaseTableNameItemNameIndex
+			@"CREATE TEMPORARY TRIGGER temp_itemNameIndex_delete AFTER DELETE ON metaData BEGIN INSERT INTO itemNameIndex(itemNameIndex, rowid, name) VALUES ('delete', OLD.mdID, OLD.name); END" // relatedTo:OCDatabaseTableNameItemNameIndex
+		]
+		upgradeMigrator:nil]
+	];
 }
 
 - (void)addOrUpdateSyncLanesSchema
@@ -1698,6 +1947,31 @@
 	];
 }
 
+- (void)addOrUpdateFolderScans
+{
+	/*** Folder Scans ***/
+
+	// Version 1
+	[self.sqlDB addTableSchema:[OCSQLiteTableSchema
+		schemaWithTableName:OCDatabaseTableNameFolderScans
+		version:1
+		creationQueries:@[
+			/*
+				fsID : INTEGER  		- unique ID used to uniquely identify and efficiently update a row
+				fileID : TEXT			- OCFileID of the folder
+				eTag : TEXT			- OCFileETag of the folder at the time its contents were last retrieved and merged into the cache
+				lastScanned : REAL		- NSDate.timeIntervalSinceReferenceDate for when the contents were last retrieved
+			*/
+			@"CREATE TABLE folderScans (fsID INTEGER PRIMARY KEY AUTOINCREMENT, fileID TEXT NOT NULL, eTag TEXT NOT NULL, lastScanned REAL NOT NULL)", // relatedTo:OCDatabaseTableNameFolderScans
+
+			// Create index over fileID
+			@"CREATE UNIQUE INDEX idx_folderScans_fileID ON folderScans (fileID)" // relatedTo:OCDatabaseTableNameFolderScans
+		]
+		openStatements:nil
+		upgradeMigrator:nil]
+	];
+}
+
 - (void)addOrUpdateEvents
 {
 	/*** Sync Events ***/
@@ -1980,6 +2254,56 @@
 		openStatements:nil
 		upgradeMigrator:nil
 	]];
+
+	// Version 2
+	/*
+		Add column blobID, referencing a blob in OCDatabase.resourceBlobStore that holds the resource's data, so that
+		large payloads no longer need to be stored in (and unarchived from) the data column.
+	*/
+	[self.sqlDB addTableSchema:[OCSQLiteTableSchema
+		schemaWithTableName:OCDatabaseTableNameResources
+		version:2
+		creationQueries:@[
+			/*
+				rowID : INTEGER	  	- unique ID used to uniquely identify and efficiently update a row
+				type : TEXT		- OCResourceType, type of resource, f.ex. thumbnail or avatar
+				identifier : TEXT	- OCResourceIdentifier, identifier that identifies the resource, f.ex. the file ID or user name
+				version : TEXT		- OCResourceVersion, string that can be used to distinguish versions (throug equality comparison), f.ex. ETags or checksums (optional)
+				structDesc : TEXT	- OCResourceStructureDescription, a string describing the structure properties of the resource that can affect resource generation or return, such as f.ex. the MIME type (which can change after a rename, without causing ID or version to change) (optional)
+				maxWidth : INTEGER	- maximum width of resource (optional)
+				maxHeight : INTEGER	- maximum height of the resource (optional)
+				metaData : TEXT		- resource type specific meta data describing resData (optional)
+				blobID : TEXT		- OCResourceBlobID of the blob in OCDatabase.resourceBlobStore containing the resource's data (optional - if not set, data contains the full resource)
+				data : BLOB		- serialized OCResource (without its data if blobID is set)
+			*/
+			@"CREATE TABLE thumb.resources (rowID INTEGER PRIMARY KEY AUTOINCREMENT, type TEXT NOT NULL, identifier TEXT NOT NULL, version TEXT, structDesc TEXT, maxWidth INTEGER, maxHeight INTEGER, metaData TEXT, blobID TEXT, data BLOB NOT NULL)", // relatedTo:OCDatabaseTableNameResources
+
+			// Create index over identifier
+			@"CREATE INDEX thumb.idx_resources_identifier ON resources (identifier)", // relatedTo:OCDatabaseTableNameResources
+
+			// Create index over blobID (used to check if a blob is still referenced before removing it)
+			@"CREATE INDEX thumb.idx_resources_blobID ON resources (blobID)" // relatedTo:OCDatabaseTableNameResources
+		]
+		openStatements:nil
+		upgradeMigrator:^(OCSQLiteDB *db, OCSQLiteTableSchema *schema, void (^completionHandler)(NSError *error)) {
+			// Migrate to version 2
+			[db executeTransaction:[OCSQLiteTransaction transactionWithBlock:^NSError *(OCSQLiteDB *db, OCSQLiteTransaction *transaction) {
+				INSTALL_TRANSACTION_ERROR_COLLECTION_RESULT_HANDLER
+
+				// Add "blobID" column (existing entries keep their data inline)
+				[db executeQuery:[OCSQLiteQuery query:@"ALTER TABLE thumb.resources ADD COLUMN blobID TEXT" resultHandler:resultHandler]]; // relatedTo:OCDatabaseTableNameResources
+				if (transactionError != nil) { return(transactionError); }
+
+				// Create index over blobID
+				[db executeQuery:[OCSQLiteQuery query:@"CREATE INDEX thumb.idx_resources_blobID ON resources (blobID)" resultHandler:resultHandler]]; // relatedTo:OCDatabaseTableNameResources
+				if (transactionError != nil) { return(transactionError); }
+
+				return (transactionError);
+			} type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+				completionHandler(error);
+			}]];
+		}
+	]];
 }
 
 - (void)addOrUpdateCountersSchema
@@ -2004,14 +2328,38 @@
 	];
 }
 
+- (void)addOrUpdatePropertiesSchema
+{
+	/*** Properties ***/
+
+	// Version 1
+	[self.sqlDB addTableSchema:[OCSQLiteTableSchema
+		schemaWithTableName:OCDatabaseTableNameProperties
+		version:1
+		creationQueries:@[
+			/*
+				name : TEXT		- name of the property (f.ex. "nameSortKeyLocale")
+				value : TEXT		- Value of the property
+			*/
+			@"CREATE TABLE properties (name TEXT PRIMARY KEY, value TEXT NOT NULL)" // relatedTo:OCDatabaseTableNameProperties
+		]
+		openStatements:nil
+		upgradeMigrator:nil]
+	];
+}
+
 @end
 
 OCDatabaseTableName OCDatabaseTableNameMetaData = @"metaData";
+OCDatabaseTableName OCDatabaseTableNameItemHierarchy = @"itemHierarchy";
+OCDatabaseTableName OCDatabaseTableNameItemNameIndex = @"itemNameIndex";
 OCDatabaseTableName OCDatabaseTableNameSyncLanes = @"syncLanes";
 OCDatabaseTableName OCDatabaseTableNameSyncJournal = @"syncJournal";
 OCDatabaseTableName OCDatabaseTableNameUpdateJobs = @"updateJobs";
+OCDatabaseTableName OCDatabaseTableNameFolderScans = @"folderScans";
 OCDatabaseTableName OCDatabaseTableNameThumbnails = @"thumb.thumbnails"; // Places that need to be changed as well if this is changed are annotated with relatedTo:OCDatabaseTableNameThumbnails
 OCDatabaseTableName OCDatabaseTableNameResources = @"thumb.resources"; // Places that need to be changed as well if this is changed are annotated with relatedTo:OCDatabaseTableNameThumbnails or relatedTo:OCDatabaseTableNameResources
 OCDatabaseTableName OCDatabaseTableNameEvents = @"events";
 OCDatabaseTableName OCDatabaseTableNameCounters = @"counters";
 OCDatabaseTableName OCDatabaseTableNameItemPolicies = @"itemPolicies";
+OCDatabaseTableName OCDatabaseTableNameProperties = @"properties";
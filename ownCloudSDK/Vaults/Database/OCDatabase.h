@@ -39,6 +39,7 @@
 @class OCCoreDirectoryUpdateJob;
 @class OCItemPolicy;
 @class OCDrive;
+@class OCResourceBlobStore;
 
 typedef void(^OCDatabaseCompletionHandler)(OCDatabase *db, NSError *error);
 typedef void(^OCDatabaseRetrieveCompletionHandler)(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray <OCItem *> *items);
@@ -84,6 +85,9 @@ typedef NSString* OCDatabaseCounterIdentifier;
 
 @property(strong) NSURL *databaseURL;
 @property(strong) NSURL *thumbnailDatabaseURL;
+@property(strong) NSURL *resourceBlobStoreURL;
+
+@property(strong,nonatomic,readonly) OCResourceBlobStore *resourceBlobStore; //!< Store for large resource payloads, located at resourceBlobStoreURL
 
 @property(assign) NSUInteger removedItemRetentionLength;
 
@@ -110,6 +114,7 @@ typedef NSString* OCDatabaseCounterIdentifier;
 - (void)purgeCacheItemsWithDatabaseIDs:(NSArray <OCDatabaseID> *)databaseIDs completionHandler:(OCDatabaseCompletionHandler)completionHandler;
 - (void)purgeCacheItemsWithDriveID:(OCDriveID)driveID completionHandler:(OCDatabaseCompletionHandler)completionHandler;
 
+// Item retrievals and iterations can be performed on a read connection (see OCSQLiteDB.maximumReadConnections). Their completion handlers and iterators are then called on that connection's thread right after the rows were read, so changes queued after a retrieval may be performed before, while or after they run - in no guaranteed order. Queries and transactions started from them are performed synchronously on the writing connection. To modify items based on their current state, retrieve them inside -performBatchUpdates:completionHandler:.
 - (void)retrieveCacheItemForLocalID:(OCLocalID)localID completionHandler:(OCDatabaseRetrieveItemCompletionHandler)completionHandler;
 
 - (void)retrieveCacheItemForFileID:(OCFileID)fileID completionHandler:(OCDatabaseRetrieveItemCompletionHandler)completionHandler;
@@ -121,10 +126,12 @@ typedef NSString* OCDatabaseCounterIdentifier;
 - (NSArray <OCItem *> *)retrieveCacheItemsSyncAtLocation:(OCLocation *)location itemOnly:(BOOL)itemOnly error:(NSError * __autoreleasing *)outError syncAnchor:(OCSyncAnchor __autoreleasing *)outSyncAnchor;
 
 - (void)retrieveCacheItemsRecursivelyBelowLocation:(OCLocation *)location includingPathItself:(BOOL)includingPathItself includingRemoved:(BOOL)includingRemoved completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler;
+- (void)retrieveCacheItemsRecursivelyBelowItem:(OCItem *)item includingItemItself:(BOOL)includingItemItself includingRemoved:(BOOL)includingRemoved completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler; //!< Retrieves the items inside the subtree of item (by localID, using the itemHierarchy table). Falls back to -retrieveCacheItemsRecursivelyBelowLocation: for items not found in itemHierarchy.
 
 - (void)retrieveCacheItemsUpdatedSinceSyncAnchor:(OCSyncAnchor)synchAnchor foldersOnly:(BOOL)foldersOnly completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler;
 
 - (void)retrieveCacheItemsForQueryCondition:(OCQueryCondition *)queryCondition cancelAction:(OCCancelAction *)cancelAction completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler;
+- (void)retrieveCacheItemsMatchingSearchTerms:(NSArray<NSString *> *)searchTerms limit:(NSUInteger)limit cancelAction:(OCCancelAction *)cancelAction completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler; //!< Retrieves up to limit (0 = no limit) items whose names match all search terms (case-insensitive), using the itemNameIndex table. Terms containing "*" are patterns that must match the entire name ("*" matching any characters, f.ex. "report*" for names starting with "report"), other terms may occur anywhere in the name. Items whose name starts with the first term are returned first, followed by the remaining items in order of relevance.
 
 - (void)iterateCacheItemsWithIterator:(OCDatabaseItemIterator)iterator; //!< Iterates through all cache items using the passed iterator block. The last invocation of the iterator will be with nil values for syncAnchor, item; NULL for stop.
 - (void)iterateCacheItemsForQueryCondition:(OCQueryCondition *)queryCondition excludeRemoved:(BOOL)excludeRemoved withIterator:(OCDatabaseItemIterator)iterator; //!< Iterates through matching cache items using the passed iterator block. The last invocation of the iterator will be with nil values for syncAnchor, item; NULL for stop.
@@ -134,6 +141,11 @@ typedef NSString* OCDatabaseCounterIdentifier;
 - (void)retrieveDirectoryUpdateJobsAfter:(OCCoreDirectoryUpdateJobID)jobID forLocation:(OCLocation *)location maximumJobs:(NSUInteger)maximumJobs completionHandler:(OCDatabaseRetrieveDirectoryUpdateJobsCompletionHandler)completionHandler;
 - (void)removeDirectoryUpdateJobWithID:(OCCoreDirectoryUpdateJobID)jobID completionHandler:(OCDatabaseCompletionHandler)completionHandler;
 
+#pragma mark - Folder scan interface
+- (void)setScannedContentsETag:(OCFileETag)eTag forFolderWithFileID:(OCFileID)fileID completionHandler:(OCDatabaseCompletionHandler)completionHandler; //!< Records that the contents of the folder with fileID have been retrieved and merged into the cache while the folder had the eTag eTag
+- (void)retrieveScannedContentsETagForFolderWithFileID:(OCFileID)fileID completionHandler:(void(^)(NSError *error, OCFileETag eTag))completionHandler; //!< Retrieves the eTag recorded via -setScannedContentsETag:forFolderWithFileID:completionHandler:, or nil if none was recorded
+- (void)removeScannedContentsETagsForFolderFileIDs:(NSArray<OCFileID> *)fileIDs completionHandler:(OCDatabaseCompletionHandler)completionHandler;
+
 #pragma mark - Sync Lane interface
 - (void)addSyncLane:(OCSyncLane *)lane completionHandler:(OCDatabaseCompletionHandler)completionHandler;
 - (void)updateSyncLane:(OCSyncLane *)lane completionHandler:(OCDatabaseCompletionHandler)completionHandler;
@@ -39,9 +39,13 @@
 #import "OCPlatform.h"
 #import "NSArray+OCSegmentedProcessing.h"
 #import "OCSQLiteDB+Internal.h"
+#import "OCSQLiteCollationLocalized.h"
+#import "OCResourceBlobStore.h"
 
 #import <objc/runtime.h>
 
+static NSString *OCDatabasePropertyNameSortKeyLocale = @"nameSortKeyLocale"; //!< Identifier of the locale the nameSortKey column was computed for
+
 @interface OCDatabase ()
 {
 	NSMutableDictionary <OCSyncRecordID, NSProgress *> *_progressBySyncRecordID;
@@ -53,6 +57,8 @@
 	OCPlatformMemoryConfiguration _memoryConfiguration;
 
 	NSMutableSet<OCSyncRecordID> *_knownInvalidSyncRecordIDs;
+
+	OCResourceBlobStore *_resourceBlobStore;
 }
 
 @end
@@ -74,6 +80,7 @@
 	{
 		self.databaseURL = databaseURL;
 		self.thumbnailDatabaseURL = [[self.databaseURL URLByDeletingPathExtension] URLByAppendingPathExtension:@"tdb"];
+		self.resourceBlobStoreURL = [self.databaseURL.URLByDeletingLastPathComponent URLByAppendingPathComponent:@"Resources" isDirectory:YES];
 
 		self.removedItemRetentionLength = 100;
 
@@ -101,12 +108,45 @@
 
 		self.sqlDB = [[OCSQLiteDB alloc] initWithURL:databaseURL];
 		self.sqlDB.journalMode = OCSQLiteJournalModeWAL;
+		self.sqlDB.maximumReadConnections = (_memoryConfiguration == OCPlatformMemoryConfigurationMinimum) ? 0 : 2;
+
+		NSURL *thumbnailDatabaseURL = self.thumbnailDatabaseURL;
+
+		self.sqlDB.readConnectionSetupHandler = ^NSError *(OCSQLiteDB *readConnection) {
+			__block NSError *attachError = nil;
+			OCSQLiteQuery *attachQuery;
+
+			// Read connections need to attach the thumbnail database, too
+			attachQuery = [OCSQLiteQuery query:@"ATTACH DATABASE ? AS 'thumb'" withParameters:@[ thumbnailDatabaseURL.path ] resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) { // relatedTo:OCDatabaseTableNameThumbnails
+				attachError = error;
+			}];
+			attachQuery.readOnly = YES;
+
+			[readConnection executeQuery:attachQuery];
+
+			return (attachError);
+		};
+
 		[self addSchemas];
 	}
 
 	return (self);
 }
 
+#pragma mark - Resource blob store
+- (OCResourceBlobStore *)resourceBlobStore
+{
+	@synchronized(self)
+	{
+		if (_resourceBlobStore == nil)
+		{
+			_resourceBlobStore = [[OCResourceBlobStore alloc] initWithRootURL:self.resourceBlobStoreURL];
+		}
+
+		return (_resourceBlobStore);
+	}
+}
+
 #pragma mark - Open / Close
 - (void)openWithCompletionHandler:(OCDatabaseCompletionHandler)completionHandler
 {
@@ -142,6 +182,8 @@
 							{
 								[self.sqlDB executeQueryString:@"PRAGMA journal_mode"];
 
+								[self _updateNameSortKeysIfLocaleChanged];
+
 								[self.sqlDB dropTableSchemas]; //!< Table schemas no longer needed, save memory
 
 								if (completionHandler!=nil)
@@ -228,6 +270,77 @@
 	return (_openCount > 0);
 }
 
+#pragma mark - Sort keys
+- (void)_updateNameSortKeysIfLocaleChanged
+{
+	// Sort keys depend on the locale they were computed for - recompute all stored sort keys if it changed since they were computed
+	NSString *localeIdentifier = OCSQLiteCollationLocalized.sortKeyLocaleIdentifier;
+
+	[self.sqlDB executeTransaction:[OCSQLiteTransaction transactionWithBlock:^NSError *(OCSQLiteDB *db, OCSQLiteTransaction *transaction) {
+		INSTALL_TRANSACTION_ERROR_COLLECTION_RESULT_HANDLER
+		__block NSString *storedLocaleIdentifier = nil;
+
+		[db executeQuery:[OCSQLiteQuery query:@"SELECT value FROM properties WHERE name = ?" withParameters:@[ OCDatabasePropertyNameSortKeyLocale ] resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) { // relatedTo:OCDatabaseTableNameProperties
+			if (error != nil)
+			{
+				transactionError = error;
+				return;
+			}
+
+			[resultSet iterateUsing:^(OCSQLiteResultSet *resultSet, NSUInteger line, NSDictionary<NSString *,id> *rowDictionary, BOOL *stop) {
+				storedLocaleIdentifier = OCTypedCast(rowDictionary[@"value"], NSString);
+			} error:&transactionError];
+		}]];
+		if (transactionError != nil) { return (transactionError); }
+
+		if ([storedLocaleIdentifier isEqual:localeIdentifier])
+		{
+			return (nil);
+		}
+
+		OCLogDebug(@"Recomputing name sort keys for locale %@ (previously computed for %@)", localeIdentifier, storedLocaleIdentifier);
+
+		[db executeQuery:[OCSQLiteQuery querySelectingColumns:@[@"mdID", @"name"] fromTable:OCDatabaseTableNameMetaData where:nil resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
+			if (error != nil)
+			{
+				transactionError = error;
+				return;
+			}
+
+			[resultSet iterateUsing:^(OCSQLiteResultSet *resultSet, NSUInteger line, NSDictionary<NSString *, id> *rowDictionary, BOOL *stop) {
+				NSString *name = OCTypedCast(rowDictionary[@"name"], NSString);
+
+				if ((name != nil) && (rowDictionary[@"mdID"] != nil))
+				{
+					[db executeQuery:[OCSQLiteQuery queryUpdatingRowWithID:rowDictionary[@"mdID"]
+									inTable:OCDatabaseTableNameMetaData
+									withRowValues:@{
+												@"nameSortKey" : [OCSQLiteCollationLocalized sortKeyForString:name]
+										       }
+									completionHandler:^(OCSQLiteDB *db, NSError *error) {
+										if (error != nil)
+										{
+											transactionError = error;
+										}
+									}
+							]
+					];
+				}
+			} error:&transactionError];
+		}]];
+		if (transactionError != nil) { return (transactionError); }
+
+		[db executeQuery:[OCSQLiteQuery query:@"INSERT OR REPLACE INTO properties (name, value) VALUES (?, ?)" withParameters:@[ OCDatabasePropertyNameSortKeyLocale, localeIdentifier ] resultHandler:resultHandler]]; // relatedTo:OCDatabaseTableNameProperties
+
+		return (transactionError);
+	} type:OCSQLiteTransactionTypeExclusive completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+		if (error != nil)
+		{
+			OCLogError(@"Error updating name sort keys for locale %@: %@", localeIdentifier, error);
+		}
+	}]];
+}
+
 #pragma mark - Transactions
 - (void)performBatchUpdates:(NSError *(^)(OCDatabase *database))updates completionHandler:(OCDatabaseCompletionHandler)completionHandler
 {
@@ -267,9 +380,226 @@
 	return @((NSUInteger)NSDate.timeIntervalSinceReferenceDate);
 }
 
+#pragma mark - Meta data rows
++ (NSArray<NSString *> *)_metaDataRowColumnNames
+{
+	static dispatch_once_t onceToken;
+	static NSArray<NSString *> *columnNames;
+
+	dispatch_once(&onceToken, ^{
+		// Order of the values returned by +_metaDataRowValuesForItem:..
+		columnNames = @[
+			@"type",
+			@"syncAnchor",
+			@"removed",
+			@"mdTimestamp",
+			@"locallyModified",
+			@"localRelativePath",
+			@"downloadTrigger",
+			@"locationString",
+			@"path",
+			@"parentPath",
+			@"name",
+			@"nameSortKey",
+			@"mimeType",
+			@"typeAlias",
+			@"size",
+			@"favorite",
+			@"cloudStatus",
+			@"hasLocalAttributes",
+			@"syncActivity",
+			@"lastUsedDate",
+			@"lastModifiedDate",
+			@"driveID",
+			@"fileID",
+			@"localID",
+			@"ownerUserName",
+			@"itemData"
+		];
+	});
+
+	return (columnNames);
+}
+
++ (NSArray<id<NSObject>> *)_metaDataRowValuesForItem:(OCItem *)item syncAnchor:(OCSyncAnchor)syncAnchor timestamp:(OCDatabaseTimestamp)mdTimestamp removed:(BOOL)removed
+{
+	NSString *name = [item.path lastPathComponent];
+
+	return (@[
+		@(item.type),
+		syncAnchor,
+		@(removed),
+		mdTimestamp,
+		@(item.locallyModified),
+		OCSQLiteNullProtect(item.localRelativePath),
+		OCSQLiteNullProtect(item.downloadTriggerIdentifier),
+		item.locationString,
+		item.path,
+		[item.path parentPath],
+		name,
+		[OCSQLiteCollationLocalized sortKeyForString:name],
+		OCSQLiteNullProtect(item.mimeType),
+		OCSQLiteNullProtect(item.typeAlias),
+		@(item.size),
+		@(item.isFavorite.boolValue),
+		@(item.cloudStatus),
+		@(item.hasLocalAttributes),
+		@(item.syncActivity),
+		OCSQLiteNullProtect(item.lastUsed),
+		OCSQLiteNullProtect(item.lastModified),
+		OCSQLiteNullProtect(item.driveID),
+		OCSQLiteNullProtect(item.fileID),
+		OCSQLiteNullProtect(item.localID),
+		OCSQLiteNullProtect(item.ownerUserName),
+		[item serializedData]
+	]);
+}
+
+- (NSArray<NSArray<id<NSObject>> *> *)_metaDataRowsForItems:(NSArray<OCItem *> *)items syncAnchor:(OCSyncAnchor)syncAnchor timestamp:(OCDatabaseTimestamp)mdTimestamp useItemRemoved:(BOOL)useItemRemoved
+{
+	// Computing row values - and serializing items in particular - makes up most of the work of writing items. It is done
+	// concurrently, in chunks, before the write, so that the SQLite thread only needs to bind and step the prepared statements.
+	const NSUInteger chunkSize = 32;
+	NSUInteger itemCount = items.count, chunkCount = (itemCount + chunkSize - 1) / chunkSize;
+	NSMutableArray<id> *rowsByChunk = [[NSMutableArray alloc] initWithCapacity:chunkCount];
+	NSMutableArray<NSArray<id<NSObject>> *> *rows = [[NSMutableArray alloc] initWithCapacity:itemCount];
+
+	for (NSUInteger chunkIdx=0; chunkIdx < chunkCount; chunkIdx++)
+	{
+		[rowsByChunk addObject:NSNull.null];
+	}
+
+	dispatch_apply(chunkCount, DISPATCH_APPLY_AUTO, ^(size_t chunkIdx) {
+		@autoreleasepool {
+			NSRange chunkRange = NSMakeRange(chunkIdx * chunkSize, MIN(chunkSize, itemCount - (chunkIdx * chunkSize)));
+			NSMutableArray<NSArray<id<NSObject>> *> *chunkRows = [[NSMutableArray alloc] initWithCapacity:chunkRange.length];
+
+			for (OCItem *item in [items subarrayWithRange:chunkRange])
+			{
+				[chunkRows addObject:[OCDatabase _metaDataRowValuesForItem:item syncAnchor:syncAnchor timestamp:mdTimestamp removed:(useItemRemoved ? item.removed : NO)]];
+			}
+
+			@synchronized(rowsByChunk)
+			{
+				rowsByChunk[chunkIdx] = chunkRows;
+			}
+		}
+	});
+
+	for (NSArray<NSArray<id<NSObject>> *> *chunkRows in rowsByChunk)
+	{
+		[rows addObjectsFromArray:chunkRows];
+	}
+
+	return (rows);
+}
+
+- (NSArray<OCSQLiteQuery *> *)_hierarchyQueriesForItems:(NSArray<OCItem *> *)items
+{
+	static dispatch_once_t onceToken;
+	static OCSQLiteQueryString rewriteSubtreeSQLQuery, upsertSQLQuery;
+	NSMutableArray<OCSQLiteQuery *> *queries = [[NSMutableArray alloc] initWithCapacity:items.count * 2];
+
+	dispatch_once(&onceToken, ^{
+		// ?1 = localID, ?2 = parentLocalID. Items whose parent is not (yet) in the hierarchy are placed below "/parentLocalID/" - and moved
+		// into place by the subtree rewrite once the parent is added.
+		NSString *idPathSQL = @"(CASE WHEN ?2 IS NULL THEN '/' ELSE COALESCE((SELECT idPath FROM itemHierarchy WHERE localID=?2), '/' || ?2 || '/') END || ?1 || '/')";
+
+		// Moves the subtree of the item (all idPaths in the range of its previous idPath) to its new idPath in one set-based UPDATE
+		rewriteSubtreeSQLQuery = [NSString stringWithFormat:@"WITH idPaths(oldIDPath, newIDPath) AS (SELECT COALESCE((SELECT idPath FROM itemHierarchy WHERE localID=?1), '/' || ?1 || '/'), %@) "
+					   "UPDATE itemHierarchy SET idPath = (SELECT newIDPath FROM idPaths) || substr(idPath, (SELECT length(oldIDPath) FROM idPaths) + 1) "
+					   "WHERE (SELECT oldIDPath != newIDPath FROM idPaths) AND idPath > (SELECT oldIDPath FROM idPaths) AND idPath < (SELECT substr(oldIDPath, 1, length(oldIDPath) - 1) || '0' FROM idPaths)", idPathSQL];
+
+		upsertSQLQuery = [NSString stringWithFormat:@"INSERT OR REPLACE INTO itemHierarchy (localID, parentLocalID, idPath) VALUES (?1, ?2, %@)", idPathSQL];
+	});
+
+	for (OCItem *item in items)
+	{
+		OCLocalID localID;
+
+		// Removed items keep their entries until they are purged from metaData (=> temp_delete_associated_hierarchy trigger)
+		if (((localID = item.localID) != nil) && !item.removed)
+		{
+			NSArray *parameters = @[ localID, OCSQLiteNullProtect(item.parentLocalID) ];
+
+			if (item.type == OCItemTypeCollection)
+			{
+				[queries addObject:[OCSQLiteQuery query:rewriteSubtreeSQLQuery withParameters:parameters resultHandler:nil]]; // relatedTo:OCDatabaseTableNameItemHierarchy
+			}
+
+			[queries addObject:[OCSQLiteQuery query:upsertSQLQuery withParameters:parameters resultHandler:nil]]; // relatedTo:OCDatabaseTableNameItemHierarchy
+		}
+	}
+
+	return (queries);
+}
+
+- (NSArray<OCItem *> *)_itemsWithChangedHierarchyPositionFromItems:(NSArray<OCItem *> *)items inDB:(OCSQLiteDB *)db error:(NSError **)outError
+{
+	// Returns the items that are not yet in the hierarchy or whose parentLocalID changed. Renames leave an item's idPath (which is built from localIDs) unchanged.
+	NSMutableDictionary<OCLocalID, OCItem *> *itemsByLocalID = [[NSMutableDictionary alloc] initWithCapacity:items.count];
+	NSMutableArray<OCItem *> *changedItems = [NSMutableArray new];
+	__block NSError *error = nil;
+
+	for (OCItem *item in items)
+	{
+		OCLocalID localID;
+
+		if (((localID = item.localID) != nil) && !item.removed)
+		{
+			itemsByLocalID[localID] = item;
+		}
+	}
+
+	if (itemsByLocalID.count == 0)
+	{
+		return (changedItems);
+	}
+
+	NSArray<OCLocalID> *localIDs = itemsByLocalID.allKeys;
+	NSString *placeholders = [@"" stringByPaddingToLength:((localIDs.count * 2) - 1) withString:@"?," startingAtIndex:0];
+
+	[db executeQuery:[OCSQLiteQuery query:[NSString stringWithFormat:@"SELECT localID, parentLocalID FROM itemHierarchy WHERE localID IN (%@)", placeholders] withParameters:localIDs resultHandler:^(OCSQLiteDB *db, NSError *queryError, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) { // relatedTo:OCDatabaseTableNameItemHierarchy
+		if (queryError != nil)
+		{
+			error = queryError;
+			return;
+		}
+
+		[resultSet iterateUsing:^(OCSQLiteResultSet *resultSet, NSUInteger line, NSDictionary<NSString *,id> *rowDictionary, BOOL *stop) {
+			OCLocalID localID = OCTypedCast(rowDictionary[@"localID"], NSString);
+			OCLocalID parentLocalID = OCTypedCast(rowDictionary[@"parentLocalID"], NSString);
+			OCItem *item;
+
+			if ((localID != nil) && ((item = itemsByLocalID[localID]) != nil) && OCNAIsEqual(item.parentLocalID, parentLocalID))
+			{
+				// Unchanged position in hierarchy
+				[itemsByLocalID removeObjectForKey:localID];
+			}
+		} error:&error];
+	}]];
+
+	if (outError != NULL)
+	{
+		*outError = error;
+	}
+
+	for (OCItem *item in items)
+	{
+		if ((item.localID != nil) && (itemsByLocalID[item.localID] == item))
+		{
+			[changedItems addObject:item];
+		}
+	}
+
+	return (changedItems);
+}
+
 - (void)addCacheItems:(NSArray <OCItem *> *)items syncAnchor:(OCSyncAnchor)syncAnchor completionHandler:(OCDatabaseCompletionHandler)completionHandler
 {
 	OCDatabaseTimestamp mdTimestamp = [self _timestampForSyncAnchor:syncAnchor];
+	NSArray<NSString *> *columnNames = OCDatabase._metaDataRowColumnNames;
+	NSUInteger rowsPerQuery = OCSQLiteMaxParametersPerQuery / columnNames.count;
 
 	if (_itemFilter != nil)
 	{
@@ -277,8 +607,6 @@
 	}
 
 	[items enumerateObjectsWithTransformer:^id _Nullable(OCItem * _Nonnull item, NSUInteger idx, BOOL * _Nonnull stop) {
-		OCSQLiteQuery *query = nil;
-
 		if (item.localID == nil)
 		{
 			OCLogWarning(@"Item added without localID: %@", item);
@@ -289,39 +617,31 @@
 			OCLogWarning(@"Item added without parentLocalID: %@", item);
 		}
 
-		query = [OCSQLiteQuery queryInsertingIntoTable:OCDatabaseTableNameMetaData rowValues:@{
-			@"type" 		: @(item.type),
-			@"syncAnchor"		: syncAnchor,
-			@"removed"		: @(0),
-			@"mdTimestamp"		: mdTimestamp,
-			@"locallyModified" 	: @(item.locallyModified),
-			@"localRelativePath"	: OCSQLiteNullProtect(item.localRelativePath),
-			@"downloadTrigger"	: OCSQLiteNullProtect(item.downloadTriggerIdentifier),
-			@"locationString"	: item.locationString,
-			@"path" 		: item.path,
-			@"parentPath" 		: [item.path parentPath],
-			@"name"			: [item.path lastPathComponent],
-			@"mimeType" 		: OCSQLiteNullProtect(item.mimeType),
-			@"typeAlias" 		: OCSQLiteNullProtect(item.typeAlias),
-			@"size" 		: @(item.size),
-			@"favorite" 		: @(item.isFavorite.boolValue),
-			@"cloudStatus" 		: @(item.cloudStatus),
-			@"hasLocalAttributes" 	: @(item.hasLocalAttributes),
-			@"syncActivity"		: @(item.syncActivity),
-			@"lastUsedDate" 	: OCSQLiteNullProtect(item.lastUsed),
-			@"lastModifiedDate"	: OCSQLiteNullProtect(item.lastModified),
-			@"driveID"		: OCSQLiteNullProtect(item.driveID),
-			@"fileID"		: OCSQLiteNullProtect(item.fileID),
-			@"localID"		: OCSQLiteNullProtect(item.localID),
-			@"ownerUserName"	: OCSQLiteNullProtect(item.ownerUserName),
-			@"itemData"		: [item serializedData]
-		} resultHandler:^(OCSQLiteDB *db, NSError *error, NSNumber *rowID) {
-			item.databaseID = rowID;
-			item.databaseTimestamp = mdTimestamp;
-		}];
+		return (item);
+	} process:^(NSArray<OCItem *> * _Nonnull segmentItems, NSUInteger processed, NSUInteger total, BOOL * _Nonnull stop) {
+		NSArray<NSArray<id<NSObject>> *> *rows = [self _metaDataRowsForItems:segmentItems syncAnchor:syncAnchor timestamp:mdTimestamp useItemRemoved:NO];
+		NSMutableArray<OCSQLiteQuery *> *queries = [NSMutableArray new];
+
+		// Insert rows with multi-row INSERTs - all but the last query share the same prepared statement
+		for (NSUInteger offset=0; offset < rows.count; offset += rowsPerQuery)
+		{
+			NSRange range = NSMakeRange(offset, MIN(rowsPerQuery, rows.count - offset));
+			NSArray<OCItem *> *queryItems = [segmentItems subarrayWithRange:range];
+			OCSQLiteQuery *query;
+
+			if ((query = [OCSQLiteQuery queryInsertingIntoTable:OCDatabaseTableNameMetaData columnNames:columnNames rows:[rows subarrayWithRange:range] resultHandler:^(OCSQLiteDB *db, NSError *error, NSArray<NSNumber *> *rowIDs) {
+				[queryItems enumerateObjectsUsingBlock:^(OCItem * _Nonnull item, NSUInteger idx, BOOL * _Nonnull stop) {
+					item.databaseID = rowIDs[idx];
+					item.databaseTimestamp = mdTimestamp;
+				}];
+			}]) != nil)
+			{
+				[queries addObject:query];
+			}
+		}
+
+		[queries addObjectsFromArray:[self _hierarchyQueriesForItems:segmentItems]];
 
-		return (query);
-	} process:^(NSArray<OCSQLiteQuery *> * _Nonnull queries, NSUInteger processed, NSUInteger total, BOOL * _Nonnull stop) {
 		[self.sqlDB executeTransaction:[OCSQLiteTransaction transactionWithQueries:queries type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
 			if (error != nil)
 			{
@@ -343,6 +663,13 @@
 {
 	OCDatabaseTimestamp mdTimestamp = [self _timestampForSyncAnchor:syncAnchor];
 	__block NSMutableSet<OCLocationString> *removedLocations = nil;
+	static dispatch_once_t onceToken;
+	static OCSQLiteQueryString updateSQLQuery;
+
+	dispatch_once(&onceToken, ^{
+		// Same query string for all items, so that the prepared statement is reused
+		updateSQLQuery = [NSString stringWithFormat:@"UPDATE %@ SET %@=? WHERE mdID=?", OCDatabaseTableNameMetaData, [OCDatabase._metaDataRowColumnNames componentsJoinedByString:@"=?,"]];
+	});
 
 	if (_itemFilter != nil)
 	{
@@ -350,7 +677,7 @@
 	}
 
 	[items enumerateObjectsWithTransformer:^id _Nullable(OCItem * _Nonnull item, NSUInteger idx, BOOL * _Nonnull stop) {
-		OCSQLiteQuery *query = nil;
+		OCItem *updateItem = nil;
 
 		if ((item.localID == nil) && (!item.removed))
 		{
@@ -364,34 +691,7 @@
 
 		if (item.databaseID != nil)
 		{
-			query = [OCSQLiteQuery queryUpdatingRowWithID:item.databaseID inTable:OCDatabaseTableNameMetaData withRowValues:@{
-				@"type" 		: @(item.type),
-				@"syncAnchor"		: syncAnchor,
-				@"removed"		: @(item.removed),
-				@"mdTimestamp"		: mdTimestamp,
-				@"locallyModified" 	: @(item.locallyModified),
-				@"localRelativePath"	: OCSQLiteNullProtect(item.localRelativePath),
-				@"downloadTrigger"	: OCSQLiteNullProtect(item.downloadTriggerIdentifier),
-				@"locationString"	: item.locationString,
-				@"path" 		: item.path,
-				@"parentPath" 		: [item.path parentPath],
-				@"name"			: [item.path lastPathComponent],
-				@"mimeType" 		: OCSQLiteNullProtect(item.mimeType),
-				@"typeAlias" 		: OCSQLiteNullProtect(item.typeAlias),
-				@"size" 		: @(item.size),
-				@"favorite" 		: @(item.isFavorite.boolValue),
-				@"cloudStatus" 		: @(item.cloudStatus),
-				@"hasLocalAttributes" 	: @(item.hasLocalAttributes),
-				@"syncActivity"		: @(item.syncActivity),
-				@"lastUsedDate" 	: OCSQLiteNullProtect(item.lastUsed),
-				@"lastModifiedDate" 	: OCSQLiteNullProtect(item.lastModified),
-				@"driveID"		: OCSQLiteNullProtect(item.driveID),
-				@"fileID"		: OCSQLiteNullProtect(item.fileID),
-				@"localID"		: OCSQLiteNullProtect(item.localID),
-				@"ownerUserName"	: OCSQLiteNullProtect(item.ownerUserName),
-				@"itemData"		: [item serializedData]
-			} completionHandler:nil];
-
+			updateItem = item;
 			item.databaseTimestamp = mdTimestamp;
 		}
 		else
@@ -414,23 +714,40 @@
 			}
 		}
 
-		return (query);
-	} process:^(NSArray<OCSQLiteQuery *> *queries, NSUInteger processed, NSUInteger total, BOOL * _Nonnull stop) {
-		// If removedLocations has entries, add SQL entries for them
-		NSMutableArray<OCSQLiteQuery *> *combinedQueries = (removedLocations != nil) ? [[NSMutableArray alloc] initWithArray:queries] : (NSMutableArray *)queries;
+		return (updateItem);
+	} process:^(NSArray<OCItem *> *segmentItems, NSUInteger processed, NSUInteger total, BOOL * _Nonnull stop) {
+		NSArray<NSArray<id<NSObject>> *> *rows = [self _metaDataRowsForItems:segmentItems syncAnchor:syncAnchor timestamp:mdTimestamp useItemRemoved:YES];
+		NSMutableArray<OCSQLiteQuery *> *combinedQueries = [[NSMutableArray alloc] initWithCapacity:rows.count];
 
+		for (NSUInteger idx=0; idx < rows.count; idx++)
+		{
+			[combinedQueries addObject:[OCSQLiteQuery query:updateSQLQuery withParameters:[rows[idx] arrayByAddingObject:segmentItems[idx].databaseID] resultHandler:nil]];
+		}
+
+		// If removedLocations has entries, add SQL entries for them
 		if (removedLocations != nil)
 		{
 			for (OCLocationString locationString in removedLocations)
 			{
 				// Update removed and syncAnchor for all items inside removed folders
-				OCSQLiteQuery *removalQuery = [OCSQLiteQuery queryUpdatingRowsWhere:@{
-					@"locationString" : [OCSQLiteQueryCondition queryConditionWithOperator:@" LIKE " value:[locationString stringByAppendingString:@"%"] apply:YES]
-				} inTable:OCDatabaseTableNameMetaData withRowValues:@{
-					@"removed"	: @(YES),
-					@"syncAnchor"	: syncAnchor,
-					@"mdTimestamp"	: mdTimestamp
-				} completionHandler:nil];
+				OCSQLiteQuery *removalQuery;
+				NSString *locationStringUpperBound;
+
+				if ((locationStringUpperBound = [locationString stringBySQLPrefixUpperBound]) != nil)
+				{
+					// Range scan on the locationString index
+					removalQuery = [OCSQLiteQuery query:@"UPDATE metaData SET removed=1, syncAnchor=?, mdTimestamp=? WHERE locationString >= ? AND locationString < ?" withParameters:@[ syncAnchor, mdTimestamp, locationString, locationStringUpperBound ] resultHandler:nil];
+				}
+				else
+				{
+					removalQuery = [OCSQLiteQuery queryUpdatingRowsWhere:@{
+						@"locationString" : [OCSQLiteQueryCondition queryConditionWithOperator:@" LIKE " value:[locationString stringByAppendingString:@"%"] apply:YES]
+					} inTable:OCDatabaseTableNameMetaData withRowValues:@{
+						@"removed"	: @(YES),
+						@"syncAnchor"	: syncAnchor,
+						@"mdTimestamp"	: mdTimestamp
+					} completionHandler:nil];
+				}
 
 				[combinedQueries addObject:removalQuery];
 			}
@@ -438,7 +755,27 @@
 			removedLocations = nil;
 		}
 
-		[self.sqlDB executeTransaction:[OCSQLiteTransaction transactionWithQueries:combinedQueries type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+		[self.sqlDB executeTransaction:[OCSQLiteTransaction transactionWithBlock:^NSError *(OCSQLiteDB *db, OCSQLiteTransaction *transaction) {
+			__block NSError *transactionError = nil;
+			NSError *hierarchyError = nil;
+			NSArray<OCItem *> *hierarchyItems;
+			NSMutableArray<OCSQLiteQuery *> *transactionQueries = [combinedQueries mutableCopy];
+			NSArray<OCSQLiteQuery *> *hierarchyQueries;
+
+			// Only items that are new to the hierarchy or moved to another parent require hierarchy writes
+			hierarchyItems = [self _itemsWithChangedHierarchyPositionFromItems:segmentItems inDB:db error:&hierarchyError];
+			if (hierarchyError != nil) { return (hierarchyError); }
+
+			hierarchyQueries = [self _hierarchyQueriesForItems:hierarchyItems];
+			[transactionQueries insertObjects:hierarchyQueries atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(rows.count, hierarchyQueries.count)]];
+
+			// Executed as nested transaction (=> savepoint), so a failing query rolls back all queries
+			[db executeTransaction:[OCSQLiteTransaction transactionWithQueries:transactionQueries type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+				transactionError = error;
+			}]];
+
+			return (transactionError);
+		} type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
 			if (error != nil)
 			{
 				*stop = YES;
@@ -649,7 +986,7 @@
 
 - (void)_retrieveCacheItemForSQLQuery:(NSString *)sqlQuery parameters:(nullable NSArray<id> *)parameters completionHandler:(OCDatabaseRetrieveItemCompletionHandler)completionHandler
 {
-	[self.sqlDB executeQuery:[OCSQLiteQuery query:sqlQuery withParameters:parameters resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
+	OCSQLiteQuery *query = [OCSQLiteQuery query:sqlQuery withParameters:parameters resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
 		if (error != nil)
 		{
 			completionHandler(self, error, nil, nil);
@@ -660,11 +997,14 @@
 				completionHandler(db, error, syncAnchor, items.firstObject);
 			}];
 		}
-	}]];
+	}];
+
+	query.readOnly = YES;
 
+	[self.sqlDB executeQuery:query];
 }
 
-- (void)_retrieveCacheItemsForSQLQuery:(NSString *)sqlQuery parameters:(nullable NSArray<id> *)parameters cancelAction:(OCCancelAction *)cancelAction completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler
+- (OCSQLiteQuery *)_cacheItemsQueryForSQLQuery:(NSString *)sqlQuery parameters:(nullable NSArray<id> *)parameters completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler
 {
 	OCSQLiteQuery *query = [OCSQLiteQuery query:sqlQuery withParameters:parameters resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
 		if (error != nil)
@@ -677,6 +1017,15 @@
 		}
 	}];
 
+	query.readOnly = YES;
+
+	return (query);
+}
+
+- (void)_retrieveCacheItemsForSQLQuery:(NSString *)sqlQuery parameters:(nullable NSArray<id> *)parameters cancelAction:(OCCancelAction *)cancelAction completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler
+{
+	OCSQLiteQuery *query = [self _cacheItemsQueryForSQLQuery:sqlQuery parameters:parameters completionHandler:completionHandler];
+
 	if (cancelAction != nil)
 	{
 		__weak OCSQLiteQuery *weakQuery = query;
@@ -753,6 +1102,7 @@
 - (void)retrieveCacheItemsRecursivelyBelowLocation:(OCLocation *)location includingPathItself:(BOOL)includingPathItself includingRemoved:(BOOL)includingRemoved completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler
 {
 	NSMutableArray *parameters = [NSMutableArray new];
+	NSString *sqlStatement, *pathUpperBound;
 
 	if (location.path.length == 0)
 	{
@@ -762,25 +1112,88 @@
 		return;
 	}
 
-	[parameters addObject:[[location.path stringBySQLLikeEscaping] stringByAppendingString:@"%"]];
+	if ((pathUpperBound = [location.path stringBySQLPrefixUpperBound]) != nil)
+	{
+		// Range scan on the path index (unlike LIKE, which is case-insensitive and can't use the index)
+		sqlStatement = [_selectItemRowsSQLQueryPrefix stringByAppendingString:(includingPathItself ? @", removed FROM metaData WHERE path >= ? AND path < ?" : @", removed FROM metaData WHERE path > ? AND path < ?")];
+		[parameters addObject:location.path];
+		[parameters addObject:pathUpperBound];
+	}
+	else
+	{
+		sqlStatement = [_selectItemRowsSQLQueryPrefix stringByAppendingString:@", removed FROM metaData WHERE substr(path, 1, length(?)) = ?"];
+		[parameters addObject:location.path];
+		[parameters addObject:location.path];
 
-	NSString *sqlStatement = [_selectItemRowsSQLQueryPrefix stringByAppendingString:@", removed FROM metaData WHERE path LIKE ?"];
+		if (!includingPathItself)
+		{
+			sqlStatement = [sqlStatement stringByAppendingString:@" AND path!=?"];
+			[parameters addObject:location.path];
+		}
+	}
 
-	sqlStatement = [sqlStatement stringByAppendingString:@" AND driveID=?"];
+	sqlStatement = [sqlStatement stringByAppendingString:@" AND driveID IS ?"];
 	[parameters addObject:OCSQLiteNullProtect(location.driveID)];
 
-	if (includingRemoved)
+	if (!includingRemoved)
 	{
 		sqlStatement = [sqlStatement stringByAppendingString:@" AND removed=0"];
 	}
 
-	if (!includingPathItself)
+	[self _retrieveCacheItemsForSQLQuery:sqlStatement parameters:parameters cancelAction:nil completionHandler:completionHandler];
+}
+
+- (void)retrieveCacheItemsRecursivelyBelowItem:(OCItem *)item includingItemItself:(BOOL)includingItemItself includingRemoved:(BOOL)includingRemoved completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler
+{
+	OCSQLiteQuery *query;
+	OCLocalID localID;
+
+	if ((localID = item.localID) == nil)
 	{
-		sqlStatement = [sqlStatement stringByAppendingString:@" AND path!=?"];
-		[parameters addObject:location.path];
+		[self retrieveCacheItemsRecursivelyBelowLocation:item.location includingPathItself:includingItemItself includingRemoved:includingRemoved completionHandler:completionHandler];
+		return;
 	}
 
-	[self _retrieveCacheItemsForSQLQuery:sqlStatement parameters:parameters cancelAction:nil completionHandler:completionHandler];
+	query = [OCSQLiteQuery query:@"SELECT idPath FROM itemHierarchy WHERE localID=?" withParameters:@[ localID ] resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) { // relatedTo:OCDatabaseTableNameItemHierarchy
+		__block NSString *idPath = nil;
+		NSString *idPathUpperBound = nil;
+		NSError *returnError = error;
+
+		if (error == nil)
+		{
+			[resultSet iterateUsing:^(OCSQLiteResultSet *resultSet, NSUInteger line, NSDictionary<NSString *,id> *rowDictionary, BOOL *stop) {
+				idPath = OCTypedCast(rowDictionary[@"idPath"], NSString);
+			} error:&returnError];
+		}
+
+		if (returnError != nil)
+		{
+			completionHandler(self, returnError, nil, nil);
+		}
+		else if ((idPath != nil) && ((idPathUpperBound = [idPath stringBySQLPrefixUpperBound]) != nil))
+		{
+			// Subtree = range of idPaths starting with the item's idPath. Performed on the same connection, so it completes before this handler returns.
+			NSString *sqlStatement = [_selectItemRowsSQLQueryPrefix stringByAppendingString:(includingItemItself ?
+				@", removed FROM metaData WHERE localID IN (SELECT localID FROM itemHierarchy WHERE idPath >= ? AND idPath < ?)" :
+				@", removed FROM metaData WHERE localID IN (SELECT localID FROM itemHierarchy WHERE idPath > ? AND idPath < ?)")];
+
+			if (!includingRemoved)
+			{
+				sqlStatement = [sqlStatement stringByAppendingString:@" AND removed=0"];
+			}
+
+			[db executeQuery:[self _cacheItemsQueryForSQLQuery:sqlStatement parameters:@[ idPath, idPathUpperBound ] completionHandler:completionHandler]];
+		}
+		else
+		{
+			// Not (yet) part of the hierarchy
+			[self retrieveCacheItemsRecursivelyBelowLocation:item.location includingPathItself:includingItemItself includingRemoved:includingRemoved completionHandler:completionHandler];
+		}
+	}];
+
+	query.readOnly = YES;
+
+	[self.sqlDB executeQuery:query];
 }
 
 - (void)retrieveCacheItemsAtLocation:(OCLocation *)location itemOnly:(BOOL)itemOnly completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler
@@ -883,13 +1296,42 @@
 			OCItemPropertyNameDownloadTrigger	: @"downloadTrigger",
 
 			OCItemPropertyNameRemoved		: @"removed",
-			OCItemPropertyNameDatabaseTimestamp	: @"mdTimestamp"
+			OCItemPropertyNameDatabaseTimestamp	: @"mdTimestamp",
+			OCItemPropertyNameDatabaseSyncAnchor	: @"syncAnchor"
 		};
 	});
 
 	return (columnNameByPropertyName);
 }
 
++ (NSDictionary<OCItemPropertyName, NSString *> *)sortKeyColumnNameByPropertyName
+{
+	static dispatch_once_t onceToken;
+	static NSDictionary<OCItemPropertyName, NSString *> *sortKeyColumnNameByPropertyName;
+
+	dispatch_once(&onceToken, ^{
+		sortKeyColumnNameByPropertyName = @{
+			OCItemPropertyNameName : @"nameSortKey"
+		};
+	});
+
+	return (sortKeyColumnNameByPropertyName);
+}
+
++ (NSDictionary<OCItemPropertyName, NSString *> *)substringIndexQueryByPropertyName
+{
+	static dispatch_once_t onceToken;
+	static NSDictionary<OCItemPropertyName, NSString *> *substringIndexQueryByPropertyName;
+
+	dispatch_once(&onceToken, ^{
+		substringIndexQueryByPropertyName = @{
+			OCItemPropertyNameName : @"mdID IN (SELECT rowid FROM itemNameIndex WHERE name LIKE ?)"
+		};
+	});
+
+	return (substringIndexQueryByPropertyName);
+}
+
 - (void)retrieveCacheItemsForQueryCondition:(OCQueryCondition *)queryCondition cancelAction:(OCCancelAction *)cancelAction completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler
 {
 	NSString *sqlQueryString = [_selectItemRowsSQLQueryPrefix stringByAppendingString:@", removed FROM metaData WHERE removed=0 AND "];
@@ -897,7 +1339,7 @@
 	NSArray *parameters = nil;
 	NSError *error = nil;
 
-	if ((sqlWhereString = [queryCondition buildSQLQueryWithPropertyColumnNameMap:[[self class] columnNameByPropertyName] parameters:&parameters error:&error]) != nil)
+	if ((sqlWhereString = [queryCondition buildSQLQueryWithPropertyColumnNameMap:[[self class] columnNameByPropertyName] sortKeyColumnNameMap:[[self class] sortKeyColumnNameByPropertyName] substringIndexQueryMap:[[self class] substringIndexQueryByPropertyName] parameters:&parameters error:&error]) != nil)
 	{
 		sqlQueryString = [sqlQueryString stringByAppendingString:sqlWhereString];
 
@@ -909,6 +1351,99 @@
 	}
 }
 
+- (void)retrieveCacheItemsMatchingSearchTerms:(NSArray<NSString *> *)searchTerms limit:(NSUInteger)limit cancelAction:(OCCancelAction *)cancelAction completionHandler:(OCDatabaseRetrieveCompletionHandler)completionHandler
+{
+	NSMutableArray<NSString *> *matchPhrases = [NSMutableArray new];
+	NSMutableArray<NSString *> *likePatterns = [NSMutableArray new];
+	NSMutableArray *parameters = [NSMutableArray new];
+	NSString *sqlQueryString, *likeConditions = @"";
+	NSString *prefixPattern = nil;
+
+	for (NSString *searchTerm in searchTerms)
+	{
+		NSString *term = [searchTerm stringByTrimmingCharactersInSet:NSCharacterSet.whitespaceAndNewlineCharacterSet];
+
+		if (term.length == 0)
+		{
+			continue;
+		}
+
+		if ([term containsString:@"*"])
+		{
+			// Patterns are matched against the entire name, with their literal parts narrowing down the rows via the trigram index
+			NSMutableArray<NSString *> *escapedSegments = [NSMutableArray new];
+
+			for (NSString *segment in [term componentsSeparatedByString:@"*"])
+			{
+				if ((prefixPattern == nil) && (segment.length > 0))
+				{
+					prefixPattern = [[segment stringBySQLLikeEscaping] stringByAppendingString:@"%"];
+				}
+
+				if (segment.length >= 3)
+				{
+					[matchPhrases addObject:[NSString stringWithFormat:@"\"%@\"", [segment stringByReplacingOccurrencesOfString:@"\"" withString:@"\"\""]]];
+				}
+
+				[escapedSegments addObject:[segment stringBySQLLikeEscaping]];
+			}
+
+			[likePatterns addObject:[escapedSegments componentsJoinedByString:@"%"]];
+			continue;
+		}
+
+		if (prefixPattern == nil)
+		{
+			prefixPattern = [[term stringBySQLLikeEscaping] stringByAppendingString:@"%"];
+		}
+
+		if (term.length >= 3)
+		{
+			// Terms with at least three characters are matched against the trigram index as quoted phrases, which match any substring
+			[matchPhrases addObject:[NSString stringWithFormat:@"\"%@\"", [term stringByReplacingOccurrencesOfString:@"\"" withString:@"\"\""]]];
+		}
+		else
+		{
+			// Shorter terms can't be looked up in the trigram index and are matched against the (already narrowed down) rows instead
+			[likePatterns addObject:[NSString stringWithFormat:@"%%%@%%", [term stringBySQLLikeEscaping]]];
+		}
+	}
+
+	if (prefixPattern == nil)
+	{
+		completionHandler(self, nil, nil, @[]);
+		return;
+	}
+
+	for (NSUInteger i=0; i<likePatterns.count; i++)
+	{
+		likeConditions = [likeConditions stringByAppendingString:@" AND metaData.name LIKE ?"];
+	}
+
+	if (matchPhrases.count > 0)
+	{
+		// Items whose name starts with the first term first, then by relevance (bm25)
+		sqlQueryString = [_selectItemRowsSQLQueryPrefix stringByAppendingFormat:@", removed FROM itemNameIndex INNER JOIN metaData ON metaData.mdID=itemNameIndex.rowid WHERE itemNameIndex MATCH ? AND metaData.removed=0%@ ORDER BY (metaData.name LIKE ?) DESC, itemNameIndex.rank", likeConditions];
+
+		[parameters addObject:[matchPhrases componentsJoinedByString:@" "]];
+	}
+	else
+	{
+		// Items whose name starts with the first term first, then by name
+		sqlQueryString = [_selectItemRowsSQLQueryPrefix stringByAppendingFormat:@", removed FROM metaData WHERE removed=0%@ ORDER BY (metaData.name LIKE ?) DESC, nameSortKey", likeConditions];
+	}
+
+	[parameters addObjectsFromArray:likePatterns];
+	[parameters addObject:prefixPattern];
+
+	if (limit > 0)
+	{
+		sqlQueryString = [sqlQueryString stringByAppendingFormat:@" LIMIT %lu", (unsigned long)limit];
+	}
+
+	[self _retrieveCacheItemsForSQLQuery:sqlQueryString parameters:parameters cancelAction:cancelAction completionHandler:completionHandler];
+}
+
 - (void)iterateCacheItemsWithIterator:(void(^)(NSError *error, OCSyncAnchor syncAnchor, OCItem *item, BOOL *stop))iterator
 {
 	NSString *sqlQueryString = [_selectItemRowsSQLQueryPrefix stringByAppendingString:@", removed FROM metaData ORDER BY mdID ASC"];
@@ -938,7 +1473,7 @@
 
 	if (queryCondition != nil)
 	{
-		if ((sqlWhereString = [queryCondition buildSQLQueryWithPropertyColumnNameMap:[[self class] columnNameByPropertyName] parameters:&parameters error:&error]) != nil)
+		if ((sqlWhereString = [queryCondition buildSQLQueryWithPropertyColumnNameMap:[[self class] columnNameByPropertyName] sortKeyColumnNameMap:[[self class] sortKeyColumnNameByPropertyName] substringIndexQueryMap:[[self class] substringIndexQueryByPropertyName] parameters:&parameters error:&error]) != nil)
 		{
 			sqlQueryString = [_selectItemRowsSQLQueryPrefix stringByAppendingFormat:@", removed FROM metaData WHERE %@%@", (excludeRemoved ? @"removed=0 AND " : @""), sqlWhereString];
 		}
@@ -956,7 +1491,7 @@
 
 	// OCLogDebug(@"Iterating result for %@ with parameters %@", sqlQueryString, parameters);
 
-	[self.sqlDB executeQuery:[OCSQLiteQuery query:sqlQueryString withParameters:parameters resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
+	OCSQLiteQuery *query = [OCSQLiteQuery query:sqlQueryString withParameters:parameters resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
 		NSError *returnError = nil;
 
 		[resultSet iterateUsing:^(OCSQLiteResultSet *resultSet, NSUInteger line, NSDictionary<NSString *,id<NSObject>> *resultDict, BOOL *stop) {
@@ -969,7 +1504,11 @@
 		} error:&returnError];
 
 		iterator(returnError, nil, nil, NULL);
-	}]];
+	}];
+
+	query.readOnly = YES;
+
+	[self.sqlDB executeQuery:query];
 }
 
 #pragma mark - Directory Update Job interface
@@ -1049,6 +1588,84 @@
 	}
 }
 
+#pragma mark - Folder scan interface
+- (void)setScannedContentsETag:(OCFileETag)eTag forFolderWithFileID:(OCFileID)fileID completionHandler:(OCDatabaseCompletionHandler)completionHandler
+{
+	if ((eTag != nil) && (fileID != nil))
+	{
+		[self.sqlDB executeQuery:[OCSQLiteQuery queryInsertingOrReplacingIntoTable:OCDatabaseTableNameFolderScans rowValues:@{
+			@"fileID"	: fileID,
+			@"eTag"		: eTag,
+			@"lastScanned"	: @(NSDate.timeIntervalSinceReferenceDate)
+		} resultHandler:^(OCSQLiteDB *db, NSError *error, NSNumber *rowID) {
+			if (completionHandler != nil)
+			{
+				completionHandler(self, error);
+			}
+		}]];
+	}
+	else
+	{
+		OCLogError(@"Could not record folder scan: eTag=%@, fileID=%@", eTag, fileID);
+
+		if (completionHandler != nil)
+		{
+			completionHandler(self, OCError(OCErrorInsufficientParameters));
+		}
+	}
+}
+
+- (void)retrieveScannedContentsETagForFolderWithFileID:(OCFileID)fileID completionHandler:(void(^)(NSError *error, OCFileETag eTag))completionHandler
+{
+	if (fileID == nil)
+	{
+		completionHandler(OCError(OCErrorInsufficientParameters), nil);
+		return;
+	}
+
+	[self.sqlDB executeQuery:[OCSQLiteQuery query:@"SELECT eTag FROM folderScans WHERE fileID = ?" withParameters:@[ fileID ] resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) { // relatedTo:OCDatabaseTableNameFolderScans
+		__block OCFileETag eTag = nil;
+		NSError *returnError = error;
+
+		if (error == nil)
+		{
+			[resultSet iterateUsing:^(OCSQLiteResultSet *resultSet, NSUInteger line, NSDictionary<NSString *,id> *rowDictionary, BOOL *stop) {
+				eTag = OCTypedCast(rowDictionary[@"eTag"], NSString);
+			} error:&returnError];
+		}
+
+		completionHandler(returnError, eTag);
+	}]];
+}
+
+- (void)removeScannedContentsETagsForFolderFileIDs:(NSArray<OCFileID> *)fileIDs completionHandler:(OCDatabaseCompletionHandler)completionHandler
+{
+	if (fileIDs.count == 0)
+	{
+		if (completionHandler != nil)
+		{
+			completionHandler(self, nil);
+		}
+		return;
+	}
+
+	NSMutableArray<OCSQLiteQuery *> *queries = [NSMutableArray new];
+
+	for (OCFileID fileID in fileIDs)
+	{
+		[queries addObject:[OCSQLiteQuery queryDeletingRowsWhere:@{
+			@"fileID" : fileID
+		} fromTable:OCDatabaseTableNameFolderScans completionHandler:nil]];
+	}
+
+	[self.sqlDB executeTransaction:[OCSQLiteTransaction transactionWithQueries:queries type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+		if (completionHandler != nil)
+		{
+			completionHandler(self, error);
+		}
+	}]];
+}
+
 #pragma mark - Sync Lane interface
 - (void)addSyncLane:(OCSyncLane *)lane completionHandler:(OCDatabaseCompletionHandler)completionHandler
 {
@@ -22,6 +22,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface OCSQLiteCollationLocalized : OCSQLiteCollation
 
++ (NSString *)sortKeyLocaleIdentifier; //!< Identifier of the locale sort keys are computed for. Stored sort keys need to be recomputed when it changes.
++ (NSData *)sortKeyForString:(NSString *)string; //!< Returns a binary sort key for string. Sort keys can be compared with memcmp() (f.ex. as BLOB in SQLite) to sort strings in (close to) the order of -localizedStandardCompare: without the cost of a collation callback per comparison.
+
 @end
 
 extern OCSQLiteCollationName OCSQLiteCollationNameLocalized;
@@ -44,6 +44,108 @@
 	return ([string1 localizedStandardCompare:string2]);
 }
 
+#pragma mark - Sort keys
+/*
+	Sort keys consist of three levels, separated by a 0x0000 unit (which sorts before any other unit, so that shorter strings sort first):
+
+	1) primary: the string folded case, diacritic and width insensitive, as big-endian UTF-16 units. Runs of ASCII digits are encoded as
+	   marker unit ('0'), followed by the number of significant digits and the significant digits themselves, so that numbers sort by
+	   their numeric value ("file2" before "file10") and before letters.
+	2) secondary: the string folded case and width insensitive (diacritics preserved), as big-endian UTF-16 units
+	3) tertiary: one unit per UTF-16 unit of the string, 0x0001 for lowercase/uncased characters and 0x0002 for uppercase characters, so that lowercase sorts before uppercase
+
+	Differences to -localizedStandardCompare: primary level characters are ordered by their Unicode code point rather than locale-specific
+	collation rules (f.ex. Swedish "å" sorts as "a", not after "z").
+*/
+static void OCSQLiteCollationLocalizedAppendUnit(NSMutableData *sortKey, unichar unit)
+{
+	uint16_t bigEndianUnit = CFSwapInt16HostToBig(unit);
+	[sortKey appendBytes:&bigEndianUnit length:sizeof(bigEndianUnit)];
+}
+
+static void OCSQLiteCollationLocalizedAppendUnits(NSMutableData *sortKey, NSString *string, BOOL encodeNumbers)
+{
+	NSUInteger length = string.length;
+	unichar *units;
+
+	if ((length == 0) || ((units = malloc(length * sizeof(unichar))) == NULL))
+	{
+		return;
+	}
+
+	[string getCharacters:units range:NSMakeRange(0, length)];
+
+	for (NSUInteger idx=0; idx < length; idx++)
+	{
+		unichar unit = units[idx];
+
+		if (encodeNumbers && (unit >= '0') && (unit <= '9'))
+		{
+			NSUInteger runStart = idx, runEnd = idx;
+
+			while ((runEnd < length) && (units[runEnd] >= '0') && (units[runEnd] <= '9')) { runEnd++; }
+
+			// Skip leading zeros, but keep at least one digit
+			while ((runStart < (runEnd-1)) && (units[runStart] == '0')) { runStart++; }
+
+			OCSQLiteCollationLocalizedAppendUnit(sortKey, '0');
+			OCSQLiteCollationLocalizedAppendUnit(sortKey, (unichar)MIN(runEnd - runStart, 0xFFFF));
+
+			for (NSUInteger digitIdx = runStart; digitIdx < runEnd; digitIdx++)
+			{
+				OCSQLiteCollationLocalizedAppendUnit(sortKey, units[digitIdx]);
+			}
+
+			idx = runEnd - 1;
+		}
+		else
+		{
+			OCSQLiteCollationLocalizedAppendUnit(sortKey, unit);
+		}
+	}
+
+	free(units);
+}
+
++ (NSString *)sortKeyLocaleIdentifier
+{
+	return (NSLocale.currentLocale.localeIdentifier);
+}
+
++ (NSData *)sortKeyForString:(NSString *)string
+{
+	NSLocale *locale = NSLocale.currentLocale;
+	NSMutableData *sortKey;
+	NSString *primaryString, *secondaryString;
+	NSUInteger length;
+
+	string = string.precomposedStringWithCanonicalMapping;
+	length = string.length;
+
+	primaryString = [string stringByFoldingWithOptions:(NSCaseInsensitiveSearch|NSDiacriticInsensitiveSearch|NSWidthInsensitiveSearch) locale:locale];
+	secondaryString = [string stringByFoldingWithOptions:(NSCaseInsensitiveSearch|NSWidthInsensitiveSearch) locale:locale];
+
+	sortKey = [[NSMutableData alloc] initWithCapacity:(primaryString.length + secondaryString.length + length + 2) * sizeof(unichar)];
+
+	// Primary level
+	OCSQLiteCollationLocalizedAppendUnits(sortKey, primaryString, YES);
+	OCSQLiteCollationLocalizedAppendUnit(sortKey, 0);
+
+	// Secondary level
+	OCSQLiteCollationLocalizedAppendUnits(sortKey, secondaryString, NO);
+	OCSQLiteCollationLocalizedAppendUnit(sortKey, 0);
+
+	// Tertiary level
+	NSCharacterSet *uppercaseCharacterSet = NSCharacterSet.uppercaseLetterCharacterSet;
+
+	for (NSUInteger idx=0; idx < length; idx++)
+	{
+		OCSQLiteCollationLocalizedAppendUnit(sortKey, [uppercaseCharacterSet characterIsMember:[string characterAtIndex:idx]] ? 2 : 1);
+	}
+
+	return (sortKey);
+}
+
 @end
 
 OCSQLiteCollationName OCSQLiteCollationNameLocalized = @"OCLOCALIZED";
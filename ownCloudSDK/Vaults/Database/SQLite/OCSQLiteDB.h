@@ -60,9 +60,12 @@ NS_ASSUME_NONNULL_BEGIN
 typedef void(^OCSQLiteDBCompletionHandler)(OCSQLiteDB *db, NSError * _Nullable error);
 typedef void(^OCSQLiteDBResultHandler)(OCSQLiteDB *db, NSError * _Nullable error, OCSQLiteTransaction * _Nullable transaction, OCSQLiteResultSet * _Nullable resultSet);
 typedef void(^OCSQLiteDBInsertionHandler)(OCSQLiteDB *db, NSError * _Nullable error, NSNumber * _Nullable rowID);
+typedef void(^OCSQLiteDBMultiRowInsertionHandler)(OCSQLiteDB *db, NSError * _Nullable error, NSArray<NSNumber *> * _Nullable rowIDs); //!< rowIDs in the order of the inserted rows
 
 typedef void(^OCSQLiteDBBusyStatusHandler)(NSProgress * _Nullable progress); //!< Progress status handler for long-lasting operations (like DB migrations), called with nil when done
 
+typedef NSError * _Nullable(^OCSQLiteDBReadConnectionSetupHandler)(OCSQLiteDB *readConnection); //!< Setup handler for read connections, called on the read connection's thread after opening it
+
 @interface OCSQLiteDB : NSObject <OCLogTagging>
 {
 	NSURL *_databaseURL;
@@ -85,6 +88,10 @@ typedef void(^OCSQLiteDBBusyStatusHandler)(NSProgress * _Nullable progress); //!
 
 	NSHashTable<OCSQLiteStatement *> *_liveStatements;
 
+	NSMutableArray<OCSQLiteDB *> *_readConnections;
+	__weak OCSQLiteDB *_writeConnection;
+	NSUInteger _pendingReadCount;
+
 	sqlite3 *_db;
 }
 
@@ -109,6 +116,10 @@ typedef void(^OCSQLiteDBBusyStatusHandler)(NSProgress * _Nullable progress); //!
 @property(assign) BOOL allowMigrations;
 @property(copy,nullable) OCSQLiteDBBusyStatusHandler busyStatusHandler;
 
+@property(assign) NSUInteger maximumReadConnections; //!< Maximum number of read-only connections used to execute queries and transactions marked as .readOnly concurrently to the (single) writing connection. Requires WAL journal mode and a databaseURL. Defaults to 0 (read-only queries are executed on the writing connection).
+@property(copy,nullable) OCSQLiteDBReadConnectionSetupHandler readConnectionSetupHandler; //!< Called for every new read connection after it was opened (f.ex. to attach additional databases)
+@property(readonly,nonatomic) BOOL isReadConnection; //!< YES if this is a read connection managed by another OCSQLiteDB
+
 #if OCSQLITE_RAWLOG_ENABLED
 @property(assign) BOOL logStatements;
 #endif /* OCSQLITE_RAWLOG_ENABLED */
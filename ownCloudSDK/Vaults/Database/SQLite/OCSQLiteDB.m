@@ -149,7 +149,7 @@ static NSMutableDictionary<NSString *, NSNumber *> *sOCSQliteDBSharedRunLoopThre
 
 			if (threadName == nil)
 			{
-				if ((_databaseURL.path != nil) && !OCSQLiteDB.allowConcurrentFileAccess)
+				if ((_databaseURL.path != nil) && !OCSQLiteDB.allowConcurrentFileAccess && (_writeConnection == nil)) // Read connections need a thread of their own
 				{
 					threadName = [@"OCSQLiteDB-" stringByAppendingString:_databaseURL.path];
 				}
@@ -301,8 +301,8 @@ static void collationProvider(void *dbObj, sqlite3 *db, int eTextRep, const char
 					OCLogError(@"Error adding collation needed callback: %d", sqErr);
 				}
 
-				// Journal mode
-				if (self->_journalMode != nil)
+				// Journal mode (can't be changed by read-only connections)
+				if ((self->_journalMode != nil) && ((flags & OCSQLiteOpenFlagsReadOnly) == 0))
 				{
 					if ((error = [self _executeSimpleSQLQuery:[@"PRAGMA journal_mode=" stringByAppendingString:self->_journalMode]]) != nil)
 					{
@@ -354,6 +354,8 @@ static void collationProvider(void *dbObj, sqlite3 *db, int eTextRep, const char
 
 - (NSError *)_close
 {
+	[self _closeReadConnections];
+
 	if (_db != NULL)
 	{
 		int sqErr = SQLITE_OK;
@@ -547,28 +549,69 @@ static void collationProvider(void *dbObj, sqlite3 *db, int eTextRep, const char
 #pragma mark - Queries (public)
 - (void)executeQuery:(OCSQLiteQuery *)query
 {
-	if ([self isOnSQLiteThread])
-	{
-		[self _executeQuery:query inTransaction:nil];
-	}
-	else
-	{
-		[self queueBlock:^{
-			[self _executeQuery:query inTransaction:nil];
-		}];
-	}
+	[self _performReadOnly:query.readOnly block:^(OCSQLiteDB *db) {
+		[db _executeQuery:query inTransaction:nil];
+	}];
 }
 
 - (void)executeTransaction:(OCSQLiteTransaction *)transaction
 {
+	// Read connections can't acquire write locks, so only deferred transactions are eligible
+	[self _performReadOnly:(transaction.readOnly && (transaction.type == OCSQLiteTransactionTypeDeferred)) block:^(OCSQLiteDB *db) {
+		[db _executeTransaction:transaction];
+	}];
+}
+
+- (void)_performReadOnly:(BOOL)readOnly block:(void(^)(OCSQLiteDB *db))block
+{
+	OCSQLiteDB *writeConnection;
+
+	if ((writeConnection = _writeConnection) != nil)
+	{
+		// Read connection: perform reads (and everything inside a read transaction) right away, hand everything else to the write connection
+		if ([self isOnSQLiteThread] && (readOnly || (_transactionNestingLevel > 0)))
+		{
+			block(self);
+		}
+		else
+		{
+			[writeConnection _performReadOnly:readOnly block:block];
+		}
+
+		return;
+	}
+
 	if ([self isOnSQLiteThread])
 	{
-		[self _executeTransaction:transaction];
+		// Nested in another query or transaction: perform right away, on the same connection, so that uncommitted changes are visible
+		block(self);
+	}
+	else if ([self _isOnReadConnectionThread])
+	{
+		// Called from inside a query or transaction running on a read connection: perform synchronously - as would have been the case if the read had been performed on this connection
+		[self executeOperationSync:^NSError *(OCSQLiteDB *db) {
+			block(db);
+			return (nil);
+		}];
 	}
 	else
 	{
 		[self queueBlock:^{
-			[self _executeTransaction:transaction];
+			OCSQLiteDB *readConnection;
+
+			// Read connections are picked on the SQLite thread, so that reads are only started after all previously queued writes have been performed
+			if (readOnly && ((readConnection = [self _checkOutReadConnection]) != nil))
+			{
+				[readConnection queueBlock:^{
+					block(readConnection);
+
+					[self _checkInReadConnection:readConnection];
+				}];
+			}
+			else
+			{
+				block(self);
+			}
 		}];
 	}
 }
@@ -965,6 +1008,160 @@ static void collationProvider(void *dbObj, sqlite3 *db, int eTextRep, const char
 	[self leaveProcessing];
 }
 
+#pragma mark - Read connections
+- (BOOL)isReadConnection
+{
+	return (_writeConnection != nil);
+}
+
+- (BOOL)_isOnReadConnectionThread
+{
+	@synchronized(self)
+	{
+		for (OCSQLiteDB *readConnection in _readConnections)
+		{
+			if (readConnection.isOnSQLiteThread)
+			{
+				return (YES);
+			}
+		}
+	}
+
+	return (NO);
+}
+
+- (OCSQLiteDB *)_checkOutReadConnection
+{
+	// Must be called on the SQLite thread
+	OCSQLiteDB *readConnection = nil;
+	BOOL addReadConnection;
+
+	if ((_maximumReadConnections == 0) || (_databaseURL == nil) || ![_journalMode isEqual:OCSQLiteJournalModeWAL] || !_opened)
+	{
+		return (nil);
+	}
+
+	@synchronized(self)
+	{
+		// Pick the least busy read connection
+		for (OCSQLiteDB *connection in _readConnections)
+		{
+			if ((readConnection == nil) || (connection->_pendingReadCount < readConnection->_pendingReadCount))
+			{
+				readConnection = connection;
+			}
+		}
+
+		// All read connections busy, but limit not yet reached: add another one
+		addReadConnection = (((readConnection == nil) || (readConnection->_pendingReadCount > 0)) && (_readConnections.count < _maximumReadConnections));
+	}
+
+	if (addReadConnection)
+	{
+		OCSQLiteDB *newReadConnection;
+
+		if ((newReadConnection = [self _openReadConnection]) != nil)
+		{
+			readConnection = newReadConnection;
+		}
+	}
+
+	if (readConnection != nil)
+	{
+		@synchronized(self)
+		{
+			readConnection->_pendingReadCount++;
+		}
+	}
+
+	return (readConnection);
+}
+
+- (void)_checkInReadConnection:(OCSQLiteDB *)readConnection
+{
+	@synchronized(self)
+	{
+		readConnection->_pendingReadCount--;
+	}
+}
+
+- (OCSQLiteDB *)_openReadConnection
+{
+	OCSQLiteDB *readConnection = [[OCSQLiteDB alloc] initWithURL:_databaseURL];
+	__block NSError *error = nil;
+	NSUInteger readConnectionCount;
+
+	readConnection->_writeConnection = self;
+	readConnection->_maxBusyRetryTimeInterval = _maxBusyRetryTimeInterval;
+	readConnection.cacheStatements = _cacheStatements;
+	readConnection.allowMigrations = NO;
+
+	if (_collationsByName != nil)
+	{
+		@synchronized (_collationsByName)
+		{
+			for (OCSQLiteCollation *collation in _collationsByName.allValues)
+			{
+				[readConnection registerCollation:collation];
+			}
+		}
+	}
+
+	// Opening a new connection on its own, idle thread - waiting for it from the SQLite thread can't deadlock
+	OCSyncExec(waitForOpen, {
+		[readConnection openWithFlags:OCSQLiteOpenFlagsReadOnly completionHandler:^(OCSQLiteDB *db, NSError *openError) {
+			if ((openError == nil) && (self.readConnectionSetupHandler != nil))
+			{
+				openError = self.readConnectionSetupHandler(db);
+			}
+
+			error = openError;
+
+			OCSyncExecDone(waitForOpen);
+		}];
+	});
+
+	if (error != nil)
+	{
+		OCLogError(@"Error opening read connection: %@", error);
+
+		[readConnection closeWithCompletionHandler:nil];
+
+		return (nil);
+	}
+
+	@synchronized(self)
+	{
+		if (_readConnections == nil)
+		{
+			_readConnections = [NSMutableArray new];
+		}
+
+		[_readConnections addObject:readConnection];
+
+		readConnectionCount = _readConnections.count;
+	}
+
+	OCLogDebug(@"Opened read connection %lu for %@", (unsigned long)readConnectionCount, _databaseURL);
+
+	return (readConnection);
+}
+
+- (void)_closeReadConnections
+{
+	NSArray<OCSQLiteDB *> *readConnections;
+
+	@synchronized(self)
+	{
+		readConnections = _readConnections;
+		_readConnections = nil;
+	}
+
+	for (OCSQLiteDB *readConnection in readConnections)
+	{
+		[readConnection closeWithCompletionHandler:nil];
+	}
+}
 
 #pragma mark - Statement caching
 - (void)setCacheStatements:(BOOL)cacheStatements
@@ -1221,6 +1418,11 @@ static void collationProvider(void *dbObj, sqlite3 *db, int eTextRep, const char
 {
 	if (_db == NULL) { return; }
 
+	@synchronized(self)
+	{
+		[_readConnections makeObjectsPerformSelector:@selector(shrinkMemory)];
+	}
+
 	if ([self isOnSQLiteThread])
 	{
 		sqlite3_db_release_memory(_db);
@@ -30,6 +30,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property(copy) OCSQLiteDBResultHandler resultHandler;
 
+@property(assign) BOOL readOnly; //!< If YES, the query only reads from the database and may be executed on a read connection, concurrently to other queries (see OCSQLiteDB.maximumReadConnections). The result handler is then called on the read connection's thread, with the read connection as db.
+
 #pragma mark - Queries
 + (nullable instancetype)query:(OCSQLiteQueryString)sqlQuery withParameters:(nullable NSArray <id<NSObject>> *)parameters resultHandler:(nullable OCSQLiteDBResultHandler)resultHandler;
 + (nullable instancetype)query:(OCSQLiteQueryString)sqlQuery withNamedParameters:(nullable NSDictionary <NSString *, id<NSObject>> *)parameters resultHandler:(nullable OCSQLiteDBResultHandler)resultHandler;
@@ -43,6 +45,7 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark - INSERT query builder
 + (nullable instancetype)queryInsertingIntoTable:(NSString *)tableName rowValues:(NSDictionary <NSString *, id<NSObject>> *)rowValues resultHandler:(nullable OCSQLiteDBInsertionHandler)resultHandler;
 + (nullable instancetype)queryInsertingOrReplacingIntoTable:(NSString *)tableName rowValues:(NSDictionary <NSString *, id<NSObject>> *)rowValues resultHandler:(OCSQLiteDBInsertionHandler)resultHandler;
++ (nullable instancetype)queryInsertingIntoTable:(NSString *)tableName columnNames:(NSArray<NSString *> *)columnNames rows:(NSArray<NSArray<id<NSObject>> *> *)rows resultHandler:(nullable OCSQLiteDBMultiRowInsertionHandler)resultHandler; //!< Inserts several rows with a single INSERT statement. Values of each row must be in the order of columnNames. Stay below 999 values (rows x columns) to support all SQLite builds. Row IDs passed to the resultHandler are derived from the last inserted row ID, which requires that the rows of the statement receive consecutive row IDs: this holds for tables with an INTEGER PRIMARY KEY - with or without AUTOINCREMENT - as long as the row IDs are not provided in the rows and the largest possible row ID has not been reached.
 
 #pragma mark - UPDATE query builder
 + (nullable instancetype)queryUpdatingRowsWhere:(NSDictionary <NSString *, id<NSObject>> *)matchValues inTable:(NSString *)tableName withRowValues:(NSDictionary <NSString *, id<NSObject>> *)rowValues completionHandler:(nullable OCSQLiteDBCompletionHandler)completionHandler;
@@ -61,5 +64,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 NS_ASSUME_NONNULL_END
 
+#define OCSQLiteMaxParametersPerQuery 999 //!< Maximum number of parameters per query supported by all SQLite builds (SQLITE_MAX_VARIABLE_NUMBER defaults to 999 before SQLite 3.32)
+
 #define OCSQLiteNullProtect(object) (((object)!=nil) ? (object) : NSNull.null)
 #define OCSQLiteNullResolved(object) ([(object) isKindOfClass:[NSNull class]] ? nil : (object))
@@ -19,6 +19,7 @@
 #import "OCSQLiteQuery.h"
 #import "OCSQLiteQueryCondition.h"
 #import "OCSQLiteStatement.h"
+#import "OCLogger.h"
 
 @interface OCSQLiteQuery ()
 {
@@ -151,6 +152,67 @@
 	return ([self _queryWith:@"INSERT OR REPLACE" intoTable:tableName rowValues:rowValues resultHandler:resultHandler]);
 }
 
++ (instancetype)queryInsertingIntoTable:(NSString *)tableName columnNames:(NSArray<NSString *> *)columnNames rows:(NSArray<NSArray<id<NSObject>> *> *)rows resultHandler:(OCSQLiteDBMultiRowInsertionHandler)resultHandler
+{
+	OCSQLiteQuery *query = nil;
+	NSUInteger columnCount = columnNames.count, rowCount = rows.count;
+
+	if ((columnCount > 0) && (rowCount > 0))
+	{
+		NSMutableArray *values = [[NSMutableArray alloc] initWithCapacity:columnCount*rowCount];
+		NSMutableString *rowPlaceholdersString = [[NSMutableString alloc] initWithCapacity:2*columnCount+2];
+		NSMutableString *placeholdersString = [[NSMutableString alloc] initWithCapacity:(2*columnCount+3)*rowCount];
+
+		[rowPlaceholdersString appendString:@"("];
+		for (NSUInteger i=0; i<columnCount; i++)
+		{
+			[rowPlaceholdersString appendString:((i == (columnCount-1)) ? @"?)" : @"?,")];
+		}
+
+		for (NSArray<id<NSObject>> *row in rows)
+		{
+			if (row.count != columnCount)
+			{
+				OCLogError(@"Row with %lu values for %lu columns - not building multi-row INSERT into %@", (unsigned long)row.count, (unsigned long)columnCount, tableName);
+				return (nil);
+			}
+
+			if (placeholdersString.length > 0)
+			{
+				[placeholdersString appendString:@","];
+			}
+			[placeholdersString appendString:rowPlaceholdersString];
+
+			[values addObjectsFromArray:row];
+		}
+
+		query = [self new];
+		query.sqlQuery = [NSString stringWithFormat:@"INSERT INTO %@ (%@) VALUES %@", tableName, [columnNames componentsJoinedByString:@","], placeholdersString];
+		query.parameters = values;
+		query.resultHandler = (resultHandler!=nil) ? ^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
+			NSMutableArray<NSNumber *> *rowIDs = nil;
+			NSNumber *lastRowID;
+
+			if ((error == nil) && ((lastRowID = [db lastInsertRowID]) != nil))
+			{
+				// Rows of a multi-row INSERT are inserted one after another, each receiving the largest row ID + 1 (for AUTOINCREMENT: the largest row ID ever used + 1), so they are consecutive within one statement
+				long long firstRowID = lastRowID.longLongValue - (long long)rowCount + 1;
+
+				rowIDs = [[NSMutableArray alloc] initWithCapacity:rowCount];
+
+				for (NSUInteger i=0; i<rowCount; i++)
+				{
+					[rowIDs addObject:@(firstRowID + (long long)i)];
+				}
+			}
+
+			resultHandler(db, error, rowIDs);
+		} : nil;
+	}
+
+	return (query);
+}
+
 #pragma mark - UPDATE query builder
 + (instancetype)queryUpdatingRowsWhere:(NSDictionary <NSString *, id<NSObject>> *)matchValues inTable:(NSString *)tableName withRowValues:(NSDictionary <NSString *, id<NSObject>> *)rowValues completionHandler:(OCSQLiteDBCompletionHandler)completionHandler
 {
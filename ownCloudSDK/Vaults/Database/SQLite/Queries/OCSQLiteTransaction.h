@@ -40,6 +40,8 @@ typedef NS_ENUM(NSUInteger, OCSQLiteTransactionType) //!< See https://www.sqlite
 
 @property(assign) BOOL commit; //!< After running .queries or transactionBlock, this value is checked to see if the transaction should be committed (YES) or rolled back (NO). Defaults to YES.
 
+@property(assign) BOOL readOnly; //!< If YES, the transaction only reads from the database and may be executed on a read connection, concurrently to other queries (see OCSQLiteDB.maximumReadConnections). Only honored for transactions of type OCSQLiteTransactionTypeDeferred. All queries executed inside the transaction are then performed on the read connection, too.
+
 @property(nullable,copy) OCSQLiteTransactionCompletionHandler completionHandler; //!< Called after commit or rollback of transaction.
 
 @property(nullable,strong) id userInfo; //!< User info. Can be used to store any kind of object.
@@ -24,6 +24,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (NSString *)stringBySQLLikeEscaping;
 
+- (nullable NSString *)stringBySQLPrefixUpperBound; //!< Returns the smallest string larger than all strings starting with the receiver (in BINARY collation), so that prefix matches can be performed as range scans: (column >= prefix AND column < prefix.stringBySQLPrefixUpperBound). Returns nil if the receiver is empty or doesn't end with an ASCII character.
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -25,4 +25,25 @@
 	return ([self stringByReplacingOccurrencesOfString:@"%" withString:@"\\%"]);
 }
 
+- (NSString *)stringBySQLPrefixUpperBound
+{
+	NSUInteger length = self.length;
+	unichar lastCharacter;
+
+	if (length == 0)
+	{
+		return (nil);
+	}
+
+	// Incrementing an ASCII character also increments its (single byte) UTF-8 representation, which SQLite's BINARY collation compares
+	if ((lastCharacter = [self characterAtIndex:length-1]) >= 0x7F)
+	{
+		return (nil);
+	}
+
+	lastCharacter++;
+
+	return ([[self substringToIndex:length-1] stringByAppendingString:[NSString stringWithCharacters:&lastCharacter length:1]]);
+}
+
 @end
@@ -41,6 +41,7 @@
 			[Bookmark UUID]/ 				- OCVault.rootURL
 				[Bookmark UUID].db			- OCVault.databaseURL
 				[Bookmark UUID].tdb			  + (thumbnail part of .database)
+				"Resources"/				  + (OCDatabase.resourceBlobStoreURL, content-addressed blobs of resource data referenced from .tdb)
 
 				[Bookmark UUID].ockvs			- OCVault.keyValueStoreURL
 
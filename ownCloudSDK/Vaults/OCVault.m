@@ -333,8 +333,9 @@
 {
 	if (_keyValueStore == nil)
 	{
-		_keyValueStore = [OCKeyValueStore sharedWithURL:self.keyValueStoreURL identifier:self.uuid.UUIDString owner:nil];
+		_keyValueStore = [OCKeyValueStore sharedWithURL:self.keyValueStoreURL identifier:self.uuid.UUIDString owner:nil backend:OCKeyValueStoreBackendLog];
 		[_keyValueStore registerClass:OCEventQueue.class forKey:OCKeyValueStoreKeyOCCoreSyncEventsQueue];
+		[_keyValueStore registerClass:OCEventRecord.class forKey:OCKeyValueStoreKeyOCCoreSyncEvents];
 		[_keyValueStore registerClass:OCCoreUpdateScheduleRecord.class forKey:OCKeyValueStoreKeyCoreUpdateScheduleRecord];
 		[_keyValueStore registerClass:OCVaultDriveList.class forKey:OCKeyValueStoreKeyVaultDriveList];
 	}
@@ -121,6 +121,7 @@ FOUNDATION_EXPORT const unsigned char ownCloudSDKVersionString[];
 
 #import <ownCloudSDK/OCConnection.h>
 #import <ownCloudSDK/OCCapabilities.h>
+#import <ownCloudSDK/OCRangedDownloadJob.h>
 
 #import <ownCloudSDK/OCServerInstance.h>
 #import <ownCloudSDK/OCBookmark+ServerInstance.h>
@@ -128,11 +129,14 @@ FOUNDATION_EXPORT const unsigned char ownCloudSDKVersionString[];
 #import <ownCloudSDK/OCLockManager.h>
 #import <ownCloudSDK/OCLockRequest.h>
 #import <ownCloudSDK/OCLock.h>
+#import <ownCloudSDK/OCLockTable.h>
 
 #import <ownCloudSDK/OCHTTPRequest.h>
+#import <ownCloudSDK/OCHTTPRangedFileStream.h>
 #import <ownCloudSDK/OCHTTPRequest+JSON.h>
 #import <ownCloudSDK/OCHTTPResponse.h>
 #import <ownCloudSDK/OCHTTPDAVRequest.h>
+#import <ownCloudSDK/OCHTTPDAVItemStreamDecoder.h>
 
 #import <ownCloudSDK/OCHTTPCookieStorage.h>
 #import <ownCloudSDK/NSHTTPCookie+OCCookies.h>
@@ -141,8 +145,10 @@ FOUNDATION_EXPORT const unsigned char ownCloudSDKVersionString[];
 #import <ownCloudSDK/OCHTTPPipeline.h>
 #import <ownCloudSDK/OCHTTPPipelineTask.h>
 #import <ownCloudSDK/OCHTTPPipelineTaskMetrics.h>
+#import <ownCloudSDK/OCHTTPConcurrencyController.h>
 #import <ownCloudSDK/OCHTTPPipelineBackend.h>
 #import <ownCloudSDK/OCHTTPPipelineTaskCache.h>
+#import <ownCloudSDK/OCHTTPPipelineTaskIndex.h>
 
 #import <ownCloudSDK/OCHTTPPolicyManager.h>
 #import <ownCloudSDK/OCHTTPPolicy.h>
@@ -184,6 +190,7 @@ FOUNDATION_EXPORT const unsigned char ownCloudSDKVersionString[];
 #import <ownCloudSDK/OCResourceSource.h>
 #import <ownCloudSDK/OCResourceSourceURL.h>
 #import <ownCloudSDK/OCResourceSourceStorage.h>
+#import <ownCloudSDK/OCResourceBlobStore.h>
 #import <ownCloudSDK/OCResourceRequest.h>
 #import <ownCloudSDK/OCResourceRequestImage.h>
 #import <ownCloudSDK/OCResource.h>
@@ -219,6 +226,7 @@ FOUNDATION_EXPORT const unsigned char ownCloudSDKVersionString[];
 #import <ownCloudSDK/OCDataSourceMapped.h>
 #import <ownCloudSDK/OCDataSourceSubscription.h>
 #import <ownCloudSDK/OCDataSourceSnapshot.h>
+#import <ownCloudSDK/OCDataSourceDiff.h>
 #import <ownCloudSDK/OCDataItemRecord.h>
 #import <ownCloudSDK/OCDataConverter.h>
 #import <ownCloudSDK/OCDataConverterPipeline.h>
@@ -231,12 +239,14 @@ FOUNDATION_EXPORT const unsigned char ownCloudSDKVersionString[];
 #import <ownCloudSDK/OCQueryFilter.h>
 #import <ownCloudSDK/OCQueryCondition.h>
 #import <ownCloudSDK/OCQueryCondition+Item.h>
+#import <ownCloudSDK/OCQueryConditionProgram.h>
 #import <ownCloudSDK/OCQueryCondition+KQLBuilder.h>
 #import <ownCloudSDK/OCQueryChangeSet.h>
 
 #import <ownCloudSDK/OCItem.h>
 #import <ownCloudSDK/OCItem+OCDataItem.h>
 #import <ownCloudSDK/OCItem+OCTypeAlias.h>
+#import <ownCloudSDK/OCItem+BinaryCoding.h>
 #import <ownCloudSDK/OCItemVersionIdentifier.h>
 
 #import <ownCloudSDK/OCShare.h>
@@ -306,6 +316,7 @@ FOUNDATION_EXPORT const unsigned char ownCloudSDKVersionString[];
 #import <ownCloudSDK/OCChecksum.h>
 #import <ownCloudSDK/OCChecksumAlgorithm.h>
 #import <ownCloudSDK/OCChecksumAlgorithmSHA1.h>
+#import <ownCloudSDK/OCChecksumEngine.h>
 
 #import <ownCloudSDK/OCFile.h>
 
@@ -77,4 +77,72 @@
 	[self waitForExpectationsWithTimeout:5 handler:nil];
 }
 
+- (void)testChecksumEngineSinglePassAndConcurrency
+{
+	OCChecksumEngine *engine = [[OCChecksumEngine alloc] initWithMaximumConcurrentComputations:2];
+	NSArray<OCChecksumAlgorithm *> *algorithms = @[
+		[OCChecksumAlgorithm algorithmForIdentifier:OCChecksumAlgorithmIdentifierSHA1],
+		[OCChecksumAlgorithm algorithmForIdentifier:@"SHA3-256"]
+	];
+	NSMutableArray<NSURL *> *fileURLs = [NSMutableArray new];
+	NSMutableDictionary<NSURL *, NSData *> *dataByURL = [NSMutableDictionary new];
+
+	XCTAssert(algorithms.count == 2);
+
+	// Create files of different sizes, spanning several chunks
+	for (NSUInteger fileIdx=0; fileIdx < 8; fileIdx++)
+	{
+		NSURL *fileURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSString stringWithFormat:@"checksum-%@.bin", NSUUID.UUID.UUIDString]];
+		NSMutableData *fileData = [NSMutableData dataWithLength:(fileIdx * 517 * 1024) + fileIdx];
+		uint8_t *bytes = fileData.mutableBytes;
+
+		for (NSUInteger i=0; i<fileData.length; i++)
+		{
+			bytes[i] = (uint8_t)((i * 13 + fileIdx) % 253);
+		}
+
+		XCTAssert([fileData writeToURL:fileURL atomically:NO]);
+
+		[fileURLs addObject:fileURL];
+		dataByURL[fileURL] = fileData;
+	}
+
+	// Compute checksums for all files concurrently and compare them with checksums computed from the data
+	for (NSURL *fileURL in fileURLs)
+	{
+		XCTestExpectation *expectComputation = [self expectationWithDescription:@"Checksums computed"];
+
+		[engine computeChecksumsWithAlgorithms:algorithms forFileAtURL:fileURL completionHandler:^(NSError * _Nullable error, NSDictionary<OCChecksumAlgorithmIdentifier,OCChecksum *> * _Nullable checksums) {
+			XCTAssert(error == nil);
+			XCTAssert(checksums.count == algorithms.count);
+
+			for (OCChecksumAlgorithm *algorithm in algorithms)
+			{
+				OCChecksum *expectedChecksum = [algorithm computeChecksumForData:dataByURL[fileURL] error:NULL];
+
+				XCTAssert([checksums[algorithm.class.identifier] isEqual:expectedChecksum], @"%@ checksum mismatch for %@: %@ vs %@", algorithm.class.identifier, fileURL.lastPathComponent, checksums[algorithm.class.identifier], expectedChecksum);
+			}
+
+			[expectComputation fulfill];
+		}];
+	}
+
+	// Missing file
+	XCTestExpectation *expectError = [self expectationWithDescription:@"Error for missing file"];
+
+	[engine computeChecksumsWithAlgorithms:algorithms forFileAtURL:[fileURLs.firstObject URLByAppendingPathExtension:@"missing"] completionHandler:^(NSError * _Nullable error, NSDictionary<OCChecksumAlgorithmIdentifier,OCChecksum *> * _Nullable checksums) {
+		XCTAssert(error != nil);
+		XCTAssert(checksums == nil);
+
+		[expectError fulfill];
+	}];
+
+	[self waitForExpectationsWithTimeout:30 handler:nil];
+
+	for (NSURL *fileURL in fileURLs)
+	{
+		[NSFileManager.defaultManager removeItemAtURL:fileURL error:NULL];
+	}
+}
+
 @end
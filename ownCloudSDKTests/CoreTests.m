@@ -10,6 +10,7 @@
 #import <ownCloudSDK/ownCloudSDK.h>
 #import <ownCloudMocking/ownCloudMocking.h>
 #import "OCCore+Internal.h"
+#import "OCQuery+Internal.h"
 #import "TestTools.h"
 #import "XCTestCase+Tagging.h"
 
@@ -1504,6 +1505,112 @@
 	}];
 }
 
+- (void)testUpdateScanRequestsPerChange
+{
+	OCBookmark *bookmark = [OCTestTarget userBookmark];
+	OCCore *core;
+	OCHostSimulator *hostSimulator = [[OCHostSimulator alloc] init];
+	__block NSUInteger propFindCount = 0;
+	__block NSUInteger initialScanPropFinds = 0, unchangedScanPropFinds = 0, changeScanPropFinds = 0;
+	NSString *folderName = [NSString stringWithFormat:@"ScanBenchmark-%@", NSDate.date];
+	XCTestExpectation *coreStartedExpectation = [self expectationWithDescription:@"Core started"];
+	XCTestExpectation *coreStoppedExpectation = [self expectationWithDescription:@"Core stopped"];
+	XCTestExpectation *benchmarkCompleteExpectation = [self expectationWithDescription:@"Benchmark complete"];
+
+	// Count PROPFIND requests, but pass all requests through to the server
+	hostSimulator.unroutableRequestHandler = nil;
+	hostSimulator.requestHandler = ^BOOL(OCConnection *connection, OCHTTPRequest *request, OCHostSimulatorResponseHandler responseHandler) {
+		if ([request.method isEqual:OCHTTPMethodPROPFIND])
+		{
+			@synchronized(self)
+			{
+				propFindCount++;
+			}
+		}
+
+		return (NO);
+	};
+
+	NSUInteger(^TakePropFindCount)(void) = ^{
+		@synchronized(self)
+		{
+			NSUInteger count = propFindCount;
+			propFindCount = 0;
+			return (count);
+		}
+	};
+
+	// Create core
+	core = [[OCCore alloc] initWithBookmark:bookmark];
+	core.automaticItemListUpdatesEnabled = NO;
+	core.connection.hostSimulator = hostSimulator;
+
+	// Start core
+	[core startWithCompletionHandler:^(OCCore *core, NSError *error) {
+		XCTAssert(error==nil);
+		[coreStartedExpectation fulfill];
+
+		TakePropFindCount();
+
+		// Initial scan of the entire tree
+		[core fetchUpdatesWithCompletionHandler:^(NSError * _Nullable error, BOOL didFindChanges) {
+			XCTAssert(error==nil);
+			initialScanPropFinds = TakePropFindCount();
+
+			// Scan without changes
+			[core fetchUpdatesWithCompletionHandler:^(NSError * _Nullable error, BOOL didFindChanges) {
+				XCTAssert(error==nil);
+				XCTAssert(!didFindChanges);
+				unchangedScanPropFinds = TakePropFindCount();
+
+				// Change the tree on the server, bypassing the core
+				OCItem *rootItem = [core cachedItemAtLocation:OCLocation.legacyRootLocation error:NULL];
+
+				XCTAssert(rootItem != nil);
+
+				[core.connection createFolder:folderName inside:rootItem options:nil resultTarget:[OCEventTarget eventTargetWithEphermalEventHandlerBlock:^(OCEvent *event, id sender) {
+					OCItem *newFolderItem = OCTypedCast(event.result, OCItem);
+
+					XCTAssert(event.error == nil);
+					XCTAssert(newFolderItem != nil);
+
+					TakePropFindCount();
+
+					// Scan for the change
+					[core fetchUpdatesWithCompletionHandler:^(NSError * _Nullable error, BOOL didFindChanges) {
+						XCTAssert(error==nil);
+						XCTAssert(didFindChanges);
+						changeScanPropFinds = TakePropFindCount();
+
+						OCLog(@"Update scan PROPFIND requests: initial scan: %lu, unchanged: %lu, per change: %lu", (unsigned long)initialScanPropFinds, (unsigned long)unchangedScanPropFinds, (unsigned long)changeScanPropFinds);
+
+						// Only the root folder check, the changed root folder and the new folder need to be retrieved - unchanged sub folders must not be
+						XCTAssert(changeScanPropFinds <= 3);
+
+						// Clean up
+						[core.connection deleteItem:newFolderItem requireMatch:NO resultTarget:[OCEventTarget eventTargetWithEphermalEventHandlerBlock:^(OCEvent *event, id sender) {
+							XCTAssert(event.error == nil);
+
+							[core stopWithCompletionHandler:^(id sender, NSError *error) {
+								[coreStoppedExpectation fulfill];
+							}];
+
+							[benchmarkCompleteExpectation fulfill];
+						} userInfo:nil ephermalUserInfo:nil]];
+					}];
+				} userInfo:nil ephermalUserInfo:nil]];
+			}];
+		}];
+	}];
+
+	[self waitForExpectationsWithTimeout:120 handler:nil];
+
+	// Erase vault
+	[core.vault eraseSyncWithCompletionHandler:^(id sender, NSError *error) {
+		XCTAssert((error==nil), @"Erased with error: %@", error);
+	}];
+}
+
 - (void)testDuplicateNameSuggestions
 {
 	OCBookmark *bookmark = [OCTestTarget userBookmark];
@@ -1784,4 +1891,82 @@
 	[OCBookmarkManager.sharedBookmarkManager removeBookmark:bookmark];
 }
 
+- (void)testSyncAnchorQueryMerge
+{
+	OCQuery *query = [OCQuery queryForChangesSinceSyncAnchor:@(0)];
+	OCItem *(^MakeItem)(OCPath path, OCFileID fileID) = ^(OCPath path, OCFileID fileID) {
+		OCItem *item = [OCItem new];
+		item.path = path;
+		item.fileID = fileID;
+		return (item);
+	};
+
+	// Initial items are appended
+	OCItem *itemA = MakeItem(@"/a/", @"fa"), *itemB = MakeItem(@"/b/", @"fb"), *itemC = MakeItem(@"/c/", @"fc");
+
+	[query mergeItemsToFullQueryResults:@[ itemA, itemB, itemC ] syncAnchor:@(1)];
+
+	XCTAssert([query.fullQueryResults isEqual:(@[ itemA, itemB, itemC ])]);
+
+	// Same path => replace in place, same fileID at new path => replace in place, new item => append
+	OCItem *itemA2 = MakeItem(@"/a/", @"fa"), *itemB2 = MakeItem(@"/b-moved/", @"fb"), *itemD = MakeItem(@"/d/", @"fd");
+
+	[query mergeItemsToFullQueryResults:@[ itemA2, itemB2, itemD ] syncAnchor:@(2)];
+
+	XCTAssert([query.fullQueryResults isEqual:(@[ itemA2, itemB2, itemC, itemD ])]);
+
+	// Item moved by fileID onto the path of another item => the other item is removed
+	OCItem *itemD2 = MakeItem(@"/c/", @"fd");
+
+	[query mergeItemsToFullQueryResults:@[ itemD2 ] syncAnchor:@(3)];
+
+	XCTAssert([query.fullQueryResults isEqual:(@[ itemA2, itemB2, itemD2 ])]);
+
+	// Index is rebuilt after compaction
+	OCItem *itemB3 = MakeItem(@"/b-moved/", @"fb");
+
+	[query mergeItemsToFullQueryResults:@[ itemB3 ] syncAnchor:@(4)];
+
+	XCTAssert([query.fullQueryResults isEqual:(@[ itemA2, itemB3, itemD2 ])]);
+}
+
+- (void)testSyncAnchorQueryMergeOfMoveAcrossFolders
+{
+	OCQuery *query = [OCQuery queryForChangesSinceSyncAnchor:@(0)];
+	OCItem *(^MakeItem)(OCPath path, OCFileID fileID, BOOL removed) = ^(OCPath path, OCFileID fileID, BOOL removed) {
+		OCItem *item = [OCItem new];
+		item.path = path;
+		item.fileID = fileID;
+		item.removed = removed;
+		return (item);
+	};
+
+	OCItem *item = MakeItem(@"/folder-a/file.txt", @"f1", NO);
+
+	[query mergeItemsToFullQueryResults:@[ item ] syncAnchor:@(1)];
+
+	// Move across folders, as merged by OCCore+ItemUpdates: removal at the previous path first, then the item at its new path
+	OCItem *removedItem = MakeItem(@"/folder-a/file.txt", @"f1", YES);
+	OCItem *movedItem = MakeItem(@"/folder-b/file.txt", @"f1", NO);
+
+	[query mergeItemsToFullQueryResults:@[ removedItem, movedItem ] syncAnchor:@(2)];
+
+	XCTAssert([query.fullQueryResults isEqual:(@[ removedItem, movedItem ])]);
+
+	// Same in a new change set (with no previous entry for the item)
+	[query requestChangeSetWithFlags:OCQueryChangeSetRequestFlagDefault completionHandler:nil];
+
+	[query mergeItemsToFullQueryResults:@[ removedItem, movedItem ] syncAnchor:@(3)];
+
+	XCTAssert([query.fullQueryResults isEqual:(@[ removedItem, movedItem ])]);
+
+	// Move back: removal at folder-b replaces the item there, the item at folder-a replaces the removal there
+	OCItem *removedItem2 = MakeItem(@"/folder-b/file.txt", @"f1", YES);
+	OCItem *movedItem2 = MakeItem(@"/folder-a/file.txt", @"f1", NO);
+
+	[query mergeItemsToFullQueryResults:@[ removedItem2, movedItem2 ] syncAnchor:@(4)];
+
+	XCTAssert([query.fullQueryResults isEqual:(@[ movedItem2, removedItem2 ])]);
+}
+
 @end
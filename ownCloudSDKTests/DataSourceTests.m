@@ -266,6 +266,131 @@ OCDataItemType DataTypeE = @"E";
 	XCTAssert( ([snapshot.removedItems isEqual:[NSSet set]]) );
 }
 
+- (void)testDataSourceDiff
+{
+	OCDataSourceDiff *diff;
+
+	// No changes
+	diff = [OCDataSourceDiff diffFromItems:@[@"a", @"b", @"c"] toItems:@[@"a", @"b", @"c"]];
+	XCTAssertFalse(diff.hasChanges);
+
+	// Insertions and removals only
+	diff = [OCDataSourceDiff diffFromItems:@[@"a", @"b", @"c", @"d"] toItems:@[@"x", @"a", @"c", @"d", @"y"]];
+	XCTAssertEqualObjects(diff.removedIndexes, [NSIndexSet indexSetWithIndex:1]);
+	XCTAssertEqualObjects(diff.removedItems, (@[@"b"]));
+	XCTAssert([diff.insertedIndexes containsIndex:0] && [diff.insertedIndexes containsIndex:4] && (diff.insertedIndexes.count == 2));
+	XCTAssertEqualObjects(diff.insertedItems, (@[@"x", @"y"]));
+	XCTAssertEqual(diff.moves.count, 0); // Items shifted by insertions and removals are not moved
+
+	// Single move
+	diff = [OCDataSourceDiff diffFromItems:@[@"a", @"b", @"c", @"d", @"e"] toItems:@[@"a", @"c", @"d", @"e", @"b"]];
+	XCTAssertEqual(diff.removedIndexes.count, 0);
+	XCTAssertEqual(diff.insertedIndexes.count, 0);
+	XCTAssertEqual(diff.moves.count, 1);
+	XCTAssertEqualObjects(diff.moves.firstObject.itemRef, @"b");
+	XCTAssertEqual(diff.moves.firstObject.fromIndex, 1);
+	XCTAssertEqual(diff.moves.firstObject.toIndex, 4);
+	XCTAssertTrue(diff.hasChanges);
+
+	// Reversal: minimal number of moves
+	diff = [OCDataSourceDiff diffFromItems:@[@"a", @"b", @"c", @"d"] toItems:@[@"d", @"c", @"b", @"a"]];
+	XCTAssertEqual(diff.moves.count, 3);
+
+	// Move, insertion and removal combined
+	diff = [OCDataSourceDiff diffFromItems:@[@"a", @"b", @"c", @"d"] toItems:@[@"d", @"a", @"x", @"b"]];
+	XCTAssertEqualObjects(diff.removedItems, (@[@"c"]));
+	XCTAssertEqualObjects(diff.insertedItems, (@[@"x"]));
+	XCTAssertEqual(diff.moves.count, 1);
+	XCTAssertEqualObjects(diff.moves.firstObject.itemRef, @"d");
+	XCTAssertEqual(diff.moves.firstObject.fromIndex, 3);
+	XCTAssertEqual(diff.moves.firstObject.toIndex, 0);
+
+	// From and to empty
+	diff = [OCDataSourceDiff diffFromItems:nil toItems:@[@"a", @"b"]];
+	XCTAssertEqualObjects(diff.insertedItems, (@[@"a", @"b"]));
+	diff = [OCDataSourceDiff diffFromItems:@[@"a", @"b"] toItems:@[]];
+	XCTAssertEqualObjects(diff.removedItems, (@[@"a", @"b"]));
+
+	// Snapshots
+	OCDataSource *source = [OCDataSource new];
+	OCDataSourceSnapshot *snapshot;
+
+	[source setItemReferences:@[@"a", @"b", @"c"] updated:nil];
+
+	OCDataSourceSubscription *subscription = [source subscribeWithUpdateHandler:^(OCDataSourceSubscription * _Nonnull subscription) {
+	} onQueue:nil trackDifferences:YES performInitialUpdate:NO];
+
+	[source setItemReferences:@[@"c", @"a", @"d"] updated:nil];
+	[source setItemReferences:@[@"c", @"a", @"d", @"e"] updated:nil];
+
+	snapshot = [subscription snapshotResettingChangeTracking:YES];
+	XCTAssertEqualObjects(snapshot.previousItems, (@[@"a", @"b", @"c"]));
+	XCTAssertEqualObjects(snapshot.addedItems, ([NSSet setWithObjects:@"d", @"e", nil]));
+	XCTAssertEqualObjects(snapshot.removedItems, ([NSSet setWithObject:@"b"]));
+	XCTAssertEqualObjects(snapshot.diff.removedIndexes, [NSIndexSet indexSetWithIndex:1]);
+	XCTAssertEqualObjects(snapshot.diff.insertedItems, (@[@"d", @"e"]));
+	XCTAssertEqual(snapshot.diff.moves.count, 1);
+	XCTAssertEqualObjects(snapshot.diff.moves.firstObject.itemRef, @"c");
+
+	snapshot = [subscription snapshotResettingChangeTracking:YES];
+	XCTAssertFalse(snapshot.diff.hasChanges);
+
+	[subscription terminate];
+}
+
+- (void)testDataSourceCompositionIncrementalSort
+{
+	OCDataSource *source = [OCDataSource new];
+	NSMutableArray<OCDataItemReference> *itemRefs = [NSMutableArray new];
+	__block NSArray<OCDataItemReference> *expectedItemRefs = nil;
+	__block XCTestExpectation *expectComposition = nil;
+
+	for (NSUInteger idx=20; idx > 0; idx--)
+	{
+		[itemRefs addObject:[NSString stringWithFormat:@"item%02lu", (unsigned long)idx]];
+	}
+
+	[source setItemReferences:itemRefs updated:nil];
+
+	OCDataSourceComposition *composition = [[OCDataSourceComposition alloc] initWithSources:@[ source ] applyCustomizations:^(OCDataSourceComposition *composition) {
+		composition.sortComparator = ^NSComparisonResult(OCDataSource *source1, OCDataItemReference itemRef1, OCDataSource *source2, OCDataItemReference itemRef2) {
+			return ([(NSString *)itemRef1 compare:(NSString *)itemRef2]);
+		};
+	}];
+
+	OCDataSourceSubscription *subscription = [composition subscribeWithUpdateHandler:^(OCDataSourceSubscription * _Nonnull subscription) {
+		@synchronized(self)
+		{
+			if ((expectComposition != nil) && [[subscription snapshotResettingChangeTracking:YES].items isEqual:expectedItemRefs])
+			{
+				[expectComposition fulfill];
+				expectComposition = nil;
+			}
+		}
+	} onQueue:dispatch_get_main_queue() trackDifferences:YES performInitialUpdate:YES];
+
+	// Full composition
+	@synchronized(self)
+	{
+		expectedItemRefs = [itemRefs sortedArrayUsingSelector:@selector(compare:)];
+		expectComposition = [self expectationWithDescription:@"Full composition"];
+	}
+	[self waitForExpectationsWithTimeout:5 handler:nil];
+
+	// Incremental composition: insert and update the same item in one snapshot, which must only be inserted once
+	[itemRefs addObject:@"item05a"];
+
+	@synchronized(self)
+	{
+		expectedItemRefs = [itemRefs sortedArrayUsingSelector:@selector(compare:)];
+		expectComposition = [self expectationWithDescription:@"Incremental composition"];
+	}
+	[source setItemReferences:itemRefs updated:[NSSet setWithObject:@"item05a"]];
+	[self waitForExpectationsWithTimeout:5 handler:nil];
+
+	[subscription terminate];
+}
+
 - (void)testDataConverterAssembly
 {
 	OCDataRenderer *renderer = [[OCDataRenderer alloc] initWithConverters:@[
@@ -1154,6 +1154,149 @@ typedef void(^PartitionSimulatorHandleResult)(OCHTTPRequest *request, OCHTTPResp
 	_forceDownloads = NO;
 }
 
+- (void)testAdaptiveConcurrencyController
+{
+	OCHTTPConcurrencyController *controller = [[OCHTTPConcurrencyController alloc] initWithInitialLimit:8 minimumLimit:1 maximumLimit:32];
+	NSMutableArray<NSNumber *> *changedLimits = [NSMutableArray new];
+
+	controller.limitChangeHandler = ^(OCHTTPPipelinePartitionID partitionID, NSString *hostname, double limit) {
+		XCTAssertEqualObjects(partitionID, @"partition-1");
+		XCTAssertEqualObjects(hostname, @"demo.owncloud.org");
+
+		[changedLimits addObject:@((NSUInteger)limit)];
+	};
+
+	// Initial limit
+	XCTAssertEqual([controller limitForPartitionID:@"partition-1" hostname:@"demo.owncloud.org"], 8);
+
+	// Rate limiting halves the limit - once per cool-down period
+	[controller recordResponseWithStatusCode:OCHTTPStatusCodeTOO_MANY_REQUESTS latency:nil receiveBytesPerSecond:nil runningRequests:8 forPartitionID:@"partition-1" hostname:@"demo.owncloud.org"];
+	[controller recordResponseWithStatusCode:OCHTTPStatusCodeSERVICE_UNAVAILABLE latency:nil receiveBytesPerSecond:nil runningRequests:7 forPartitionID:@"partition-1" hostname:@"Demo.ownCloud.org"];
+
+	XCTAssertEqual([controller limitForPartitionID:@"partition-1" hostname:@"demo.owncloud.org"], 4);
+	XCTAssertEqual([controller limitForPartitionID:@"partition-2" hostname:@"demo.owncloud.org"], 8);
+
+	// Successful responses while the limit is in use increase it by one per round of requests
+	for (NSUInteger i=0; i<4; i++)
+	{
+		[controller recordResponseWithStatusCode:OCHTTPStatusCodeOK latency:@(0.1) receiveBytesPerSecond:nil runningRequests:4 forPartitionID:@"partition-1" hostname:@"demo.owncloud.org"];
+	}
+
+	XCTAssertEqual([controller limitForPartitionID:@"partition-1" hostname:@"demo.owncloud.org"], 5);
+
+	// .. but not while it isn't in use
+	[controller recordResponseWithStatusCode:OCHTTPStatusCodeOK latency:@(0.1) receiveBytesPerSecond:nil runningRequests:1 forPartitionID:@"partition-1" hostname:@"demo.owncloud.org"];
+
+	XCTAssertEqual([controller limitForPartitionID:@"partition-1" hostname:@"demo.owncloud.org"], 5);
+
+	XCTAssertEqualObjects(changedLimits, (@[ @(4), @(5) ]));
+
+	// Restored limits are clamped, removed limits fall back to the initial limit
+	[controller restoreLimit:100 forPartitionID:@"partition-1" hostname:@"demo.owncloud.org"];
+	XCTAssertEqual([controller limitForPartitionID:@"partition-1" hostname:@"demo.owncloud.org"], 32);
+
+	[controller removeLimitsForPartitionID:@"partition-1"];
+	XCTAssertEqual([controller limitForPartitionID:@"partition-1" hostname:@"demo.owncloud.org"], 8);
+}
+
+- (void)testSchedulingStressWithManyQueuedRequests
+{
+	XCTestExpectation *pipelineStartedExpectation = [self expectationWithDescription:@"pipeline started"];
+	XCTestExpectation *pipelineStoppedExpectation = [self expectationWithDescription:@"pipeline stopped"];
+	XCTestExpectation *attachCompletedExpectation = [self expectationWithDescription:@"attach completed"];
+	XCTestExpectation *requestsCompletedExpectation = [self expectationWithDescription:@"requests completed"];
+
+	const NSUInteger totalRequests = 10000;
+	__block NSUInteger requestCount = totalRequests;
+	__block NSUInteger runningRequests = 0;
+	__block NSTimeInterval startTime = 0;
+
+	NSURL *temporaryBackendDBURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString];
+	OCHTTPPipeline *pipeline = [[OCHTTPPipeline alloc] initWithIdentifier:@"testPipeline" backend:[[OCHTTPPipelineBackend alloc] initWithSQLDB:[[OCSQLiteDB alloc] initWithURL:temporaryBackendDBURL] temporaryFilesRoot:nil] configuration:[NSURLSessionConfiguration backgroundSessionConfigurationWithIdentifier:@"bgQueue"]];
+	pipeline.maximumConcurrentRequests = 10;
+
+	PartitionSimulator *partitionHandler = [PartitionSimulator new];
+	partitionHandler.partitionID = @"partition-1";
+	partitionHandler.prepareRequestForScheduling = ^OCHTTPRequest *(OCHTTPPipeline *pipeline, OCHTTPRequest *request) {
+		@synchronized (self)
+		{
+			runningRequests++;
+			XCTAssert(runningRequests <= (pipeline.maximumConcurrentRequests+1));
+		}
+
+		return (request);
+	};
+	partitionHandler.simulateRequestHandling = ^BOOL(OCHTTPPipeline *pipeline, OCHTTPPipelinePartitionID partitionID, OCHTTPRequest *request, void (^completionHandler)(OCHTTPResponse *response)) {
+		// Respond without network access, so that the scheduler's overhead dominates
+		dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+			completionHandler([OCHTTPResponse responseWithRequest:request HTTPError:nil]);
+		});
+
+		return (NO);
+	};
+
+	[pipeline startWithCompletionHandler:^(id sender, NSError *error) {
+		XCTAssert(error==nil);
+
+		[pipelineStartedExpectation fulfill];
+
+		[pipeline attachPartitionHandler:partitionHandler completionHandler:^(id sender, NSError *error) {
+			NSMutableArray<OCHTTPRequest *> *scheduleRequests = [NSMutableArray new];
+
+			[attachCompletedExpectation fulfill];
+
+			for (NSUInteger i=0; i<totalRequests; i++)
+			{
+				OCHTTPRequest *request;
+
+				request = [OCHTTPRequest requestWithURL:[NSURL URLWithString:[NSString stringWithFormat:@"https://demo.owncloud.org/status.php?request=%lu", (unsigned long)i]]];
+
+				if ((i % 10) == 0)
+				{
+					// Mix in grouped requests
+					request.groupID = [NSString stringWithFormat:@"group-%lu", (unsigned long)(i % 50)];
+				}
+
+				request.ephermalResultHandler = ^(OCHTTPRequest *request, OCHTTPResponse *response, NSError *error) {
+					@synchronized (self)
+					{
+						runningRequests--;
+						requestCount--;
+
+						if (requestCount == 0)
+						{
+							NSTimeInterval duration = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+							OCLog(@"Completed %lu requests in %.2fs (%.0f requests/s)", (unsigned long)totalRequests, duration, ((double)totalRequests) / duration);
+
+							[requestsCompletedExpectation fulfill];
+
+							[pipeline detachPartitionHandler:partitionHandler completionHandler:^(id sender, NSError *error) {
+								[pipeline stopWithCompletionHandler:^(id sender, NSError *error) {
+									[pipelineStoppedExpectation fulfill];
+								} graceful:YES];
+							}];
+						}
+					}
+				};
+
+				[scheduleRequests addObject:request];
+			}
+
+			startTime = NSDate.timeIntervalSinceReferenceDate;
+
+			for (OCHTTPRequest *request in scheduleRequests)
+			{
+				[pipeline enqueueRequest:request forPartitionID:partitionHandler.partitionID isFinal:NO];
+			}
+		}];
+	}];
+
+	[self waitForExpectationsWithTimeout:600 handler:nil];
+
+	[NSFileManager.defaultManager removeItemAtURL:temporaryBackendDBURL error:NULL];
+}
+
 - (void)testRedirection
 {
 	XCTestExpectation *pipelineStartedExpectation = [self expectationWithDescription:@"pipeline started"];
@@ -2627,6 +2770,57 @@ typedef void(^PartitionSimulatorHandleResult)(OCHTTPRequest *request, OCHTTPResp
 	}
 }
 
+- (void)testRangedFileStream
+{
+	NSURL *fileURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSString stringWithFormat:@"ranged-%@.bin", NSUUID.UUID.UUIDString]];
+	NSMutableData *fileData = [NSMutableData dataWithLength:1024 * 1024];
+	NSRange range = NSMakeRange(100001, 700000);
+	NSError *error = nil;
+
+	// Fill file with a pattern
+	uint8_t *bytes = fileData.mutableBytes;
+	for (NSUInteger i=0; i<fileData.length; i++)
+	{
+		bytes[i] = (uint8_t)((i * 7) % 251);
+	}
+
+	XCTAssert([fileData writeToURL:fileURL atomically:NO]);
+
+	// Read range with and without read-ahead
+	for (NSNumber *readAheadSize in @[ @(0), @(OCHTTPRangedFileStream.defaultReadAheadSize) ])
+	{
+		OCHTTPRangedFileStream *rangedStream;
+		NSInputStream *inputStream;
+		NSMutableData *readData = [NSMutableData new];
+		uint8_t buffer[32 * 1024];
+		NSInteger bytesRead;
+
+		rangedStream = [OCHTTPRangedFileStream streamForFileURL:fileURL range:range readAheadSize:readAheadSize.unsignedIntegerValue error:&error];
+		inputStream = rangedStream.inputStream;
+
+		XCTAssert(inputStream != nil);
+		XCTAssert(error == nil);
+
+		[inputStream open];
+
+		while ((bytesRead = [inputStream read:buffer maxLength:sizeof(buffer)]) > 0)
+		{
+			[readData appendBytes:buffer length:bytesRead];
+		}
+
+		[inputStream close];
+		[rangedStream close];
+
+		XCTAssert([readData isEqualToData:[fileData subdataWithRange:range]], @"Read data (%lu bytes) doesn't match range %@ (readAheadSize=%@)", readData.length, NSStringFromRange(range), readAheadSize);
+	}
+
+	// Range exceeding the file size
+	XCTAssert([OCHTTPRangedFileStream streamForFileURL:fileURL range:NSMakeRange(fileData.length - 10, 11) readAheadSize:0 error:&error] == nil);
+	XCTAssert(error != nil);
+
+	[NSFileManager.defaultManager removeItemAtURL:fileURL error:NULL];
+}
+
 /*
 	Test scenarios currently not covered:
 	- test certificate issue handling (including a non-response to the certificate callback and restart (test for handling of app crashes/terminations))
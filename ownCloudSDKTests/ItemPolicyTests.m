@@ -14,6 +14,40 @@
 
 @end
 
+@interface WatermarkTestPolicyProcessor : OCItemPolicyProcessor
+@property(strong) NSMutableSet<OCLocalID> *processedLocalIDs;
+@end
+
+@implementation WatermarkTestPolicyProcessor
+
+- (instancetype)initWithKind:(OCItemPolicyKind)kind core:(OCCore *)core
+{
+	if ((self = [super initWithKind:kind core:core]) != nil)
+	{
+		self.evaluatesIncrementally = YES;
+		self.matchCondition = [OCQueryCondition where:OCItemPropertyNameRemoved isEqualTo:@(NO)];
+		self.processedLocalIDs = [NSMutableSet new];
+	}
+
+	return (self);
+}
+
+- (OCItemPolicyProcessorTrigger)triggerMask
+{
+	// Only triggered by the SDK for processors with a .syncReason, so runs are controlled by the test
+	return (OCItemPolicyProcessorTriggerSyncReason);
+}
+
+- (void)performActionOn:(OCItem *)matchingItem withTrigger:(OCItemPolicyProcessorTrigger)trigger
+{
+	@synchronized(self)
+	{
+		[self.processedLocalIDs addObject:matchingItem.localID];
+	}
+}
+
+@end
+
 @implementation ItemPolicyTests
 
 - (void)_runTestWithBookmark:(OCBookmark *)bookmark implementation:(void(^)(OCCore *core, OCQuery *query, void(^endTest)(BOOL doEraseVault)))implementation
@@ -406,6 +440,115 @@
 	[OCItemPolicyProcessor setUserPreferenceValue:nil forClassSettingsKey:OCClassSettingsKeyItemPolicyVacuumSyncAnchorTTL];
 }
 
+- (void)testIncrementalEvaluation
+{
+	/*
+		- runs an incrementally evaluating processor for the first time and verifies it sees all items (no watermark)
+		- updates one item with a new sync anchor
+		- verifies incremental runs only see items changed with or after the watermark
+		- verifies -resetPolicyProcessorWatermarks and -runPolicyProcessorsForTrigger:fullEvaluation: force full evaluations
+	*/
+	OCBookmark *bookmark = OCTestTarget.demoBookmark;
+	__block BOOL didStart = NO;
+
+	[self _runTestWithBookmark:bookmark implementation:^(OCCore *core, OCQuery *query, void (^endTest)(BOOL doEraseVault)) {
+		[query requestChangeSetWithFlags:OCQueryChangeSetRequestFlagOnlyResults completionHandler:^(OCQuery * _Nonnull query, OCQueryChangeSet * _Nullable changeset) {
+			if ((query.state != OCQueryStateIdle) || (changeset.queryResult.count < 2) || didStart)
+			{
+				return;
+			}
+
+			didStart = YES;
+
+			OCItem *updateItem = changeset.queryResult.firstObject;
+
+			dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+				WatermarkTestPolicyProcessor *processor = [[WatermarkTestPolicyProcessor alloc] initWithKind:@"watermarkTest" core:core];
+				NSSet<OCLocalID> *(^RunProcessor)(BOOL fullEvaluation) = ^(BOOL fullEvaluation) {
+					dispatch_semaphore_t waitSemaphore = dispatch_semaphore_create(0);
+					NSSet<OCLocalID> *processedLocalIDs;
+
+					@synchronized(processor)
+					{
+						[processor.processedLocalIDs removeAllObjects];
+					}
+
+					// Run inside the database context, so the processor's scans are performed synchronously
+					[core.vault.database.sqlDB executeOperation:^NSError * _Nullable(OCSQLiteDB * _Nonnull db) {
+						[core runPolicyProcessorsForTrigger:OCItemPolicyProcessorTriggerSyncReason fullEvaluation:fullEvaluation];
+						return (nil);
+					} completionHandler:^(OCSQLiteDB * _Nonnull db, NSError * _Nullable error) {
+						dispatch_semaphore_signal(waitSemaphore);
+					}];
+
+					dispatch_semaphore_wait(waitSemaphore, DISPATCH_TIME_FOREVER);
+
+					@synchronized(processor)
+					{
+						processedLocalIDs = [processor.processedLocalIDs copy];
+					}
+
+					return (processedLocalIDs);
+				};
+				NSSet<OCLocalID> *allLocalIDs, *processedLocalIDs;
+
+				[core resetPolicyProcessorWatermarks];
+				[core addItemPolicyProcessor:processor];
+
+				// First run: no watermark => full evaluation
+				allLocalIDs = RunProcessor(NO);
+				XCTAssert([allLocalIDs containsObject:updateItem.localID]);
+				XCTAssert(allLocalIDs.count >= 2);
+
+				// Update one item with a new sync anchor
+				dispatch_semaphore_t updateSemaphore = dispatch_semaphore_create(0);
+
+				[core.vault.database increaseValueForCounter:OCCoreSyncAnchorCounter withProtectedBlock:^NSError *(NSNumber *previousCounterValue, NSNumber *newCounterValue) {
+					__block NSError *updateError = nil;
+
+					[core.vault.database updateCacheItems:@[ updateItem ] syncAnchor:newCounterValue completionHandler:^(OCDatabase *db, NSError *error) {
+						updateError = error;
+					}];
+
+					return (updateError);
+				} completionHandler:^(NSError *error, NSNumber *previousCounterValue, NSNumber *newCounterValue) {
+					XCTAssert(error == nil);
+					dispatch_semaphore_signal(updateSemaphore);
+				}];
+
+				dispatch_semaphore_wait(updateSemaphore, DISPATCH_TIME_FOREVER);
+
+				// Second run: watermark from the first run => items changed with or after its sync anchor
+				processedLocalIDs = RunProcessor(NO);
+				XCTAssert([processedLocalIDs containsObject:updateItem.localID]);
+
+				// Third run: watermark from the second run => only the updated item
+				processedLocalIDs = RunProcessor(NO);
+				XCTAssert([processedLocalIDs containsObject:updateItem.localID]);
+				XCTAssert(processedLocalIDs.count < allLocalIDs.count, @"Incremental run processed %lu of %lu items", (unsigned long)processedLocalIDs.count, (unsigned long)allLocalIDs.count);
+
+				// Reset of watermarks => full evaluation
+				[core resetPolicyProcessorWatermarks];
+				processedLocalIDs = RunProcessor(NO);
+				XCTAssertEqualObjects(processedLocalIDs, allLocalIDs);
+
+				// Incremental again after the full evaluation
+				processedLocalIDs = RunProcessor(NO);
+				XCTAssert(processedLocalIDs.count < allLocalIDs.count);
+
+				// Explicitly requested full evaluation, despite watermark
+				processedLocalIDs = RunProcessor(YES);
+				XCTAssertEqualObjects(processedLocalIDs, allLocalIDs);
+
+				[core removeItemPolicyProcessor:processor];
+				[core resetPolicyProcessorWatermarks];
+
+				endTest(YES);
+			});
+		}];
+	}];
+}
+
 #pragma mark - Claims
 - (void)testClaimForLifetimeOfCore
 {
@@ -412,4 +412,74 @@
 	}
 }
 
+- (void)testKeyValueStoreLogBackend
+{
+	@autoreleasepool {
+		__block XCTestExpectation *expectCollectionUpdate = [self expectationWithDescription:@"Expect collection update [2]"];
+		__block XCTestExpectation *expectFinalValueUpdate = [self expectationWithDescription:@"Expect final value [2]"];
+
+		// Store a value using the archive backend
+		OCKeyValueStore *archiveKeyValueStore = [[OCKeyValueStore alloc] initWithURL:keyValueStoreURL identifier:@"test.kvs5"];
+		[archiveKeyValueStore storeObject:@"archived" forKey:@"value"];
+		archiveKeyValueStore = nil;
+
+		// Convert to log backend
+		OCKeyValueStore *keyValueStore1 = [[OCKeyValueStore alloc] initWithURL:keyValueStoreURL identifier:@"test.kvs5" backend:OCKeyValueStoreBackendLog];
+		OCKeyValueStore *keyValueStore2 = [[OCKeyValueStore alloc] initWithURL:keyValueStoreURL identifier:@"test.kvs5"];
+
+		XCTAssert(keyValueStore1.backend == OCKeyValueStoreBackendLog);
+		XCTAssert(keyValueStore2.backend == OCKeyValueStoreBackendLog); // existing log is picked up regardless of requested backend
+		XCTAssertEqualObjects([keyValueStore1 readObjectForKey:@"value"], @"archived");
+		XCTAssertEqualObjects([keyValueStore2 readObjectForKey:@"value"], @"archived");
+
+		[keyValueStore2 addObserver:^(OCKeyValueStore *store, id  _Nullable owner, OCKeyValueStoreKey key, id  _Nullable newValue) {
+			OCLog(@"[2] New collection: %@", newValue);
+
+			if ([newValue isEqual:@[ @"b" ]] && (expectCollectionUpdate != nil))
+			{
+				[expectCollectionUpdate fulfill];
+				expectCollectionUpdate = nil;
+			}
+		} forKey:@"collection" withOwner:self initial:YES];
+
+		[keyValueStore2 addObserver:^(OCKeyValueStore *store, id  _Nullable owner, OCKeyValueStoreKey key, id  _Nullable newValue) {
+			if ([newValue isEqual:@"final"] && (expectFinalValueUpdate != nil))
+			{
+				[expectFinalValueUpdate fulfill];
+				expectFinalValueUpdate = nil;
+			}
+		} forKey:@"value" withOwner:self initial:YES];
+
+		// Collections
+		XCTAssert([keyValueStore1 addObject:@"a" toCollectionForKey:@"collection" withEntryID:@"1"]);
+		XCTAssert([keyValueStore1 addObject:@"b" toCollectionForKey:@"collection" withEntryID:@"2"]);
+		XCTAssertFalse([keyValueStore1 addObject:@"a" toCollectionForKey:@"collection" withEntryID:@"1"]); // duplicate
+		XCTAssertEqualObjects([keyValueStore1 readObjectForKey:@"collection"], (@[ @"a", @"b" ]));
+
+		XCTAssert([keyValueStore1 removeObjectWithEntryID:@"1" fromCollectionForKey:@"collection"]);
+		XCTAssertFalse([keyValueStore1 removeObjectWithEntryID:@"1" fromCollectionForKey:@"collection"]);
+		XCTAssertFalse([keyValueStore1 addObject:@"a" toCollectionForKey:@"collection" withEntryID:@"1"]); // recently removed
+		XCTAssertEqualObjects([keyValueStore1 readObjectForKey:@"collection"], (@[ @"b" ]));
+
+		// Write enough values to trigger compaction of the log
+		NSString *padding = [@"" stringByPaddingToLength:512 withString:@"x" startingAtIndex:0];
+
+		for (NSUInteger i=0; i<1000; i++)
+		{
+			[keyValueStore1 storeObject:[NSString stringWithFormat:@"%lu%@", i, padding] forKey:@"value"];
+		}
+
+		[keyValueStore1 storeObject:@"final" forKey:@"value"];
+
+		NSNumber *logSize = nil;
+		[keyValueStoreURL getResourceValue:&logSize forKey:NSURLFileSizeKey error:NULL];
+		XCTAssert(logSize.unsignedIntegerValue < (1000 * 512)); // log was compacted
+
+		[self waitForExpectationsWithTimeout:30.0 handler:nil];
+
+		XCTAssertEqualObjects([keyValueStore2 readObjectForKey:@"value"], @"final");
+		XCTAssertEqualObjects([keyValueStore2 readObjectForKey:@"collection"], (@[ @"b" ]));
+	}
+}
+
 @end
@@ -12,6 +12,7 @@
 @interface LockTests : XCTestCase
 {
 	NSURL *_keyValueStoreURL;
+	NSURL *_lockTableURL;
 }
 
 @end
@@ -19,6 +20,7 @@
 @interface OCLockManager (Private)
 - (void)_updateLocks;
 - (void)setNeedsLockUpdate;
+- (void)_recordLockTableUnavailable;
 @end
 
 @interface PausableLockManager : OCLockManager
@@ -43,6 +45,7 @@
 	NSError *error =nil;
 	[NSFileManager.defaultManager createDirectoryAtURL:temporaryDirectoryURL withIntermediateDirectories:YES attributes:nil error:&error];
 	_keyValueStoreURL = [temporaryDirectoryURL URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
+	_lockTableURL = [temporaryDirectoryURL URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
 
 	OCLogDebug(@"Using keyValueStoreURL=%@, error=%@", _keyValueStoreURL, error);
 }
@@ -53,6 +56,16 @@
 
 	[[NSFileManager defaultManager] removeItemAtURL:_keyValueStoreURL error:NULL];
 	_keyValueStoreURL = nil;
+
+	for (NSURL *fileURL in [NSFileManager.defaultManager contentsOfDirectoryAtURL:_lockTableURL.URLByDeletingLastPathComponent includingPropertiesForKeys:nil options:0 error:NULL])
+	{
+		// Lock table files carry a path extension for version and slot count
+		if ([fileURL.lastPathComponent hasPrefix:_lockTableURL.lastPathComponent])
+		{
+			[[NSFileManager defaultManager] removeItemAtURL:fileURL error:NULL];
+		}
+	}
+	_lockTableURL = nil;
 }
 
 - (void)testConcurrencyLock
@@ -173,4 +186,208 @@
 	NSLog(@"LockManager 1: %@, LockManager 2: %@", lockManager1, lockManager2);
 }
 
+- (void)testLockTable
+{
+	NSString *tableIdentifier = NSUUID.UUID.UUIDString;
+	OCLockTable *lockTable1 = [[OCLockTable alloc] initWithURL:_lockTableURL identifier:tableIdentifier];
+	OCLockTable *lockTable2 = [[OCLockTable alloc] initWithURL:_lockTableURL identifier:tableIdentifier];
+	OCLockTableToken token1, token2;
+	NSDate *holderExpirationDate = nil;
+
+	XCTAssertNotNil(lockTable1);
+	XCTAssertNotNil(lockTable2);
+	XCTAssert([lockTable1 providesLockForResource:@"resource-1"]);
+
+	// Exclusive
+	token1 = [lockTable1 acquireLockForResource:@"resource-1" expirationDate:[NSDate dateWithTimeIntervalSinceNow:10] holderExpirationDate:NULL];
+	XCTAssert(token1 != 0);
+
+	token2 = [lockTable2 acquireLockForResource:@"resource-1" expirationDate:[NSDate dateWithTimeIntervalSinceNow:10] holderExpirationDate:&holderExpirationDate];
+	XCTAssert(token2 == 0);
+	XCTAssert(holderExpirationDate.timeIntervalSinceNow > 9);
+
+	// Other resources are not affected
+	XCTAssert([lockTable2 acquireLockForResource:@"resource-2" expirationDate:[NSDate dateWithTimeIntervalSinceNow:10] holderExpirationDate:NULL] != 0);
+
+	// Release
+	XCTAssert([lockTable1 renewLockForResource:@"resource-1" token:token1 expirationDate:[NSDate dateWithTimeIntervalSinceNow:0.2]]);
+	XCTAssert([lockTable1 releaseLockForResource:@"resource-1" token:token1]);
+	XCTAssertFalse([lockTable1 releaseLockForResource:@"resource-1" token:token1]);
+
+	token2 = [lockTable2 acquireLockForResource:@"resource-1" expirationDate:[NSDate dateWithTimeIntervalSinceNow:0.2] holderExpirationDate:NULL];
+	XCTAssert(token2 != 0);
+
+	// Expiration
+	XCTAssert([lockTable1 acquireLockForResource:@"resource-1" expirationDate:[NSDate dateWithTimeIntervalSinceNow:10] holderExpirationDate:NULL] == 0);
+
+	[NSThread sleepForTimeInterval:0.3];
+
+	token1 = [lockTable1 acquireLockForResource:@"resource-1" expirationDate:[NSDate dateWithTimeIntervalSinceNow:10] holderExpirationDate:NULL];
+	XCTAssert(token1 != 0);
+
+	XCTAssertFalse([lockTable2 renewLockForResource:@"resource-1" token:token2 expirationDate:[NSDate dateWithTimeIntervalSinceNow:10]]);
+	XCTAssertFalse([lockTable2 releaseLockForResource:@"resource-1" token:token2]);
+}
+
+- (void)testLockTableConcurrencyLock
+{
+	__block XCTestExpectation *expectLock1 = [self expectationWithDescription:@"Lock 1 acquired"];
+	__block XCTestExpectation *expectLock1Release = [self expectationWithDescription:@"Lock 1 released"];
+	__block XCTestExpectation *expectLock2 = [self expectationWithDescription:@"Lock 2 acquired"];
+	__block NSTimeInterval releaseTime = 0;
+
+	NSString *tableIdentifier = NSUUID.UUID.UUIDString;
+	OCLockManager *lockManager1 = [[OCLockManager alloc] initWithLockTable:[[OCLockTable alloc] initWithURL:_lockTableURL identifier:tableIdentifier] keyValueStore:nil];
+	OCLockManager *lockManager2 = [[OCLockManager alloc] initWithLockTable:[[OCLockTable alloc] initWithURL:_lockTableURL identifier:tableIdentifier] keyValueStore:nil];
+
+	[lockManager1 requestLock:[[OCLockRequest alloc] initWithResourceIdentifier:@"resource-1" acquiredHandler:^(NSError * _Nullable error, OCLock * _Nullable lock) {
+		[expectLock1 fulfill];
+
+		dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(1.0 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+			expectLock1 = nil;
+
+			releaseTime = NSDate.timeIntervalSinceReferenceDate;
+			[lock releaseLock];
+
+			[expectLock1Release fulfill];
+		});
+	}]];
+
+	dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+		[lockManager2 requestLock:[[OCLockRequest alloc] initWithResourceIdentifier:@"resource-1" acquiredHandler:^(NSError * _Nullable error, OCLock * _Nullable lock) {
+			NSTimeInterval wakeupDelay = NSDate.timeIntervalSinceReferenceDate - releaseTime;
+
+			XCTAssert(expectLock1 == nil);
+
+			// Woken up by the release notification, not by the keep-alive or expiration of lock 1
+			XCTAssert(wakeupDelay < (OCLockExpirationInterval / 2.0));
+			NSLog(@"Lock 2 acquired %.3fs after release of lock 1", wakeupDelay);
+
+			[expectLock2 fulfill];
+		}]];
+	});
+
+	[self waitForExpectationsWithTimeout:10.0 handler:nil];
+}
+
+- (void)testLockTableConcurrencyLockExpiration
+{
+	__block XCTestExpectation *expectLock1 = [self expectationWithDescription:@"Lock 1 acquired"];
+	__block XCTestExpectation *expectLock1Expiry = [self expectationWithDescription:@"Lock 1 expired"];
+	__block XCTestExpectation *expectLock2 = [self expectationWithDescription:@"Lock 2 acquired"];
+
+	NSString *tableIdentifier = NSUUID.UUID.UUIDString;
+	PausableLockManager *lockManager1 = [[PausableLockManager alloc] initWithLockTable:[[OCLockTable alloc] initWithURL:_lockTableURL identifier:tableIdentifier] keyValueStore:nil];
+	OCLockManager *lockManager2 = [[OCLockManager alloc] initWithLockTable:[[OCLockTable alloc] initWithURL:_lockTableURL identifier:tableIdentifier] keyValueStore:nil];
+
+	[lockManager1 requestLock:[[OCLockRequest alloc] initWithResourceIdentifier:@"resource-2" acquiredHandler:^(NSError * _Nullable error, OCLock * _Nullable lock) {
+		lock.expirationHandler = ^{
+			[expectLock1Expiry fulfill];
+		};
+
+		// Stop keep-alive, so that the lock expires
+		lockManager1.paused = YES;
+
+		dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(OCLockExpirationInterval*1.5 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+			lockManager1.paused = NO;
+			[lockManager1 setNeedsLockUpdate];
+		});
+
+		[expectLock1 fulfill];
+		expectLock1 = nil;
+	}]];
+
+	dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.25 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+		[lockManager2 requestLock:[[OCLockRequest alloc] initWithResourceIdentifier:@"resource-2" acquiredHandler:^(NSError * _Nullable error, OCLock * _Nullable lock) {
+			XCTAssert(expectLock1 == nil);
+
+			[expectLock2 fulfill];
+		}]];
+	});
+
+	[self waitForExpectationsWithTimeout:10.0 handler:nil];
+}
+
+- (void)testLockTableUnavailableFallback
+{
+	__block XCTestExpectation *expectLock1 = [self expectationWithDescription:@"Lock 1 acquired"];
+	__block XCTestExpectation *expectLock1Release = [self expectationWithDescription:@"Lock 1 released"];
+	__block XCTestExpectation *expectLock2 = [self expectationWithDescription:@"Lock 2 acquired"];
+
+	// Lock manager 1 uses the lock table, lock manager 2 runs in a process that couldn't open it
+	OCLockManager *lockManager1 = [[OCLockManager alloc] initWithLockTable:[[OCLockTable alloc] initWithURL:_lockTableURL identifier:NSUUID.UUID.UUIDString] keyValueStore:[[OCKeyValueStore alloc] initWithURL:_keyValueStoreURL identifier:@"lockTestKVS"]];
+	OCLockManager *lockManager2 = [[OCLockManager alloc] initWithLockTable:nil keyValueStore:[[OCKeyValueStore alloc] initWithURL:_keyValueStoreURL identifier:@"lockTestKVS"]];
+
+	[lockManager1 requestLock:[[OCLockRequest alloc] initWithResourceIdentifier:@"resource-3" acquiredHandler:^(NSError * _Nullable error, OCLock * _Nullable lock) {
+		[expectLock1 fulfill];
+
+		// Hold the lock beyond the time lock managers wait for locks to move from the lock table to the KVS
+		dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(OCLockExpirationInterval * 1.5 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+			expectLock1 = nil;
+
+			[lock releaseLock];
+
+			[expectLock1Release fulfill];
+		});
+	}]];
+
+	dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.25 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+		[lockManager2 _recordLockTableUnavailable];
+
+		[lockManager2 requestLock:[[OCLockRequest alloc] initWithResourceIdentifier:@"resource-3" acquiredHandler:^(NSError * _Nullable error, OCLock * _Nullable lock) {
+			// Lock 1 was moved to the KVS, so lock 2 is only acquired after its release
+			XCTAssert(expectLock1 == nil);
+
+			[expectLock2 fulfill];
+		}]];
+	});
+
+	[self waitForExpectationsWithTimeout:15.0 handler:nil];
+}
+
+- (void)testLockTableUnavailableRecordExpires
+{
+	XCTestExpectation *expectLock = [self expectationWithDescription:@"Lock acquired"];
+	OCKeyValueStore *keyValueStore = [[OCKeyValueStore alloc] initWithURL:_keyValueStoreURL identifier:@"lockTestKVS"];
+
+	// Record left behind by a process that couldn't open the lock table and has since terminated
+	[keyValueStore registerClass:NSDate.class forKey:OCKeyValueStoreKeyLockTableUnavailable];
+	[keyValueStore storeObject:[NSDate dateWithTimeIntervalSinceNow:-3600] forKey:OCKeyValueStoreKeyLockTableUnavailable];
+
+	OCLockManager *lockManager = [[OCLockManager alloc] initWithLockTable:[[OCLockTable alloc] initWithURL:_lockTableURL identifier:NSUUID.UUID.UUIDString] keyValueStore:keyValueStore];
+
+	[lockManager requestLock:[[OCLockRequest alloc] initWithResourceIdentifier:@"resource-4" acquiredHandler:^(NSError * _Nullable error, OCLock * _Nullable lock) {
+		// Lock was acquired in the lock table
+		XCTAssertNotNil(lock);
+		XCTAssertEqual([[lockManager valueForKey:@"_lockTableTokensByLockIdentifier"] count], 1);
+
+		[lock releaseLock];
+
+		[expectLock fulfill];
+	}]];
+
+	[self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testLockTableWithUnexpectedSizeIsNotResized
+{
+	NSString *tableIdentifier = NSUUID.UUID.UUIDString;
+	NSURL *tableFileURL = nil;
+	NSNumber *fileSize = nil;
+
+	@autoreleasepool {
+		tableFileURL = [[OCLockTable alloc] initWithURL:_lockTableURL identifier:tableIdentifier].url;
+	}
+
+	XCTAssertNotEqualObjects(tableFileURL, _lockTableURL);
+
+	// File with a different layout (f.ex. written by another version)
+	XCTAssert([[NSData dataWithLength:100] writeToURL:tableFileURL atomically:NO]);
+
+	XCTAssertNil([[OCLockTable alloc] initWithURL:_lockTableURL identifier:tableIdentifier]);
+
+	[tableFileURL getResourceValue:&fileSize forKey:NSURLFileSizeKey error:NULL];
+	XCTAssertEqual(fileSize.unsignedIntegerValue, 100);
+}
+
 @end
@@ -8,6 +8,11 @@
 
 #import <XCTest/XCTest.h>
 #import <ownCloudSDK/ownCloudSDK.h>
+#import "OCLogRecordBuffer.h"
+
+@interface OCConnection (Private)
+- (void)_handleRangedDownloadChunkResult:(OCHTTPRequest *)request error:(NSError *)error;
+@end
 
 @interface MiscTests : XCTestCase
 
@@ -249,6 +254,80 @@
 	XCTAssert([cache objectForKey:@"3"] != nil, @"Value 3 still in cache");
 }
 
+- (void)testCacheStatistics
+{
+	OCCache *cache = [[OCCache alloc] initWithShardCount:4];
+
+	cache.countLimit = 100;
+
+	for (NSUInteger i=0; i<200; i++)
+	{
+		[cache setObject:@(i) forKey:@(i) cost:2];
+	}
+
+	XCTAssert(cache.count <= 100, @"Count limit split across shards");
+	XCTAssert(cache.totalCost == cache.count * 2);
+	XCTAssert(cache.evictionCount == 200 - cache.count);
+
+	XCTAssertEqualObjects([cache objectForKey:@(199)], @(199));
+	XCTAssertNil([cache objectForKey:@(0)]);
+	XCTAssert(cache.hitCount == 1);
+	XCTAssert(cache.missCount == 1);
+
+	[cache removeObjectForKey:@(199)];
+	XCTAssertNil([cache objectForKey:@(199)]);
+
+	[cache resetStatistics];
+	XCTAssert((cache.hitCount == 0) && (cache.missCount == 0) && (cache.evictionCount == 0));
+
+	[cache clearCache];
+	XCTAssert((cache.count == 0) && (cache.totalCost == 0));
+}
+
+- (void)testCacheAdmissionPolicy
+{
+	NSUInteger (^hotHitCountForPolicy)(OCCacheAdmissionPolicy admissionPolicy) = ^(OCCacheAdmissionPolicy admissionPolicy) {
+		OCCache<NSString *, NSNumber *> *cache = [OCCache new];
+		NSUInteger hotHitCount = 0;
+
+		cache.countLimit = 100;
+		cache.admissionPolicy = admissionPolicy;
+
+		// 80 frequently used keys, each followed by a key that is only used once
+		for (NSUInteger i=0; i<5000; i++)
+		{
+			NSString *scanKey = [NSString stringWithFormat:@"scan-%lu", (unsigned long)i];
+			NSString *hotKey = [NSString stringWithFormat:@"hot-%lu", (unsigned long)(i % 80)];
+
+			if ([cache objectForKey:scanKey] == nil)
+			{
+				[cache setObject:@(i) forKey:scanKey];
+			}
+
+			if ([cache objectForKey:hotKey] != nil)
+			{
+				hotHitCount++;
+			}
+			else
+			{
+				[cache setObject:@(i) forKey:hotKey];
+			}
+		}
+
+		XCTAssert(cache.count == 100);
+
+		return (hotHitCount);
+	};
+
+	NSUInteger lruHitCount = hotHitCountForPolicy(OCCacheAdmissionPolicyLRU);
+	NSUInteger tinyLFUHitCount = hotHitCountForPolicy(OCCacheAdmissionPolicyTinyLFU);
+
+	OCLog(@"Hits for frequently used keys: LRU=%lu, TinyLFU=%lu", (unsigned long)lruHitCount, (unsigned long)tinyLFUHitCount);
+
+	XCTAssert(lruHitCount == 0, @"Reuse distance (160 keys) exceeds the count limit");
+	XCTAssert(tinyLFUHitCount > 4000, @"TinyLFU keeps frequently used keys");
+}
+
 #pragma mark - OCUser
 - (void)testUserSerialization
 {
@@ -325,6 +404,39 @@
 
 }
 
+#pragma mark - NSDate+OCDateParser
+- (void)testDateParsing
+{
+	NSTimeInterval timeInterval = 0;
+	NSDate *expectedDate = [NSDate dateWithTimeIntervalSince1970:1519386725]; // 2018-02-23 11:52:05 UTC
+
+	// RFC 1123
+	XCTAssertEqualObjects([NSDate dateParsedFromString:@"Fri, 23 Feb 2018 11:52:05 GMT" error:NULL], expectedDate);
+	XCTAssertEqualObjects([NSDate dateParsedFromString:@"Fri, 23 Feb 2018 12:52:05 +0100" error:NULL], expectedDate);
+	XCTAssertEqualObjects([NSDate dateParsedFromString:@"23 feb 2018 11:52:05 UTC" error:NULL], expectedDate);
+	XCTAssertEqualObjects([NSDate dateParsedFromString:@"Fri, 23 Nov 2018 09:43:58 GMT" error:NULL], [NSDate dateWithTimeIntervalSince1970:1542966238]);
+
+	XCTAssertFalse(OCDateParseRFC1123("Thu, 29 Feb 2018 11:52:05 GMT", 29, &timeInterval)); // 2018 is not a leap year
+	XCTAssertFalse(OCDateParseRFC1123("Fri, 23 Feb 2018 11:52", 22, &timeInterval));
+	XCTAssertTrue(OCDateParseRFC1123("Thu, 29 Feb 2024 00:00:00 GMT", 29, &timeInterval));
+	XCTAssertEqual(timeInterval, [NSDate dateWithTimeIntervalSince1970:1709164800].timeIntervalSinceReferenceDate);
+
+	// ISO 8601
+	XCTAssertEqualObjects([NSDate dateParsedFromISO8601String:@"2018-02-23T11:52:05Z"], expectedDate);
+	XCTAssertEqualObjects([NSDate dateParsedFromISO8601String:@"2018-02-23T13:52:05+02:00"], expectedDate);
+	XCTAssertEqualWithAccuracy([NSDate dateParsedFromISO8601String:@"2018-02-23T11:52:05.25Z"].timeIntervalSince1970, 1519386725.25, 0.0001);
+	XCTAssertEqualObjects([NSDate dateParsedFromCompactUTCString:@"2018-02-23 11:52:05" error:NULL], expectedDate);
+	XCTAssertEqualObjects([NSDate dateParsedFromCompactUTCString:@"2018-02-23T11:52:05Z" error:NULL], expectedDate);
+
+	XCTAssertFalse(OCDateParseISO8601("2018-02-23T11:52:05", 19, &timeInterval)); // time zone required for 'T' separated dates
+	XCTAssertFalse(OCDateParseISO8601("2018-13-23T11:52:05Z", 20, &timeInterval));
+	XCTAssertFalse(OCDateParseISO8601("2018-02-23T11:52:05.Z", 21, &timeInterval));
+
+	// Fallback for invalid strings
+	XCTAssertNil([NSDate dateParsedFromString:@"not a date" error:NULL]);
+	XCTAssertNil([NSDate dateParsedFromISO8601String:@"not a date"]);
+}
+
 #pragma mark - Formatting
 - (void)testStringFormatting
 {
@@ -344,6 +456,72 @@
 	XCTAssert([@"     The quick brown fox jumps" isEqual:[@"The quick brown fox jumps" rightPaddedMaxLength:30]]);
 }
 
+#pragma mark - OCLogRecordBuffer
+static BOOL MiscTestsAppendLogRecord(OCLogRecordBuffer *buffer, NSString *format, ...) NS_FORMAT_FUNCTION(2,3);
+static BOOL MiscTestsAppendLogRecord(OCLogRecordBuffer *buffer, NSString *format, ...)
+{
+	va_list args;
+	BOOL appended;
+
+	va_start(args, format);
+	appended = [buffer appendRecordWithLogLevel:OCLogLevelDebug timestamp:OCLogRecordBuffer.currentTimestamp functionName:@"function" file:@"file.m" line:1 tags:@[@"Test"] format:format arguments:args];
+	va_end(args);
+
+	return (appended);
+}
+
+- (void)testLogRecordBuffer
+{
+	OCLogRecordBuffer *buffer = [[OCLogRecordBuffer alloc] initWithCapacity:8 threadID:1];
+	NSMutableArray<OCLogBufferedRecord *> *records = [NSMutableArray new];
+	NSMutableString *mutableString = [@"before" mutableCopy];
+	NSArray<NSString *> *expectedMessages;
+
+	XCTAssert(MiscTestsAppendLogRecord(buffer, @"Plain text, 100%% literal"));
+	XCTAssert(MiscTestsAppendLogRecord(buffer, @"int=%d uint=%u hex=%04x long=%ld ulonglong=%llu size=%zu char=%c", -42, 42u, 255, -1234567890123L, 18446744073709551615ULL, (size_t)7, 'x'));
+	XCTAssert(MiscTestsAppendLogRecord(buffer, @"double=%.3f sci=%e float=%g", 3.14159, 0.000123, 2.5f));
+	XCTAssert(MiscTestsAppendLogRecord(buffer, @"object=%@ number=%@ nil=%@ cString=%s", mutableString, @(23), nil, "c-string"));
+	XCTAssert(MiscTestsAppendLogRecord(buffer, @"star width=[%*d]", 5, 42)); // Not captured, formatted immediately
+	XCTAssert(MiscTestsAppendLogRecord(buffer, @"%@", @"only object"));
+
+	// Changes after logging must not be reflected in the message
+	[mutableString setString:@"after"];
+
+	XCTAssertEqual(buffer.count, 6);
+	XCTAssert(MiscTestsAppendLogRecord(buffer, @"7"));
+	XCTAssert(MiscTestsAppendLogRecord(buffer, @"8"));
+	XCTAssertFalse(MiscTestsAppendLogRecord(buffer, @"9 (buffer full)"));
+
+	XCTAssertEqual([buffer dequeueRecordsInto:records], 8);
+	XCTAssertEqual(buffer.count, 0);
+
+	expectedMessages = @[
+		@"Plain text, 100% literal",
+		[NSString stringWithFormat:@"int=%d uint=%u hex=%04x long=%ld ulonglong=%llu size=%zu char=%c", -42, 42u, 255, -1234567890123L, 18446744073709551615ULL, (size_t)7, 'x'],
+		[NSString stringWithFormat:@"double=%.3f sci=%e float=%g", 3.14159, 0.000123, 2.5f],
+		@"object=before number=23 nil=(null) cString=c-string",
+		@"star width=[   42]",
+		@"only object",
+		@"7",
+		@"8"
+	];
+
+	for (NSUInteger idx=0; idx < records.count; idx++)
+	{
+		XCTAssertEqualObjects(records[idx].message, expectedMessages[idx]);
+		XCTAssertEqualObjects(records[idx].tags, @[@"Test"]);
+		XCTAssertEqual(records[idx].threadID, 1);
+	}
+
+	XCTAssert(records.firstObject.timestamp <= records.lastObject.timestamp);
+
+	// Slots are reused after dequeuing
+	XCTAssert(MiscTestsAppendLogRecord(buffer, @"wrap %d", 9));
+	[records removeAllObjects];
+	XCTAssertEqual([buffer dequeueRecordsInto:records], 1);
+	XCTAssertEqualObjects(records.firstObject.message, @"wrap 9");
+}
+
 #pragma mark - OCIPCNotificationCenter
 - (void)testIPNotifications
 {
@@ -822,4 +1000,388 @@
 
 }
 
+#pragma mark - OCHTTPDAVItemStreamDecoder
+- (void)testItemStreamDecoderRestart
+{
+	__block NSUInteger restartCount = 0;
+	OCHTTPDAVItemStreamDecoder *decoder, *restartedDecoder;
+
+	decoder = [[OCHTTPDAVItemStreamDecoder alloc] initWithBasePath:@"/remote.php/dav/files/admin" batchHandler:^(OCHTTPDAVItemStreamDecoder *decoder, NSArray<OCItem *> *items) {
+	}];
+	decoder.batchSize = 50;
+	decoder.driveID = @"drive";
+	decoder.restartHandler = ^{
+		restartCount++;
+	};
+
+	restartedDecoder = [decoder decoderForRestartedResponse];
+
+	XCTAssert(restartCount == 1);
+	XCTAssert(decoder.isCancelled);
+	XCTAssert(!restartedDecoder.isCancelled);
+	XCTAssert(restartedDecoder != decoder);
+	XCTAssert(restartedDecoder.batchSize == 50);
+	XCTAssert([restartedDecoder.driveID isEqual:@"drive"]);
+	XCTAssert([restartedDecoder.basePath isEqual:@"/remote.php/dav/files/admin"]);
+	XCTAssert(restartedDecoder.restartHandler != nil);
+	XCTAssert(restartedDecoder.itemCount == 0);
+}
+
+#pragma mark - OCResourceBlobStore
+- (void)testResourceBlobStore
+{
+	NSURL *rootURL = [NSFileManager.defaultManager.temporaryDirectory URLByAppendingPathComponent:NSUUID.UUID.UUIDString isDirectory:YES];
+	OCResourceBlobStore *blobStore = [[OCResourceBlobStore alloc] initWithRootURL:rootURL];
+	NSMutableArray<OCResourceBlobID> *blobIDs = [NSMutableArray new];
+	NSUInteger blobSize = 64 * 1024;
+
+	// Store
+	for (uint8_t idx=0; idx < 10; idx++)
+	{
+		NSMutableData *data = [NSMutableData dataWithLength:blobSize];
+		OCResourceBlobID blobID;
+		NSError *error = nil;
+
+		memset(data.mutableBytes, idx, blobSize);
+
+		blobID = [blobStore storeData:data error:&error];
+
+		XCTAssertNil(error);
+		XCTAssertNotNil(blobID);
+		XCTAssertEqual(blobID.length, 64);
+
+		// Deduplication
+		XCTAssertEqualObjects([blobStore storeData:[data copy] error:NULL], blobID);
+
+		// Retrieval
+		XCTAssertEqualObjects([blobStore dataForBlobID:blobID], data);
+
+		[blobIDs addObject:blobID];
+	}
+
+	XCTAssertEqual(blobStore.totalSize, 10 * blobSize);
+
+	// Index is rebuilt from the file system
+	XCTAssertEqual([[OCResourceBlobStore alloc] initWithRootURL:rootURL].totalSize, 10 * blobSize);
+
+	// Access first blob, so it's no longer the least recently used one
+	[NSThread sleepForTimeInterval:0.1];
+	XCTAssertNotNil([blobStore dataForBlobID:blobIDs.firstObject]);
+
+	// Eviction
+	blobStore.sizeBudget = 5 * blobSize;
+
+	XCTAssert(blobStore.totalSize <= (5 * blobSize));
+	XCTAssertNotNil([blobStore dataForBlobID:blobIDs.firstObject]); // recently used
+	XCTAssertNil([blobStore dataForBlobID:blobIDs[1]]); // least recently used
+	XCTAssertNotNil([blobStore dataForBlobID:blobIDs.lastObject]); // most recently stored
+
+	// Removal
+	[blobStore removeBlobWithID:blobIDs.lastObject];
+	XCTAssertNil([blobStore dataForBlobID:blobIDs.lastObject]);
+
+	[blobStore removeAllBlobs];
+	XCTAssertEqual(blobStore.totalSize, 0);
+	XCTAssertFalse([NSFileManager.defaultManager fileExistsAtPath:rootURL.path]);
+}
+
+- (void)testResourceBlobStoreReadsUpdateRecency
+{
+	NSURL *rootURL = [NSFileManager.defaultManager.temporaryDirectory URLByAppendingPathComponent:NSUUID.UUID.UUIDString isDirectory:YES];
+	OCResourceBlobStore *writingBlobStore = [[OCResourceBlobStore alloc] initWithRootURL:rootURL];
+	OCResourceBlobStore *readingBlobStore = [[OCResourceBlobStore alloc] initWithRootURL:rootURL];
+	NSMutableArray<OCResourceBlobID> *blobIDs = [NSMutableArray new];
+	NSUInteger blobSize = 64 * 1024;
+
+	for (uint8_t idx=0; idx < 4; idx++)
+	{
+		NSMutableData *data = [NSMutableData dataWithLength:blobSize];
+
+		memset(data.mutableBytes, idx, blobSize);
+
+		[blobIDs addObject:[writingBlobStore storeData:data error:NULL]];
+	}
+
+	// Read oldest blob from a store that hasn't loaded its index yet (f.ex. in another process)
+	[NSThread sleepForTimeInterval:0.1];
+	XCTAssertNotNil([readingBlobStore dataForBlobID:blobIDs.firstObject]);
+	XCTAssertEqual(readingBlobStore.totalSize, 4 * blobSize);
+
+	// Eviction skips the recently read blob
+	readingBlobStore.sizeBudget = 3 * blobSize;
+
+	XCTAssertNotNil([readingBlobStore dataForBlobID:blobIDs.firstObject]);
+	XCTAssertNil([readingBlobStore dataForBlobID:blobIDs[1]]);
+
+	[readingBlobStore removeAllBlobs];
+}
+
+#pragma mark - OCRangedDownloadJob
+- (void)testRangedDownloadJobChunkMap
+{
+	NSURL *fileURL = [NSFileManager.defaultManager.temporaryDirectory URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
+	NSURL *chunkURL = [NSFileManager.defaultManager.temporaryDirectory URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
+	NSUInteger fileSize = 10 * 1000 + 500, chunkSize = 1000;
+	NSMutableData *contents = [NSMutableData dataWithLength:fileSize];
+	OCRangedDownloadJob *job = [[OCRangedDownloadJob alloc] initWithFileURL:fileURL fileSize:fileSize eTag:@"\"etag\"" chunkSize:chunkSize];
+	NSError *error = nil;
+
+	for (NSUInteger idx=0; idx < fileSize; idx++)
+	{
+		((uint8_t *)contents.mutableBytes)[idx] = (uint8_t)(idx * 7);
+	}
+
+	job.maximumConcurrentChunks = 4;
+
+	// Ranges
+	XCTAssertEqual(job.chunkCount, 11);
+	XCTAssertEqual([job byteRangeOfChunk:0].location, 0);
+	XCTAssertEqual([job byteRangeOfChunk:0].length, chunkSize);
+	XCTAssertEqual([job byteRangeOfChunk:10].location, 10000);
+	XCTAssertEqual([job byteRangeOfChunk:10].length, 500);
+	XCTAssertEqual([job byteRangeOfChunk:11].location, NSNotFound);
+
+	XCTAssertTrue([job prepareFileWithError:&error]);
+	XCTAssertNil(error);
+	XCTAssertEqual([[NSFileManager.defaultManager attributesOfItemAtPath:fileURL.path error:NULL] fileSize], fileSize);
+
+	// Concurrency limit
+	NSIndexSet *requestedChunks = [job requestChunks];
+	XCTAssertEqualObjects(requestedChunks, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 4)]);
+	XCTAssertEqual([job requestChunks].count, 0);
+
+	[job abandonChunk:3];
+	XCTAssertEqualObjects([job requestChunks], [NSIndexSet indexSetWithIndex:3]);
+
+	// Store chunks in reverse order
+	for (NSInteger chunkIndex=job.chunkCount-1; chunkIndex >= 0; chunkIndex--)
+	{
+		if (chunkIndex == 5) { continue; }
+
+		XCTAssertTrue([[contents subdataWithRange:[job byteRangeOfChunk:chunkIndex]] writeToURL:chunkURL atomically:NO]);
+		XCTAssertTrue([job storeChunk:chunkIndex fromFileURL:chunkURL error:&error]);
+		XCTAssertNil(error);
+	}
+
+	XCTAssertFalse(job.isComplete);
+	XCTAssertFalse([job isChunkComplete:5]);
+	XCTAssertEqual(job.completedByteCount, fileSize - chunkSize);
+
+	// Truncated chunks are rejected
+	XCTAssertTrue([[contents subdataWithRange:NSMakeRange(5000, 10)] writeToURL:chunkURL atomically:NO]);
+	XCTAssertFalse([job storeChunk:5 fromFileURL:chunkURL error:&error]);
+	XCTAssertNotNil(error);
+	XCTAssertFalse([job isChunkComplete:5]);
+
+	// Chunk map survives encoding
+	OCRangedDownloadJob *decodedJob = [NSKeyedUnarchiver unarchivedObjectOfClass:OCRangedDownloadJob.class fromData:[NSKeyedArchiver archivedDataWithRootObject:job requiringSecureCoding:YES error:NULL] error:NULL];
+
+	XCTAssertNotNil(decodedJob);
+	XCTAssertEqualObjects(decodedJob.identifier, job.identifier);
+	XCTAssertEqualObjects(decodedJob.eTag, job.eTag);
+	XCTAssertEqual(decodedJob.maximumConcurrentChunks, 4);
+	XCTAssertEqual(decodedJob.completedByteCount, job.completedByteCount);
+
+	// Resumed job only requests the missing chunk
+	XCTAssertEqualObjects([decodedJob requestChunks], [NSIndexSet indexSetWithIndex:5]);
+
+	XCTAssertTrue([[contents subdataWithRange:[decodedJob byteRangeOfChunk:5]] writeToURL:chunkURL atomically:NO]);
+	XCTAssertTrue([decodedJob storeChunk:5 fromFileURL:chunkURL error:&error]);
+	XCTAssertTrue(decodedJob.isComplete);
+
+	// Assembled in place
+	XCTAssertEqualObjects([NSData dataWithContentsOfURL:fileURL], contents);
+
+	// Conclusion
+	XCTAssertTrue([decodedJob conclude]);
+	XCTAssertFalse([decodedJob conclude]);
+
+	[decodedJob destroy];
+	XCTAssertFalse([NSFileManager.defaultManager fileExistsAtPath:fileURL.path]);
+	XCTAssertFalse(decodedJob.isComplete);
+
+	[NSFileManager.defaultManager removeItemAtURL:chunkURL error:NULL];
+}
+
+- (OCHTTPRequest *)_rangedDownloadResultForJob:(OCRangedDownloadJob *)job item:(OCItem *)item chunk:(NSUInteger)chunkIndex statusCode:(OCHTTPStatusCode)statusCode headerFields:(NSDictionary<NSString *, NSString *> *)headerFields body:(NSData *)body eventTarget:(OCEventTarget *)eventTarget
+{
+	OCHTTPRequest *request = [OCHTTPRequest requestWithURL:[NSURL URLWithString:@"https://demo.owncloud.org/remote.php/dav/files/admin/file.bin"]];
+
+	request.userInfo = @{
+		@"item" : item,
+		@"job" : job,
+		@"chunk" : @(chunkIndex)
+	};
+	request.eventTarget = eventTarget;
+
+	request.httpResponse = [[OCHTTPResponse alloc] initWithRequest:request HTTPError:nil];
+	request.httpResponse.status = [OCHTTPStatus HTTPStatusWithCode:statusCode];
+	request.httpResponse.headerFields = headerFields;
+
+	if (body != nil)
+	{
+		NSURL *bodyURL = [NSFileManager.defaultManager.temporaryDirectory URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
+
+		[body writeToURL:bodyURL atomically:NO];
+		request.httpResponse.bodyURL = bodyURL;
+	}
+
+	return (request);
+}
+
+- (void)testRangedDownloadChunkResultHandling
+{
+	OCConnection *connection = [[OCConnection alloc] initWithBookmark:[OCBookmark bookmarkForURL:[NSURL URLWithString:@"https://demo.owncloud.org/"]]];
+	NSMutableDictionary<NSString *, OCRangedDownloadJob *> *jobsByID = [connection valueForKey:@"_rangedDownloadJobsByID"];
+	NSUInteger fileSize = 2500, chunkSize = 1000;
+	NSMutableData *contents = [NSMutableData dataWithLength:fileSize];
+	NSMutableArray<OCEvent *> *events = [NSMutableArray new];
+	OCEventTarget *eventTarget = [OCEventTarget eventTargetWithEphermalEventHandlerBlock:^(OCEvent * _Nonnull event, id _Nonnull sender) {
+		[events addObject:event];
+	} userInfo:nil ephermalUserInfo:nil];
+	OCItem *item = [OCItem new];
+	OCRangedDownloadJob *job;
+
+	for (NSUInteger idx=0; idx < fileSize; idx++)
+	{
+		((uint8_t *)contents.mutableBytes)[idx] = (uint8_t)(idx * 13);
+	}
+
+	item.path = @"/file.bin";
+	item.eTag = @"\"etag\"";
+	item.size = fileSize;
+
+	// 206: ranges are stored, an unexpected Content-Range concludes the job with an error
+	job = [[OCRangedDownloadJob alloc] initWithFileURL:[NSFileManager.defaultManager.temporaryDirectory URLByAppendingPathComponent:NSUUID.UUID.UUIDString] fileSize:fileSize eTag:item.eTag chunkSize:chunkSize];
+	XCTAssertTrue([job prepareFileWithError:NULL]);
+	XCTAssertEqualObjects([job requestChunks], [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 3)]);
+
+	[connection _handleRangedDownloadChunkResult:[self _rangedDownloadResultForJob:job item:item chunk:0 statusCode:OCHTTPStatusCodePARTIAL_CONTENT headerFields:@{ OCHTTPHeaderFieldNameContentRange : @"bytes 0-999/2500" } body:[contents subdataWithRange:NSMakeRange(0, 1000)] eventTarget:eventTarget] error:nil];
+
+	XCTAssertTrue([job isChunkComplete:0]);
+	XCTAssertEqual(events.count, 0);
+	XCTAssertEqual(jobsByID[job.identifier], job);
+
+	[connection _handleRangedDownloadChunkResult:[self _rangedDownloadResultForJob:job item:item chunk:1 statusCode:OCHTTPStatusCodePARTIAL_CONTENT headerFields:@{ OCHTTPHeaderFieldNameContentRange : @"bytes 1000-1499/2500" } body:[contents subdataWithRange:NSMakeRange(1000, 500)] eventTarget:eventTarget] error:nil];
+
+	XCTAssertFalse([job isChunkComplete:1]);
+	XCTAssertTrue(job.concluded);
+	XCTAssertEqual(events.count, 1);
+	XCTAssertTrue([events.lastObject.error isOCErrorWithCode:OCErrorResponseUnknownFormat]);
+	XCTAssertEqual(events.lastObject.result, job);
+
+	// Concluded job stays registered until the last chunk request has returned - and stores its range for a retry
+	XCTAssertEqual(jobsByID[job.identifier], job);
+
+	[connection _handleRangedDownloadChunkResult:[self _rangedDownloadResultForJob:job item:item chunk:2 statusCode:OCHTTPStatusCodePARTIAL_CONTENT headerFields:@{ OCHTTPHeaderFieldNameContentRange : @"bytes 2000-2499/2500" } body:[contents subdataWithRange:NSMakeRange(2000, 500)] eventTarget:eventTarget] error:nil];
+
+	XCTAssertTrue([job isChunkComplete:2]);
+	XCTAssertEqual(events.count, 1);
+	XCTAssertNil(jobsByID[job.identifier]);
+
+	[job resume];
+	XCTAssertEqualObjects([job requestChunks], [NSIndexSet indexSetWithIndex:1]);
+	[job destroy];
+
+	// 200 with the requested ETag: server doesn't support ranges and returned the entire file
+	[events removeAllObjects];
+
+	job = [[OCRangedDownloadJob alloc] initWithFileURL:[NSFileManager.defaultManager.temporaryDirectory URLByAppendingPathComponent:NSUUID.UUID.UUIDString] fileSize:fileSize eTag:item.eTag chunkSize:chunkSize];
+	XCTAssertTrue([job prepareFileWithError:NULL]);
+	XCTAssertEqual([job requestChunks].count, 3);
+
+	[connection _handleRangedDownloadChunkResult:[self _rangedDownloadResultForJob:job item:item chunk:0 statusCode:OCHTTPStatusCodeOK headerFields:@{ @"Etag" : item.eTag } body:contents eventTarget:eventTarget] error:nil];
+
+	XCTAssertTrue(job.isComplete);
+	XCTAssertEqual(events.count, 1);
+	XCTAssertNil(events.lastObject.error);
+	XCTAssertEqualObjects(events.lastObject.file.url, job.fileURL);
+	XCTAssertEqualObjects([NSData dataWithContentsOfURL:job.fileURL], contents);
+	XCTAssertEqual(jobsByID[job.identifier], job);
+
+	for (NSUInteger chunkIndex=1; chunkIndex < 3; chunkIndex++)
+	{
+		OCHTTPRequest *request = [self _rangedDownloadResultForJob:job item:item chunk:chunkIndex statusCode:OCHTTPStatusCodeOK headerFields:@{} body:nil eventTarget:eventTarget];
+
+		request.cancelled = YES;
+
+		[connection _handleRangedDownloadChunkResult:request error:nil];
+	}
+
+	XCTAssertEqual(events.count, 1);
+	XCTAssertNil(jobsByID[job.identifier]);
+	[job destroy];
+
+	// 200 with a different ETag: If-Range didn't match because the file changed on the server
+	[events removeAllObjects];
+
+	job = [[OCRangedDownloadJob alloc] initWithFileURL:[NSFileManager.defaultManager.temporaryDirectory URLByAppendingPathComponent:NSUUID.UUID.UUIDString] fileSize:fileSize eTag:item.eTag chunkSize:chunkSize];
+	XCTAssertTrue([job prepareFileWithError:NULL]);
+	XCTAssertEqual([job requestChunks].count, 3);
+
+	[connection _handleRangedDownloadChunkResult:[self _rangedDownloadResultForJob:job item:item chunk:0 statusCode:OCHTTPStatusCodePARTIAL_CONTENT headerFields:@{ OCHTTPHeaderFieldNameContentRange : @"bytes 0-999/2500" } body:[contents subdataWithRange:NSMakeRange(0, 1000)] eventTarget:eventTarget] error:nil];
+	XCTAssertEqual(job.completedByteCount, 1000);
+
+	[connection _handleRangedDownloadChunkResult:[self _rangedDownloadResultForJob:job item:item chunk:1 statusCode:OCHTTPStatusCodeOK headerFields:@{ @"Etag" : @"\"changed\"" } body:contents eventTarget:eventTarget] error:nil];
+
+	XCTAssertEqual(job.completedByteCount, 0);
+	XCTAssertTrue(job.concluded);
+	XCTAssertEqual(events.count, 1);
+	XCTAssertTrue([events.lastObject.error isOCErrorWithCode:OCErrorItemChanged]);
+	XCTAssertEqual(jobsByID[job.identifier], job);
+
+	[connection _handleRangedDownloadChunkResult:[self _rangedDownloadResultForJob:job item:item chunk:2 statusCode:OCHTTPStatusCodeOK headerFields:@{} body:nil eventTarget:eventTarget] error:OCError(OCErrorCancelled)];
+
+	XCTAssertEqual(events.count, 1);
+	XCTAssertNil(jobsByID[job.identifier]);
+
+	[job destroy];
+
+	// 200 without ETag: version of the returned file is unknown, so it is not accepted
+	[events removeAllObjects];
+
+	job = [[OCRangedDownloadJob alloc] initWithFileURL:[NSFileManager.defaultManager.temporaryDirectory URLByAppendingPathComponent:NSUUID.UUID.UUIDString] fileSize:fileSize eTag:item.eTag chunkSize:chunkSize];
+	XCTAssertTrue([job prepareFileWithError:NULL]);
+	XCTAssertEqual([job requestChunks].count, 3);
+
+	[connection _handleRangedDownloadChunkResult:[self _rangedDownloadResultForJob:job item:item chunk:0 statusCode:OCHTTPStatusCodeOK headerFields:@{} body:contents eventTarget:eventTarget] error:nil];
+
+	XCTAssertFalse(job.isComplete);
+	XCTAssertTrue(job.concluded);
+	XCTAssertEqual(events.count, 1);
+	XCTAssertTrue([events.lastObject.error isOCErrorWithCode:OCErrorItemChanged]);
+
+	for (NSUInteger chunkIndex=1; chunkIndex < 3; chunkIndex++)
+	{
+		[connection _handleRangedDownloadChunkResult:[self _rangedDownloadResultForJob:job item:item chunk:chunkIndex statusCode:OCHTTPStatusCodeOK headerFields:@{} body:nil eventTarget:eventTarget] error:OCError(OCErrorCancelled)];
+	}
+
+	XCTAssertNil(jobsByID[job.identifier]);
+
+	[job destroy];
+}
+
+- (void)testLocalSearchTermsForKQLQuery
+{
+	// Name conditions, as produced by the KQL builder
+	XCTAssertEqualObjects([OCCore localSearchTermsForKQLQuery:[[OCQueryCondition where:OCItemPropertyNameName contains:@"report"] kqlStringWithTypeAliasToKQLTypeMap:@{} targetContent:OCKQLSearchedContentItemName]], (@[ @"report" ]));
+	XCTAssertEqualObjects([OCCore localSearchTermsForKQLQuery:[[OCQueryCondition where:OCItemPropertyNameName contains:@"report"] kqlStringWithTypeAliasToKQLTypeMap:@{} targetContent:OCKQLSearchedContentItemName|OCKQLSearchedContentContents]], (@[ @"report" ]));
+	XCTAssertEqualObjects([OCCore localSearchTermsForKQLQuery:[[OCQueryCondition require:@[
+		[OCQueryCondition where:OCItemPropertyNameName contains:@"2026"],
+		[OCQueryCondition where:OCItemPropertyNameName startsWith:@"Quarterly \"Q3\""]
+	]] kqlStringWithTypeAliasToKQLTypeMap:@{} targetContent:OCKQLSearchedContentItemName]], (@[ @"2026", @"Quarterly \"Q3\"*" ]));
+	XCTAssertEqualObjects([OCCore localSearchTermsForKQLQuery:[[OCQueryCondition where:OCItemPropertyNameName endsWith:@".pdf"] kqlStringWithTypeAliasToKQLTypeMap:@{} targetContent:OCKQLSearchedContentItemName]], (@[ @"*.pdf" ]));
+	XCTAssertEqualObjects([OCCore localSearchTermsForKQLQuery:@"name:\"*report*2026*\""], (@[ @"*report*2026*" ]));
+
+	// Free text
+	XCTAssertEqualObjects([OCCore localSearchTermsForKQLQuery:@"holiday pictures"], (@[ @"holiday", @"pictures" ]));
+
+	// Conditions that can't be answered from the name index
+	XCTAssertNil([OCCore localSearchTermsForKQLQuery:@"(name:\"*report*\") AND (mediatype:\"pdf\")"]);
+	XCTAssertNil([OCCore localSearchTermsForKQLQuery:@"content:\"*report*\""]);
+	XCTAssertNil([OCCore localSearchTermsForKQLQuery:@"report NOT draft"]);
+	XCTAssertNil([OCCore localSearchTermsForKQLQuery:@"size>1000"]);
+	XCTAssertNil([OCCore localSearchTermsForKQLQuery:@""]);
+}
+
 @end
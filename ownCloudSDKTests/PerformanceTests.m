@@ -10,14 +10,15 @@
 #import <ownCloudSDK/ownCloudSDK.h>
 
 #import "OCDetailedPerformanceTestCase.h"
+#import "OCCoreQueryRoutingIndex.h"
 
-//@interface PerformanceTests : OCDetailedPerformanceTestCase
-//
-//@end
-//
-//@implementation PerformanceTests
-//
-//#pragma mark - PROPFIND XML decoding performance
+@interface PerformanceTests : OCDetailedPerformanceTestCase
+
+@end
+
+@implementation PerformanceTests
+
+#pragma mark - PROPFIND XML decoding performance
 //// Test deactivated because the private API used in this test (+knownMemoryMetrics) is no longer available
 //- (void)testPROPFINDXMLDecodingPerformance
 //{
@@ -34,5 +35,910 @@
 //		OCLog(@"%lu parsed objects, %lu errors", (unsigned long)xmlParser.parsedObjects.count, xmlParser.errors.count);
 //	}];
 //}
-//
-//@end
+
+- (void)testPROPFINDStreamingDecoding
+{
+	NSURL *xmlResponseDataURL = [[NSBundle bundleForClass:[self class]] URLForResource:@"largePropFindResponse1000" withExtension:@"xml"];
+	NSData *xmlResponseData = [NSData dataWithContentsOfURL:xmlResponseDataURL];
+
+	[self measureBlock:^{
+		XCTestExpectation *expectFinish = [self expectationWithDescription:@"Decoding finished"];
+		__block NSUInteger batchCount = 0, itemCount = 0;
+		NSInputStream *inputStream = nil;
+		NSOutputStream *outputStream = nil;
+		OCHTTPDAVItemStreamDecoder *decoder;
+
+		decoder = [[OCHTTPDAVItemStreamDecoder alloc] initWithBasePath:@"/remote.php/dav/files/manyfiles" batchHandler:^(OCHTTPDAVItemStreamDecoder *decoder, NSArray<OCItem *> *items) {
+			XCTAssert(items.count <= 100);
+
+			batchCount++;
+			itemCount += items.count;
+		}];
+		decoder.batchSize = 100;
+
+		// Feed the response in small chunks through a bound stream pair, simulating data arriving from the network
+		[NSStream getBoundStreamsWithBufferSize:8192 inputStream:&inputStream outputStream:&outputStream];
+		[outputStream open];
+
+		[decoder decodeStream:inputStream];
+
+		const uint8_t *p_data = (const uint8_t *)xmlResponseData.bytes;
+		NSUInteger remainingBytes = xmlResponseData.length;
+
+		while (remainingBytes > 0)
+		{
+			NSInteger writtenBytes = [outputStream write:p_data maxLength:MIN(remainingBytes, 4096)];
+
+			XCTAssert(writtenBytes >= 0);
+
+			p_data += writtenBytes;
+			remainingBytes -= writtenBytes;
+		}
+
+		[outputStream close];
+
+		[decoder notifyWhenFinished:^{
+			[expectFinish fulfill];
+		}];
+
+		[self waitForExpectationsWithTimeout:30 handler:nil];
+
+		XCTAssert(decoder.finished);
+		XCTAssert(decoder.errors.count == 0, @"Errors: %@", decoder.errors);
+		XCTAssert(itemCount == 1001, @"itemCount=%lu", (unsigned long)itemCount);
+		XCTAssert(itemCount == decoder.itemCount);
+		XCTAssert(batchCount == 11, @"batchCount=%lu", (unsigned long)batchCount);
+	}];
+}
+
+#pragma mark - OCItem serialization performance
+- (NSArray<OCItem *> *)_generateItems:(NSUInteger)count
+{
+	NSMutableArray<OCItem *> *items = [NSMutableArray new];
+	OCUser *owner = [OCUser userWithUserName:@"admin" displayName:@"Administrator"];
+
+	for (NSUInteger i=0; i<count; i++)
+	{
+		OCItem *item = [OCItem placeholderItemOfType:(((i % 10) == 0) ? OCItemTypeCollection : OCItemTypeFile)];
+
+		item.path = [NSString stringWithFormat:@"/Documents/Folder %lu/File %lu.jpg", (unsigned long)(i / 100), (unsigned long)i];
+		item.fileID = [NSString stringWithFormat:@"000%05luocabc123def", (unsigned long)i];
+		item.parentFileID = [NSString stringWithFormat:@"000%05luocabc123def", (unsigned long)(i / 100)];
+		item.eTag = [NSString stringWithFormat:@"\"%lx\"", (unsigned long)(i * 7919)];
+		item.driveID = @"1284d238-aa92-42ce-bdc4-0b0000009157$4c510ada-c86b-4815-8820-42cdf82c3d51";
+		item.mimeType = (item.type == OCItemTypeCollection) ? @"httpd/unix-directory" : @"image/jpeg";
+		item.permissions = OCItemPermissionWritable | OCItemPermissionDelete | OCItemPermissionRename | OCItemPermissionMove;
+		item.size = (NSInteger)(i * 1024);
+		item.lastModified = [NSDate dateWithTimeIntervalSinceReferenceDate:700000000 + i];
+		item.creationDate = [NSDate dateWithTimeIntervalSinceReferenceDate:600000000 + i];
+		item.owner = owner;
+		item.databaseID = @(i+1);
+
+		if ((i % 20) == 0)
+		{
+			item.checksums = @[ [[OCChecksum alloc] initWithAlgorithmIdentifier:@"SHA1" checksum:@"a94a8fe5ccb19ba61c4c0873d391e987982fbbd3"] ];
+			[item setValue:@(i) forLocalAttribute:OCLocalAttributeFavoriteRank];
+		}
+
+		[items addObject:item];
+	}
+
+	return (items);
+}
+
+- (void)testItemBinaryCodingRoundtrip
+{
+	OCItem *item = [self _generateItems:1].firstObject;
+	OCItem *decodedItem, *remoteItem = [self _generateItems:1].firstObject;
+	NSData *itemData;
+
+	item.remoteItem = remoteItem;
+	item.owner = [OCUser userWithUserName:@"guest@example.org" displayName:@"Guest" isRemote:NO];
+	item.isFavorite = @(YES);
+	item.localCopyVersionIdentifier = item.itemVersionIdentifier;
+	item.activeSyncRecordIDs = @[ @(1), @(23) ];
+	item.quotaBytesRemaining = @(-3);
+	item.checksums = @[ item.checksums.firstObject, [[OCChecksum alloc] initWithAlgorithmIdentifier:@"SHA3-256" checksum:@"36f028580bb02cc8272a9a020f4200e346e276ae664e45ee80745574e2f5ab80"] ];
+
+	itemData = item.serializedData;
+
+	XCTAssert([OCItem isBinaryEncodedData:itemData]);
+	XCTAssert(![OCItem isBinaryEncodedData:[NSKeyedArchiver archivedDataWithRootObject:item]]);
+
+	decodedItem = [OCItem itemFromSerializedData:itemData];
+
+	XCTAssertEqualObjects(item.path, decodedItem.path);
+	XCTAssertEqualObjects(item.fileID, decodedItem.fileID);
+	XCTAssertEqualObjects(item.eTag, decodedItem.eTag);
+	XCTAssertEqualObjects(item.localID, decodedItem.localID);
+	XCTAssertEqualObjects(item.driveID, decodedItem.driveID);
+	XCTAssertEqualObjects(item.mimeType, decodedItem.mimeType);
+	XCTAssertEqualObjects(item.lastModified, decodedItem.lastModified);
+	XCTAssertEqualObjects(item.owner, decodedItem.owner);
+	XCTAssertEqualObjects(item.databaseID, decodedItem.databaseID);
+	XCTAssertEqualObjects(item.isFavorite, decodedItem.isFavorite);
+	XCTAssertEqualObjects(item.localCopyVersionIdentifier, decodedItem.localCopyVersionIdentifier);
+	XCTAssertEqualObjects(item.activeSyncRecordIDs, decodedItem.activeSyncRecordIDs);
+	XCTAssertEqualObjects(item.quotaBytesRemaining, decodedItem.quotaBytesRemaining);
+	XCTAssertEqual(item.type, decodedItem.type);
+	XCTAssertEqual(item.size, decodedItem.size);
+	XCTAssertEqual(item.permissions, decodedItem.permissions);
+	XCTAssertEqual(item.versionSeed, decodedItem.versionSeed);
+	XCTAssertEqual(item.localAttributesLastModified, decodedItem.localAttributesLastModified);
+
+	// Lazy fields
+	XCTAssertEqualObjects(item.checksums.firstObject.headerString, decodedItem.checksums.firstObject.headerString);
+	XCTAssertEqualObjects(item.checksums.lastObject.headerString, decodedItem.checksums.lastObject.headerString);
+	XCTAssertEqualObjects(item.localAttributes, decodedItem.localAttributes);
+	XCTAssertEqualObjects(item.remoteItem.fileID, decodedItem.remoteItem.fileID);
+
+	// Re-encoding an item with undecoded lazy fields must preserve them
+	decodedItem = [OCItem itemFromSerializedData:[OCItem itemFromSerializedData:itemData].serializedData];
+	XCTAssertEqualObjects(item.localAttributes, decodedItem.localAttributes);
+	XCTAssertEqualObjects(item.remoteItem.path, decodedItem.remoteItem.path);
+
+	// Legacy keyed archives can still be decoded
+	decodedItem = [OCItem itemFromSerializedData:[NSKeyedArchiver archivedDataWithRootObject:item]];
+	XCTAssertEqualObjects(item.path, decodedItem.path);
+	XCTAssertEqualObjects(item.localAttributes, decodedItem.localAttributes);
+}
+
+- (void)testItemSerializationPerformance
+{
+	NSArray<OCItem *> *items = [self _generateItems:10000];
+	NSMutableArray<NSData *> *keyedArchives = [NSMutableArray new], *binaryEncodings = [NSMutableArray new];
+	NSUInteger keyedArchivesLength = 0, binaryEncodingsLength = 0;
+	NSTimeInterval keyedEncodeTime, keyedDecodeTime, binaryEncodeTime, binaryDecodeTime, startTime;
+
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+	for (OCItem *item in items)
+	{
+		NSData *data = [NSKeyedArchiver archivedDataWithRootObject:item];
+		keyedArchivesLength += data.length;
+		[keyedArchives addObject:data];
+	}
+	keyedEncodeTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+	for (NSData *data in keyedArchives)
+	{
+		XCTAssertNotNil([NSKeyedUnarchiver unarchiveObjectWithData:data]);
+	}
+	keyedDecodeTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+	for (OCItem *item in items)
+	{
+		NSData *data = item.binaryEncodedData;
+		binaryEncodingsLength += data.length;
+		[binaryEncodings addObject:data];
+	}
+	binaryEncodeTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+	for (NSData *data in binaryEncodings)
+	{
+		XCTAssertNotNil([OCItem itemFromBinaryEncodedData:data]);
+	}
+	binaryDecodeTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	OCLog(@"Keyed archive: encode %.3fs, decode %.3fs, %lu bytes", keyedEncodeTime, keyedDecodeTime, (unsigned long)keyedArchivesLength);
+	OCLog(@"Binary coding: encode %.3fs, decode %.3fs, %lu bytes", binaryEncodeTime, binaryDecodeTime, (unsigned long)binaryEncodingsLength);
+
+	XCTAssert(binaryEncodingsLength < keyedArchivesLength);
+
+	[self measureBlock:^{
+		for (NSData *data in binaryEncodings)
+		{
+			[OCItem itemFromBinaryEncodedData:data];
+		}
+	}];
+}
+
+- (void)testItemCopying
+{
+	NSArray<OCItem *> *items = [self _generateItems:10000];
+	OCItem *item = items.firstObject, *copiedItem, *decodedItem;
+	NSTimeInterval copyTime, serializedCopyTime, startTime;
+
+	item.remoteItem = [self _generateItems:1].firstObject;
+	item.activeSyncRecordIDs = @[ @(1) ];
+	[item addSyncRecordID:@(2) activity:OCItemSyncActivityUpdating];
+	[item addSyncRecordID:@(3) activity:OCItemSyncActivityUpdating];
+	item.bookmarkUUID = NSUUID.UUID.UUIDString;
+
+	// Copies preserve the same properties as a serialization roundtrip
+	copiedItem = [item copy];
+	decodedItem = [OCItem itemFromSerializedData:item.serializedData];
+
+	XCTAssertEqualObjects(copiedItem.serializedData, item.serializedData);
+	XCTAssertEqualObjects(copiedItem.bookmarkUUID, item.bookmarkUUID);
+	XCTAssertEqualObjects(copiedItem.localAttributes, item.localAttributes);
+	XCTAssertEqualObjects(copiedItem.remoteItem.fileID, item.remoteItem.fileID);
+	XCTAssert(copiedItem.remoteItem != item.remoteItem);
+
+	// Mutable containers are shared until mutated
+	[copiedItem setValue:@(99) forLocalAttribute:OCLocalAttributeFavoriteRank];
+	[copiedItem removeSyncRecordID:@(3) activity:OCItemSyncActivityUpdating];
+
+	XCTAssertEqualObjects([item valueForLocalAttribute:OCLocalAttributeFavoriteRank], @(0));
+	XCTAssertEqualObjects([copiedItem valueForLocalAttribute:OCLocalAttributeFavoriteRank], @(99));
+	XCTAssertEqualObjects(item.activeSyncRecordIDs, (@[ @(1), @(2), @(3) ]));
+	XCTAssertEqualObjects(copiedItem.activeSyncRecordIDs, (@[ @(1), @(2) ]));
+	XCTAssertEqual([item countOfSyncRecordsWithSyncActivity:OCItemSyncActivityUpdating], 2);
+	XCTAssertEqual([copiedItem countOfSyncRecordsWithSyncActivity:OCItemSyncActivityUpdating], 1);
+
+	// Undecoded lazy fields are passed on to the copy
+	copiedItem = [decodedItem copy];
+	XCTAssertEqualObjects(copiedItem.checksums.firstObject.headerString, item.checksums.firstObject.headerString);
+	XCTAssertEqualObjects(copiedItem.localAttributes, item.localAttributes);
+
+	// Memberwise copies vs. serialization roundtrips
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+	for (OCItem *listItem in items)
+	{
+		XCTAssertNotNil([OCItem itemFromSerializedData:listItem.serializedData]);
+	}
+	serializedCopyTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+	for (OCItem *listItem in items)
+	{
+		XCTAssertNotNil([listItem copy]);
+	}
+	copyTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	OCLog(@"Copying %lu items: serialization roundtrip %.3fs, memberwise %.3fs", (unsigned long)items.count, serializedCopyTime, copyTime);
+
+	XCTAssert(copyTime < serializedCopyTime);
+}
+
+#pragma mark - SQLite read connection performance
+- (NSTimeInterval)_measureMixedReadWriteWithReadConnections:(NSUInteger)maximumReadConnections
+{
+	NSURL *databaseURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString];
+	OCSQLiteDB *sqlDB = [[OCSQLiteDB alloc] initWithURL:databaseURL];
+	XCTestExpectation *expectOpen = [self expectationWithDescription:@"Opened"];
+	XCTestExpectation *expectDone = [self expectationWithDescription:@"Done"];
+	const NSUInteger rowCount = 20000, readCount = 40, writeCount = 200;
+	__block NSUInteger remainingOperations = readCount + writeCount;
+	NSTimeInterval startTime, duration;
+
+	sqlDB.journalMode = OCSQLiteJournalModeWAL;
+	sqlDB.maximumReadConnections = maximumReadConnections;
+
+	[sqlDB openWithFlags:OCSQLiteOpenFlagsDefault completionHandler:^(OCSQLiteDB *db, NSError *error) {
+		XCTAssert(error == nil);
+
+		[db executeTransaction:[OCSQLiteTransaction transactionWithBlock:^NSError *(OCSQLiteDB *db, OCSQLiteTransaction *transaction) {
+			[db executeQuery:[OCSQLiteQuery query:@"CREATE TABLE items (itemID INTEGER PRIMARY KEY, name VARCHAR, size INTEGER)" resultHandler:nil]];
+
+			for (NSUInteger i=0; i<rowCount; i++)
+			{
+				[db executeQuery:[OCSQLiteQuery query:@"INSERT INTO items (name, size) VALUES (?, ?)" withParameters:@[ [NSString stringWithFormat:@"Item %lu", (unsigned long)i], @(i) ] resultHandler:nil]];
+			}
+
+			return (nil);
+		} type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+			XCTAssert(error == nil);
+			[expectOpen fulfill];
+		}]];
+	}];
+
+	[self waitForExpectations:@[ expectOpen ] timeout:60];
+
+	void (^operationDone)(void) = ^{
+		@synchronized(self)
+		{
+			remainingOperations--;
+
+			if (remainingOperations == 0)
+			{
+				[expectDone fulfill];
+			}
+		}
+	};
+
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+
+	for (NSUInteger i=0; i<writeCount; i++)
+	{
+		if ((i % (writeCount / readCount)) == 0)
+		{
+			OCSQLiteQuery *scanQuery = [OCSQLiteQuery query:@"SELECT itemID, name, size FROM items WHERE name LIKE '%9%' ORDER BY size DESC" resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
+				__block NSUInteger matchCount = 0;
+
+				[resultSet iterateUsing:^(OCSQLiteResultSet *resultSet, NSUInteger line, NSDictionary<NSString *,id<NSObject>> *rowDictionary, BOOL *stop) {
+					matchCount++;
+				} error:&error];
+
+				XCTAssert(error == nil);
+				XCTAssert(matchCount > 0);
+
+				operationDone();
+			}];
+			scanQuery.readOnly = YES;
+
+			[sqlDB executeQuery:scanQuery];
+		}
+
+		[sqlDB executeQuery:[OCSQLiteQuery query:@"UPDATE items SET size=size+1 WHERE itemID=?" withParameters:@[ @(1 + (i * 97) % rowCount) ] resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
+			XCTAssert(error == nil);
+			operationDone();
+		}]];
+	}
+
+	[self waitForExpectations:@[ expectDone ] timeout:120];
+
+	duration = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	OCLog(@"maximumReadConnections=%lu: %lu reads + %lu writes in %.3fs (%.1f ops/s)", (unsigned long)maximumReadConnections, (unsigned long)readCount, (unsigned long)writeCount, duration, ((double)(readCount + writeCount)) / duration);
+
+	XCTestExpectation *expectClose = [self expectationWithDescription:@"Closed"];
+
+	[sqlDB closeWithCompletionHandler:^(OCSQLiteDB *db, NSError *error) {
+		[expectClose fulfill];
+	}];
+
+	[self waitForExpectations:@[ expectClose ] timeout:10];
+
+	[NSFileManager.defaultManager removeItemAtURL:databaseURL error:NULL];
+
+	return (duration);
+}
+
+- (void)testSQLiteReadConnectionsMixedThroughput
+{
+	NSTimeInterval writerOnlyDuration = [self _measureMixedReadWriteWithReadConnections:0];
+	NSTimeInterval readConnectionsDuration = [self _measureMixedReadWriteWithReadConnections:4];
+
+	OCLog(@"Speedup with read connections: %.2fx", writerOnlyDuration / readConnectionsDuration);
+}
+
+#pragma mark - Query condition evaluation performance
+- (void)testCompiledQueryConditionEvaluation
+{
+	NSArray<OCItem *> *items = [self _generateItems:100000];
+	OCQueryCondition *condition = [OCQueryCondition require:@[
+		[OCQueryCondition anyOf:@[
+			[OCQueryCondition where:OCItemPropertyNameName contains:@"file 9"],
+			[OCQueryCondition where:OCItemPropertyNameName endsWith:@".jpg"],
+			[OCQueryCondition where:OCItemPropertyNameMIMEType startsWith:@"image/"]
+		]],
+		[OCQueryCondition where:OCItemPropertyNameType isEqualTo:@(OCItemTypeFile)],
+		[OCQueryCondition where:OCItemPropertyNameSize isGreaterThan:@(100 * 1024)],
+		[OCQueryCondition where:OCItemPropertyNameLastModified isLessThan:[NSDate dateWithTimeIntervalSinceReferenceDate:700090000]],
+		[OCQueryCondition negating:YES condition:[OCQueryCondition where:OCItemPropertyNameIsFavorite isEqualTo:@(1)]],
+		[OCQueryCondition where:OCItemPropertyNamePath isNotEqualTo:@"/Documents/Folder 1/File 101.jpg"]
+	]];
+	OCQueryConditionProgram *program = [condition compiledProgram];
+	NSUInteger interpretedMatches = 0, compiledMatches = 0;
+	NSTimeInterval interpretedTime, compiledTime, startTime;
+
+	// Both evaluators must produce the same results
+	for (OCItem *item in items)
+	{
+		XCTAssertEqual([condition fulfilledByItem:item], [program evaluateWithItem:item], @"Mismatch for %@", item.path);
+	}
+
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+	for (OCItem *item in items)
+	{
+		if ([condition fulfilledByItem:item]) { interpretedMatches++; }
+	}
+	interpretedTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+	for (OCItem *item in items)
+	{
+		if ([program evaluateWithItem:item]) { compiledMatches++; }
+	}
+	compiledTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	XCTAssert(compiledMatches > 0);
+	XCTAssertEqual(interpretedMatches, compiledMatches);
+
+	OCLog(@"Interpreted: %.3fs (%.0f items/s), compiled: %.3fs (%.0f items/s), %lu matches", interpretedTime, items.count / interpretedTime, compiledTime, items.count / compiledTime, (unsigned long)compiledMatches);
+
+	[self measureBlock:^{
+		for (OCItem *item in items)
+		{
+			[program evaluateWithItem:item];
+		}
+	}];
+}
+
+#pragma mark - Query routing performance
+- (void)testQueryRoutingIndex
+{
+	NSArray<OCItem *> *items = [self _generateItems:50000];
+	OCDriveID driveID = items.firstObject.driveID;
+	OCCoreQueryRoutingIndex *routingIndex = [OCCoreQueryRoutingIndex new];
+	NSMutableArray<OCCoreItemList *> *changeBatches = [NSMutableArray new];
+	OCQuery *folder3Query = nil;
+
+	// 500 live queries: 450 folders, 40 single items, 8 sync anchor queries, 2 custom queries
+	for (NSUInteger folderIdx=0; folderIdx<450; folderIdx++)
+	{
+		OCQuery *query = [OCQuery queryForLocation:[[OCLocation alloc] initWithDriveID:driveID path:[NSString stringWithFormat:@"/Documents/Folder %lu/", (unsigned long)folderIdx]]];
+
+		if (folderIdx == 3) { folder3Query = query; }
+
+		[routingIndex addQuery:query];
+	}
+
+	for (NSUInteger itemIdx=0; itemIdx<40; itemIdx++)
+	{
+		[routingIndex addQuery:[OCQuery queryWithItem:items[itemIdx * 100]]];
+	}
+
+	for (NSUInteger anchorIdx=0; anchorIdx<8; anchorIdx++)
+	{
+		[routingIndex addQuery:[OCQuery queryForChangesSinceSyncAnchor:@(anchorIdx)]];
+	}
+
+	for (NSUInteger customIdx=0; customIdx<2; customIdx++)
+	{
+		[routingIndex addQuery:[OCQuery queryWithCondition:[OCQueryCondition where:OCItemPropertyNameIsFavorite isEqualTo:@(1)] inputFilter:nil]];
+	}
+
+	XCTAssertEqual(routingIndex.count, 500);
+
+	// Changes are typically limited to the contents of a single folder
+	for (NSUInteger folderIdx=0; folderIdx<500; folderIdx++)
+	{
+		[changeBatches addObject:[OCCoreItemList itemListWithItems:[items subarrayWithRange:NSMakeRange(folderIdx * 100, 100)]]];
+	}
+
+	// Updates in Folder 3: location query for the folder, item query for File 300, sync anchor and custom queries
+	NSArray<OCQuery *> *routedQueries = [routingIndex queriesForAddedItems:nil removedItems:nil updatedItems:changeBatches[3] movedFolderItems:nil];
+
+	XCTAssertEqual(routedQueries.count, 12);
+	XCTAssert([routedQueries indexOfObjectIdenticalTo:folder3Query] != NSNotFound);
+
+	// Removal of a folder's parent folder also reaches the folder's query
+	OCItem *documentsFolder = [OCItem placeholderItemOfType:OCItemTypeCollection];
+	documentsFolder.path = @"/Documents/";
+	documentsFolder.driveID = driveID;
+
+	routedQueries = [routingIndex queriesForAddedItems:nil removedItems:[OCCoreItemList itemListWithItems:@[ documentsFolder ]] updatedItems:nil movedFolderItems:nil];
+
+	XCTAssertEqual(routedQueries.count, 460);
+
+	[routingIndex removeQuery:folder3Query];
+
+	XCTAssertEqual(routingIndex.count, 499);
+	XCTAssertEqual([routingIndex queriesForAddedItems:nil removedItems:nil updatedItems:changeBatches[3] movedFolderItems:nil].count, 11);
+
+	__block NSUInteger routedCount = 0;
+
+	[self measureBlock:^{
+		routedCount = 0;
+
+		for (OCCoreItemList *changeBatch in changeBatches)
+		{
+			routedCount += [routingIndex queriesForAddedItems:nil removedItems:nil updatedItems:changeBatch movedFolderItems:nil].count;
+		}
+	}];
+
+	OCLog(@"Routed %lu change batches to an average of %.1f of %lu queries", (unsigned long)changeBatches.count, ((double)routedCount) / ((double)changeBatches.count), (unsigned long)routingIndex.count);
+}
+
+#pragma mark - Subtree lookup performance
+- (void)testSubtreeLookupAndMove
+{
+	NSURL *databaseURL = [[[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString] URLByAppendingPathExtension:@"db"];
+	OCDatabase *database = [[OCDatabase alloc] initWithURL:databaseURL];
+	NSMutableArray<OCItem *> *items = [NSMutableArray new];
+	const NSUInteger itemCount = 100000, folderCount = 10000, fanOut = 10;
+	__block NSArray<OCItem *> *locationSubtreeItems = nil, *hierarchySubtreeItems = nil;
+	NSTimeInterval startTime, locationLookupTime, hierarchyLookupTime, pathRewriteMoveTime, hierarchyMoveTime;
+
+	// Tree of 100k nodes: item i is located in folder (i-1)/10, items 0..9999 are folders
+	for (NSUInteger i=0; i<itemCount; i++)
+	{
+		OCItem *item = [OCItem placeholderItemOfType:((i < folderCount) ? OCItemTypeCollection : OCItemTypeFile)];
+		OCItem *parentItem = (i > 0) ? items[(i-1) / fanOut] : nil;
+
+		item.localID = [NSString stringWithFormat:@"L%lu", (unsigned long)i];
+		item.fileID = [NSString stringWithFormat:@"F%lu", (unsigned long)i];
+		item.path = (parentItem == nil) ? @"/" : [parentItem.path stringByAppendingFormat:((i < folderCount) ? @"Folder %lu/" : @"File %lu.txt"), (unsigned long)i];
+		item.parentLocalID = parentItem.localID;
+		item.parentFileID = parentItem.fileID;
+
+		[items addObject:item];
+	}
+
+	XCTestExpectation *expectAdded = [self expectationWithDescription:@"Added"];
+
+	[database openWithCompletionHandler:^(OCDatabase *db, NSError *error) {
+		XCTAssert(error == nil);
+
+		[db addCacheItems:items syncAnchor:@(1) completionHandler:^(OCDatabase *db, NSError *error) {
+			XCTAssert(error == nil);
+			[expectAdded fulfill];
+		}];
+	}];
+
+	[self waitForExpectations:@[ expectAdded ] timeout:300];
+
+	// Subtree lookups (folder 1 contains 11110 items)
+	XCTestExpectation *expectLocationLookup = [self expectationWithDescription:@"Location lookup"];
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+
+	[database retrieveCacheItemsRecursivelyBelowLocation:items[1].location includingPathItself:NO includingRemoved:NO completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *subtreeItems) {
+		locationSubtreeItems = subtreeItems;
+		[expectLocationLookup fulfill];
+	}];
+
+	[self waitForExpectations:@[ expectLocationLookup ] timeout:60];
+	locationLookupTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	XCTestExpectation *expectHierarchyLookup = [self expectationWithDescription:@"Hierarchy lookup"];
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+
+	[database retrieveCacheItemsRecursivelyBelowItem:items[1] includingItemItself:NO includingRemoved:NO completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *subtreeItems) {
+		hierarchySubtreeItems = subtreeItems;
+		[expectHierarchyLookup fulfill];
+	}];
+
+	[self waitForExpectations:@[ expectHierarchyLookup ] timeout:60];
+	hierarchyLookupTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	XCTAssertEqual(locationSubtreeItems.count, 11110);
+	XCTAssertEqual(hierarchySubtreeItems.count, locationSubtreeItems.count);
+
+	// Move folder 1 into folder 2: hierarchy update of the moved folder only
+	XCTestExpectation *expectHierarchyMove = [self expectationWithDescription:@"Hierarchy move"];
+	OCItem *movedFolder = items[1];
+	OCPath previousFolderPath = movedFolder.path;
+
+	movedFolder.path = [items[2].path stringByAppendingString:@"Folder 1/"];
+	movedFolder.parentLocalID = items[2].localID;
+	movedFolder.parentFileID = items[2].fileID;
+
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+
+	[database updateCacheItems:@[ movedFolder ] syncAnchor:@(2) completionHandler:^(OCDatabase *db, NSError *error) {
+		XCTAssert(error == nil);
+		[expectHierarchyMove fulfill];
+	}];
+
+	[self waitForExpectations:@[ expectHierarchyMove ] timeout:60];
+	hierarchyMoveTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	// Move folder 1 into folder 2: rewrite of the paths of all contained items
+	XCTestExpectation *expectPathRewriteMove = [self expectationWithDescription:@"Path rewrite move"];
+
+	for (OCItem *item in locationSubtreeItems)
+	{
+		item.path = [movedFolder.path stringByAppendingString:[item.path substringFromIndex:previousFolderPath.length]];
+	}
+
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+
+	[database updateCacheItems:locationSubtreeItems syncAnchor:@(2) completionHandler:^(OCDatabase *db, NSError *error) {
+		XCTAssert(error == nil);
+		[expectPathRewriteMove fulfill];
+	}];
+
+	[self waitForExpectations:@[ expectPathRewriteMove ] timeout:120];
+	pathRewriteMoveTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	// Folder 2 now contains its own 11110 items, folder 1 and the 11110 items inside folder 1
+	XCTestExpectation *expectMovedLookup = [self expectationWithDescription:@"Moved lookup"];
+
+	[database retrieveCacheItemsRecursivelyBelowItem:items[2] includingItemItself:NO includingRemoved:NO completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *subtreeItems) {
+		XCTAssertEqual(subtreeItems.count, 22221);
+		[expectMovedLookup fulfill];
+	}];
+
+	[self waitForExpectations:@[ expectMovedLookup ] timeout:60];
+
+	OCLog(@"Subtree of %lu items in tree of %lu: path lookup %.3fs, hierarchy lookup %.3fs / folder move: path rewrite %.3fs, hierarchy %.3fs", (unsigned long)locationSubtreeItems.count, (unsigned long)itemCount, locationLookupTime, hierarchyLookupTime, pathRewriteMoveTime, hierarchyMoveTime);
+
+	XCTestExpectation *expectClose = [self expectationWithDescription:@"Closed"];
+
+	[database closeWithCompletionHandler:^(OCDatabase *db, NSError *error) {
+		[expectClose fulfill];
+	}];
+
+	[self waitForExpectations:@[ expectClose ] timeout:10];
+
+	[NSFileManager.defaultManager removeItemAtURL:databaseURL error:NULL];
+	[NSFileManager.defaultManager removeItemAtURL:database.thumbnailDatabaseURL error:NULL];
+}
+
+#pragma mark - Item name search performance
+- (void)testItemNameSearch
+{
+	NSURL *databaseURL = [[[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString] URLByAppendingPathExtension:@"db"];
+	OCDatabase *database = [[OCDatabase alloc] initWithURL:databaseURL];
+	NSMutableArray<OCItem *> *items = [NSMutableArray new];
+	const NSUInteger itemCount = 100000, reportInterval = 1000;
+	__block NSUInteger likeScanCount = 0;
+	__block NSArray<OCItem *> *conditionItems = nil, *searchItems = nil;
+	NSTimeInterval startTime, likeScanTime, conditionTime, searchTime;
+
+	// 100k files, every 1000th of which is a report
+	for (NSUInteger i=0; i<itemCount; i++)
+	{
+		OCItem *item = [OCItem placeholderItemOfType:OCItemTypeFile];
+
+		item.localID = [NSString stringWithFormat:@"L%lu", (unsigned long)i];
+		item.fileID = [NSString stringWithFormat:@"F%lu", (unsigned long)i];
+		item.path = [NSString stringWithFormat:(((i % reportInterval) == 0) ? @"/Quarterly Report %lu.pdf" : @"/File %lu.txt"), (unsigned long)i];
+
+		[items addObject:item];
+	}
+
+	XCTestExpectation *expectAdded = [self expectationWithDescription:@"Added"];
+
+	[database openWithCompletionHandler:^(OCDatabase *db, NSError *error) {
+		XCTAssert(error == nil);
+
+		[db addCacheItems:items syncAnchor:@(1) completionHandler:^(OCDatabase *db, NSError *error) {
+			XCTAssert(error == nil);
+			[expectAdded fulfill];
+		}];
+	}];
+
+	[self waitForExpectations:@[ expectAdded ] timeout:300];
+
+	// LIKE scan over metaData
+	XCTestExpectation *expectLikeScan = [self expectationWithDescription:@"LIKE scan"];
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+
+	[database.sqlDB executeQuery:[OCSQLiteQuery query:@"SELECT mdID FROM metaData WHERE removed=0 AND name LIKE '%report%'" resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
+		[resultSet iterateUsing:^(OCSQLiteResultSet *resultSet, NSUInteger line, NSDictionary<NSString *,id<NSObject>> *rowDictionary, BOOL *stop) {
+			likeScanCount++;
+		} error:NULL];
+
+		[expectLikeScan fulfill];
+	}]];
+
+	[self waitForExpectations:@[ expectLikeScan ] timeout:60];
+	likeScanTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	// Contains condition (answered from itemNameIndex)
+	XCTestExpectation *expectCondition = [self expectationWithDescription:@"Condition"];
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+
+	[database retrieveCacheItemsForQueryCondition:[OCQueryCondition where:OCItemPropertyNameName contains:@"report"] cancelAction:nil completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *resultItems) {
+		conditionItems = resultItems;
+		[expectCondition fulfill];
+	}];
+
+	[self waitForExpectations:@[ expectCondition ] timeout:60];
+	conditionTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	// Ranked local search
+	XCTestExpectation *expectSearch = [self expectationWithDescription:@"Search"];
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+
+	[database retrieveCacheItemsMatchingSearchTerms:@[ @"report", @"9" ] limit:0 cancelAction:nil completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *resultItems) {
+		XCTAssert(error == nil);
+		searchItems = resultItems;
+		[expectSearch fulfill];
+	}];
+
+	[self waitForExpectations:@[ expectSearch ] timeout:60];
+	searchTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	XCTAssertEqual(likeScanCount, itemCount / reportInterval);
+	XCTAssertEqual(conditionItems.count, likeScanCount);
+	XCTAssertEqual(searchItems.count, 19); // Quarterly Report 9000, 19000, … 89000 + 90000 … 99000
+	XCTAssert([searchItems.firstObject.name hasPrefix:@"Quarterly Report"]);
+
+	OCLog(@"Name search in %lu items: LIKE scan %.3fs, indexed condition %.3fs, ranked search %.3fs", (unsigned long)itemCount, likeScanTime, conditionTime, searchTime);
+
+	// Renamed and removed items are reflected in the index
+	XCTestExpectation *expectUpdated = [self expectationWithDescription:@"Updated"];
+	OCItem *renamedItem = items[1], *removedItem = items[reportInterval];
+
+	renamedItem.path = @"/Annual Report.pdf";
+
+	[database updateCacheItems:@[ renamedItem ] syncAnchor:@(2) completionHandler:^(OCDatabase *db, NSError *error) {
+		XCTAssert(error == nil);
+
+		[db purgeCacheItemsWithDatabaseIDs:@[ removedItem.databaseID ] completionHandler:^(OCDatabase *db, NSError *error) {
+			XCTAssert(error == nil);
+
+			[db retrieveCacheItemsMatchingSearchTerms:@[ @"report" ] limit:0 cancelAction:nil completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *resultItems) {
+				XCTAssertEqual(resultItems.count, itemCount / reportInterval);
+				XCTAssert([[resultItems valueForKeyPath:@"localID"] containsObject:renamedItem.localID]);
+				XCTAssertFalse([[resultItems valueForKeyPath:@"localID"] containsObject:removedItem.localID]);
+
+				// Patterns stay anchored
+				[db retrieveCacheItemsMatchingSearchTerms:@[ @"annual*" ] limit:0 cancelAction:nil completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *resultItems) {
+					XCTAssertEqualObjects([resultItems valueForKeyPath:@"localID"], (@[ renamedItem.localID ]));
+
+					[db retrieveCacheItemsMatchingSearchTerms:@[ @"report*" ] limit:0 cancelAction:nil completionHandler:^(OCDatabase *db, NSError *error, OCSyncAnchor syncAnchor, NSArray<OCItem *> *resultItems) {
+						XCTAssertEqual(resultItems.count, 0);
+
+						[expectUpdated fulfill];
+					}];
+				}];
+			}];
+		}];
+	}];
+
+	[self waitForExpectations:@[ expectUpdated ] timeout:60];
+
+	XCTestExpectation *expectClose = [self expectationWithDescription:@"Closed"];
+
+	[database closeWithCompletionHandler:^(OCDatabase *db, NSError *error) {
+		[expectClose fulfill];
+	}];
+
+	[self waitForExpectations:@[ expectClose ] timeout:10];
+
+	[NSFileManager.defaultManager removeItemAtURL:databaseURL error:NULL];
+	[NSFileManager.defaultManager removeItemAtURL:database.thumbnailDatabaseURL error:NULL];
+}
+
+#pragma mark - Date parsing performance
+- (void)testDAVDateParsing
+{
+	NSURL *xmlResponseDataURL = [[NSBundle bundleForClass:[self class]] URLForResource:@"largePropFindResponse1000" withExtension:@"xml"];
+	NSString *xmlResponseString = [NSString stringWithContentsOfURL:xmlResponseDataURL encoding:NSUTF8StringEncoding error:NULL];
+	NSRegularExpression *lastModifiedRegex = [NSRegularExpression regularExpressionWithPattern:@"<d:getlastmodified>([^<]*)</d:getlastmodified>" options:0 error:NULL];
+	NSMutableArray<NSString *> *dateStrings = [NSMutableArray new];
+	NSDateFormatter *dateFormatter = [NSDateFormatter new];
+	const NSUInteger rounds = 100;
+	NSTimeInterval startTime, formatterTime, parserTime;
+
+	dateFormatter.locale = [[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"];
+	dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
+	dateFormatter.dateFormat = @"EEE, dd MMM y HH:mm:ss zzz";
+
+	for (NSTextCheckingResult *match in [lastModifiedRegex matchesInString:xmlResponseString options:0 range:NSMakeRange(0, xmlResponseString.length)])
+	{
+		[dateStrings addObject:[xmlResponseString substringWithRange:[match rangeAtIndex:1]]];
+	}
+
+	XCTAssert(dateStrings.count >= 1000);
+
+	// Parser and formatter must agree
+	for (NSString *dateString in dateStrings)
+	{
+		XCTAssertEqualObjects([NSDate dateParsedFromString:dateString error:NULL], [dateFormatter dateFromString:dateString]);
+	}
+
+	// Formatter
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+	for (NSUInteger round=0; round < rounds; round++)
+	{
+		for (NSString *dateString in dateStrings)
+		{
+			@autoreleasepool {
+				[dateFormatter dateFromString:dateString];
+			}
+		}
+	}
+	formatterTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	// Parser
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+	for (NSUInteger round=0; round < rounds; round++)
+	{
+		for (NSString *dateString in dateStrings)
+		{
+			@autoreleasepool {
+				[NSDate dateParsedFromString:dateString error:NULL];
+			}
+		}
+	}
+	parserTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	OCLog(@"Parsed %lu dates %lu times: formatter %.3f sec, parser %.3f sec (%.1fx)", (unsigned long)dateStrings.count, (unsigned long)rounds, formatterTime, parserTime, formatterTime / parserTime);
+
+	// Parser, concurrently
+	[self measureBlock:^{
+		dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+			for (NSUInteger round=0; round < rounds; round++)
+			{
+				for (NSString *dateString in dateStrings)
+				{
+					@autoreleasepool {
+						[NSDate dateParsedFromString:dateString error:NULL];
+					}
+				}
+			}
+		});
+	}];
+}
+
+#pragma mark - OCCache performance
+- (void)testCacheConcurrentHits
+{
+	const NSUInteger keyCount = 100000;
+	NSMutableArray<NSNumber *> *keys = [NSMutableArray new];
+
+	for (NSUInteger i=0; i<keyCount; i++)
+	{
+		[keys addObject:@(i)];
+	}
+
+	for (NSNumber *shardCount in @[ @(1), @(16) ])
+	{
+		OCCache<NSNumber *, NSNumber *> *cache = [[OCCache alloc] initWithShardCount:shardCount.unsignedIntegerValue];
+		NSTimeInterval startTime;
+
+		cache.countLimit = keyCount;
+
+		for (NSNumber *key in keys)
+		{
+			[cache setObject:key forKey:key];
+		}
+
+		startTime = NSDate.timeIntervalSinceReferenceDate;
+
+		dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+			for (NSUInteger i=0; i<keyCount; i++)
+			{
+				[cache objectForKey:keys[(i * 7919 + iteration) % keyCount]];
+			}
+		});
+
+		OCLog(@"%lu concurrent hits with %@ shard(s): %.3f sec", (unsigned long)(keyCount * 8), shardCount, NSDate.timeIntervalSinceReferenceDate - startTime);
+
+		XCTAssert(cache.hitCount == keyCount * 8);
+		XCTAssert(cache.evictionCount == 0);
+	}
+}
+
+#pragma mark - Lock performance
+- (void)testLockAcquisition
+{
+	NSURL *temporaryDirectoryURL = [NSURL fileURLWithPath:NSTemporaryDirectory()];
+	NSURL *keyValueStoreURL = [temporaryDirectoryURL URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
+	NSURL *lockTableURL = [temporaryDirectoryURL URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
+	OCLockTable *lockTable = [[OCLockTable alloc] initWithURL:lockTableURL identifier:NSUUID.UUID.UUIDString];
+	const NSUInteger tableRounds = 100000, managerRounds = 100;
+	NSTimeInterval startTime, tableTime, keyValueStoreManagerTime, lockTableManagerTime;
+
+	// Lock table: acquire, keep-alive, release
+	startTime = NSDate.timeIntervalSinceReferenceDate;
+
+	for (NSUInteger i=0; i<tableRounds; i++)
+	{
+		NSDate *expirationDate = [NSDate dateWithTimeIntervalSinceNow:OCLockExpirationInterval];
+		OCLockTableToken token = [lockTable acquireLockForResource:@"resource" expirationDate:expirationDate holderExpirationDate:NULL];
+
+		XCTAssert(token != 0);
+		XCTAssert([lockTable renewLockForResource:@"resource" token:token expirationDate:expirationDate]);
+		XCTAssert([lockTable releaseLockForResource:@"resource" token:token]);
+	}
+
+	tableTime = NSDate.timeIntervalSinceReferenceDate - startTime;
+
+	// Lock managers: request, acquire, release
+	NSTimeInterval (^measureLockManager)(OCLockManager *lockManager) = ^(OCLockManager *lockManager) {
+		NSTimeInterval startTime = NSDate.timeIntervalSinceReferenceDate;
+
+		for (NSUInteger i=0; i<managerRounds; i++)
+		{
+			dispatch_semaphore_t acquiredSemaphore = dispatch_semaphore_create(0);
+
+			[lockManager requestLock:[[OCLockRequest alloc] initWithResourceIdentifier:@"resource" acquiredHandler:^(NSError * _Nullable error, OCLock * _Nullable lock) {
+				[lock releaseLock];
+				dispatch_semaphore_signal(acquiredSemaphore);
+			}]];
+
+			XCTAssert(dispatch_semaphore_wait(acquiredSemaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(10 * NSEC_PER_SEC))) == 0);
+		}
+
+		return (NSDate.timeIntervalSinceReferenceDate - startTime);
+	};
+
+	keyValueStoreManagerTime = measureLockManager([[OCLockManager alloc] initWithKeyValueStore:[[OCKeyValueStore alloc] initWithURL:keyValueStoreURL identifier:NSUUID.UUID.UUIDString]]);
+	lockTableManagerTime = measureLockManager([[OCLockManager alloc] initWithLockTable:lockTable keyValueStore:nil]);
+
+	OCLog(@"Lock table: %.3fµs per acquire/renew/release / lock manager round trip: KVS %.3fms, lock table %.3fms", (tableTime * 1000000.0) / tableRounds, (keyValueStoreManagerTime * 1000.0) / managerRounds, (lockTableManagerTime * 1000.0) / managerRounds);
+
+	[NSFileManager.defaultManager removeItemAtURL:keyValueStoreURL error:NULL];
+	[NSFileManager.defaultManager removeItemAtURL:lockTableURL error:NULL];
+}
+
+@end
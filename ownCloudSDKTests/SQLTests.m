@@ -351,6 +351,58 @@
 	});
 }
 
+- (void)testSQLiteQueryConstructionMultiRowInsert
+{
+	OCSQLiteDB *sqlDB;
+	XCTestExpectation *expectCallback = [self expectationWithDescription:@"Expect receiving callback"];
+	XCTestExpectation *expectRowIDs = [self expectationWithDescription:@"Expect row IDs"];
+	XCTestExpectation *expectRows = [self expectationWithDescription:@"Expect rows"];
+
+	if ((sqlDB = [OCSQLiteDB new]) != nil)
+	{
+		[sqlDB openWithFlags:OCSQLiteOpenFlagsDefault completionHandler:^(OCSQLiteDB *db, NSError *error) {
+			[db executeTransaction:[OCSQLiteTransaction transactionWithQueries:@[
+				[OCSQLiteQuery query:@"CREATE TABLE t1(id INTEGER PRIMARY KEY, number REAL, name TEXT)" resultHandler:nil],
+				[OCSQLiteQuery queryInsertingIntoTable:@"t1" rowValues:@{
+					@"number" : @(1),
+					@"name" : @"one"
+				} resultHandler:nil],
+				[OCSQLiteQuery queryInsertingIntoTable:@"t1" columnNames:@[ @"number", @"name" ] rows:@[
+					@[ @(2), @"two" ],
+					@[ @(3), NSNull.null ],
+					@[ @(4), @"four" ]
+				] resultHandler:^(OCSQLiteDB *db, NSError *error, NSArray<NSNumber *> *rowIDs) {
+					XCTAssertNil(error);
+					XCTAssertEqualObjects(rowIDs, (@[ @(2), @(3), @(4) ]));
+					[expectRowIDs fulfill];
+				}]
+			] type:OCSQLiteTransactionTypeDeferred completionHandler:^(OCSQLiteDB *db, OCSQLiteTransaction *transaction, NSError *error) {
+				XCTAssert((error==nil), @"Transaction finished without errors");
+
+				[db executeQuery:[OCSQLiteQuery query:@"SELECT * FROM t1 ORDER BY id" resultHandler:^(OCSQLiteDB *db, NSError *error, OCSQLiteTransaction *transaction, OCSQLiteResultSet *resultSet) {
+					[resultSet iterateUsing:^(OCSQLiteResultSet *resultSet, NSUInteger line, NSDictionary<NSString *,id<NSObject>> *rowDictionary, BOOL *stop) {
+						XCTAssertEqual(((NSNumber *)rowDictionary[@"id"]).integerValue, ((NSNumber *)rowDictionary[@"number"]).integerValue);
+
+						if (line == 3) { [expectRows fulfill]; }
+					} error:NULL];
+				}]];
+
+				[expectCallback fulfill];
+			}]];
+		}];
+	}
+
+	XCTAssertNil([OCSQLiteQuery queryInsertingIntoTable:@"t1" columnNames:@[ @"number", @"name" ] rows:@[ @[ @(5) ] ] resultHandler:nil]);
+
+	[self waitForExpectationsWithTimeout:5 handler:NULL];
+
+	OCSyncExec(waitSQL, {
+		[sqlDB closeWithCompletionHandler:^(OCSQLiteDB *db, NSError *error) {
+			OCSyncExecDone(waitSQL);
+		}];
+	});
+}
+
 - (void)testSQLiteQueryConstructionInsertAndUpdate
 {
 	OCSQLiteDB *sqlDB;
@@ -703,4 +755,40 @@
 	});
 }
 
+- (void)testLocalizedCollationSortKeys
+{
+	NSArray<NSString *> *names = @[
+		@"file10.txt", @"File2.txt", @"file2.txt", @"file1.txt", @"file01.txt", @"file.txt",
+		@"Äpfel", @"apfel", @"Apfel", @"Birnen", @"birne", @"b", @"a", @"a b", @"_hidden", @"2024 Report", @"100 Reasons"
+	];
+	NSArray<NSString *> *sortedBySortKey = [names sortedArrayUsingComparator:^NSComparisonResult(NSString *name1, NSString *name2) {
+		NSData *sortKey1 = [OCSQLiteCollationLocalized sortKeyForString:name1];
+		NSData *sortKey2 = [OCSQLiteCollationLocalized sortKeyForString:name2];
+		int result = memcmp(sortKey1.bytes, sortKey2.bytes, MIN(sortKey1.length, sortKey2.length));
+
+		if (result == 0)
+		{
+			return ((sortKey1.length == sortKey2.length) ? NSOrderedSame : ((sortKey1.length < sortKey2.length) ? NSOrderedAscending : NSOrderedDescending));
+		}
+
+		return ((result < 0) ? NSOrderedAscending : NSOrderedDescending);
+	}];
+
+	// Numbers are sorted by value, shorter strings first
+	XCTAssert([sortedBySortKey indexOfObject:@"file.txt"] < [sortedBySortKey indexOfObject:@"file1.txt"]);
+	XCTAssert([sortedBySortKey indexOfObject:@"file1.txt"] < [sortedBySortKey indexOfObject:@"file2.txt"]);
+	XCTAssert([sortedBySortKey indexOfObject:@"file2.txt"] < [sortedBySortKey indexOfObject:@"file10.txt"]);
+	XCTAssert([sortedBySortKey indexOfObject:@"100 Reasons"] < [sortedBySortKey indexOfObject:@"2024 Report"]);
+
+	// Case and diacritics only break ties
+	XCTAssert([sortedBySortKey indexOfObject:@"apfel"] < [sortedBySortKey indexOfObject:@"Apfel"]);
+	XCTAssert([sortedBySortKey indexOfObject:@"Apfel"] < [sortedBySortKey indexOfObject:@"Äpfel"]);
+	XCTAssert([sortedBySortKey indexOfObject:@"Äpfel"] < [sortedBySortKey indexOfObject:@"b"]);
+	XCTAssert([sortedBySortKey indexOfObject:@"a"] < [sortedBySortKey indexOfObject:@"a b"]);
+	XCTAssert([sortedBySortKey indexOfObject:@"birne"] < [sortedBySortKey indexOfObject:@"Birnen"]);
+
+	// Sort keys for equal strings are equal, regardless of Unicode normalization
+	XCTAssertEqualObjects([OCSQLiteCollationLocalized sortKeyForString:@"\u00C4pfel"], [OCSQLiteCollationLocalized sortKeyForString:@"A\u0308pfel"]);
+}
+
 @end